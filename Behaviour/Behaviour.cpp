@@ -24,6 +24,7 @@
 
 #include "Behaviour.h"
 #include "BehaviourProvider.h"
+#include "FieldGeometryMap.h"
 
 #include "MiscBehaviours/SelectBehaviourProvider.h"
 #include "Soccer/SoccerProvider.h"
@@ -50,6 +51,7 @@ using namespace std;
 
 Behaviour::Behaviour()
 {
+    FieldGeometryMap::getInstance();            // load the field geometry now, rather than in the middle of the first decision
     #if defined(TARGET_IS_NAOWEBOTS)
         m_behaviour = new ScriptedPoseProvider(this);
     #elif defined(TARGET_IS_BEAR)
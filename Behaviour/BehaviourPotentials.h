@@ -1,7 +1,8 @@
 /*! @file BehaviourPotentials.h
     @brief Declaration of the behaviour motor schemas (aka potentials or vector fields)
  
-    Functions in this file return a vector (trans_speed, trans_direction, rotational_speed).
+    Functions in this file return a Potential (trans_speed, trans_direction, rotational_speed), and makeField()
+    builds the PotentialField a behaviour evaluates once each time it is run.
 
     @author Jason Kulk
  
@@ -24,8 +25,11 @@
 #ifndef BEHAVIOUR_POTENTIALS_H
 #define BEHAVIOUR_POTENTIALS_H
 
+#include "PotentialField.h"
+#include "FieldGeometryMap.h"
 #include "Infrastructure/FieldObjects/FieldObjects.h"
 #include "Infrastructure/GameInformation/GameInformation.h"
+#include "Infrastructure/TeamInformation/TeamInformation.h"
 #include "Infrastructure/NUSensorsData/NUSensorsData.h"
 #include "Tools/Math/General.h"
 
@@ -36,23 +40,91 @@
 #include <string>
 using namespace std;
 
+#define POTENTIALS_GOALPOST_SIZE 10             //!< the radius in cm of a goal post in the field made by makeField()
+#define POTENTIALS_GOALPOST_DONTCARE 40         //!< the distance in cm at which a goal post is no longer avoided
+#define POTENTIALS_TEAMMATE_SIZE 30             //!< the radius in cm of a team mate
+#define POTENTIALS_TEAMMATE_DONTCARE 70         //!< the distance in cm at which a team mate is no longer avoided
+#define POTENTIALS_ROBOT_SIZE 25                //!< the radius in cm of a robot seen in the image
+#define POTENTIALS_ROBOT_DONTCARE 60            //!< the distance in cm at which a robot seen in the image is no longer avoided
+
 class BehaviourPotentials 
 {
 public:
-    /*! @brief Returns a vector to go to a field state 
+    /*! @brief Builds the field of everything on the pitch to keep clear of this tick; the goal posts, the team mates, the
+               robots they can see and the robots seen in this image. The robot's position is the high rate field pose in the
+               sensors when there is one, as it is fresher than the self object's.
+        
+        The behaviour then adds its own attractors, potentials and the sonar, and evaluates the field once to get its walk.
+        @param field the field to build; anything already in it is removed
+        @param fieldobjects the field objects
+        @param teaminfo the team information, for the positions of the team mates. It may be NULL
+        @param sensors the sensors, for the field pose. It may be NULL
+     */
+    static void makeField(PotentialField& field, FieldObjects* fieldobjects, TeamInformation* teaminfo, NUSensorsData* sensors)
+    {
+        field.clear();
+        Self& self = fieldobjects->self;
+        vector<float> pose;
+        if (sensors == NULL or not sensors->getFieldPose(pose))
+        {
+            pose.resize(3);
+            pose[0] = self.wmX();
+            pose[1] = self.wmY();
+            pose[2] = self.Heading();
+        }
+        field.setPose(pose[0], pose[1], pose[2]);
+        
+        for (int i=FieldObjects::FO_BLUE_LEFT_GOALPOST; i<=FieldObjects::FO_YELLOW_RIGHT_GOALPOST; i++)
+        {
+            StationaryObject& post = fieldobjects->stationaryFieldObjects[i];
+            field.addRepulsor(post.X(), post.Y(), POTENTIALS_GOALPOST_SIZE, POTENTIALS_GOALPOST_DONTCARE);
+        }
+        
+        if (teaminfo != NULL)
+        {
+            for (int i=1; i<=TEAM_MAX_PLAYER_NUMBER; i++)
+            {
+                const TeamPacket* packet = teaminfo->getTeamPacket(i);
+                if (packet == NULL)
+                    continue;
+                field.addRepulsor(packet->Self.X, packet->Self.Y, POTENTIALS_TEAMMATE_SIZE, POTENTIALS_TEAMMATE_DONTCARE);
+                for (int j=0; j<packet->NumObstacles; j++)
+                {   // the robots the team mate can see, except those so close to me that they are most likely me
+                    float dx = packet->Obstacles[j].X - pose[0];
+                    float dy = packet->Obstacles[j].Y - pose[1];
+                    if (sqrt(dx*dx + dy*dy) > POTENTIALS_ROBOT_DONTCARE)
+                        field.addRepulsor(packet->Obstacles[j].X, packet->Obstacles[j].Y, POTENTIALS_ROBOT_SIZE, POTENTIALS_ROBOT_DONTCARE);
+                }
+            }
+        }
+        
+        for (size_t i=0; i<fieldobjects->ambiguousFieldObjects.size(); i++)
+        {
+            AmbiguousObject& robot = fieldobjects->ambiguousFieldObjects[i];
+            int id = robot.getID();
+            if (robot.isObjectVisible() and (id == FieldObjects::FO_ROBOT_UNKNOWN or id == FieldObjects::FO_BLUE_ROBOT_UNKNOWN or id == FieldObjects::FO_PINK_ROBOT_UNKNOWN))
+            {
+                float x = pose[0] + robot.measuredDistance()*cos(pose[2] + robot.measuredBearing());
+                float y = pose[1] + robot.measuredDistance()*sin(pose[2] + robot.measuredBearing());
+                field.addRepulsor(x, y, POTENTIALS_ROBOT_SIZE, POTENTIALS_ROBOT_DONTCARE);
+            }
+        }
+    }
+    
+    /*! @brief Returns a potential to go to a field state 
         @param self the self field object
         @param fieldstate the absolute position on the field [x(cm), y(cm), heading(rad)]
         @param stoppeddistance the distance in cm to the target at which the robot will stop walking, ie the accurarcy required.
         @param stoppingdistance the distance in cm from the target the robot will start to slow
         @param turningdistance the distance in cm from the target the robot will start to turn to face the desired heading
      */
-    static vector<float> goToFieldState(Self& self, const vector<float>& fieldstate, float stoppeddistance = 0, float stoppingdistance = 50, float turningdistance = 70)
+    static Potential goToFieldState(Self& self, const vector<float>& fieldstate, float stoppeddistance = 0, float stoppingdistance = 50, float turningdistance = 70)
     {
         vector<float> relativestate = self.CalculateDifferenceFromFieldState(fieldstate);
         return goToPoint(relativestate[0], relativestate[1], relativestate[2], stoppeddistance, stoppingdistance, turningdistance);
     }
     
-    /*! @brief Returns a vector to go to a field state 
+    /*! @brief Returns a potential to go to a field state 
         @param distance to the distance to the point
         @param bearing to the point
         @param heading the desired heading at the point
@@ -60,80 +132,28 @@ public:
         @param stoppingdistance the distance in cm from the target the robot will start to slow
         @param turningdistance the distance in cm from the target the robot will start to turn to face the desired heading
      */
-    static vector<float> goToPoint(float distance, float bearing, float heading, float stoppeddistance = 0, float stoppingdistance = 50, float turningdistance = 70)
+    static Potential goToPoint(float distance, float bearing, float heading, float stoppeddistance = 0, float stoppingdistance = 50, float turningdistance = 70)
     {
-        vector<float> result(3,0);
-        if (distance < stoppeddistance and fabs(heading) < 0.1)         // if we are close --- enough stop
-            return result;
-        else
-        {
-            // calculate the translational speed
-            if (distance < stoppingdistance)
-                result[0] = distance/stoppingdistance;
-            else
-                result[0] = 1;
-            // 'calculate' the translational direction
-            result[1] = bearing;
-            // calculate the rotational speed
-            if (distance < turningdistance)
-            {
-                if (fabs(heading) > 2.5)
-                    heading = fabs(heading);
-                result[2] = 0.5*heading;
-            }
-            else
-                result[2] = 0.5*bearing;
-            return result;
-        }
+        return PotentialField::goToPoint(distance, bearing, heading, stoppeddistance, stoppingdistance, turningdistance);
     }
     
-    /*! @brief Returns a vector to avoid a field state 
+    /*! @brief Returns a potential to avoid a field state 
         @param self the self field object
         @param fieldstate the absolute position on the field [x(cm), y(cm)]
         @param objectsize the radius in cm of the object to avoid
         @param dontcaredistance the distance in cm at which I make no attempt to avoid the object
      */
-    static vector<float> avoidFieldState(Self& self, vector<float>& fieldstate, float objectsize = 25, float dontcaredistance = 100)
+    static Potential avoidFieldState(Self& self, vector<float>& fieldstate, float objectsize = 25, float dontcaredistance = 100)
     {
-        vector<float> result(3,0);
         if (fieldstate.size() < 3)
             fieldstate.push_back(0);
         vector<float> relativestate = self.CalculateDifferenceFromFieldState(fieldstate);
-        
-        float distance = relativestate[0];
-        float bearing = relativestate[1];
-        
-        if (distance > dontcaredistance)
-        {   // if the object is too far away don't avoid it
-            return result;
-        }
-        else
-        {
-            // calculate the translational speed --- max if inside the object and reduces to zero at dontcaredistance
-            if (distance < objectsize)
-                result[0] = 1;
-            else
-                result[0] = (distance - dontcaredistance)/(objectsize - dontcaredistance);
-            // calculate the translational bearing --- away
-            if (fabs(bearing) < 0.1)
-                result[1] = mathGeneral::PI/2;
-            else
-                result[1] = bearing - mathGeneral::sign(bearing)*mathGeneral::PI/2;
-            // calculate the rotational speed --- spin facing object if infront, spin away if behind
-            float y = distance*sin(bearing);
-            float x = distance*cos(bearing);
-            if (fabs(y) < objectsize)
-                result[2] = atan2(y - mathGeneral::sign(y)*objectsize, x);
-            else
-                result[2] = 0;
-            
-            return result;
-        }
+        return PotentialField::avoidPoint(relativestate[0], relativestate[1], objectsize, dontcaredistance);
     }
     
-    /*! @brief Returns a vector to go to a ball
+    /*! @brief Returns a potential to go to a ball
      */
-    static vector<float> goToBall(MobileObject& ball, Self& self, float heading, float kickingdistance = 15.0, float stoppingdistance = 65)
+    static Potential goToBall(MobileObject& ball, Self& self, float heading, float kickingdistance = 15.0, float stoppingdistance = 65)
     {
         vector<float> ball_prediction = self.CalculateClosestInterceptToMobileObject(ball);
         if (ball_prediction[0] < 4 and ball.estimatedDistance() > 30)
@@ -144,7 +164,7 @@ public:
             float bearing = atan2(y,x);
             float heading = ball.estimatedBearing();
             
-            vector<float> speed = goToPoint(distance, bearing, 0, 0, 0, distance+9000);
+            Potential speed = goToPoint(distance, bearing, 0, 0, 0, distance+9000);
             
             #if DEBUG_BEHAVIOUR_VERBOSITY > 1
                 debug << "goToBall Predicated x:" << x << " y: " << y << " ballx: " << ball.estimatedDistance()*cos(heading) << " bally: " << ball.estimatedDistance()*sin(heading) << endl;
@@ -231,84 +251,28 @@ public:
                 around_rotation = 0;
             }
             
-            vector<float> speed(3,0);
-            speed[0] = max(position_speed, around_speed);
-            float xsum = position_speed*cos(position_direction) + around_speed*cos(around_direction);
-            float ysum = position_speed*sin(position_direction) + around_speed*sin(around_direction);
-            speed[1] = atan2(ysum, xsum);
-            speed[2] = position_rotation + around_rotation;
-            return speed;
+            Potential components[2] = {{position_speed, position_direction, position_rotation}, {around_speed, around_direction, around_rotation}};
+            return PotentialField::sum(components, 2);
         }
     }
     
     /*! @brief Returns a the vector sum of the potentials
-        @param potentials a list of [trans_speed, trans_direction, rot_speed] vectors
+        @param potentials the potentials to sum
+        @param n the number of potentials
      */
-    static vector<float> sumPotentials(const vector<vector<float> >& potentials)
+    static Potential sumPotentials(const Potential* potentials, int n)
     {
-        float xsum = 0;
-        float ysum = 0;
-        float yawsum = 0;
-        float maxspeed = 0;
-        for (size_t i=0; i<potentials.size(); i++)
-        {
-            if (potentials[i][0] > maxspeed)
-                maxspeed = potentials[i][0];
-            xsum += potentials[i][0]*cos(potentials[i][1]);
-            ysum += potentials[i][0]*sin(potentials[i][1]);
-            yawsum += potentials[i][2];
-        }
-        vector<float> result(3,0);
-        result[0] = maxspeed;
-        result[1] = atan2(ysum,xsum);
-        result[2] = yawsum;
-        return result;
+        return PotentialField::sum(potentials, n);
     }
     
-    /*! @brief Returns a vector as close to the original as possible without hitting obstacles detected by the sensors
-        @param speed the desired speed as [trans_speed, trans_direction, rot_speed]
+    /*! @brief Returns a potential as close to the original as possible without hitting obstacles detected by the sensors
+        @param speed the desired potential
      */
-    static vector<float> sensorAvoidObjects(const vector<float>& speed, NUSensorsData* sensors, float objectsize = 20, float dontcaredistance = 50)
+    static Potential sensorAvoidObjects(const Potential& speed, NUSensorsData* sensors, float objectsize = 20, float dontcaredistance = 50)
     {
-        // Get obstacle distances from the sensors
-        vector<float> temp;
-        float leftobstacle = 255;
-        float rightobstacle = 255;
-        if (sensors->get(NUSensorsData::LDistance, temp) and temp.size() > 0)
-            leftobstacle = temp[0];
-        if (sensors->get(NUSensorsData::RDistance, temp) and temp.size() > 0)
-            rightobstacle = temp[0];
-        
-        if (fabs(speed[1]) > mathGeneral::PI/2)
-        {   // if the speed is not in the range of the ultrasonic sensors then don't both dodging
-            return speed;
-        }
-        else if (leftobstacle > dontcaredistance and rightobstacle > dontcaredistance)
-        {   // if the obstacles are too far away don't dodge
-            return speed;
-        }
-        else
-        {   // an obstacle needs to be dodged
-            vector<float> newspeed = speed;
-            float obstacle = min(leftobstacle, rightobstacle);
-            float dodgeangle;
-            if (obstacle < objectsize)          // if we are 'inside' the object
-                dodgeangle = mathGeneral::PI/2 + asin((objectsize - obstacle)/objectsize);
-            else                                // if we are 'outside' the object
-                dodgeangle = asin(objectsize/obstacle);
-            
-            if (leftobstacle <= rightobstacle)
-            {   // the obstacle is on the left
-                if (speed[1] > -dodgeangle)
-                    newspeed[1] = -dodgeangle;
-            }
-            else
-            {   // the obstacle is on the right
-                if (speed[1] < dodgeangle)
-                    newspeed[1] = dodgeangle;
-            }
-            return newspeed;
-        }
+        float leftobstacle, rightobstacle;
+        PotentialField::getSonarDistances(sensors, leftobstacle, rightobstacle);
+        return PotentialField::sensorAvoid(speed, leftobstacle, rightobstacle, objectsize, dontcaredistance);
     }
     
     /*! @brief Returns the opponent's goal */
@@ -332,8 +296,17 @@ public:
     /*! @brief Returns the bearing to the opponent's goal */
     static float getBearingToOpponentGoal(FieldObjects* fieldobjects, GameInformation* gameinfo)
     {
-        vector<float> position = getOpponentGoalPosition(fieldobjects, gameinfo);
-        return position[1];
+        Self& self = fieldobjects->self;
+        return FieldGeometryMap::getInstance()->getGoalBearing(getOpponentGoalID(gameinfo), self.wmX(), self.wmY(), self.Heading());
+    }
+    
+    /*! @brief Returns the id of the opponent's goal in the FieldGeometryMap */
+    static FieldGeometryMap::Goal getOpponentGoalID(GameInformation* gameinfo)
+    {
+        if (gameinfo->getTeamColour() == GameInformation::RedTeam)
+            return FieldGeometryMap::BlueGoal;
+        else
+            return FieldGeometryMap::YellowGoal;
     }
     
     /*! @brief Returns your own goal */
@@ -357,8 +330,17 @@ public:
     /*! @brief Returns the bearing to your own goal */
     static float getBearingToOwnGoal(FieldObjects* fieldobjects, GameInformation* gameinfo)
     {
-        vector<float> position = getOwnGoalPosition(fieldobjects, gameinfo);
-        return position[1];
+        Self& self = fieldobjects->self;
+        return FieldGeometryMap::getInstance()->getGoalBearing(getOwnGoalID(gameinfo), self.wmX(), self.wmY(), self.Heading());
+    }
+    
+    /*! @brief Returns the id of your own goal in the FieldGeometryMap */
+    static FieldGeometryMap::Goal getOwnGoalID(GameInformation* gameinfo)
+    {
+        if (gameinfo->getTeamColour() == GameInformation::RedTeam)
+            return FieldGeometryMap::YellowGoal;
+        else
+            return FieldGeometryMap::BlueGoal;
     }
 
     /*! @brief Returns the [x,y] of the support player position */
@@ -394,23 +376,8 @@ public:
     /*! @brief Returns true if goal is lined up, false if it is not. */
     static bool opponentsGoalLinedUp(FieldObjects* fieldobjects, GameInformation* gameinfo)
     {
-        StationaryObject* targetGoalLeftPost;
-        StationaryObject* targetGoalRightPost;
         Self& self = fieldobjects->self;
-        if (gameinfo->getTeamColour() == GameInformation::RedTeam)
-        {
-            targetGoalLeftPost = &(fieldobjects->stationaryFieldObjects[FieldObjects::FO_BLUE_LEFT_GOALPOST]);
-            targetGoalRightPost = &(fieldobjects->stationaryFieldObjects[FieldObjects::FO_BLUE_RIGHT_GOALPOST]);
-        }
-        else
-        {
-            targetGoalLeftPost = &(fieldobjects->stationaryFieldObjects[FieldObjects::FO_YELLOW_LEFT_GOALPOST]);
-            targetGoalRightPost = &(fieldobjects->stationaryFieldObjects[FieldObjects::FO_YELLOW_RIGHT_GOALPOST]);
-        }
-        float leftGoalBearing = self.CalculateBearingToStationaryObject(*targetGoalLeftPost);
-        float rightGoalBearing = self.CalculateBearingToStationaryObject(*targetGoalRightPost);
-        float middleBearing = leftGoalBearing + rightGoalBearing / 2.0f;
-        return ((leftGoalBearing > 0.2f) && (rightGoalBearing < -0.2f)) || (fabs(middleBearing) < mathGeneral::PI/16.0f);
+        return FieldGeometryMap::getInstance()->isGoalLinedUp(getOpponentGoalID(gameinfo), self.wmX(), self.wmY(), self.Heading());
     }
 };
 
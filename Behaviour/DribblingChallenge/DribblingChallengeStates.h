@@ -98,8 +98,8 @@ public:
         else if (ball.TimeSinceLastSeen() > 250)
             m_jobs->addMotionJob(new HeadPanJob(ball));
         
-        vector<float> speed = BehaviourPotentials::goToBall(ball, self, BehaviourPotentials::getBearingToOpponentGoal(m_field_objects, m_game_info));
-        vector<float> result;
+        Potential speed = BehaviourPotentials::goToBall(ball, self, BehaviourPotentials::getBearingToOpponentGoal(m_field_objects, m_game_info));
+        Potential result;
         // decide whether we need to dodge or not
         float leftobstacle = 255;
         float rightobstacle = 255;
@@ -115,7 +115,7 @@ public:
         else
             result = speed;
         
-        m_jobs->addMotionJob(new WalkJob(result[0], result[1], result[2]));
+        m_jobs->addMotionJob(new WalkJob(result.Speed, result.Direction, result.Rotation));
     }
 };
 
@@ -226,8 +226,8 @@ protected:
         m_data->getMotionKickActive(iskicking);
         if(!iskicking)
         {
-            vector<float> speed = BehaviourPotentials::goToBall(ball, self, BehaviourPotentials::CalculateBestKickBearing(obstacles, m_field_objects, m_game_info));     // need target bearing
-            m_jobs->addMotionJob(new WalkJob(speed[0], speed[1], speed[2]));
+            Potential speed = BehaviourPotentials::goToBall(ball, self, BehaviourPotentials::CalculateBestKickBearing(obstacles, m_field_objects, m_game_info));     // need target bearing
+            m_jobs->addMotionJob(new WalkJob(speed.Speed, speed.Direction, speed.Rotation));
         }
         
         if (not iskicking and m_kick_was_active)
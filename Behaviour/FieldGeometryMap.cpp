@@ -0,0 +1,356 @@
+/*! @file FieldGeometryMap.cpp
+    @brief Implementation of precomputed maps of the field geometry
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "FieldGeometryMap.h"
+#include "Infrastructure/FieldObjects/FieldObjects.h"
+#include "Tools/Math/General.h"
+
+#include "debug.h"
+#include "debugverbositybehaviour.h"
+#include "nubotdataconfig.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <pthread.h>
+using namespace std;
+
+static const char FieldGeometryMagic[4] = {'N', 'U', 'F', 'G'};
+static pthread_once_t FieldGeometryOnce = PTHREAD_ONCE_INIT;
+FieldGeometryMap* FieldGeometryMap::Instance = NULL;
+
+/*! @brief Returns the single FieldGeometryMap instance. The first call loads the maps from CONFIG_DIR/FieldGeometry.map,
+           or if that fails, generates them and saves them there. It is safe to call from any thread; the first call
+           from each other thread waits until the maps are ready.
+ */
+FieldGeometryMap* FieldGeometryMap::getInstance()
+{
+    pthread_once(&FieldGeometryOnce, createInstance);
+    return Instance;
+}
+
+/*! @brief Creates, and loads or generates, the single instance. Called once by getInstance() */
+void FieldGeometryMap::createInstance()
+{
+    FieldGeometryMap* instance = new FieldGeometryMap();
+    string filename = CONFIG_DIR + string(FIELD_GEOMETRY_FILENAME);
+    if (not instance->load(filename))
+    {
+        errorlog << "FieldGeometryMap::getInstance(). Generating the maps on the robot because " << filename << " could not be loaded. Use fieldgeometrymap to make it offline." << endl;
+        instance->generate();
+        instance->save(filename);
+    }
+    Instance = instance;
+}
+
+/*! @brief Creates an empty map. Either generate() or load() needs to be called before it can be used.
+           The size of the field is taken from the positions of the field corners in FieldObjects.
+ */
+FieldGeometryMap::FieldGeometryMap()
+{
+    FieldObjects objects;
+    const StationaryObject& corner = objects.stationaryFieldObjects[FieldObjects::FO_CORNER_YELLOW_FIELD_LEFT];
+    m_half_length = fabs(corner.X());
+    m_half_width = fabs(corner.Y());
+    m_x_min = -(m_half_length + FIELD_GEOMETRY_MARGIN);
+    m_y_min = -(m_half_width + FIELD_GEOMETRY_MARGIN);
+    m_width = static_cast<int>(-2*m_x_min/FIELD_GEOMETRY_RESOLUTION + 0.5) + 1;
+    m_height = static_cast<int>(-2*m_y_min/FIELD_GEOMETRY_RESOLUTION + 0.5) + 1;
+}
+
+FieldGeometryMap::~FieldGeometryMap()
+{
+}
+
+/*! @brief Calculates the maps from the positions of the stationary field objects */
+void FieldGeometryMap::generate()
+{
+    FieldObjects objects;
+    vector<StationaryObject>& landmarks = objects.stationaryFieldObjects;
+    int numlandmarks = min(static_cast<int>(landmarks.size()), 32);
+
+    m_maps.assign(NumMaps*m_width*m_height, 0);
+    m_visible.assign(FIELD_GEOMETRY_HEADINGS*m_width*m_height, 0);
+    vector<float> landmarkdistance(numlandmarks, 0);
+    vector<float> landmarkdirection(numlandmarks, 0);
+    for (int j=0; j<m_height; j++)
+    {
+        float y = m_y_min + j*FIELD_GEOMETRY_RESOLUTION;
+        for (int i=0; i<m_width; i++)
+        {
+            float x = m_x_min + i*FIELD_GEOMETRY_RESOLUTION;
+            for (int g=0; g<NumGoals; g++)
+            {
+                const StationaryObject& leftpost = landmarks[g == BlueGoal ? FieldObjects::FO_BLUE_LEFT_GOALPOST : FieldObjects::FO_YELLOW_LEFT_GOALPOST];
+                const StationaryObject& rightpost = landmarks[g == BlueGoal ? FieldObjects::FO_BLUE_RIGHT_GOALPOST : FieldObjects::FO_YELLOW_RIGHT_GOALPOST];
+
+                // the same calculations as Self::CalculateDifferenceFromGoal() and Self::CalculateAngularWidthOfGoal()
+                float diffX = leftpost.X() - x;
+                float diffY = -y;
+                if (diffX == 0 and diffY == 0)
+                    diffY = 0.0001;
+                float distance = sqrt(diffX*diffX + diffY*diffY);
+                float direction = atan2(diffY, diffX);
+                float width = 2*fabs(leftpost.Y());
+                float angularwidth = atan2(width*cos(direction), 2*distance + width*sin(direction)) + atan2(width*cos(direction), 2*distance - width*sin(direction));
+
+                at(g*NumGoalMaps + GoalDistance, i, j) = distance;
+                at(g*NumGoalMaps + GoalDirection, i, j) = direction;
+                at(g*NumGoalMaps + GoalWidth, i, j) = angularwidth;
+                at(g*NumGoalMaps + LeftPostDirection, i, j) = atan2(leftpost.Y() - y, leftpost.X() - x);
+                at(g*NumGoalMaps + RightPostDirection, i, j) = atan2(rightpost.Y() - y, rightpost.X() - x);
+            }
+
+            // the distance to the boundary lines; positive inside the field and negative outside
+            float outsideX = fabs(x) - m_half_length;
+            float outsideY = fabs(y) - m_half_width;
+            if (outsideX <= 0 and outsideY <= 0)
+                at(BoundaryDistance, i, j) = -max(outsideX, outsideY);
+            else
+                at(BoundaryDistance, i, j) = -sqrt(pow(max(outsideX, 0.0f), 2) + pow(max(outsideY, 0.0f), 2));
+
+            // the landmarks that can be seen at each heading
+            for (int k=0; k<numlandmarks; k++)
+            {
+                float dx = landmarks[k].X() - x;
+                float dy = landmarks[k].Y() - y;
+                landmarkdistance[k] = sqrt(dx*dx + dy*dy);
+                landmarkdirection[k] = atan2(dy, dx);
+            }
+            unsigned int* masks = &m_visible[FIELD_GEOMETRY_HEADINGS*(j*m_width + i)];
+            for (int h=0; h<FIELD_GEOMETRY_HEADINGS; h++)
+            {
+                float heading = h*2*mathGeneral::PI/FIELD_GEOMETRY_HEADINGS;
+                unsigned int mask = 0;
+                for (int k=0; k<numlandmarks; k++)
+                {
+                    if (landmarkdistance[k] < FIELD_GEOMETRY_VIEW_DISTANCE and fabs(mathGeneral::normaliseAngle(landmarkdirection[k] - heading)) < FIELD_GEOMETRY_VIEW_ANGLE)
+                        mask |= 1u << k;
+                }
+                masks[h] = mask;
+            }
+        }
+    }
+}
+
+/*! @brief Loads the maps from a file made by save()
+    @return false if the file could not be read, or was made for a different version or grid
+ */
+bool FieldGeometryMap::load(const string& filename)
+{
+    ifstream file(filename.c_str(), ios_base::in | ios_base::binary);
+    if (not file.is_open())
+        return false;
+
+    char magic[4];
+    int header[7];
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (not file.good() or not equal(magic, magic + 4, FieldGeometryMagic))
+        return false;
+    if (header[0] != FIELD_GEOMETRY_VERSION or header[1] != m_width or header[2] != m_height or header[3] != FIELD_GEOMETRY_HEADINGS or header[4] != NumMaps
+        or header[5] != static_cast<int>(m_half_length) or header[6] != static_cast<int>(m_half_width))
+    {
+        errorlog << "FieldGeometryMap::load(). " << filename << " is for a different version, grid or field, and will be regenerated" << endl;
+        return false;
+    }
+
+    vector<float> maps(NumMaps*m_width*m_height);
+    vector<unsigned int> visible(FIELD_GEOMETRY_HEADINGS*m_width*m_height);
+    file.read(reinterpret_cast<char*>(&maps[0]), maps.size()*sizeof(float));
+    file.read(reinterpret_cast<char*>(&visible[0]), visible.size()*sizeof(unsigned int));
+    if (not file.good())
+    {
+        errorlog << "FieldGeometryMap::load(). " << filename << " is truncated" << endl;
+        return false;
+    }
+    m_maps.swap(maps);
+    m_visible.swap(visible);
+    return true;
+}
+
+/*! @brief Saves the maps to a file that can be loaded with load()
+    @return false if the file could not be written
+ */
+bool FieldGeometryMap::save(const string& filename) const
+{
+    if (m_maps.empty())
+        return false;
+    ofstream file(filename.c_str(), ios_base::out | ios_base::binary | ios_base::trunc);
+    if (not file.is_open())
+    {
+        errorlog << "FieldGeometryMap::save(). Unable to open " << filename << endl;
+        return false;
+    }
+    int header[7] = {FIELD_GEOMETRY_VERSION, m_width, m_height, FIELD_GEOMETRY_HEADINGS, NumMaps, static_cast<int>(m_half_length), static_cast<int>(m_half_width)};
+    file.write(FieldGeometryMagic, sizeof(FieldGeometryMagic));
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(&m_maps[0]), m_maps.size()*sizeof(float));
+    file.write(reinterpret_cast<const char*>(&m_visible[0]), m_visible.size()*sizeof(unsigned int));
+    return file.good();
+}
+
+/*! @brief Returns the distance in cm from [x, y] to the centre of the goal */
+float FieldGeometryMap::getGoalDistance(Goal goal, float x, float y) const
+{
+    return interpolate(goal*NumGoalMaps + GoalDistance, x, y);
+}
+
+/*! @brief Returns the bearing from [x, y, heading] to the centre of the goal */
+float FieldGeometryMap::getGoalBearing(Goal goal, float x, float y, float heading) const
+{
+    return mathGeneral::normaliseAngle(interpolateAngle(goal*NumGoalMaps + GoalDirection, x, y) - heading);
+}
+
+/*! @brief Returns the angle in radians between the goal posts seen from [x, y] */
+float FieldGeometryMap::getGoalAngularWidth(Goal goal, float x, float y) const
+{
+    return interpolate(goal*NumGoalMaps + GoalWidth, x, y);
+}
+
+/*! @brief Returns the bearing from [x, y, heading] to the goal's left post */
+float FieldGeometryMap::getLeftPostBearing(Goal goal, float x, float y, float heading) const
+{
+    return mathGeneral::normaliseAngle(interpolateAngle(goal*NumGoalMaps + LeftPostDirection, x, y) - heading);
+}
+
+/*! @brief Returns the bearing from [x, y, heading] to the goal's right post */
+float FieldGeometryMap::getRightPostBearing(Goal goal, float x, float y, float heading) const
+{
+    return mathGeneral::normaliseAngle(interpolateAngle(goal*NumGoalMaps + RightPostDirection, x, y) - heading);
+}
+
+/*! @brief Returns true if a robot at [x, y, heading] is lined up to kick into the goal. The same test as BehaviourPotentials::opponentsGoalLinedUp() */
+bool FieldGeometryMap::isGoalLinedUp(Goal goal, float x, float y, float heading) const
+{
+    float leftGoalBearing = getLeftPostBearing(goal, x, y, heading);
+    float rightGoalBearing = getRightPostBearing(goal, x, y, heading);
+    float middleBearing = leftGoalBearing + rightGoalBearing / 2.0f;
+    return ((leftGoalBearing > 0.2f) && (rightGoalBearing < -0.2f)) || (fabs(middleBearing) < mathGeneral::PI/16.0f);
+}
+
+/*! @brief Returns the distance in cm from [x, y] to the nearest boundary line. The distance is negative outside the field */
+float FieldGeometryMap::getBoundaryDistance(float x, float y) const
+{
+    return interpolate(BoundaryDistance, x, y);
+}
+
+/*! @brief Returns a mask of the stationary field objects that could be seen from [x, y, heading].
+           Bit i is set if the object with StationaryFieldObjectID i could be seen.
+ */
+unsigned int FieldGeometryMap::getVisibleLandmarks(float x, float y, float heading) const
+{
+    if (m_visible.empty())
+        return 0;
+    int h = static_cast<int>(floor(heading*FIELD_GEOMETRY_HEADINGS/(2*mathGeneral::PI) + 0.5)) % FIELD_GEOMETRY_HEADINGS;
+    if (h < 0)
+        h += FIELD_GEOMETRY_HEADINGS;
+    return m_visible[FIELD_GEOMETRY_HEADINGS*getNearestCell(x, y) + h];
+}
+
+/*! @brief Returns true if the stationary field object with the given id could be seen from [x, y, heading] */
+bool FieldGeometryMap::isLandmarkVisible(int id, float x, float y, float heading) const
+{
+    if (id < 0 or id >= 32)
+        return false;
+    return (getVisibleLandmarks(x, y, heading) >> id) & 1u;
+}
+
+/*! @brief Returns the distance from the centre to the goal lines in cm */
+float FieldGeometryMap::getHalfLength() const
+{
+    return m_half_length;
+}
+
+/*! @brief Returns the distance from the centre to the side lines in cm */
+float FieldGeometryMap::getHalfWidth() const
+{
+    return m_half_width;
+}
+
+/*! @brief Bilinearly interpolates a map at [x, y] */
+float FieldGeometryMap::interpolate(int map, float x, float y) const
+{
+    if (m_maps.empty())
+        return 0;
+    int i, j;
+    float fx, fy;
+    getCell(x, y, i, j, fx, fy);
+    float bottom = at(map, i, j) + fx*(at(map, i + 1, j) - at(map, i, j));
+    float top = at(map, i, j + 1) + fx*(at(map, i + 1, j + 1) - at(map, i, j + 1));
+    return bottom + fy*(top - bottom);
+}
+
+/*! @brief Bilinearly interpolates a map of angles at [x, y], going the short way round between the grid points */
+float FieldGeometryMap::interpolateAngle(int map, float x, float y) const
+{
+    if (m_maps.empty())
+        return 0;
+    int i, j;
+    float fx, fy;
+    getCell(x, y, i, j, fx, fy);
+    float a00 = at(map, i, j);
+    float a10 = a00 + mathGeneral::normaliseAngle(at(map, i + 1, j) - a00);
+    float a01 = a00 + mathGeneral::normaliseAngle(at(map, i, j + 1) - a00);
+    float a11 = a00 + mathGeneral::normaliseAngle(at(map, i + 1, j + 1) - a00);
+    float bottom = a00 + fx*(a10 - a00);
+    float top = a01 + fx*(a11 - a01);
+    return mathGeneral::normaliseAngle(bottom + fy*(top - bottom));
+}
+
+/*! @brief Gets the grid cell containing [x, y], and the position within the cell. Positions off the grid are clipped to its edge.
+    @param i will be updated with the index of the grid point to the left of x
+    @param j will be updated with the index of the grid point below y
+    @param fx will be updated with the fraction [0, 1] of the way x is between i and i + 1
+    @param fy will be updated with the fraction [0, 1] of the way y is between j and j + 1
+ */
+void FieldGeometryMap::getCell(float x, float y, int& i, int& j, float& fx, float& fy) const
+{
+    float gx = (x - m_x_min)/FIELD_GEOMETRY_RESOLUTION;
+    float gy = (y - m_y_min)/FIELD_GEOMETRY_RESOLUTION;
+    gx = mathGeneral::crop(gx, 0.0f, m_width - 1.001f);
+    gy = mathGeneral::crop(gy, 0.0f, m_height - 1.001f);
+    i = static_cast<int>(gx);
+    j = static_cast<int>(gy);
+    fx = gx - i;
+    fy = gy - j;
+}
+
+/*! @brief Returns the index of the grid point nearest to [x, y] */
+int FieldGeometryMap::getNearestCell(float x, float y) const
+{
+    int i = static_cast<int>(floor((x - m_x_min)/FIELD_GEOMETRY_RESOLUTION + 0.5));
+    int j = static_cast<int>(floor((y - m_y_min)/FIELD_GEOMETRY_RESOLUTION + 0.5));
+    i = mathGeneral::crop(i, 0, m_width - 1);
+    j = mathGeneral::crop(j, 0, m_height - 1);
+    return j*m_width + i;
+}
+
+float& FieldGeometryMap::at(int map, int i, int j)
+{
+    return m_maps[(map*m_height + j)*m_width + i];
+}
+
+float FieldGeometryMap::at(int map, int i, int j) const
+{
+    return m_maps[(map*m_height + j)*m_width + i];
+}
+
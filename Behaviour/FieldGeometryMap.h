@@ -0,0 +1,128 @@
+/*! @file FieldGeometryMap.h
+    @brief Declaration of precomputed maps of the field geometry
+
+    @class FieldGeometryMap
+    @brief Lookup tables of the geometry of the fixed field landmarks over a grid of field positions
+
+    Every FIELD_GEOMETRY_RESOLUTION cm across the field (and FIELD_GEOMETRY_MARGIN past its edges) the map stores
+        - the distance, direction and angular width of each goal
+        - the direction to each goal post
+        - the distance to the nearest field line on the boundary (negative when outside)
+    and for each of FIELD_GEOMETRY_HEADINGS headings a bit mask of the stationary field objects
+    that could be seen by panning the head.
+
+    Directions are measured from the field x-axis, so the robot's heading is only subtracted at
+    query time and does not need to be part of the grid. Queries bilinearly interpolate between
+    the four surrounding grid points; the visibility mask is taken from the nearest grid point.
+
+    The maps, and the size of the field, are generated from the landmark positions in FieldObjects.
+    They take a while to generate on the robot, so they are generated offline with the
+    fieldgeometrymap tool (NUBOT_BUILD_FIELD_GEOMETRY_MAP) into Config/<robot>/FieldGeometry.map,
+    and sent to the robot with the rest of its configuration. The single instance is loaded from
+    CONFIG_DIR/FieldGeometry.map when behaviour starts, and the maps are only generated (and saved
+    for next time) when that file is missing or out of date.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef FIELD_GEOMETRY_MAP_H
+#define FIELD_GEOMETRY_MAP_H
+
+#include <vector>
+#include <string>
+
+#define FIELD_GEOMETRY_VERSION 2                //!< the version of the map file; increment it whenever the contents of the maps change
+#define FIELD_GEOMETRY_FILENAME "FieldGeometry.map" //!< the name of the map file in CONFIG_DIR
+#define FIELD_GEOMETRY_MARGIN 70.0              //!< the distance the grid extends past the boundary lines in cm
+#define FIELD_GEOMETRY_RESOLUTION 10.0          //!< the spacing of the grid in cm
+#define FIELD_GEOMETRY_HEADINGS 32              //!< the number of headings in the visibility masks
+#define FIELD_GEOMETRY_VIEW_DISTANCE 450.0      //!< landmarks further away than this are not expected to be seen (cm)
+#define FIELD_GEOMETRY_VIEW_ANGLE 1.0           //!< landmarks more than this from the heading are not expected to be seen (rad)
+
+class FieldGeometryMap
+{
+public:
+    enum Goal
+    {
+        BlueGoal = 0,
+        YellowGoal = 1,
+        NumGoals = 2
+    };
+
+    static FieldGeometryMap* getInstance();
+
+    FieldGeometryMap();
+    ~FieldGeometryMap();
+
+    void generate();
+    bool load(const std::string& filename);
+    bool save(const std::string& filename) const;
+
+    float getGoalDistance(Goal goal, float x, float y) const;
+    float getGoalBearing(Goal goal, float x, float y, float heading) const;
+    float getGoalAngularWidth(Goal goal, float x, float y) const;
+    float getLeftPostBearing(Goal goal, float x, float y, float heading) const;
+    float getRightPostBearing(Goal goal, float x, float y, float heading) const;
+    bool isGoalLinedUp(Goal goal, float x, float y, float heading) const;
+    float getBoundaryDistance(float x, float y) const;
+    unsigned int getVisibleLandmarks(float x, float y, float heading) const;
+    bool isLandmarkVisible(int id, float x, float y, float heading) const;
+
+    float getHalfLength() const;
+    float getHalfWidth() const;
+
+private:
+    /*! @brief The maps stored for each goal */
+    enum GoalMap
+    {
+        GoalDistance = 0,
+        GoalDirection = 1,
+        GoalWidth = 2,
+        LeftPostDirection = 3,
+        RightPostDirection = 4,
+        NumGoalMaps = 5
+    };
+    /*! @brief The map ids; the goal maps for goal g are g*NumGoalMaps + GoalMap */
+    enum MapID
+    {
+        BoundaryDistance = NumGoals*NumGoalMaps,
+        NumMaps = NumGoals*NumGoalMaps + 1
+    };
+
+    float interpolate(int map, float x, float y) const;
+    float interpolateAngle(int map, float x, float y) const;
+    void getCell(float x, float y, int& i, int& j, float& fx, float& fy) const;
+    int getNearestCell(float x, float y) const;
+    float& at(int map, int i, int j);
+    float at(int map, int i, int j) const;
+    static void createInstance();
+
+private:
+    static FieldGeometryMap* Instance;          //!< the single instance, created by the first getInstance()
+    float m_half_length;                        //!< the distance from the centre to the goal lines in cm
+    float m_half_width;                         //!< the distance from the centre to the side lines in cm
+    float m_x_min;                              //!< the smallest x coordinate of the grid in cm
+    float m_y_min;                              //!< the smallest y coordinate of the grid in cm
+    int m_width;                                //!< the number of grid points along the x-axis
+    int m_height;                               //!< the number of grid points along the y-axis
+    std::vector<float> m_maps;                  //!< the maps, one after the other, each stored one row of constant y at a time
+    std::vector<unsigned int> m_visible;        //!< the visibility masks, FIELD_GEOMETRY_HEADINGS for each grid point
+};
+
+#endif
+
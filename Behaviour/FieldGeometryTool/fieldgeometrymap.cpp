@@ -0,0 +1,76 @@
+/*! @file fieldgeometrymap.cpp
+    @brief The fieldgeometrymap executable. Generates the FieldGeometryMap offline.
+
+    Usage: fieldgeometrymap [output file]
+
+    The maps are generated from FieldObjects, saved (by default to FieldGeometry.map in the current directory),
+    and loaded back to check the file. Put the file in Config/<robot>/ so that it is sent to the robot with
+    the rest of its configuration; otherwise the robot has to generate the maps itself when behaviour starts.
+    Use a build with NUBOT_BUILD_FIELD_GEOMETRY_MAP ON.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Behaviour/FieldGeometryMap.h"
+
+#include "debug.h"
+
+#include <cmath>
+using namespace std;
+
+ofstream debug;
+ofstream errorlog;
+
+int main(int argc, const char *argv[])
+{
+    debug.open("fieldgeometrymapdebug.log");
+    errorlog.open("fieldgeometrymaperror.log");
+
+    string filename = argc > 1 ? argv[1] : FIELD_GEOMETRY_FILENAME;
+    FieldGeometryMap map;
+    cout << "Generating the maps for a " << 2*map.getHalfLength() << "x" << 2*map.getHalfWidth() << "cm field" << endl;
+    map.generate();
+    if (not map.save(filename))
+    {
+        cerr << "fieldgeometrymap: unable to write " << filename << endl;
+        return 1;
+    }
+
+    // load the file back, and check a few positions agree with the generated maps
+    FieldGeometryMap loaded;
+    if (not loaded.load(filename))
+    {
+        cerr << "fieldgeometrymap: unable to load " << filename << " back" << endl;
+        return 1;
+    }
+    for (float x = -map.getHalfLength(); x <= map.getHalfLength(); x += 37)
+    {
+        for (float y = -map.getHalfWidth(); y <= map.getHalfWidth(); y += 29)
+        {
+            if (loaded.getGoalDistance(FieldGeometryMap::BlueGoal, x, y) != map.getGoalDistance(FieldGeometryMap::BlueGoal, x, y)
+                or loaded.getBoundaryDistance(x, y) != map.getBoundaryDistance(x, y)
+                or loaded.getVisibleLandmarks(x, y, 0) != map.getVisibleLandmarks(x, y, 0))
+            {
+                cerr << "fieldgeometrymap: " << filename << " does not match the generated maps at [" << x << ", " << y << "]" << endl;
+                return 1;
+            }
+        }
+    }
+    cout << "Saved " << filename << endl;
+    return 0;
+}
@@ -119,8 +119,8 @@ public:
         }
 
         
-        vector<float> speed = BehaviourPotentials::goToFieldState(m_field_objects->self, position, 5, 60, 200);
-        m_jobs->addMotionJob(new WalkJob(speed[0], speed[1], speed[2]));
+        Potential speed = BehaviourPotentials::goToFieldState(m_field_objects->self, position, 5, 60, 200);
+        m_jobs->addMotionJob(new WalkJob(speed.Speed, speed.Direction, speed.Rotation));
     }
 };
 
@@ -157,8 +157,8 @@ protected:
         
         if(!iskicking)
         {
-            vector<float> speed = BehaviourPotentials::goToBall(ball, self, bearing_to_goal);
-            m_jobs->addMotionJob(new WalkJob(speed[0], speed[1], speed[2]));
+            Potential speed = BehaviourPotentials::goToBall(ball, self, bearing_to_goal);
+            m_jobs->addMotionJob(new WalkJob(speed.Speed, speed.Direction, speed.Rotation));
         }
         
         if( (ball.estimatedDistance() < 20.0f) && fabs(bearing_to_goal) < 3.1416/8)
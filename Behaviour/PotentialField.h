@@ -0,0 +1,413 @@
+/*! @file PotentialField.h
+    @brief Declaration of a fixed size potential field made from attractors, repulsors and the sonar
+
+    @class PotentialField
+    @brief A potential field that evaluates all of its attractors and repulsors in a single pass
+
+    The attractors and repulsors are absolute field positions, stored in fixed size arrays, so building and
+    evaluating the field never allocates. A behaviour builds one field each time it is run, with everything
+    it needs to go to or keep clear of (BehaviourPotentials::makeField() adds the goal posts, team mates and
+    obstacles), and evaluates it once at the robot's position to get its walk. A field can also be evaluated
+    at a batch of candidate positions (eg. a grid made with makeGrid()) to search for the best place to stand.
+
+    Each potential is a Potential [trans_speed, trans_direction, rotational_speed], and the attractors,
+    repulsors and sonar use the same motor schemas as BehaviourPotentials.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef POTENTIAL_FIELD_H
+#define POTENTIAL_FIELD_H
+
+#include "Infrastructure/FieldObjects/Self.h"
+#include "Infrastructure/NUSensorsData/NUSensorsData.h"
+#include "Tools/Math/General.h"
+
+#include <cmath>
+#include <vector>
+
+#define POTENTIAL_FIELD_MAX_ATTRACTORS 4        //!< the maximum number of attractors in a field
+#define POTENTIAL_FIELD_MAX_REPULSORS 64        //!< the maximum number of repulsors in a field
+#define POTENTIAL_FIELD_MAX_POTENTIALS 4        //!< the maximum number of potentials relative to the robot in a field
+#define POTENTIAL_FIELD_MAX_POSITIONS 256       //!< the maximum number of positions made by makeGrid()
+
+/*! @brief A motor schema output [trans_speed, trans_direction, rotational_speed] */
+struct Potential
+{
+    float Speed;                    //!< the translational speed [0,1]
+    float Direction;                //!< the translational direction in rad
+    float Rotation;                 //!< the rotational speed
+};
+
+class PotentialField
+{
+public:
+    PotentialField()
+    {
+        clear();
+        setPose(0, 0, 0);
+    }
+
+    /*! @brief Removes all of the attractors, repulsors, potentials and the sonar */
+    void clear()
+    {
+        m_num_attractors = 0;
+        m_num_repulsors = 0;
+        m_num_potentials = 0;
+        m_has_sonar = false;
+    }
+
+    /*! @brief Sets the robot's position on the field from the self object */
+    void setSelf(Self& self)
+    {
+        setPose(self.wmX(), self.wmY(), self.Heading());
+    }
+
+    /*! @brief Sets the robot's position on the field [x(cm), y(cm), heading(rad)] */
+    void setPose(float x, float y, float heading)
+    {
+        m_x = x;
+        m_y = y;
+        m_heading = heading;
+    }
+
+    /*! @brief Adds a field state to go to. The parameters are the same as BehaviourPotentials::goToFieldState()
+        @return false if there are already POTENTIAL_FIELD_MAX_ATTRACTORS attractors
+     */
+    bool addAttractor(float x, float y, float heading, float stoppeddistance = 0, float stoppingdistance = 50, float turningdistance = 70)
+    {
+        if (m_num_attractors >= POTENTIAL_FIELD_MAX_ATTRACTORS)
+            return false;
+        int i = m_num_attractors++;
+        m_attractor_x[i] = x;
+        m_attractor_y[i] = y;
+        m_attractor_heading[i] = heading;
+        m_attractor_stopped[i] = stoppeddistance;
+        m_attractor_stopping[i] = stoppingdistance;
+        m_attractor_turning[i] = turningdistance;
+        return true;
+    }
+
+    /*! @brief Adds a field position to avoid. The parameters are the same as BehaviourPotentials::avoidFieldState()
+        @return false if there are already POTENTIAL_FIELD_MAX_REPULSORS repulsors
+     */
+    bool addRepulsor(float x, float y, float objectsize = 25, float dontcaredistance = 100)
+    {
+        if (m_num_repulsors >= POTENTIAL_FIELD_MAX_REPULSORS)
+            return false;
+        int i = m_num_repulsors++;
+        m_repulsor_x[i] = x;
+        m_repulsor_y[i] = y;
+        m_repulsor_size[i] = objectsize;
+        m_repulsor_dontcare[i] = dontcaredistance;
+        return true;
+    }
+
+    /*! @brief Adds the obstacles detected by the sonar. They are relative to the robot, so only affect evaluate() at the robot's position.
+               The parameters are the same as BehaviourPotentials::sensorAvoidObjects()
+     */
+    void addSonar(NUSensorsData* sensors, float objectsize = 20, float dontcaredistance = 50)
+    {
+        float leftobstacle, rightobstacle;
+        getSonarDistances(sensors, leftobstacle, rightobstacle);
+        setSonar(leftobstacle, rightobstacle, objectsize, dontcaredistance);
+    }
+
+    /*! @brief Sets the closest obstacle on the left and right in cm. The other parameters are the same as addSonar() */
+    void setSonar(float leftobstacle, float rightobstacle, float objectsize = 20, float dontcaredistance = 50)
+    {
+        m_sonar_left = leftobstacle;
+        m_sonar_right = rightobstacle;
+        m_sonar_size = objectsize;
+        m_sonar_dontcare = dontcaredistance;
+        m_has_sonar = true;
+    }
+
+    /*! @brief Adds a potential that is already relative to the robot, such as BehaviourPotentials::goToBall().
+               Like the sonar it only affects evaluate() at the robot's position.
+        @return false if there are already POTENTIAL_FIELD_MAX_POTENTIALS potentials
+     */
+    bool addPotential(const Potential& potential)
+    {
+        if (m_num_potentials >= POTENTIAL_FIELD_MAX_POTENTIALS)
+            return false;
+        m_potentials[m_num_potentials++] = potential;
+        return true;
+    }
+
+    /*! @brief Returns the potential at the robot's position; the sum of every attractor, repulsor and potential, dodged around the sonar */
+    Potential evaluate() const
+    {
+        float xsum, ysum, yawsum, maxspeed;
+        sumAt(m_x, m_y, m_heading, xsum, ysum, yawsum, maxspeed);
+        for (int i=0; i<m_num_potentials; i++)
+            accumulate(m_potentials[i], xsum, ysum, yawsum, maxspeed);
+        Potential result = {maxspeed, atan2(ysum, xsum), yawsum};
+        if (m_has_sonar)
+            result = sensorAvoid(result, m_sonar_left, m_sonar_right, m_sonar_size, m_sonar_dontcare);
+        return result;
+    }
+
+    /*! @brief Evaluates the field at a batch of positions, as if the robot was standing at each of them with its current heading
+        @param x the x coordinates of the positions (cm)
+        @param y the y coordinates of the positions (cm)
+        @param n the number of positions
+        @param potentials will be updated with the potential at each position
+     */
+    void evaluate(const float* x, const float* y, int n, Potential* potentials) const
+    {
+        for (int i=0; i<n; i++)
+            potentials[i] = evaluateAt(x[i], y[i], m_heading);
+    }
+
+    /*! @brief Returns the index of the best of a batch of positions.
+
+        The best position is where the attractors and repulsors balance, ie. the length of the summed translational vector
+        is the smallest, plus travelcost for each metre the robot would need to walk to get there.
+        @return the index of the best position, or -1 if n is zero
+     */
+    int findBestPosition(const float* x, const float* y, int n, float travelcost = 0.1) const
+    {
+        int best = -1;
+        float bestcost = 0;
+        for (int i=0; i<n; i++)
+        {
+            float xsum, ysum, yawsum, maxspeed;
+            sumAt(x[i], y[i], m_heading, xsum, ysum, yawsum, maxspeed);
+            float dx = x[i] - m_x;
+            float dy = y[i] - m_y;
+            float cost = sqrt(xsum*xsum + ysum*ysum) + travelcost*sqrt(dx*dx + dy*dy)/100;
+            if (best < 0 or cost < bestcost)
+            {
+                best = i;
+                bestcost = cost;
+            }
+        }
+        return best;
+    }
+
+    /*! @brief Fills x and y with a nx by ny grid of positions covering [xmin, xmax] by [ymin, ymax]
+        @return the number of positions in the grid, at most POTENTIAL_FIELD_MAX_POSITIONS
+     */
+    static int makeGrid(float xmin, float xmax, float ymin, float ymax, int nx, int ny, float* x, float* y)
+    {
+        float dx = nx > 1 ? (xmax - xmin)/(nx - 1) : 0;
+        float dy = ny > 1 ? (ymax - ymin)/(ny - 1) : 0;
+        int n = 0;
+        for (int i=0; i<nx; i++)
+        {
+            for (int j=0; j<ny and n<POTENTIAL_FIELD_MAX_POSITIONS; j++)
+            {
+                x[n] = xmin + i*dx;
+                y[n] = ymin + j*dy;
+                n++;
+            }
+        }
+        return n;
+    }
+
+    /*! @brief The motor schema to go to a point. See BehaviourPotentials::goToPoint() */
+    static Potential goToPoint(float distance, float bearing, float heading, float stoppeddistance, float stoppingdistance, float turningdistance)
+    {
+        Potential result = {0, 0, 0};
+        if (distance < stoppeddistance and fabs(heading) < 0.1)         // if we are close --- enough stop
+            return result;
+
+        // calculate the translational speed
+        if (distance < stoppingdistance)
+            result.Speed = distance/stoppingdistance;
+        else
+            result.Speed = 1;
+        // 'calculate' the translational direction
+        result.Direction = bearing;
+        // calculate the rotational speed
+        if (distance < turningdistance)
+        {
+            if (fabs(heading) > 2.5)
+                heading = fabs(heading);
+            result.Rotation = 0.5*heading;
+        }
+        else
+            result.Rotation = 0.5*bearing;
+        return result;
+    }
+
+    /*! @brief The motor schema to avoid a point. See BehaviourPotentials::avoidFieldState() */
+    static Potential avoidPoint(float distance, float bearing, float objectsize, float dontcaredistance)
+    {
+        Potential result = {0, 0, 0};
+        if (distance > dontcaredistance)        // if the object is too far away don't avoid it
+            return result;
+
+        // calculate the translational speed --- max if inside the object and reduces to zero at dontcaredistance
+        if (distance < objectsize)
+            result.Speed = 1;
+        else
+            result.Speed = (distance - dontcaredistance)/(objectsize - dontcaredistance);
+        // calculate the translational bearing --- away
+        if (fabs(bearing) < 0.1)
+            result.Direction = mathGeneral::PI/2;
+        else
+            result.Direction = bearing - mathGeneral::sign(bearing)*mathGeneral::PI/2;
+        // calculate the rotational speed --- spin facing object if infront, spin away if behind
+        float y = distance*sin(bearing);
+        float x = distance*cos(bearing);
+        if (fabs(y) < objectsize)
+            result.Rotation = atan2(y - mathGeneral::sign(y)*objectsize, x);
+        return result;
+    }
+
+    /*! @brief Returns the sum of the potentials. See BehaviourPotentials::sumPotentials() */
+    static Potential sum(const Potential* potentials, int n)
+    {
+        float xsum = 0;
+        float ysum = 0;
+        float yawsum = 0;
+        float maxspeed = 0;
+        for (int i=0; i<n; i++)
+            accumulate(potentials[i], xsum, ysum, yawsum, maxspeed);
+        Potential result = {maxspeed, atan2(ysum, xsum), yawsum};
+        return result;
+    }
+
+    /*! @brief The motor schema to dodge the obstacles detected by the sonar. See BehaviourPotentials::sensorAvoidObjects() */
+    static Potential sensorAvoid(const Potential& speed, float leftobstacle, float rightobstacle, float objectsize, float dontcaredistance)
+    {
+        if (fabs(speed.Direction) > mathGeneral::PI/2)
+        {   // if the speed is not in the range of the ultrasonic sensors then don't both dodging
+            return speed;
+        }
+        else if (leftobstacle > dontcaredistance and rightobstacle > dontcaredistance)
+        {   // if the obstacles are too far away don't dodge
+            return speed;
+        }
+
+        // an obstacle needs to be dodged
+        Potential newspeed = speed;
+        float obstacle = std::min(leftobstacle, rightobstacle);
+        float dodgeangle;
+        if (obstacle < objectsize)          // if we are 'inside' the object
+            dodgeangle = mathGeneral::PI/2 + asin((objectsize - obstacle)/objectsize);
+        else                                // if we are 'outside' the object
+            dodgeangle = asin(objectsize/obstacle);
+
+        if (leftobstacle <= rightobstacle)
+        {   // the obstacle is on the left
+            if (speed.Direction > -dodgeangle)
+                newspeed.Direction = -dodgeangle;
+        }
+        else
+        {   // the obstacle is on the right
+            if (speed.Direction < dodgeangle)
+                newspeed.Direction = dodgeangle;
+        }
+        return newspeed;
+    }
+
+    /*! @brief Gets the closest obstacle on the left and right from the sonar in cm; 255 if there is no reading */
+    static void getSonarDistances(NUSensorsData* sensors, float& leftobstacle, float& rightobstacle)
+    {
+        std::vector<float> temp;
+        leftobstacle = 255;
+        rightobstacle = 255;
+        if (sensors->get(NUSensorsData::LDistance, temp) and temp.size() > 0)
+            leftobstacle = temp[0];
+        if (sensors->get(NUSensorsData::RDistance, temp) and temp.size() > 0)
+            rightobstacle = temp[0];
+    }
+
+    /*! @brief Calculates the distance and bearing to a field position from a pose. The same as Self::CalculateDifferenceFromFieldLocation() */
+    static void relativePosition(float selfx, float selfy, float selfheading, float x, float y, float& distance, float& bearing)
+    {
+        float diffX = x - selfx;
+        float diffY = y - selfy;
+        if (diffX == 0 and diffY == 0)
+            diffY = 0.0001;
+        distance = sqrt(diffX*diffX + diffY*diffY);
+        bearing = mathGeneral::normaliseAngle(atan2(diffY, diffX) - selfheading);
+    }
+
+private:
+    /*! @brief Returns the summed potential of the attractors and repulsors as if the robot was at [x, y, heading] */
+    Potential evaluateAt(float x, float y, float heading) const
+    {
+        float xsum, ysum, yawsum, maxspeed;
+        sumAt(x, y, heading, xsum, ysum, yawsum, maxspeed);
+        Potential result = {maxspeed, atan2(ysum, xsum), yawsum};
+        return result;
+    }
+
+    /*! @brief Sums the attractors and repulsors as if the robot was at [x, y, heading] */
+    void sumAt(float x, float y, float heading, float& xsum, float& ysum, float& yawsum, float& maxspeed) const
+    {
+        xsum = 0;
+        ysum = 0;
+        yawsum = 0;
+        maxspeed = 0;
+        float distance, bearing;
+        for (int i=0; i<m_num_attractors; i++)
+        {
+            relativePosition(x, y, heading, m_attractor_x[i], m_attractor_y[i], distance, bearing);
+            float headingdifference = mathGeneral::normaliseAngle(m_attractor_heading[i] - heading);
+            accumulate(goToPoint(distance, bearing, headingdifference, m_attractor_stopped[i], m_attractor_stopping[i], m_attractor_turning[i]), xsum, ysum, yawsum, maxspeed);
+        }
+        for (int i=0; i<m_num_repulsors; i++)
+        {
+            relativePosition(x, y, heading, m_repulsor_x[i], m_repulsor_y[i], distance, bearing);
+            accumulate(avoidPoint(distance, bearing, m_repulsor_size[i], m_repulsor_dontcare[i]), xsum, ysum, yawsum, maxspeed);
+        }
+    }
+
+public:
+    /*! @brief Adds a potential to a sum. The translational vectors are summed, the rotations added and the fastest speed kept */
+    static void accumulate(const Potential& potential, float& xsum, float& ysum, float& yawsum, float& maxspeed)
+    {
+        if (potential.Speed > maxspeed)
+            maxspeed = potential.Speed;
+        xsum += potential.Speed*cos(potential.Direction);
+        ysum += potential.Speed*sin(potential.Direction);
+        yawsum += potential.Rotation;
+    }
+
+private:
+    float m_x, m_y, m_heading;                                          //!< the robot's position on the field
+
+    int m_num_attractors;
+    float m_attractor_x[POTENTIAL_FIELD_MAX_ATTRACTORS];
+    float m_attractor_y[POTENTIAL_FIELD_MAX_ATTRACTORS];
+    float m_attractor_heading[POTENTIAL_FIELD_MAX_ATTRACTORS];
+    float m_attractor_stopped[POTENTIAL_FIELD_MAX_ATTRACTORS];
+    float m_attractor_stopping[POTENTIAL_FIELD_MAX_ATTRACTORS];
+    float m_attractor_turning[POTENTIAL_FIELD_MAX_ATTRACTORS];
+
+    int m_num_repulsors;
+    float m_repulsor_x[POTENTIAL_FIELD_MAX_REPULSORS];
+    float m_repulsor_y[POTENTIAL_FIELD_MAX_REPULSORS];
+    float m_repulsor_size[POTENTIAL_FIELD_MAX_REPULSORS];
+    float m_repulsor_dontcare[POTENTIAL_FIELD_MAX_REPULSORS];
+
+    int m_num_potentials;
+    Potential m_potentials[POTENTIAL_FIELD_MAX_POTENTIALS];             //!< the potentials relative to the robot
+
+    bool m_has_sonar;
+    float m_sonar_left, m_sonar_right;                                  //!< the closest obstacle on each side in cm
+    float m_sonar_size, m_sonar_dontcare;
+};
+
+#endif
+
@@ -0,0 +1,397 @@
+/*! @file potentialfieldcheck.cpp
+    @brief The potentialfieldcheck executable. Checks the summed PotentialField against the per source motor schemas it replaced.
+
+    Usage: potentialfieldcheck [number of fields]
+
+    Before the PotentialField every motor schema was a separate function in BehaviourPotentials returning a
+    [trans_speed, trans_direction, rot_speed] vector; a behaviour called goToFieldState() and avoidFieldState()
+    for each source, summed them with sumPotentials() and then dodged the sonar with sensorAvoidObjects().
+    Those functions are copied here as they were, and are the reference.
+
+    Random fields (1000 unless given) are made with a random pose, attractors, repulsors, potentials relative to
+    the robot and sonar readings. The field's evaluate() at the robot is compared with the reference sum of the
+    same sources, and the batch evaluate() at random positions with the reference sum as if the robot was at
+    each of them. The speeds and rotations must agree to POTENTIAL_CHECK_TOLERANCE. The direction must too,
+    except when the summed translational vector is too short to have one.
+
+    The number of potentials compared and the number of failures are printed, and the exit status is 1 if
+    there were any failures.
+    Use a build with NUBOT_BUILD_POTENTIAL_FIELD_CHECK ON.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Behaviour/PotentialField.h"
+#include "Tools/Math/General.h"
+
+#include "debug.h"
+
+#include <cstdlib>
+#include <vector>
+#include <string>
+#include <algorithm>
+using namespace std;
+
+ofstream debug;
+ofstream errorlog;
+
+#define POTENTIAL_CHECK_TOLERANCE 1e-4          //!< the largest difference in a speed, direction or rotation that is not a failure
+#define POTENTIAL_CHECK_MIN_LENGTH 1e-3         //!< the shortest summed translational vector whose direction is compared
+#define POTENTIAL_CHECK_MAX_ATTRACTORS 2        //!< the most attractors in a random field
+#define POTENTIAL_CHECK_MAX_POTENTIALS 2        //!< the most potentials relative to the robot in a random field
+#define POTENTIAL_CHECK_NUM_POSITIONS 16        //!< the number of positions the batch evaluate() is checked at in each field
+#define MAX_REPORTED_FAILURES 5                 //!< the number of failures that are printed in full
+
+// ------------------------------------------------------------------------------------------------ The reference
+/*! @brief Self::CalculateDifferenceFromFieldState() from a pose */
+static vector<float> differenceFromFieldState(float selfx, float selfy, float selfheading, const vector<float>& fieldstate)
+{
+    float diffX = fieldstate[0] - selfx;
+    float diffY = fieldstate[1] - selfy;
+    if( (diffX == 0) && (diffY == 0)) diffY = 0.0001;
+    float positionHeading = atan2(diffY, diffX);
+
+    vector<float> result(3,0.0f);
+    result[0] = sqrt( diffX * diffX + diffY * diffY );
+    result[1] = mathGeneral::normaliseAngle(positionHeading - selfheading);
+    result[2] = mathGeneral::normaliseAngle(fieldstate[2] - selfheading);
+    return result;
+}
+
+/*! @brief The original BehaviourPotentials::goToPoint() */
+static vector<float> goToPoint(float distance, float bearing, float heading, float stoppeddistance, float stoppingdistance, float turningdistance)
+{
+    vector<float> result(3,0);
+    if (distance < stoppeddistance and fabs(heading) < 0.1)         // if we are close --- enough stop
+        return result;
+    else
+    {
+        // calculate the translational speed
+        if (distance < stoppingdistance)
+            result[0] = distance/stoppingdistance;
+        else
+            result[0] = 1;
+        // 'calculate' the translational direction
+        result[1] = bearing;
+        // calculate the rotational speed
+        if (distance < turningdistance)
+        {
+            if (fabs(heading) > 2.5)
+                heading = fabs(heading);
+            result[2] = 0.5*heading;
+        }
+        else
+            result[2] = 0.5*bearing;
+        return result;
+    }
+}
+
+/*! @brief The original BehaviourPotentials::goToFieldState(), from a pose instead of the self object */
+static vector<float> goToFieldState(float selfx, float selfy, float selfheading, const vector<float>& fieldstate, float stoppeddistance, float stoppingdistance, float turningdistance)
+{
+    vector<float> relativestate = differenceFromFieldState(selfx, selfy, selfheading, fieldstate);
+    return goToPoint(relativestate[0], relativestate[1], relativestate[2], stoppeddistance, stoppingdistance, turningdistance);
+}
+
+/*! @brief The original BehaviourPotentials::avoidFieldState(), from a pose instead of the self object */
+static vector<float> avoidFieldState(float selfx, float selfy, float selfheading, vector<float>& fieldstate, float objectsize, float dontcaredistance)
+{
+    vector<float> result(3,0);
+    if (fieldstate.size() < 3)
+        fieldstate.push_back(0);
+    vector<float> relativestate = differenceFromFieldState(selfx, selfy, selfheading, fieldstate);
+
+    float distance = relativestate[0];
+    float bearing = relativestate[1];
+
+    if (distance > dontcaredistance)
+    {   // if the object is too far away don't avoid it
+        return result;
+    }
+    else
+    {
+        // calculate the translational speed --- max if inside the object and reduces to zero at dontcaredistance
+        if (distance < objectsize)
+            result[0] = 1;
+        else
+            result[0] = (distance - dontcaredistance)/(objectsize - dontcaredistance);
+        // calculate the translational bearing --- away
+        if (fabs(bearing) < 0.1)
+            result[1] = mathGeneral::PI/2;
+        else
+            result[1] = bearing - mathGeneral::sign(bearing)*mathGeneral::PI/2;
+        // calculate the rotational speed --- spin facing object if infront, spin away if behind
+        float y = distance*sin(bearing);
+        float x = distance*cos(bearing);
+        if (fabs(y) < objectsize)
+            result[2] = atan2(y - mathGeneral::sign(y)*objectsize, x);
+        else
+            result[2] = 0;
+
+        return result;
+    }
+}
+
+/*! @brief The original BehaviourPotentials::sumPotentials() */
+static vector<float> sumPotentials(const vector<vector<float> >& potentials)
+{
+    float xsum = 0;
+    float ysum = 0;
+    float yawsum = 0;
+    float maxspeed = 0;
+    for (size_t i=0; i<potentials.size(); i++)
+    {
+        if (potentials[i][0] > maxspeed)
+            maxspeed = potentials[i][0];
+        xsum += potentials[i][0]*cos(potentials[i][1]);
+        ysum += potentials[i][0]*sin(potentials[i][1]);
+        yawsum += potentials[i][2];
+    }
+    vector<float> result(3,0);
+    result[0] = maxspeed;
+    result[1] = atan2(ysum,xsum);
+    result[2] = yawsum;
+    return result;
+}
+
+/*! @brief The original BehaviourPotentials::sensorAvoidObjects(), with the sonar readings instead of the sensors */
+static vector<float> sensorAvoidObjects(const vector<float>& speed, float leftobstacle, float rightobstacle, float objectsize, float dontcaredistance)
+{
+    if (fabs(speed[1]) > mathGeneral::PI/2)
+    {   // if the speed is not in the range of the ultrasonic sensors then don't both dodging
+        return speed;
+    }
+    else if (leftobstacle > dontcaredistance and rightobstacle > dontcaredistance)
+    {   // if the obstacles are too far away don't dodge
+        return speed;
+    }
+    else
+    {   // an obstacle needs to be dodged
+        vector<float> newspeed = speed;
+        float obstacle = min(leftobstacle, rightobstacle);
+        float dodgeangle;
+        if (obstacle < objectsize)          // if we are 'inside' the object
+            dodgeangle = mathGeneral::PI/2 + asin((objectsize - obstacle)/objectsize);
+        else                                // if we are 'outside' the object
+            dodgeangle = asin(objectsize/obstacle);
+
+        if (leftobstacle <= rightobstacle)
+        {   // the obstacle is on the left
+            if (speed[1] > -dodgeangle)
+                newspeed[1] = -dodgeangle;
+        }
+        else
+        {   // the obstacle is on the right
+            if (speed[1] < dodgeangle)
+                newspeed[1] = dodgeangle;
+        }
+        return newspeed;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------ The random fields
+/*! @brief Returns a random number in [low, high] */
+static float uniform(float low, float high)
+{
+    return low + (high - low)*rand()/RAND_MAX;
+}
+
+/*! @brief The sources of a random field, kept so that the reference can be summed from them */
+class RandomField
+{
+public:
+    RandomField()
+    {
+        x = uniform(-370, 370);
+        y = uniform(-270, 270);
+        heading = uniform(-mathGeneral::PI, mathGeneral::PI);
+
+        int numattractors = rand() % (POTENTIAL_CHECK_MAX_ATTRACTORS + 1);
+        for (int i=0; i<numattractors; i++)
+        {
+            vector<float> attractor(6,0);
+            attractor[0] = uniform(-370, 370);
+            attractor[1] = uniform(-270, 270);
+            attractor[2] = uniform(-mathGeneral::PI, mathGeneral::PI);
+            attractor[3] = uniform(0, 20);
+            attractor[4] = uniform(20, 200);
+            attractor[5] = uniform(0, 300);
+            attractors.push_back(attractor);
+        }
+        int numrepulsors = rand() % (POTENTIAL_FIELD_MAX_REPULSORS + 1);
+        for (int i=0; i<numrepulsors; i++)
+        {   // the repulsors are scattered near the robot so that most of them are not too far away to avoid
+            vector<float> repulsor(4,0);
+            repulsor[0] = x + uniform(-150, 150);
+            repulsor[1] = y + uniform(-150, 150);
+            repulsor[2] = uniform(5, 40);
+            repulsor[3] = repulsor[2] + uniform(10, 100);
+            repulsors.push_back(repulsor);
+        }
+        int numpotentials = rand() % (POTENTIAL_CHECK_MAX_POTENTIALS + 1);
+        for (int i=0; i<numpotentials; i++)
+        {
+            vector<float> potential(3,0);
+            potential[0] = uniform(0, 1);
+            potential[1] = uniform(-mathGeneral::PI, mathGeneral::PI);
+            potential[2] = uniform(-1, 1);
+            potentials.push_back(potential);
+        }
+        hassonar = rand() % 2;
+        sonar[0] = rand() % 4 == 0 ? 255 : uniform(0, 150);
+        sonar[1] = rand() % 4 == 0 ? 255 : uniform(0, 150);
+        sonar[2] = uniform(10, 40);
+        sonar[3] = sonar[2] + uniform(10, 100);
+    }
+
+    /*! @brief Builds the PotentialField of these sources */
+    void make(PotentialField& field) const
+    {
+        field.clear();
+        field.setPose(x, y, heading);
+        for (size_t i=0; i<attractors.size(); i++)
+            field.addAttractor(attractors[i][0], attractors[i][1], attractors[i][2], attractors[i][3], attractors[i][4], attractors[i][5]);
+        for (size_t i=0; i<repulsors.size(); i++)
+            field.addRepulsor(repulsors[i][0], repulsors[i][1], repulsors[i][2], repulsors[i][3]);
+        for (size_t i=0; i<potentials.size(); i++)
+        {
+            Potential potential = {potentials[i][0], potentials[i][1], potentials[i][2]};
+            field.addPotential(potential);
+        }
+        if (hassonar)
+            field.setSonar(sonar[0], sonar[1], sonar[2], sonar[3]);
+    }
+
+    /*! @brief Returns the reference sum of the attractors and repulsors with the robot at [atx, aty, heading]
+        @param withrobot true to include the potentials relative to the robot and the sonar
+        @param length will be updated with the length of the summed translational vector
+     */
+    vector<float> reference(float atx, float aty, bool withrobot, float& length) const
+    {
+        vector<vector<float> > components;
+        for (size_t i=0; i<attractors.size(); i++)
+            components.push_back(goToFieldState(atx, aty, heading, attractors[i], attractors[i][3], attractors[i][4], attractors[i][5]));
+        for (size_t i=0; i<repulsors.size(); i++)
+        {
+            vector<float> fieldstate(repulsors[i].begin(), repulsors[i].begin() + 2);
+            components.push_back(avoidFieldState(atx, aty, heading, fieldstate, repulsors[i][2], repulsors[i][3]));
+        }
+        if (withrobot)
+            components.insert(components.end(), potentials.begin(), potentials.end());
+
+        float xsum = 0;
+        float ysum = 0;
+        for (size_t i=0; i<components.size(); i++)
+        {
+            xsum += components[i][0]*cos(components[i][1]);
+            ysum += components[i][0]*sin(components[i][1]);
+        }
+        length = sqrt(xsum*xsum + ysum*ysum);
+
+        vector<float> result = sumPotentials(components);
+        if (withrobot and hassonar)
+            result = sensorAvoidObjects(result, sonar[0], sonar[1], sonar[2], sonar[3]);
+        return result;
+    }
+
+    float x, y, heading;                                //!< the robot's pose
+    vector<vector<float> > attractors;                  //!< [x, y, heading, stoppeddistance, stoppingdistance, turningdistance]
+    vector<vector<float> > repulsors;                   //!< [x, y, objectsize, dontcaredistance]
+    vector<vector<float> > potentials;                  //!< [trans_speed, trans_direction, rot_speed]
+    bool hassonar;
+    float sonar[4];                                     //!< [leftobstacle, rightobstacle, objectsize, dontcaredistance]
+};
+
+// ------------------------------------------------------------------------------------------------ The check
+/*! @brief The result of comparing the field with the reference */
+class CheckResult
+{
+public:
+    CheckResult(const string& name) : m_name(name), m_checked(0), m_failures(0) {}
+
+    /*! @brief Compares a potential from the field with the reference
+        @param field the number of the random field, which is printed if the potential fails
+        @param length the length of the reference's summed translational vector
+     */
+    void compare(int field, const Potential& potential, const vector<float>& reference, float length)
+    {
+        m_checked++;
+        bool failed = fabs(potential.Speed - reference[0]) > POTENTIAL_CHECK_TOLERANCE or fabs(potential.Rotation - reference[2]) > POTENTIAL_CHECK_TOLERANCE;
+        if (length > POTENTIAL_CHECK_MIN_LENGTH and fabs(mathGeneral::normaliseAngle(potential.Direction - reference[1])) > POTENTIAL_CHECK_TOLERANCE)
+            failed = true;
+        if (failed)
+        {
+            m_failures++;
+            if (m_failures <= MAX_REPORTED_FAILURES)
+                cout << "    " << m_name << " field " << field << ": [" << potential.Speed << ", " << potential.Direction << ", " << potential.Rotation << "] not [" << reference[0] << ", " << reference[1] << ", " << reference[2] << "]" << endl;
+        }
+    }
+    bool failed() const {return m_failures > 0;}
+
+    void print() const
+    {
+        cout << m_name << ": " << m_checked << " potentials checked, " << m_failures << " failures" << endl;
+    }
+private:
+    string m_name;                          //!< the name of the evaluation
+    long m_checked;                         //!< the number of potentials compared
+    long m_failures;                        //!< the number of potentials differing from the reference
+};
+
+int main(int argc, const char *argv[])
+{
+    int numfields = 1000;
+    if (argc > 1)
+        numfields = max(1, atoi(argv[1]));
+    srand(1);
+
+    CheckResult robotresult("evaluate()");
+    CheckResult batchresult("evaluate(x, y, n)");
+    PotentialField field;
+    for (int i=0; i<numfields; i++)
+    {
+        RandomField sources;
+        sources.make(field);
+
+        float length;
+        vector<float> reference = sources.reference(sources.x, sources.y, true, length);
+        robotresult.compare(i, field.evaluate(), reference, length);
+
+        float x[POTENTIAL_CHECK_NUM_POSITIONS];
+        float y[POTENTIAL_CHECK_NUM_POSITIONS];
+        Potential potentials[POTENTIAL_CHECK_NUM_POSITIONS];
+        for (int j=0; j<POTENTIAL_CHECK_NUM_POSITIONS; j++)
+        {
+            x[j] = sources.x + uniform(-100, 100);
+            y[j] = sources.y + uniform(-100, 100);
+        }
+        field.evaluate(x, y, POTENTIAL_CHECK_NUM_POSITIONS, potentials);
+        for (int j=0; j<POTENTIAL_CHECK_NUM_POSITIONS; j++)
+        {
+            reference = sources.reference(x[j], y[j], false, length);
+            batchresult.compare(i, potentials[j], reference, length);
+        }
+    }
+    robotresult.print();
+    batchresult.print();
+
+    if (robotresult.failed() or batchresult.failed())
+        return 1;
+    else
+        return 0;
+}
@@ -64,12 +64,8 @@ public:
             m_chasing_time = 0;
         }
         
-        vector<float> speed(3,0);
-        vector<float> result(3,0);
-        speed[0] = 1;
-        speed[1] = m_target.measuredBearing();
-        speed[2] = m_target.measuredBearing()/2;
-        result = BehaviourPotentials::sensorAvoidObjects(speed, m_data, 40, 100);
+        Potential speed = {1, m_target.measuredBearing(), m_target.measuredBearing()/2};
+        Potential result = BehaviourPotentials::sensorAvoidObjects(speed, m_data, 40, 100);
         
         if (not m_tracking_ball)
         {   // if we are chasing the object
@@ -92,7 +88,7 @@ public:
                 m_jobs->addMotionJob(new HeadTrackJob(ball, 0.15, offset));
             }
             
-            result[0] *= 0.5;
+            result.Speed *= 0.5;
             
             m_tracking_time += m_data->CurrentTime - m_previous_time;
             
@@ -102,7 +98,7 @@ public:
                 m_chasing_time = 0;
             }
         }
-        m_jobs->addMotionJob(new WalkJob(result[0], result[1], result[2]));
+        m_jobs->addMotionJob(new WalkJob(result.Speed, result.Direction, result.Rotation));
 
         m_previous_time = m_data->CurrentTime;
     };
@@ -235,9 +235,12 @@ protected:
                 m_position[2] = 0;
             }
         }
-        vector<float> speed = BehaviourPotentials::goToFieldState(m_field_objects->self, m_position, 0, 55, 0);
-        vector<float> result = BehaviourPotentials::sensorAvoidObjects(speed, m_data, 25, 100);
-        m_jobs->addMotionJob(new WalkJob(result[0], result[1], result[2]));
+        PotentialField field;
+        BehaviourPotentials::makeField(field, m_field_objects, m_team_info, m_data);
+        field.addAttractor(m_position[0], m_position[1], m_position[2], 0, 55, 0);
+        field.addSonar(m_data, 25, 100);
+        Potential result = field.evaluate();
+        m_jobs->addMotionJob(new WalkJob(result.Speed, result.Direction, result.Rotation));
         
         float pan_width = 1.1;
         if (ball.isObjectVisible())
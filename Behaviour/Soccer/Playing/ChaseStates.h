@@ -77,8 +77,9 @@ protected:
         m_data->get(NUSensorsData::MotionKickActive, iskicking);
         if(!iskicking)
         {
-            vector<float> speed = BehaviourPotentials::goToBall(ball, self, BehaviourPotentials::getBearingToOpponentGoal(m_field_objects, m_game_info));
-            vector<float> result;
+            PotentialField field;
+            BehaviourPotentials::makeField(field, m_field_objects, m_team_info, m_data);
+            field.addPotential(BehaviourPotentials::goToBall(ball, self, BehaviourPotentials::getBearingToOpponentGoal(m_field_objects, m_game_info)));
             // decide whether we need to dodge or not
             float leftobstacle = 255;
             float rightobstacle = 255;
@@ -90,11 +91,10 @@ protected:
             
             // if the ball is too far away to kick and the obstable is closer than the ball we need to dodge!
             if (ball.estimatedDistance() > 20 and min(leftobstacle, rightobstacle) < ball.estimatedDistance())
-                result = BehaviourPotentials::sensorAvoidObjects(speed, m_data, min(ball.estimatedDistance(), 25.0f), 75);
-            else
-                result = speed;
+                field.setSonar(leftobstacle, rightobstacle, min(ball.estimatedDistance(), 25.0f), 75);
             
-            m_jobs->addMotionJob(new WalkJob(result[0], result[1], result[2]));
+            Potential result = field.evaluate();
+            m_jobs->addMotionJob(new WalkJob(result.Speed, result.Direction, result.Rotation));
         }
         
         if( (ball.estimatedDistance() < 20.0f) && BehaviourPotentials::opponentsGoalLinedUp(m_field_objects, m_game_info))
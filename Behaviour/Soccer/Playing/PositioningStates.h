@@ -73,9 +73,12 @@ protected:
             turningdistance = 200;
         else
             turningdistance = 100;
-        vector<float> speed = BehaviourPotentials::goToPoint(distance, bearing, ball.estimatedBearing(), 10, 50, turningdistance);
-        vector<float> result = BehaviourPotentials::sensorAvoidObjects(speed, m_data, 25, 75);
-        m_jobs->addMotionJob(new WalkJob(result[0], result[1], result[2]));
+        PotentialField field;
+        BehaviourPotentials::makeField(field, m_field_objects, m_team_info, m_data);
+        field.addPotential(BehaviourPotentials::goToPoint(distance, bearing, ball.estimatedBearing(), 10, 50, turningdistance));
+        field.addSonar(m_data, 25, 75);
+        Potential result = field.evaluate();
+        m_jobs->addMotionJob(new WalkJob(result.Speed, result.Direction, result.Rotation));
         
         float pan_width = 1.1;
         if (m_team_info->getPlayerNumber() == 1)
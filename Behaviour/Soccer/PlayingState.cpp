@@ -78,6 +78,16 @@ void PlayingState::doStateCommons()
         m_actions->add(NUActionatorsData::REyeLed, m_actions->CurrentTime, m_led_green);
     else
         m_actions->add(NUActionatorsData::REyeLed, m_actions->CurrentTime, m_led_off);
+    
+    // tell the team mates the role I intend to play, so the attacker keeps the ball in amIClosestToBall()
+    if (m_state == m_chase_state)
+        m_team_info->setRoleIntent(TeamPacket::AttackerRole);
+    else if (m_team_info->getPlayerNumber() == 1)
+        m_team_info->setRoleIntent(TeamPacket::GoalKeeperRole);
+    else if (m_state == m_positioning_state)
+        m_team_info->setRoleIntent(TeamPacket::SupporterRole);
+    else
+        m_team_info->setRoleIntent(TeamPacket::UnknownRole);
 }
 
 BehaviourFSMState* PlayingState::nextStateCommons()
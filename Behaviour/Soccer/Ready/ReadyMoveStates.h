@@ -104,14 +104,15 @@ protected:
         
         
         vector<float> position = getReadyFieldPositions();
-        vector<float> speed = BehaviourPotentials::goToFieldState(m_field_objects->self, position, 5, 60, 100);
-        
-        vector<float> result;
+        PotentialField field;
+        BehaviourPotentials::makeField(field, m_field_objects, m_team_info, m_data);
+        field.addAttractor(position[0], position[1], position[2], 5, 60, 100);
         if (m_team_info->getPlayerNumber() != 1)
-            result = BehaviourPotentials::sensorAvoidObjects(speed, m_data, 25, 100);
+            field.addSonar(m_data, 25, 100);
         else
-            result = BehaviourPotentials::sensorAvoidObjects(speed, m_data, 25, 35);
-        m_jobs->addMotionJob(new WalkJob(result[0], result[1], result[2]));
+            field.addSonar(m_data, 25, 35);
+        Potential result = field.evaluate();
+        m_jobs->addMotionJob(new WalkJob(result.Speed, result.Direction, result.Rotation));
     }
 private:
     vector<float> getReadyFieldPositions()
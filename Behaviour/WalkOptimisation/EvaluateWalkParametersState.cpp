@@ -80,8 +80,8 @@ void EvaluateWalkParametersState::doState()
     if (pointReached())
         m_current_target_state = getNextPoint();
 
-    vector<float> speed = BehaviourPotentials::goToFieldState(m_field_objects->self, m_current_target_state, 0, m_parent->stoppingDistance(), 9000);
-    m_jobs->addMotionJob(new WalkJob(speed[0], speed[1], speed[2]));
+    Potential speed = BehaviourPotentials::goToFieldState(m_field_objects->self, m_current_target_state, 0, m_parent->stoppingDistance(), 9000);
+    m_jobs->addMotionJob(new WalkJob(speed.Speed, speed.Direction, speed.Rotation));
 }
 
 /*! @brief Returns the starting point for the evaluation of the speed */
@@ -102,8 +102,8 @@ public:
             m_time_not_getting_up += m_data->CurrentTime - m_data->PreviousTime;
 
         lookAtGoals();
-        vector<float> speed = BehaviourPotentials::goToFieldState(m_field_objects->self, m_current_target_state, 0, 2*m_parent->stoppingDistance(), 9000);
-        m_jobs->addMotionJob(new WalkJob(speed[0], speed[1], speed[2]));
+        Potential speed = BehaviourPotentials::goToFieldState(m_field_objects->self, m_current_target_state, 0, 2*m_parent->stoppingDistance(), 9000);
+        m_jobs->addMotionJob(new WalkJob(speed.Speed, speed.Direction, speed.Rotation));
 		#if DEBUG_BEHAVIOUR_VERBOSITY > 4
             debug << "GenerateWalkParametersState::doState() - Completed." << endl;
         #endif
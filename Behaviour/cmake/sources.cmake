@@ -25,6 +25,8 @@ SET (YOUR_SRCS  BehaviourProvider.cpp BehaviourProvider.h
                 BehaviourState.cpp BehaviourState.h
                 BehaviourFSMState.cpp BehaviourFSMState.h
                 BehaviourPotentials.h
+                PotentialField.h
+                FieldGeometryMap.cpp FieldGeometryMap.h
                 Behaviour.cpp Behaviour.h
 )
 ####################################################################################
@@ -0,0 +1,253 @@
+/*! @file LandmarkVisibility.cpp
+    @brief Implementation of a predictor of which landmarks should be in view
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "LandmarkVisibility.h"
+#include "FieldObjects.h"
+#include "Tools/Math/General.h"
+
+#include <cmath>
+#include <algorithm>
+using namespace std;
+
+LandmarkVisibility::LandmarkVisibility()
+{
+    m_unknown.Expected = true;
+    m_unknown.Distance = 0;
+    m_unknown.Bearing = 0;
+    m_unknown.Elevation = 0;
+    m_unknown.MinX = m_unknown.MinY = 0;
+    m_unknown.MaxX = m_unknown.MaxY = 0;
+    m_image_width = m_image_height = 0;
+    m_focal_x = m_focal_y = 1;
+    invalidate();
+}
+
+LandmarkVisibility::~LandmarkVisibility()
+{
+}
+
+/*! @brief Sets the pose the prediction is made from
+    @param x the x position in cm
+    @param y the y position in cm
+    @param heading the heading in rad
+    @param sdx the standard deviation of x
+    @param sdy the standard deviation of y
+    @param sdheading the standard deviation of the heading
+ */
+void LandmarkVisibility::setPose(float x, float y, float heading, float sdx, float sdy, float sdheading)
+{
+    m_x = x;
+    m_y = y;
+    m_heading = heading;
+    m_sd_position = max(sdx, sdy);
+    m_sd_heading = sdheading;
+    m_pose_valid = m_sd_position < LANDMARK_VISIBILITY_MAX_POSITION_SD and m_sd_heading < LANDMARK_VISIBILITY_MAX_HEADING_SD;
+}
+
+/*! @brief Sets the camera used for the prediction
+    @param cameratoground the 4x4 camera to ground transform (row major)
+    @return false if the transform is invalid
+ */
+bool LandmarkVisibility::setCamera(const vector<float>& cameratoground)
+{
+    m_camera_valid = false;
+    if (cameratoground.size() != 16)
+        return false;
+
+    // the ground to camera rotation is the transpose of the camera to ground rotation
+    for (int i=0; i<3; i++)
+    {
+        for (int j=0; j<3; j++)
+            m_rotation[i][j] = cameratoground[4*j + i];
+        m_camera[i] = cameratoground[4*i + 3];
+    }
+    m_camera_valid = true;
+    return true;
+}
+
+/*! @brief Sets the size of the image the expected regions are calculated in */
+void LandmarkVisibility::setImageSize(int imagewidth, int imageheight)
+{
+    m_image_width = imagewidth;
+    m_image_height = imageheight;
+    m_focal_x = (0.5*imagewidth)/tan(0.5*LANDMARK_VISIBILITY_FOV_X);
+    m_focal_y = (0.5*imageheight)/tan(0.5*LANDMARK_VISIBILITY_FOV_Y);
+}
+
+/*! @brief Forgets the pose and the camera, so that every landmark is expected until they are set again */
+void LandmarkVisibility::invalidate()
+{
+    m_x = m_y = m_heading = 0;
+    m_sd_position = m_sd_heading = 0;
+    m_pose_valid = false;
+    m_camera_valid = false;
+}
+
+/*! @brief Returns true if the pose is certain enough, and the camera is known, so that landmarks can be ruled out */
+bool LandmarkVisibility::isValid() const
+{
+    return m_pose_valid and m_camera_valid;
+}
+
+/*! @brief Predicts which of the landmarks should be in the image, and where. The result is indexed by the position in landmarks.
+           If the prediction is not valid every landmark is expected to be anywhere in the image.
+ */
+void LandmarkVisibility::predict(const vector<StationaryObject>& landmarks)
+{
+    m_expected.resize(landmarks.size());
+    m_unknown.MaxX = max(m_image_width - 1, 0);
+    m_unknown.MaxY = max(m_image_height - 1, 0);
+    for (size_t i=0; i<landmarks.size(); i++)
+    {
+        ExpectedLandmark& expected = m_expected[i];
+        expected = m_unknown;
+        if (not isValid())
+            continue;
+
+        float topdistance, topbearing, topelevation;
+        bool infront = project(landmarks[i].X(), landmarks[i].Y(), 0, m_x, m_y, m_heading, expected.Distance, expected.Bearing, expected.Elevation);
+        if (expected.Distance < 2*m_sd_position)
+            continue;               // too close to rule out; the landmark may be on either side of the camera
+        if (not infront or expected.Distance > LANDMARK_VISIBILITY_MAX_DISTANCE)
+        {
+            expected.Expected = false;
+            continue;
+        }
+        project(landmarks[i].X(), landmarks[i].Y(), getHeight(i), m_x, m_y, m_heading, topdistance, topbearing, topelevation);
+
+        float margin = LANDMARK_VISIBILITY_MARGIN + 2*m_sd_heading + atan2(2*m_sd_position, expected.Distance);
+        expected.Expected = inView(expected.Bearing, expected.Elevation, topelevation, margin);
+        if (expected.Expected)
+        {
+            expected.MinX = max(toImageX(expected.Bearing + margin), 0);
+            expected.MaxX = min(toImageX(expected.Bearing - margin), m_image_width - 1);
+            expected.MinY = max(toImageY(topelevation + margin), 0);
+            expected.MaxY = min(toImageY(expected.Elevation - margin), m_image_height - 1);
+        }
+    }
+}
+
+/*! @brief Returns true if the landmark with the given id could be in the image. Landmarks that have not been predicted are always expected. */
+bool LandmarkVisibility::isExpected(int id) const
+{
+    return getExpected(id).Expected;
+}
+
+/*! @brief Returns the prediction for the landmark with the given id */
+const LandmarkVisibility::ExpectedLandmark& LandmarkVisibility::getExpected(int id) const
+{
+    if (id < 0 or id >= static_cast<int>(m_expected.size()))
+        return m_unknown;
+    else
+        return m_expected[id];
+}
+
+/*! @brief Returns true if the landmark could be in the image from the given pose. This uses the current camera, but not the current pose.
+    @param landmark the landmark
+    @param x the x position of the pose in cm
+    @param y the y position of the pose in cm
+    @param heading the heading of the pose in rad
+    @param sdposition the standard deviation of the position of the pose
+    @param sdheading the standard deviation of the heading of the pose
+ */
+bool LandmarkVisibility::couldSee(const StationaryObject& landmark, float x, float y, float heading, float sdposition, float sdheading) const
+{
+    if (not m_camera_valid or sdposition > LANDMARK_VISIBILITY_MAX_POSITION_SD or sdheading > LANDMARK_VISIBILITY_MAX_HEADING_SD)
+        return true;
+
+    float distance, bearing, elevation;
+    float topdistance, topbearing, topelevation;
+    bool infront = project(landmark.X(), landmark.Y(), 0, x, y, heading, distance, bearing, elevation);
+    if (distance < 2*sdposition)
+        return true;
+    if (not infront or distance > LANDMARK_VISIBILITY_MAX_DISTANCE)
+        return false;
+    project(landmark.X(), landmark.Y(), getHeight(landmark.getID()), x, y, heading, topdistance, topbearing, topelevation);
+
+    float margin = LANDMARK_VISIBILITY_MARGIN + 2*sdheading + atan2(2*sdposition, distance);
+    return inView(bearing, elevation, topelevation, margin);
+}
+
+/*! @brief Returns the height in cm of the landmark with the given StationaryFieldObjectID */
+float LandmarkVisibility::getHeight(int id)
+{
+    if (id >= FieldObjects::FO_BLUE_LEFT_GOALPOST and id <= FieldObjects::FO_YELLOW_RIGHT_GOALPOST)
+        return LANDMARK_VISIBILITY_GOALPOST_HEIGHT;
+    else
+        return 0;
+}
+
+/*! @brief Calculates the position of a point on the field relative to the camera
+    @param landmarkx the x position of the point in cm
+    @param landmarky the y position of the point in cm
+    @param landmarkz the height of the point in cm
+    @param x, y, heading the robot's pose
+    @param distance will be updated with the distance from the camera in cm
+    @param bearing will be updated with the bearing from the camera centre
+    @param elevation will be updated with the elevation from the camera centre
+    @return false if the point is behind the camera
+ */
+bool LandmarkVisibility::project(float landmarkx, float landmarky, float landmarkz, float x, float y, float heading, float& distance, float& bearing, float& elevation) const
+{
+    float dx = landmarkx - x;
+    float dy = landmarky - y;
+    float ground[3];
+    ground[0] = cos(heading)*dx + sin(heading)*dy - m_camera[0];
+    ground[1] = -sin(heading)*dx + cos(heading)*dy - m_camera[1];
+    ground[2] = landmarkz - m_camera[2];
+
+    float camera[3];
+    for (int i=0; i<3; i++)
+        camera[i] = m_rotation[i][0]*ground[0] + m_rotation[i][1]*ground[1] + m_rotation[i][2]*ground[2];
+
+    float horizontal = sqrt(camera[0]*camera[0] + camera[1]*camera[1]);
+    distance = sqrt(horizontal*horizontal + camera[2]*camera[2]);
+    bearing = atan2(camera[1], camera[0]);
+    elevation = atan2(camera[2], horizontal);
+    return camera[0] > 0;
+}
+
+/*! @brief Returns true if a vertical segment at bearing between lowelevation and highelevation is within the field of view plus margin */
+bool LandmarkVisibility::inView(float bearing, float lowelevation, float highelevation, float margin) const
+{
+    if (fabs(bearing) > 0.5*LANDMARK_VISIBILITY_FOV_X + margin)
+        return false;
+    if (highelevation < -0.5*LANDMARK_VISIBILITY_FOV_Y - margin)
+        return false;
+    if (lowelevation > 0.5*LANDMARK_VISIBILITY_FOV_Y + margin)
+        return false;
+    return true;
+}
+
+/*! @brief Returns the image column at the bearing; the inverse of Vision::CalculateBearing() */
+int LandmarkVisibility::toImageX(float bearing) const
+{
+    bearing = mathGeneral::crop(bearing, -1.5f, 1.5f);
+    return static_cast<int>(0.5*m_image_width - m_focal_x*tan(bearing));
+}
+
+/*! @brief Returns the image row at the elevation; the inverse of Vision::CalculateElevation() */
+int LandmarkVisibility::toImageY(float elevation) const
+{
+    elevation = mathGeneral::crop(elevation, -1.5f, 1.5f);
+    return static_cast<int>(0.5*m_image_height - m_focal_y*tan(elevation));
+}
+
@@ -0,0 +1,100 @@
+/*! @file LandmarkVisibility.h
+    @brief Declaration of a predictor of which landmarks should be in view
+
+    @class LandmarkVisibility
+    @brief Predicts which stationary field objects should be in the image, and where, from a pose and the camera transform
+
+    The landmarks are projected into the image using the camera to ground transform and the same
+    bearing/elevation to pixel model as Vision::CalculateBearing() and Vision::CalculateElevation().
+    The uncertainty in the pose is turned into an angular margin, so a landmark is only predicted
+    to be out of view when it could not be in view for any likely pose.
+
+    Vision uses the prediction to skip searching for goals that can not be in the image, and
+    Localisation uses couldSee() to skip association hypotheses a model could not have seen.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LANDMARK_VISIBILITY_H
+#define LANDMARK_VISIBILITY_H
+
+#include <vector>
+class StationaryObject;
+
+#define LANDMARK_VISIBILITY_FOV_X 0.7854                //!< the horizontal field of view in rad (45 deg, the same as Vision)
+#define LANDMARK_VISIBILITY_FOV_Y 0.6013                //!< the vertical field of view in rad (34.45 deg, the same as Vision)
+#define LANDMARK_VISIBILITY_MAX_DISTANCE 700.0          //!< landmarks further away than this are never expected to be seen (cm)
+#define LANDMARK_VISIBILITY_GOALPOST_HEIGHT 80.0        //!< the height of the goal posts in cm
+#define LANDMARK_VISIBILITY_MARGIN 0.1                  //!< the angular margin in rad added for the errors in the kinematics
+#define LANDMARK_VISIBILITY_MAX_POSITION_SD 75.0        //!< if the position standard deviation is larger than this (cm) nothing is ruled out
+#define LANDMARK_VISIBILITY_MAX_HEADING_SD 0.5          //!< if the heading standard deviation is larger than this (rad) nothing is ruled out
+
+class LandmarkVisibility
+{
+public:
+    /*! @brief The predicted position of a landmark in the image */
+    struct ExpectedLandmark
+    {
+        bool Expected;              //!< true if the landmark could be in the image
+        float Distance;             //!< the distance from the camera in cm
+        float Bearing;              //!< the bearing from the camera centre in rad
+        float Elevation;            //!< the elevation from the camera centre in rad (the base of the landmark)
+        int MinX, MaxX;             //!< the columns of the image the landmark could be in
+        int MinY, MaxY;             //!< the rows of the image the landmark could be in
+    };
+
+    LandmarkVisibility();
+    ~LandmarkVisibility();
+
+    void setPose(float x, float y, float heading, float sdx, float sdy, float sdheading);
+    bool setCamera(const std::vector<float>& cameratoground);
+    void setImageSize(int imagewidth, int imageheight);
+    void invalidate();
+    bool isValid() const;
+
+    void predict(const std::vector<StationaryObject>& landmarks);
+    bool isExpected(int id) const;
+    const ExpectedLandmark& getExpected(int id) const;
+
+    bool couldSee(const StationaryObject& landmark, float x, float y, float heading, float sdposition, float sdheading) const;
+
+    static float getHeight(int id);
+
+private:
+    bool project(float landmarkx, float landmarky, float landmarkz, float x, float y, float heading, float& distance, float& bearing, float& elevation) const;
+    bool inView(float bearing, float lowelevation, float highelevation, float margin) const;
+    int toImageX(float bearing) const;
+    int toImageY(float elevation) const;
+
+private:
+    float m_x, m_y, m_heading;                  //!< the pose [x(cm), y(cm), heading(rad)]
+    float m_sd_position, m_sd_heading;          //!< the uncertainty in the pose
+    bool m_pose_valid;                          //!< true if the pose is certain enough to rule landmarks out
+
+    float m_rotation[3][3];                     //!< the rotation from the ground frame to the camera frame
+    float m_camera[3];                          //!< the position of the camera in the ground frame
+    int m_image_width, m_image_height;
+    float m_focal_x, m_focal_y;                 //!< the effective camera distance in pixels
+    bool m_camera_valid;
+
+    std::vector<ExpectedLandmark> m_expected;   //!< the prediction for each landmark, indexed by StationaryFieldObjectID
+    ExpectedLandmark m_unknown;                 //!< returned for landmarks that were not predicted
+};
+
+#endif
+
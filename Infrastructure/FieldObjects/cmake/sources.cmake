@@ -23,6 +23,7 @@ ENDIF()
 SET (YOUR_SRCS
 AmbiguousObject.cpp
 FieldObjects.cpp
+LandmarkVisibility.cpp
 MobileObject.cpp
 Object.cpp
 Self.cpp
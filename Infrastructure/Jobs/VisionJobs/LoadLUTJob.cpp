@@ -0,0 +1,125 @@
+/*! @file LoadLUTJob.cpp
+    @brief Implementation of LoadLUTJob class
+
+    @author agent
+
+ Copyright (c) 2026 agent
+
+ This file is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This file is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LoadLUTJob.h"
+#include "debug.h"
+#include "debugverbosityjobs.h"
+
+/*! @brief Constructs a LoadLUTJob
+
+    @param filename the path of the lookup table file on the robot
+ */
+LoadLUTJob::LoadLUTJob(const std::string& filename) : VisionJob(Job::VISION_LOAD_LUT)
+{
+    m_filename = filename;
+}
+
+/*! @brief Constructs a LoadLUTJob from stream data
+    @param input the stream from which to make a LoadLUTJob
+
+    Remember that only members introduced at this level are read at this level.
+ */
+LoadLUTJob::LoadLUTJob(istream& input) : VisionJob(Job::VISION_LOAD_LUT)
+{
+    m_job_time = 0;
+    // the filename is stored as its length followed by its characters
+    unsigned int length = 0;
+    input.read(reinterpret_cast<char*>(&length), sizeof(length));
+    if (input.good() and length < 1024)
+    {
+        m_filename.resize(length);
+        if (length > 0)
+            input.read(&m_filename[0], length);
+    }
+    else
+        errorlog << "LoadLUTJob::LoadLUTJob(istream). Invalid filename length: " << length << endl;
+}
+
+/*! @brief LoadLUTJob destructor
+ */
+LoadLUTJob::~LoadLUTJob()
+{
+}
+
+/*! @brief Returns the path of the lookup table file on the robot
+ */
+const std::string& LoadLUTJob::getFileName()
+{
+    return m_filename;
+}
+
+/*! @brief Prints a human-readable summary to the stream
+ @param output the stream to be written to
+ */
+void LoadLUTJob::summaryTo(ostream& output)
+{
+    output << "LoadLUTJob: " << m_job_time << " " << m_filename << endl;
+}
+
+/*! @brief Prints a csv version to the stream
+ @param output the stream to be written to
+ */
+void LoadLUTJob::csvTo(ostream& output)
+{
+    output << "LoadLUTJob, " << m_job_time << ", " << m_filename << ", " << endl;
+}
+
+/*! @brief A helper function to ease writing Job objects to classes
+
+    This function calls its parents versions of the toStream, each parent
+    writes the members introduced at that level
+
+    @param output the stream to write the job to
+ */
+void LoadLUTJob::toStream(ostream& output) const
+{
+    Job::toStream(output);                  // This writes data introduced at the base level
+    VisionJob::toStream(output);            // This writes data introduced at the vision level
+                                            // Then we write LoadLUTJob specific data
+    unsigned int length = m_filename.size();
+    output.write((char*) &length, sizeof(length));
+    output.write(m_filename.c_str(), length);
+}
+
+/*! @relates LoadLUTJob
+    @brief Stream insertion operator for a LoadLUTJob
+
+    @param output the stream to write to
+    @param job the job to be written to the stream
+ */
+ostream& operator<<(ostream& output, const LoadLUTJob& job)
+{
+    job.toStream(output);
+    return output;
+}
+
+/*! @relates LoadLUTJob
+    @brief Stream insertion operator for a pointer to LoadLUTJob
+
+    @param output the stream to write to
+    @param job the job to be written to the stream
+ */
+ostream& operator<<(ostream& output, const LoadLUTJob* job)
+{
+    if (job != NULL)
+        job->toStream(output);
+    return output;
+}
@@ -0,0 +1,55 @@
+/*! @file LoadLUTJob.h
+    @brief Declaration of LoadLUTJob class.
+
+    @class LoadLUTJob
+    @brief A job to replace vision's colour lookup table with one loaded from a file on the robot.
+
+    The table is too large to send in a job, so the job names a file that has already been copied
+    onto the robot. Vision loads it in the background and starts using it at the next frame.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOADLUTJOB_H
+#define LOADLUTJOB_H
+
+#include "../VisionJob.h"
+#include <string>
+
+class LoadLUTJob : public VisionJob
+{
+public:
+    LoadLUTJob(const std::string& filename);
+    LoadLUTJob(istream& input);
+    virtual ~LoadLUTJob();
+
+    const std::string& getFileName();
+
+    virtual void summaryTo(ostream& output);
+    virtual void csvTo(ostream& output);
+
+    friend ostream& operator<<(ostream& output, const LoadLUTJob& job);
+    friend ostream& operator<<(ostream& output, const LoadLUTJob* job);
+protected:
+    virtual void toStream(ostream& output) const;
+private:
+    std::string m_filename;         //!< the path of the lookup table file on the robot
+};
+
+#endif
+
@@ -0,0 +1,305 @@
+/*! @file imageconversioncheck.cpp
+    @brief The imageconversioncheck executable. Checks every pixel of the ImageConversions fast paths against ColorModelConversions.
+
+    Usage: imageconversioncheck [row length]
+
+    Every one of the 2^24 RGB colours is converted by ImageConversions::fromRGBToYCbCr, and every one of the
+    2^24 YCbCr pixels by fromYCbCrToRGB, fromYCbCrToBGR and fromYCbCrToARGB, and each result is compared with
+    the single pixel conversion of ColorModelConversions. The pixels are converted in rows of the given length
+    (321 unless given), so that the scalar tail of every row is checked along with the vectorised part. A
+    channel may differ by one level; any larger difference is a failure.
+
+    packYUV422 is checked exactly against the averaging of the chroma of every pair of Cb and Cr values,
+    unpackYUV422 against its definition and against packYUV422, and downsampleYUV422 against a copy of a
+    synthetic 640x480 camera image made one pixel at a time.
+
+    The number of pixels checked, the number off by one level, and the number of failures are printed for
+    each conversion, and the exit status is 1 if there were any failures.
+    Use a build with NUBOT_BUILD_IMAGE_CONVERSION_CHECK ON.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Infrastructure/NUImage/ImageConversions.h"
+#include "Infrastructure/NUImage/ColorModelConversions.h"
+
+#include "debug.h"
+
+#include <cstdlib>
+#include <vector>
+#include <string>
+#include <algorithm>
+using namespace std;
+
+ofstream debug;
+ofstream errorlog;
+
+#define NUM_COLOURS (1 << 24)               //!< the number of 24 bit colours
+#define CAMERA_WIDTH 640                    //!< the width of the synthetic camera image
+#define CAMERA_HEIGHT 480                   //!< the height of the synthetic camera image
+#define MAX_REPORTED_FAILURES 5             //!< the number of failures of each conversion that are printed in full
+
+/*! @brief The result of checking a single conversion */
+class CheckResult
+{
+public:
+    CheckResult(const string& name) : m_name(name), m_checked(0), m_off_by_one(0), m_failures(0), m_model("") {}
+
+    /*! @brief Sets the source pixel whose channels are compared next, which is printed if a channel fails
+        @param model the colour model of the source pixel
+     */
+    void setPixel(const char* model, int a, int b, int c)
+    {
+        m_model = model;
+        m_pixel[0] = a;
+        m_pixel[1] = b;
+        m_pixel[2] = c;
+    }
+    /*! @brief Compares a channel of the converted pixel with the reference
+        @param channel the name of the channel
+        @param tolerance the largest difference that is not a failure
+     */
+    void compare(const char* channel, int value, int reference, int tolerance = 1)
+    {
+        int difference = abs(value - reference);
+        if (difference == 1 and tolerance >= 1)
+            m_off_by_one++;
+        else if (difference > tolerance)
+        {
+            m_failures++;
+            if (m_failures <= MAX_REPORTED_FAILURES)
+                cout << "    " << m_name << " " << m_model << " (" << m_pixel[0] << ", " << m_pixel[1] << ", " << m_pixel[2] << "): " << channel << " is " << value << " not " << reference << endl;
+        }
+    }
+    /*! @brief Counts a pixel as checked */
+    void count() {m_checked++;}
+    bool failed() const {return m_failures > 0;}
+
+    void print() const
+    {
+        cout << m_name << ": " << m_checked << " pixels checked, " << m_off_by_one << " channels off by one level, " << m_failures << " failures" << endl;
+    }
+private:
+    string m_name;                          //!< the name of the conversion
+    long m_checked;                         //!< the number of pixels checked
+    long m_off_by_one;                      //!< the number of channels differing from the reference by one level
+    long m_failures;                        //!< the number of channels differing from the reference by more than the tolerance
+    const char* m_model;                    //!< the colour model of the source pixel being compared
+    int m_pixel[3];                         //!< the channels of the source pixel being compared
+};
+
+/*! @brief Sets a full resolution YCbCr pixel from the 24 bit colour (Y << 16) | (Cb << 8) | Cr */
+static void makeYCbCr(int colour, Pixel& pixel)
+{
+    pixel.y = pixel.yCbCrPadding = (colour >> 16) & 0xff;
+    pixel.cb = (colour >> 8) & 0xff;
+    pixel.cr = colour & 0xff;
+}
+
+/*! @brief Checks fromRGBToYCbCr with every RGB colour */
+static bool checkRGBToYCbCr(int rowlength)
+{
+    CheckResult result("fromRGBToYCbCr");
+    vector<unsigned char> rgb(3*rowlength);
+    vector<Pixel> pixels(rowlength);
+    for (int first = 0; first < NUM_COLOURS; first += rowlength)
+    {
+        int n = min(rowlength, NUM_COLOURS - first);
+        for (int i=0; i<n; i++)
+        {
+            int colour = first + i;
+            rgb[3*i] = (colour >> 16) & 0xff;
+            rgb[3*i + 1] = (colour >> 8) & 0xff;
+            rgb[3*i + 2] = colour & 0xff;
+        }
+        ImageConversions::fromRGBToYCbCr(&rgb[0], &pixels[0], n);
+        for (int i=0; i<n; i++)
+        {
+            unsigned char y, cb, cr;
+            ColorModelConversions::fromRGBToYCbCr(rgb[3*i], rgb[3*i + 1], rgb[3*i + 2], y, cb, cr);
+            result.setPixel("RGB", rgb[3*i], rgb[3*i + 1], rgb[3*i + 2]);
+            result.compare("Y", pixels[i].y, y);
+            result.compare("Cb", pixels[i].cb, cb);
+            result.compare("Cr", pixels[i].cr, cr);
+            result.compare("the padding", pixels[i].yCbCrPadding, pixels[i].y, 0);
+            result.count();
+        }
+    }
+    result.print();
+    return not result.failed();
+}
+
+/*! @brief Checks fromYCbCrToRGB, fromYCbCrToBGR and fromYCbCrToARGB with every YCbCr pixel */
+static bool checkYCbCrToRGB(int rowlength)
+{
+    CheckResult rgbresult("fromYCbCrToRGB");
+    CheckResult bgrresult("fromYCbCrToBGR");
+    CheckResult argbresult("fromYCbCrToARGB");
+    vector<Pixel> pixels(rowlength);
+    vector<unsigned char> rgb(3*rowlength);
+    vector<unsigned char> bgr(3*rowlength);
+    vector<unsigned int> argb(rowlength);
+    for (int first = 0; first < NUM_COLOURS; first += rowlength)
+    {
+        int n = min(rowlength, NUM_COLOURS - first);
+        for (int i=0; i<n; i++)
+            makeYCbCr(first + i, pixels[i]);
+        ImageConversions::fromYCbCrToRGB(&pixels[0], &rgb[0], n);
+        ImageConversions::fromYCbCrToBGR(&pixels[0], &bgr[0], n);
+        ImageConversions::fromYCbCrToARGB(&pixels[0], &argb[0], n);
+        for (int i=0; i<n; i++)
+        {
+            unsigned char r, g, b;
+            ColorModelConversions::fromYCbCrToRGB(pixels[i].y, pixels[i].cb, pixels[i].cr, r, g, b);
+            rgbresult.setPixel("YCbCr", pixels[i].y, pixels[i].cb, pixels[i].cr);
+            bgrresult.setPixel("YCbCr", pixels[i].y, pixels[i].cb, pixels[i].cr);
+            argbresult.setPixel("YCbCr", pixels[i].y, pixels[i].cb, pixels[i].cr);
+            rgbresult.compare("R", rgb[3*i], r);
+            rgbresult.compare("G", rgb[3*i + 1], g);
+            rgbresult.compare("B", rgb[3*i + 2], b);
+            rgbresult.count();
+            bgrresult.compare("B", bgr[3*i], b);
+            bgrresult.compare("G", bgr[3*i + 1], g);
+            bgrresult.compare("R", bgr[3*i + 2], r);
+            bgrresult.count();
+            argbresult.compare("A", argb[i] >> 24, 0xff, 0);
+            argbresult.compare("R", (argb[i] >> 16) & 0xff, r);
+            argbresult.compare("G", (argb[i] >> 8) & 0xff, g);
+            argbresult.compare("B", argb[i] & 0xff, b);
+            argbresult.count();
+        }
+    }
+    rgbresult.print();
+    bgrresult.print();
+    argbresult.print();
+    return not rgbresult.failed() and not bgrresult.failed() and not argbresult.failed();
+}
+
+/*! @brief Checks packYUV422 with every pair of Cb values and every pair of Cr values, and unpackYUV422 with the packed pixels */
+static bool checkYUV422(int rowlength)
+{
+    CheckResult packresult("packYUV422");
+    CheckResult unpackresult("unpackYUV422");
+    int numpairs = 1 << 16;
+    // pair k has the Cb values (k >> 8, k & 0xff), the Cr values the other way around, and pseudo-random Y values
+    vector<Pixel> pixels(2*numpairs);
+    srand(1);
+    for (int k=0; k<numpairs; k++)
+    {
+        makeYCbCr((rand() & 0xff) << 16 | (k & 0xff00) | (k & 0xff), pixels[2*k]);
+        makeYCbCr((rand() & 0xff) << 16 | (k & 0xff) << 8 | (k >> 8), pixels[2*k + 1]);
+    }
+
+    int packedlength = max(rowlength/2, 1);
+    vector<Pixel> packed(packedlength);
+    vector<Pixel> unpacked(2*packedlength);
+    vector<Pixel> repacked(packedlength);
+    for (int first = 0; first < numpairs; first += packedlength)
+    {
+        int n = min(packedlength, numpairs - first);
+        const Pixel* source = &pixels[2*first];
+        ImageConversions::packYUV422(source, &packed[0], 2*n);
+        for (int i=0; i<n; i++)
+        {
+            const Pixel& even = source[2*i];
+            const Pixel& odd = source[2*i + 1];
+            packresult.setPixel("pair", first + i, even.cb, odd.cb);
+            packresult.compare("the first Y", packed[i].yCbCrPadding, even.y, 0);
+            packresult.compare("Cb", packed[i].cb, (even.cb + odd.cb + 1)/2, 0);
+            packresult.compare("the second Y", packed[i].y, odd.y, 0);
+            packresult.compare("Cr", packed[i].cr, (even.cr + odd.cr + 1)/2, 0);
+            packresult.count();
+        }
+
+        ImageConversions::unpackYUV422(&packed[0], &unpacked[0], n);
+        ImageConversions::packYUV422(&unpacked[0], &repacked[0], 2*n);
+        for (int i=0; i<n; i++)
+        {
+            unpackresult.setPixel("pair", first + i, packed[i].cb, packed[i].cr);
+            for (int k=0; k<2; k++)
+            {
+                const Pixel& p = unpacked[2*i + k];
+                int y = k == 0 ? packed[i].yCbCrPadding : packed[i].y;
+                unpackresult.compare("Y", p.y, y, 0);
+                unpackresult.compare("the padding", p.yCbCrPadding, y, 0);
+                unpackresult.compare("Cb", p.cb, packed[i].cb, 0);
+                unpackresult.compare("Cr", p.cr, packed[i].cr, 0);
+                unpackresult.count();
+            }
+            unpackresult.compare("the repacked pixel", repacked[i].color == packed[i].color ? 0 : 1, 0, 0);
+        }
+    }
+    packresult.print();
+    unpackresult.print();
+    return not packresult.failed() and not unpackresult.failed();
+}
+
+/*! @brief Checks downsampleYUV422 with a synthetic camera image */
+static bool checkDownsample()
+{
+    CheckResult result("downsampleYUV422");
+    int rowbytes = 2*CAMERA_WIDTH;
+    vector<unsigned char> yuv422(rowbytes*CAMERA_HEIGHT);
+    srand(2);
+    for (size_t i=0; i<yuv422.size(); i++)
+        yuv422[i] = rand() & 0xff;
+
+    int width = CAMERA_WIDTH/2;
+    int height = CAMERA_HEIGHT/2;
+    vector<Pixel> image(width*height);
+    vector<Pixel*> rows(height);
+    for (int y=0; y<height; y++)
+        rows[y] = &image[y*width];
+    ImageConversions::downsampleYUV422(&yuv422[0], CAMERA_WIDTH, CAMERA_HEIGHT, &rows[0]);
+
+    for (int y=0; y<height; y++)
+    {
+        for (int x=0; x<width; x++)
+        {
+            const unsigned char* source = &yuv422[2*y*rowbytes + 4*x];
+            const Pixel& p = rows[y][x];
+            result.setPixel("pixel", x, y, 0);
+            for (int c=0; c<4; c++)
+                result.compare("a channel", p.channel[c], source[c], 0);
+            result.count();
+        }
+    }
+    result.print();
+    return not result.failed();
+}
+
+int main(int argc, const char *argv[])
+{
+    debug.open("imageconversioncheckdebug.log");
+    errorlog.open("imageconversioncheckerror.log");
+
+    int rowlength = argc > 1 ? atoi(argv[1]) : 321;
+    if (rowlength <= 0)
+    {
+        cerr << "imageconversioncheck: the row length must be positive" << endl;
+        return 1;
+    }
+
+    cout << "ImageConversions " << (ImageConversions::isAccelerated() ? "with" : "without") << " SSE2, in rows of " << rowlength << " pixels" << endl;
+    bool passed = checkRGBToYCbCr(rowlength);
+    passed = checkYCbCrToRGB(rowlength) and passed;
+    passed = checkYUV422(rowlength) and passed;
+    passed = checkDownsample() and passed;
+    cout << (passed ? "passed" : "FAILED") << endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,302 @@
+/*! @file ImageConversions.cpp
+    @brief Implementation of ImageConversions class
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ImageConversions.h"
+
+#include <cstring>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+    #define IMAGE_CONVERSIONS_USE_SSE2
+#endif
+
+// The coefficients of ColorModelConversions in 16.16 fixed point
+#define FIXED_Y_R 19595
+#define FIXED_Y_G 38470
+#define FIXED_Y_B 7471
+#define FIXED_CB_R -11076
+#define FIXED_CB_G -21758
+#define FIXED_CB_B 32768
+#define FIXED_CR_R 32768
+#define FIXED_CR_G -27460
+#define FIXED_CR_B -5328
+#define FIXED_R_CR 92242
+#define FIXED_G_CB -22643
+#define FIXED_G_CR -46982
+#define FIXED_B_CB 116589
+#define FIXED_CHROMA_OFFSET (128 << 16)
+
+/*! @brief Rounds a 16.16 fixed point number to the nearest integer, and clips it to [0, 255] */
+static inline unsigned char roundFixed(int value)
+{
+    value += 1 << 15;
+    if (value < 0)
+        return 0;
+    else if (value >= (255 << 16))
+        return 255;
+    else
+        return static_cast<unsigned char>(value >> 16);
+}
+
+/*! @brief Converts a single RGB pixel to a full resolution YCbCr pixel */
+static inline void convertRGBToYCbCr(const unsigned char* rgb, Pixel& pixel)
+{
+    int r = rgb[0], g = rgb[1], b = rgb[2];
+    unsigned char y = roundFixed(FIXED_Y_R*r + FIXED_Y_G*g + FIXED_Y_B*b);
+    pixel.yCbCrPadding = y;
+    pixel.cb = roundFixed(FIXED_CB_R*r + FIXED_CB_G*g + FIXED_CB_B*b + FIXED_CHROMA_OFFSET);
+    pixel.y = y;
+    pixel.cr = roundFixed(FIXED_CR_R*r + FIXED_CR_G*g + FIXED_CR_B*b + FIXED_CHROMA_OFFSET);
+}
+
+/*! @brief Converts a single YCbCr pixel to RGB */
+static inline void convertYCbCrToRGB(const Pixel& pixel, unsigned char& r, unsigned char& g, unsigned char& b)
+{
+    int y = pixel.y << 16;
+    int cb = pixel.cb - 128;
+    int cr = pixel.cr - 128;
+    r = roundFixed(y + FIXED_R_CR*cr);
+    g = roundFixed(y + FIXED_G_CB*cb + FIXED_G_CR*cr);
+    b = roundFixed(y + FIXED_B_CB*cb);
+}
+
+#ifdef IMAGE_CONVERSIONS_USE_SSE2
+/*! @brief Clips each element to [0, 255] and rounds it to the nearest integer */
+static inline __m128i roundAndClip(__m128 value)
+{
+    value = _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(255.0f));
+    return _mm_cvttps_epi32(_mm_add_ps(value, _mm_set1_ps(0.5f)));
+}
+
+/*! @brief Returns the floating point value of the byte at the given shift in each of the four words */
+static inline __m128 extractChannel(__m128i words, int shift)
+{
+    return _mm_cvtepi32_ps(_mm_and_si128(_mm_srl_epi32(words, _mm_cvtsi32_si128(shift)), _mm_set1_epi32(0xff)));
+}
+
+/*! @brief Converts four YCbCr pixels to 0xffRRGGBB words */
+static inline __m128i convertYCbCrToARGB(__m128i pixels)
+{
+    __m128 cb = _mm_sub_ps(extractChannel(pixels, 8), _mm_set1_ps(128.0f));
+    __m128 y = extractChannel(pixels, 16);
+    __m128 cr = _mm_sub_ps(extractChannel(pixels, 24), _mm_set1_ps(128.0f));
+
+    __m128i r = roundAndClip(_mm_add_ps(y, _mm_mul_ps(_mm_set1_ps(1.4075f), cr)));
+    __m128i g = roundAndClip(_mm_sub_ps(_mm_sub_ps(y, _mm_mul_ps(_mm_set1_ps(0.3455f), cb)), _mm_mul_ps(_mm_set1_ps(0.7169f), cr)));
+    __m128i b = roundAndClip(_mm_add_ps(y, _mm_mul_ps(_mm_set1_ps(1.7790f), cb)));
+
+    __m128i argb = _mm_or_si128(_mm_slli_epi32(r, 16), _mm_slli_epi32(g, 8));
+    argb = _mm_or_si128(argb, b);
+    return _mm_or_si128(argb, _mm_set1_epi32(static_cast<int>(0xff000000)));
+}
+
+/*! @brief Converts the YCbCr pixels to three bytes per pixel, in the order given by the shifts of each channel in a 0xffRRGGBB word */
+static void convertYCbCrToBytes(const Pixel* pixels, unsigned char* bytes, int numpixels, int firstshift, int thirdshift)
+{
+    int i = 0;
+    unsigned int words[4];
+    for (; i + 4 <= numpixels; i += 4)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(words), convertYCbCrToARGB(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i))));
+        for (int k=0; k<4; k++)
+        {
+            *bytes++ = static_cast<unsigned char>(words[k] >> firstshift);
+            *bytes++ = static_cast<unsigned char>(words[k] >> 8);
+            *bytes++ = static_cast<unsigned char>(words[k] >> thirdshift);
+        }
+    }
+    for (; i < numpixels; i++)
+    {
+        unsigned char r, g, b;
+        convertYCbCrToRGB(pixels[i], r, g, b);
+        *bytes++ = firstshift == 16 ? r : b;
+        *bytes++ = g;
+        *bytes++ = firstshift == 16 ? b : r;
+    }
+}
+#endif
+
+/*! @brief Converts RGB pixels to full resolution YCbCr pixels
+    @param rgb the source pixels, three bytes each
+    @param pixels the destination, which must have room for numpixels
+    @param numpixels the number of pixels to convert
+ */
+void ImageConversions::fromRGBToYCbCr(const unsigned char* rgb, Pixel* pixels, int numpixels)
+{
+    int i = 0;
+    #ifdef IMAGE_CONVERSIONS_USE_SSE2
+        // each pixel is loaded as a 32 bit word, so the last pixel is left to the scalar loop to avoid reading past the end
+        for (; i + 4 < numpixels; i += 4)
+        {
+            const unsigned char* source = rgb + 3*i;
+            unsigned int words[4];
+            memcpy(&words[0], source, 4);
+            memcpy(&words[1], source + 3, 4);
+            memcpy(&words[2], source + 6, 4);
+            memcpy(&words[3], source + 9, 4);
+            __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words));
+            __m128 r = extractChannel(packed, 0);
+            __m128 g = extractChannel(packed, 8);
+            __m128 b = extractChannel(packed, 16);
+
+            __m128 y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(0.299f), r), _mm_mul_ps(_mm_set1_ps(0.587f), g)), _mm_mul_ps(_mm_set1_ps(0.114f), b));
+            __m128 cb = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(-0.169f), r), _mm_mul_ps(_mm_set1_ps(-0.332f), g)), _mm_mul_ps(_mm_set1_ps(0.5f), b));
+            __m128 cr = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(0.5f), r), _mm_mul_ps(_mm_set1_ps(-0.419f), g)), _mm_mul_ps(_mm_set1_ps(-0.0813f), b));
+            __m128i yi = roundAndClip(y);
+            __m128i cbi = roundAndClip(_mm_add_ps(cb, _mm_set1_ps(128.0f)));
+            __m128i cri = roundAndClip(_mm_add_ps(cr, _mm_set1_ps(128.0f)));
+
+            __m128i result = _mm_or_si128(yi, _mm_slli_epi32(yi, 16));
+            result = _mm_or_si128(result, _mm_slli_epi32(cbi, 8));
+            result = _mm_or_si128(result, _mm_slli_epi32(cri, 24));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i), result);
+        }
+    #endif
+    for (; i < numpixels; i++)
+        convertRGBToYCbCr(rgb + 3*i, pixels[i]);
+}
+
+/*! @brief Converts YCbCr pixels to RGB pixels
+    @param pixels the source pixels
+    @param rgb the destination, which must have room for 3*numpixels bytes
+    @param numpixels the number of pixels to convert
+ */
+void ImageConversions::fromYCbCrToRGB(const Pixel* pixels, unsigned char* rgb, int numpixels)
+{
+    #ifdef IMAGE_CONVERSIONS_USE_SSE2
+        convertYCbCrToBytes(pixels, rgb, numpixels, 16, 0);
+    #else
+        for (int i=0; i<numpixels; i++, rgb += 3)
+            convertYCbCrToRGB(pixels[i], rgb[0], rgb[1], rgb[2]);
+    #endif
+}
+
+/*! @brief Converts YCbCr pixels to BGR pixels (the order OpenCV uses)
+    @param pixels the source pixels
+    @param bgr the destination, which must have room for 3*numpixels bytes
+    @param numpixels the number of pixels to convert
+ */
+void ImageConversions::fromYCbCrToBGR(const Pixel* pixels, unsigned char* bgr, int numpixels)
+{
+    #ifdef IMAGE_CONVERSIONS_USE_SSE2
+        convertYCbCrToBytes(pixels, bgr, numpixels, 0, 16);
+    #else
+        for (int i=0; i<numpixels; i++, bgr += 3)
+            convertYCbCrToRGB(pixels[i], bgr[2], bgr[1], bgr[0]);
+    #endif
+}
+
+/*! @brief Converts YCbCr pixels to opaque 0xAARRGGBB words (the format of a QImage::Format_ARGB32 scan line)
+    @param pixels the source pixels
+    @param argb the destination, which must have room for numpixels
+    @param numpixels the number of pixels to convert
+ */
+void ImageConversions::fromYCbCrToARGB(const Pixel* pixels, unsigned int* argb, int numpixels)
+{
+    int i = 0;
+    #ifdef IMAGE_CONVERSIONS_USE_SSE2
+        for (; i + 4 <= numpixels; i += 4)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(argb + i), convertYCbCrToARGB(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i))));
+    #endif
+    for (; i < numpixels; i++)
+    {
+        unsigned char r, g, b;
+        convertYCbCrToRGB(pixels[i], r, g, b);
+        argb[i] = 0xff000000 | (r << 16) | (g << 8) | b;
+    }
+}
+
+/*! @brief Packs pairs of full resolution YCbCr pixels into YUV422 pixels. The chroma of each pair is averaged.
+    @param pixels the source pixels
+    @param packed the destination, which must have room for numpixels/2
+    @param numpixels the number of source pixels. If it is odd the last pixel is ignored.
+ */
+void ImageConversions::packYUV422(const Pixel* pixels, Pixel* packed, int numpixels)
+{
+    int numpacked = numpixels/2;
+    int i = 0;
+    #ifdef IMAGE_CONVERSIONS_USE_SSE2
+        for (; i + 4 <= numpacked; i += 4)
+        {
+            __m128i first = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + 2*i)), _MM_SHUFFLE(3,1,2,0));
+            __m128i second = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + 2*i + 4)), _MM_SHUFFLE(3,1,2,0));
+            __m128i even = _mm_unpacklo_epi64(first, second);
+            __m128i odd = _mm_unpackhi_epi64(first, second);
+
+            __m128i chroma = _mm_and_si128(_mm_avg_epu8(even, odd), _mm_set1_epi32(static_cast<int>(0xff00ff00)));
+            __m128i y0 = _mm_and_si128(_mm_srli_epi32(even, 16), _mm_set1_epi32(0xff));
+            __m128i y1 = _mm_and_si128(odd, _mm_set1_epi32(0xff0000));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(packed + i), _mm_or_si128(chroma, _mm_or_si128(y0, y1)));
+        }
+    #endif
+    for (; i < numpacked; i++)
+    {
+        const Pixel& even = pixels[2*i];
+        const Pixel& odd = pixels[2*i + 1];
+        packed[i].yCbCrPadding = even.y;
+        packed[i].cb = (even.cb + odd.cb + 1) >> 1;
+        packed[i].y = odd.y;
+        packed[i].cr = (even.cr + odd.cr + 1) >> 1;
+    }
+}
+
+/*! @brief Unpacks YUV422 pixels into pairs of full resolution YCbCr pixels
+    @param packed the source pixels
+    @param pixels the destination, which must have room for 2*numpacked
+    @param numpacked the number of YUV422 pixels
+ */
+void ImageConversions::unpackYUV422(const Pixel* packed, Pixel* pixels, int numpacked)
+{
+    for (int i=0; i<numpacked; i++)
+    {
+        Pixel& even = pixels[2*i];
+        Pixel& odd = pixels[2*i + 1];
+        even = packed[i];
+        even.y = packed[i].yCbCrPadding;
+        odd = packed[i];
+        odd.yCbCrPadding = packed[i].y;
+    }
+}
+
+/*! @brief Copies a YUV422 image into an image of half the resolution; every second row is dropped and each YUV422 pixel
+           becomes a single pixel. This is the format of the images Vision uses on the NAO.
+    @param yuv422 the source image, 2*width bytes per row
+    @param width the width of the source image in pixels
+    @param height the height of the source image in pixels
+    @param rows the rows of the destination image, which must be at least width/2 by height/2
+ */
+void ImageConversions::downsampleYUV422(const unsigned char* yuv422, int width, int height, Pixel** rows)
+{
+    int rowbytes = 2*width;
+    for (int y=0; y<height/2; y++)
+        memcpy(rows[y], yuv422 + 2*y*rowbytes, (width/2)*sizeof(Pixel));
+}
+
+/*! @brief Returns true if the conversions are vectorised on this build */
+bool ImageConversions::isAccelerated()
+{
+    #ifdef IMAGE_CONVERSIONS_USE_SSE2
+        return true;
+    #else
+        return false;
+    #endif
+}
+
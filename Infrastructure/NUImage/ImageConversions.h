@@ -0,0 +1,57 @@
+/*! @file ImageConversions.h
+    @brief Declaration of ImageConversions class
+
+    @class ImageConversions
+    @brief Colour conversions between whole rows of RGB, YCbCr and YUV422 pixels
+
+    ColorModelConversions converts a single pixel at a time in floating point. These functions
+    convert a contiguous run of pixels straight into the destination buffer (usually a row of
+    an NUImage), using the same coefficients as ColorModelConversions. On x86 with SSE2 four
+    pixels are converted at a time, elsewhere (the NAO's geode has no SSE) a fixed point
+    version is used. Both agree with ColorModelConversions to within one level.
+
+    The Pixel layout is that of NUImage. A full resolution YCbCr pixel has its Y in both the y
+    and the yCbCrPadding channels. A YUV422 pixel (as it comes from the NAO's camera) is two
+    horizontally adjacent pixels sharing a single Cb and Cr; the first Y is in yCbCrPadding and
+    the second in y.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef IMAGE_CONVERSIONS_H
+#define IMAGE_CONVERSIONS_H
+
+#include "Pixel.h"
+
+class ImageConversions
+{
+public:
+    static void fromRGBToYCbCr(const unsigned char* rgb, Pixel* pixels, int numpixels);
+    static void fromYCbCrToRGB(const Pixel* pixels, unsigned char* rgb, int numpixels);
+    static void fromYCbCrToBGR(const Pixel* pixels, unsigned char* bgr, int numpixels);
+    static void fromYCbCrToARGB(const Pixel* pixels, unsigned int* argb, int numpixels);
+
+    static void packYUV422(const Pixel* pixels, Pixel* packed, int numpixels);
+    static void unpackYUV422(const Pixel* packed, Pixel* pixels, int numpacked);
+    static void downsampleYUV422(const unsigned char* yuv422, int width, int height, Pixel** rows);
+
+    static bool isAccelerated();
+};
+
+#endif
+
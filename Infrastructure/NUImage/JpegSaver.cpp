@@ -1,38 +1,28 @@
 #include "JpegSaver.h"
-#include "Tools/Image/ColorModelConversions.h"
+#include "ImageConversions.h"
 #if defined WIN32 || defined WIN64
 #include "highgui.h"
 #else
 #include "opencv/highgui.h"
 #endif
 
+std::vector<unsigned char> JpegSaver::m_bgr_buffer;
 
-bool JpegSaver::saveNUimageAsJpeg(NUimage* image, const std::string& pFileName)
+bool JpegSaver::saveNUimageAsJpeg(const NUImage* image, const std::string& pFileName)
 {
-    unsigned char r,g,b;
-    char* bgrBuffer = new char[image->width() * image->height() * 3];
-    int bufferIndex = 0;
-    pixels::Pixel temp; 
-    for(int y = 0; y < image->height(); y++)
-    {
-        for (int x = 0; x < image->width(); x++)
-        {
-            temp = image->image[y][x];
-            ColorModelConversions::fromYCbCrToRGB(temp.y,temp.cb,temp.cr,r,g,b);
-            bgrBuffer[bufferIndex++] = b;
-            bgrBuffer[bufferIndex++] = g;
-            bgrBuffer[bufferIndex++] = r;
-        }
-    }
+    int width = image->getWidth();
+    int height = image->getHeight();
+    m_bgr_buffer.resize(3*width*height);
+    for (int y = 0; y < height; y++)
+        ImageConversions::fromYCbCrToBGR(image->m_image[y], &m_bgr_buffer[3*y*width], width);
 
         IplImage* fIplImageHeader;
-        fIplImageHeader = cvCreateImageHeader(cvSize(image->width(), image->height()), 8, 3);
-        fIplImageHeader->imageData = bgrBuffer;
+        fIplImageHeader = cvCreateImageHeader(cvSize(width, height), 8, 3);
+        fIplImageHeader->imageData = reinterpret_cast<char*>(&m_bgr_buffer[0]);
         cvSaveImage(pFileName.c_str(),fIplImageHeader);
         if (fIplImageHeader)
         {
             cvReleaseImageHeader(&fIplImageHeader);
         }
-        delete [] bgrBuffer;
         return true;
 }
@@ -1,13 +1,16 @@
 #ifndef __JPEGSAVER_H__
 #define __JPEGSAVER_H__
 
-#include "NUimage.h"
+#include "NUImage.h"
 #include <string>
+#include <vector>
 
 class JpegSaver
 {
 public:
-    static bool saveNUimageAsJpeg(NUimage* image, const std::string& pFileName);
+    static bool saveNUimageAsJpeg(const NUImage* image, const std::string& pFileName);
+private:
+    static std::vector<unsigned char> m_bgr_buffer;     //!< the converted image; kept between calls so that it is only allocated once
 };
 
 #endif
@@ -2,6 +2,7 @@
 #include <cstring>
 #include <string>
 #include "ColorModelConversions.h"
+#include "ImageConversions.h"
 /*!
 @file NUImage.h
 @brief Declaration of NUbots NUImage class. Storage class for images.
@@ -153,14 +154,7 @@ void NUImage::CopyFromYUV422Buffer(const unsigned char* buffer, int width, int h
     height /= 2;
     setImageDimensions(width, height);
     useInternalBuffer(true);
-    Pixel* pixelisedBuffer = (Pixel*)buffer;
-    for(int y = 0; y < height; y++)
-    {
-       for(int x = 0; x < width; x++)
-       {
-           this->m_image[y][x] = pixelisedBuffer[y*width*2 + x];
-       }
-    }
+    ImageConversions::downsampleYUV422(buffer, 2*width, 2*height, m_image);
     return;
 }
 
@@ -24,6 +24,7 @@ SET (YOUR_SRCS
 BresenhamLine.cpp
 ClassifiedImage.cpp
 NUImage.cpp
+ImageConversions.cpp
 #JpegSaver.cpp  
 )
 ####################################################################################
@@ -0,0 +1,103 @@
+/*! @file KinematicHistory.cpp
+    @brief Implementation of a ring of recent kinematic states
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "KinematicHistory.h"
+
+#include <cmath>
+
+KinematicHistory::KinematicHistory()
+{
+}
+
+KinematicHistory::~KinematicHistory()
+{
+}
+
+/*! @brief Empties the history. This must not be called while another thread is reading it. */
+void KinematicHistory::clear()
+{
+    m_states.clear();
+}
+
+/*! @brief Adds a state to the history, replacing the oldest one. Only one thread may record states.
+    @param state the new state; its time must not be older than the previous state's
+ */
+void KinematicHistory::record(const KinematicState& state)
+{
+    m_states.record(state);
+}
+
+/*! @brief Gets the state at the given time, interpolating between the recorded states either side of it.
+           If the time is newer than the newest state the newest state is used, and if it is older than the
+           oldest state the oldest state is used.
+    @param time the time in ms
+    @param state will be updated with the state at the given time
+    @return false if the history is empty
+ */
+bool KinematicHistory::get(double time, KinematicState& state) const
+{
+    return m_states.get(time, state, interpolate);
+}
+
+/*! @brief Linearly interpolates between two states. A part that is only valid in one of them is taken from the nearer
+           one, provided it is valid there.
+ */
+void KinematicHistory::interpolate(const KinematicState& older, const KinematicState& newer, double time, KinematicState& state)
+{
+    double dt = newer.Time - older.Time;
+    float fraction = dt > 0 ? (time - older.Time)/dt : 1;
+    const KinematicState& nearer = fraction < 0.5 ? older : newer;
+
+    state = nearer;
+    state.Time = time;
+    if (older.CameraTransformValid and newer.CameraTransformValid)
+    {
+        for (int i=0; i<16; i++)
+            state.CameraTransform[i] = older.CameraTransform[i] + fraction*(newer.CameraTransform[i] - older.CameraTransform[i]);
+    }
+    if (older.CameraToGroundTransformValid and newer.CameraToGroundTransformValid)
+    {
+        for (int i=0; i<16; i++)
+            state.CameraToGroundTransform[i] = older.CameraToGroundTransform[i] + fraction*(newer.CameraToGroundTransform[i] - older.CameraToGroundTransform[i]);
+    }
+    if (older.HorizonValid and newer.HorizonValid)
+    {
+        for (int i=0; i<3; i++)
+            state.Horizon[i] = older.Horizon[i] + fraction*(newer.Horizon[i] - older.Horizon[i]);
+    }
+    if (older.OrientationValid and newer.OrientationValid)
+    {
+        for (int i=0; i<3; i++)
+        {   // the angles are interpolated the short way round
+            float difference = newer.Orientation[i] - older.Orientation[i];
+            if (difference > M_PI)
+                difference -= 2*M_PI;
+            else if (difference < -M_PI)
+                difference += 2*M_PI;
+            state.Orientation[i] = older.Orientation[i] + fraction*difference;
+        }
+    }
+    if (older.CameraHeightValid and newer.CameraHeightValid)
+        state.CameraHeight = older.CameraHeight + fraction*(newer.CameraHeight - older.CameraHeight);
+    if (older.HeadPitchValid and newer.HeadPitchValid)
+        state.HeadPitch = older.HeadPitch + fraction*(newer.HeadPitch - older.HeadPitch);
+}
+
@@ -0,0 +1,74 @@
+/*! @file KinematicHistory.h
+    @brief Declaration of a ring of recent kinematic states
+
+    @class KinematicHistory
+    @brief A lock-free ring of recent kinematic states (camera transforms, horizon, orientation) keyed by time
+
+    The states are recorded by the thread updating the sensors, and can be read at the same time by any number
+    of other threads. So vision can use the camera pose at the time the image was taken, rather than the pose
+    the sensor thread last calculated which may be up to a camera period newer.
+
+    The ring is a SeqlockHistory, so there is only ever one writer, and the readers never block it.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KINEMATICHISTORY_H
+#define KINEMATICHISTORY_H
+
+#include "SeqlockHistory.h"
+
+#define KINEMATIC_HISTORY_SIZE 32           // 320ms of states when the sensors are updated at 100Hz
+
+/*! @brief A snapshot of the kinematic sensors at a single time */
+struct KinematicState
+{
+    double Time;                            //!< the time of the sensor update in ms
+    bool CameraTransformValid;
+    bool CameraToGroundTransformValid;
+    bool HorizonValid;
+    bool OrientationValid;
+    bool CameraHeightValid;
+    bool HeadPitchValid;
+    float CameraTransform[16];              //!< the flattened 4x4 camera transform
+    float CameraToGroundTransform[16];      //!< the flattened 4x4 camera to ground transform
+    float Horizon[3];                       //!< the horizon line coefficients [A, B, C]
+    float Orientation[3];                   //!< [roll, pitch, yaw]
+    float CameraHeight;                     //!< the height of the camera above the ground in cm
+    float HeadPitch;                        //!< the head pitch joint position in radians
+};
+
+class KinematicHistory
+{
+public:
+    KinematicHistory();
+    ~KinematicHistory();
+
+    void record(const KinematicState& state);
+    bool get(double time, KinematicState& state) const;
+    void clear();
+
+private:
+    static void interpolate(const KinematicState& older, const KinematicState& newer, double time, KinematicState& state);
+
+private:
+    SeqlockHistory<KinematicState, KINEMATIC_HISTORY_SIZE> m_states;  //!< the ring of states
+};
+
+#endif
+
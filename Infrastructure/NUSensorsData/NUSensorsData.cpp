@@ -26,6 +26,7 @@
 #include "debugverbositynusensors.h"
 
 #include <fstream>
+#include <algorithm>
 #include <limits>
 
 int s_curr_id = NUData::m_num_common_ids+1; 
@@ -411,6 +412,103 @@ bool NUSensorsData::getOdometry(vector<float>& data)
         return false;
 }
 
+/*! @brief Records the current kinematic sensors in the kinematic history. This must only be called by the thread updating the sensors. */
+void NUSensorsData::recordKinematics()
+{
+    KinematicState& state = m_kinematic_state;
+    state.Time = CurrentTime;
+    state.CameraTransformValid = get(CameraTransform, m_kinematic_buffer) and m_kinematic_buffer.size() == 16;
+    if (state.CameraTransformValid)
+        copy(m_kinematic_buffer.begin(), m_kinematic_buffer.end(), state.CameraTransform);
+    state.CameraToGroundTransformValid = get(CameraToGroundTransform, m_kinematic_buffer) and m_kinematic_buffer.size() == 16;
+    if (state.CameraToGroundTransformValid)
+        copy(m_kinematic_buffer.begin(), m_kinematic_buffer.end(), state.CameraToGroundTransform);
+    state.HorizonValid = get(Horizon, m_kinematic_buffer) and m_kinematic_buffer.size() == 3;
+    if (state.HorizonValid)
+        copy(m_kinematic_buffer.begin(), m_kinematic_buffer.end(), state.Horizon);
+    state.OrientationValid = get(Orientation, m_kinematic_buffer) and m_kinematic_buffer.size() == 3;
+    if (state.OrientationValid)
+        copy(m_kinematic_buffer.begin(), m_kinematic_buffer.end(), state.Orientation);
+    state.CameraHeightValid = get(CameraHeight, state.CameraHeight);
+    state.HeadPitchValid = getPosition(HeadPitch, state.HeadPitch);
+    m_kinematic_history.record(state);
+}
+
+/*! @brief Gets the kinematic sensors at the given time, interpolated from the recent history. This can be called
+           from any thread, for example to get the camera pose at the time an image was taken.
+    @param time the time in ms
+    @param state will be updated with the kinematic sensors at that time
+    @return false if there is no history
+ */
+bool NUSensorsData::getKinematics(double time, KinematicState& state) const
+{
+    return m_kinematic_history.get(time, state);
+}
+
+/*! @brief Records the robot's motion since the last sensor update in the odometry history. This must only be called by the thread updating the sensors.
+    @param dx the distance in cm the robot moved forward
+    @param dy the distance in cm the robot moved left
+    @param dheading the angle in radians the robot turned
+ */
+void NUSensorsData::recordOdometry(float dx, float dy, float dheading)
+{
+    m_odometry_history.record(CurrentTime, dx, dy, dheading);
+}
+
+/*! @brief Records the robot's motion since the last sensor update in the odometry history, with the turn fused with the yaw gyro.
+           This must only be called by the thread updating the sensors.
+    @param yawrate the yaw gyro in rad/s. The other parameters are the same as recordOdometry(dx, dy, dheading)
+ */
+void NUSensorsData::recordOdometry(float dx, float dy, float dheading, float yawrate)
+{
+    m_odometry_history.record(CurrentTime, dx, dy, dheading, yawrate);
+}
+
+/*! @brief Gets the robot's motion between two recent times from the odometry history. This can be called from any thread.
+    @param from the start time in ms, for example the capture time of the previous image
+    @param to the end time in ms
+    @param data will be updated with the motion [forward (cm), left (cm), turn (rad)] relative to the robot at the start time
+    @return false if there is no history
+ */
+bool NUSensorsData::getOdometry(double from, double to, vector<float>& data) const
+{
+    float dx, dy, dheading;
+    if (not m_odometry_history.getMotion(from, to, dx, dy, dheading))
+        return false;
+    data.resize(3);
+    data[0] = dx;
+    data[1] = dy;
+    data[2] = dheading;
+    return true;
+}
+
+/*! @brief Sets the robot's field pose at the given time. This must only be called by localisation.
+    @param time the time in ms the pose is for
+    @param pose the field pose [x (cm), y (cm), heading (rad)]
+ */
+void NUSensorsData::setFieldPose(double time, const vector<float>& pose)
+{
+    if (pose.size() >= 3)
+        m_odometry_history.setFieldPose(time, pose[0], pose[1], pose[2]);
+}
+
+/*! @brief Gets the robot's field pose at the newest sensor update; the last pose from localisation moved by the odometry since.
+           This can be called from any thread, so behaviour and motion can have a pose fresher than the last image.
+    @param pose will be updated with the field pose [x (cm), y (cm), heading (rad)]
+    @return false if localisation has not set a pose
+ */
+bool NUSensorsData::getFieldPose(vector<float>& pose) const
+{
+    OdometryPose fieldpose;
+    if (not m_odometry_history.getFieldPose(fieldpose))
+        return false;
+    pose.resize(3);
+    pose[0] = fieldpose.X;
+    pose[1] = fieldpose.Y;
+    pose[2] = fieldpose.Heading;
+    return true;
+}
+
 /******************************************************************************************************************************************
                                                                                                         Get Methods For Balance Information
  ******************************************************************************************************************************************/
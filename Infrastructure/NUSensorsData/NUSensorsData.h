@@ -27,6 +27,8 @@
 #define NUSENSORSDATA_H
 
 #include "Sensor.h"
+#include "KinematicHistory.h"
+#include "OdometryHistory.h"
 #include "Infrastructure/NUData.h"
 #include "Tools/FileFormats/TimestampedData.h"
 
@@ -164,6 +166,13 @@ public:
     bool getCameraHeight(float& data);
     bool getHorizon(vector<float>& data);
     bool getOdometry(vector<float>& data);
+    bool getOdometry(double from, double to, vector<float>& data) const;
+    void recordKinematics();
+    bool getKinematics(double time, KinematicState& state) const;
+    void recordOdometry(float dx, float dy, float dheading);
+    void recordOdometry(float dx, float dy, float dheading, float yawrate);
+    void setFieldPose(double time, const vector<float>& pose);
+    bool getFieldPose(vector<float>& pose) const;
     
     // Get methods for balance information
     bool getAccelerometer(vector<float>& data);
@@ -229,6 +238,10 @@ private:
 private:
     static vector<id_t*> m_ids;				 //!< a vector containing all of the actionator ids
     vector<Sensor> m_sensors;                //!< a vector of all of the sensors
+    KinematicHistory m_kinematic_history;    //!< the recent kinematic states, so that they can be matched to images
+    KinematicState m_kinematic_state;        //!< a preallocated state used by recordKinematics()
+    vector<float> m_kinematic_buffer;        //!< a preallocated buffer used by recordKinematics()
+    OdometryHistory m_odometry_history;      //!< the recent odometry poses, and the field pose anchored to them
 };  
 
 #endif
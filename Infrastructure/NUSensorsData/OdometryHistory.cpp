@@ -0,0 +1,215 @@
+/*! @file OdometryHistory.cpp
+    @brief Implementation of a ring of recent odometry poses
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "OdometryHistory.h"
+
+#include <cmath>
+
+OdometryHistory::OdometryHistory()
+{
+    clear();
+}
+
+OdometryHistory::~OdometryHistory()
+{
+}
+
+/*! @brief Empties the history and removes the anchor. This must not be called while another thread is using it. */
+void OdometryHistory::clear()
+{
+    m_pose.Time = 0;
+    m_pose.X = 0;
+    m_pose.Y = 0;
+    m_pose.Heading = 0;
+    m_poses.clear();
+    m_count = 0;
+    m_anchor_sequence = 0;
+}
+
+/*! @brief Integrates the robot's motion since the last record, and adds the new pose to the history. Only one thread may record poses.
+    @param time the time of the sensor update in ms; it must not be older than the previous one
+    @param dx the distance in cm the robot moved forward
+    @param dy the distance in cm the robot moved to the left
+    @param dheading the angle in radians the robot turned
+ */
+void OdometryHistory::record(double time, float dx, float dy, float dheading)
+{
+    // As in the localisation's motion model the translation is along the heading half way through the turn
+    float heading = m_pose.Heading + dheading/2;
+    m_pose.Time = time;
+    m_pose.X += dx*cos(heading) - dy*sin(heading);
+    m_pose.Y += dx*sin(heading) + dy*cos(heading);
+    m_pose.Heading += dheading;
+    if (m_pose.Heading > M_PI)
+        m_pose.Heading -= 2*M_PI;
+    else if (m_pose.Heading < -M_PI)
+        m_pose.Heading += 2*M_PI;
+
+    m_poses.record(m_pose);
+    m_count++;
+}
+
+/*! @brief Integrates the robot's motion since the last record, fusing the turn with the yaw gyro, and adds the new pose to the history. 
+    @param time the time of the sensor update in ms; it must not be older than the previous one
+    @param dx the distance in cm the robot moved forward
+    @param dy the distance in cm the robot moved to the left
+    @param dheading the angle in radians the odometry says the robot turned
+    @param yawrate the yaw gyro in rad/s
+ */
+void OdometryHistory::record(double time, float dx, float dy, float dheading, float yawrate)
+{
+    if (m_count > 0 and time > m_pose.Time)
+        dheading = (1 - ODOMETRY_GYRO_WEIGHT)*dheading + ODOMETRY_GYRO_WEIGHT*yawrate*(time - m_pose.Time)/1000;
+    record(time, dx, dy, dheading);
+}
+
+/*! @brief Gets the odometry pose at the given time, interpolating between the recorded poses either side of it.
+           If the time is newer than the newest pose the newest is used, and if it is older than the oldest the oldest is used.
+    @param time the time in ms
+    @param pose will be updated with the pose at the given time
+    @return false if the history is empty
+ */
+bool OdometryHistory::get(double time, OdometryPose& pose) const
+{
+    return m_poses.get(time, pose, interpolate);
+}
+
+/*! @brief Gets the robot's motion between two times
+    @param from the start time in ms
+    @param to the end time in ms
+    @param dx will be updated with the distance in cm moved forward, relative to the robot at the start time
+    @param dy will be updated with the distance in cm moved left, relative to the robot at the start time
+    @param dheading will be updated with the angle in radians turned
+    @return false if the history is empty
+ */
+bool OdometryHistory::getMotion(double from, double to, float& dx, float& dy, float& dheading) const
+{
+    OdometryPose start, end;
+    if (not get(from, start) or not get(to, end))
+        return false;
+    relative(start, end, dx, dy, dheading);
+    return true;
+}
+
+/*! @brief Anchors a field pose from localisation to the odometry pose at the same time. Only one thread may set the field pose.
+    @param time the time in ms the field pose is for, for example the capture time of the image localisation just used
+    @param x the field x in cm
+    @param y the field y in cm
+    @param heading the field heading in radians
+ */
+void OdometryHistory::setFieldPose(double time, float x, float y, float heading)
+{
+    OdometryPose odometry;
+    if (not get(time, odometry))
+        return;
+
+    m_anchor_sequence++;
+    __sync_synchronize();
+    m_anchor_odometry = odometry;
+    m_anchor_field.Time = time;
+    m_anchor_field.X = x;
+    m_anchor_field.Y = y;
+    m_anchor_field.Heading = heading;
+    __sync_synchronize();
+    m_anchor_sequence++;
+}
+
+/*! @brief Gets the field pose at the time of the newest sensor update; the last field pose from localisation moved by the odometry since.
+    @param pose will be updated with the current field pose
+    @return false if localisation has not set a field pose yet
+ */
+bool OdometryHistory::getFieldPose(OdometryPose& pose) const
+{
+    OdometryPose odometry, field, newest;
+    if (not readAnchor(odometry, field))
+        return false;
+    if (not m_poses.getNewest(newest))
+        newest = odometry;
+
+    float dx, dy, dheading;
+    relative(odometry, newest, dx, dy, dheading);
+    float heading = field.Heading + dheading/2;
+    pose.Time = newest.Time;
+    pose.X = field.X + dx*cos(heading) - dy*sin(heading);
+    pose.Y = field.Y + dx*sin(heading) + dy*cos(heading);
+    pose.Heading = field.Heading + dheading;
+    if (pose.Heading > M_PI)
+        pose.Heading -= 2*M_PI;
+    else if (pose.Heading < -M_PI)
+        pose.Heading += 2*M_PI;
+    return true;
+}
+
+/*! @brief Copies the anchor, retrying while it is being written
+    @return false if there is no anchor
+ */
+bool OdometryHistory::readAnchor(OdometryPose& odometry, OdometryPose& field) const
+{
+    while (true)
+    {
+        unsigned int before = m_anchor_sequence;
+        __sync_synchronize();
+        if (before == 0)
+            return false;
+        if (before % 2 == 1)
+            continue;
+        odometry = m_anchor_odometry;
+        field = m_anchor_field;
+        __sync_synchronize();
+        if (m_anchor_sequence == before)
+            return true;
+    }
+}
+
+/*! @brief Linearly interpolates between two poses, the heading the short way round */
+void OdometryHistory::interpolate(const OdometryPose& older, const OdometryPose& newer, double time, OdometryPose& pose)
+{
+    double dt = newer.Time - older.Time;
+    float fraction = dt > 0 ? (time - older.Time)/dt : 1;
+    float difference = newer.Heading - older.Heading;
+    if (difference > M_PI)
+        difference -= 2*M_PI;
+    else if (difference < -M_PI)
+        difference += 2*M_PI;
+
+    pose.Time = time;
+    pose.X = older.X + fraction*(newer.X - older.X);
+    pose.Y = older.Y + fraction*(newer.Y - older.Y);
+    pose.Heading = older.Heading + fraction*difference;
+}
+
+/*! @brief Calculates the motion from one pose to another, relative to the first pose */
+void OdometryHistory::relative(const OdometryPose& from, const OdometryPose& to, float& dx, float& dy, float& dheading)
+{
+    dheading = to.Heading - from.Heading;
+    if (dheading > M_PI)
+        dheading -= 2*M_PI;
+    else if (dheading < -M_PI)
+        dheading += 2*M_PI;
+
+    // the translation is expressed along the heading half way through the turn, so that record() of the result reproduces it
+    float heading = from.Heading + dheading/2;
+    float x = to.X - from.X;
+    float y = to.Y - from.Y;
+    dx = x*cos(heading) + y*sin(heading);
+    dy = -x*sin(heading) + y*cos(heading);
+}
+
@@ -0,0 +1,87 @@
+/*! @file OdometryHistory.h
+    @brief Declaration of a ring of recent odometry poses
+
+    @class OdometryHistory
+    @brief A lock-free ring of the robot's dead reckoned pose keyed by time, and the latest field pose anchored to it
+
+    The sensor thread integrates the odometry every sensor update, fusing the turn with the yaw gyro on the
+    platforms that have one, and records the resulting pose in the odometry frame. Localisation can then get the robot's motion between any two recent times,
+    for example between the capture times of two images, rather than whatever was accumulated between two
+    runs of the localisation.
+
+    After each localisation update the field pose at the image's capture time is anchored to the odometry
+    pose at the same time. The current field pose is the anchor moved by the odometry since then, so
+    behaviour and motion get a fresh pose at the sensor rate without running the localisation any more often.
+
+    As in the KinematicHistory the poses are in a SeqlockHistory, and the anchor has a sequence number of its
+    own which is odd while it is being written. There is only one thread recording poses, and one thread
+    anchoring; the readers never block either.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ODOMETRYHISTORY_H
+#define ODOMETRYHISTORY_H
+
+#include "SeqlockHistory.h"
+
+#define ODOMETRY_HISTORY_SIZE 128           // 1.28s of poses when the sensors are updated at 100Hz
+#define ODOMETRY_GYRO_WEIGHT 0.5            //!< the weight given to the yaw gyro over the odometry's turn
+
+/*! @brief A pose [x, y, heading] at a single time */
+struct OdometryPose
+{
+    double Time;                            //!< the time in ms
+    float X;                                //!< the x position in cm
+    float Y;                                //!< the y position in cm
+    float Heading;                          //!< the heading in radians
+};
+
+class OdometryHistory
+{
+public:
+    OdometryHistory();
+    ~OdometryHistory();
+
+    void record(double time, float dx, float dy, float dheading);
+    void record(double time, float dx, float dy, float dheading, float yawrate);
+    bool get(double time, OdometryPose& pose) const;
+    bool getMotion(double from, double to, float& dx, float& dy, float& dheading) const;
+
+    void setFieldPose(double time, float x, float y, float heading);
+    bool getFieldPose(OdometryPose& pose) const;
+
+    void clear();
+
+private:
+    bool readAnchor(OdometryPose& odometry, OdometryPose& field) const;
+    static void interpolate(const OdometryPose& older, const OdometryPose& newer, double time, OdometryPose& pose);
+    static void relative(const OdometryPose& from, const OdometryPose& to, float& dx, float& dy, float& dheading);
+
+private:
+    OdometryPose m_pose;                                        //!< the integrated pose, only used by the recording thread
+    SeqlockHistory<OdometryPose, ODOMETRY_HISTORY_SIZE> m_poses;  //!< the ring of poses
+    unsigned int m_count;                                       //!< the number of poses recorded, only used by the recording thread
+
+    OdometryPose m_anchor_odometry;                             //!< the odometry pose at the time of the last field pose
+    OdometryPose m_anchor_field;                                //!< the last field pose from localisation
+    volatile unsigned int m_anchor_sequence;                    //!< the sequence number of the anchor; odd while it is being written, zero if there is no anchor
+};
+
+#endif
+
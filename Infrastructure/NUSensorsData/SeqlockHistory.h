@@ -0,0 +1,140 @@
+/*! @file SeqlockHistory.h
+    @brief Declaration and implementation of a lock-free ring of recent values keyed by time
+
+    @class SeqlockHistory
+    @brief A lock-free ring of the last N values of type T, keyed by their Time member in ms
+
+    The values are recorded by a single thread, and can be read at the same time by any number of other
+    threads. Each slot has a sequence number which is odd while the slot is being written. A reader copies
+    the slot, and only keeps the copy if the sequence number was what it expected and unchanged across
+    the copy. So there is only ever one writer, and the readers never block it.
+
+    It is used by the KinematicHistory and the OdometryHistory. T needs to be copyable with a double Time.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SEQLOCKHISTORY_H
+#define SEQLOCKHISTORY_H
+
+template <class T, unsigned int N>
+class SeqlockHistory
+{
+public:
+    /*! @brief Interpolates between an older and a newer value to the given time */
+    typedef void (*Interpolator)(const T& older, const T& newer, double time, T& value);
+
+    SeqlockHistory() {clear();}
+
+    /*! @brief Empties the history. This must not be called while another thread is using it. */
+    void clear()
+    {
+        for (unsigned int i=0; i<N; i++)
+            m_sequence[i] = 0;
+        m_count = 0;
+    }
+
+    /*! @brief Adds a value to the history, replacing the oldest one. Only one thread may record values.
+        @param value the new value; its time must not be older than the previous value's
+     */
+    void record(const T& value)
+    {
+        unsigned int slot = m_count % N;
+        m_sequence[slot]++;
+        __sync_synchronize();
+        m_values[slot] = value;
+        __sync_synchronize();
+        m_sequence[slot]++;
+        __sync_synchronize();
+        m_count++;
+    }
+
+    /*! @brief Gets the value at the given time, interpolating between the recorded values either side of it.
+               If the time is newer than the newest value the newest is used, and if it is older than the oldest the oldest is used.
+        @param time the time in ms
+        @param value will be updated with the value at the given time
+        @param interpolate the function that interpolates between two values
+        @return false if the history is empty
+     */
+    bool get(double time, T& value, Interpolator interpolate) const
+    {
+        unsigned int count = m_count;
+        __sync_synchronize();
+        if (count == 0)
+            return false;
+
+        // the oldest slot is skipped, it is the next to be overwritten
+        unsigned int oldest = count > N ? count - N + 1 : 0;
+        T older, newer;
+        bool hasnewer = false;
+        for (unsigned int number = count; number > oldest; number--)
+        {
+            if (not read(number - 1, older))
+                continue;
+            if (older.Time <= time)
+            {
+                if (hasnewer)
+                    interpolate(older, newer, time, value);
+                else
+                    value = older;
+                return true;
+            }
+            newer = older;
+            hasnewer = true;
+        }
+        if (hasnewer)
+            value = newer;
+        return hasnewer;
+    }
+
+    /*! @brief Gets the newest value
+        @return false if the history is empty. The newest value is only overwritten after N more records, so it can always be read.
+     */
+    bool getNewest(T& value) const
+    {
+        unsigned int count = m_count;
+        __sync_synchronize();
+        return count > 0 and read(count - 1, value);
+    }
+
+private:
+    /*! @brief Copies a recorded value
+        @param number the number of the value, where the first value ever recorded is zero
+        @param value will be updated with the value
+        @return false if the value has been, or is being, overwritten
+     */
+    bool read(unsigned int number, T& value) const
+    {
+        unsigned int slot = number % N;
+        unsigned int expected = 2*(number/N + 1);
+        unsigned int before = m_sequence[slot];
+        __sync_synchronize();
+        if (before != expected)
+            return false;
+        value = m_values[slot];
+        __sync_synchronize();
+        return m_sequence[slot] == before;
+    }
+
+private:
+    T m_values[N];                              //!< the ring of values
+    volatile unsigned int m_sequence[N];        //!< the sequence number of each slot; odd while it is being written
+    volatile unsigned int m_count;              //!< the number of values recorded, the newest is m_count - 1
+};
+
+#endif
@@ -22,6 +22,9 @@ ENDIF()
 ########## List your source files here! ############################################
 SET (YOUR_SRCS  NUSensorsData.cpp NUSensorsData.h
                 Sensor.cpp Sensor.h
+                KinematicHistory.cpp KinematicHistory.h
+                OdometryHistory.cpp OdometryHistory.h
+                SeqlockHistory.h
 )
 ####################################################################################
 ########## List your subdirectories here! ##########################################
@@ -25,8 +25,10 @@
 #include "Infrastructure/NUActionatorsData/NUActionatorsData.h"
 #include "Infrastructure/FieldObjects/FieldObjects.h"
 #include "NUPlatform/NUPlatform.h"
+#include "Tools/Math/General.h"
 
 #include <memory.h>
+#include <cmath>
 
 #include "debug.h"
 #include "debugverbositynetwork.h"
@@ -40,7 +42,10 @@ TeamInformation::TeamInformation(int playernum, int teamnum) : m_TIMEOUT(2000)
     m_objects = Blackboard->Objects;
     
     initTeamPacket();
-    m_received_packets = vector<boost::circular_buffer<TeamPacket> >(13, boost::circular_buffer<TeamPacket>(3));
+    TeamPacket empty;
+    memset(&empty, 0, sizeof(empty));
+    empty.ReceivedTime = -1e10;
+    m_received_packets = vector<TeamPacket>(TEAM_MAX_PLAYER_NUMBER + 1, empty);
 }
 
 
@@ -48,19 +53,43 @@ TeamInformation::~TeamInformation()
 {
 }
 
+/*! @brief Returns true if the packet was received within the last m_TIMEOUT ms */
+bool TeamInformation::isRecent(const TeamPacket& packet)
+{
+    double timenow = m_data != NULL ? m_data->CurrentTime : Platform->getTime();
+    return timenow - packet.ReceivedTime < m_TIMEOUT;
+}
+
+/*! @brief Returns true if no team mate can get to the ball sooner than me.
+
+    A robot that intends to be the attacker keeps the ball until a team mate is TEAM_ATTACKER_HYSTERESIS
+    faster, so that two robots with similar times do not swap between chasing and positioning every packet.
+ */
 bool TeamInformation::amIClosestToBall()
 {
+    bool iamattacker = isAttacker(m_packet);
     for (size_t i=0; i<m_received_packets.size(); i++)
     {
-        if (not m_received_packets[i].empty())
-        {
-            if ((m_data->CurrentTime - m_received_packets[i].back().ReceivedTime < m_TIMEOUT) and (m_packet.TimeToBall > m_received_packets[i].back().TimeToBall))
-                return false;
-        }
+        const TeamPacket& packet = m_received_packets[i];
+        if (not isRecent(packet))
+            continue;
+        float margin = 0;
+        if (iamattacker)
+            margin += TEAM_ATTACKER_HYSTERESIS;
+        if (isAttacker(packet))
+            margin -= TEAM_ATTACKER_HYSTERESIS;
+        if (m_packet.TimeToBall > packet.TimeToBall + margin)
+            return false;
     }
     return true;
 }
 
+/*! @brief Returns true if the packet says its sender intends to be the attacker */
+bool TeamInformation::isAttacker(const TeamPacket& packet)
+{
+    return (packet.Payloads & TeamPacket::RolePayload) and packet.Role == TeamPacket::AttackerRole;
+}
+
 /*! @brief Returns all of the shared balls in the TeamInformation
  */
 vector<TeamPacket::SharedBall> TeamInformation::getSharedBalls()
@@ -69,23 +98,59 @@ vector<TeamPacket::SharedBall> TeamInformation::getSharedBalls()
     sharedballs.reserve(m_received_packets.size());
     for (size_t i=0; i<m_received_packets.size(); i++)
     {
-        if (not m_received_packets[i].empty() and (m_data->CurrentTime - m_received_packets[i].back().ReceivedTime < m_TIMEOUT))
+        if (isRecent(m_received_packets[i]))
         {   // if there is a received packet that is not too old grab the shared ball
-            sharedballs.push_back(m_received_packets[i].back().Ball);
+            sharedballs.push_back(m_received_packets[i].Ball);
         }
     }
     return sharedballs;
 }
 
+/*! @brief Returns the latest team packet from a team mate, or NULL if there hasn't been one recently
+    @param playernumber the team mate's player number
+ */
+const TeamPacket* TeamInformation::getTeamPacket(int playernumber)
+{
+    if (playernumber <= 0 or (unsigned) playernumber >= m_received_packets.size())
+        return NULL;
+    else if (not isRecent(m_received_packets[playernumber]))
+        return NULL;
+    else
+        return &m_received_packets[playernumber];
+}
+
+/*! @brief Sets the role this robot intends to play. The role is sent to team mates in every packet.
+    @param role the role intent
+ */
+void TeamInformation::setRoleIntent(TeamPacket::RoleIntent role)
+{
+    m_packet.Role = static_cast<unsigned char>(role);
+    m_packet.Payloads |= TeamPacket::RolePayload;
+}
+
+/*! @brief Sets the summary of the localisation that is sent to team mates
+    @param nummodels the number of active models
+    @param bestalpha the weight of the best model
+    @param timesincefieldobjectseen the time since a useful field object was seen in ms
+ */
+void TeamInformation::setLocalisationSummary(int nummodels, float bestalpha, float timesincefieldobjectseen)
+{
+    m_packet.Localisation.NumModels = nummodels;
+    m_packet.Localisation.BestAlpha = bestalpha;
+    m_packet.Localisation.TimeSinceFieldObjectSeen = timesincefieldobjectseen;
+    m_packet.Payloads |= TeamPacket::LocalisationPayload;
+}
+
 /*! @brief Initialises my team packet to send to my team mates
  */
 void TeamInformation::initTeamPacket()
 {   
-    memcpy(m_packet.Header, TEAM_PACKET_STRUCT_HEADER, sizeof(m_packet.Header));
+    memset(&m_packet, 0, sizeof(m_packet));
     m_packet.ID = 0;
     // we initialise everything that never changes here
     m_packet.PlayerNumber = static_cast<char>(m_player_number);
     m_packet.TeamNumber = static_cast<char>(m_team_number);
+    m_packet.Role = TeamPacket::UnknownRole;
 }
 
 /*! @brief Updates my team packet with the latest information
@@ -117,6 +182,32 @@ void TeamInformation::updateTeamPacket()
     m_packet.Self.SDX = self.sdX();
     m_packet.Self.SDY = self.sdY();
     m_packet.Self.SDHeading = self.sdHeading();
+    
+    updateSharedObstacles();
+}
+
+/*! @brief Updates the shared obstacles with the robots seen in this frame
+ */
+void TeamInformation::updateSharedObstacles()
+{
+    Self& self = m_objects->self;
+    m_packet.NumObstacles = 0;
+    for (size_t i=0; i<m_objects->ambiguousFieldObjects.size() and m_packet.NumObstacles < TeamPacket::MaxObstacles; i++)
+    {
+        AmbiguousObject& object = m_objects->ambiguousFieldObjects[i];
+        int id = object.getID();
+        if (object.isObjectVisible() and (id == FieldObjects::FO_ROBOT_UNKNOWN or id == FieldObjects::FO_BLUE_ROBOT_UNKNOWN or id == FieldObjects::FO_PINK_ROBOT_UNKNOWN))
+        {
+            TeamPacket::SharedObstacle& obstacle = m_packet.Obstacles[m_packet.NumObstacles];
+            obstacle.X = self.wmX() + object.measuredDistance()*cos(self.Heading() + object.measuredBearing());
+            obstacle.Y = self.wmY() + object.measuredDistance()*sin(self.Heading() + object.measuredBearing());
+            m_packet.NumObstacles++;
+        }
+    }
+    if (m_packet.NumObstacles > 0)
+        m_packet.Payloads |= TeamPacket::ObstaclesPayload;
+    else
+        m_packet.Payloads &= ~TeamPacket::ObstaclesPayload;
 }
 
 float TeamInformation::getTimeToBall()
@@ -152,35 +243,12 @@ float TeamInformation::getTimeToBall()
     return time;
 }
 
-void TeamPacket::summaryTo(ostream& output)
-{
-    output << "ID: " << ID;
-    output << " Player: " << (int)PlayerNumber;
-    output << " Team: " << (int)TeamNumber;
-    output << " TimeToBall: " << TimeToBall;
-    output << endl;
-}
-
-
-ostream& operator<< (ostream& output, const TeamPacket& packet)
-{
-    output.write((char*) &packet, sizeof(packet));
-    return output;
-}
-
-istream& operator>> (istream& input, TeamPacket& packet)
-{
-    TeamPacket packetBuffer;
-    input.read(reinterpret_cast<char*>(&packetBuffer), sizeof(packetBuffer));
-    packet = packetBuffer;
-    
-    return input;
-}
-
 ostream& operator<< (ostream& output, TeamInformation& info)
 {
     info.updateTeamPacket();
     output << info.m_packet;
+    // the behaviour sets the role every time it runs, so a robot that stops playing stops sending one
+    info.m_packet.Payloads &= ~TeamPacket::RolePayload;
     //System->displayTeamPacketSent(info.m_actions);
     return output;
 }
@@ -192,45 +260,42 @@ ostream& operator<< (ostream& output, TeamInformation* info)
     return output;
 }
 
+/*! @brief Decodes a team packet in the wire format straight into the table of received packets
+ */
 istream& operator>> (istream& input, TeamInformation& info)
 {
-    TeamPacket temp;
-    input >> temp;
-    double timenow;
-    if (info.m_data != NULL)
-        timenow = info.m_data->CurrentTime;
-    else
-        timenow = Platform->getTime();
-    temp.ReceivedTime = timenow;
+    char buffer[TeamPacket::MaxEncodedSize + 1];
+    input.read(buffer, sizeof(buffer));
+    size_t size = input.gcount();
     
-    if (temp.PlayerNumber > 0 and (unsigned) temp.PlayerNumber < info.m_received_packets.size() and temp.PlayerNumber != info.m_player_number and temp.TeamNumber == info.m_team_number)
-    {   // only accept packets from valid player numbers
-        // System->displayTeamPacketReceived(info.m_actions);
-        if (info.m_received_packets[temp.PlayerNumber].empty())
-        {   // if there have been no previous packets from this player always accept the packet
-            info.m_received_packets[temp.PlayerNumber].push_back(temp);
-        }
+    int playernumber, teamnumber;
+    unsigned int id;
+    if (size <= TeamPacket::MaxEncodedSize and TeamPacket::decodeHeader(buffer, size, playernumber, teamnumber, id))
+    {
+        double timenow;
+        if (info.m_data != NULL)
+            timenow = info.m_data->CurrentTime;
         else
-        {
-            TeamPacket lastpacket = info.m_received_packets[temp.PlayerNumber].back();
-            if (timenow - lastpacket.ReceivedTime > 2000)
-            {   // if there have been no packets recently from this player always accept the packet
-                info.m_received_packets[temp.PlayerNumber].push_back(temp);
-            }
-            else if (temp.ID > lastpacket.ID)
-            {   // avoid out of order packets by only adding recent packets that have a higher ID
-                info.m_received_packets[temp.PlayerNumber].push_back(temp);
+            timenow = Platform->getTime();
+        
+        if (playernumber > 0 and (unsigned) playernumber < info.m_received_packets.size() and playernumber != info.m_player_number and teamnumber == info.m_team_number)
+        {   // only accept packets from valid player numbers
+            // System->displayTeamPacketReceived(info.m_actions);
+            TeamPacket& lastpacket = info.m_received_packets[playernumber];
+            // if there have been no packets recently from this player always accept the packet, 
+            // otherwise avoid out of order packets by only adding recent packets that have a higher ID
+            if (timenow - lastpacket.ReceivedTime > 2000 or id > lastpacket.ID)
+            {
+                lastpacket.decode(buffer, size);
+                lastpacket.ReceivedTime = timenow;
             }
+            return input;
         }
     }
-    else
-    {
-        #if DEBUG_NETWORK_VERBOSITY > 0
-            debug << ">>TeamInformation. Rejected team packet:";
-            temp.summaryTo(debug);
-            debug << endl;
-        #endif
-    }
+    
+    #if DEBUG_NETWORK_VERBOSITY > 0
+        debug << ">>TeamInformation. Rejected team packet of " << size << " bytes" << endl;
+    #endif
     return input;
 }
 
@@ -29,48 +29,14 @@ class NUSensorsData;
 class NUActionatorsData;
 class FieldObjects;
 
-#include <boost/circular_buffer.hpp>
+#include "TeamPacket.h"
+
 #include <vector>
 #include <iostream>
 using namespace std;
 
-#define TEAM_PACKET_STRUCT_HEADER "NUtm"
-
-class TeamPacket
-{
-public:
-    struct SharedBall 
-    {
-        float TimeSinceLastSeen;
-        float X;
-        float Y;
-        float SRXX;
-        float SRXY;
-        float SRYY;
-    };
-    struct SharedSelf
-    {
-        float X;
-        float Y;
-        float Heading;
-        float SDX;
-        float SDY;
-        float SDHeading;
-    };
-    char Header[4];
-    unsigned long ID;
-    double SentTime;
-    double ReceivedTime;
-    char PlayerNumber;
-    char TeamNumber;
-    float TimeToBall;
-    SharedBall Ball;
-    SharedSelf Self;
-    
-    void summaryTo(ostream& output);
-    friend ostream& operator<< (ostream& output, const TeamPacket& packet);
-    friend istream& operator>> (istream& input, TeamPacket& packet);
-};
+#define TEAM_MAX_PLAYER_NUMBER 12           //!< the largest player number a team mate can have
+#define TEAM_ATTACKER_HYSTERESIS 0.5        //!< how much faster in s to the ball a team mate needs to be to take over from an attacker
 
 class TeamInformation
 {
@@ -83,6 +49,10 @@ public:
     bool amIClosestToBall();
     
     vector<TeamPacket::SharedBall> getSharedBalls();
+    const TeamPacket* getTeamPacket(int playernumber);
+    
+    void setRoleIntent(TeamPacket::RoleIntent role);
+    void setLocalisationSummary(int nummodels, float bestalpha, float timesincefieldobjectseen);
     
     friend ostream& operator<< (ostream& output, TeamInformation& info);
     friend ostream& operator<< (ostream& output, TeamInformation* info);
@@ -91,7 +61,10 @@ public:
 private:
     void initTeamPacket();
     void updateTeamPacket();
+    void updateSharedObstacles();
     float getTimeToBall();
+    bool isRecent(const TeamPacket& packet);
+    static bool isAttacker(const TeamPacket& packet);
 private:
     const float m_TIMEOUT;
     int m_player_number;
@@ -102,9 +75,8 @@ private:
     FieldObjects* m_objects;
     
     TeamPacket m_packet;                                                //!< team packet to send
-    vector<boost::circular_buffer<TeamPacket> > m_received_packets;     //!< team packets received from other robots
+    vector<TeamPacket> m_received_packets;                              //!< the latest team packet received from each player, indexed by player number
 };
 
 
 #endif
-
@@ -0,0 +1,286 @@
+/*! @file TeamPacket.cpp
+    @brief Implementation of TeamPacket and its wire format
+
+    @author agent
+ 
+  Copyright (c) 2026 agent
+ 
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "TeamPacket.h"
+#include "Tools/Math/General.h"
+
+#include <memory.h>
+#include <cmath>
+
+const unsigned char TeamPacket::Version;
+const size_t TeamPacket::MaxObstacles;
+const size_t TeamPacket::MinEncodedSize;
+const size_t TeamPacket::MaxEncodedSize;
+
+// ------------------------------------------------------------------------------------------------ wire format helpers
+// Every field is written a byte at a time in little-endian order, so the format does not depend on the host.
+
+/*! @brief Quantises value/resolution to an integer clipped to [min, max]. NaN is quantised to nan. */
+static long quantise(float value, float resolution, long min, long max, long nan)
+{
+    if (isnan(value))
+        return nan;
+    float q = value/resolution;
+    if (q <= min)
+        return min;
+    else if (q >= max)
+        return max;
+    else
+        return static_cast<long>(q >= 0 ? q + 0.5f : q - 0.5f);
+}
+
+static void putUInt8(char*& p, unsigned long value)
+{
+    *p++ = static_cast<char>(value & 0xFF);
+}
+
+static void putUInt16(char*& p, unsigned long value)
+{
+    *p++ = static_cast<char>(value & 0xFF);
+    *p++ = static_cast<char>((value >> 8) & 0xFF);
+}
+
+static void putUInt32(char*& p, unsigned long value)
+{
+    putUInt16(p, value & 0xFFFF);
+    putUInt16(p, (value >> 16) & 0xFFFF);
+}
+
+static void putInt16(char*& p, long value)
+{
+    putUInt16(p, static_cast<unsigned long>(value) & 0xFFFF);
+}
+
+static unsigned long getUInt8(const char*& p)
+{
+    return static_cast<unsigned char>(*p++);
+}
+
+static unsigned long getUInt16(const char*& p)
+{
+    unsigned long value = static_cast<unsigned char>(p[0]) | (static_cast<unsigned long>(static_cast<unsigned char>(p[1])) << 8);
+    p += 2;
+    return value;
+}
+
+static unsigned long getUInt32(const char*& p)
+{
+    unsigned long low = getUInt16(p);
+    return low | (getUInt16(p) << 16);
+}
+
+static long getInt16(const char*& p)
+{
+    long value = getUInt16(p);
+    return value >= 0x8000 ? value - 0x10000 : value;
+}
+
+static long getInt8(const char*& p)
+{
+    long value = getUInt8(p);
+    return value >= 0x80 ? value - 0x100 : value;
+}
+
+/*! @brief Encodes the packet into the wire format
+    @param buffer the buffer to write into
+    @param size the size of the buffer; it needs to be at least TeamPacket::MaxEncodedSize
+    @return the number of bytes written, or 0 if the buffer is too small
+ */
+size_t TeamPacket::encode(char* buffer, size_t size) const
+{
+    if (size < MaxEncodedSize)
+        return 0;
+    
+    char* p = buffer;
+    memcpy(p, TEAM_PACKET_STRUCT_HEADER, 4);
+    p += 4;
+    putUInt8(p, Version);
+    putUInt8(p, PlayerNumber);
+    putUInt8(p, TeamNumber);
+    putUInt8(p, Payloads);
+    putUInt32(p, ID);
+    putUInt16(p, quantise(TimeToBall, 0.01, 0, 0xFFFF, 0xFFFF));
+    
+    putUInt16(p, quantise(Ball.TimeSinceLastSeen, 10, 0, 0xFFFF, 0xFFFF));
+    putInt16(p, quantise(Ball.X, 0.1, -0x7FFF, 0x7FFF, 0));
+    putInt16(p, quantise(Ball.Y, 0.1, -0x7FFF, 0x7FFF, 0));
+    putInt16(p, quantise(Ball.SRXX, 0.1, -0x7FFF, 0x7FFF, 0x7FFF));
+    putInt16(p, quantise(Ball.SRXY, 0.1, -0x7FFF, 0x7FFF, 0));
+    putInt16(p, quantise(Ball.SRYY, 0.1, -0x7FFF, 0x7FFF, 0x7FFF));
+    
+    putInt16(p, quantise(Self.X, 0.1, -0x7FFF, 0x7FFF, 0));
+    putInt16(p, quantise(Self.Y, 0.1, -0x7FFF, 0x7FFF, 0));
+    putInt16(p, quantise(mathGeneral::normaliseAngle(Self.Heading), 1e-4, -0x7FFF, 0x7FFF, 0));
+    putUInt16(p, quantise(Self.SDX, 0.1, 0, 0xFFFF, 0xFFFF));
+    putUInt16(p, quantise(Self.SDY, 0.1, 0, 0xFFFF, 0xFFFF));
+    putUInt16(p, quantise(Self.SDHeading, 1e-4, 0, 0xFFFF, 0xFFFF));
+    
+    if (Payloads & ObstaclesPayload)
+    {   // the obstacles are sent relative to our own position, so that they fit into a byte
+        size_t n = NumObstacles < MaxObstacles ? NumObstacles : MaxObstacles;
+        putUInt8(p, n);
+        for (size_t i=0; i<n; i++)
+        {
+            putUInt8(p, static_cast<unsigned long>(quantise(Obstacles[i].X - Self.X, 4, -0x7F, 0x7F, 0)) & 0xFF);
+            putUInt8(p, static_cast<unsigned long>(quantise(Obstacles[i].Y - Self.Y, 4, -0x7F, 0x7F, 0)) & 0xFF);
+        }
+    }
+    if (Payloads & RolePayload)
+        putUInt8(p, Role);
+    if (Payloads & LocalisationPayload)
+    {
+        putUInt8(p, quantise(Localisation.NumModels, 1, 0, 0xFF, 0));
+        putUInt8(p, quantise(Localisation.BestAlpha, 1.0/255, 0, 0xFF, 0));
+        putUInt16(p, quantise(Localisation.TimeSinceFieldObjectSeen, 100, 0, 0xFFFF, 0xFFFF));
+    }
+    return p - buffer;
+}
+
+/*! @brief Returns the size a packet in the wire format should have, given its fixed part. 
+    @param buffer the received bytes
+    @param size the number of received bytes
+    @return the expected size, or 0 if buffer is not a team packet of the current version
+ */
+size_t TeamPacket::encodedSize(const char* buffer, size_t size)
+{
+    if (size < MinEncodedSize or memcmp(buffer, TEAM_PACKET_STRUCT_HEADER, 4) != 0 or static_cast<unsigned char>(buffer[4]) != Version)
+        return 0;
+    
+    unsigned char payloads = static_cast<unsigned char>(buffer[7]);
+    size_t expected = MinEncodedSize;
+    if (payloads & ObstaclesPayload)
+    {
+        if (size < expected + 1)
+            return 0;
+        size_t n = static_cast<unsigned char>(buffer[expected]);
+        if (n > MaxObstacles)
+            return 0;
+        expected += 1 + 2*n;
+    }
+    if (payloads & RolePayload)
+        expected += 1;
+    if (payloads & LocalisationPayload)
+        expected += 4;
+    return expected;
+}
+
+/*! @brief Reads the identity of a packet in the wire format without decoding the rest of it
+    @return true if the buffer contains a complete team packet of the current version
+ */
+bool TeamPacket::decodeHeader(const char* buffer, size_t size, int& playernumber, int& teamnumber, unsigned int& id)
+{
+    if (size == 0 or encodedSize(buffer, size) != size)
+        return false;
+    const char* p = buffer + 5;
+    playernumber = getUInt8(p);
+    teamnumber = getUInt8(p);
+    p++;
+    id = getUInt32(p);
+    return true;
+}
+
+/*! @brief Decodes a packet in the wire format into this packet. Nothing is modified if the packet is invalid.
+    @param buffer the received bytes
+    @param size the number of received bytes
+    @return true if the packet was decoded
+ */
+bool TeamPacket::decode(const char* buffer, size_t size)
+{
+    if (size == 0 or encodedSize(buffer, size) != size)
+        return false;
+    
+    const char* p = buffer + 5;
+    PlayerNumber = static_cast<char>(getUInt8(p));
+    TeamNumber = static_cast<char>(getUInt8(p));
+    Payloads = getUInt8(p);
+    ID = getUInt32(p);
+    TimeToBall = 0.01*getUInt16(p);
+    
+    Ball.TimeSinceLastSeen = 10.0*getUInt16(p);
+    Ball.X = 0.1*getInt16(p);
+    Ball.Y = 0.1*getInt16(p);
+    Ball.SRXX = 0.1*getInt16(p);
+    Ball.SRXY = 0.1*getInt16(p);
+    Ball.SRYY = 0.1*getInt16(p);
+    
+    Self.X = 0.1*getInt16(p);
+    Self.Y = 0.1*getInt16(p);
+    Self.Heading = 1e-4*getInt16(p);
+    Self.SDX = 0.1*getUInt16(p);
+    Self.SDY = 0.1*getUInt16(p);
+    Self.SDHeading = 1e-4*getUInt16(p);
+    
+    NumObstacles = 0;
+    if (Payloads & ObstaclesPayload)
+    {
+        NumObstacles = getUInt8(p);
+        for (size_t i=0; i<NumObstacles; i++)
+        {
+            Obstacles[i].X = Self.X + 4*getInt8(p);
+            Obstacles[i].Y = Self.Y + 4*getInt8(p);
+        }
+    }
+    Role = UnknownRole;
+    if (Payloads & RolePayload)
+        Role = getUInt8(p);
+    if (Payloads & LocalisationPayload)
+    {
+        Localisation.NumModels = getUInt8(p);
+        Localisation.BestAlpha = getUInt8(p)/255.0;
+        Localisation.TimeSinceFieldObjectSeen = 100.0*getUInt16(p);
+    }
+    return true;
+}
+
+void TeamPacket::summaryTo(ostream& output)
+{
+    output << "ID: " << ID;
+    output << " Player: " << (int)PlayerNumber;
+    output << " Team: " << (int)TeamNumber;
+    output << " TimeToBall: " << TimeToBall;
+    output << " Obstacles: " << (int)NumObstacles;
+    output << " Role: " << (int)Role;
+    output << endl;
+}
+
+
+ostream& operator<< (ostream& output, const TeamPacket& packet)
+{
+    char buffer[TeamPacket::MaxEncodedSize];
+    size_t size = packet.encode(buffer, sizeof(buffer));
+    output.write(buffer, size);
+    return output;
+}
+
+/*! @brief Decodes a single team packet in the wire format; the rest of the stream needs to be exactly one packet.
+           The failbit is set if it is not, and the packet is left unchanged.
+ */
+istream& operator>> (istream& input, TeamPacket& packet)
+{
+    char buffer[TeamPacket::MaxEncodedSize + 1];
+    input.read(buffer, sizeof(buffer));
+    size_t size = input.gcount();
+    // reading less than the buffer is expected, so only the end of the stream is kept from the read
+    input.clear(input.rdstate() & ios::eofbit);
+    if (size > TeamPacket::MaxEncodedSize or not packet.decode(buffer, size))
+        input.setstate(ios::failbit);
+    return input;
+}
@@ -0,0 +1,128 @@
+/*! @file TeamPacket.h
+    @brief Declaration of TeamPacket
+ 
+    @class TeamPacket
+    @brief The packet shared with team mates, and its wire format
+
+    @author agent
+ 
+  Copyright (c) 2026 agent
+ 
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TEAMPACKET_H
+#define TEAMPACKET_H
+
+#include <cstddef>
+#include <iostream>
+using namespace std;
+
+#define TEAM_PACKET_STRUCT_HEADER "NUtm"
+
+/*! @brief The team packet shared with team mates.
+
+    The in-memory packet is never sent as is; it is encoded into a versioned, little-endian wire format
+    with quantised fields, so that it is identical on 32 and 64 bit builds and does not contain padding:
+        - Header         4 bytes "NUtm"
+        - Version        uint8
+        - PlayerNumber   uint8
+        - TeamNumber     uint8
+        - Payloads       uint8 flags for the optional payloads that follow the fixed part
+        - ID             uint32
+        - TimeToBall     uint16 (10ms)
+        - Ball           uint16 TimeSinceLastSeen (10ms), int16 X, Y, SRXX, SRXY, SRYY (mm)
+        - Self           int16 X, Y (mm), int16 Heading (0.1mrad), uint16 SDX, SDY (mm), uint16 SDHeading (0.1mrad)
+    followed by the optional payloads in flag order:
+        - Obstacles      uint8 count, then int8 X, Y per obstacle relative to the sender's position (4cm)
+        - Role           uint8 RoleIntent
+        - Localisation   uint8 NumModels, uint8 BestAlpha (1/255), uint16 TimeSinceFieldObjectSeen (100ms)
+    SentTime and ReceivedTime are local times and are never transmitted.
+ */
+class TeamPacket
+{
+public:
+    struct SharedBall 
+    {
+        float TimeSinceLastSeen;
+        float X;
+        float Y;
+        float SRXX;
+        float SRXY;
+        float SRYY;
+    };
+    struct SharedSelf
+    {
+        float X;
+        float Y;
+        float Heading;
+        float SDX;
+        float SDY;
+        float SDHeading;
+    };
+    struct SharedObstacle
+    {
+        float X;                                        //!< the obstacle's field x position in cm
+        float Y;                                        //!< the obstacle's field y position in cm
+    };
+    struct LocalisationSummary
+    {
+        int NumModels;                                  //!< the number of active localisation models
+        float BestAlpha;                                //!< the weight of the best model (0 to 1)
+        float TimeSinceFieldObjectSeen;                 //!< the time since a useful field object was seen in ms
+    };
+    enum RoleIntent
+    {
+        UnknownRole = 0,
+        GoalKeeperRole = 1,
+        AttackerRole = 2,
+        SupporterRole = 3,
+        DefenderRole = 4
+    };
+    enum PayloadFlags
+    {
+        ObstaclesPayload = 0x01,
+        RolePayload = 0x02,
+        LocalisationPayload = 0x04
+    };
+    static const unsigned char Version = 1;             //!< the version of the wire format
+    static const size_t MaxObstacles = 4;               //!< the maximum number of obstacles in a single packet
+    static const size_t MinEncodedSize = 38;            //!< the size of the fixed part of the wire format
+    static const size_t MaxEncodedSize = MinEncodedSize + 1 + 2*MaxObstacles + 1 + 4;     //!< the size with every payload
+    
+    unsigned int ID;
+    double SentTime;
+    double ReceivedTime;
+    char PlayerNumber;
+    char TeamNumber;
+    float TimeToBall;
+    SharedBall Ball;
+    SharedSelf Self;
+    unsigned char Payloads;                             //!< the PayloadFlags of the optional payloads present
+    unsigned char NumObstacles;
+    SharedObstacle Obstacles[MaxObstacles];
+    unsigned char Role;
+    LocalisationSummary Localisation;
+    
+    size_t encode(char* buffer, size_t size) const;
+    bool decode(const char* buffer, size_t size);
+    static bool decodeHeader(const char* buffer, size_t size, int& playernumber, int& teamnumber, unsigned int& id);
+    static size_t encodedSize(const char* buffer, size_t size);
+    
+    void summaryTo(ostream& output);
+    friend ostream& operator<< (ostream& output, const TeamPacket& packet);
+    friend istream& operator>> (istream& input, TeamPacket& packet);
+};
+
+#endif
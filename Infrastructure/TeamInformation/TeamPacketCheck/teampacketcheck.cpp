@@ -0,0 +1,298 @@
+/*! @file teampacketcheck.cpp
+    @brief The teampacketcheck executable. Checks that team packets survive the wire format, and that broken packets are rejected.
+
+    Usage: teampacketcheck [number of packets]
+
+    Random packets (1000 unless given) are made with every combination of the optional payloads and every
+    number of obstacles. Each is encoded and decoded, both directly and through the stream operators, and
+    every field must come back to within half of its quantisation step.
+
+    Each encoded packet is then broken: every truncation of it, the packet with an extra byte, a wrong header,
+    a wrong version and too many obstacles. Every one of them must be rejected by decode(), decodeHeader()
+    and operator>>, and must leave the packet it was decoded into unchanged.
+
+    The number of packets checked and the number of failures are printed for each check, and the exit
+    status is 1 if there were any failures.
+    Use a build with NUBOT_BUILD_TEAM_PACKET_CHECK ON.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Infrastructure/TeamInformation/TeamPacket.h"
+#include "Tools/Math/General.h"
+
+#include "debug.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <sstream>
+#include <string>
+using namespace std;
+
+ofstream debug;
+ofstream errorlog;
+
+#define NUM_PAYLOAD_COMBINATIONS 8              //!< the number of combinations of the three optional payloads
+#define MAX_REPORTED_FAILURES 5                 //!< the number of failures of each check that are printed in full
+
+/*! @brief The result of a single check */
+class CheckResult
+{
+public:
+    CheckResult(const string& name) : m_name(name), m_checked(0), m_failures(0), m_packet(0) {}
+
+    /*! @brief Sets the number of the packet being checked, which is printed if it fails */
+    void setPacket(int packet) {m_packet = packet;}
+    /*! @brief Records a failure if ok is false
+        @param what a description of what was checked
+     */
+    void expect(bool ok, const string& what)
+    {
+        if (ok)
+            return;
+        m_failures++;
+        if (m_failures <= MAX_REPORTED_FAILURES)
+            cout << "    " << m_name << " packet " << m_packet << ": " << what << endl;
+    }
+    /*! @brief Records a failure if value is more than tolerance from reference */
+    void compare(const string& what, float value, float reference, float tolerance)
+    {
+        if (fabs(value - reference) > tolerance)
+        {
+            ostringstream message;
+            message << what << " is " << value << " not " << reference;
+            expect(false, message.str());
+        }
+    }
+    /*! @brief Counts a packet as checked */
+    void count() {m_checked++;}
+    bool failed() const {return m_failures > 0;}
+
+    void print() const
+    {
+        cout << m_name << ": " << m_checked << " packets checked, " << m_failures << " failures" << endl;
+    }
+private:
+    string m_name;                          //!< the name of the check
+    long m_checked;                         //!< the number of packets checked
+    long m_failures;                        //!< the number of failed expectations
+    int m_packet;                           //!< the number of the packet being checked
+};
+
+/*! @brief Returns a random number in [low, high] */
+static float uniform(float low, float high)
+{
+    return low + (high - low)*rand()/RAND_MAX;
+}
+
+/*! @brief Makes a random packet whose fields are all in the range of the wire format
+    @param payloads the PayloadFlags of the optional payloads to include
+    @param numobstacles the number of obstacles, used if the obstacles payload is included
+ */
+static TeamPacket makePacket(int id, unsigned char payloads, int numobstacles)
+{
+    TeamPacket packet;
+    memset(&packet, 0, sizeof(packet));
+    packet.ID = id;
+    packet.PlayerNumber = 1 + rand() % 12;
+    packet.TeamNumber = rand() % 100;
+    packet.TimeToBall = uniform(0, 600);
+    packet.Ball.TimeSinceLastSeen = uniform(0, 600000);
+    packet.Ball.X = uniform(-400, 400);
+    packet.Ball.Y = uniform(-300, 300);
+    packet.Ball.SRXX = uniform(0, 1000);
+    packet.Ball.SRXY = uniform(-1000, 1000);
+    packet.Ball.SRYY = uniform(0, 1000);
+    packet.Self.X = uniform(-400, 400);
+    packet.Self.Y = uniform(-300, 300);
+    packet.Self.Heading = uniform(-3.14, 3.14);
+    packet.Self.SDX = uniform(0, 1000);
+    packet.Self.SDY = uniform(0, 1000);
+    packet.Self.SDHeading = uniform(0, 6);
+    packet.Payloads = payloads;
+    if (payloads & TeamPacket::ObstaclesPayload)
+    {   // the obstacles are sent relative to the robot, to within 127 steps of 4cm
+        packet.NumObstacles = numobstacles;
+        for (int i=0; i<numobstacles; i++)
+        {
+            packet.Obstacles[i].X = packet.Self.X + uniform(-500, 500);
+            packet.Obstacles[i].Y = packet.Self.Y + uniform(-500, 500);
+        }
+    }
+    if (payloads & TeamPacket::RolePayload)
+        packet.Role = rand() % (TeamPacket::DefenderRole + 1);
+    if (payloads & TeamPacket::LocalisationPayload)
+    {
+        packet.Localisation.NumModels = rand() % 256;
+        packet.Localisation.BestAlpha = uniform(0, 1);
+        packet.Localisation.TimeSinceFieldObjectSeen = uniform(0, 600000);
+    }
+    return packet;
+}
+
+/*! @brief Compares a decoded packet with the one that was encoded, to within half of the quantisation of each field */
+static void comparePackets(CheckResult& result, const TeamPacket& decoded, const TeamPacket& packet)
+{
+    const float e = 1e-3;            // the rounding of the floats themselves
+    result.expect(decoded.ID == packet.ID, "the ID differs");
+    result.expect(decoded.PlayerNumber == packet.PlayerNumber, "the player number differs");
+    result.expect(decoded.TeamNumber == packet.TeamNumber, "the team number differs");
+    result.expect(decoded.Payloads == packet.Payloads, "the payloads differ");
+    result.compare("TimeToBall", decoded.TimeToBall, packet.TimeToBall, 0.005 + e);
+    result.compare("Ball.TimeSinceLastSeen", decoded.Ball.TimeSinceLastSeen, packet.Ball.TimeSinceLastSeen, 5 + e);
+    result.compare("Ball.X", decoded.Ball.X, packet.Ball.X, 0.05 + e);
+    result.compare("Ball.Y", decoded.Ball.Y, packet.Ball.Y, 0.05 + e);
+    result.compare("Ball.SRXX", decoded.Ball.SRXX, packet.Ball.SRXX, 0.05 + e);
+    result.compare("Ball.SRXY", decoded.Ball.SRXY, packet.Ball.SRXY, 0.05 + e);
+    result.compare("Ball.SRYY", decoded.Ball.SRYY, packet.Ball.SRYY, 0.05 + e);
+    result.compare("Self.X", decoded.Self.X, packet.Self.X, 0.05 + e);
+    result.compare("Self.Y", decoded.Self.Y, packet.Self.Y, 0.05 + e);
+    result.compare("Self.Heading", decoded.Self.Heading, packet.Self.Heading, 5e-5 + 1e-6);
+    result.compare("Self.SDX", decoded.Self.SDX, packet.Self.SDX, 0.05 + e);
+    result.compare("Self.SDY", decoded.Self.SDY, packet.Self.SDY, 0.05 + e);
+    result.compare("Self.SDHeading", decoded.Self.SDHeading, packet.Self.SDHeading, 5e-5 + 1e-6);
+    result.expect(decoded.NumObstacles == packet.NumObstacles, "the number of obstacles differs");
+    for (int i=0; i<packet.NumObstacles and i<decoded.NumObstacles; i++)
+    {   // the obstacles are relative to the decoded position, so they can be out by a step of Self too
+        result.compare("Obstacle.X", decoded.Obstacles[i].X, packet.Obstacles[i].X, 2 + 0.05 + e);
+        result.compare("Obstacle.Y", decoded.Obstacles[i].Y, packet.Obstacles[i].Y, 2 + 0.05 + e);
+    }
+    if (packet.Payloads & TeamPacket::RolePayload)
+        result.expect(decoded.Role == packet.Role, "the role differs");
+    else
+        result.expect(decoded.Role == TeamPacket::UnknownRole, "the role is not unknown");
+    if (packet.Payloads & TeamPacket::LocalisationPayload)
+    {
+        result.expect(decoded.Localisation.NumModels == packet.Localisation.NumModels, "the number of models differs");
+        result.compare("Localisation.BestAlpha", decoded.Localisation.BestAlpha, packet.Localisation.BestAlpha, 0.5/255 + 1e-6);
+        result.compare("Localisation.TimeSinceFieldObjectSeen", decoded.Localisation.TimeSinceFieldObjectSeen, packet.Localisation.TimeSinceFieldObjectSeen, 50 + e);
+    }
+}
+
+/*! @brief Checks that a broken packet is rejected everywhere and leaves the packet it is decoded into unchanged
+    @param what a description of how the packet is broken
+ */
+static void checkRejected(CheckResult& result, const char* buffer, size_t size, const string& what)
+{
+    TeamPacket sentinel = makePacket(12345, TeamPacket::ObstaclesPayload | TeamPacket::RolePayload, 1);
+    TeamPacket packet = sentinel;
+    result.expect(not packet.decode(buffer, size), "decode() accepted " + what);
+    result.expect(memcmp(&packet, &sentinel, sizeof(packet)) == 0, "decode() modified the packet with " + what);
+
+    int playernumber, teamnumber;
+    unsigned int id;
+    result.expect(not TeamPacket::decodeHeader(buffer, size, playernumber, teamnumber, id), "decodeHeader() accepted " + what);
+
+    istringstream input(string(buffer, size));
+    input >> packet;
+    result.expect(input.fail(), "operator>> accepted " + what);
+    result.expect(memcmp(&packet, &sentinel, sizeof(packet)) == 0, "operator>> modified the packet with " + what);
+}
+
+int main(int argc, const char *argv[])
+{
+    int numpackets = 1000;
+    if (argc > 1)
+        numpackets = max(1, atoi(argv[1]));
+    srand(1);
+
+    CheckResult roundtrip("encode() and decode()");
+    CheckResult streams("operator<< and operator>>");
+    CheckResult truncated("truncated packets");
+    CheckResult broken("oversized and corrupt packets");
+    for (int i=0; i<numpackets; i++)
+    {
+        unsigned char payloads = i % NUM_PAYLOAD_COMBINATIONS;
+        int numobstacles = (i / NUM_PAYLOAD_COMBINATIONS) % (TeamPacket::MaxObstacles + 1);
+        TeamPacket packet = makePacket(i, payloads, numobstacles);
+        roundtrip.setPacket(i);
+        streams.setPacket(i);
+        truncated.setPacket(i);
+        broken.setPacket(i);
+
+        // ---------------------------------------------------------------- round trip
+        char buffer[TeamPacket::MaxEncodedSize + 1];
+        size_t size = packet.encode(buffer, TeamPacket::MaxEncodedSize);
+        roundtrip.expect(size >= TeamPacket::MinEncodedSize and size <= TeamPacket::MaxEncodedSize, "the encoded size is out of range");
+        roundtrip.expect(TeamPacket::encodedSize(buffer, size) == size, "encodedSize() does not match encode()");
+        roundtrip.expect(packet.encode(buffer, TeamPacket::MaxEncodedSize - 1) == 0, "encode() wrote into a buffer that is too small");
+        packet.encode(buffer, TeamPacket::MaxEncodedSize);
+
+        TeamPacket decoded;
+        memset(&decoded, 0, sizeof(decoded));
+        roundtrip.expect(decoded.decode(buffer, size), "decode() rejected the packet");
+        comparePackets(roundtrip, decoded, packet);
+        int playernumber, teamnumber;
+        unsigned int id;
+        roundtrip.expect(TeamPacket::decodeHeader(buffer, size, playernumber, teamnumber, id), "decodeHeader() rejected the packet");
+        roundtrip.expect(playernumber == packet.PlayerNumber and teamnumber == packet.TeamNumber and id == packet.ID, "decodeHeader() does not match the packet");
+        roundtrip.count();
+
+        ostringstream output;
+        output << packet;
+        streams.expect(output.str() == string(buffer, size), "operator<< does not match encode()");
+        istringstream input(output.str());
+        TeamPacket streamed;
+        memset(&streamed, 0, sizeof(streamed));
+        input >> streamed;
+        streams.expect(not input.fail(), "operator>> rejected the packet");
+        comparePackets(streams, streamed, packet);
+        streams.count();
+
+        // ---------------------------------------------------------------- truncated
+        for (size_t n=0; n<size; n++)
+        {
+            ostringstream what;
+            what << "the first " << n << " of " << size << " bytes";
+            checkRejected(truncated, buffer, n, what.str());
+        }
+        truncated.count();
+
+        // ---------------------------------------------------------------- oversized and corrupt
+        char copy[TeamPacket::MaxEncodedSize + 1];
+        memcpy(copy, buffer, size);
+        copy[size] = 0;
+        checkRejected(broken, copy, size + 1, "an extra byte");
+
+        memcpy(copy, buffer, size);
+        copy[0] = 'X';
+        checkRejected(broken, copy, size, "a wrong header");
+
+        memcpy(copy, buffer, size);
+        copy[4] = TeamPacket::Version + 1;
+        checkRejected(broken, copy, size, "a wrong version");
+
+        if (payloads & TeamPacket::ObstaclesPayload)
+        {
+            memcpy(copy, buffer, size);
+            copy[TeamPacket::MinEncodedSize] = TeamPacket::MaxObstacles + 1;
+            checkRejected(broken, copy, size, "too many obstacles");
+        }
+        broken.count();
+    }
+    roundtrip.print();
+    streams.print();
+    truncated.print();
+    broken.print();
+
+    if (roundtrip.failed() or streams.failed() or truncated.failed() or broken.failed())
+        return 1;
+    else
+        return 0;
+}
@@ -21,6 +21,7 @@ ENDIF()
 
 ########## List your source files here! ############################################
 SET (YOUR_SRCS  TeamInformation.cpp TeamInformation.h
+                TeamPacket.cpp TeamPacket.h
 )
 ####################################################################################
 ########## List your subdirectories here! ##########################################
@@ -3,196 +3,153 @@
 
 #include "debug.h"
 #include "nubotdataconfig.h"
-OrientationUKF::OrientationUKF(): UKF(numStates), m_initialised(false)
+
+static const double gravityAccel = 981.0; // cm/s^2
+
+/*! @brief The gyro driven process model.
+
+    x' = Ax + By
+       = [ 1 -dt 0  0  ] [ pitchAngle      ] + [ dt  0  ] [ pitchGyroReading ]
+         [ 0  1  0  0  ] [ pitchGyroOffset ]   [  0  0  ] [ rollGyroReading  ]
+         [ 0  0  1 -dt ] [ rollAngle       ]   [  0  dt ]
+         [ 0  0  0  1  ] [ rollGyroOffset  ]   [  0  0  ]
+ */
+class OrientationProcessModel
+{
+public:
+    OrientationProcessModel(double dt, double pitchGyro, double rollGyro) : m_dt(dt), m_pitch_gyro(pitchGyro), m_roll_gyro(rollGyro) {};
+    void propagate(const double state[OrientationUKF::numStates], double result[OrientationUKF::numStates]) const
+    {
+        result[OrientationUKF::pitchAngle] = state[OrientationUKF::pitchAngle] + m_dt*(m_pitch_gyro - state[OrientationUKF::pitchGyroOffset]);
+        result[OrientationUKF::pitchGyroOffset] = state[OrientationUKF::pitchGyroOffset];
+        result[OrientationUKF::rollAngle] = state[OrientationUKF::rollAngle] + m_dt*(m_roll_gyro - state[OrientationUKF::rollGyroOffset]);
+        result[OrientationUKF::rollGyroOffset] = state[OrientationUKF::rollGyroOffset];
+    }
+private:
+    double m_dt;
+    double m_pitch_gyro;
+    double m_roll_gyro;
+};
+
+/*! @brief The accelerometer measurement model; assumes the only acceleration is gravity */
+class AccelerometerModel
 {
-//    std::fstream file;
-//    file.open((std::string(DATA_DIR) + std::string("OrientationUKF.log")).c_str(),ios_base::trunc | ios_base::out);
-//    file.close();
+public:
+    enum {NumMeasurements = 3};
+    void predict(const double state[OrientationUKF::numStates], double measurement[NumMeasurements]) const
+    {
+        double pitch = mathGeneral::normaliseAngle(state[OrientationUKF::pitchAngle]);
+        double roll = mathGeneral::normaliseAngle(state[OrientationUKF::rollAngle]);
+        measurement[0] = gravityAccel * sin(pitch);
+        measurement[1] = -gravityAccel * sin(roll);
+        measurement[2] = -gravityAccel * cos(pitch) * cos(roll);
+    }
+};
+
+/*! @brief The accelerometer measurement model with the roll and pitch given by the support leg kinematics */
+class AccelerometerKinematicsModel
+{
+public:
+    enum {NumMeasurements = 5};
+    void predict(const double state[OrientationUKF::numStates], double measurement[NumMeasurements]) const
+    {
+        m_accelerometer.predict(state, measurement);
+        measurement[3] = mathGeneral::normaliseAngle(state[OrientationUKF::rollAngle]);
+        measurement[4] = mathGeneral::normaliseAngle(state[OrientationUKF::pitchAngle]);
+    }
+private:
+    AccelerometerModel m_accelerometer;
+};
+
+OrientationUKF::OrientationUKF(): m_timeOfLastUpdate(0), m_initialised(false)
+{
+    for (int i = 0; i < numStates; i++)
+        for (int j = 0; j < numStates; j++)
+            m_sqrtProcessNoise[i][j] = 0;
+    m_sqrtProcessNoise[pitchAngle][pitchAngle] = sqrt(1e-3);
+    m_sqrtProcessNoise[pitchGyroOffset][pitchGyroOffset] = sqrt(1e-5);
+    m_sqrtProcessNoise[rollAngle][rollAngle] = sqrt(1e-3);
+    m_sqrtProcessNoise[rollGyroOffset][rollGyroOffset] = sqrt(1e-5);
 }
 
 void OrientationUKF::initialise(double time, const std::vector<float>& gyroReadings, const std::vector<float>& accelerations)
 {
     m_timeOfLastUpdate = time;
 
+    double mean[numStates];
+    double sqrtCovariance[numStates][numStates];
+    for (int i = 0; i < numStates; i++)
+        for (int j = 0; j < numStates; j++)
+            sqrtCovariance[i][j] = 0;
+
     // Assume there is little or no motion to start for best intial estimate.
-    m_mean[pitchGyroOffset][0] = gyroReadings[1];
-    m_mean[rollGyroOffset][0] = gyroReadings[0];
+    mean[pitchGyroOffset] = gyroReadings[1];
+    mean[rollGyroOffset] = gyroReadings[0];
 
-    m_covariance[pitchGyroOffset][pitchGyroOffset] = 0.1f * 0.1f;
-    m_covariance[rollGyroOffset][rollGyroOffset] = 0.1f * 0.1f;
+    sqrtCovariance[pitchGyroOffset][pitchGyroOffset] = 0.1;
+    sqrtCovariance[rollGyroOffset][rollGyroOffset] = 0.1;
 
     // Assume there is little to no acceleration apart from gravity for initial estimation.
-    m_mean[pitchAngle][0] = -atan2(-accelerations[0],-accelerations[2]);
-    m_mean[rollAngle][0] = atan2(accelerations[1],-accelerations[2]);
+    mean[pitchAngle] = -atan2(-accelerations[0],-accelerations[2]);
+    mean[rollAngle] = atan2(accelerations[1],-accelerations[2]);
 
-    m_covariance[pitchAngle][pitchAngle] = 0.5f*0.5f;
-    m_covariance[rollAngle][rollAngle] = 0.5f * 0.5f;
+    sqrtCovariance[pitchAngle][pitchAngle] = 0.5;
+    sqrtCovariance[rollAngle][rollAngle] = 0.5;
 
-    m_processNoise = Matrix(numStates,numStates,false);
-    m_processNoise[pitchAngle][pitchAngle] = 1e-3;
-    m_processNoise[pitchGyroOffset][pitchGyroOffset] = 1e-5;
-    m_processNoise[rollAngle][rollAngle] = 1e-3;
-    m_processNoise[rollGyroOffset][rollGyroOffset] = 1e-5;
+    for (int i = 0; i < numStates; i++)
+        m_filter.setMean(i, mean[i]);
+    m_filter.setSqrtCovariance(sqrtCovariance);
 
     m_initialised = true;
 }
 
 void OrientationUKF::TimeUpdate(const std::vector<float>& gyroReadings, double timestamp)
 {
-//    std::fstream file;
-//    file.open((std::string(DATA_DIR) + std::string("OrientationUKF.log")).c_str(),ios_base::app | ios_base::out);
-//    file << "-- Time Update (" << timestamp << ") [" << rollGyroReading << "," << pitchGyroReading << "] --" << std::endl;
-//    file << "Previous Mean:" << std::endl;
-//    file << m_mean;
-    //double startTime = System->getThreadTime();
     // Find delta 't', the time that has passed since the previous time update.
-    const float dt = (timestamp - m_timeOfLastUpdate) / 1000.0f;
+    const double dt = (timestamp - m_timeOfLastUpdate) / 1000.0;
 
     // Store the current time for reference during next update.
     m_timeOfLastUpdate = timestamp;
 
-    // Time Update Function is equation of the form (emitting accelerations):
-    // x' = Ax + By
-    //    = [ 1 -dt 0  0  ] [ pitchAngle      ] + [ dt  0  ] [ pitchGyroReading ]
-    //      [ 0  1  0  0  ] [ pitchGyroOffset ]   [  0  0  ] [ rollGyroReading  ]
-    //      [ 0  0  1 -dt ] [ rollAngle       ]   [  0  dt ]
-    //      [ 0  0  0  1  ] [ rollGyroOffset  ]   [  0  0  ]
-
-    // A Matrix
-    Matrix A(numStates,numStates,true);
-    A[0][1] = -dt;
-    A[2][3] = -dt;
-
-    // B Matrix
-    Matrix B(numStates,2,false);
-    B[0][0] = dt;
-    B[2][1] = dt;
-
-    // Sensor value matrix
-    Matrix sensorData(2,1,false);
-    sensorData[0][0] = gyroReadings[1];
-    sensorData[1][0] = gyroReadings[0];
-
-    // Generate the sigma points and update using transfer function
-    Matrix sigmaPoints = GenerateSigmaPoints();
-    m_updateSigmaPoints = Matrix(sigmaPoints.getm(), sigmaPoints.getn(), false);
-    Matrix tempResult;
-    for(int i = 0; i < sigmaPoints.getn(); i++)
-    {
-        tempResult = A*sigmaPoints.getCol(i) + B*sensorData;
-        m_updateSigmaPoints.setCol(i,tempResult);
-    }
+    OrientationProcessModel model(dt, gyroReadings[1], gyroReadings[0]);
+    if (not m_filter.timeUpdate(model, m_sqrtProcessNoise))
+        errorlog << "OrientationUKF::TimeUpdate(). The covariance could not be factored; the update was ignored." << std::endl;
 
-    // Find the new mean
-    m_mean = CalculateMeanFromSigmas(m_updateSigmaPoints);
     // Normalise the angles so they lie between +pi and -pi.
-    m_mean[pitchAngle][0] = mathGeneral::normaliseAngle(m_mean[pitchAngle][0]);
-    m_mean[rollAngle][0] = mathGeneral::normaliseAngle(m_mean[rollAngle][0]);
-
-    // Find the new covariance
-    m_covariance = CalculateCovarianceFromSigmas(m_updateSigmaPoints, m_mean) + m_processNoise;
-    //double runTime = System->getThreadTime() - startTime;
-    //debug << "TimeUpdate took: " << runTime << " ms" << std::endl;
-
-//    file << "New Mean:" << std::endl;
-//    file << m_mean << std::endl;
-//    file.close();
+    m_filter.setMean(pitchAngle, mathGeneral::normaliseAngle(m_filter.getMean(pitchAngle)));
+    m_filter.setMean(rollAngle, mathGeneral::normaliseAngle(m_filter.getMean(rollAngle)));
 }
 
 void OrientationUKF::MeasurementUpdate(const std::vector<float>& accelerations, bool validKinematics, const std::vector<float>& kinematicsOrientation)
 {
-//    std::fstream file;
-//    file.open((std::string(DATA_DIR) + std::string("OrientationUKF.log")).c_str(),ios_base::app | ios_base::out);
-//    file << "-- Measurement Update [" << accelerations[0] << "," << accelerations[1] << ","<< accelerations[2] <<  "] ";
-//    if(validKinematics)
-//    {
-//        file << "[" << kinematicsOrientation[0] << "," << kinematicsOrientation[1] << "," << kinematicsOrientation[2] << "] ";
-//    }
-//    file << "--" << std::endl;
-//    file << "Previous Mean:" << std::endl;
-//    file << m_mean << std::endl;
-
-    //double startTime = System->getThreadTime();
-    const float gravityAccel = 981.0f; // cm/s^2
-    int numMeasurements = 3;
-    if(validKinematics) numMeasurements+=2;
-
-    // Generate sigma points from current state estimation.
-    Matrix sigmaPoints = GenerateSigmaPoints();
-    int numberOfSigmaPoints = sigmaPoints.getn();
-
-    // List of predicted observation for each sigma point.
-    Matrix predictedObservationSigmas(numMeasurements, numberOfSigmaPoints, false);
-
-    // Put observation into matrix form so we can use if for doing math
-    Matrix observation(numMeasurements,1,false);
-    observation[0][0] = accelerations[0];
-    observation[1][0] = accelerations[1];
-    observation[2][0] = accelerations[2];
-    if(validKinematics)
-    {
-        observation[3][0] = kinematicsOrientation[0];
-        observation[4][0] = kinematicsOrientation[1];
-    }
-
-    // Observation noise
-    Matrix S_Obs(numMeasurements,numMeasurements,true);
-    //double accelNoise = 200.0*200.0;
+    // Observation noise; the accelerometers are trusted less the further the measured acceleration is from gravity
     double accelVectorMag = sqrt(accelerations[0]*accelerations[0] + accelerations[1]*accelerations[1] + accelerations[2]*accelerations[2]);
     double errorFromIdealGravity = accelVectorMag - fabs(gravityAccel);
     double accelNoise = 25.0 + fabs(errorFromIdealGravity);
-//    file << "Using accel noise: " << accelNoise << std::endl;
-    accelNoise = accelNoise*accelNoise;
+    const double kinematicsNoise = 0.01;
 
-    S_Obs[0][0] = accelNoise;
-    S_Obs[1][1] = accelNoise;
-    S_Obs[2][2] = accelNoise;
-    if(validKinematics)
+    bool success;
+    if (validKinematics)
     {
-        double kinematicsNoise = 0.01*0.01;
-        S_Obs[3][3] = kinematicsNoise;
-        S_Obs[4][4] = kinematicsNoise;
+        const double observation[AccelerometerKinematicsModel::NumMeasurements] = {accelerations[0], accelerations[1], accelerations[2], kinematicsOrientation[0], kinematicsOrientation[1]};
+        const double sqrtNoise[AccelerometerKinematicsModel::NumMeasurements][AccelerometerKinematicsModel::NumMeasurements] = {{accelNoise, 0, 0, 0, 0},
+                                                                                                                                {0, accelNoise, 0, 0, 0},
+                                                                                                                                {0, 0, accelNoise, 0, 0},
+                                                                                                                                {0, 0, 0, kinematicsNoise, 0},
+                                                                                                                                {0, 0, 0, 0, kinematicsNoise}};
+        success = m_filter.measurementUpdate(AccelerometerKinematicsModel(), observation, sqrtNoise);
     }
-
-    // Temp working variables
-    Matrix temp(numMeasurements,1,false);
-    double pitch, roll;
-
-    // Convert estimated state sigma points to estimates observation sigma points.
-    for(int i = 0; i < numberOfSigmaPoints; i++)
+    else
     {
-        pitch = mathGeneral::normaliseAngle(sigmaPoints[pitchAngle][i]);
-        roll = mathGeneral::normaliseAngle(sigmaPoints[rollAngle][i]);
-
-        // Calculate predicted x acceleration due to gravity + external acceleration.
-        temp[0][0] = gravityAccel * sin(pitch);
-
-        // Calculate predicted y acceleration due to gravity + external acceleration.
-        temp[1][0] = -gravityAccel * sin(roll);
-
-        // Calculate predicted z acceleration due to gravity + external acceleration.
-        temp[2][0] = -gravityAccel * cos(pitch) * cos(roll);
-
-        if(validKinematics)
-        {
-            // Calculate predicted measurement.
-            temp[3][0] = roll;
-            temp[4][0] = pitch;
-        }
-
-        // Add to measurement sigma point list.
-        predictedObservationSigmas.setCol(i,temp);
+        const double observation[AccelerometerModel::NumMeasurements] = {accelerations[0], accelerations[1], accelerations[2]};
+        const double sqrtNoise[AccelerometerModel::NumMeasurements][AccelerometerModel::NumMeasurements] = {{accelNoise, 0, 0},
+                                                                                                            {0, accelNoise, 0},
+                                                                                                            {0, 0, accelNoise}};
+        success = m_filter.measurementUpdate(AccelerometerModel(), observation, sqrtNoise);
     }
+    if (not success)
+        errorlog << "OrientationUKF::MeasurementUpdate(). The update would make the covariance indefinite; it was ignored." << std::endl;
 
-    measurementUpdate(observation, S_Obs, predictedObservationSigmas, sigmaPoints);
-    m_mean[pitchAngle][0] = mathGeneral::normaliseAngle(m_mean[pitchAngle][0]);
-    m_mean[rollAngle][0] = mathGeneral::normaliseAngle(m_mean[rollAngle][0]);
-    //double runTime = System->getThreadTime() - startTime;
-    //debug << "Acceleration Measurement Update took: " << runTime << " ms" << std::endl;
-//    file << "Predicted Observation Mean:" << std::endl;
-//    file << predictedObservationSigmas.getCol(0);
-//    file << "Observation:" << std::endl << observation;
-//    file << "New Mean:" << std::endl;
-//    file << m_mean << std::endl;
-//    file.close();
+    m_filter.setMean(pitchAngle, mathGeneral::normaliseAngle(m_filter.getMean(pitchAngle)));
+    m_filter.setMean(rollAngle, mathGeneral::normaliseAngle(m_filter.getMean(rollAngle)));
 }
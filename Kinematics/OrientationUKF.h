@@ -1,9 +1,16 @@
 #ifndef ORIENTATIONUKF_H
 #define ORIENTATIONUKF_H
 
-#include "Tools/Math/UKF.h"
+#include "Tools/Math/UnscentedFilter.h"
+#include <vector>
 
-class OrientationUKF : public UKF
+/*! @brief Estimates the pitch and roll of the torso, and the offsets of the pitch and roll gyros.
+
+    The gyros drive the time update, the accelerometers (and the support leg kinematics when they
+    are available) the measurement update. The filtering itself is done by an UnscentedFilter, so
+    the updates do not allocate.
+ */
+class OrientationUKF
 {
 public:
     OrientationUKF();
@@ -19,11 +26,13 @@ public:
     void TimeUpdate(const std::vector<float>& gyroReadings, double timestamp);
     void MeasurementUpdate(const std::vector<float>& accelerations, bool validKinematics, const std::vector<float>& kinematicsOrientation);
     bool Initialised(){return m_initialised;};
+    double getMean(int stateId) const {return m_filter.getMean(stateId);};
+    double calculateSd(int stateId) const {return m_filter.calculateSd(stateId);};
 
 private:
+    UnscentedFilter<numStates> m_filter;
     double m_timeOfLastUpdate;
-    Matrix m_updateSigmaPoints;
-    Matrix m_processNoise;
+    double m_sqrtProcessNoise[numStates][numStates];
     bool m_initialised;
 };
 
@@ -0,0 +1,281 @@
+/*! @file BallTracker.cpp
+    @brief Implementation of BallTracker class
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "BallTracker.h"
+
+#include <math.h>
+
+// Tuning Values (Constants). These are the per frame values the ball states in KF had, converted to per second at 30fps
+const double BallTracker::c_velocityDecay = 0.635;          // 0.985 each frame => speed halves every 1.5 seconds
+const double BallTracker::c_positionNoise = 21.9;           // 4cm each frame
+const double BallTracker::c_velocityNoise = 31.0;           // 5.66cm/s each frame
+const double BallTracker::c_odometryNoise = 0.1;
+
+// Ball distance measurement error weightings (Constant)
+const double BallTracker::c_R_ball_theta = 0.0001;          // (0.01 rad)^2
+const double BallTracker::c_R_ball_range_offset = 25.0;     // (5cm)^2
+const double BallTracker::c_R_ball_range_relative = 0.0025; // 5% of range added
+const double BallTracker::c_threshold2 = 15.0;
+const int BallTracker::c_MAX_OUTLIERS = 3;
+
+BallTracker::BallTracker()
+{
+    reset();
+}
+
+/*! @brief Resets the ball to be at the robot with a large uncertainty */
+void BallTracker::reset()
+{
+    m_estimates = Matrix(numStates, 1, false);
+    m_sr = Matrix(numStates, numStates, false);
+    m_sr[relX][relX] = 150.0;                   // 150 cm
+    m_sr[relY][relY] = 100.0;                   // 100 cm
+    m_sr[relXVelocity][relXVelocity] = 10.0;    // 10 cm/s
+    m_sr[relYVelocity][relYVelocity] = 10.0;    // 10 cm/s
+    m_num_outliers = 0;
+}
+
+/*! @brief Adds uncertainty to the ball, for example when it has gone out and been replaced
+    @param position the standard deviation in cm to add to the position
+    @param velocity the standard deviation in cm/s to add to the velocity
+ */
+void BallTracker::increaseUncertainty(double position, double velocity)
+{
+    Matrix extra(numStates, numStates, false);
+    extra[relX][relX] = position;
+    extra[relY][relY] = position;
+    extra[relXVelocity][relXVelocity] = velocity;
+    extra[relYVelocity][relYVelocity] = velocity;
+    m_sr = HT(horzcat(m_sr, extra));
+}
+
+/*! @brief Moves the ball by its velocity, and then removes the robot's motion
+    @param deltaTime the time in seconds since the last time update
+    @param odomX the robot's displacement along its x axis (the same as that given to the localisation models)
+    @param odomY the robot's displacement along its y axis
+    @param odomTheta the robot's change in heading
+ */
+void BallTracker::timeUpdate(double deltaTime, double odomX, double odomY, double odomTheta)
+{
+    // The ball's own motion in the previous robot frame
+    Matrix F(numStates, numStates, true);
+    double decay = pow(c_velocityDecay, deltaTime);
+    F[relX][relXVelocity] = deltaTime;
+    F[relY][relYVelocity] = deltaTime;
+    F[relXVelocity][relXVelocity] = decay;
+    F[relYVelocity][relYVelocity] = decay;
+
+    // The robot's motion. As in the OdometryMotionModel the translation is along the heading half way through the turn
+    double c = cos(odomTheta);
+    double s = sin(odomTheta);
+    Matrix R(numStates, numStates, false);
+    R[relX][relX] = c;  R[relX][relY] = s;
+    R[relY][relX] = -s; R[relY][relY] = c;
+    R[relXVelocity][relXVelocity] = c;  R[relXVelocity][relYVelocity] = s;
+    R[relYVelocity][relXVelocity] = -s; R[relYVelocity][relYVelocity] = c;
+
+    Matrix displacement(numStates, 1, false);
+    displacement[relX][0] = odomX*cos(odomTheta/2) - odomY*sin(odomTheta/2);
+    displacement[relY][0] = odomX*sin(odomTheta/2) + odomY*cos(odomTheta/2);
+
+    Matrix A = R*F;
+    m_estimates = A*m_estimates - R*displacement;
+
+    double range = getDistance();
+    double translation = sqrt(odomX*odomX + odomY*odomY);
+    Matrix Q(numStates, numStates, false);
+    Q[relX][relX] = c_positionNoise*sqrt(deltaTime) + c_odometryNoise*(translation + fabs(odomTheta)*range);
+    Q[relY][relY] = Q[relX][relX];
+    Q[relXVelocity][relXVelocity] = c_velocityNoise*sqrt(deltaTime);
+    Q[relYVelocity][relYVelocity] = Q[relXVelocity][relXVelocity];
+    m_sr = HT(horzcat(A*m_sr, Q));
+}
+
+/*! @brief Updates the ball with a measurement from vision
+ 
+    If the ball has been rejected as an outlier c_MAX_OUTLIERS times in a row it has most likely
+    been kicked or moved, so it is moved to the measurement and its velocity is made uncertain.
+ 
+    @param distance the flat distance to the ball in cm
+    @param bearing the bearing to the ball in radians
+ */
+KfUpdateResult BallTracker::measurementUpdate(double distance, double bearing)
+{
+    double R_range = c_R_ball_range_offset + c_R_ball_range_relative*distance*distance;
+    Matrix S(2, 2, false);
+    S[0][0] = cos(bearing)*sqrt(R_range);
+    S[0][1] = -sin(bearing)*distance*sqrt(c_R_ball_theta);
+    S[1][0] = sin(bearing)*sqrt(R_range);
+    S[1][1] = cos(bearing)*distance*sqrt(c_R_ball_theta);
+
+    Matrix y(2, 1, false);
+    y[0][0] = distance*cos(bearing);
+    y[1][0] = distance*sin(bearing);
+
+    KfUpdateResult result = linearUpdate(y, S);
+    if (result == KF_OK)
+        m_num_outliers = 0;
+    else if (++m_num_outliers >= c_MAX_OUTLIERS)
+    {
+        reset();
+        m_estimates[relX][0] = y[0][0];
+        m_estimates[relY][0] = y[1][0];
+        m_sr[relX][relX] = S[0][0]; m_sr[relX][relY] = S[0][1];
+        m_sr[relY][relX] = S[1][0]; m_sr[relY][relY] = S[1][1];
+        result = KF_OK;
+    }
+    return result;
+}
+
+/*! @brief Updates the ball with a measurement in field coordinates, for example a shared ball from a team mate
+    @param x the field x coordinate of the ball in cm
+    @param y the field y coordinate of the ball in cm
+    @param sr the 2x2 square root of the covariance of the measurement
+    @param self the model used to bring the measurement into the robot's frame. Its uncertainty is added to the measurement's.
+ */
+KfUpdateResult BallTracker::fieldMeasurementUpdate(double x, double y, const Matrix& sr, const KF& self)
+{
+    double c = cos(self.getState(KF::selfTheta));
+    double s = sin(self.getState(KF::selfTheta));
+    double dx = x - self.getState(KF::selfX);
+    double dy = y - self.getState(KF::selfY);
+
+    Matrix relative(2, 1, false);
+    relative[0][0] = dx*c + dy*s;
+    relative[1][0] = -dx*s + dy*c;
+
+    Matrix R(2, 2, false);
+    R[0][0] = c;  R[0][1] = s;
+    R[1][0] = -s; R[1][1] = c;
+
+    Matrix J(2, KF::numStates, false);          // the jacobian of the relative position with respect to the robot's pose
+    J[0][KF::selfX] = -c; J[0][KF::selfY] = -s; J[0][KF::selfTheta] = relative[1][0];
+    J[1][KF::selfX] = s;  J[1][KF::selfY] = -c; J[1][KF::selfTheta] = -relative[0][0];
+
+    return linearUpdate(relative, HT(horzcat(R*sr, J*self.stateStandardDeviations)));
+}
+
+/*! @brief Updates the ball with a measurement of its relative position
+    @param y the 2x1 measured relative position
+    @param sr the 2x2 square root of the covariance of the measurement
+ */
+KfUpdateResult BallTracker::linearUpdate(const Matrix& y, const Matrix& sr)
+{
+    Matrix CS = vertcat(m_sr.getRow(relX), m_sr.getRow(relY));
+    Matrix Py = CS*CS.transp() + sr*sr.transp();
+    Matrix Pyinv = Invert22(Py);
+
+    Matrix innovation(2, 1, false);
+    innovation[0][0] = y[0][0] - m_estimates[relX][0];
+    innovation[1][0] = y[1][0] - m_estimates[relY][0];
+    if (convDble(innovation.transp()*Pyinv*innovation) > c_threshold2)
+        return KF_OUTLIER;
+
+    Matrix K = m_sr*CS.transp()*Pyinv;
+    m_sr = HT(horzcat(m_sr - K*CS, K*sr));
+    m_estimates = m_estimates + K*innovation;
+    return KF_OK;
+}
+
+double BallTracker::getState(int stateID) const
+{
+    return m_estimates[stateID][0];
+}
+
+double BallTracker::sd(int stateID) const
+{
+    return sqrt(convDble(m_sr.getRow(stateID)*m_sr.getRow(stateID).transp()));
+}
+
+/*! @brief Returns the flat distance to the ball in cm */
+double BallTracker::getDistance() const
+{
+    return sqrt(pow(m_estimates[relX][0], 2) + pow(m_estimates[relY][0], 2));
+}
+
+/*! @brief Returns the bearing to the ball in radians */
+double BallTracker::getBearing() const
+{
+    return atan2(m_estimates[relY][0], m_estimates[relX][0]);
+}
+
+/*! @brief Returns the ball's field state [x, y, vx, vy] if the robot were at the given model */
+Matrix BallTracker::getFieldEstimates(const KF& self) const
+{
+    Matrix field = getFieldJacobian(self)*m_estimates;
+    field[relX][0] += self.getState(KF::selfX);
+    field[relY][0] += self.getState(KF::selfY);
+    return field;
+}
+
+/*! @brief Returns the square root of the covariance of getFieldEstimates(self). It includes the uncertainty of the model. */
+Matrix BallTracker::getFieldSR(const KF& self) const
+{
+    return HT(horzcat(getFieldJacobian(self)*m_sr, getPoseJacobian(self)*self.stateStandardDeviations));
+}
+
+/*! @brief Returns the rotation from the relative ball state to the field ball state */
+Matrix BallTracker::getFieldJacobian(const KF& self) const
+{
+    double c = cos(self.getState(KF::selfTheta));
+    double s = sin(self.getState(KF::selfTheta));
+    Matrix J(numStates, numStates, false);
+    J[relX][relX] = c; J[relX][relY] = -s;
+    J[relY][relX] = s; J[relY][relY] = c;
+    J[relXVelocity][relXVelocity] = c; J[relXVelocity][relYVelocity] = -s;
+    J[relYVelocity][relXVelocity] = s; J[relYVelocity][relYVelocity] = c;
+    return J;
+}
+
+/*! @brief Returns the jacobian of the field ball state with respect to the robot's pose */
+Matrix BallTracker::getPoseJacobian(const KF& self) const
+{
+    double c = cos(self.getState(KF::selfTheta));
+    double s = sin(self.getState(KF::selfTheta));
+    double x = m_estimates[relX][0];
+    double y = m_estimates[relY][0];
+    double vx = m_estimates[relXVelocity][0];
+    double vy = m_estimates[relYVelocity][0];
+
+    Matrix J(numStates, KF::numStates, false);
+    J[relX][KF::selfX] = 1;
+    J[relY][KF::selfY] = 1;
+    J[relX][KF::selfTheta] = -s*x - c*y;
+    J[relY][KF::selfTheta] = c*x - s*y;
+    J[relXVelocity][KF::selfTheta] = -s*vx - c*vy;
+    J[relYVelocity][KF::selfTheta] = c*vx - s*vy;
+    return J;
+}
+
+std::ostream& operator<< (std::ostream& output, const BallTracker& p_ball)
+{
+    WriteMatrix(output, p_ball.m_estimates);
+    WriteMatrix(output, p_ball.m_sr);
+    return output;
+}
+
+std::istream& operator>> (std::istream& input, BallTracker& p_ball)
+{
+    p_ball.m_estimates = ReadMatrix(input);
+    p_ball.m_sr = ReadMatrix(input);
+    return input;
+}
+
@@ -0,0 +1,101 @@
+/*! @file BallTracker.h
+    @brief Declaration of BallTracker class
+
+    @class BallTracker
+    @brief A single kalman filter tracking the ball's position and velocity relative to the robot
+
+    Previously every localisation model carried its own copy of the ball, so each ball measurement,
+    shared ball, split, merge and time update was done on every model with the full 7 state filter.
+    The ball is now tracked once, with a 4 state filter in robot relative coordinates. The robot
+    relative ball does not depend on where the robot thinks it is; the ball measurements are
+    directly in this frame, and the robot's own motion is removed using the odometry.
+
+    The field coordinates of the ball are obtained by conditioning the relative estimate on a
+    self localisation model (usually the best one), and the uncertainty of that model is included
+    in the field covariance. The shared balls from team mates (which are in field coordinates) are
+    brought into the relative frame in the same way.
+
+    The states are [x, y, vx, vy] in cm and cm/s; x is forward and y is to the left.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BALLTRACKER_H
+#define BALLTRACKER_H
+
+#include "KF.h"
+#include "Tools/Math/Matrix.h"
+
+#include <iostream>
+
+class BallTracker
+{
+public:
+    enum State
+    {
+        relX,
+        relY,
+        relXVelocity,
+        relYVelocity,
+        numStates
+    };
+
+    BallTracker();
+
+    void reset();
+    void increaseUncertainty(double position, double velocity);
+
+    // Update functions
+    void timeUpdate(double deltaTime, double odomX, double odomY, double odomTheta);
+    KfUpdateResult measurementUpdate(double distance, double bearing);
+    KfUpdateResult fieldMeasurementUpdate(double x, double y, const Matrix& sr, const KF& self);
+
+    // Data retrieval
+    double getState(int stateID) const;
+    double sd(int stateID) const;
+    double getDistance() const;
+    double getBearing() const;
+    Matrix getFieldEstimates(const KF& self) const;
+    Matrix getFieldSR(const KF& self) const;
+
+    friend std::ostream& operator<< (std::ostream& output, const BallTracker& p_ball);
+    friend std::istream& operator>> (std::istream& input, BallTracker& p_ball);
+private:
+    KfUpdateResult linearUpdate(const Matrix& y, const Matrix& sr);
+    Matrix getFieldJacobian(const KF& self) const;
+    Matrix getPoseJacobian(const KF& self) const;
+
+private:
+    Matrix m_estimates;                         //!< the relative ball state [x, y, vx, vy]
+    Matrix m_sr;                                //!< the square root of the state covariance
+    int m_num_outliers;                         //!< the number of consecutive ball measurements rejected as outliers
+
+    // Tuning Values (Constants) -- Values assigned in BallTracker.cpp
+    static const double c_velocityDecay;        //!< the fraction of the ball's velocity left after one second
+    static const double c_positionNoise;        //!< the process noise on the position in cm per root second
+    static const double c_velocityNoise;        //!< the process noise on the velocity in cm/s per root second
+    static const double c_odometryNoise;        //!< the fraction of the robot's motion added as noise to the position
+    static const double c_R_ball_theta;
+    static const double c_R_ball_range_offset;
+    static const double c_R_ball_range_relative;
+    static const double c_threshold2;           //!< the threshold on the normalised innovation for outlier rejection
+    static const int c_MAX_OUTLIERS;            //!< the number of consecutive outliers after which the ball is moved to the measurement
+};
+
+#endif
+
@@ -1,12 +1,9 @@
 /**
-7 states calculation
+3 states calculation
 Xhat[0][0]=x
 Xhat[1][0]=y
 Xhat[2][0]=orientation
-Xhat[3][0]=ballX
-Xhat[4][0]=ballY
-Xhat[5][0]=ballVeocityX
-Xhat[6][0]=ballVeocityY
+The ball is tracked separately by the BallTracker
 **/
 
 #include "KF.h"
@@ -21,7 +18,6 @@ using namespace mathGeneral;
 
 // Tuning Values (Constants)
 const float KF::c_Kappa = 1.0f; // weight used in w matrix. (Constant)
-const float KF::c_ballDecayRate = 0.985f; // Ball weighting 0.985 => speed halves every 1.5 seconds. (Constant)
 const float KF::c_threshold2 = 15.0f; // Threshold for outlier rejection. Magic Number. (Constant)
 
 const float KF::c_outlierLikelyhood = 1e-3;
@@ -33,11 +29,6 @@ const float KF::c_outlierLikelyhood = 1e-3;
 // const float KF::sb_alpha5 = 0.0005;
 
 
-// Ball distance measurement error weightings (Constant)
-const float KF::c_R_ball_theta = 0.0001f;
-const float KF::c_R_ball_range_offset = 25.0f; // (5cm)^2
-const float KF::c_R_ball_range_relative = 0.0025f; // 5% of range added.
-
 
 double muXx     = 0.07;
 double muXy     = 0.00005;
@@ -57,23 +48,15 @@ KF::KF():odom_Model(0.07,0.00005,0.00005,0.000005)
   toBeActivated = false; // Model to be in use.
 
 // Update Uncertainty
-  updateUncertainties = Matrix(7, 7, true);
-  updateUncertainties[5][5] = c_ballDecayRate; // Ball velocity x
-  updateUncertainties[6][6] = c_ballDecayRate; // Ball velocity y
-  updateUncertainties[3][5] = 1.0f/frameRate; // [ballX][ballXvelocity]
-  updateUncertainties[4][6] = 1.0f/frameRate; // [ballY][ballYvelocity]
+  updateUncertainties = Matrix(numStates, numStates, true);
 
   init();									//Initialisation of Xhat and S
 
 // Process Noise - Matrix Square Root of Q
-  sqrtOfProcessNoise = Matrix(7,7,true);
+  sqrtOfProcessNoise = Matrix(numStates,numStates,true);
   sqrtOfProcessNoise[0][0] = 0.1; // Robot X coord.
   sqrtOfProcessNoise[1][1] = 0.1; // Robot Y coord.
   sqrtOfProcessNoise[2][2] = 0.001; // Robot Theta. 0.00001
-  sqrtOfProcessNoise[3][3] = 4.0; // Ball X.
-  sqrtOfProcessNoise[4][4] = 4.0; // Ball Y.
-  sqrtOfProcessNoise[5][5] = 5.6569; // Ball X Velocity.
-  sqrtOfProcessNoise[6][6] = 5.6569; // Ball Y Velocity.
 
 	//RHM 7/7/08: Extra matrix for resetting
   // Process noise for used for reset.
@@ -85,13 +68,11 @@ KF::KF():odom_Model(0.07,0.00005,0.00005,0.000005)
 //  sqrtOfProcessNoiseReset[3][3] = 20.0; // ball itself shouldn't have moved much?
 //  sqrtOfProcessNoiseReset[4][4] = 20.0; // just being cautious
 	
-  sqrtOfProcessNoiseReset = Matrix(7,7,false);
+  sqrtOfProcessNoiseReset = Matrix(numStates,numStates,false);
   sqrtOfProcessNoiseReset[0][0] = 150.0; // extra 50cm sd when kidnapped?
   sqrtOfProcessNoiseReset[1][1] = 100.0; // extra 50cm sd when kidnapped?
   //sqrtOfProcessNoiseReset[2][2] = 0.25; // extra 15deg shift when kidnapped? 0.25
   sqrtOfProcessNoiseReset[2][2] = 2.0; // extra 15deg shift when kidnapped? 0.25
-  sqrtOfProcessNoiseReset[3][3] = 20.0; // ball itself shouldn't have moved much?
-  sqrtOfProcessNoiseReset[4][4] = 20.0; // just being cautious
 
 
   nStates = stateEstimates.getm(); // number of states.
@@ -108,28 +89,24 @@ KF::KF():odom_Model(0.07,0.00005,0.00005,0.000005)
   }
   
   
-  Matrix srukfCovX = Matrix(7,7,false);  // Original covariance mat
-  Matrix srukfSq = Matrix(7,7,false);    // State noise square root covariance
-  Matrix srukfSr = Matrix(7,7,false);    // Measurement noise square root cov
-  Matrix srukfSx = Matrix(7,7,false);    
+  Matrix srukfCovX = Matrix(nStates,nStates,false);  // Original covariance mat
+  Matrix srukfSq = Matrix(nStates,nStates,false);    // State noise square root covariance
+  Matrix srukfSr = Matrix(nStates,nStates,false);    // Measurement noise square root cov
+  Matrix srukfSx = Matrix(nStates,nStates,false);    
   return;
 }
 
 
 void KF::init(){
   // Initial state estimates
-    stateEstimates= Matrix(7,1,true);
+    stateEstimates= Matrix(numStates,1,true);
     stateEstimates[2][0]=3+3.1416/2.0; // 0 for all values but robot bearing = 3.
   // S = Standard deviation matrix.
   // Initial Uncertainty
-    stateStandardDeviations = Matrix(7,7,false);
+    stateStandardDeviations = Matrix(numStates,numStates,false);
     stateStandardDeviations[0][0] = 150; // 100 cm
     stateStandardDeviations[1][1] = 100; // 150 cm
     stateStandardDeviations[2][2] = 2;   // 2 radians
-    stateStandardDeviations[3][3] = 150; // 100 cm
-    stateStandardDeviations[4][4] = 100; // 150 cm
-    stateStandardDeviations[5][5] = 10;  // 10 cm/s
-    stateStandardDeviations[6][6] = 10;  // 10 cm/s
     
     
     srukfCovX = stateStandardDeviations*stateStandardDeviations.transp();
@@ -231,12 +208,6 @@ void KF::performFiltering(double odom_X, double odom_Y, double odom_Theta)
 
 
 void KF::timeUpdate(double deltaTime){
-		
-   	//-----------------------Update for ball velocity	
-	stateEstimates[3][0] = stateEstimates[3][0] + stateEstimates[5][0]/frameRate; // Update ball x position by ball x velocity.
-	stateEstimates[4][0] = stateEstimates[4][0] + stateEstimates[6][0]/frameRate; // Update ball y position by ball y velocity.
-	stateEstimates[5][0] = c_ballDecayRate*stateEstimates[5][0]; // Reduce ball x velocity assuming deceleration
-	stateEstimates[6][0] = c_ballDecayRate*stateEstimates[6][0]; // Reduce ball y velocity assuming deceleration
 
   // Householder transform. Unscented KF algorithm. Takes a while.
 	stateStandardDeviations=HT(horzcat(updateUncertainties*stateStandardDeviations, sqrtOfProcessNoise));	
@@ -261,7 +232,7 @@ KfUpdateResult KF::odometeryUpdate(double odom_X, double odom_Y, double odom_The
   // Unscented KF Stuff.
 	Matrix yBar;                                  	//reset
 	Matrix Py;
-	Matrix Pxy=Matrix(7, 2, false);                    //Pxy=[0;0;0];
+	Matrix Pxy=Matrix(nStates, 2, false);                    //Pxy=[0;0;0];
 	Matrix scriptX=Matrix(stateEstimates.getm(), 2 * nStates + 1, false);
 	scriptX.setCol(0, stateEstimates);                         //scriptX(:,1)=Xhat;                  
     
@@ -331,80 +302,6 @@ KfUpdateResult KF::odometeryUpdate(double odom_X, double odom_Y, double odom_The
 	return KF_OK; 
 }
 
-KfUpdateResult KF::ballmeas(double Ballmeas, double theta_Ballmeas){
-  double ballX_rel = Ballmeas * cos(theta_Ballmeas);
-  double ballY_rel = Ballmeas * sin(theta_Ballmeas);
-  // RHM 8/7/08:
-  double R_range = c_R_ball_range_offset + c_R_ball_range_relative*pow(Ballmeas,2);
-  double R_bearing = c_R_ball_theta;
-    
-  // Calculate update uncertainties - S_ball_rel & R_ball_rel.
-  Matrix S_ball_rel = Matrix(2,2,false);
-  S_ball_rel[0][0] = cos(theta_Ballmeas) * sqrt(R_range);
-  S_ball_rel[0][1] = -sin(theta_Ballmeas) * Ballmeas * sqrt(R_bearing);
-  S_ball_rel[1][0] = sin(theta_Ballmeas) * sqrt(R_range);
-  S_ball_rel[1][1] = cos(theta_Ballmeas) * Ballmeas * sqrt(R_bearing);
-
-  Matrix R_ball_rel = S_ball_rel * S_ball_rel.transp();  // R = S^2
-
-  Matrix yBar;                                  	//reset
-  Matrix Py;
-  Matrix Pxy = Matrix(7,2,false);                    //Pxy=[0;0;0];
-
-  Matrix scriptX = Matrix(stateEstimates.getm(),2 * nStates + 1,false);
-  scriptX.setCol(0,stateEstimates);                         //scriptX(:,1)=Xhat; Current state.
-  for(int i = 1; i <= nStates; i++){  // Unscented KF. Creates test points used to compare against vision data.
-    // Addition Portion.
-    scriptX.setCol(i, stateEstimates + sqrt(nStates + c_Kappa) * stateStandardDeviations.getCol(i - 1));
-    // Subtraction Portion.
-    scriptX.setCol(nStates + i, stateEstimates - sqrt(nStates + c_Kappa) * stateStandardDeviations.getCol(i - 1));
-  }
-    
-  Matrix scriptY = Matrix(2, 2 * nStates + 1, false);
-  Matrix temp = Matrix(2,1,false);
-  for(int i = 0; i < 2 * nStates + 1; i++){
-    temp[0][0] = (scriptX[3][i] - scriptX[0][i]) * cos(scriptX[2][i]) + (scriptX[4][i] - scriptX[1][i]) * sin(scriptX[2][i]);
-    temp[1][0] = -(scriptX[3][i] - scriptX[0][i]) * sin(scriptX[2][i]) + (scriptX[4][i] - scriptX[1][i]) * cos(scriptX[2][i]);
-    scriptY.setCol(i,temp.getCol(0));
-  }
-    
-  Matrix Mx = Matrix(scriptX.getm(), 2 * nStates + 1, false);
-  Matrix My = Matrix(scriptY.getm(), 2 * nStates + 1, false);  
-  for(int i = 0; i < 2 * nStates + 1; i++){
-    Mx.setCol(i, sqrtOfTestWeightings[0][i] * scriptX.getCol(i));
-    My.setCol(i, sqrtOfTestWeightings[0][i] * scriptY.getCol(i));
-  }                                      
-
-  Matrix M1 = sqrtOfTestWeightings;
-  yBar = My * M1.transp(); // Predicted Measurement
-  Py = (My - yBar * M1) * (My - yBar * M1).transp();
-  Pxy = (Mx - stateEstimates * M1) * (My -yBar * M1).transp();
-    
-  Matrix K = Pxy * Invert22(Py + R_ball_rel);   // Kalman Filter Gain.
-
-  Matrix y = Matrix(2,1,false); // Measurement.
-  y[0][0] = ballX_rel;
-  y[1][0] = ballY_rel;
-	
-	//RHM: (3) Outlier rejection.
-	// (i) Compute
-  // double innovation2 = (yBar-temp).transp()*Invert22(Py+R_ball_rel)*(yBar-temp);
-	double innovation2 = convDble((yBar - y).transp()*Invert22(Py + R_ball_rel)*(yBar - y));
-	// (ii) Now compare this with a 'magic number' (threshold2) for outliers, and also vision
-  // object confidence, something like if ((innovation2> threshold2) && (visionObject.confidence is small) )
-  if (innovation2 > c_threshold2){
-	//std::cout<<"not update"<<std::endl;
-   	return KF_OUTLIER; // Outlier, so chuck it all out...
-  }
-
-  stateStandardDeviations = HT( horzcat(Mx - stateEstimates*M1 - K*My + K*yBar* M1, K*S_ball_rel) ); // Update uncertainties.
-  stateEstimates = stateEstimates - K * (yBar - y); // Update States.
-    
-  return KF_OK; // It all worked OK!
-}
-
-
-
 // RHM 7/7/08: Change for resetting (return int)
 KfUpdateResult KF::fieldObjectmeas(double distance,double bearing,double objX, double objY, double distanceErrorOffset, double distanceErrorRelative, double bearingError){
   double objX_rel = distance * cos(bearing);
@@ -426,7 +323,7 @@ KfUpdateResult KF::fieldObjectmeas(double distance,double bearing,double objX, d
   // Unscented KF Stuff.
   Matrix yBar;                                  	//reset
   Matrix Py;
-  Matrix Pxy=Matrix(7, 2, false);                    //Pxy=[0;0;0];
+  Matrix Pxy=Matrix(nStates, 2, false);                    //Pxy=[0;0;0];
   Matrix scriptX=Matrix(stateEstimates.getm(), 2 * nStates + 1, false);
   scriptX.setCol(0, stateEstimates);                         //scriptX(:,1)=Xhat;                  
     
@@ -511,8 +408,8 @@ void KF::linear2MeasurementUpdate(double Y1,double Y2, double SR11, double SR12,
   // are predicted to be Xhat[index1][0] and Xhat[index2][0] respectively
   // This is based on the function fieldObjectmeas, but simplified.
   //
-  // Example Call (given data from wireless: ballX, ballY, SRballXX, SRballXY, SRballYY)
-  //      linear2MeasurementUpdate( ballX, ballY, SRballXX, SRballXY, SRballYY, 3, 4 )
+  // Example Call (given a measurement of the robot's position: X, Y, SRXX, SRXY, SRYY)
+  //      linear2MeasurementUpdate( X, Y, SRXX, SRXY, SRYY, 0, 1 )
   Matrix SR = Matrix(2,2,false);
   SR[0][0] = SR11;
   SR[0][1] = SR12;
@@ -522,9 +419,9 @@ void KF::linear2MeasurementUpdate(double Y1,double Y2, double SR11, double SR12,
   R = SR * SR.transp();
 
   Matrix Py = Matrix(2, 2, false);
-  Matrix Pxy = Matrix(7, 2, false);                   
+  Matrix Pxy = Matrix(nStates, 2, false);                   
  
-  Matrix CS = Matrix(2, 7, false);
+  Matrix CS = Matrix(2, nStates, false);
   CS.setRow(0, stateStandardDeviations.getRow(index1));
   CS.setRow(1, stateStandardDeviations.getRow(index2));
 
@@ -557,22 +454,6 @@ void KF::linear2MeasurementUpdate(double Y1,double Y2, double SR11, double SR12,
   stateEstimates = stateEstimates - K * (yBar - y);
   return;
 }
-//======================================================================================================
-//
-// RHM: 26/6/08 New Pseudo code for ball information to send over wireless
-// Information to add to the broadcast to other robots:
-// (along with other information)
-// * Frame Number {timing indicator)
-// * Frames since I last saw the ball
-// * Xhat[3][0] (est ball X)
-// * Xhat[4][0] (est ball Y)
-// * SRxx, SRxy, SRyy (3 elements of 2x2 sqrt matrix formed as: HT(vertical_cat(S.getRow[3], S.getRow[4])))
-// * Xhat[0][0]
-// * Xhat[1][0] (could be used in behaviour)
-// * other stuff probably
-//
-//
-
 KfUpdateResult KF::updateAngleBetween(double angle, double x1, double y1, double x2, double y2, double sd_angle)
 {
         // Method to take the angle between two objects, that is,
@@ -586,7 +467,7 @@ KfUpdateResult KF::updateAngleBetween(double angle, double x1, double y1, double
     // Unscented KF Stuff.
     double yBar;                                  	//reset
     double Py;
-    Matrix Pxy = Matrix(7, 1, false);                    //Pxy=[0;0;0];
+    Matrix Pxy = Matrix(nStates, 1, false);                    //Pxy=[0;0;0];
     Matrix scriptX = Matrix(stateEstimates.getm(), 2 * nStates + 1, false);
     scriptX.setCol(0, stateEstimates);                         //scriptX(:,1)=Xhat;
     float weight = sqrt((double)nStates + c_Kappa);
@@ -667,13 +548,6 @@ double KF::getState(int stateID) const
 
 
 
-Matrix KF::GetBallSR() const
-{
-  return HT(vertcat(stateStandardDeviations.getRow(3), stateStandardDeviations.getRow(4)));
-}
-
-
-
 double KF::getDistanceToPosition(double posX, double posY) const
 {
   double selfX = stateEstimates[0][0];
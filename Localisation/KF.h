@@ -22,10 +22,6 @@ class KF {
             selfX,
             selfY,
             selfTheta,
-            ballX,
-            ballY,
-            ballXVelocity,
-            ballYVelocity,
             numStates
         };
 
@@ -34,7 +30,6 @@ class KF {
         // Update functions
         void timeUpdate(double deltaTime);
         KfUpdateResult odometeryUpdate(double odom_X, double odom_Y, double odom_Theta, double R_X, double R_Y, double R_Theta);
-        KfUpdateResult ballmeas(double Ballmeas, double theta_Ballmeas);
         KfUpdateResult fieldObjectmeas(double distance, double bearing,double objX,double objY, double distanceErrorOffset, double distanceErrorRelative, double bearingError);
         void linear2MeasurementUpdate(double Y1,double Y2, double SR11, double SR12, double SR22, int index1, int index2);
         KfUpdateResult updateAngleBetween(double angle, double x1, double y1, double x2, double y2, double sd_angle);
@@ -44,7 +39,6 @@ class KF {
         double sd(int Xi) const;
         double variance(int Xi) const;
         double getState(int stateID) const;
-        Matrix GetBallSR() const;
         double getDistanceToPosition(double posX, double posY) const;
         double getBearingToPosition(double posX, double posY) const;
 
@@ -97,14 +91,8 @@ class KF {
 	OdometryMotionModel odom_Model;
         // Tuning Values (Constants) -- Values assigned in KF.cpp
         static const float c_Kappa;
-        static const float c_ballDecayRate;
         static const float c_threshold2;
 
-        // Ball distance measurement error weightings (Constant) -- Values assigned in KF.cpp
-        static const float c_R_ball_theta;
-        static const float c_R_ball_range_offset;
-        static const float c_R_ball_range_relative;
-
         static const float c_outlierLikelyhood;
 	
 	void measureLocalization(double x,double y,double theta);
@@ -52,7 +52,7 @@ const float Localisation::centreCircleBearingError = (float)(deg2rad(20)*deg2rad
 
 const float Localisation::sdTwoObjectAngle = (float) 0.02; //Small! error in angle difference is normally very small
 
-Localisation::Localisation(int playerNumber): m_timestamp(0)
+Localisation::Localisation(int playerNumber): m_timestamp(0), m_frame_time(0)
 {
     m_previously_incapacitated = true;
     m_previous_game_state = GameInformation::InitialState;
@@ -87,10 +87,12 @@ Localisation& Localisation::operator=(const Localisation& source)
     if (this != &source) // protect against invalid self-assignment
     {
         m_timestamp = source.m_timestamp;
+        m_frame_time = source.m_frame_time;
         for (int i = 0; i < c_MAX_MODELS; i++)
         {
             m_models[i] = source.m_models[i];
         }
+        m_ball = source.m_ball;
 
         // local pointers to the public store
         m_sensor_data = source.m_sensor_data;
@@ -150,16 +152,35 @@ void Localisation::process(NUSensorsData* data, FieldObjects* fobs, GameInformat
             return;
         }
     #else
+        // The models are moved to the time the image was taken, using the odometry between this image and the last.
+        // If there is no odometry history, the odometry accumulated since the last frame is used.
+        double frameTime = m_objects->GetTimestamp();
         vector<float> odo;
-        if (m_sensor_data->getOdometry(odo))
+        bool accumulated = m_sensor_data->getOdometry(odo);
+        if (m_frame_time > 0 and m_sensor_data->getOdometry(m_frame_time, frameTime, odo))
         {
             m_odomForward = odo[0];
             m_odomLeft = odo[1];
             m_odomTurn = odo[2];
         }
+        else if (accumulated)
+        {
+            m_odomForward = -odo[0];
+            m_odomLeft = odo[1];
+            m_odomTurn = odo[2];
+        }
         // perform odometry update and change the variance of the model
-        doTimeUpdate((-m_odomForward), m_odomLeft, m_odomTurn);
+        doTimeUpdate(m_odomForward, m_odomLeft, m_odomTurn);
         ProcessObjects();
+        m_frame_time = frameTime;
+
+        // Anchor the high rate pose stream, so everything else can have the pose between images
+        const KF& bestModel = getBestModel();
+        vector<float> pose(3, 0);
+        pose[0] = bestModel.getState(KF::selfX);
+        pose[1] = bestModel.getState(KF::selfY);
+        pose[2] = bestModel.getState(KF::selfTheta);
+        m_sensor_data->setFieldPose(frameTime, pose);
     #endif
 
     m_timestamp = m_sensor_data->CurrentTime;
@@ -257,7 +278,21 @@ void Localisation::ProcessObjects()
         NormaliseAlphas();
 
 #if MULTIPLE_MODELS_ON
-        // Do Ambiguous objects.
+        // Do Ambiguous objects. The camera when the image was taken is used to skip the options a model could not have seen.
+        // If there is no kinematic history, the current camera is used.
+        vector<float> ctgvector;
+        KinematicState imagekinematics;
+        bool ctgvalid;
+        if (m_sensor_data->getKinematics(m_objects->GetTimestamp(), imagekinematics))
+        {
+            ctgvalid = imagekinematics.CameraToGroundTransformValid;
+            if (ctgvalid)
+                ctgvector.assign(imagekinematics.CameraToGroundTransform, imagekinematics.CameraToGroundTransform + 16);
+        }
+        else
+            ctgvalid = m_sensor_data->get(NUSensorsData::CameraToGroundTransform, ctgvector);
+        if (not ctgvalid or not m_landmark_visibility.setCamera(ctgvector))
+            m_landmark_visibility.invalidate();
         AmbiguousObjectsIt currAmb(m_objects->ambiguousFieldObjects.begin());
         AmbiguousObjectsConstIt endAmb(m_objects->ambiguousFieldObjects.end());
         for(; currAmb != endAmb; ++currAmb){
@@ -301,6 +336,8 @@ void Localisation::ProcessObjects()
         //int bestModelID = getBestModelID();
         // Get the best model to use.
         WriteModelToObjects(getBestModel(), m_objects);
+        if (m_team_info != NULL)
+            m_team_info->setLocalisationSummary(getNumActiveModels(), getBestModel().alpha, timeSinceFieldObjectSeen);
 
 #if DEBUG_LOCALISATION_VERBOSITY > 2
         const KF* bestModel = &(getBestModel());
@@ -343,14 +380,17 @@ void Localisation::WriteModelToObjects(const KF &model, FieldObjects* fieldObjec
     }
     */
 
-    // Set the balls location.
-    float distance,bearing;
-    distance = model.getDistanceToPosition(model.getState(KF::ballX), model.getState(KF::ballY));
-    bearing = model.getBearingToPosition(model.getState(KF::ballX), model.getState(KF::ballY));
-    fieldObjects->mobileFieldObjects[fieldObjects->FO_BALL].updateObjectLocation(model.getState(KF::ballX),model.getState(KF::ballY),model.sd(KF::ballX), model.sd(KF::ballY));
-    fieldObjects->mobileFieldObjects[fieldObjects->FO_BALL].updateObjectVelocities(model.getState(KF::ballXVelocity),model.getState(KF::ballYVelocity),model.sd(KF::ballXVelocity), model.sd(KF::ballYVelocity));
-    fieldObjects->mobileFieldObjects[fieldObjects->FO_BALL].updateEstimatedRelativeVariables(distance, bearing, 0.0f);
-    fieldObjects->mobileFieldObjects[fieldObjects->FO_BALL].updateSharedCovariance(model.GetBallSR());
+    // Set the balls location. The ball is tracked relative to the robot, so its field location is conditioned on the model
+    Matrix ballEstimates = m_ball.getFieldEstimates(model);
+    Matrix ballSR = m_ball.getFieldSR(model);
+    double ballSd[BallTracker::numStates];
+    for (int i = 0; i < BallTracker::numStates; i++)
+        ballSd[i] = sqrt(convDble(ballSR.getRow(i)*ballSR.getRow(i).transp()));
+    MobileObject& ball = fieldObjects->mobileFieldObjects[fieldObjects->FO_BALL];
+    ball.updateObjectLocation(ballEstimates[BallTracker::relX][0], ballEstimates[BallTracker::relY][0], ballSd[BallTracker::relX], ballSd[BallTracker::relY]);
+    ball.updateObjectVelocities(ballEstimates[BallTracker::relXVelocity][0], ballEstimates[BallTracker::relYVelocity][0], ballSd[BallTracker::relXVelocity], ballSd[BallTracker::relYVelocity]);
+    ball.updateEstimatedRelativeVariables(m_ball.getDistance(), m_ball.getBearing(), 0.0f);
+    ball.updateSharedCovariance(HT(vertcat(ballSR.getRow(BallTracker::relX), ballSR.getRow(BallTracker::relY))));
 
 	bool lost = false;
 	if (lostCount > 20 or timeSinceFieldObjectSeen > 15000)
@@ -418,6 +458,7 @@ void Localisation::ClearAllModels()
         m_models[m].isActive = false;
         m_models[m].toBeActivated = false;
     }
+    m_ball.reset();
     return;
 }
 
@@ -588,10 +629,6 @@ void Localisation::doReset()
     m_models[0].stateEstimates[0][0] = 300.0;         // Robot x
     m_models[0].stateEstimates[1][0] = 0.0;           // Robot y
     m_models[0].stateEstimates[2][0] = PI;        // Robot heading
-    m_models[0].stateEstimates[3][0] = 0.0;           // Ball x
-    m_models[0].stateEstimates[4][0] = 0.0;           // Ball y
-    m_models[0].stateEstimates[5][0] = 0.0;           // Ball vx
-    m_models[0].stateEstimates[6][0] = 0.0;           // Ball vy
 
     // Set the uncertainties
     resetSdMatrix(0);
@@ -603,10 +640,6 @@ void Localisation::doReset()
     m_models[1].stateEstimates[0][0] = -300.0;        // Robot x
     m_models[1].stateEstimates[1][0] = 0.0;           // Robot y
     m_models[1].stateEstimates[2][0] = 0.0;           // Robot heading
-    m_models[1].stateEstimates[3][0] = 0.0;       // Ball x
-    m_models[1].stateEstimates[4][0] = 0.0;       // Ball y
-    m_models[1].stateEstimates[5][0] = 0.0;       // Ball vx
-    m_models[1].stateEstimates[6][0] = 0.0;       // Ball vy
 
     // Set the uncertainties
     resetSdMatrix(1);
@@ -618,10 +651,6 @@ void Localisation::doReset()
     m_models[2].stateEstimates[0][0] = 0.0;        // Robot x
     m_models[2].stateEstimates[1][0] = 200.0;           // Robot y
     m_models[2].stateEstimates[2][0] = -PI/2.0;           // Robot heading
-    m_models[2].stateEstimates[3][0] = 0.0;       // Ball x
-    m_models[2].stateEstimates[4][0] = 0.0;       // Ball y
-    m_models[2].stateEstimates[5][0] = 0.0;       // Ball vx
-    m_models[2].stateEstimates[6][0] = 0.0;       // Ball vy
 
     // Set the uncertainties
     resetSdMatrix(2);
@@ -633,10 +662,6 @@ void Localisation::doReset()
     m_models[3].stateEstimates[0][0] = 0.0;        // Robot x
     m_models[3].stateEstimates[1][0] = -200.0;           // Robot y
     m_models[3].stateEstimates[2][0] = PI/2.0;           // Robot heading
-    m_models[3].stateEstimates[3][0] = 0.0;       // Ball x
-    m_models[3].stateEstimates[4][0] = 0.0;       // Ball y
-    m_models[3].stateEstimates[5][0] = 0.0;       // Ball vx
-    m_models[3].stateEstimates[6][0] = 0.0;       // Ball vy
 
     // Set the uncertainties
     resetSdMatrix(3);
@@ -649,13 +674,7 @@ void Localisation::doBallOutReset()
     debug_out  << "[" << m_sensor_data->CurrentTime << "] Performing ball out reset." << endl;
 #endif // DEBUG_LOCALISATION_VERBOSITY > 0
     // Increase uncertainty of ball position if it has gone out.. Cause it has probably been moved.
-    for (int modelNumber = 0; modelNumber < c_MAX_MODELS; modelNumber++){
-        if(m_models[modelNumber].isActive == false) continue;
-        m_models[modelNumber].stateStandardDeviations[3][3] += 100.0; // 100 cm
-        m_models[modelNumber].stateStandardDeviations[4][4] += 60.0; // 60 cm
-        m_models[modelNumber].stateStandardDeviations[5][5] += 10.0;   // 10 cm/s
-        m_models[modelNumber].stateStandardDeviations[6][6] += 10.0;   // 10 cm/s
-    }
+    m_ball.increaseUncertainty(100.0, 10.0);  // 100 cm, 10 cm/s
     return;
 }
 
@@ -668,10 +687,6 @@ void Localisation::setupModel(int modelNumber, int numModels, float x, float y,
     m_models[modelNumber].stateEstimates[0][0] = x;             // Robot x
     m_models[modelNumber].stateEstimates[1][0] = y;             // Robot y
     m_models[modelNumber].stateEstimates[2][0] = heading;       // Robot heading
-    m_models[modelNumber].stateEstimates[3][0] = 0.0;           // Ball x
-    m_models[modelNumber].stateEstimates[4][0] = 0.0;           // Ball y
-    m_models[modelNumber].stateEstimates[5][0] = 0.0;           // Ball vx
-    m_models[modelNumber].stateEstimates[6][0] = 0.0;           // Ball vy
 }
 
 /*! @brief Setup a model's standard deviations with the given sdx, sdy, sdheading */
@@ -680,10 +695,6 @@ void Localisation::setupModelSd(int modelNumber, float sdx, float sdy, float sdh
     m_models[modelNumber].stateStandardDeviations[0][0] = sdx;        // Robot x
     m_models[modelNumber].stateStandardDeviations[1][1] = sdy;        // Robot y
     m_models[modelNumber].stateStandardDeviations[2][2] = sdheading;  // Robot heading
-    m_models[modelNumber].stateStandardDeviations[3][3] = 150.0;      // Ball x
-    m_models[modelNumber].stateStandardDeviations[4][4] = 100.0;      // Ball y
-    m_models[modelNumber].stateStandardDeviations[5][5] = 10.0;       // Ball velocity x
-    m_models[modelNumber].stateStandardDeviations[6][6] = 10.0;       // Ball velocity y
 }
 
 void Localisation::resetSdMatrix(int modelNumber)
@@ -692,19 +703,11 @@ void Localisation::resetSdMatrix(int modelNumber)
      m_models[modelNumber].stateStandardDeviations[0][0] = 150.0; // 150 cm
      m_models[modelNumber].stateStandardDeviations[1][1] = 100.0; // 100 cm
      m_models[modelNumber].stateStandardDeviations[2][2] = PI;   // 2 radians
-     m_models[modelNumber].stateStandardDeviations[3][3] = 150.0; // 150 cm
-     m_models[modelNumber].stateStandardDeviations[4][4] = 100.0; // 100 cm
-     m_models[modelNumber].stateStandardDeviations[5][5] = 10.0;   // 10 cm/s
-     m_models[modelNumber].stateStandardDeviations[6][6] = 10.0;   // 10 cm/s
 
     
 //    models[modelNumber].stateStandardDeviations[0][0] = 10.0; // 100 cm
 //    models[modelNumber].stateStandardDeviations[1][1] = 10.0; // 150 cm
 //    models[modelNumber].stateStandardDeviations[2][2] = 0.2;   // 2 radians
-//    models[modelNumber].stateStandardDeviations[3][3] = 10.0; // 100 cm
-//    models[modelNumber].stateStandardDeviations[4][4] = 10.0; // 150 cm
-//    models[modelNumber].stateStandardDeviations[5][5] = 1.0;   // 10 cm/s
-//    models[modelNumber].stateStandardDeviations[6][6] = 1.0;   // 10 cm/s
     
     
     return;  
@@ -764,41 +767,6 @@ bool Localisation::clipModelToField(int modelID)
     }
     #endif // DEBUG_LOCALISATION_VERBOSITY > 1
 
-    wasClipped = wasClipped || clipped;
-    prevX = m_models[modelID].getState(0);
-    prevY = m_models[modelID].getState(1);
-    prevTheta = m_models[modelID].getState(2);
-
-    clipped = m_models[modelID].clipState(3, fieldXMin, fieldXMax);		// Clipping for ball's X
-
-    #if DEBUG_LOCALISATION_VERBOSITY > 1
-    if(clipped){
-        debug_out  << "[" << m_timestamp << "]: Model[" << modelID << "]";
-        debug_out  << " [alpha = " << m_models[modelID].alpha << "]";
-        debug_out  << " State(3) clipped." << endl;
-        debug_out  << " (" << prevX << "," << prevY << "," << prevTheta << ") -> (" << m_models[modelID].getState(0);
-        debug_out  << "," << m_models[modelID].getState(1) << "," << m_models[modelID].getState(2) << ")" << endl;
-    }
-    #endif // DEBUG_LOCALISATION_VERBOSITY > 1
-    
-    wasClipped = wasClipped || clipped;
-
-    prevX = m_models[modelID].getState(0);
-    prevY = m_models[modelID].getState(1);
-    prevTheta = m_models[modelID].getState(2);
-
-    clipped = m_models[modelID].clipState(4, fieldYMin, fieldYMax);		// Clipping for ball's Y
-
-    #if DEBUG_LOCALISATION_VERBOSITY > 1
-    if(clipped){
-        debug_out  << "[" << m_timestamp << "]: Model[" << modelID << "]";
-        debug_out  << " [alpha = " << m_models[modelID].alpha << "]";
-        debug_out  << " State(4) clipped." << endl;
-        debug_out  << " (" << prevX << "," << prevY << "," << prevTheta << ") -> (" << m_models[modelID].getState(0);
-        debug_out  << "," << m_models[modelID].getState(1) << "," << m_models[modelID].getState(2) << ")" << endl;
-    }
-    #endif // DEBUG_LOCALISATION_VERBOSITY > 1
-    
     wasClipped = wasClipped || clipped;
 
     return wasClipped;
@@ -821,6 +789,13 @@ bool Localisation::clipActiveModelsToField()
 
 bool Localisation::doTimeUpdate(float odomForward, float odomLeft, float odomTurn)
 {
+    // The ball is moved by the same odometry as the models, over the time between the images they were taken from.
+    // The time is clipped in case localisation was not running, and there is no motion before the first image
+    double deltaTime = 0;
+    if (m_frame_time > 0)
+        deltaTime = crop((m_objects->GetTimestamp() - m_frame_time)/1000.0, 0.0, 1.0);
+    m_ball.timeUpdate(deltaTime, odomForward, odomLeft, odomTurn);
+
     bool result = false;
     for(int modelID = 0; modelID < c_MAX_MODELS; modelID++)
     {
@@ -880,8 +855,6 @@ bool Localisation::doTimeUpdate(float odomForward, float odomLeft, float odomTur
 
 int Localisation::doSharedBallUpdate(const TeamPacket::SharedBall& sharedBall)
 {
-    int kf_return;
-    int numSuccessfulUpdates = 0;
     float timeSinceSeen = sharedBall.TimeSinceLastSeen;
     double sharedBallX = sharedBall.X;
     double sharedBallY = sharedBall.Y;
@@ -899,20 +872,19 @@ int Localisation::doSharedBallUpdate(const TeamPacket::SharedBall& sharedBall)
         debug_out  << "[" << m_timestamp << "]: Doing Shared Ball Update. X = " << sharedBallX << " Y = " << sharedBallY << " SRXX = " << SRXX << " SRXY = " << SRXY << "SRYY = " << SRYY << endl;
     #endif
 
-    for(int modelID = 0; modelID < c_MAX_MODELS; modelID++){
-        if(m_models[modelID].isActive == false) continue; // Skip Inactive models.
-        kf_return = KF_OK;
-        m_models[modelID].linear2MeasurementUpdate(sharedBallX, sharedBallY, SRXX, SRXY, SRYY, 3, 4);
-        if(kf_return == KF_OK) numSuccessfulUpdates++;
-    }
-    return numSuccessfulUpdates;
+    // The shared ball is in field coordinates, so it is brought into the robot's frame using the best model
+    Matrix SR(2, 2, false);
+    SR[0][0] = SRXX;
+    SR[0][1] = SRXY;
+    SR[1][1] = SRYY;
+    if (m_ball.fieldMeasurementUpdate(sharedBallX, sharedBallY, SR, getBestModel()) == KF_OK)
+        return 1;
+    else
+        return 0;
 }
 
 int Localisation::doBallMeasurementUpdate(MobileObject &ball)
 {
-    int kf_return;
-    int numSuccessfulUpdates = 0;
-
     if(IsValidObject(ball) == false)
     {
     #if DEBUG_LOCALISATION_VERBOSITY > 0
@@ -926,13 +898,10 @@ int Localisation::doBallMeasurementUpdate(MobileObject &ball)
     #endif // DEBUG_LOCALISATION_VERBOSITY > 1
 
     double flatBallDistance = ball.measuredDistance() * cos(ball.measuredElevation());
-    for(int modelID = 0; modelID < c_MAX_MODELS; modelID++){
-        if(m_models[modelID].isActive == false) continue; // Skip Inactive models.
-        kf_return = KF_OK;
-        kf_return = m_models[modelID].ballmeas(flatBallDistance, ball.measuredBearing());
-        if(kf_return == KF_OK) numSuccessfulUpdates++;
-    }
-    return numSuccessfulUpdates;
+    if (m_ball.measurementUpdate(flatBallDistance, ball.measuredBearing()) == KF_OK)
+        return 1;
+    else
+        return 0;
 }
 
 int Localisation::doKnownLandmarkMeasurementUpdate(StationaryObject &landmark)
@@ -1107,6 +1076,17 @@ int Localisation::doAmbiguousLandmarkMeasurementUpdate(AmbiguousObject &ambigous
         // Now go through each of the possible options, and apply it to a copy of the model
         for(unsigned int optionNumber = 0; optionNumber < numOptions; optionNumber++){
             int possibleObjectID = possabilities[optionNumber];
+
+            // If this model could not have seen the option, the update would only be rejected as an outlier, so skip it
+            float sdposition = max(m_tempModel.sd(KF::selfX), m_tempModel.sd(KF::selfY));
+            if (not m_landmark_visibility.couldSee(possibleObjects[possibleObjectID], m_tempModel.getState(KF::selfX), m_tempModel.getState(KF::selfY), m_tempModel.getState(KF::selfTheta), sdposition, m_tempModel.sd(KF::selfTheta)))
+            {
+                #if DEBUG_LOCALISATION_VERBOSITY > 2
+                debug_out  <<"[" << m_timestamp << "]: Model[" << modelID << "] could not see option " << possibleObjectID << ". Skipped." << endl;
+                #endif // DEBUG_LOCALISATION_VERBOSITY > 2
+                continue;
+            }
+
             int newModelID = FindNextFreeModel();
     
             // If an invalid modelID has been returned, something has gone horribly wrong, so stop here.
@@ -1261,6 +1241,12 @@ const KF& Localisation::getBestModel() const
     return m_models[getBestModelID()];
 }
 
+/*! @brief Returns the ball tracker. The ball is relative to the robot; use getFieldEstimates() with a model to get its field location */
+const BallTracker& Localisation::getBall() const
+{
+    return m_ball;
+}
+
 int Localisation::getBestModelID() const
 {
     // Return model with highest alpha value.
@@ -1585,10 +1571,15 @@ void Localisation::measureLocalization(double x,double y,double theta)
 
 }
 
+/*! @brief Writes the localisation to a stream. The number of models is preceded by the negative of the
+           LOCALISATION_STREAM_VERSION, which version 1 readers and streams never have there.
+ */
 std::ostream& operator<< (std::ostream& output, const Localisation& p_loc)
 {
+    int version = -LOCALISATION_STREAM_VERSION;
     int numodels = p_loc.c_MAX_MODELS;
     output.write(reinterpret_cast<const char*>(&p_loc.m_timestamp), sizeof(p_loc.m_timestamp));
+    output.write(reinterpret_cast<const char*>(&version), sizeof(version));
     output.write(reinterpret_cast<const char*>(&numodels), sizeof(numodels));
     for (int i = 0; i < numodels; ++i)
     {
@@ -1596,19 +1587,36 @@ std::ostream& operator<< (std::ostream& output, const Localisation& p_loc)
         for (int j = 0; j < p_loc.c_numOutlierTrackedObjects; ++j)
             output.write(reinterpret_cast<const char*>(&p_loc.m_modelObjectErrors[i][j]), sizeof(p_loc.m_modelObjectErrors[i][j]));
     }
+    output << p_loc.m_ball;
     return output;
 }
 
+/*! @brief Reads the localisation from a stream of any version. A version 1 stream has no ball, so the ball is reset. */
 std::istream& operator>> (std::istream& input, Localisation& p_loc)
 {
+    int version = 1;
     int numModels;
     input.read(reinterpret_cast<char*>(&p_loc.m_timestamp), sizeof(p_loc.m_timestamp));
     input.read(reinterpret_cast<char*>(&numModels), sizeof(numModels));
+    if (numModels < 0)
+    {
+        version = -numModels;
+        input.read(reinterpret_cast<char*>(&numModels), sizeof(numModels));
+    }
+    if (version > LOCALISATION_STREAM_VERSION or numModels < 0 or numModels > p_loc.c_MAX_MODELS)
+    {
+        input.setstate(std::ios_base::failbit);
+        return input;
+    }
     for (int i = 0; i < numModels; ++i)
     {
         input >> p_loc.m_models[i];
         for (int j = 0; j < p_loc.c_numOutlierTrackedObjects; ++j)
             input.read(reinterpret_cast<char*>(&p_loc.m_modelObjectErrors[i][j]), sizeof(p_loc.m_modelObjectErrors[i][j]));
     }
+    if (version >= 2)
+        input >> p_loc.m_ball;
+    else
+        p_loc.m_ball.reset();
     return input;
 }
@@ -1,8 +1,10 @@
 #ifndef LOCWM_H_DEFINED
 #define LOCWM_H_DEFINED
 #include "KF.h"
+#include "BallTracker.h"
 
 #include "Infrastructure/FieldObjects/FieldObjects.h"
+#include "Infrastructure/FieldObjects/LandmarkVisibility.h"
 #include "Infrastructure/GameInformation/GameInformation.h"
 class NUSensorsData;
 #include "Infrastructure/TeamInformation/TeamInformation.h"
@@ -19,6 +21,9 @@ class NUSensorsData;
 // 3 - All messages
 // #define  DEBUG_LOCALISATION_VERBOSITY 3
 
+// The version of the stream format. Version 1 streams have no version, and end after the models without the ball.
+#define LOCALISATION_STREAM_VERSION 2
+
 class Localisation: public TimestampedData
 {
 	public:
@@ -52,6 +57,7 @@ class Localisation: public TimestampedData
         bool CheckModelForOutlierReset(int modelID);
         int  CheckForOutlierResets();
         const KF& getBestModel() const;
+        const BallTracker& getBall() const;
         const KF& getModel(int modelNumber) const;
         int getBestModelID() const;
         void NormaliseAlphas();
@@ -103,18 +109,21 @@ class Localisation: public TimestampedData
         static const int c_numOutlierTrackedObjects = FieldObjects::NUM_STAT_FIELD_OBJECTS;
         KF m_tempModel;
         KF m_models[c_MAX_MODELS];
+        BallTracker m_ball;                 //!< the ball, which is tracked once relative to the robot rather than in every model
     
         // local pointers to the public store
         NUSensorsData* m_sensor_data;
         FieldObjects* m_objects;
         GameInformation* m_game_info;
         TeamInformation* m_team_info;
+        LandmarkVisibility m_landmark_visibility;      //!< used to skip ambiguous options a model could not have seen
 
 	#if DEBUG_LOCALISATION_VERBOSITY > 0
         ofstream debug_file; // Logging file
         #endif // LOCWM_VERBOSITY > 0
 
         double m_timestamp;
+        double m_frame_time;                // the capture time of the image used in the last update
         double GetTimestamp() const {return m_timestamp;};
         int m_currentFrameNumber;
         float m_modelObjectErrors[c_MAX_MODELS][c_numOutlierTrackedObjects]; // Storage of outlier history.
@@ -124,14 +133,14 @@ class Localisation: public TimestampedData
         GameInformation::RobotState m_previous_game_state;
         
         float m_odomForward, m_odomLeft, m_odomTurn;
-        // Tuning Constants -- Values assigned in LocWM.cpp
+        // Tuning Constants -- Values assigned in Localisation.cpp
         static const float c_LargeAngleSD;
         static const float c_OBJECT_ERROR_THRESHOLD;
         static const float c_OBJECT_ERROR_DECAY;
         static const float c_RESET_SUM_THRESHOLD;
         static const int c_RESET_NUM_THRESHOLD;
 
-        // Object distance measurement error weightings (Constant) -- Values assigned in LocWM.cpp
+        // Object distance measurement error weightings (Constant) -- Values assigned in Localisation.cpp
         static const float R_obj_theta;
         static const float R_obj_range_offset;
         static const float R_obj_range_relative;
@@ -24,6 +24,7 @@ SET (YOUR_SRCS  pose2d.h
                probabilityUtils.cpp probabilityUtils.h
                odometryMotionModel.cpp odometryMotionModel.h
                KF.cpp KF.h
+               BallTracker.cpp BallTracker.h
                Localisation.cpp Localisation.h
 		LocWmFrame
 )
@@ -0,0 +1,62 @@
+##############################
+# tools.cmake
+#
+#   - define NUBOT_ADD_TOOL, which adds an optional executable built alongside nubot (benchmarks, checks and offline tools)
+#   - set the conditions a tool can require that are not already a variable
+#
+#   NUBOT_ADD_TOOL(<name> <option> <description> <directory> [REQUIRES <variable>...] [LIBRARIES <library>...])
+#       - adds the advanced cache option <option>, which is OFF unless it is set
+#       - if the option and every REQUIRES variable are true, includes <directory>/cmake/sources.cmake (the directory is
+#         relative to the top of the source tree) and adds the executable <name> built from the sources it puts in <NAME>_SRCS
+#       - links the executable to the LIBRARIES
+#
+#    Copyright (c) 2026 agent
+#    This file is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This file is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+
+IF (${TARGET_ROBOT} STREQUAL BEAR OR ${TARGET_ROBOT} STREQUAL CYCLOID)
+    SET(NUBOT_TARGET_IS_ROBOTIS ON)
+ENDIF()
+IF (${CMAKE_SYSTEM_NAME} STREQUAL Linux)
+    SET(NUBOT_SYSTEM_IS_LINUX ON)
+ENDIF()
+
+FUNCTION(NUBOT_ADD_TOOL name option description directory)
+    OPTION(${option} "${description}" OFF)
+    MARK_AS_ADVANCED(${option})
+
+    # split the remaining arguments into the REQUIRES and LIBRARIES lists
+    SET(TOOL_REQUIRES )
+    SET(TOOL_LIBRARIES )
+    SET(TOOL_LIST TOOL_REQUIRES)
+    FOREACH(loop_var ${ARGN})
+        IF (loop_var STREQUAL REQUIRES OR loop_var STREQUAL LIBRARIES)
+            SET(TOOL_LIST TOOL_${loop_var})
+        ELSE()
+            LIST(APPEND ${TOOL_LIST} ${loop_var})
+        ENDIF()
+    ENDFOREACH(loop_var ${ARGN})
+
+    IF (NOT ${option})
+        RETURN()
+    ENDIF()
+    FOREACH(loop_var ${TOOL_REQUIRES})
+        IF (NOT ${loop_var})
+            RETURN()
+        ENDIF()
+    ENDFOREACH(loop_var ${TOOL_REQUIRES})
+
+    STRING(TOUPPER ${name} TOOL_NAME)
+    INCLUDE(${CMAKE_CURRENT_SOURCE_DIR}/../${directory}/cmake/sources.cmake)
+    ADD_EXECUTABLE( ${name} ${${TOOL_NAME}_SRCS} )
+    IF (TOOL_LIBRARIES)
+        TARGET_LINK_LIBRARIES( ${name} ${TOOL_LIBRARIES} )
+    ENDIF()
+ENDFUNCTION(NUBOT_ADD_TOOL)
@@ -49,6 +49,13 @@ NUHead::NUHead(NUSensorsData* data, NUActionatorsData* actions) : NUMotionProvid
     m_is_nodding = false;
     m_move_end_time = 0;
     
+    m_pan_library_clock = 0;
+    for (int i=0; i<NUHEAD_PAN_LIBRARY_SIZE; i++)
+    {
+        m_pan_library[i].Valid = false;
+        m_pan_library[i].LastUsed = 0;
+    }
+    
     load();
 }
 
@@ -274,21 +281,23 @@ void NUHead::calculateHeadTarget(float elevation, float bearing, float centreele
 /*! @brief Calculates the minimum and maximum head pitch values given a range on the field to look over
     @param mindistance the minimum distance in centimetres to look
     @param maxdistance the maximum distance in centimetres to look
+    @param cameraheight the height of the camera in centimetres
+    @param bodypitch the forward-backward lean of the robot in radians
     @param minpitch the calculated minpitch is stored here
     @param maxpitch the calculated maxpitch is stored here
  */
-void NUHead::calculateMinAndMaxPitch(float mindistance, float maxdistance, float& minpitch, float& maxpitch)
+void NUHead::calculateMinAndMaxPitch(float mindistance, float maxdistance, float cameraheight, float bodypitch, float& minpitch, float& maxpitch)
 {
-    float maxtilt_limit = m_CAMERA_FOV_Y/2 - m_CAMERA_OFFSET - m_body_pitch - 0.05;
-    minpitch = std::min(static_cast<float>(atan2(m_camera_height, mindistance) - m_CAMERA_OFFSET - 0.5*m_CAMERA_FOV_Y - m_body_pitch), m_pitch_limits[1]);
+    float maxtilt_limit = m_CAMERA_FOV_Y/2 - m_CAMERA_OFFSET - bodypitch - 0.05;
+    minpitch = std::min(static_cast<float>(atan2(cameraheight, mindistance) - m_CAMERA_OFFSET - 0.5*m_CAMERA_FOV_Y - bodypitch), m_pitch_limits[1]);
     if (maxdistance > 800)
         maxpitch = maxtilt_limit;
     else
-        maxpitch = std::max(static_cast<float>(atan2(m_camera_height, maxdistance) - m_CAMERA_OFFSET + 0.5*m_CAMERA_FOV_Y - m_body_pitch), maxtilt_limit);
+        maxpitch = std::max(static_cast<float>(atan2(cameraheight, maxdistance) - m_CAMERA_OFFSET + 0.5*m_CAMERA_FOV_Y - bodypitch), maxtilt_limit);
     
     if (minpitch <= maxpitch)
     {
-        float pitch = atan2(m_camera_height, (mindistance + maxdistance)/2) - m_CAMERA_OFFSET - m_body_pitch;
+        float pitch = atan2(cameraheight, (mindistance + maxdistance)/2) - m_CAMERA_OFFSET - bodypitch;
         if (pitch > m_pitch_limits[1])
             pitch = m_pitch_limits[1];
         else if (pitch < maxtilt_limit)
@@ -339,17 +348,122 @@ void NUHead::calculateLocalisationPan()
 }
 
 /*! @brief Calculates a pan between mindistance (cm) and maxdistance (cm) at panspeed (cm/s)
+ 
+    The pan is taken from the library, so only the move from the current head position to the start of the pan is calculated here.
  */
 void NUHead::calculateGenericPan(float mindistance, float maxdistance, float minyaw, float maxyaw, float panspeed)
 {
-    float minpitch, maxpitch;
-    calculateMinAndMaxPitch(mindistance, maxdistance, minpitch, maxpitch);
+    const PanTrajectory& pan = getPanTrajectory(mindistance, maxdistance, minyaw, maxyaw, panspeed);
+    int start = fabs(m_sensor_pitch - pan.MinPitch) < fabs(m_sensor_pitch - pan.MaxPitch) ? 0 : 1;      // start from the closest pitch
+    int side = m_sensor_yaw >= 0 ? 0 : 1;                                                               // start on the side we are on
+    const vector<vector<float> >& points = pan.Points[start][side];
+    const vector<double>& durations = pan.Durations[start][side];
+    
+    // if the yaw limits change between the current head position and the first pan level an extra point is needed
+    static vector<float> limitpoint(2,0);
+    bool haslimitpoint = not points.empty() and calculatePanLimitPoint(points[0][0], m_sensor_pitch, minyaw, maxyaw, side == 0, limitpoint);
+    unsigned int offset = haslimitpoint ? 1 : 0;
+    
+    m_pan_points.resize(points.size() + offset);
+    m_pan_times.resize(points.size() + offset);
+    if (haslimitpoint)
+        m_pan_points[0] = limitpoint;
+    for (unsigned int i=0; i<points.size(); i++)
+        m_pan_points[i + offset] = points[i];
+    
+    if (not m_pan_points.empty())
+    {
+        static vector<float> current(2,0);
+        current[0] = m_sensor_pitch;
+        current[1] = m_sensor_yaw;
+        float yawspeed = calculatePanYawSpeed(m_pan_points[0][0], panspeed, m_camera_height, m_body_pitch);
+        m_pan_times[0] = calculatePanDuration(current, m_pan_points[0], yawspeed) + m_data->CurrentTime;
+        if (haslimitpoint)
+        {
+            yawspeed = calculatePanYawSpeed(m_pan_points[1][0], panspeed, m_camera_height, m_body_pitch);
+            m_pan_times[1] = calculatePanDuration(m_pan_points[0], m_pan_points[1], yawspeed) + m_pan_times[0];
+        }
+        for (unsigned int i=1; i<points.size(); i++)
+            m_pan_times[i + offset] = durations[i] + m_pan_times[i + offset - 1];
+    }
+    
+    moveTo(m_pan_times, m_pan_points);
+}
+
+/*! @brief Returns the pan with the given parameters from the library, generating it if it is not already there.
+ 
+    The pans are generated for the current posture rounded to NUHEAD_PAN_HEIGHT_RESOLUTION and NUHEAD_PAN_PITCH_RESOLUTION,
+    so that small changes in the posture do not require a new pan.
+ */
+NUHead::PanTrajectory& NUHead::getPanTrajectory(float mindistance, float maxdistance, float minyaw, float maxyaw, float panspeed)
+{
+    float cameraheight = NUHEAD_PAN_HEIGHT_RESOLUTION*floor(m_camera_height/NUHEAD_PAN_HEIGHT_RESOLUTION + 0.5);
+    float bodypitch = NUHEAD_PAN_PITCH_RESOLUTION*floor(m_body_pitch/NUHEAD_PAN_PITCH_RESOLUTION + 0.5);
+    m_pan_library_clock++;
+    
+    int oldest = 0;
+    for (int i=0; i<NUHEAD_PAN_LIBRARY_SIZE; i++)
+    {
+        PanTrajectory& pan = m_pan_library[i];
+        if (pan.Valid and pan.MinDistance == mindistance and pan.MaxDistance == maxdistance and pan.MinYaw == minyaw and pan.MaxYaw == maxyaw 
+            and pan.PanSpeed == panspeed and pan.CameraHeight == cameraheight and pan.BodyPitch == bodypitch)
+        {
+            pan.LastUsed = m_pan_library_clock;
+            return pan;
+        }
+        if (pan.LastUsed < m_pan_library[oldest].LastUsed)
+            oldest = i;
+    }
     
-    vector<float> scan_levels = calculatePanLevels(minpitch, maxpitch);
-    vector<vector<float> > scan_points = calculatePanPoints(scan_levels, minyaw, maxyaw);
-    vector<double> times = calculatePanTimes(scan_points, panspeed);
+    PanTrajectory& pan = m_pan_library[oldest];
+    pan.MinDistance = mindistance;
+    pan.MaxDistance = maxdistance;
+    pan.MinYaw = minyaw;
+    pan.MaxYaw = maxyaw;
+    pan.PanSpeed = panspeed;
+    pan.CameraHeight = cameraheight;
+    pan.BodyPitch = bodypitch;
+    generatePanTrajectory(pan);
+    pan.Valid = true;
+    pan.LastUsed = m_pan_library_clock;
+    #if DEBUG_NUMOTION_VERBOSITY > 2
+        debug << "NUHead::getPanTrajectory(). Generated pan " << oldest << " for " << mindistance << "-" << maxdistance << "cm " << minyaw << "-" << maxyaw << "rad at " << panspeed << "cm/s" << endl;
+    #endif
+    return pan;
+}
+
+/*! @brief Generates the four versions of the pan from its parameters and posture
+ */
+void NUHead::generatePanTrajectory(PanTrajectory& pan)
+{
+    calculateMinAndMaxPitch(pan.MinDistance, pan.MaxDistance, pan.CameraHeight, pan.BodyPitch, pan.MinPitch, pan.MaxPitch);
     
-    moveTo(times, scan_points);
+    vector<float> levels;
+    for (int start=0; start<2; start++)
+    {
+        calculatePanLevels(pan.MinPitch, pan.MaxPitch, start == 0, levels);
+        for (int side=0; side<2; side++)
+        {
+            vector<vector<float> >& points = pan.Points[start][side];
+            vector<double>& durations = pan.Durations[start][side];
+            
+            points.clear();
+            bool onleft = side == 0;
+            for (unsigned int i=0; i<levels.size(); i++)
+                generateScan(levels[i], levels[i > 0 ? i-1 : 0], pan.MinYaw, pan.MaxYaw, onleft, points);
+            
+            durations.assign(points.size(), 0);
+            for (unsigned int i=1; i<points.size(); i++)
+            {
+                float yawspeed;
+                if (i+1 < points.size()-1 and getPanLimitIndex(points[i][0]) != getPanLimitIndex(points[i+1][0]))       // hack to move at max speed when changing pan limits
+                    yawspeed = m_max_speeds[1];
+                else
+                    yawspeed = calculatePanYawSpeed(points[i][0], pan.PanSpeed, pan.CameraHeight, pan.BodyPitch);
+                durations[i] = calculatePanDuration(points[i-1], points[i], yawspeed);
+            }
+        }
+    }
 }
 
 /*! @brief Gets relevant sensor data from the NUSensorsData; sets m_camera_height, m_body_pitch, and m_sensor_pitch, m_sensor_yaw
@@ -374,15 +488,14 @@ void NUHead::getSensorValues()
 
 /*! @brief Calculates evenly spaced pitch values to pan at based on the camera field of view
  
-    This function will automatically put the levels in the correct order based on the current head pitch
- 
     @param minpitch the lowest pan level in radians
     @param maxpitch the hight pan level in radians
-    @return a vector containing the ordered pan levels
+    @param fromminpitch true if the levels should start from the minpitch, false to start from the maxpitch
+    @param levels will be updated with the ordered pan levels
  */
-vector<float> NUHead::calculatePanLevels(float minpitch, float maxpitch)
+void NUHead::calculatePanLevels(float minpitch, float maxpitch, bool fromminpitch, vector<float>& levels)
 {
-    vector<float> levels;
+    levels.clear();
     // calculate scan lines required to scan the area between the min and max scan lines
     int numscans;       // the number of scans (pans)
     float spacing;      // the pitch spacing between each scan (radians)
@@ -397,34 +510,16 @@ vector<float> NUHead::calculatePanLevels(float minpitch, float maxpitch)
         spacing = (minpitch - maxpitch)/(numscans - 1);
     }
     
-    if (fabs(m_sensor_pitch - minpitch) < fabs(m_sensor_pitch - maxpitch))
-    {   // if we are closer to the minpitch position then start from the minpitch
+    if (fromminpitch)
+    {
         for (int i=0; i<numscans; i++)
             levels.push_back(minpitch - i*spacing);
     }
     else
-    {   // if we are closer to the maxpitch position then start from the maxpitch
+    {
         for (int i=0; i<numscans; i++)
             levels.push_back(maxpitch + i*spacing);
     }
-    return levels;
-}
-
-/*! @brief Calculates an ordered list of pan way points 
-    @param levels the pan levels (in radians)
-    @return a matrix containing [[pitch0, yaw0], [pitch1, yaw1], ...]
- */
-vector<vector<float> > NUHead::calculatePanPoints(const vector<float>& levels, float minyaw, float maxyaw)
-{
-    vector<vector<float> > points;
-    bool onleft = m_sensor_yaw >= 0;
-    
-    if (levels.size() > 0)
-        generateScan(levels[0], m_sensor_pitch, minyaw, maxyaw, onleft, points);
-    for (unsigned int i=1; i<levels.size(); i++)
-        generateScan(levels[i], levels[i-1], minyaw, maxyaw, onleft, points);
-
-    return points;
 }
 
 /*! @brief Calculates a single scan to the given pitch value
@@ -439,24 +534,10 @@ void NUHead::generateScan(float pitch, float previouspitch, float minyaw, float
     static vector<float> a(2,0);        // holds the first of the scan line
     static vector<float> b(2,0);        // holds the second of the scan line
     
-    int i = getPanLimitIndex(pitch);
-    int p = getPanLimitIndex(previouspitch);
-    if (i != p)
-    {   // if the yaw limits change add the extra point to stop the head from hitting the shoulder
-        if (i < p)
-            s[0] = m_pan_limits_pitch[i];
-        else
-            s[0] = m_pan_limits_pitch[p];
-        if (onleft)
-            s[1] = min(m_pan_limits_yaw[p][1], m_pan_limits_yaw[i][1]);
-        else
-            s[1] = max(m_pan_limits_yaw[p][0], m_pan_limits_yaw[i][0]);
-        
-        // now that we have made the point see if we actually need it by comparing it to the min and max yaw
-        if ((onleft and maxyaw > s[1]) or (not onleft and minyaw < s[1]))
-            scan.push_back(s);
-    }
+    if (calculatePanLimitPoint(pitch, previouspitch, minyaw, maxyaw, onleft, s))
+        scan.push_back(s);
     
+    int i = getPanLimitIndex(pitch);
     a[0] = pitch;
     b[0] = pitch;
     if (onleft)
@@ -474,43 +555,50 @@ void NUHead::generateScan(float pitch, float previouspitch, float minyaw, float
     onleft = !onleft;
 }
 
-/*! @brief Calculates the pan times based on the distance to the top of the scan line on the field
+/*! @brief Calculates the extra point needed to stop the head from hitting the shoulder when the yaw limits change between two pitch values
+    @param point will be updated with the extra [pitch, yaw] point
+    @return true if the extra point is needed
  */
-vector<double> NUHead::calculatePanTimes(const vector<vector<float> >& points, float panspeed)
+bool NUHead::calculatePanLimitPoint(float pitch, float previouspitch, float minyaw, float maxyaw, bool onleft, vector<float>& point)
 {
-    vector<double> times;
+    int i = getPanLimitIndex(pitch);
+    int p = getPanLimitIndex(previouspitch);
+    if (i == p)
+        return false;
     
-    float distance, yawspeed, yawtime, pitchtime;
-    if (points.size() > 0)
-    {
-        float ratio_hl = tan(points[0][0] + m_CAMERA_OFFSET - 0.5*m_CAMERA_FOV_Y + m_body_pitch);
-        if (ratio_hl < 0.05)            // need to be careful here to avoid divide by zero, and VERY slow pan when the distance is close to infinity
-            distance = 1.1*m_FIELD_DIAGONAL;
-        else
-            distance = m_camera_height/ratio_hl;
-        yawspeed = min(panspeed/distance, m_max_speeds[1]);
-        yawtime = fabs(points[0][1] - m_sensor_yaw)/yawspeed;
-        pitchtime = fabs(points[0][0] - m_sensor_pitch)/m_max_speeds[0];
-        times.push_back(1000*max(yawtime, pitchtime) + m_data->CurrentTime);
-    }
-    for (unsigned int i=1; i<points.size(); i++)
-    {
-        if (i+1 < points.size()-1 and getPanLimitIndex(points[i][0]) != getPanLimitIndex(points[i+1][0]))       // hack to move at max speed when changing pan limits
-            yawspeed = m_max_speeds[1];
-        else
-        {
-            float ratio_hl = tan(points[i][0] + m_CAMERA_OFFSET - 0.5*m_CAMERA_FOV_Y + m_body_pitch);
-            if (ratio_hl < 0.05)        // need to be careful here to avoid divide by zero, and VERY slow pan when the distance is close to infinity
-                distance = 1.1*m_FIELD_DIAGONAL;
-            else
-                distance = m_camera_height/ratio_hl;
-            yawspeed = min(panspeed/distance, m_max_speeds[1]);
-        }
-        yawtime = fabs(points[i][1] - points[i-1][1])/yawspeed;
-        pitchtime = fabs(points[i][0] - points[i-1][0])/m_max_speeds[0];
-        times.push_back(1000*max(yawtime, pitchtime) + times[i-1]);
-    }
-    return times;
+    if (i < p)
+        point[0] = m_pan_limits_pitch[i];
+    else
+        point[0] = m_pan_limits_pitch[p];
+    if (onleft)
+        point[1] = min(m_pan_limits_yaw[p][1], m_pan_limits_yaw[i][1]);
+    else
+        point[1] = max(m_pan_limits_yaw[p][0], m_pan_limits_yaw[i][0]);
+    
+    // now that we have made the point see if we actually need it by comparing it to the min and max yaw
+    return (onleft and maxyaw > point[1]) or (not onleft and minyaw < point[1]);
+}
+
+/*! @brief Returns the yaw speed (rad/s) for a pan at the given pitch, based on the distance to the top of the scan line on the field
+ */
+float NUHead::calculatePanYawSpeed(float pitch, float panspeed, float cameraheight, float bodypitch)
+{
+    float distance;
+    float ratio_hl = tan(pitch + m_CAMERA_OFFSET - 0.5*m_CAMERA_FOV_Y + bodypitch);
+    if (ratio_hl < 0.05)            // need to be careful here to avoid divide by zero, and VERY slow pan when the distance is close to infinity
+        distance = 1.1*m_FIELD_DIAGONAL;
+    else
+        distance = cameraheight/ratio_hl;
+    return min(panspeed/distance, m_max_speeds[1]);
+}
+
+/*! @brief Returns the time in ms to move between two [pitch, yaw] points with the given yaw speed and the maximum pitch speed
+ */
+double NUHead::calculatePanDuration(const vector<float>& from, const vector<float>& to, float yawspeed)
+{
+    float yawtime = fabs(to[1] - from[1])/yawspeed;
+    float pitchtime = fabs(to[0] - from[0])/m_max_speeds[0];
+    return 1000*max(yawtime, pitchtime);
 }
 
 /*! @brief Returns the index into the pan limit vectors for the given pitch value
@@ -580,7 +668,7 @@ void NUHead::calculateLocalisationNod()
 void NUHead::calculateGenericNod(float mindistance, float maxdistance, float nodspeed)
 {
     float minpitch, maxpitch;
-    calculateMinAndMaxPitch(mindistance, maxdistance, minpitch, maxpitch);
+    calculateMinAndMaxPitch(mindistance, maxdistance, m_camera_height, m_body_pitch, minpitch, maxpitch);
     vector<vector<float> > points = calculateNodPoints(minpitch, maxpitch);
     vector<double> times = calculateNodTimes(points, nodspeed);
     
@@ -644,6 +732,7 @@ void NUHead::load()
 {
     loadConfig();
     loadPanConfig();
+    loadPanLibrary();
 }
 
 /*! @brief Loads the maximum speed, maximum acceleration, and default gains from Head.cfg
@@ -706,5 +795,13 @@ void NUHead::loadPanConfig()
     }
 }
 
-
-
+/*! @brief Generates the default pans for each pan type, so that they are ready before the first pan job arrives
+ */
+void NUHead::loadPanLibrary()
+{
+    if (m_pan_limits_yaw.empty())
+        return;
+    getPanTrajectory(m_BALL_SIZE, 1.1*m_FIELD_DIAGONAL, m_yaw_limits[0], m_yaw_limits[1], m_pan_ball_speed);
+    getPanTrajectory(m_BALL_SIZE, 1e10, m_yaw_limits[0], m_yaw_limits[1], min(m_pan_ball_speed, m_pan_localisation_speed));
+    getPanTrajectory(120, 1e10, m_yaw_limits[0], m_yaw_limits[1], m_pan_localisation_speed);
+}
@@ -36,6 +36,10 @@ class HeadTrackJob;
 
 #include <vector>
 
+#define NUHEAD_PAN_LIBRARY_SIZE 8               //!< the number of pan trajectories kept in the library
+#define NUHEAD_PAN_HEIGHT_RESOLUTION 1.0        //!< the camera height resolution (cm) of the library's trajectories
+#define NUHEAD_PAN_PITCH_RESOLUTION 0.02        //!< the body pitch resolution (rad) of the library's trajectories
+
 class NUHead : public NUMotionProvider
 {
 public:
@@ -76,11 +80,32 @@ private:
     void calculateGenericPan(float mindistance, float maxdistance, float minyaw, float maxyaw, float panspeed);
     
     void getSensorValues();
-    void calculateMinAndMaxPitch(float mindistance, float maxdistance, float& minpitch, float& maxpitch);
-    vector<float> calculatePanLevels(float minpitch, float maxpitch);
-    vector<vector<float> > calculatePanPoints(const vector<float>& levels, float minyaw, float maxyaw);
+    void calculateMinAndMaxPitch(float mindistance, float maxdistance, float cameraheight, float bodypitch, float& minpitch, float& maxpitch);
+    
+    /*! @brief A pan over one distance band, generated once and then reused by every pan job that asks for it.
+     
+        There are four versions of the pan, one for each combination of starting at the min or max pitch and starting on
+        the left or right. None of them include the move from the current head position, which is added when the pan is used.
+     */
+    struct PanTrajectory
+    {
+        bool Valid;                                     //!< false until the trajectory has been generated
+        float MinDistance, MaxDistance;                 //!< the distances (cm) the pan is for
+        float MinYaw, MaxYaw;                           //!< the yaw range (rad) the pan is for
+        float PanSpeed;                                 //!< the pan speed (cm/s) the pan is for
+        float CameraHeight, BodyPitch;                  //!< the posture the pan was generated for
+        float MinPitch, MaxPitch;                       //!< the first pan level when starting from the min or max pitch
+        vector<vector<float> > Points[2][2];            //!< the way points [start from min or max pitch][start on left or right]
+        vector<double> Durations[2][2];                 //!< the time (ms) to reach each way point from the previous one. The first is not used
+        unsigned int LastUsed;                          //!< the value of m_pan_library_clock when the pan was last used
+    };
+    PanTrajectory& getPanTrajectory(float mindistance, float maxdistance, float minyaw, float maxyaw, float panspeed);
+    void generatePanTrajectory(PanTrajectory& pan);
+    void calculatePanLevels(float minpitch, float maxpitch, bool fromminpitch, vector<float>& levels);
     void generateScan(float pitch, float previouspitch, float minyaw, float maxyaw, bool& onleft, vector<vector<float> >& scan);
-    vector<double> calculatePanTimes(const vector<vector<float> >& points, float panspeed);
+    bool calculatePanLimitPoint(float pitch, float previouspitch, float minyaw, float maxyaw, bool onleft, vector<float>& point);
+    float calculatePanYawSpeed(float pitch, float panspeed, float cameraheight, float bodypitch);
+    double calculatePanDuration(const vector<float>& from, const vector<float>& to, float yawspeed);
     int getPanLimitIndex(float pitch);
     bool panYawLimitsChange(float pitch_a, float pitch_b);
     
@@ -95,6 +120,7 @@ private:
     void load();
     void loadConfig();
     void loadPanConfig();
+    void loadPanLibrary();
 
 private:
     float m_camera_height;                      //!< the camera height in cm
@@ -117,6 +143,10 @@ private:
     vector<vector<float> > m_pan_limits_yaw;    //!< the yaw limits of the pan (Loaded from HeadPan.cfg)
     float m_x_min, m_x_max;                     //!< the minimum and maximum distances to use for a pan when m_pan_default_values is false
     float m_yaw_min, m_yaw_max;                 //!< the minimum and maximum distances to use for a pan when m_pan_default_values is false
+    PanTrajectory m_pan_library[NUHEAD_PAN_LIBRARY_SIZE];  //!< the pans generated so far; the least recently used is replaced when a new one is needed
+    unsigned int m_pan_library_clock;           //!< incremented each time a pan is taken from the library
+    vector<vector<float> > m_pan_points;        //!< the way points of the current pan, including the move from the head position
+    vector<double> m_pan_times;                 //!< the times (ms) of the way points of the current pan
     
     bool m_is_nodding;                          //!< true if we are currently nodding the head
     HeadNodJob::head_nod_t m_nod_type;          //!< the type of nod we are currently performing
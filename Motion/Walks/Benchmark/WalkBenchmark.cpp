@@ -0,0 +1,295 @@
+/*! @file WalkBenchmark.cpp
+    @brief Implementation of WalkBenchmark class
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "WalkBenchmark.h"
+#include "Motion/NUWalk.h"
+#include "Infrastructure/NUSensorsData/NUSensorsData.h"
+#include "Infrastructure/NUActionatorsData/NUActionatorsData.h"
+#include "Infrastructure/Jobs/MotionJobs/WalkJob.h"
+
+#include "debug.h"
+#include "debugverbositynumotion.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <cmath>
+
+size_t WalkBenchmark::AllocationCount = 0;
+
+/*! @brief Constructs a blank platform with a simulated clock starting at zero */
+WalkBenchmarkPlatform::WalkBenchmarkPlatform() : NUPlatform()
+{
+    m_simulated_time = 0;
+    init();
+}
+
+WalkBenchmarkPlatform::~WalkBenchmarkPlatform()
+{
+}
+
+/*! @brief Returns the simulated time in milliseconds */
+double WalkBenchmarkPlatform::getTime()
+{
+    return m_simulated_time;
+}
+
+/*! @brief Sets the simulated time
+    @param time the new simulated time in milliseconds
+ */
+void WalkBenchmarkPlatform::setTime(double time)
+{
+    m_simulated_time = time;
+}
+
+/*! @brief Constructs a WalkBenchmark
+    @param platform the platform providing the simulated clock
+    @param walk the walk engine to benchmark
+    @param data the synthetic sensor data; it must already have its joints added
+    @param actions the synthetic actionator data; it must already have its joints added
+    @param period the simulated motion period in ms
+ */
+WalkBenchmark::WalkBenchmark(WalkBenchmarkPlatform* platform, NUWalk* walk, NUSensorsData* data, NUActionatorsData* actions, double period)
+{
+    m_platform = platform;
+    m_walk = walk;
+    m_data = data;
+    m_actions = actions;
+    m_period = period;
+    m_current_time = 0;
+
+    m_joint_ids = m_data->mapIdToIds(NUSensorsData::All);
+    m_joint_sensor = vector<float>(NUSensorsData::NumJointSensorIndices, numeric_limits<float>::quiet_NaN());
+    m_position_history = vector<vector<float> >(3, vector<float>(m_joint_ids.size(), 0));
+    m_num_history = 0;
+}
+
+WalkBenchmark::~WalkBenchmark()
+{
+}
+
+/*! @brief Appends a segment to the speed profile
+    @param name a short description of the segment
+    @param duration the length of the segment in seconds
+    @param translationspeed the translation speed fraction (-1 to 1)
+    @param direction the translation direction in radians
+    @param rotationspeed the rotation speed in rad/s
+ */
+void WalkBenchmark::addSegment(const string& name, float duration, float translationspeed, float direction, float rotationspeed)
+{
+    ProfileSegment segment;
+    segment.Name = name;
+    segment.Duration = duration;
+    segment.TranslationSpeed = translationspeed;
+    segment.Direction = direction;
+    segment.RotationSpeed = rotationspeed;
+    m_profile.push_back(segment);
+}
+
+/*! @brief Loads the default profile. It starts and stops, walks in each direction and finishes with
+           rapid changes in the target speed, which is usually where the engines produce the most jerk.
+ */
+void WalkBenchmark::loadDefaultProfile()
+{
+    m_profile.clear();
+    addSegment("stand", 2, 0, 0, 0);
+    addSegment("forward", 5, 1, 0, 0);
+    addSegment("backward", 3, 1, 3.1416, 0);
+    addSegment("sideward", 3, 1, 1.5708, 0);
+    addSegment("turn", 3, 0, 0, 1);
+    addSegment("arc", 4, 1, 0.3, 0.5);
+    for (int i=0; i<6; i++)
+    {
+        addSegment("switch", 0.5, 1, 0, 0);
+        addSegment("switch", 0.5, 1, -1.5708, -0.5);
+    }
+    addSegment("stop", 2, 0, 0, 0);
+}
+
+/*! @brief Loads a profile from a stream. Each non-empty line not starting with a '#' is a segment:
+           name duration(s) translationspeed direction(rad) rotationspeed(rad/s)
+    @param input the stream to read the profile from
+    @return true if at least one segment was loaded
+ */
+bool WalkBenchmark::loadProfile(istream& input)
+{
+    m_profile.clear();
+    string line;
+    while (getline(input, line))
+    {
+        if (line.empty() or line[0] == '#')
+            continue;
+        stringstream ss(line);
+        ProfileSegment segment;
+        if (ss >> segment.Name >> segment.Duration >> segment.TranslationSpeed >> segment.Direction >> segment.RotationSpeed)
+            m_profile.push_back(segment);
+        else
+            errorlog << "WalkBenchmark::loadProfile. Unable to parse: " << line << endl;
+    }
+    return not m_profile.empty();
+}
+
+/*! @brief Runs the walk engine through the entire speed profile */
+void WalkBenchmark::run()
+{
+    reset();
+
+    size_t totalticks = 0;
+    for (size_t i=0; i<m_profile.size(); i++)
+        totalticks += static_cast<size_t>(1000*m_profile[i].Duration/m_period);
+    m_latencies.reserve(totalticks);
+    m_allocations.reserve(totalticks);
+    m_jerks.reserve(totalticks);
+
+    for (size_t i=0; i<m_profile.size(); i++)
+    {
+        const ProfileSegment& segment = m_profile[i];
+        #if DEBUG_NUMOTION_VERBOSITY > 0
+            debug << "WalkBenchmark::run(). Segment " << segment.Name << " at " << m_current_time << endl;
+        #endif
+        WalkJob job(segment.TranslationSpeed, segment.Direction, segment.RotationSpeed);
+        m_walk->process(&job, true);
+
+        size_t ticks = static_cast<size_t>(1000*segment.Duration/m_period);
+        for (size_t j=0; j<ticks; j++)
+        {
+            m_current_time += m_period;
+            m_platform->setTime(m_current_time);
+            updateSensors();
+
+            size_t allocations = AllocationCount;
+            double start = m_platform->getRealTime();
+            m_walk->process(m_data, m_actions);
+            double stop = m_platform->getRealTime();
+            m_latencies.push_back(1000*(stop - start));
+            m_allocations.push_back(AllocationCount - allocations);
+
+            updateActions();
+        }
+    }
+}
+
+/*! @brief Clears the previous results and returns the synthetic robot to time zero */
+void WalkBenchmark::reset()
+{
+    m_current_time = 0;
+    m_platform->setTime(0);
+    m_num_history = 0;
+    m_latencies.clear();
+    m_allocations.clear();
+    m_jerks.clear();
+}
+
+/*! @brief Updates the synthetic sensor data. The servos are perfect so the joint positions are the
+           positions sent to the hardware on the previous tick.
+ */
+void WalkBenchmark::updateSensors()
+{
+    m_data->PreviousTime = m_data->CurrentTime;
+    m_data->CurrentTime = m_current_time;
+
+    const float dt = m_period/1000.0;
+    for (size_t i=0; i<m_joint_ids.size(); i++)
+    {
+        float position = m_num_history > 0 ? m_position_history[0][i] : 0;
+        float previous = m_num_history > 1 ? m_position_history[1][i] : position;
+        m_joint_sensor[NUSensorsData::PositionId] = position;
+        m_joint_sensor[NUSensorsData::VelocityId] = (position - previous)/dt;
+        m_joint_sensor[NUSensorsData::TargetId] = position;
+        m_joint_sensor[NUSensorsData::StiffnessId] = 100;
+        m_data->set(*m_joint_ids[i], m_current_time, m_joint_sensor);
+    }
+}
+
+/*! @brief Extracts the joint positions that would be sent to the hardware this tick, and calculates the
+           rms jerk over all of the joints.
+ */
+void WalkBenchmark::updateActions()
+{
+    m_actions->preProcess(m_current_time);
+    m_actions->getNextServos(m_positions, m_gains);
+    m_actions->postProcess();
+
+    size_t n = min(m_positions.size(), m_joint_ids.size());
+    if (m_num_history >= 3)
+    {
+        const float dt = m_period/1000.0;
+        float sum = 0;
+        for (size_t i=0; i<n; i++)
+        {   // the third backward difference p[t] - 3p[t-1] + 3p[t-2] - p[t-3]
+            float jerk = (m_positions[i] - 3*m_position_history[0][i] + 3*m_position_history[1][i] - m_position_history[2][i])/(dt*dt*dt);
+            if (not isnan(jerk))
+                sum += jerk*jerk;
+        }
+        m_jerks.push_back(sqrt(sum/n));
+    }
+
+    // shift the history along without reallocating; the oldest buffer becomes the newest
+    m_position_history[2].swap(m_position_history[1]);
+    m_position_history[1].swap(m_position_history[0]);
+    for (size_t i=0; i<n; i++)
+        m_position_history[0][i] = isnan(m_positions[i]) ? m_position_history[1][i] : m_positions[i];
+    if (m_num_history < 3)
+        m_num_history++;
+}
+
+/*! @brief Returns the p-th percentile of a sorted vector
+    @param sorted the sorted values
+    @param p the percentile (0 to 100)
+ */
+float WalkBenchmark::percentile(vector<float>& sorted, float p) const
+{
+    if (sorted.empty())
+        return 0;
+    size_t index = static_cast<size_t>(p/100*(sorted.size() - 1) + 0.5);
+    return sorted[index];
+}
+
+/*! @brief Prints a summary of the benchmark results
+    @relates WalkBenchmark
+ */
+ostream& operator<<(ostream& output, const WalkBenchmark& benchmark)
+{
+    vector<float> latencies(benchmark.m_latencies);
+    vector<float> allocations(benchmark.m_allocations);
+    vector<float> jerks(benchmark.m_jerks);
+    sort(latencies.begin(), latencies.end());
+    sort(allocations.begin(), allocations.end());
+    sort(jerks.begin(), jerks.end());
+
+    float meanlatency = 0, meanallocations = 0, meanjerk = 0;
+    for (size_t i=0; i<latencies.size(); i++)
+        meanlatency += latencies[i]/latencies.size();
+    for (size_t i=0; i<allocations.size(); i++)
+        meanallocations += allocations[i]/allocations.size();
+    for (size_t i=0; i<jerks.size(); i++)
+        meanjerk += jerks[i]/jerks.size();
+
+    output << fixed << setprecision(2);
+    output << "ticks: " << latencies.size() << " period: " << benchmark.m_period << "ms" << endl;
+    output << "latency (us)    mean: " << meanlatency << " min: " << benchmark.percentile(latencies, 0) << " p50: " << benchmark.percentile(latencies, 50);
+    output << " p90: " << benchmark.percentile(latencies, 90) << " p99: " << benchmark.percentile(latencies, 99) << " max: " << benchmark.percentile(latencies, 100) << endl;
+    output << "allocations     mean: " << meanallocations << " p50: " << benchmark.percentile(allocations, 50) << " max: " << benchmark.percentile(allocations, 100) << endl;
+    output << "jerk (rad/s^3)  mean: " << meanjerk << " p50: " << benchmark.percentile(jerks, 50) << " p99: " << benchmark.percentile(jerks, 99) << " max: " << benchmark.percentile(jerks, 100) << endl;
+    return output;
+}
+
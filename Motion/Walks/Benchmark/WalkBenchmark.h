@@ -0,0 +1,119 @@
+/*! @file WalkBenchmark.h
+    @brief Declaration of WalkBenchmark class
+
+    @class WalkBenchmark
+    @brief A headless harness to measure the cost and smoothness of a walk engine
+
+    The walk engine is run against a synthetic NUSensorsData/NUActionatorsData pair. The servos
+    are modelled as perfect, that is the sensed joint positions are exactly the positions that were
+    sent to the 'hardware' on the previous tick. A scripted speed profile is fed into the walk through
+    WalkJobs, so the speeds are clipped and accelerated by NUWalk::setTargetSpeed exactly as on the robot.
+
+    For each call to NUWalk::process we record the latency, the number of heap allocations and the
+    joint-trajectory jerk (third difference of the joint positions sent to the hardware).
+
+    The simulated clock is provided by a WalkBenchmarkPlatform, so the benchmark runs as fast as the
+    walk engine allows while the engine still sees a perfectly periodic motion loop.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef WALKBENCHMARK_H
+#define WALKBENCHMARK_H
+
+#include "NUPlatform/NUPlatform.h"
+#include "Infrastructure/NUData.h"
+class NUWalk;
+class NUSensorsData;
+class NUActionatorsData;
+
+#include <string>
+#include <vector>
+#include <iostream>
+using namespace std;
+
+/*! @brief A blank platform whose getTime() is driven by the benchmark instead of the wall clock */
+class WalkBenchmarkPlatform : public NUPlatform
+{
+public:
+    WalkBenchmarkPlatform();
+    ~WalkBenchmarkPlatform();
+
+    double getTime();
+    void setTime(double time);
+private:
+    double m_simulated_time;                        //!< the current simulated time in ms
+};
+
+class WalkBenchmark
+{
+public:
+    /*! @brief A single segment of a scripted speed profile. The arguments are those of a WalkJob */
+    struct ProfileSegment
+    {
+        string Name;                                //!< a short description of the segment
+        float Duration;                             //!< the length of the segment in seconds
+        float TranslationSpeed;                     //!< the translation speed fraction (-1 to 1)
+        float Direction;                            //!< the translation direction in radians
+        float RotationSpeed;                        //!< the rotation speed in rad/s
+    };
+
+    WalkBenchmark(WalkBenchmarkPlatform* platform, NUWalk* walk, NUSensorsData* data, NUActionatorsData* actions, double period = 10);
+    ~WalkBenchmark();
+
+    void addSegment(const string& name, float duration, float translationspeed, float direction, float rotationspeed);
+    void loadDefaultProfile();
+    bool loadProfile(istream& input);
+
+    void run();
+
+    friend ostream& operator<<(ostream& output, const WalkBenchmark& benchmark);
+public:
+    static size_t AllocationCount;                  //!< incremented by the executable's operator new; the benchmark only reads it
+private:
+    void updateSensors();
+    void updateActions();
+    void reset();
+
+    float percentile(vector<float>& sorted, float p) const;
+
+private:
+    WalkBenchmarkPlatform* m_platform;              //!< the platform providing the simulated clock
+    NUWalk* m_walk;                                 //!< the walk engine under test
+    NUSensorsData* m_data;                          //!< the synthetic sensor data
+    NUActionatorsData* m_actions;                   //!< the synthetic actionator data
+    double m_period;                                //!< the simulated motion period in ms
+    double m_current_time;                          //!< the current simulated time in ms
+
+    vector<ProfileSegment> m_profile;               //!< the scripted speed profile
+    vector<NUData::id_t*> m_joint_ids;              //!< the ids of every joint on the synthetic robot
+
+    vector<float> m_positions;                      //!< the joint positions sent to the hardware this tick
+    vector<float> m_gains;                          //!< the joint gains sent to the hardware this tick
+    vector<vector<float> > m_position_history;      //!< the joint positions sent on the previous three ticks [t-1, t-2, t-3]
+    vector<float> m_joint_sensor;                   //!< a preallocated single joint's sensor vector
+    size_t m_num_history;                           //!< the number of valid entries in m_position_history
+
+    // the results
+    vector<float> m_latencies;                      //!< the latency of each call to NUWalk::process in us
+    vector<float> m_allocations;                    //!< the number of heap allocations in each call to NUWalk::process
+    vector<float> m_jerks;                          //!< the rms joint jerk on each tick in rad/s^3
+};
+
+#endif
+
@@ -0,0 +1,38 @@
+# A CMake file for the walk engine benchmark
+#   - the benchmark is a separate executable, so its sources go into WALKBENCHMARK_SRCS not NUBOT_SRCS
+#   - it is built from all of the nubot sources except the platform specific ones and the NUbot itself
+#
+#    Copyright (c) 2026 agent
+#    This file is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This file is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+
+IF(DEBUG)
+    MESSAGE(STATUS ${CMAKE_CURRENT_LIST_FILE})
+ENDIF()
+
+########## List your source files here! ############################################
+SET (YOUR_SRCS  WalkBenchmark.cpp WalkBenchmark.h
+                walkbenchmark.cpp
+)
+####################################################################################
+
+# I need to prefix each file and directory with the correct path
+STRING(REPLACE "/cmake/sources.cmake" "" THIS_SRC_DIR ${CMAKE_CURRENT_LIST_FILE})
+
+SET(WALKBENCHMARK_SRCS )
+FOREACH(loop_var ${NUBOT_SRCS})
+    IF(NOT ${loop_var} MATCHES "/NUPlatform/Platforms/" AND NOT ${loop_var} MATCHES "/NUbot[./]")
+        LIST(APPEND WALKBENCHMARK_SRCS ${loop_var})
+    ENDIF()
+ENDFOREACH(loop_var ${NUBOT_SRCS})
+
+FOREACH(loop_var ${YOUR_SRCS}) 
+    LIST(APPEND WALKBENCHMARK_SRCS "${THIS_SRC_DIR}/${loop_var}" )
+ENDFOREACH(loop_var ${YOUR_SRCS})
@@ -0,0 +1,160 @@
+/*! @file walkbenchmark.cpp
+    @brief The walkbenchmark executable. Runs the configured walk engine headlessly through a speed profile.
+
+    Usage: walkbenchmark [profile file] [period in ms]
+
+    The walk engine is selected at compile time exactly as on the robot (NUWalk::getWalkEngine). To compare
+    engines, configure a build for each NUBOT_USE_MOTION_WALK_* option with NUBOT_BUILD_WALK_BENCHMARK ON.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "WalkBenchmark.h"
+#include "Motion/NUWalk.h"
+#include "Infrastructure/NUBlackboard.h"
+#include "Infrastructure/NUSensorsData/NUSensorsData.h"
+#include "Infrastructure/NUActionatorsData/NUActionatorsData.h"
+
+#include "debug.h"
+#include "targetconfig.h"
+#include "walkconfig.h"
+
+#include <cstdlib>
+#include <new>
+using namespace std;
+
+ofstream debug;
+ofstream errorlog;
+
+// Every heap allocation in the executable is counted, so that the benchmark can report allocations per tick
+void* operator new(size_t size)
+{
+    WalkBenchmark::AllocationCount++;
+    void* p = malloc(size == 0 ? 1 : size);
+    if (p == NULL)
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* p) throw()
+{
+    free(p);
+}
+
+void operator delete[](void* p) throw()
+{
+    free(p);
+}
+
+// The joints of the synthetic robot are those of the target platform
+#if defined(TARGET_IS_BEAR)
+static string temp_joint_names[] = {string("HeadPitch"), string("HeadYaw"), string("NeckPitch"), \
+                                    string("LShoulderRoll"), string("LShoulderPitch"), string("LElbowRoll"), \
+                                    string("RShoulderRoll"), string("RShoulderPitch"), string("RElbowRoll"), \
+                                    string("TorsoRoll"), string("TorsoYaw"), \
+                                    string("LHipRoll"),  string("LHipPitch"), string("LKneePitch"), string("LAnkleRoll"), string("LAnklePitch"), \
+                                    string("RHipRoll"),  string("RHipPitch"), string("RKneePitch"), string("RAnkleRoll"), string("RAnklePitch")};
+#elif defined(TARGET_IS_CYCLOID)
+static string temp_joint_names[] = {string("HeadYaw"), \
+                                    string("LShoulderRoll"), string("LShoulderPitch"), string("LElbowRoll"), string("LElbowYaw"), \
+                                    string("RShoulderRoll"), string("RShoulderPitch"), string("RElbowRoll"), string("RElbowYaw"), \
+                                    string("TorsoRoll"), string("TorsoPitch"), \
+                                    string("LHipRoll"),  string("LHipPitch"), string("LHipYaw"), string("LKneePitch"), string("LAnkleRoll"), string("LAnklePitch"), \
+                                    string("RHipRoll"),  string("RHipPitch"), string("RHipYaw"), string("RKneePitch"), string("RAnkleRoll"), string("RAnklePitch")};
+#else
+static string temp_joint_names[] = {string("HeadPitch"), string("HeadYaw"), \
+                                    string("LShoulderRoll"), string("LShoulderPitch"), string("LElbowRoll"), string("LElbowYaw"), \
+                                    string("RShoulderRoll"), string("RShoulderPitch"), string("RElbowRoll"), string("RElbowYaw"), \
+                                    string("LHipRoll"),  string("LHipPitch"), string("LHipYawPitch"), string("LKneePitch"), string("LAnkleRoll"), string("LAnklePitch"), \
+                                    string("RHipRoll"),  string("RHipPitch"), string("RHipYawPitch"), string("RKneePitch"), string("RAnkleRoll"), string("RAnklePitch")};
+#endif
+static vector<string> joint_names(temp_joint_names, temp_joint_names + sizeof(temp_joint_names)/sizeof(*temp_joint_names));
+
+/*! @brief Returns the name of the walk engine selected by walkconfig.h */
+static string walkEngineName()
+{
+    #if defined(USE_JWALK)
+        return "JWalk";
+    #elif defined(USE_JUPPWALK)
+        return "JuppWalk";
+    #elif defined(USE_NBWALK)
+        return "NBWalk";
+    #elif defined(USE_ALWALK)
+        return "ALWalk";
+    #elif defined(USE_VSCWALK)
+        return "VSCWalk";
+    #elif defined(USE_BEARWALK)
+        return "BearWalk";
+    #else
+        return "None";
+    #endif
+}
+
+int main(int argc, const char *argv[])
+{
+    debug.open("walkbenchmarkdebug.log");
+    errorlog.open("walkbenchmarkerror.log");
+
+    WalkBenchmarkPlatform* platform = new WalkBenchmarkPlatform();
+    NUBlackboard* blackboard = new NUBlackboard();
+    NUSensorsData* data = new NUSensorsData();
+    NUActionatorsData* actions = new NUActionatorsData();
+    data->addSensors(joint_names);
+    actions->addActionators(joint_names);
+    blackboard->add(data);
+    blackboard->add(actions);
+
+    NUWalk* walk = NUWalk::getWalkEngine(data, actions);
+    if (walk == NULL)
+    {
+        cerr << "walkbenchmark: no walk engine is configured. Turn on one of NUBOT_USE_MOTION_WALK_*" << endl;
+        return 1;
+    }
+
+    double period = 10;
+    if (argc > 2)
+        period = atof(argv[2]);
+
+    WalkBenchmark benchmark(platform, walk, data, actions, period);
+    if (argc > 1)
+    {
+        ifstream file(argv[1]);
+        if (not benchmark.loadProfile(file))
+        {
+            cerr << "walkbenchmark: unable to load a profile from " << argv[1] << endl;
+            return 1;
+        }
+    }
+    else
+        benchmark.loadDefaultProfile();
+
+    benchmark.run();
+    cout << walkEngineName() << endl;
+    cout << benchmark;
+
+    delete walk;
+    delete blackboard;
+    delete platform;
+    return 0;
+}
+
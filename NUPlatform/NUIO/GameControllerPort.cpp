@@ -35,12 +35,14 @@ using namespace std;
 GameControllerPort::GameControllerPort(GameInformation* nubotgameinformation): UdpPort(std::string("GameControllerPort"), GAMECONTROLLER_PORT)
 {
     m_game_information = nubotgameinformation;
+    listen();
 }
 
 /*! @brief Closes the job port
  */
 GameControllerPort::~GameControllerPort()
 {
+    unlisten();
 }
 
 /*! @brief Send game controller return packet */
@@ -57,12 +59,12 @@ void GameControllerPort::sendReturnPacket(RoboCupGameControlReturnData* data)
 /*! @brief Copies the received data into the public nubot joblist
     @param buffer containing the joblist
 */
-void GameControllerPort::handleNewData(std::stringstream& buffer)
+void GameControllerPort::handleNewData(std::istream& buffer)
 {
-    string s_buffer = buffer.str();
-    if (s_buffer.size() == sizeof(RoboCupGameControlData))
+    if (buffer.rdbuf()->in_avail() == sizeof(RoboCupGameControlData))
     {   // discard game controller packets that are the wrong size
-        RoboCupGameControlData* gcpacket = (RoboCupGameControlData*) s_buffer.c_str();
-        (*m_game_information) << gcpacket;
+        RoboCupGameControlData gcpacket;
+        buffer.read(reinterpret_cast<char*>(&gcpacket), sizeof(gcpacket));
+        (*m_game_information) << &gcpacket;
     }
 }
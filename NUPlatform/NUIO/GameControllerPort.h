@@ -36,7 +36,7 @@ public:
     
     void sendReturnPacket(RoboCupGameControlReturnData* data);
 private:
-    void handleNewData(std::stringstream& buffer);
+    void handleNewData(std::istream& buffer);
 public:
 private:
     GameInformation* m_game_information;
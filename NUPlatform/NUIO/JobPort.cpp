@@ -35,12 +35,14 @@ JobPort::JobPort(JobList* nubotjobs): UdpPort(string("JobPort"), JOBS_PORT, true
         debug << "JobPort::JobPort(" << nubotjobs << ")" << endl;
     #endif
     m_jobs = nubotjobs;
+    listen();
 }
 
 /*! @brief Closes the job port
  */
 JobPort::~JobPort()
 {
+    unlisten();
 #if DEBUG_NETWORK_VERBOSITY > 0
     debug << "JobPort::~JobPort()" << endl;
 #endif
@@ -91,7 +93,7 @@ JobPort& operator<<(JobPort& port, JobList* jobs)
 /*! @brief Copies the received data into the public nubot joblist
     @param buffer containing the joblist
 */
-void JobPort::handleNewData(std::stringstream& buffer)
+void JobPort::handleNewData(std::istream& buffer)
 {
     #if DEBUG_NETWORK_VERBOSITY > 0
         debug << "JobPort::handleNewData()" << endl;
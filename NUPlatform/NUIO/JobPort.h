@@ -41,7 +41,7 @@ public:
     friend JobPort& operator<<(JobPort& port, JobList& jobs);
     friend JobPort& operator<<(JobPort& port, JobList* jobs);
 private:
-    void handleNewData(std::stringstream& buffer);
+    void handleNewData(std::istream& buffer);
 public:
 private:
     JobList* m_jobs;
@@ -0,0 +1,219 @@
+/*! @file NetworkReactor.cpp
+    @brief Implementation of NetworkReactor class.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "NetworkReactor.h"
+#include "UdpPort.h"
+
+#include "debug.h"
+#include "debugverbositynetwork.h"
+
+#ifdef NETWORKREACTOR_USE_EPOLL
+    #include <sys/epoll.h>
+    #include <unistd.h>
+#elif !defined(WIN32)
+    #include <sys/select.h>
+#endif
+#include <errno.h>
+#include <algorithm>
+using namespace std;
+
+NetworkReactor* NetworkReactor::m_instance = NULL;
+pthread_once_t NetworkReactor::m_instance_once = PTHREAD_ONCE_INIT;
+
+/*! @brief Returns the network reactor, creating and starting it if this is the first call. 
+           The ports are created by several threads, so the first call is made only once with pthread_once.
+ */
+NetworkReactor* NetworkReactor::getInstance()
+{
+    pthread_once(&m_instance_once, createInstance);
+    return m_instance;
+}
+
+/*! @brief Creates and starts the network reactor. This is only called once, by getInstance() */
+void NetworkReactor::createInstance()
+{
+    m_instance = new NetworkReactor();
+    m_instance->start();
+}
+
+NetworkReactor::NetworkReactor() : Thread(string("NetworkReactor"), 0)
+{
+    #if DEBUG_NETWORK_VERBOSITY > 0
+        debug << "NetworkReactor::NetworkReactor()" << endl;
+    #endif
+    pthread_mutex_init(&m_ports_mutex, NULL);
+    pthread_cond_init(&m_received_cond, NULL);
+    m_receiving = NULL;
+    #ifdef NETWORKREACTOR_USE_EPOLL
+        m_epoll_fd = epoll_create(NETWORKREACTOR_MAX_EVENTS);
+        if (m_epoll_fd == -1)
+            errorlog << "NetworkReactor::NetworkReactor(). Failed to create epoll instance, errno: " << errno << endl;
+    #endif
+}
+
+NetworkReactor::~NetworkReactor()
+{
+    stop();
+    #ifdef NETWORKREACTOR_USE_EPOLL
+        close(m_epoll_fd);
+    #endif
+    pthread_cond_destroy(&m_received_cond);
+    pthread_mutex_destroy(&m_ports_mutex);
+}
+
+/*! @brief Adds a port to the reactor. The port's receive() will be called whenever there is data waiting on its socket.
+    @param port the port to add
+ */
+void NetworkReactor::add(UdpPort* port)
+{
+    #if DEBUG_NETWORK_VERBOSITY > 0
+        debug << "NetworkReactor::add(" << port->m_port_name << ")" << endl;
+    #endif
+    pthread_mutex_lock(&m_ports_mutex);
+    if (not isRegistered(port))
+    {
+        m_ports.push_back(port);
+        #ifdef NETWORKREACTOR_USE_EPOLL
+            struct epoll_event event;
+            event.events = EPOLLIN;
+            event.data.ptr = port;
+            if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, port->m_sockfd, &event) == -1)
+                errorlog << "NetworkReactor::add(" << port->m_port_name << "). Failed to add socket, errno: " << errno << endl;
+        #endif
+    }
+    pthread_mutex_unlock(&m_ports_mutex);
+}
+
+/*! @brief Removes a port from the reactor. Once this returns the port's receive() is not running, and will not be called again.
+           If the port is receiving on the reactor's thread this waits for it to finish, unless it is that thread removing it.
+    @param port the port to remove
+ */
+void NetworkReactor::remove(UdpPort* port)
+{
+    pthread_mutex_lock(&m_ports_mutex);
+    vector<UdpPort*>::iterator it = find(m_ports.begin(), m_ports.end(), port);
+    if (it != m_ports.end())
+    {
+        m_ports.erase(it);
+        #ifdef NETWORKREACTOR_USE_EPOLL
+            struct epoll_event event;           // the event is ignored, but kernels before 2.6.9 require it to be non-NULL
+            epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, port->m_sockfd, &event);
+        #endif
+    }
+    // m_reactor_thread is always set by the time a port is m_receiving
+    while (m_receiving == port and not pthread_equal(pthread_self(), m_reactor_thread))
+        pthread_cond_wait(&m_received_cond, &m_ports_mutex);
+    pthread_mutex_unlock(&m_ports_mutex);
+}
+
+/*! @brief Returns true if the port has been added, and not removed. m_ports_mutex must be held by the caller. */
+bool NetworkReactor::isRegistered(UdpPort* port) const
+{
+    return find(m_ports.begin(), m_ports.end(), port) != m_ports.end();
+}
+
+/*! @brief Has each of the ready ports receive its data. 
+    
+    m_ports_mutex is only held to check that a port has not been removed since it was found to be ready, and to mark it
+    as m_receiving; it is released while the port receives, so that adding or removing other ports, and the port's own
+    handleNewData(), is not blocked by it. remove() waits for a port that is m_receiving to finish.
+    @param ready the ports with data waiting
+    @param numready the number of ready ports
+ */
+void NetworkReactor::receive(UdpPort** ready, int numready)
+{
+    for (int i=0; i<numready; i++)
+    {
+        pthread_mutex_lock(&m_ports_mutex);
+        bool registered = isRegistered(ready[i]);         // the port may have been removed since it was found to be ready
+        if (registered)
+            m_receiving = ready[i];
+        pthread_mutex_unlock(&m_ports_mutex);
+        if (not registered)
+            continue;
+        
+        ready[i]->receive();
+        
+        pthread_mutex_lock(&m_ports_mutex);
+        m_receiving = NULL;
+        pthread_cond_broadcast(&m_received_cond);
+        pthread_mutex_unlock(&m_ports_mutex);
+    }
+}
+
+/*! @brief The reactor's main loop; wait for data on any of the sockets, and have the ports with data receive it */
+void NetworkReactor::run()
+{
+    #if DEBUG_NETWORK_VERBOSITY > 4
+        debug << "NetworkReactor::run(). Starting the network reactor's mainloop" << endl;
+    #endif
+    pthread_mutex_lock(&m_ports_mutex);
+    m_reactor_thread = pthread_self();
+    pthread_mutex_unlock(&m_ports_mutex);
+    UdpPort* ready[NETWORKREACTOR_MAX_EVENTS];
+    #ifdef NETWORKREACTOR_USE_EPOLL
+        struct epoll_event events[NETWORKREACTOR_MAX_EVENTS];
+        while (1)
+        {
+            int numready = epoll_wait(m_epoll_fd, events, NETWORKREACTOR_MAX_EVENTS, -1);
+            if (numready == -1)
+            {
+                if (errno != EINTR)
+                    errorlog << "NetworkReactor::run(). epoll_wait failed, errno: " << errno << endl;
+                continue;
+            }
+            for (int i=0; i<numready; i++)
+                ready[i] = reinterpret_cast<UdpPort*>(events[i].data.ptr);
+            receive(ready, numready);
+        }
+    #else
+        while (1)
+        {
+            fd_set readable;
+            FD_ZERO(&readable);
+            int maxfd = -1;
+            pthread_mutex_lock(&m_ports_mutex);
+            for (size_t i=0; i<m_ports.size(); i++)
+            {
+                FD_SET(m_ports[i]->m_sockfd, &readable);
+                maxfd = max(maxfd, static_cast<int>(m_ports[i]->m_sockfd));
+            }
+            pthread_mutex_unlock(&m_ports_mutex);
+
+            struct timeval timeout;
+            timeout.tv_sec = 0;
+            timeout.tv_usec = 1000*NETWORKREACTOR_SELECT_TIMEOUT;
+            if (select(maxfd + 1, &readable, NULL, NULL, &timeout) <= 0)
+                continue;
+
+            int numready = 0;
+            pthread_mutex_lock(&m_ports_mutex);
+            for (size_t i=0; i<m_ports.size() and numready<NETWORKREACTOR_MAX_EVENTS; i++)
+            {
+                if (FD_ISSET(m_ports[i]->m_sockfd, &readable))
+                    ready[numready++] = m_ports[i];
+            }
+            pthread_mutex_unlock(&m_ports_mutex);
+            receive(ready, numready);
+        }
+    #endif
+}
+
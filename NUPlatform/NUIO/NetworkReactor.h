@@ -0,0 +1,77 @@
+/*! @file NetworkReactor.h
+    @brief Declaration of NetworkReactor class.
+
+    @class NetworkReactor
+    @brief A single low priority thread that receives on every UdpPort
+
+    Rather than each UdpPort having its own thread blocked in recvfrom, every port registers its
+    socket with the reactor. The reactor waits on all of the sockets at once (with epoll on linux,
+    and select elsewhere) and asks the port with data to receive it. The port then reads the waiting
+    datagrams into its preallocated buffers and hands them to its handleNewData().
+
+    There is only one reactor; it is created and started when the first port is added.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef NETWORKREACTOR_H
+#define NETWORKREACTOR_H
+
+#include "Tools/Threading/Thread.h"
+class UdpPort;
+
+#include <vector>
+
+#if defined(__linux__)
+    #define NETWORKREACTOR_USE_EPOLL
+#endif
+
+#define NETWORKREACTOR_MAX_EVENTS 16            //!< the maximum number of ready sockets handled per wait
+#define NETWORKREACTOR_SELECT_TIMEOUT 100       //!< the select timeout in ms, after which newly added ports are included in the wait
+
+class NetworkReactor : public Thread
+{
+public:
+    static NetworkReactor* getInstance();
+
+    void add(UdpPort* port);
+    void remove(UdpPort* port);
+private:
+    NetworkReactor();
+    ~NetworkReactor();
+    static void createInstance();
+
+    void run();
+    bool isRegistered(UdpPort* port) const;
+    void receive(UdpPort** ready, int numready);
+
+private:
+    static NetworkReactor* m_instance;          //!< the network reactor, created by the first getInstance()
+    static pthread_once_t m_instance_once;      //!< makes sure only one getInstance() creates the network reactor
+    #ifdef NETWORKREACTOR_USE_EPOLL
+        int m_epoll_fd;                         //!< the epoll instance all of the sockets are registered with
+    #endif
+    std::vector<UdpPort*> m_ports;              //!< the ports that have been added
+    pthread_mutex_t m_ports_mutex;              //!< lock for m_ports and m_receiving. It is not held while a port receives
+    pthread_cond_t m_received_cond;             //!< signalled when a port has finished receiving
+    UdpPort* m_receiving;                       //!< the port that is receiving, or NULL. remove() waits until it has finished
+    pthread_t m_reactor_thread;                 //!< the reactor's thread, so that a port removed from its own handleNewData() is not waited for
+};
+
+#endif
+
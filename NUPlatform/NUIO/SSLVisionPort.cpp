@@ -54,24 +54,25 @@ SSLVisionPort::SSLVisionPort(NUSensorsData *nubotsensors, TeamInformation* teami
     }
     idfile.close();
 	storage.open("/var/volatile/storage.log");	
+    listen();
 }
 
 /*! @brief Closes the job port
  */
 SSLVisionPort::~SSLVisionPort()
 {
+    unlisten();
     if(m_packet != NULL) delete m_packet;
 }
 
 /*! @brief Copies the received data into the public nubot joblist
     @param buffer containing the joblist
 */
-void SSLVisionPort::handleNewData(std::stringstream& buffer)
+void SSLVisionPort::handleNewData(std::istream& buffer)
 {
     #if DEBUG_NETWORK_VERBOSITY > 0
         debug << "SSLVisionPort::handleNewData()." << std::endl;
     #endif
-    string s_buffer = buffer.str();
     buffer >> (*m_packet);
     writePacketToSensors(m_packet, m_sensor_data);
 }
@@ -38,7 +38,7 @@ public:
     ~SSLVisionPort();
     
 private:
-    void handleNewData(std::stringstream& buffer);
+    void handleNewData(std::istream& buffer);
     void writePacketToSensors(SSLVisionPacket* packet, NUSensorsData* sensors);
 public:
 private:
@@ -26,8 +26,12 @@
 #include "debugverbositynetwork.h"
 #include <string.h>
 #include <errno.h>
+#ifndef WIN32
+    #include <unistd.h>
+#endif
 #include "Localisation/Localisation.h"
 #include "Infrastructure/FieldObjects/FieldObjects.h"
+#include "Tools/Threading/PeriodicThread.h"
 
 /*! @brief Constructs a tcp port on the specified port
  
@@ -211,6 +215,17 @@ void TcpPort::sendData(const NUImage& p_image, const NUSensorsData &p_sensors)
     network_data_t sensordata;
     stringstream sensorsbuffer;
     sensorsbuffer << p_sensors;
+    
+    // the thread statistics go after the sensors, followed by their size and a marker, where readers that do not know about them ignore them
+    stringstream statisticsbuffer;
+    PeriodicThread::writeAllStatistics(statisticsbuffer);
+    string statisticsString = statisticsbuffer.str();
+    int statisticsSize = statisticsString.size();
+    int statisticsMagic = PERIODIC_THREAD_STATISTICS_MAGIC;
+    sensorsbuffer.write(statisticsString.c_str(), statisticsSize);
+    sensorsbuffer.write(reinterpret_cast<char*>(&statisticsSize), sizeof(statisticsSize));
+    sensorsbuffer.write(reinterpret_cast<char*>(&statisticsMagic), sizeof(statisticsMagic));
+    
     string sensorsString = sensorsbuffer.str();
     sensordata.data = (char*) sensorsString.c_str();
     sensordata.size = sensorsString.size();
@@ -238,7 +253,6 @@ void TcpPort::sendData(const NUImage& p_image, const NUSensorsData &p_sensors)
         sendData(linedata);
     }
     sendData(sensordata);
-    
 }
 
 
@@ -38,30 +38,26 @@ TeamPort::TeamPort(TeamInformation* nubotteaminformation, int portnumber, bool i
     m_team_transmission_thread = new TeamTransmissionThread(this, 250);
     
     m_team_transmission_thread->start();
+    listen();
 }
 
 /*! @brief Closes the job port
  */
 TeamPort::~TeamPort()
 {
+    unlisten();
     m_team_transmission_thread->stop();
     delete m_team_transmission_thread;
 }
 
-/*! @brief Copies the received data into the public nubot joblist
-    @param buffer containing the joblist
+/*! @brief Copies the received team packet into the public nubot team information
+    @param buffer containing a single team packet. Packets of the wrong size are rejected when they are decoded.
 */
-void TeamPort::handleNewData(std::stringstream& buffer)
+void TeamPort::handleNewData(std::istream& buffer)
 {
     #if DEBUG_NETWORK_VERBOSITY > 0
         debug << "TeamPort::handleNewData()." << endl;
     #endif
-    string s_buffer = buffer.str();
-    if (s_buffer.size() == sizeof(TeamPacket))
-    {   // discard team packets that are the wrong size
-        buffer >> m_team_information;
-    }
-    else
-        debug << "TeamPort::handleNewData(). The received packet does not have the correct length: " << s_buffer.size() << " instead of " << sizeof(TeamPacket) << endl;
+    buffer >> m_team_information;
 }
 
@@ -36,7 +36,7 @@ public:
     ~TeamPort();
     
 private:
-    void handleNewData(std::stringstream& buffer);
+    void handleNewData(std::istream& buffer);
 public:
 private:
     TeamInformation* m_team_information;
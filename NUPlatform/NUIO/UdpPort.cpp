@@ -20,6 +20,7 @@
  */
 
 #include "UdpPort.h"
+#include "NetworkReactor.h"
 
 #include "targetconfig.h"
 #include "debug.h"
@@ -29,6 +30,7 @@
     #include <sys/ioctl.h>
     #include <netdb.h>
     #include <net/if.h>
+    #include <unistd.h>
 #endif
 #include <errno.h>
 #include <cstring>
@@ -36,13 +38,13 @@ using namespace std;
 
 /*! @brief Constructs a udp port on the specified port
  
-    The port is setup to always broadcast on the local subnet.
+    The port is setup to always broadcast on the local subnet. Data is not received until listen() is called.
 
     @param name the name of the network used for debug purposes eg. TeamPort, GameController, Jobs, etc
     @param portnumber the port number the data will be sent and received on
     @param ignoreself set this to true if you want to ignore your own transmissions on this port
  */
-UdpPort::UdpPort(string name, int portnumber, bool ignoreself): Thread(name, 0)
+UdpPort::UdpPort(string name, int portnumber, bool ignoreself): m_packet_stream(&m_packet_buffer)
 {
     #if DEBUG_NETWORK_VERBOSITY > 0
         debug << "UdpPort::UdpPort(" << name << ", " << portnumber << ")" << endl;
@@ -59,6 +61,7 @@ UdpPort::UdpPort(string name, int portnumber, bool ignoreself): Thread(name, 0)
     m_port_name = name;
     m_port_number = portnumber;
     m_ignore_self = ignoreself;
+    m_listening = false;
     
     // Set the socket as UDP
     if ((m_sockfd = socket(AF_INET, SOCK_DGRAM, 0)) == -1) 
@@ -133,56 +136,114 @@ UdpPort::UdpPort(string name, int portnumber, bool ignoreself): Thread(name, 0)
     if (bind(m_sockfd, (struct sockaddr *)&m_address, sizeof m_address) == -1)
         errorlog << "UdpPort::UdpPort(" << m_port_name << "). Failed to bind socket, errno: " << errno << endl;
     
-    pthread_mutex_init(&m_socket_mutex, NULL);
-    
-    start();
+    #ifdef UDPPORT_USE_RECVMMSG
+        // point each recvmmsg header at its own buffer and sender address
+        memset(m_headers, 0, sizeof(m_headers));
+        for (int i=0; i<UDPPORT_BATCH_SIZE; i++)
+        {
+            m_iovecs[i].iov_base = m_buffers[i];
+            m_iovecs[i].iov_len = UDPPORT_BUFFER_SIZE;
+            m_headers[i].msg_hdr.msg_iov = &m_iovecs[i];
+            m_headers[i].msg_hdr.msg_iovlen = 1;
+            m_headers[i].msg_hdr.msg_name = &m_senders[i];
+        }
+        m_recvmmsg_supported = true;
+    #endif
 }
 
-/*! @brief Closes the udp port
+/*! @brief Closes the udp port. The derived class's destructor must call unlisten() first.
  */
 UdpPort::~UdpPort()
 {
+    unlisten();
     #ifdef WIN32
         closesocket(m_sockfd);
         WSACleanup();
     #else
         close(m_sockfd);
     #endif
-    pthread_mutex_destroy(&m_socket_mutex);
 }
 
-/*! @brief Run the UDP port's main loop
+/*! @brief Starts receiving data on the port. This should be called at the end of the derived class's constructor,
+           so that handleNewData() is not called before the derived class is ready.
+ */
+void UdpPort::listen()
+{
+    if (not m_listening)
+    {
+        m_listening = true;
+        NetworkReactor::getInstance()->add(this);
+    }
+}
 
+/*! @brief Stops receiving data on the port. When this returns handleNewData() is not being called, and will not be
+           called again. This must be called at the start of the derived class's destructor, because the NetworkReactor's
+           thread may be in handleNewData() until then, and by the time UdpPort's destructor runs the derived class is gone.
+           When it is called from the port's own handleNewData() it does not wait, and handleNewData() is not called again.
  */
-void UdpPort::run()
+void UdpPort::unlisten()
 {
-#if DEBUG_NETWORK_VERBOSITY > 4
-    debug << "UdpPort::run(). Starting udpport: " << m_port_name << "'s mainloop" << endl;
-#endif
-    struct sockaddr_in local_their_addr; // connector's address information
-    socklen_t local_addr_len = sizeof(local_their_addr);
-    char localdata[10*1024];
-    int localnumBytes;
-    while(1)
+    if (m_listening)
     {
-        localnumBytes = recvfrom(m_sockfd, localdata, 10*1024 , 0, (struct sockaddr *)&local_their_addr, &local_addr_len);
-        if (localnumBytes != -1 and ((not m_ignore_self) or (local_their_addr.sin_addr.s_addr != m_local_address.sin_addr.s_addr)))
+        NetworkReactor::getInstance()->remove(this);
+        m_listening = false;
+    }
+}
+
+/*! @brief Receives the datagrams waiting on the socket, and passes each of them to handleNewData().
+           This is called by the NetworkReactor's thread when the socket is readable.
+ */
+void UdpPort::receive()
+{
+    #ifdef UDPPORT_USE_RECVMMSG
+        if (m_recvmmsg_supported)
         {
-            #if DEBUG_NETWORK_VERBOSITY > 0
-                debug << "UdpPort::run()." << m_port_number << " Received " << localnumBytes << " bytes from " << inet_ntoa(local_their_addr.sin_addr) << endl;
-            #endif
-            stringstream buffer;
-            buffer.write(reinterpret_cast<char*>(localdata), localnumBytes);
-            #if DEBUG_NETWORK_VERBOSITY > 4
-                string s = buffer.str();
-                for (size_t i=0; i<s.size(); i++)
-                    debug << s[i];
-                debug << endl;
-            #endif
-            handleNewData(buffer);
+            for (int i=0; i<UDPPORT_BATCH_SIZE; i++)
+                m_headers[i].msg_hdr.msg_namelen = sizeof(m_senders[i]);
+            int numreceived = recvmmsg(m_sockfd, m_headers, UDPPORT_BATCH_SIZE, MSG_DONTWAIT, NULL);
+            if (numreceived >= 0)
+            {
+                for (int i=0; i<numreceived; i++)
+                    dispatch(m_buffers[i], m_headers[i].msg_len, m_senders[i]);
+                return;
+            }
+            else if (errno == ENOSYS)
+                m_recvmmsg_supported = false;           // kernels before 2.6.33 do not implement recvmmsg; use recvfrom from now on
+            else
+                return;
         }
-    }
-    return;
+    #endif
+    #ifdef MSG_DONTWAIT
+        int flags = MSG_DONTWAIT;
+    #else
+        int flags = 0;
+    #endif
+    socklen_t addresslength = sizeof(m_senders[0]);
+    int numbytes = recvfrom(m_sockfd, m_buffers[0], UDPPORT_BUFFER_SIZE, flags, (struct sockaddr *)&m_senders[0], &addresslength);
+    if (numbytes != -1)
+        dispatch(m_buffers[0], numbytes, m_senders[0]);
+}
+
+/*! @brief Decodes a single received datagram with handleNewData(), unless it is one of our own and they are being ignored
+    @param data the datagram
+    @param numbytes the length of the datagram
+    @param from the address of the sender
+ */
+void UdpPort::dispatch(char* data, int numbytes, const sockaddr_in& from)
+{
+    if (m_ignore_self and from.sin_addr.s_addr == m_local_address.sin_addr.s_addr)
+        return;
+    #if DEBUG_NETWORK_VERBOSITY > 0
+        debug << "UdpPort::dispatch()." << m_port_number << " Received " << numbytes << " bytes from " << inet_ntoa(from.sin_addr) << endl;
+    #endif
+    #if DEBUG_NETWORK_VERBOSITY > 4
+        for (int i=0; i<numbytes; i++)
+            debug << data[i];
+        debug << endl;
+    #endif
+    m_packet_buffer.setPacket(data, numbytes);
+    m_packet_stream.clear();
+    handleNewData(m_packet_stream);
 }
 
 /*! @brief Sends a string stream over the network
@@ -190,14 +251,10 @@ void UdpPort::run()
  */
 void UdpPort::sendData(const stringstream& stream)
 {
-    char* data;
-    int numbytes;
-    numbytes = stream.str().size();
-    data = (char*) stream.str().c_str();
+    string data = stream.str();
     #if DEBUG_NETWORK_VERBOSITY > 4
-        debug << "UdpPort::sendData(). Sending " << numbytes << " bytes to " << inet_ntoa(m_target_address.sin_addr) << endl;
+        debug << "UdpPort::sendData(). Sending " << data.size() << " bytes to " << inet_ntoa(m_target_address.sin_addr) << endl;
     #endif
-    pthread_mutex_lock(&m_socket_mutex);
-    sendto(m_sockfd, data, numbytes, 0, (struct sockaddr *)&m_target_address, sizeof(m_target_address));
-    pthread_mutex_unlock(&m_socket_mutex);
+    // a datagram is sent atomically, so sends from several threads do not need to be serialised
+    sendto(m_sockfd, data.c_str(), data.size(), 0, (struct sockaddr *)&m_target_address, sizeof(m_target_address));
 }
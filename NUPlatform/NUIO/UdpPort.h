@@ -4,6 +4,9 @@
     @class UdpPort
     @brief UdpPort class encapsulating a udp socket
 
+    The port does not have a thread of its own; after listen() is called the NetworkReactor receives
+    on the port's behalf, and each datagram is decoded by handleNewData() on the reactor's thread.
+
     @author Aaron Wong, Jason Kulk
  
  Copyright (c) 2009, 2010 Aaron Wong
@@ -33,21 +36,41 @@
     #include <arpa/inet.h>
 #endif
 
-#include "Tools/Threading/Thread.h"
-
 #include <sstream>
+#include <istream>
 #include <string>
 
-class UdpPort : public Thread
+#if defined(__linux__) && defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 12))
+    #define UDPPORT_USE_RECVMMSG
+#endif
+
+#define UDPPORT_BUFFER_SIZE (10*1024)           //!< the size of each receive buffer; the largest datagram that will be received
+#define UDPPORT_BATCH_SIZE 8                    //!< the maximum number of datagrams received at once
+
+/*! @brief A read only stream buffer over a received datagram, so that a packet can be decoded without copying it */
+class PacketStreamBuffer : public std::streambuf
+{
+public:
+    void setPacket(char* data, size_t size)
+    {
+        setg(data, data, data + size);
+    }
+};
+
+class UdpPort
 {
 public:
     UdpPort(std::string name, int portnumber, bool ignoreself = true);
     virtual ~UdpPort();
 protected:
+    void listen();
+    void unlisten();
     void sendData(const std::stringstream& stream);
-    virtual void handleNewData(std::stringstream& buffer) = 0;
+    virtual void handleNewData(std::istream& buffer) = 0;
 private:
-    void run();
+    friend class NetworkReactor;
+    void receive();
+    void dispatch(char* data, int numbytes, const sockaddr_in& from);
     
 protected:
     std::string m_port_name;            //!< the name of this port
@@ -60,12 +83,20 @@ private:
     int m_sockfd;                       //!< the socket
     int m_port_number;                  //!< the port number of the socket
     bool m_ignore_self;                 //!< true if you want to ignore your own transmissions
+    bool m_listening;                   //!< true once the port has been added to the NetworkReactor
     
     sockaddr_in m_address;              //!< the socket address
 
-    pthread_mutex_t m_socket_mutex;     //!< lock to prevent simultaneous reading and writing on the same port
-
+    // the receive buffers; they are allocated once and only used by the NetworkReactor's thread
+    char m_buffers[UDPPORT_BATCH_SIZE][UDPPORT_BUFFER_SIZE];       //!< the data of each datagram in a batch
+    sockaddr_in m_senders[UDPPORT_BATCH_SIZE];                      //!< the sender of each datagram in a batch
+    #ifdef UDPPORT_USE_RECVMMSG
+        struct iovec m_iovecs[UDPPORT_BATCH_SIZE];                  //!< the scatter/gather vector for each datagram, pointing into m_buffers
+        struct mmsghdr m_headers[UDPPORT_BATCH_SIZE];               //!< the recvmmsg header for each datagram
+        bool m_recvmmsg_supported;                                  //!< false if the kernel does not implement recvmmsg
+    #endif
+    PacketStreamBuffer m_packet_buffer; //!< the stream buffer over the datagram being decoded
+    std::istream m_packet_stream;       //!< the stream handed to handleNewData
 };
 
 #endif
-
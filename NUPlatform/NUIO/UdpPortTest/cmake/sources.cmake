@@ -0,0 +1,34 @@
+# A CMake file for the udp port test
+#   - the test is a separate executable, so its sources go into UDPPORTTEST_SRCS not NUBOT_SRCS
+#   - it only needs UdpPort, the NetworkReactor and the threads, so it is not built from the rest of the nubot sources
+#
+#    Copyright (c) 2026 agent
+#    This file is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This file is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+
+IF(DEBUG)
+    MESSAGE(STATUS ${CMAKE_CURRENT_LIST_FILE})
+ENDIF()
+
+########## List your source files here! ############################################
+SET (YOUR_SRCS  udpporttest.cpp
+                ../UdpPort.cpp ../UdpPort.h
+                ../NetworkReactor.cpp ../NetworkReactor.h
+                ../../../Tools/Threading/Thread.cpp ../../../Tools/Threading/Thread.h
+)
+####################################################################################
+
+# I need to prefix each file and directory with the correct path
+STRING(REPLACE "/cmake/sources.cmake" "" THIS_SRC_DIR ${CMAKE_CURRENT_LIST_FILE})
+
+SET(UDPPORTTEST_SRCS )
+FOREACH(loop_var ${YOUR_SRCS}) 
+    LIST(APPEND UDPPORTTEST_SRCS "${THIS_SRC_DIR}/${loop_var}" )
+ENDFOREACH(loop_var ${YOUR_SRCS})
@@ -0,0 +1,268 @@
+/*! @file udpporttest.cpp
+    @brief The udpporttest executable. Tests UdpPort and the NetworkReactor over the loopback interface.
+
+    Usage: udpporttest [port number]
+
+    The tests use the port number and the three after it (56000 to 56003 unless given):
+        - loopback: a port sends datagrams of every size up to UDPPORT_BUFFER_SIZE to itself, and each must be received unchanged
+        - destroy while receiving: a port whose handleNewData() is slow is deleted while another socket floods it,
+          many times over. The derived port's members are destroyed while the NetworkReactor is still sending it
+          data, so a port that does not unlisten() first fails this test under AddressSanitizer or ThreadSanitizer.
+        - add while receiving: another port is created and deleted while a port is in a very slow handleNewData().
+          The NetworkReactor must not hold its lock while a port receives, so this must not wait for the slow port.
+    The exit status is 1 if a test failed.
+    Use a build with NUBOT_BUILD_UDP_PORT_TEST ON.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "NUPlatform/NUIO/UdpPort.h"
+
+#include "debug.h"
+
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <string>
+#include <iterator>
+using namespace std;
+
+ofstream debug;
+ofstream errorlog;
+
+#define LOOPBACK_DATAGRAMS 200              //!< the number of datagrams sent in the loopback test
+#define LOOPBACK_TIMEOUT 1000               //!< the time in ms the loopback test waits for each datagram
+#define DESTROY_REPETITIONS 50              //!< the number of ports deleted while receiving
+#define DESTROY_DELAY 5000                  //!< the time in us a port receives before it is deleted
+#define HANDLER_DELAY 200                   //!< the time in us the slow port spends in each handleNewData()
+#define BLOCKING_HANDLER_DELAY 500000       //!< the time in us the very slow port spends in handleNewData()
+#define BLOCKING_START_DELAY 50000          //!< the time in us given to the very slow port to start receiving
+#define BLOCKING_MAX_TIME 200               //!< the time in ms creating and deleting a port may take while the very slow port receives
+
+/*! @brief Returns the current monotonic time in ms */
+static double now()
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return 1e3*t.tv_sec + 1e-6*t.tv_nsec;
+}
+
+/*! @brief A port on the loopback interface that keeps every datagram it receives */
+class TestPort : public UdpPort
+{
+public:
+    /*! @brief Creates a port sending to itself on the loopback interface
+        @param handlerdelay the time in us spent in each handleNewData()
+     */
+    TestPort(int portnumber, int handlerdelay = 0) : UdpPort("TestPort", portnumber, false)
+    {
+        m_handler_delay = handlerdelay;
+        pthread_mutex_init(&m_received_mutex, NULL);
+        m_target_address.sin_addr.s_addr = inet_addr("127.0.0.1");
+        listen();
+    }
+    ~TestPort()
+    {
+        unlisten();
+        pthread_mutex_destroy(&m_received_mutex);
+    }
+
+    void send(const string& data)
+    {
+        stringstream buffer;
+        buffer << data;
+        sendData(buffer);
+    }
+
+    /*! @brief Waits until at least the given number of datagrams have been received
+        @return false if they have not all arrived within the timeout in ms
+     */
+    bool waitFor(size_t numdatagrams, double timeout)
+    {
+        double start = now();
+        while (getReceived().size() < numdatagrams)
+        {
+            if (now() - start > timeout)
+                return false;
+            usleep(1000);
+        }
+        return true;
+    }
+
+    vector<string> getReceived()
+    {
+        pthread_mutex_lock(&m_received_mutex);
+        vector<string> received = m_received;
+        pthread_mutex_unlock(&m_received_mutex);
+        return received;
+    }
+protected:
+    void handleNewData(istream& buffer)
+    {
+        string data((istreambuf_iterator<char>(buffer)), istreambuf_iterator<char>());
+        if (m_handler_delay > 0)
+            usleep(m_handler_delay);
+        pthread_mutex_lock(&m_received_mutex);
+        m_received.push_back(data);
+        pthread_mutex_unlock(&m_received_mutex);
+    }
+private:
+    int m_handler_delay;                    //!< the time in us spent in each handleNewData()
+    pthread_mutex_t m_received_mutex;       //!< lock for m_received
+    vector<string> m_received;              //!< every datagram received, in the order they arrived
+};
+
+/*! @brief A thread sending small datagrams to a loopback port as fast as it can until it is stopped */
+class Flooder
+{
+public:
+    Flooder(int portnumber)
+    {
+        m_stop = false;
+        pthread_mutex_init(&m_mutex, NULL);
+        m_sockfd = socket(AF_INET, SOCK_DGRAM, 0);
+        memset(&m_address, 0, sizeof(m_address));
+        m_address.sin_family = AF_INET;
+        m_address.sin_port = htons(portnumber);
+        m_address.sin_addr.s_addr = inet_addr("127.0.0.1");
+        pthread_create(&m_thread, NULL, run, this);
+    }
+    ~Flooder()
+    {
+        pthread_mutex_lock(&m_mutex);
+        m_stop = true;
+        pthread_mutex_unlock(&m_mutex);
+        pthread_join(m_thread, NULL);
+        close(m_sockfd);
+        pthread_mutex_destroy(&m_mutex);
+    }
+private:
+    static void* run(void* arg)
+    {
+        Flooder* flooder = static_cast<Flooder*>(arg);
+        const char data[] = "flood";
+        while (not flooder->isStopped())
+        {
+            sendto(flooder->m_sockfd, data, sizeof(data), 0, (struct sockaddr*)&flooder->m_address, sizeof(flooder->m_address));
+            usleep(20);
+        }
+        return NULL;
+    }
+    bool isStopped()
+    {
+        pthread_mutex_lock(&m_mutex);
+        bool stop = m_stop;
+        pthread_mutex_unlock(&m_mutex);
+        return stop;
+    }
+
+    int m_sockfd;                           //!< the socket the datagrams are sent from
+    sockaddr_in m_address;                  //!< the loopback address of the port being flooded
+    pthread_t m_thread;                     //!< the sending thread
+    pthread_mutex_t m_mutex;                //!< lock for m_stop
+    bool m_stop;                            //!< true once the thread has been asked to stop
+};
+
+/*! @brief Sends datagrams of many sizes from a port to itself, and checks that each is received unchanged.
+           Each datagram is sent once the one before it has arrived, so that none are dropped because the socket's receive buffer is full.
+ */
+static bool testLoopback(int portnumber)
+{
+    TestPort port(portnumber);
+    int numreceived = 0;
+    bool passed = true;
+    for (int i=0; i<LOOPBACK_DATAGRAMS and passed; i++)
+    {
+        // the sizes go from 1 byte up to the size of the receive buffer
+        size_t size = 1 + (static_cast<size_t>(i)*(UDPPORT_BUFFER_SIZE - 1))/(LOOPBACK_DATAGRAMS - 1);
+        string data(size, static_cast<char>('a' + i % 26));
+        data[0] = static_cast<char>(i);
+        port.send(data);
+        if (not port.waitFor(i + 1, LOOPBACK_TIMEOUT))
+        {
+            cout << "    datagram " << i << " of " << size << " bytes was not received" << endl;
+            passed = false;
+            break;
+        }
+        vector<string> received = port.getReceived();
+        numreceived = received.size();
+        if (numreceived != i + 1 or received.back() != data)
+        {
+            cout << "    datagram " << i << " of " << size << " bytes was received as " << received.back().size() << " bytes" << endl;
+            passed = false;
+        }
+    }
+    cout << "loopback: " << numreceived << " of " << LOOPBACK_DATAGRAMS << " datagrams received, " << (passed ? "passed" : "FAILED") << endl;
+    return passed;
+}
+
+/*! @brief Deletes slow ports while they are being flooded */
+static bool testDestroyWhileReceiving(int portnumber)
+{
+    Flooder flooder(portnumber);
+    size_t total = 0;
+    for (int i=0; i<DESTROY_REPETITIONS; i++)
+    {
+        TestPort* port = new TestPort(portnumber, HANDLER_DELAY);
+        usleep(DESTROY_DELAY);
+        total += port->getReceived().size();
+        delete port;
+    }
+    bool passed = total > 0;
+    cout << "destroy while receiving: " << DESTROY_REPETITIONS << " ports deleted, " << total << " datagrams received, " << (passed ? "passed" : "FAILED") << endl;
+    return passed;
+}
+
+/*! @brief Creates and deletes a port while another is stuck in handleNewData() */
+static bool testAddWhileReceiving(int portnumber)
+{
+    TestPort slowport(portnumber, BLOCKING_HANDLER_DELAY);
+    slowport.send("slow");
+    usleep(BLOCKING_START_DELAY);
+
+    double start = now();
+    TestPort* port = new TestPort(portnumber + 1);
+    delete port;
+    double elapsed = now() - start;
+
+    bool passed = elapsed < BLOCKING_MAX_TIME and slowport.waitFor(1, LOOPBACK_TIMEOUT + BLOCKING_HANDLER_DELAY/1000);
+    cout << "add while receiving: a port was created and deleted in " << elapsed << " ms, " << (passed ? "passed" : "FAILED") << endl;
+    return passed;
+}
+
+int main(int argc, const char *argv[])
+{
+    debug.open("udpporttestdebug.log");
+    errorlog.open("udpporttesterror.log");
+
+    int portnumber = argc > 1 ? atoi(argv[1]) : 56000;
+    if (portnumber <= 0 or portnumber >= 65533)
+    {
+        cerr << "udpporttest: the port number must be between 1 and 65532" << endl;
+        return 1;
+    }
+
+    bool passed = testLoopback(portnumber);
+    passed = testDestroyWhileReceiving(portnumber + 1) and passed;
+    passed = testAddWhileReceiving(portnumber + 2) and passed;
+    cout << (passed ? "passed" : "FAILED") << endl;
+    return passed ? 0 : 1;
+}
@@ -21,6 +21,7 @@ ENDIF()
 
 ########## List your source files here! ############################################
 SET (YOUR_SRCS  UdpPort.cpp UdpPort.h
+                NetworkReactor.cpp NetworkReactor.h
                 TcpPort.cpp TcpPort.h
                 GameControllerPort.cpp GameControllerPort.h
                 JobPort.cpp JobPort.h
@@ -87,6 +87,7 @@ void NUSensors::update()
     m_data->CurrentTime = m_current_time;
     copyFromHardwareCommunications();       // the implementation of this function will be platform specific
     calculateSoftSensors();
+    m_data->recordKinematics();             // so that vision can use the kinematics at the time its image was taken
     
 #if DEBUG_NUSENSORS_VERBOSITY > 0
     m_data->summaryTo(debug);
@@ -439,6 +440,14 @@ void NUSensors::calculateOdometry()
     odometeryData[2] += deltaTheta;
 
     m_data->set(NUSensorsData::Odometry, m_data->CurrentTime, odometeryData);
+    
+    // the feet move backwards when the robot moves forwards. Only some platforms have a yaw gyro (the NAO only has roll
+    // and pitch); the odometry history fuses it with the turn, but the Odometry sensor is left as it was
+    static vector<float> gyros;
+    if (m_data->getGyro(gyros) and gyros.size() > 2)
+        m_data->recordOdometry(-deltaX, deltaY, deltaTheta, gyros[2]);
+    else
+        m_data->recordOdometry(-deltaX, deltaY, deltaTheta);
 
     // Save the historical data
     prevHipYaw = hipYawPitch;
@@ -74,13 +74,15 @@ void CycloidActionators::copyToServos()
 {
     static vector<float> positions;
     static vector<float> gains;
+    MotorFeedback feedback;
     
     m_data->getNextServos(positions, gains);
+    m_motors->getFeedback(feedback);
     for (size_t i=0; i<positions.size(); i++)
     {
         // 195.379 converts radians to motor units, and Motors::DefaultPositions are the calibrated zero positions
         float motorposition = Motors::MotorSigns[i]*positions[i]*195.379 + Motors::DefaultPositions[i];                  
-        float speed = 1000*fabs(motorposition - JointPositions[i])/(m_data->CurrentTime - m_data->PreviousTime);     
+        float speed = 1000*fabs(motorposition - feedback.Positions[i])/(m_data->CurrentTime - m_data->PreviousTime);     
         if (speed > 1023)
             speed = 1023;
         
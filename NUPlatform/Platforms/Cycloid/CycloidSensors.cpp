@@ -70,8 +70,8 @@ void CycloidSensors::copyFromHardwareCommunications()
 
 /*! @brief Copys the joint sensor data from the Motors class to the NUSensorsData container.
  
-    The Motors class is very old and uses two globals; JointPositions and JointLoads to store sensor data.
-    Consequently, we need only copy from these old arrays into the new fancy NUSensorsData structure.
+    The Motors class keeps a double buffered snapshot of the feedback from the last transfer, so we take a copy of it
+    and convert it into the new fancy NUSensorsData structure.
  */
 void CycloidSensors::copyFromJoints()
 {
@@ -79,18 +79,20 @@ void CycloidSensors::copyFromJoints()
     
     vector<float> targets, stiffnesses;
     m_motors->getTargets(targets);
+    MotorFeedback feedback;
+    m_motors->getFeedback(feedback);
     m_motors->getStiffnesses(stiffnesses);
     
     vector<float> joint(NUSensorsData::NumJointSensorIndices, NaN);
     float delta_t = (m_current_time - m_previous_time)/1000;
     for (size_t i=0; i<m_joint_ids.size(); i++)
     {
-        joint[NUSensorsData::PositionId] = Motors::MotorSigns[i]*(JointPositions[i] - Motors::DefaultPositions[i])/195.379;         // I know, its a horrible way of converting from motor units to radians
+        joint[NUSensorsData::PositionId] = Motors::MotorSigns[i]*(feedback.Positions[i] - Motors::DefaultPositions[i])/195.379;         // I know, its a horrible way of converting from motor units to radians
         joint[NUSensorsData::VelocityId] = (joint[NUSensorsData::PositionId] - m_previous_positions[i])/delta_t;    
         joint[NUSensorsData::AccelerationId] = (joint[NUSensorsData::VelocityId] - m_previous_velocities[i])/delta_t;
         joint[NUSensorsData::TargetId] = Motors::MotorSigns[i]*(targets[i] - Motors::DefaultPositions[i])/195.379;;
         joint[NUSensorsData::StiffnessId] = stiffnesses[i];
-        joint[NUSensorsData::TorqueId] = Motors::MotorSigns[i]*JointLoads[i]*1.6432e-3;             // This torque conversion factor was measured for a DX-117, I don't know how well it applies to other motors
+        joint[NUSensorsData::TorqueId] = Motors::MotorSigns[i]*feedback.Loads[i]*1.6432e-3;             // This torque conversion factor was measured for a DX-117, I don't know how well it applies to other motors
         m_data->set(*m_joint_ids[i], m_current_time, joint);
         
         if (*m_joint_ids[i] == NUSensorsData::LAnklePitch)
@@ -5,6 +5,7 @@
 
 #include "debug.h"
 #include "nubotdataconfig.h"
+#include "Tools/Logging/AsyncLog.h"
 
 #include <iostream>
 using namespace std;
@@ -14,11 +15,12 @@ ofstream errorlog;
 
 int main(int argc, const char *argv[]) 
 {
-    debug.open("/var/volatile/debug.log");
-    errorlog.open((DATA_DIR + "error.log").c_str());
+    AsyncLog::attach(debug, "/var/volatile/debug.log");
+    AsyncLog::attach(errorlog, DATA_DIR + "error.log");
                   
     NUbot* nubot = new NUbot(argc, argv);
     Motors::getInstance()->setSensorThread(nubot->m_sensemove_thread);
     nubot->run();
     delete nubot;
+    AsyncLog::close();
 }
@@ -0,0 +1,457 @@
+/*! @file capturetest.cpp
+    @brief The capturetest executable. Tests NAOCameraThread without the robot's camera.
+
+    Usage: capturetest [number of frames] [frames.yuv | /dev/videoN]
+
+    Without a device the thread is run against a stand-in for the driver, which fills four in-memory buffers
+    every 33ms with the frames of a raw 640x480 YUV422 file (looped), or with a test pattern if no file is
+    given. The stand-in checks that a buffer is never dequeued or queued twice, and the test checks that
+        - the frames are taken in order, with increasing timestamps, and are intact
+        - grabFrame() returns -1, rather than blocking forever, once the device fails
+        - finish() wakes a grabFrame() that is waiting for a frame
+    With a device (eg. the vivid test driver, modprobe vivid) the thread is run on the device's own mmap buffers,
+    and the frame rate and number of skipped frames is printed.
+    The exit code is non-zero if a check fails. Use a build with NUBOT_BUILD_CAPTURE_TEST ON.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "NUPlatform/Platforms/NAO/NAOCameraThread.h"
+#include "NUPlatform/NUPlatform.h"
+
+#include "debug.h"
+
+#include <cstring>
+#include <cstdlib>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <linux/videodev2.h>
+#include <deque>
+#include <vector>
+using namespace std;
+
+ofstream debug;
+ofstream errorlog;
+
+#define CAPTURETEST_WIDTH 640
+#define CAPTURETEST_HEIGHT 480
+#define CAPTURETEST_SIZE (CAPTURETEST_WIDTH*CAPTURETEST_HEIGHT*2)
+#define CAPTURETEST_BUFFERS 4
+#define CAPTURETEST_PERIOD 33               //!< the time between frames from the stand-in in ms
+
+static int failures = 0;
+
+/*! @brief Prints the result of a check, and counts it if it failed */
+static void check(bool passed, const string& description)
+{
+    cout << (passed ? "    pass: " : "    FAIL: ") << description << endl;
+    if (not passed)
+        failures++;
+}
+
+/*! @brief Returns the current monotonic time in ms */
+static double now()
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return 1e3*t.tv_sec + 1e-6*t.tv_nsec;
+}
+
+/*! @brief A platform that only provides the time, which is all the capture thread needs */
+class CaptureTestPlatform : public NUPlatform
+{
+public:
+    CaptureTestPlatform() : NUPlatform() {m_start = now();};
+    double getTime() {return now() - m_start;};
+private:
+    double m_start;                         //!< the monotonic time the platform was created in ms
+};
+
+/*! @brief A capture thread on a stand-in for the driver. Its buffers are in memory, and filled with the frames of a file */
+class FileCaptureThread : public NAOCameraThread
+{
+public:
+    /*! @brief Creates a stand-in for the driver, with every buffer queued and streaming on
+        @param frames the frames to fill the buffers with, in turn
+        @param period the time between frames in ms
+        @param failafter the number of frames after which the device fails, or 0 if it never fails
+     */
+    FileCaptureThread(const vector<vector<unsigned char> >& frames, double period, unsigned int failafter) :
+        NAOCameraThread(-1, CAPTURETEST_SIZE), m_frames(frames), m_period(period), m_fail_after(failafter)
+    {
+        pthread_mutex_init(&m_driver_mutex, NULL);
+        m_buffers.resize(CAPTURETEST_BUFFERS, vector<unsigned char>(CAPTURETEST_SIZE));
+        m_states.resize(CAPTURETEST_BUFFERS, Queued);
+        m_sequences.resize(CAPTURETEST_BUFFERS, 0);
+        m_timestamps.resize(CAPTURETEST_BUFFERS, 0);
+        for (int i=0; i<CAPTURETEST_BUFFERS; i++)
+            m_queued.push_back(i);
+        m_num_filled = 0;
+        m_next_time = now() + m_period;
+        m_num_errors = 0;
+    }
+    ~FileCaptureThread()
+    {
+        finish();
+        pthread_mutex_destroy(&m_driver_mutex);
+    }
+
+    /*! @brief Returns the contents of a buffer */
+    const unsigned char* getBuffer(int index) {return &m_buffers[index][0];};
+    /*! @brief Returns the number of the frame in a buffer, counting from 1 */
+    unsigned int getSequence(int index) {return m_sequences[index];};
+    /*! @brief Returns the number of frames the stand-in has filled */
+    unsigned int getNumFilled()
+    {
+        pthread_mutex_lock(&m_driver_mutex);
+        unsigned int filled = m_num_filled;
+        pthread_mutex_unlock(&m_driver_mutex);
+        return filled;
+    }
+    /*! @brief Returns the number of times a buffer was dequeued or queued twice */
+    unsigned int getNumErrors()
+    {
+        pthread_mutex_lock(&m_driver_mutex);
+        unsigned int errors = m_num_errors;
+        pthread_mutex_unlock(&m_driver_mutex);
+        return errors;
+    }
+protected:
+    /*! @brief Waits until a buffer has been filled, filling the oldest queued buffer every period */
+    int waitForFrame(int timeout)
+    {
+        double end = now() + timeout;
+        while (true)
+        {
+            pthread_mutex_lock(&m_driver_mutex);
+            if (m_fail_after > 0 and m_num_filled >= m_fail_after)
+            {
+                pthread_mutex_unlock(&m_driver_mutex);
+                errno = EIO;
+                return -1;
+            }
+            fill();
+            bool ready = not m_done.empty();
+            double next = m_next_time;
+            pthread_mutex_unlock(&m_driver_mutex);
+
+            double time = now();
+            if (ready)
+                return 1;
+            else if (time >= end)
+                return 0;
+            usleep(static_cast<useconds_t>(1000*(min(next, end) - time)) + 100);
+        }
+    }
+
+    /*! @brief Takes the oldest filled buffer */
+    bool dequeue(struct v4l2_buffer& buffer)
+    {
+        pthread_mutex_lock(&m_driver_mutex);
+        if (m_done.empty())
+        {
+            pthread_mutex_unlock(&m_driver_mutex);
+            errno = EAGAIN;
+            return false;
+        }
+        int index = m_done.front();
+        m_done.pop_front();
+        if (m_states[index] != Done)
+            m_num_errors++;
+        m_states[index] = Dequeued;
+        buffer.index = index;
+        buffer.bytesused = CAPTURETEST_SIZE;
+        buffer.flags = 0;
+        #ifdef V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC
+            buffer.flags = V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC;
+        #endif
+        buffer.timestamp.tv_sec = static_cast<long>(m_timestamps[index]/1e3);
+        buffer.timestamp.tv_usec = static_cast<long>(1e3*(m_timestamps[index] - 1e3*buffer.timestamp.tv_sec));
+        pthread_mutex_unlock(&m_driver_mutex);
+        return true;
+    }
+
+    /*! @brief Gives a buffer back to be filled. The buffer must have been dequeued, and not queued since */
+    bool queue(int index)
+    {
+        pthread_mutex_lock(&m_driver_mutex);
+        bool valid = index >= 0 and index < CAPTURETEST_BUFFERS and m_states[index] == Dequeued;
+        if (valid)
+        {
+            m_states[index] = Queued;
+            m_queued.push_back(index);
+        }
+        else
+            m_num_errors++;
+        pthread_mutex_unlock(&m_driver_mutex);
+        if (not valid)
+            errno = EINVAL;
+        return valid;
+    }
+private:
+    /*! @brief Fills the oldest queued buffer with the next frame, if it is time. A frame is dropped if there is no buffer for it,
+               as the driver does. m_driver_mutex must be held.
+     */
+    void fill()
+    {
+        double time = now();
+        while (time >= m_next_time)
+        {
+            if (not m_queued.empty())
+            {
+                int index = m_queued.front();
+                m_queued.pop_front();
+                m_num_filled++;
+                const vector<unsigned char>& frame = m_frames[(m_num_filled - 1) % m_frames.size()];
+                memcpy(&m_buffers[index][0], &frame[0], CAPTURETEST_SIZE);
+                m_sequences[index] = m_num_filled;
+                m_timestamps[index] = m_next_time;
+                m_states[index] = Done;
+                m_done.push_back(index);
+            }
+            m_next_time += m_period;
+        }
+    }
+private:
+    enum BufferState {Queued, Done, Dequeued};
+    const vector<vector<unsigned char> >& m_frames;     //!< the frames to fill the buffers with
+    const double m_period;                              //!< the time between frames in ms
+    const unsigned int m_fail_after;                    //!< the number of frames after which the device fails, or 0
+
+    pthread_mutex_t m_driver_mutex;                     //!< lock for the driver state below; the capture and consumer threads both queue buffers
+    vector<vector<unsigned char> > m_buffers;           //!< the buffers' memory
+    vector<BufferState> m_states;                       //!< the state of each buffer
+    vector<unsigned int> m_sequences;                   //!< the number of the frame in each buffer
+    vector<double> m_timestamps;                        //!< the monotonic capture time of each buffer in ms
+    deque<int> m_queued;                                //!< the buffers waiting to be filled, oldest first
+    deque<int> m_done;                                  //!< the buffers that have been filled, oldest first
+    unsigned int m_num_filled;                          //!< the number of frames that have been filled
+    double m_next_time;                                 //!< the monotonic time the next frame is due in ms
+    unsigned int m_num_errors;                          //!< the number of times a buffer was dequeued or queued twice
+};
+
+/*! @brief Loads the frames of a raw YUV422 file, or generates a test pattern if there is no file
+    @return false if the file has no complete frames
+ */
+static bool loadFrames(const char* filename, vector<vector<unsigned char> >& frames)
+{
+    frames.clear();
+    if (filename == NULL)
+    {   // a pattern that is different in every frame
+        for (int f=0; f<8; f++)
+        {
+            frames.push_back(vector<unsigned char>(CAPTURETEST_SIZE));
+            for (int i=0; i<CAPTURETEST_SIZE; i++)
+                frames.back()[i] = static_cast<unsigned char>(i/2 + 31*f);
+        }
+        return true;
+    }
+
+    ifstream file(filename, ios_base::binary);
+    vector<unsigned char> frame(CAPTURETEST_SIZE);
+    while (file.read(reinterpret_cast<char*>(&frame[0]), CAPTURETEST_SIZE))
+        frames.push_back(frame);
+    return not frames.empty();
+}
+
+/*! @brief Checks the frames taken from the capture thread are in order, with increasing timestamps, and are intact */
+static void testFrames(const vector<vector<unsigned char> >& frames, unsigned int numframes)
+{
+    cout << "frames" << endl;
+    FileCaptureThread capture(frames, CAPTURETEST_PERIOD, 0);
+    capture.start();
+
+    bool ordered = true;
+    bool intact = true;
+    unsigned int last = 0;
+    double lasttime = -1;
+    unsigned int skipped = 0;
+    for (unsigned int i=0; i<numframes; i++)
+    {
+        double timestamp;
+        unsigned int s;
+        int index = capture.grabFrame(timestamp, s);
+        if (index < 0)
+        {
+            check(false, "grabFrame() returns a frame while the device is working");
+            return;
+        }
+        skipped += s;
+        if (i % 3 == 0)
+            usleep(1000*2*CAPTURETEST_PERIOD);     // be slow sometimes so that frames are skipped
+        unsigned int sequence = capture.getSequence(index);
+        ordered = ordered and sequence > last and timestamp > lasttime;
+        const vector<unsigned char>& frame = frames[(sequence - 1) % frames.size()];
+        intact = intact and memcmp(capture.getBuffer(index), &frame[0], CAPTURETEST_SIZE) == 0;
+        last = sequence;
+        lasttime = timestamp;
+    }
+    capture.finish();
+
+    check(ordered, "frames are taken in order with increasing timestamps");
+    check(intact, "frames are not overwritten while they are held");
+    check(skipped > 0 and skipped == capture.getNumSkippedFrames(), "skipped frames are counted");
+    check(capture.getNumErrors() == 0, "no buffer is dequeued or queued twice");
+}
+
+/*! @brief Checks that grabFrame() returns -1 once the device fails, instead of waiting forever */
+static void testFailure(const vector<vector<unsigned char> >& frames)
+{
+    cout << "device failure" << endl;
+    const unsigned int failafter = 5;
+    FileCaptureThread capture(frames, CAPTURETEST_PERIOD, failafter);
+    capture.start();
+
+    double start = now();
+    unsigned int grabbed = 0;
+    double timestamp;
+    unsigned int skipped;
+    while (capture.grabFrame(timestamp, skipped) >= 0 and grabbed <= failafter)
+        grabbed++;
+    check(grabbed <= failafter, "grabFrame() returns -1 once the device has failed");
+    check(now() - start < 1000 + CAPTURETEST_PERIOD*failafter, "grabFrame() returns promptly once the device has failed");
+    check(capture.grabFrame(timestamp, skipped) < 0, "grabFrame() keeps returning -1");
+    check(capture.getNumErrors() == 0, "no buffer is dequeued or queued twice");
+}
+
+static void* finishLater(void* capture)
+{
+    usleep(1000*100);
+    reinterpret_cast<NAOCameraThread*>(capture)->finish();
+    return NULL;
+}
+
+/*! @brief Checks that finish() wakes a grabFrame() that is waiting for a frame that will never come */
+static void testFinish(const vector<vector<unsigned char> >& frames)
+{
+    cout << "finish" << endl;
+    FileCaptureThread capture(frames, 1e9, 0);
+    capture.start();
+
+    pthread_t finisher;
+    pthread_create(&finisher, NULL, finishLater, &capture);
+    double start = now();
+    double timestamp;
+    unsigned int skipped;
+    int index = capture.grabFrame(timestamp, skipped);
+    pthread_join(finisher, NULL);
+    check(index < 0 and now() - start < 1000, "finish() wakes a waiting grabFrame(), which returns -1");
+}
+
+/*! @brief Runs the capture thread on a real V4L2 device, and prints the frame rate */
+static void testDevice(const char* device, unsigned int numframes)
+{
+    cout << device << endl;
+    int fd = open(device, O_RDWR);
+    if (fd < 0)
+    {
+        check(false, string("open ") + device + ": " + strerror(errno));
+        return;
+    }
+
+    struct v4l2_format fmt;
+    memset(&fmt, 0, sizeof(fmt));
+    fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    fmt.fmt.pix.width = CAPTURETEST_WIDTH;
+    fmt.fmt.pix.height = CAPTURETEST_HEIGHT;
+    fmt.fmt.pix.pixelformat = V4L2_PIX_FMT_YUYV;
+    fmt.fmt.pix.field = V4L2_FIELD_NONE;
+    bool ok = ioctl(fd, VIDIOC_S_FMT, &fmt) != -1;
+
+    struct v4l2_requestbuffers rb;
+    memset(&rb, 0, sizeof(rb));
+    rb.count = CAPTURETEST_BUFFERS;
+    rb.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    rb.memory = V4L2_MEMORY_MMAP;
+    ok = ok and ioctl(fd, VIDIOC_REQBUFS, &rb) != -1;
+
+    vector<void*> mem(rb.count, MAP_FAILED);
+    vector<size_t> length(rb.count, 0);
+    for (unsigned int i=0; ok and i<rb.count; i++)
+    {
+        struct v4l2_buffer buffer;
+        memset(&buffer, 0, sizeof(buffer));
+        buffer.index = i;
+        buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buffer.memory = V4L2_MEMORY_MMAP;
+        ok = ioctl(fd, VIDIOC_QUERYBUF, &buffer) != -1;
+        if (ok)
+        {
+            length[i] = buffer.length;
+            mem[i] = mmap(0, buffer.length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, buffer.m.offset);
+            ok = mem[i] != MAP_FAILED and ioctl(fd, VIDIOC_QBUF, &buffer) != -1;
+        }
+    }
+    int type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    ok = ok and ioctl(fd, VIDIOC_STREAMON, &type) != -1;
+    check(ok, string("the device is set up: ") + (ok ? "" : strerror(errno)));
+
+    if (ok)
+    {
+        NAOCameraThread capture(fd, fmt.fmt.pix.sizeimage);
+        capture.start();
+        double start = now();
+        unsigned int grabbed = 0;
+        double timestamp;
+        unsigned int skipped;
+        while (grabbed < numframes and capture.grabFrame(timestamp, skipped) >= 0)
+            grabbed++;
+        double elapsed = now() - start;
+        capture.finish();
+        check(grabbed == numframes, "every frame is taken");
+        cout << "    " << grabbed << " frames at " << 1e3*grabbed/elapsed << " fps, " << capture.getNumSkippedFrames() << " skipped" << endl;
+        ioctl(fd, VIDIOC_STREAMOFF, &type);
+    }
+
+    for (unsigned int i=0; i<mem.size(); i++)
+        if (mem[i] != MAP_FAILED)
+            munmap(mem[i], length[i]);
+    close(fd);
+}
+
+int main(int argc, const char *argv[])
+{
+    debug.open("capturetestdebug.log");
+    errorlog.open("capturetesterror.log");
+    CaptureTestPlatform platform;
+
+    unsigned int numframes = argc > 1 ? atoi(argv[1]) : 60;
+    const char* source = argc > 2 ? argv[2] : NULL;
+    if (source != NULL and strncmp(source, "/dev/", 5) == 0)
+        testDevice(source, numframes);
+    else
+    {
+        vector<vector<unsigned char> > frames;
+        if (not loadFrames(source, frames))
+        {
+            cerr << "capturetest: " << source << " does not contain a complete " << CAPTURETEST_WIDTH << "x" << CAPTURETEST_HEIGHT << " YUV422 frame" << endl;
+            return 1;
+        }
+        testFrames(frames, numframes);
+        testFailure(frames);
+        testFinish(frames);
+    }
+
+    if (failures > 0)
+        cout << failures << " checks failed" << endl;
+    return failures > 0;
+}
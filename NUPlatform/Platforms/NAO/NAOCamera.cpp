@@ -20,6 +20,7 @@
  */
 
 #include "NAOCamera.h"
+#include "NAOCameraThread.h"
 #include "NUPlatform/NUPlatform.h"
 #include "GTAssert.h"
 
@@ -32,6 +33,7 @@
 #include <fcntl.h>
 #include <sys/ioctl.h>
 #include <sys/mman.h>
+#include <unistd.h>
 #include <errno.h>
 #include <stdlib.h>
 
@@ -41,6 +43,8 @@
 #include <bn/i2c/i2c-dev.h>
 #define __STRICT_ANSI__
 
+#define NAOCAMERA_RESTART_DELAY 500         //!< The time in ms to wait before restarting the capture after the device fails
+
 #ifndef V4L2_CID_AUTOEXPOSURE
 #  define V4L2_CID_AUTOEXPOSURE     (V4L2_CID_BASE+32)
 #endif
@@ -145,9 +149,10 @@ std::string controlName(unsigned int id)
 }
 
 NAOCamera::NAOCamera() :
-currentBuf(0),
+currentIndex(-1),
 timeStamp(0),
-storedTimeStamp(Platform->getTime())
+captureThread(0),
+framesSkipped(0)
 {
 #if DEBUG_NUCAMERA_VERBOSITY > 4
     debug << "NAOCamera::NAOCamera()" << endl;
@@ -183,6 +188,7 @@ storedTimeStamp(Platform->getTime())
 
     // enable streaming
     setStreaming(true);
+    startCapture();
 }
 
 NAOCamera::~NAOCamera()
@@ -190,6 +196,10 @@ NAOCamera::~NAOCamera()
 #if DEBUG_NUCAMERA_VERBOSITY > 4
     debug << "NAOCamera::~NAOCamera()" << endl;
 #endif
+  // stop capturing before the buffers go away
+  captureThread->finish();
+  delete captureThread;
+
   // disable streaming
   setStreaming(false);
 
@@ -316,31 +326,72 @@ void NAOCamera::initialiseCamera()
     }
 }
 
-bool NAOCamera::capturedNew()
+/*! @brief Starts a capture thread on the device. The buffers must be queued, and streaming on. */
+void NAOCamera::startCapture()
 {
-  // requeue the buffer of the last captured image which is obselete now
-  if(currentBuf) 
-    VERIFY(ioctl(fd, VIDIOC_QBUF, currentBuf) != -1);
-  
-  // dequeue a frame buffer (this call blocks when there is no new image available) */
-  VERIFY(ioctl(fd, VIDIOC_DQBUF, buf) != -1);
+  captureThread = new NAOCameraThread(fd, SIZE);
+  captureThread->start();
+}
 
-  ASSERT(buf->bytesused == SIZE);
-  currentBuf = buf;
-  timeStamp = storedTimeStamp + 33.0;
-  storedTimeStamp = Platform->getTime();
+/*! @brief Restarts the capture after the device has failed. Streaming is turned off and on again, with every buffer
+           given back to the driver, and a new capture thread is started. The restart is delayed by NAOCAMERA_RESTART_DELAY
+           so that a device which keeps failing does not spin the vision thread.
+ */
+void NAOCamera::restartCapture()
+{
+  errorlog << "NAOCamera::restartCapture(). The capture thread has exited. Restarting the capture in " << NAOCAMERA_RESTART_DELAY << "ms" << endl;
+  captureThread->finish();
+  delete captureThread;
+  captureThread = 0;
+  currentIndex = -1;
+  usleep(1000*NAOCAMERA_RESTART_DELAY);
+
+  int type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+  if (ioctl(fd, VIDIOC_STREAMOFF, &type) == -1)
+    errorlog << "NAOCamera::restartCapture(). VIDIOC_STREAMOFF failed: " << strerror(errno) << endl;
+  for(int i = 0; i < frameBufferCount; ++i)
+  {
+    memset(buf, 0, sizeof(struct v4l2_buffer));
+    buf->index = i;
+    buf->type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf->memory = V4L2_MEMORY_MMAP;
+    if (ioctl(fd, VIDIOC_QBUF, buf) == -1)
+      errorlog << "NAOCamera::restartCapture(). VIDIOC_QBUF " << i << " failed: " << strerror(errno) << endl;
+  }
+  if (ioctl(fd, VIDIOC_STREAMON, &type) == -1)
+    errorlog << "NAOCamera::restartCapture(). VIDIOC_STREAMON failed: " << strerror(errno) << endl;
+  startCapture();
+}
+
+bool NAOCamera::capturedNew()
+{
+  // take the freshest frame from the capture thread (this call blocks when there is no new image available).
+  // the buffer of the last captured image is obselete now, and is given back to the driver.
+  unsigned int skipped = 0;
+  int index = captureThread->grabFrame(timeStamp, skipped);
+  if (index < 0)
+  {   // the device failed and the capture thread has exited, so there will be no more frames until the capture is restarted
+    restartCapture();
+    return false;
+  }
+  currentIndex = index;
+  framesSkipped += skipped;
+  #if DEBUG_NUCAMERA_VERBOSITY > 2
+  if(skipped > 0)
+    debug << "NAOCamera::capturedNew(): " << skipped << " frames skipped (" << framesSkipped << " total)" << endl;
+  #endif
   return true;
 }
 
 const unsigned char* NAOCamera::getImage() const
 {
-  ASSERT(currentBuf);
-  return static_cast<unsigned char*>(mem[currentBuf->index]);
+  ASSERT(currentIndex >= 0);
+  return static_cast<unsigned char*>(mem[currentIndex]);
 }
 
 double NAOCamera::getTimeStamp() const
 {
-  ASSERT(currentBuf);
+  ASSERT(currentIndex >= 0);
   return timeStamp;
 }
 
@@ -30,6 +30,7 @@
 #include "NUPlatform/NUCamera.h"
 #include "NUPlatform/NUCamera/CameraSettings.h"
 #include "Infrastructure/NUImage/NUImage.h"
+class NAOCameraThread;
 
 class NAOCamera : public NUCamera
 {
@@ -50,7 +51,7 @@ private:
 private:
   enum 
     {
-        frameBufferCount = 20, //!< Number of available frame buffers.
+        frameBufferCount = 4, //!< Number of available frame buffers. One held by vision, one waiting and two being filled.
         WIDTH = 640,
         HEIGHT = 480,
         SIZE = WIDTH * HEIGHT * 2
@@ -63,18 +64,24 @@ private:
     void readCameraSettings();
     void openCameraDevice(std::string device_name);
     void setStreaming(bool streaming_on);
+    void startCapture();
+    void restartCapture();
 
     int fd; //!< The file descriptor for the video device.
     void* mem[frameBufferCount]; //!< Frame buffer addresses.
     int memLength[frameBufferCount]; //!< The length of each frame buffer.
     struct v4l2_buffer* buf; //!< Reusable parameter struct for some ioctl calls.
-    struct v4l2_buffer* currentBuf; //!< The last dequeued frame buffer.
-    double timeStamp, //!< Timestamp of the last captured image.
-           storedTimeStamp; //!< Timestamp when the next image recording starts.
+    int currentIndex; //!< The buffer index of the last captured image, or -1.
+    double timeStamp; //!< Timestamp of the last captured image.
+    NAOCameraThread* captureThread; //!< The thread dequeuing frames as soon as they are ready.
+    unsigned int framesSkipped; //!< The number of frames dropped because vision was not ready for them.
     bool capturedNew();
     const unsigned char* getImage() const;
     double getTimeStamp() const;
     CameraSettings::Camera getCurrentCamera();
+public:
+    unsigned int getNumSkippedFrames() const {return framesSkipped;};
+private:
 
     NUImage currentBufferedImage;
     CameraSettings m_cameraSettings[CameraSettings::NUM_CAMERAS];
@@ -0,0 +1,283 @@
+/*! @file NAOCameraThread.cpp
+    @brief Implementation of the camera capture thread.
+
+    @author agent
+
+ Copyright (c) 2026 agent
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "NAOCameraThread.h"
+#include "NUPlatform/NUPlatform.h"
+
+#include "debug.h"
+#include "debugverbositynucamera.h"
+
+#include <cstring>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/ioctl.h>
+#include <linux/videodev2.h>
+
+using namespace std;
+
+#define NAOCAMERA_POLL_TIMEOUT 200          // the poll timeout in ms, a frame is expected every 33ms
+
+/*! @brief Creates the capture thread. It is not started until start() is called.
+    @param fd the file descriptor of the device. Its mmap buffers must be queued, and streaming on.
+    @param framesize the size in bytes of a complete frame
+ */
+NAOCameraThread::NAOCameraThread(int fd, unsigned int framesize) : Thread(string("NAOCameraThread"), 0), m_fd(fd), m_frame_size(framesize)
+{
+    #if DEBUG_NUCAMERA_VERBOSITY > 0
+        debug << "NAOCameraThread::NAOCameraThread(" << fd << ", " << framesize << ")" << endl;
+    #endif
+    pthread_mutex_init(&m_frame_mutex, NULL);
+    pthread_cond_init(&m_frame_condition, NULL);
+    m_finishing = false;
+    m_finished = false;
+    m_latest_index = -1;
+    m_latest_timestamp = 0;
+    m_held_index = -1;
+    m_num_frames = 0;
+    m_num_skipped = 0;
+    m_num_skipped_since_grab = 0;
+}
+
+/*! @brief Stops the capture thread. The device's buffers are left for the owner to release. */
+NAOCameraThread::~NAOCameraThread()
+{
+    #if DEBUG_NUCAMERA_VERBOSITY > 0
+        debug << "NAOCameraThread::~NAOCameraThread()" << endl;
+    #endif
+    finish();
+    pthread_cond_destroy(&m_frame_condition);
+    pthread_mutex_destroy(&m_frame_mutex);
+}
+
+/*! @brief Asks the capture thread to exit, and waits until it has. The thread notices within NAOCAMERA_POLL_TIMEOUT.
+           Any grabFrame() waiting for a frame returns -1. It is safe to call this more than once.
+ */
+void NAOCameraThread::finish()
+{
+    pthread_mutex_lock(&m_frame_mutex);
+    bool joined = m_finishing;
+    m_finishing = true;
+    pthread_cond_broadcast(&m_frame_condition);
+    pthread_mutex_unlock(&m_frame_mutex);
+    if (not joined)
+        join();
+}
+
+/*! @brief Returns the freshest frame, blocking until there is one. The frame returned by the previous call is
+           given back to the driver, so it must no longer be used.
+    @param timestamp will be updated with the time the frame was captured in platform time (ms)
+    @param skipped will be updated with the number of frames dropped since the previous call
+    @return the buffer index of the frame, or -1 if the thread has exited (because the device failed, or finish()
+            was called) and there will be no more frames
+ */
+int NAOCameraThread::grabFrame(double& timestamp, unsigned int& skipped)
+{
+    pthread_mutex_lock(&m_frame_mutex);
+    if (m_held_index >= 0)
+    {
+        requeue(m_held_index);
+        m_held_index = -1;
+    }
+    while (m_latest_index < 0 and not m_finished and not m_finishing)
+        pthread_cond_wait(&m_frame_condition, &m_frame_mutex);
+    if (m_latest_index < 0)
+    {
+        pthread_mutex_unlock(&m_frame_mutex);
+        return -1;
+    }
+
+    m_held_index = m_latest_index;
+    m_latest_index = -1;
+    timestamp = m_latest_timestamp;
+    skipped = m_num_skipped_since_grab;
+    m_num_skipped_since_grab = 0;
+    int index = m_held_index;
+    pthread_mutex_unlock(&m_frame_mutex);
+    return index;
+}
+
+/*! @brief Returns the number of frames dequeued since the thread started */
+unsigned int NAOCameraThread::getNumFrames()
+{
+    pthread_mutex_lock(&m_frame_mutex);
+    unsigned int frames = m_num_frames;
+    pthread_mutex_unlock(&m_frame_mutex);
+    return frames;
+}
+
+/*! @brief Returns the number of frames dropped because a fresher frame arrived before they were taken */
+unsigned int NAOCameraThread::getNumSkippedFrames()
+{
+    pthread_mutex_lock(&m_frame_mutex);
+    unsigned int skipped = m_num_skipped;
+    pthread_mutex_unlock(&m_frame_mutex);
+    return skipped;
+}
+
+/*! @brief The capture loop. Waits for the driver to fill a buffer, and replaces the freshest frame with it.
+           The loop exits when finish() is called or the device fails, and wakes the consumer either way.
+ */
+void NAOCameraThread::run()
+{
+    #if DEBUG_NUCAMERA_VERBOSITY > 0
+        debug << "NAOCameraThread::run()" << endl;
+    #endif
+
+    struct v4l2_buffer buffer;
+    while (not isFinishing())
+    {
+        int ready = waitForFrame(NAOCAMERA_POLL_TIMEOUT);
+        if (ready < 0 and errno == EINTR)
+            continue;
+        else if (ready < 0)
+        {
+            errorlog << "NAOCameraThread::run(). poll failed: " << strerror(errno) << endl;
+            break;
+        }
+        else if (ready == 0)
+        {
+            #if DEBUG_NUCAMERA_VERBOSITY > 0
+                debug << "NAOCameraThread::run(). No frame within " << NAOCAMERA_POLL_TIMEOUT << "ms" << endl;
+            #endif
+            continue;
+        }
+
+        memset(&buffer, 0, sizeof(buffer));
+        buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buffer.memory = V4L2_MEMORY_MMAP;
+        if (not dequeue(buffer))
+        {
+            if (errno == EAGAIN or errno == EINTR)
+                continue;
+            errorlog << "NAOCameraThread::run(). VIDIOC_DQBUF failed: " << strerror(errno) << endl;
+            break;
+        }
+        double timestamp = getPlatformTime(buffer);
+
+        pthread_mutex_lock(&m_frame_mutex);
+        m_num_frames++;
+        if (buffer.bytesused != m_frame_size)
+        {   // an incomplete frame is given straight back to the driver
+            errorlog << "NAOCameraThread::run(). Incomplete frame: " << buffer.bytesused << " of " << m_frame_size << " bytes" << endl;
+            requeue(buffer.index);
+        }
+        else
+        {
+            if (m_latest_index >= 0)
+            {
+                requeue(m_latest_index);
+                m_num_skipped++;
+                m_num_skipped_since_grab++;
+            }
+            m_latest_index = buffer.index;
+            m_latest_timestamp = timestamp;
+            pthread_cond_signal(&m_frame_condition);
+        }
+        pthread_mutex_unlock(&m_frame_mutex);
+    }
+
+    pthread_mutex_lock(&m_frame_mutex);
+    if (not m_finishing)
+        errorlog << "NAOCameraThread is exiting because the device failed." << endl;
+    m_finished = true;
+    pthread_cond_broadcast(&m_frame_condition);
+    pthread_mutex_unlock(&m_frame_mutex);
+}
+
+/*! @brief Returns true once finish() has been called */
+bool NAOCameraThread::isFinishing()
+{
+    pthread_mutex_lock(&m_frame_mutex);
+    bool finishing = m_finishing;
+    pthread_mutex_unlock(&m_frame_mutex);
+    return finishing;
+}
+
+/*! @brief Waits for the driver to fill a buffer
+    @param timeout the longest time to wait in ms
+    @return 1 if a buffer can be dequeued, 0 on a timeout, and -1 on an error (with errno set)
+ */
+int NAOCameraThread::waitForFrame(int timeout)
+{
+    struct pollfd device;
+    device.fd = m_fd;
+    device.events = POLLIN;
+    return poll(&device, 1, timeout);
+}
+
+/*! @brief Takes a filled buffer from the driver
+    @param buffer its type and memory must be set. It will be updated with the buffer.
+    @return false on an error (with errno set)
+ */
+bool NAOCameraThread::dequeue(struct v4l2_buffer& buffer)
+{
+    return ioctl(m_fd, VIDIOC_DQBUF, &buffer) != -1;
+}
+
+/*! @brief Gives a buffer back to the driver to be filled
+    @return false on an error (with errno set)
+ */
+bool NAOCameraThread::queue(int index)
+{
+    struct v4l2_buffer buffer;
+    memset(&buffer, 0, sizeof(buffer));
+    buffer.index = index;
+    buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buffer.memory = V4L2_MEMORY_MMAP;
+    return ioctl(m_fd, VIDIOC_QBUF, &buffer) != -1;
+}
+
+/*! @brief Gives a buffer back to the driver. m_frame_mutex must be held. */
+void NAOCameraThread::requeue(int index)
+{
+    if (not queue(index))
+        errorlog << "NAOCameraThread::requeue(). VIDIOC_QBUF " << index << " failed: " << strerror(errno) << endl;
+}
+
+/*! @brief Returns the time the driver captured the frame in platform time (ms).
+
+    The driver stamps the buffer with either the monotonic clock or the wall clock, neither of which is the
+    platform's time. So the age of the frame is calculated using the same clock as the driver, and subtracted
+    from the current platform time.
+ */
+double NAOCameraThread::getPlatformTime(const struct v4l2_buffer& buffer)
+{
+    double now = Platform->getTime();
+    if (buffer.timestamp.tv_sec == 0 and buffer.timestamp.tv_usec == 0)
+        return now;                     // the driver does not timestamp its buffers
+
+    struct timespec clocknow;
+    #ifdef V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC
+        if ((buffer.flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) == V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC)
+            clock_gettime(CLOCK_MONOTONIC, &clocknow);
+        else
+            clock_gettime(CLOCK_REALTIME, &clocknow);
+    #else
+        clock_gettime(CLOCK_REALTIME, &clocknow);
+    #endif
+
+    double age = 1e3*(clocknow.tv_sec - buffer.timestamp.tv_sec) + 1e-6*clocknow.tv_nsec - 1e-3*buffer.timestamp.tv_usec;
+    if (age < 0 or age > 1000)
+        return now;                     // the stamp is not from either clock we know about
+    return now - age;
+}
+
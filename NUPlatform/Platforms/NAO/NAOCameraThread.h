@@ -0,0 +1,84 @@
+/*! @file NAOCameraThread.h
+    @brief Declaration of the camera capture thread.
+
+    @class NAOCameraThread
+    @brief A thread that dequeues frames from a streaming V4L2 device as soon as they are ready.
+
+    The thread polls the device, and keeps only the freshest frame out of the driver. When a new frame arrives
+    before the previous one has been taken, the previous one is requeued immediately and counted as skipped. So
+    the driver always has buffers to fill, even when the vision thread overruns.
+
+    The consumer takes the freshest frame with grabFrame(), which blocks until there is one. The frame is
+    zero-copy; it stays out of the driver until the next call to grabFrame().
+
+    Only the file descriptor of a device that has had its mmap buffers requested, queued and streaming turned on
+    is required. So the thread works with any V4L2 capture device (eg. the vivid test driver), not only the NAO's.
+    The device is only accessed through waitForFrame(), dequeue() and queue(), so that a stand-in for the driver
+    can be used instead (see CaptureTest/capturetest.cpp). A derived class must call finish() in its destructor.
+
+    If the device fails the thread exits, and grabFrame() returns -1 instead of blocking. The owner is then free
+    to restart the capture. The thread is stopped by finish(), never cancelled, so it never exits holding the lock.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+     This program is free software: you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation, either version 3 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef NAOCAMERATHREAD_H
+#define NAOCAMERATHREAD_H
+
+#include "Tools/Threading/Thread.h"
+
+#include <pthread.h>
+struct v4l2_buffer;
+
+class NAOCameraThread : public Thread
+{
+public:
+    NAOCameraThread(int fd, unsigned int framesize);
+    virtual ~NAOCameraThread();
+
+    void finish();
+    int grabFrame(double& timestamp, unsigned int& skipped);
+    unsigned int getNumFrames();
+    unsigned int getNumSkippedFrames();
+protected:
+    void run();
+    virtual int waitForFrame(int timeout);
+    virtual bool dequeue(struct v4l2_buffer& buffer);
+    virtual bool queue(int index);
+private:
+    bool isFinishing();
+    void requeue(int index);
+    double getPlatformTime(const struct v4l2_buffer& buffer);
+private:
+    const int m_fd;                         //!< the file descriptor of the streaming video device
+    const unsigned int m_frame_size;        //!< the number of bytes in a complete frame; incomplete frames are requeued
+
+    pthread_mutex_t m_frame_mutex;          //!< lock for the frame bookkeeping below
+    pthread_cond_t m_frame_condition;       //!< signalled when a new frame is available, or the thread exits
+    bool m_finishing;                       //!< true once the thread has been asked to exit
+    bool m_finished;                        //!< true once the thread has exited, either because it was asked to or because the device failed
+    int m_latest_index;                     //!< the buffer index of the freshest frame not yet taken, or -1
+    double m_latest_timestamp;              //!< the capture time of the freshest frame in platform time (ms)
+    int m_held_index;                       //!< the buffer index of the frame currently held by the consumer, or -1
+    unsigned int m_num_frames;              //!< the number of frames dequeued since the thread started
+    unsigned int m_num_skipped;             //!< the number of frames requeued without being taken since the thread started
+    unsigned int m_num_skipped_since_grab;  //!< the number of frames requeued without being taken since the last grabFrame()
+};
+
+#endif
+
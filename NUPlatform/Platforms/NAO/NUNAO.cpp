@@ -22,6 +22,7 @@
 #include "NUNAO.h"
 #include "NUbot.h"
 #include "NUbot/SenseMoveThread.h"
+#include "Tools/Logging/AsyncLog.h"
 
 #include <dcmproxy.h>
 #include <boost/bind.hpp>
@@ -43,14 +44,15 @@ NUNAO::NUNAO(ALPtr<ALBroker> pBroker, const string& pName): ALModule(pBroker, pN
 NUNAO::~NUNAO()
 {
     delete m_nubot;
+    AsyncLog::close();
 }
 
 extern "C" int _createModule(ALPtr<ALBroker> pBroker)
 {
-    debug.open("/var/volatile/debug.log");
+    AsyncLog::attach(debug, "/var/volatile/debug.log");
     debug << "NUbot Debug Log" << endl;
     debug << "NUNAO.cpp: _createModule" << endl;
-    errorlog.open("/var/volatile/error.log");
+    AsyncLog::attach(errorlog, "/var/volatile/error.log");
     errorlog << "NUbot Error Log" << endl;
     ALModule::createModule<NUNAO>(pBroker, "NUNAO");
     return 0;
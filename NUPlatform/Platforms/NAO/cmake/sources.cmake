@@ -20,6 +20,7 @@
 SET (YOUR_SRCS  NUNAO.cpp
 		        NAOPlatform.cpp NAOPlatform.h
                 NAOCamera.cpp NAOCamera.h
+                NAOCameraThread.cpp NAOCameraThread.h
                 NAOSensors.cpp NAOSensors.h
                 NAOActionators.cpp NAOActionators.h
                 NAOIO.cpp )
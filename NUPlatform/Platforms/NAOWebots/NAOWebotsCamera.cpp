@@ -20,8 +20,8 @@
  */
 
 #include "NAOWebotsCamera.h"
-#include "Infrastructure/NUImage/ColorModelConversions.h"
-#include "Infrastructure/NUImage/Pixel.h"
+#include "Infrastructure/NUImage/NUImage.h"
+#include "Infrastructure/NUImage/ImageConversions.h"
 #include "NUPlatform/NUPlatform.h"
 
 #include "debug.h"
@@ -50,8 +50,7 @@ NAOWebotsCamera::NAOWebotsCamera(NAOWebotsPlatform* platform)
     debug << "NAOWebotsCamera::NAOWebotsCamera(). Width = " << m_width << " Height = " << m_height << endl;
 #endif
     
-    m_image = new NUImage(m_width, m_height, false);
-    m_yuyv_buffer = new Pixel[m_totalpixels*2];
+    m_image = new NUImage(m_width, m_height, true);
 }
 
 /*! @brief Destory the NAOWebotsCamera
@@ -65,8 +64,6 @@ NAOWebotsCamera::~NAOWebotsCamera()
     }
     if (m_image != NULL)
         delete m_image;
-    if (m_yuyv_buffer != NULL)
-        delete m_yuyv_buffer;
 }
 
 /*! @brief Returns a pointer to a new image.
@@ -77,19 +74,9 @@ NUImage* NAOWebotsCamera::grabNewImage()
 {
     const unsigned char* rgb_image = m_camera->getImage();              // grab the image from webots
     
-    unsigned char y, u, v;
-    int j,k;
-    for (int i=0; i<m_totalpixels; i++)                                 // convert from rgb to yuv422
-    {
-        j = 3*i;
-        ColorModelConversions::fromRGBToYCbCr(rgb_image[j], rgb_image[j + 1], rgb_image[j + 2], y, u, v);
-        m_yuyv_buffer[i].yCbCrPadding = y;
-        m_yuyv_buffer[i].cb = u;
-        m_yuyv_buffer[i].y = y;
-        m_yuyv_buffer[i].cr = v;
-    }
+    for (int y=0; y<m_height; y++)                                      // convert from rgb straight into the image
+        ImageConversions::fromRGBToYCbCr(rgb_image + 3*y*m_width, m_image->m_image[y], m_width);
     
-    m_image->MapBufferToImage(m_yuyv_buffer, m_width, m_height);  // have NUImage use m_yuyv_buffer
     m_image->m_timestamp = Platform->getTime();
     return m_image;
 }
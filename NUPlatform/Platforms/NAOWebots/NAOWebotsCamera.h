@@ -45,8 +45,7 @@ private:
     webots::Camera* m_camera;
     int m_width, m_height, m_totalpixels;
     
-    NUImage* m_image;
-    Pixel* m_yuyv_buffer;
+    NUImage* m_image;                   //!< the image, into which each frame from webots is converted directly
 };
 
 #endif
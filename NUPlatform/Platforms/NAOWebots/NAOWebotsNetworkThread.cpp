@@ -65,14 +65,14 @@ void NAOWebotsNetworkThread::periodicFunction()
             updateBallPosition((RoboCupGameControlDataWebots*)data);
             (*m_game_info) << m_game_packet;
         }
-        else if (memcmp(data, TEAM_PACKET_STRUCT_HEADER, sizeof(TEAM_PACKET_STRUCT_HEADER)-1) == 0 and m_receiver->getDataSize() == sizeof(TeamPacket))
+        else if (memcmp(data, TEAM_PACKET_STRUCT_HEADER, sizeof(TEAM_PACKET_STRUCT_HEADER)-1) == 0 and (size_t) m_receiver->getDataSize() <= TeamPacket::MaxEncodedSize)
         {   // if it is a team packet
             stringstream ss;
-            ss.write((char*) data, sizeof(TeamPacket));
+            ss.write((char*) data, m_receiver->getDataSize());
             ss >> (*m_team_info);
         }
         else
-            cout << "Received " << m_receiver->getDataSize() << " unknown bytes. Want " << sizeof(RoboCupGameControlDataWebots) << " or " << sizeof(TeamPacket) << endl;
+            cout << "Received " << m_receiver->getDataSize() << " unknown bytes. Want " << sizeof(RoboCupGameControlDataWebots) << " or at most " << TeamPacket::MaxEncodedSize << endl;
         m_receiver->nextPacket();
     };
     
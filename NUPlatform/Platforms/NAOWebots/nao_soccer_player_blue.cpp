@@ -11,6 +11,7 @@
 #include "NUbot.h"
 #include "debug.h"
 #include "nubotdataconfig.h"
+#include "Tools/Logging/AsyncLog.h"
 
 #include <sstream>
 #include <string.h>
@@ -42,10 +43,11 @@ int main(int argc, const char *argv[])
     filename_prefix << buffer << " " << setfill('0') << setw(2) << getLogNumber(argc, argv);
     filename_postfix << ".log";
     
-    debug.open((DATA_DIR + filename_prefix.str() + "debug" + filename_postfix.str()).c_str());
-    errorlog.open((DATA_DIR + filename_prefix.str() + "error" + filename_postfix.str()).c_str());
+    AsyncLog::attach(debug, DATA_DIR + filename_prefix.str() + "debug" + filename_postfix.str());
+    AsyncLog::attach(errorlog, DATA_DIR + filename_prefix.str() + "error" + filename_postfix.str());
     
     NUbot* nubot = new NUbot(argc, argv);
     nubot->run();
     delete nubot;
+    AsyncLog::close();
 }
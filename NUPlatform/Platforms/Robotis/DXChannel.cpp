@@ -0,0 +1,218 @@
+/*! @file DXChannel.cpp
+    @brief Implementation of the DXChannel class.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "DXChannel.h"
+#include "DXPort.h"
+#include "dx117.h"
+
+#include "debug.h"
+#include "debugverbositynuplatform.h"
+
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+using namespace std;
+
+/*! @brief Creates and starts the thread for a chain of motors
+    @param name the name of the thread (used entirely for debug purposes)
+    @param port the serial connection to the chain. The channel does not take ownership of it
+ */
+DXChannel::DXChannel(const string& name, DXPort* port) : ConditionalThread(name, 45), m_port(port)
+{
+    #if DEBUG_NUPLATFORM_VERBOSITY > 0
+        debug << "DXChannel::DXChannel(" << name << ")" << endl;
+    #endif
+    m_command = NULL;
+    m_command_length = 0;
+    m_feedback = NULL;
+    m_num_updated = 0;
+    m_busy = false;
+    pthread_mutex_init(&m_busy_mutex, NULL);
+    pthread_cond_init(&m_busy_condition, NULL);
+    start();
+}
+
+DXChannel::~DXChannel()
+{
+    stop();
+    pthread_cond_destroy(&m_busy_condition);
+    pthread_mutex_destroy(&m_busy_mutex);
+}
+
+/*! @brief Adds a block of feedback requests; every block is sent in each transfer in the order they were added.
+    @param request the request packets for the block. The buffer must outlive the channel
+    @param length the length of the request in bytes
+    @param nummotors the number of motors in the block, ie the number of replies to wait for
+ */
+void DXChannel::addRequest(const unsigned char request[], unsigned short length, unsigned char nummotors)
+{
+    m_requests.push_back(request);
+    m_request_lengths.push_back(length);
+    m_request_sizes.push_back(nummotors);
+}
+
+/*! @brief Starts a transfer. Blocks until the previous transfer has finished.
+    @param command the control packets to send. The buffer must not be modified until waitForTransfer returns
+    @param length the length of the control packets in bytes
+    @param feedback the feedback to fill with the replies
+ */
+void DXChannel::startTransfer(const unsigned char command[], unsigned short length, MotorFeedback* feedback)
+{
+    pthread_mutex_lock(&m_busy_mutex);
+    while (m_busy)                                  // the channel's thread is still using the previous command and feedback
+        pthread_cond_wait(&m_busy_condition, &m_busy_mutex);
+    m_command = command;
+    m_command_length = length;
+    m_feedback = feedback;
+    m_busy = true;
+    pthread_mutex_unlock(&m_busy_mutex);
+    signal(true);
+}
+
+/*! @brief Waits for the current transfer to finish
+    @return false if the transfer did not finish within DXCHANNEL_TRANSFER_TIMEOUT
+ */
+bool DXChannel::waitForTransfer()
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_nsec += 1000000*DXCHANNEL_TRANSFER_TIMEOUT;
+    deadline.tv_sec += deadline.tv_nsec/1000000000;
+    deadline.tv_nsec %= 1000000000;
+
+    bool finished = true;
+    pthread_mutex_lock(&m_busy_mutex);
+    while (m_busy and finished)
+        finished = pthread_cond_timedwait(&m_busy_condition, &m_busy_mutex, &deadline) != ETIMEDOUT;
+    finished = not m_busy;
+    pthread_mutex_unlock(&m_busy_mutex);
+    return finished;
+}
+
+/*! @brief Returns the number of motors that replied in the last transfer */
+unsigned char DXChannel::getNumUpdated() const
+{
+    return m_num_updated;
+}
+
+/*! @brief The channel's main loop; perform a transfer each time one is started */
+void DXChannel::run()
+{
+    #if DEBUG_NUPLATFORM_VERBOSITY > 0
+        debug << "DXChannel::run(). Starting " << m_name << "'s mainloop" << endl;
+    #endif
+    while (1)
+    {
+        wait();
+        transfer();
+        pthread_mutex_lock(&m_busy_mutex);
+        m_busy = false;
+        pthread_cond_broadcast(&m_busy_condition);
+        pthread_mutex_unlock(&m_busy_mutex);
+    }
+}
+
+/*! @brief Sends the control packets and every request block, and unpacks the replies into m_feedback */
+void DXChannel::transfer()
+{
+    m_num_updated = 0;
+    if (m_requests.empty())
+    {
+        m_port->write(m_command, m_command_length);
+        return;
+    }
+
+    for (size_t i=0; i<m_requests.size(); i++)
+    {
+        if (i == 0)
+        {   // the control packets and the first request go out in the same write, so there is no gap between them
+            memcpy(m_transmit_buffer, m_command, m_command_length);
+            memcpy(m_transmit_buffer + m_command_length, m_requests[0], m_request_lengths[0]);
+            m_port->write(m_transmit_buffer, m_command_length + m_request_lengths[0]);
+        }
+        else
+            m_port->write(m_requests[i], m_request_lengths[i]);
+
+        // read until every motor in the block has replied, or it is clear that some of them will not
+        unsigned short numbytes = 0;
+        unsigned char numreplies = 0;
+        double deadline = DXPort::getMonotonicTime() + DXCHANNEL_REPLY_TIMEOUT;
+        double remaining = DXCHANNEL_REPLY_TIMEOUT;
+        while (numreplies < m_request_sizes[i] and remaining > 0 and numbytes < DXCHANNEL_BUFFER_LENGTH)
+        {
+            numbytes += m_port->read(m_receive_buffer + numbytes, DXCHANNEL_BUFFER_LENGTH - numbytes, static_cast<int>(remaining));
+            numreplies = unpackReplies(m_receive_buffer, numbytes);
+            remaining = deadline - DXPort::getMonotonicTime();
+        }
+        #if DEBUG_NUPLATFORM_VERBOSITY > 2
+            if (numreplies < m_request_sizes[i])
+                debug << "DXChannel::transfer(). " << m_name << " only got " << static_cast<int>(numreplies) << " of " << static_cast<int>(m_request_sizes[i]) << " replies to block " << i << endl;
+        #endif
+        m_num_updated += numreplies;
+    }
+}
+
+/*! @brief Unpacks every valid feedback reply in data into m_feedback
+
+    DX117 Reply Packet Format: 0xFF, 0xFF, ID, length, error, para1, para2, ..., para(length-2), checksum
+    Anything else (the echo of our own packets, or a packet with a bad checksum) is skipped.
+
+    @param data the bytes read from the chain
+    @param numbytes the number of bytes in data
+    @return the number of replies unpacked
+ */
+unsigned char DXChannel::unpackReplies(const unsigned char data[], unsigned short numbytes)
+{
+    unsigned char numreplies = 0;
+    unsigned short i = 0;
+    while (i + 3 < numbytes)
+    {
+        unsigned char id = data[i+2];
+        unsigned char length = data[i+3];
+        if (data[i] != DX117_START_BYTE or data[i+1] != DX117_START_BYTE or id == DX117_START_BYTE)
+        {
+            i++;
+            continue;
+        }
+        if (i + 3 + length >= numbytes)                 // the rest of the packet has not arrived yet
+            break;
+
+        unsigned char checksum = 0;
+        for (unsigned short j=i+2; j<i+3+length; j++)
+            checksum += data[j];
+        checksum = ~checksum;
+
+        unsigned char index = id <= MOTORS_MAX_ID ? Motors::MotorIDToIndex[id] : 0xFF;
+        if (checksum == data[i+3+length] and length - 2 == NUM_FEEDBACK_MOTOR and id >= MOTORS_MIN_ID and index < MOTORS_NUM_MOTORS)
+        {
+            const unsigned char* parameters = &data[i+5];
+            m_feedback->Positions[index] = ((parameters[1] & 0x3) << 8) + parameters[0];
+            m_feedback->Speeds[index] = ((parameters[3] & 0x3) << 8) + parameters[2];
+            m_feedback->Loads[index] = ((parameters[5] & 0x3) << 8) + parameters[4];
+            m_feedback->Errors[index] = data[i+4];
+            numreplies++;
+            i += 4 + length;
+        }
+        else
+            i++;
+    }
+    return numreplies;
+}
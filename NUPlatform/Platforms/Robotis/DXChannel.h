@@ -0,0 +1,85 @@
+/*! @file DXChannel.h
+    @brief Declaration of the DXChannel class.
+
+    @class DXChannel
+    @brief A thread that performs the serial transfers for a single chain of Dynamixel motors
+
+    There is a DXChannel for the lower body and one for the upper body, so the two chains are
+    serviced at the same time. Each transfer first sends the control packets (sync writes built by
+    Motors) together with the first block of feedback requests in a single write, then sends each of
+    the remaining request blocks as soon as every motor in the previous block has replied (or the
+    reply timeout has passed). The replies are unpacked straight into the MotorFeedback the transfer
+    was given.
+
+    The thread is persistent; Motors starts a transfer with startTransfer() and collects it with
+    waitForTransfer().
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DXCHANNEL_H
+#define DXCHANNEL_H
+
+#include "Tools/Threading/ConditionalThread.h"
+#include "Motors.h"
+class DXPort;
+
+#include <vector>
+#include <string>
+#include <pthread.h>
+
+#define DXCHANNEL_REPLY_TIMEOUT         3000            //!< the time in us to wait for every motor in a request block to reply
+#define DXCHANNEL_TRANSFER_TIMEOUT      20              //!< the time in ms to wait for a whole transfer before giving up on it
+#define DXCHANNEL_BUFFER_LENGTH         1024            //!< the size of the receive buffer for a single request block
+
+class DXChannel : public ConditionalThread
+{
+public:
+    DXChannel(const std::string& name, DXPort* port);
+    ~DXChannel();
+
+    void addRequest(const unsigned char request[], unsigned short length, unsigned char nummotors);
+    void startTransfer(const unsigned char command[], unsigned short length, MotorFeedback* feedback);
+    bool waitForTransfer();
+    unsigned char getNumUpdated() const;
+
+private:
+    void run();
+    void transfer();
+    unsigned char unpackReplies(const unsigned char data[], unsigned short numbytes);
+
+private:
+    DXPort* m_port;                                     //!< the serial connection to the chain
+    std::vector<const unsigned char*> m_requests;       //!< the pre-generated feedback request blocks
+    std::vector<unsigned short> m_request_lengths;      //!< the length in bytes of each request block
+    std::vector<unsigned char> m_request_sizes;         //!< the number of motors in each request block
+
+    const unsigned char* m_command;                     //!< the control packets for the current transfer
+    unsigned short m_command_length;                    //!< the length of m_command
+    MotorFeedback* m_feedback;                          //!< the feedback being filled by the current transfer
+    unsigned char m_num_updated;                        //!< the number of motors that replied in the last transfer
+
+    unsigned char m_transmit_buffer[MOTORS_NUM_MOTORS*MAX_MESSAGE_LENGTH];  //!< the control packets and the first request block
+    unsigned char m_receive_buffer[DXCHANNEL_BUFFER_LENGTH];                //!< the replies to a single request block
+
+    bool m_busy;                                        //!< true while a transfer is in progress
+    pthread_mutex_t m_busy_mutex;                       //!< lock for m_busy
+    pthread_cond_t m_busy_condition;                    //!< signalled when a transfer finishes
+};
+
+#endif
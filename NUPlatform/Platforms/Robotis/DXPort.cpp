@@ -0,0 +1,224 @@
+/*! @file DXPort.cpp
+    @brief Implementation of the DXPort, FTDIPort and TTYPort classes.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "DXPort.h"
+
+#include "debug.h"
+#include "debugverbositynuplatform.h"
+
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/select.h>
+using namespace std;
+
+/*! @brief Returns the monotonic time in microseconds; used for the read timeouts */
+double DXPort::getMonotonicTime()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return 1e6*now.tv_sec + 1e-3*now.tv_nsec;
+}
+
+/*! @brief Opens a channel of the FTDI chip (8 bit bytes, no parity, 1 stop bit)
+    @param device the index of the channel (0 for the lower body, 1 for the upper body)
+    @param baudrate the baud rate
+ */
+FTDIPort::FTDIPort(int device, unsigned int baudrate) : m_device(device), m_open(false)
+{
+    #if DEBUG_NUPLATFORM_VERBOSITY > 0
+        debug << "FTDIPort::FTDIPort(" << device << ", " << baudrate << ")" << endl;
+    #endif
+    if (FT_Open(device, &m_handle) != FT_OK)
+    {
+        errorlog << "FTDIPort::FTDIPort(" << device << "). Unable to open the serial connection" << endl;
+        return;
+    }
+    m_open = true;
+    if (FT_SetBaudRate(m_handle, baudrate) != FT_OK)
+        errorlog << "FTDIPort::FTDIPort(" << device << "). Unable to set the baud rate" << endl;
+    if (FT_SetDataCharacteristics(m_handle, FT_BITS_8, FT_STOP_BITS_1, FT_PARITY_NONE) != FT_OK)
+        errorlog << "FTDIPort::FTDIPort(" << device << "). Unable to set the data characteristics" << endl;
+    if (FT_SetTimeouts(m_handle, 1, 1) != FT_OK)
+        errorlog << "FTDIPort::FTDIPort(" << device << "). Unable to set the timeouts" << endl;
+    // The latency timer is how long the chip holds a partially filled usb packet; the replies are short, so keep it to a minimum
+    if (FT_SetLatencyTimer(m_handle, 1) != FT_OK)
+        errorlog << "FTDIPort::FTDIPort(" << device << "). Unable to set the latency timer" << endl;
+}
+
+FTDIPort::~FTDIPort()
+{
+    if (m_open and FT_Close(m_handle) != FT_OK)
+        errorlog << "FTDIPort::~FTDIPort(). Failed to close channel " << m_device << endl;
+}
+
+/*! @brief Returns true if the channel was opened successfully */
+bool FTDIPort::isOpen() const
+{
+    return m_open;
+}
+
+/*! @brief Writes a buffer to the channel
+    @return true if all of the bytes were written
+ */
+bool FTDIPort::write(const unsigned char data[], unsigned short length)
+{
+    if (not m_open or length == 0)
+        return m_open;
+    DWORD bytessent;
+    FT_STATUS status = FT_Write(m_handle, const_cast<unsigned char*>(data), length, &bytessent);
+    if (status != FT_OK or bytessent != length)
+    {
+        errorlog << "FTDIPort::write(). Only " << bytessent << " of " << length << " bytes were written to channel " << m_device << ", FT_Write returned " << status << endl;
+        return false;
+    }
+    return true;
+}
+
+/*! @brief Reads the bytes that have arrived, waiting up to timeout for the first to arrive
+    @param data the buffer to read into
+    @param maxlength the size of the buffer
+    @param timeout the maximum time to wait in microseconds
+    @return the number of bytes read
+ */
+unsigned short FTDIPort::read(unsigned char data[], unsigned short maxlength, int timeout)
+{
+    if (not m_open)
+        return 0;
+    double deadline = getMonotonicTime() + timeout;
+    DWORD numqueued = 0;
+    while (FT_GetQueueStatus(m_handle, &numqueued) == FT_OK and numqueued == 0 and getMonotonicTime() < deadline)
+        usleep(100);
+    if (numqueued == 0)
+        return 0;
+
+    DWORD numread = 0;
+    if (FT_Read(m_handle, data, numqueued < maxlength ? numqueued : maxlength, &numread) != FT_OK)
+    {
+        errorlog << "FTDIPort::read(). FT_Read failed on channel " << m_device << endl;
+        return 0;
+    }
+    return numread;
+}
+
+/*! @brief Discards anything waiting to be read */
+void FTDIPort::purge()
+{
+    if (m_open)
+        FT_Purge(m_handle, FT_PURGE_RX);
+}
+
+/*! @brief Opens a serial device in raw mode (8 bit bytes, no parity, 1 stop bit)
+    @param path the path of the device
+    @param baudrate the baud rate. It is ignored if the system does not support it, and by pseudo-terminals
+ */
+TTYPort::TTYPort(const string& path, unsigned int baudrate) : m_path(path)
+{
+    #if DEBUG_NUPLATFORM_VERBOSITY > 0
+        debug << "TTYPort::TTYPort(" << path << ", " << baudrate << ")" << endl;
+    #endif
+    m_fd = open(path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (m_fd < 0)
+    {
+        errorlog << "TTYPort::TTYPort(" << path << "). Unable to open the device, errno: " << errno << endl;
+        return;
+    }
+
+    struct termios options;
+    tcgetattr(m_fd, &options);
+    cfmakeraw(&options);
+    options.c_cflag |= CLOCAL | CREAD;
+    #ifdef B1000000
+        if (baudrate == 1000000)
+        {
+            cfsetispeed(&options, B1000000);
+            cfsetospeed(&options, B1000000);
+        }
+    #endif
+    if (tcsetattr(m_fd, TCSANOW, &options) != 0)
+        errorlog << "TTYPort::TTYPort(" << path << "). Unable to set the terminal attributes, errno: " << errno << endl;
+}
+
+TTYPort::~TTYPort()
+{
+    if (m_fd >= 0)
+        close(m_fd);
+}
+
+/*! @brief Returns true if the device was opened successfully */
+bool TTYPort::isOpen() const
+{
+    return m_fd >= 0;
+}
+
+/*! @brief Writes a buffer to the device
+    @return true if all of the bytes were written
+ */
+bool TTYPort::write(const unsigned char data[], unsigned short length)
+{
+    if (m_fd < 0)
+        return false;
+    unsigned short numwritten = 0;
+    while (numwritten < length)
+    {
+        ssize_t n = ::write(m_fd, data + numwritten, length - numwritten);
+        if (n > 0)
+            numwritten += n;
+        else if (n < 0 and errno != EAGAIN and errno != EINTR)
+        {
+            errorlog << "TTYPort::write(). Only " << numwritten << " of " << length << " bytes were written to " << m_path << ", errno: " << errno << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/*! @brief Reads the bytes that have arrived, waiting up to timeout for the first to arrive
+    @param data the buffer to read into
+    @param maxlength the size of the buffer
+    @param timeout the maximum time to wait in microseconds
+    @return the number of bytes read
+ */
+unsigned short TTYPort::read(unsigned char data[], unsigned short maxlength, int timeout)
+{
+    if (m_fd < 0)
+        return 0;
+    fd_set readable;
+    FD_ZERO(&readable);
+    FD_SET(m_fd, &readable);
+    struct timeval wait;
+    wait.tv_sec = timeout/1000000;
+    wait.tv_usec = timeout%1000000;
+    if (select(m_fd + 1, &readable, NULL, NULL, &wait) <= 0)
+        return 0;
+
+    ssize_t n = ::read(m_fd, data, maxlength);
+    return n > 0 ? n : 0;
+}
+
+/*! @brief Discards anything waiting to be read */
+void TTYPort::purge()
+{
+    if (m_fd >= 0)
+        tcflush(m_fd, TCIFLUSH);
+}
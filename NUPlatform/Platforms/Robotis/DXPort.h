@@ -0,0 +1,87 @@
+/*! @file DXPort.h
+    @brief Declaration of the DXPort, FTDIPort and TTYPort classes.
+
+    @class DXPort
+    @brief A serial connection to a single chain of Dynamixel motors
+
+    The bus driver only ever writes whole buffers of packets, and reads whatever has arrived. The motors
+    are normally connected through the two channels of an FTDI chip (FTDIPort), but they can also be
+    a tty (TTYPort); that is how the pseudo-terminals of the motor emulator (dxemulator) are used.
+
+    @class FTDIPort
+    @brief A channel of the FTDI chip, accessed through libftd2xx
+
+    @class TTYPort
+    @brief A serial device, or one end of a pseudo-terminal, accessed through termios
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DXPORT_H
+#define DXPORT_H
+
+#include "ftd2xx.h"
+#include <string>
+
+class DXPort
+{
+public:
+    virtual ~DXPort() {};
+
+    virtual bool isOpen() const = 0;
+    virtual bool write(const unsigned char data[], unsigned short length) = 0;
+    virtual unsigned short read(unsigned char data[], unsigned short maxlength, int timeout) = 0;
+    virtual void purge() = 0;
+
+    static double getMonotonicTime();
+};
+
+class FTDIPort : public DXPort
+{
+public:
+    FTDIPort(int device, unsigned int baudrate);
+    ~FTDIPort();
+
+    bool isOpen() const;
+    bool write(const unsigned char data[], unsigned short length);
+    unsigned short read(unsigned char data[], unsigned short maxlength, int timeout);
+    void purge();
+
+private:
+    int m_device;                           //!< the index of the channel on the FTDI chip
+    FT_HANDLE m_handle;                     //!< the d2xx handle for the channel
+    bool m_open;                            //!< true if the channel was opened successfully
+};
+
+class TTYPort : public DXPort
+{
+public:
+    TTYPort(const std::string& path, unsigned int baudrate);
+    ~TTYPort();
+
+    bool isOpen() const;
+    bool write(const unsigned char data[], unsigned short length);
+    unsigned short read(unsigned char data[], unsigned short maxlength, int timeout);
+    void purge();
+
+private:
+    std::string m_path;                     //!< the path of the device
+    int m_fd;                               //!< the file descriptor of the device, -1 if it could not be opened
+};
+
+#endif
@@ -70,17 +70,9 @@ void DXSerialThread::periodicFunction()
     
     if (m_motors)
     {
-        m_motors->read();
+        m_motors->transfer();
         #ifdef THREAD_SENSEMOVE_PROFILE
-            prof.split("MotorRead");
-        #endif
-        m_motors->write();
-        #ifdef THREAD_SENSEMOVE_PROFILE
-            prof.split("MotorWrite");
-        #endif
-        m_motors->request();
-        #ifdef THREAD_SENSEMOVE_PROFILE
-            prof.split("MotorRequest");
+            prof.split("MotorTransfer");
         #endif
     }
     
@@ -0,0 +1,298 @@
+/*! @file DXEmulator.cpp
+    @brief Implementation of the DXEmulator class.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "DXEmulator.h"
+#include "../dx117.h"
+
+#include "debug.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <math.h>
+using namespace std;
+
+/*! @brief Creates the pseudo-terminal for a chain of motors and links it to link
+    @param link the path to link to the pseudo-terminal (an existing link is replaced)
+    @param motorid the ids of the motors on the chain
+    @param nummotors the length of motorid
+    @param positions the initial position of each motor in motorid
+ */
+DXEmulator::DXEmulator(const string& link, const unsigned char motorid[], unsigned char nummotors, const unsigned short positions[]) : m_link(link)
+{
+    m_slave = -1;
+    m_buffer_length = 0;
+    m_previous_time = 0;
+    memset(m_present, 0, sizeof(m_present));
+    memset(m_tables, 0, sizeof(m_tables));
+    memset(m_positions, 0, sizeof(m_positions));
+    for (unsigned char i=0; i<nummotors; i++)
+    {
+        unsigned char id = motorid[i];
+        m_present[id] = true;
+        m_tables[id][P_ID] = id;
+        m_tables[id][P_BAUD_RATE] = DX117_BAUD_1M;
+        m_tables[id][P_RETURN_LEVEL] = DX117_RETURN_READ;
+        m_tables[id][P_TORQUE_ENABLE] = DX117_TORQUE_OFF;
+        m_positions[id] = positions[i];
+        setWord(id, P_PRESENT_POSITION_L, positions[i]);
+        setWord(id, P_GOAL_POSITION_L, positions[i]);
+        setWord(id, P_TORQUE_LIMIT_L, DX117_MAX_TORQUE);
+    }
+
+    m_master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (m_master < 0 or grantpt(m_master) != 0 or unlockpt(m_master) != 0)
+    {
+        errorlog << "DXEmulator::DXEmulator(" << link << "). Unable to create a pseudo-terminal, errno: " << errno << endl;
+        if (m_master >= 0)
+            close(m_master);
+        m_master = -1;
+        return;
+    }
+    fcntl(m_master, F_SETFL, fcntl(m_master, F_GETFL) | O_NONBLOCK);
+
+    // put the slave into raw mode now, otherwise the line discipline echoes anything written before the client opens it
+    string slavename = ptsname(m_master);
+    m_slave = open(slavename.c_str(), O_RDWR | O_NOCTTY);
+    if (m_slave >= 0)
+    {
+        struct termios options;
+        tcgetattr(m_slave, &options);
+        cfmakeraw(&options);
+        tcsetattr(m_slave, TCSANOW, &options);
+    }
+
+    unlink(m_link.c_str());
+    if (symlink(slavename.c_str(), m_link.c_str()) != 0)
+        errorlog << "DXEmulator::DXEmulator(" << link << "). Unable to link " << slavename << ", errno: " << errno << endl;
+}
+
+/*! @brief Removes the link and closes the pseudo-terminal */
+DXEmulator::~DXEmulator()
+{
+    if (m_master >= 0)
+    {
+        unlink(m_link.c_str());
+        close(m_master);
+    }
+    if (m_slave >= 0)
+        close(m_slave);
+}
+
+/*! @brief Returns true if the pseudo-terminal was created successfully */
+bool DXEmulator::isOpen() const
+{
+    return m_master >= 0;
+}
+
+/*! @brief Returns the file descriptor to poll for received data */
+int DXEmulator::getFileDescriptor() const
+{
+    return m_master;
+}
+
+/*! @brief Reads everything that has been received, and processes each complete packet */
+void DXEmulator::receive()
+{
+    if (m_master < 0)
+        return;
+    ssize_t n;
+    while ((n = read(m_master, m_buffer + m_buffer_length, DXEMULATOR_BUFFER_LENGTH - m_buffer_length)) > 0)
+    {
+        m_buffer_length += n;
+
+        /* DX117 Instruction Packet Format:
+         0xFF, 0xFF, ID, length, instruction, para1, para2, ..., para(length-2), checksum
+         */
+        unsigned short i = 0;
+        while (i + 3 < m_buffer_length)
+        {
+            if (m_buffer[i] != DX117_START_BYTE or m_buffer[i+1] != DX117_START_BYTE or m_buffer[i+2] == DX117_START_BYTE)
+            {
+                i++;
+                continue;
+            }
+            unsigned char length = m_buffer[i+3];
+            if (i + 3 + length >= m_buffer_length)          // the rest of the packet has not arrived yet
+                break;
+
+            unsigned char checksum = 0;
+            for (unsigned short j=i+2; j<i+3+length; j++)
+                checksum += m_buffer[j];
+            checksum = ~checksum;
+            if (length >= 2 and checksum == m_buffer[i+3+length])
+            {
+                process(&m_buffer[i]);
+                i += 4 + length;
+            }
+            else
+                i++;
+        }
+        memmove(m_buffer, m_buffer + i, m_buffer_length - i);
+        m_buffer_length -= i;
+        if (m_buffer_length == DXEMULATOR_BUFFER_LENGTH)    // the buffer is full of rubbish
+            m_buffer_length = 0;
+    }
+}
+
+/*! @brief Moves the present position of each motor that is on toward its goal
+    @param time the current time in ms
+ */
+void DXEmulator::update(double time)
+{
+    double dt = m_previous_time > 0 ? (time - m_previous_time)/1000.0 : 0;
+    m_previous_time = time;
+    for (int id=0; id<256; id++)
+    {
+        if (not m_present[id])
+            continue;
+
+        double speed = 0;
+        if (m_tables[id][P_TORQUE_ENABLE] == DX117_TORQUE_ON)
+        {
+            double error = getWord(id, P_GOAL_POSITION_L) - m_positions[id];
+            unsigned short goalspeed = getWord(id, P_GOAL_SPEED_L);
+            double maxstep = dt*(goalspeed == 0 ? DXEMULATOR_MAX_SPEED : DXEMULATOR_SPEED_UNIT*goalspeed);
+            double step = fabs(error) < maxstep ? error : (error > 0 ? maxstep : -maxstep);
+            m_positions[id] += step;
+            if (dt > 0)
+                speed = step/(dt*DXEMULATOR_SPEED_UNIT);
+        }
+        setWord(id, P_PRESENT_POSITION_L, static_cast<unsigned short>(m_positions[id] + 0.5));
+        // the present speed is a magnitude, with bit 10 set when the motor is turning clockwise
+        unsigned short magnitude = static_cast<unsigned short>(fabs(speed) + 0.5);
+        if (magnitude > DX117_MAX_SPEED)
+            magnitude = DX117_MAX_SPEED;
+        setWord(id, P_PRESENT_SPEED_L, speed < 0 ? magnitude | 0x400 : magnitude);
+        m_tables[id][P_MOVING] = fabs(speed) > 0 ? DX117_MOVING : DX117_NOT_MOVING;
+    }
+}
+
+/*! @brief Acts on a single instruction packet, that has already had its checksum checked */
+void DXEmulator::process(const unsigned char packet[])
+{
+    unsigned char id = packet[2];
+    unsigned char numparameters = packet[3] - 2;
+    unsigned char instruction = packet[4];
+    const unsigned char* parameters = &packet[5];
+    bool broadcast = id == DX117_BROADCASTING_ID;
+    if (not broadcast and not m_present[id])
+        return;
+
+    switch (instruction)
+    {
+        case DX117_PING:
+            if (not broadcast)
+                reply(id, NULL, 0);
+            break;
+        case DX117_READ:
+            if (not broadcast and numparameters == 2 and parameters[0] + parameters[1] <= DXEMULATOR_TABLE_LENGTH)
+                reply(id, &m_tables[id][parameters[0]], parameters[1]);
+            break;
+        case DX117_WRITE:
+            if (numparameters < 2)
+                break;
+            if (broadcast)
+            {
+                for (int i=0; i<256; i++)
+                    if (m_present[i])
+                        write(i, parameters[0], &parameters[1], numparameters - 1);
+            }
+            else
+            {
+                write(id, parameters[0], &parameters[1], numparameters - 1);
+                if (m_tables[id][P_RETURN_LEVEL] == DX117_RETURN_ALL)
+                    reply(id, NULL, 0);
+            }
+            break;
+        case DX117_SYNC_WRITE:
+        {   // address, L, [id, data0, ..., data(L-1)]*
+            if (not broadcast or numparameters < 2)
+                break;
+            unsigned char address = parameters[0];
+            unsigned char length = parameters[1];
+            for (unsigned char i=2; i + length < numparameters; i += length + 1)
+            {
+                if (m_present[parameters[i]])
+                    write(parameters[i], address, &parameters[i+1], length);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+/*! @brief Writes data into a motor's control table; writes beyond the end of the table are ignored */
+void DXEmulator::write(unsigned char motorid, unsigned char address, const unsigned char data[], unsigned char length)
+{
+    for (unsigned char i=0; i<length and address + i < DXEMULATOR_TABLE_LENGTH; i++)
+    {
+        // the present values are read-only; writing to the goal position of a motor that is off turns it on
+        if (address + i >= P_PRESENT_POSITION_L and address + i <= P_MOVING)
+            continue;
+        m_tables[motorid][address + i] = data[i];
+    }
+    if (address <= P_GOAL_POSITION_H and address + length > P_GOAL_POSITION_L)
+        m_tables[motorid][P_TORQUE_ENABLE] = DX117_TORQUE_ON;
+}
+
+/*! @brief Sends a status packet
+    @param motorid the id of the replying motor
+    @param parameters the contents of the status packet
+    @param length the length of parameters
+ */
+void DXEmulator::reply(unsigned char motorid, const unsigned char parameters[], unsigned char length)
+{
+    unsigned char packet[DXEMULATOR_TABLE_LENGTH + 6];
+    packet[0] = DX117_START_BYTE;
+    packet[1] = DX117_START_BYTE;
+    packet[2] = motorid;
+    packet[3] = length + 2;
+    packet[4] = 0;                                          // the error byte; the emulated motors are always healthy
+    for (unsigned char i=0; i<length; i++)
+        packet[5+i] = parameters[i];
+    unsigned char checksum = 0;
+    for (unsigned char i=2; i<5+length; i++)
+        checksum += packet[i];
+    packet[5+length] = ~checksum;
+
+    ssize_t n = ::write(m_master, packet, 6 + length);
+    if (n != 6 + length)
+        errorlog << "DXEmulator::reply(). Unable to reply from motor " << static_cast<int>(motorid) << " on " << m_link << endl;
+}
+
+/*! @brief Returns the two byte value at address in a motor's control table */
+unsigned short DXEmulator::getWord(unsigned char motorid, unsigned char address) const
+{
+    return m_tables[motorid][address] + (m_tables[motorid][address+1] << 8);
+}
+
+/*! @brief Sets the two byte value at address in a motor's control table */
+void DXEmulator::setWord(unsigned char motorid, unsigned char address, unsigned short value)
+{
+    m_tables[motorid][address] = value & 0xFF;
+    m_tables[motorid][address+1] = (value >> 8) & 0xFF;
+}
+
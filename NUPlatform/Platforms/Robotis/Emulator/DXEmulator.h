@@ -0,0 +1,78 @@
+/*! @file DXEmulator.h
+    @brief Declaration of the DXEmulator class.
+
+    @class DXEmulator
+    @brief Emulates a single chain of DX-117 motors on a pseudo-terminal
+
+    The emulator creates a pseudo-terminal and links it to a fixed path, so that Motors can open the
+    chain with a TTYPort instead of the FTDI chip. Each motor has a control table, and the emulator
+    replies to PING and READ instructions with status packets and acts on WRITE and SYNC_WRITE
+    instructions, in the same way the motors do with a status return level of DX117_RETURN_READ.
+    When a motor's torque is on its present position moves toward the goal position at the goal speed.
+
+    The replies are sent as soon as a request is received, regardless of the return delays.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DXEMULATOR_H
+#define DXEMULATOR_H
+
+#include <string>
+
+#define DXEMULATOR_TABLE_LENGTH         0x32            //!< the length of a DX-117 control table (the last address is P_PUNCH_H)
+#define DXEMULATOR_BUFFER_LENGTH        4096            //!< the size of the buffer for partially received packets
+#define DXEMULATOR_SPEED_UNIT           2.29            //!< the speed in position units per second of one goal speed unit (0.111rpm)
+#define DXEMULATOR_MAX_SPEED            2360            //!< the speed in position units per second when the goal speed is 0 (no speed control)
+
+class DXEmulator
+{
+public:
+    DXEmulator(const std::string& link, const unsigned char motorid[], unsigned char nummotors, const unsigned short positions[]);
+    ~DXEmulator();
+
+    bool isOpen() const;
+    int getFileDescriptor() const;
+
+    void receive();
+    void update(double time);
+
+private:
+    void process(const unsigned char packet[]);
+    void write(unsigned char motorid, unsigned char address, const unsigned char data[], unsigned char length);
+    void reply(unsigned char motorid, const unsigned char parameters[], unsigned char length);
+
+    unsigned short getWord(unsigned char motorid, unsigned char address) const;
+    void setWord(unsigned char motorid, unsigned char address, unsigned short value);
+
+private:
+    std::string m_link;                                 //!< the path linked to the pseudo-terminal
+    int m_master;                                       //!< the master side of the pseudo-terminal, -1 if it could not be created
+    int m_slave;                                        //!< the slave side of the pseudo-terminal; held open so the master does not hang up between clients
+
+    bool m_present[256];                                //!< true for each motor id on this chain
+    unsigned char m_tables[256][DXEMULATOR_TABLE_LENGTH];   //!< the control table of each motor on this chain
+    double m_positions[256];                            //!< the present position of each motor in position units (the table only holds whole units)
+
+    unsigned char m_buffer[DXEMULATOR_BUFFER_LENGTH];   //!< the bytes received that have not been processed
+    unsigned short m_buffer_length;                     //!< the number of bytes in m_buffer
+    double m_previous_time;                             //!< the time of the previous update in ms
+};
+
+#endif
+
@@ -0,0 +1,31 @@
+# A CMake file for the Dynamixel motor emulator
+#   - the emulator is a separate executable, so its sources go into DXEMULATOR_SRCS not NUBOT_SRCS
+#   - it only needs the motor constants of the target robot, so it is not built from the rest of the nubot sources
+#
+#    Copyright (c) 2026 agent
+#    This file is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This file is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+
+IF(DEBUG)
+    MESSAGE(STATUS ${CMAKE_CURRENT_LIST_FILE})
+ENDIF()
+
+########## List your source files here! ############################################
+SET (YOUR_SRCS  dxemulator.cpp
+                DXEmulator.cpp DXEmulator.h
+)
+####################################################################################
+
+STRING(REPLACE "/cmake/sources.cmake" "" THIS_SRC_DIR ${CMAKE_CURRENT_LIST_FILE})
+
+SET(DXEMULATOR_SRCS ${TARGET_ROBOT_DIR}/MotorConstants.cpp)
+FOREACH(loop_var ${YOUR_SRCS}) 
+    LIST(APPEND DXEMULATOR_SRCS "${THIS_SRC_DIR}/${loop_var}" )
+ENDFOREACH(loop_var ${YOUR_SRCS})
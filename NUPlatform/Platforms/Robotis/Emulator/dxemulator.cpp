@@ -0,0 +1,104 @@
+/*! @file dxemulator.cpp
+    @brief The dxemulator executable. Emulates the motors of the target robot on pseudo-terminals.
+
+    Usage: dxemulator
+
+    The lower body and upper body chains are linked to MOTORS_EMULATOR_LOWER_DEVICE and MOTORS_EMULATOR_UPPER_DEVICE.
+    Run nubot with NUBOT_DX_EMULATOR=1 in its environment and Motors uses them instead of the FTDI chip, so the whole
+    bus driver (and the rest of nubot) can be run on an ordinary linux machine. The motors start at their default positions with their torque off.
+    Stop the emulator with ctrl-c; the links are removed when it exits.
+    Use a build for the BEAR or CYCLOID with NUBOT_BUILD_DX_EMULATOR ON.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "DXEmulator.h"
+#include "../Motors.h"
+
+#include "debug.h"
+
+#include <signal.h>
+#include <poll.h>
+#include <time.h>
+using namespace std;
+
+ofstream debug;
+ofstream errorlog;
+
+static volatile sig_atomic_t Running = 1;
+
+static void stop(int signum)
+{
+    Running = 0;
+}
+
+/*! @brief Returns the current monotonic time in ms */
+static double now()
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return 1e3*t.tv_sec + 1e-6*t.tv_nsec;
+}
+
+/*! @brief Returns the default position of each motor in motorid */
+static vector<unsigned short> getDefaultPositions(const unsigned char motorid[], unsigned char nummotors)
+{
+    vector<unsigned short> positions(nummotors + 1, 0);
+    for (unsigned char i=0; i<nummotors; i++)
+        positions[i] = MotorConstants::e_DefaultPositions[MotorConstants::e_MotorIDToIndex[motorid[i]]];
+    return positions;
+}
+
+int main(int argc, const char *argv[])
+{
+    debug.open("dxemulatordebug.log");
+    errorlog.open("dxemulatorerror.log");
+
+    vector<unsigned short> lowerpositions = getDefaultPositions(MotorConstants::e_LowerBodyIndexToMotorID, MOTORS_NUM_LOWER_MOTORS);
+    vector<unsigned short> upperpositions = getDefaultPositions(MotorConstants::e_UpperBodyIndexToMotorID, MOTORS_NUM_UPPER_MOTORS);
+    DXEmulator lower(MOTORS_EMULATOR_LOWER_DEVICE, MotorConstants::e_LowerBodyIndexToMotorID, MOTORS_NUM_LOWER_MOTORS, &lowerpositions[0]);
+    DXEmulator upper(MOTORS_EMULATOR_UPPER_DEVICE, MotorConstants::e_UpperBodyIndexToMotorID, MOTORS_NUM_UPPER_MOTORS, &upperpositions[0]);
+    if (not lower.isOpen() or not upper.isOpen())
+    {
+        cerr << "dxemulator: unable to create the pseudo-terminals, see dxemulatorerror.log" << endl;
+        return 1;
+    }
+
+    signal(SIGINT, stop);
+    signal(SIGTERM, stop);
+    cout << "dxemulator: " << MOTORS_NUM_LOWER_MOTORS << " motors on " << MOTORS_EMULATOR_LOWER_DEVICE << ", " << MOTORS_NUM_UPPER_MOTORS << " motors on " << MOTORS_EMULATOR_UPPER_DEVICE << endl;
+
+    struct pollfd fds[2];
+    fds[0].fd = lower.getFileDescriptor();
+    fds[1].fd = upper.getFileDescriptor();
+    fds[0].events = fds[1].events = POLLIN;
+    while (Running)
+    {
+        // the positions are updated at least every millisecond, and before every request is answered
+        poll(fds, 2, 1);
+        double time = now();
+        lower.update(time);
+        upper.update(time);
+        if (fds[0].revents & POLLIN)
+            lower.receive();
+        if (fds[1].revents & POLLIN)
+            upper.receive();
+    }
+    return 0;
+}
+
@@ -22,12 +22,18 @@
 
 #include "dx117.h"
 #include "Motors.h"
+#include "DXPort.h"
+#include "DXChannel.h"
 #include "DXSerialThread.h"
 #include "NUPlatform/NUPlatform.h"
 
 #include "debug.h"
 #include "debugverbositynuplatform.h"
 
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+
 unsigned char* Motors::MotorIDToLowerBody = MotorConstants::e_MotorIDToLowerBody;
 unsigned char* Motors::IndexToMotorID = MotorConstants::e_IndexToMotorID;
 unsigned char* Motors::MotorIDToIndex = MotorConstants::e_MotorIDToIndex;
@@ -43,13 +49,6 @@ unsigned char* Motors::DefaultSlopes = MotorConstants::e_DefaultSlopes;
 unsigned char* Motors::DefaultMargins = MotorConstants::e_DefaultMargins;
 unsigned short* Motors::DefaultPunches = MotorConstants::e_DefaultPunches;
 
-// externally available feedback arrays
-long double JointTime = 0.0;
-long double PreviousJointTime = 0.0;
-unsigned short JointPositions[MOTORS_NUM_MOTORS] =             {000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000}; 
-unsigned short JointSpeeds[MOTORS_NUM_MOTORS] =                {000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000}; 
-unsigned short JointLoads[MOTORS_NUM_MOTORS] =                 {000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000,  000}; 
-
 /*! Create a serial link with the motors
  */
 Motors::Motors()
@@ -61,15 +60,13 @@ Motors::Motors()
     initControlTables();  //<-- I don't need to change this, however, occasionally the motor does resort back to 57k baud rate
     initSlopes();
     initMargins();
+    initChannels();
 
-    request();
-    Platform->msleep(40);
-    read();
-    updateControls(JointPositions, Motors::DefaultSpeeds, Motors::DefaultPunches);
-    
-    struct timespec timenow;
-    clock_gettime(CLOCK_REALTIME, &timenow);
-    StartTime = timenow.tv_nsec/1e6 + timenow.tv_sec*1e3;
+    // get the current positions so that the motors stay where they are until they are told otherwise
+    MotorFeedback feedback;
+    transfer();
+    getFeedback(feedback);
+    updateControls(feedback.Positions, Motors::DefaultSpeeds, Motors::DefaultPunches);
     
     m_thread = new DXSerialThread(this, 13.33);
 }
@@ -79,7 +76,11 @@ Motors::Motors()
 Motors::~Motors()
 {
    delete m_thread;
+   delete lowerChannel;
+   delete upperChannel;
    closeSerial();
+   pthread_mutex_destroy(&ControlMutex);
+   pthread_mutex_destroy(&FeedbackMutex);
 }
 
 /*! @brief Get the Motors instance
@@ -117,6 +118,11 @@ void Motors::initSelf()
    // Initialise motor torques to off
    for (unsigned char i=0; i<MOTORS_NUM_MOTORS; i++)
       MotorTorqueOn[i] = false;
+   // Initialise the feedback to zero (the positions are overwritten by the first transfer)
+   memset(Feedback, 0, sizeof(Feedback));
+   FrontFeedback = 0;
+   pthread_mutex_init(&ControlMutex, NULL);
+   pthread_mutex_init(&FeedbackMutex, NULL);
    return;
 }
 
@@ -129,15 +135,13 @@ void Motors::initSelf()
  
  The request messages are organised as follows:
     The lower and upper body motors are on separate channels, so the messages for each are separate
-    Each channel has the motors separated into blocks of 6 or less, each block of motors is sent requests with the same call to FT_Write, and the reply delays are staggered such that they reply at different times
+    Each channel has the motors separated into blocks of 6 or less, each block of motors is sent requests with the same write, and the reply delays are staggered such that they reply at different times
  
- Essentially, to use the messages
-   FT_Write(lowerbodymessage[0])
-   FT_Write(upperbodymessage[0])
-   wait for reply
-   FT_Write(lowerbodymessage[1])
-   FT_Write(upperbodymessage[1])
-   wait for reply
+ Essentially, to use the messages (this is what each DXChannel does in a transfer)
+   write(lowerbodymessage[0])
+   wait for every motor in the block to reply
+   write(lowerbodymessage[1])
+   wait for every motor in the block to reply
    etc...
  */
 void Motors::initRequestMessages()
@@ -166,6 +170,7 @@ void Motors::initRequestMessages()
          nummotorsinblock = MOTORS_NUM_LOWER_MOTORS - i*MOTORS_NUM_MOTORS_PER_BLOCK;
       else
          nummotorsinblock = MOTORS_NUM_MOTORS_PER_BLOCK;
+      MotorRequestsLowerLength[i] = 0;
       appendPacketsToBuffer(&Motors::LowerBodyIndexToMotorID[i*MOTORS_NUM_MOTORS_PER_BLOCK], nummotorsinblock, DX117_READ, requestdata, 2, MotorRequestsLower[i], NULL, &MotorRequestsLowerLength[i], NULL);
    }
 
@@ -176,6 +181,7 @@ void Motors::initRequestMessages()
          nummotorsinblock = MOTORS_NUM_UPPER_MOTORS - i*MOTORS_NUM_MOTORS_PER_BLOCK;
       else
          nummotorsinblock = MOTORS_NUM_MOTORS_PER_BLOCK;
+      MotorRequestsUpperLength[i] = 0;
       appendPacketsToBuffer(&Motors::UpperBodyIndexToMotorID[i*MOTORS_NUM_MOTORS_PER_BLOCK], nummotorsinblock, DX117_READ, requestdata, 2, NULL, MotorRequestsUpper[i], NULL, &MotorRequestsUpperLength[i]);
    }
 
@@ -186,61 +192,53 @@ void Motors::initRequestMessages()
 
 
 /* Initialise the actual serial connection with the motors
- The connection to the lower body and upper body channels is opened
+ If MOTORS_EMULATOR_VARIABLE is set to anything but 0 the motor emulator's pseudo-terminals are used, otherwise the lower body and upper body
+ channels of the FTDI chip are opened. The choice is logged to the errorlog, so a robot can not be silently left talking to the emulator.
  The baud rate and data characteristics are set (1Mbp, 8bit no parity, 1 stop bit)
  The read and write timeouts are set to 1ms
- The latency timer is set to 2ms (This is the latency between the chip receiving data, and the PC getting it)
+ The latency timer is set to 1ms (This is the latency between the chip receiving data, and the PC getting it)
  */
 void Motors::initSerial()
 {
-   // open, set baud rate, set data characteristics, set timeouts
    #if DEBUG_NUPLATFORM_VERBOSITY > 0
       debug << "MOTORS: Initialising RS-485 dual channel comms to DX-117s." << endl;
    #endif
    
-   // Open
-   FT_STATUS status;
-   status = FT_Open(0, &lowerHandle);
-   if (status != FT_OK)
+   const char* emulator = getenv(MOTORS_EMULATOR_VARIABLE);
+   if (emulator != NULL and strlen(emulator) > 0 and strcmp(emulator, "0") != 0)
+   {
+      errorlog << "MOTORS: " << MOTORS_EMULATOR_VARIABLE << " is set; using the motor emulator on " << MOTORS_EMULATOR_LOWER_DEVICE << " and " << MOTORS_EMULATOR_UPPER_DEVICE << endl;
+      if (access(MOTORS_EMULATOR_LOWER_DEVICE, F_OK) != 0)
+         errorlog << "MOTORS: " << MOTORS_EMULATOR_LOWER_DEVICE << " does not exist; is dxemulator running?" << endl;
+      lowerPort = new TTYPort(MOTORS_EMULATOR_LOWER_DEVICE, MOTORS_BAUD_RATE);
+      upperPort = new TTYPort(MOTORS_EMULATOR_UPPER_DEVICE, MOTORS_BAUD_RATE);
+   }
+   else
+   {
+      errorlog << "MOTORS: Using the FTDI chip" << endl;
+      lowerPort = new FTDIPort(0, MOTORS_BAUD_RATE);
+      upperPort = new FTDIPort(1, MOTORS_BAUD_RATE);
+   }
+   
+   if (not lowerPort->isOpen())
       debug << "MOTORS: Unable to open lower body serial connection" << endl;
-
-   status = FT_Open(1, &upperHandle);
-   if (status != FT_OK)
+   if (not upperPort->isOpen() and MOTORS_NUM_UPPER_MOTORS > 0)
       debug << "MOTORS: Unable to open upper body serial connection" << endl;
+}
+
+/* Initialise the threads that perform the transfers on each channel, and give each the pre-generated request messages
+ The lower and upper body channels are serviced at the same time by separate threads.
+ */
+void Motors::initChannels()
+{
+   // the channels are started after the control tables have been read; they would otherwise eat the replies
+   lowerChannel = new DXChannel("DXLowerChannel", lowerPort);
+   upperChannel = new DXChannel("DXUpperChannel", upperPort);
    
-   // Set Baud Rate
-   status = FT_SetBaudRate(lowerHandle, MOTORS_BAUD_RATE);
-   if (status != FT_OK)
-      debug << "MOTORS: Unable to set lower body serial baud rate" << endl;
-   
-   status = FT_SetBaudRate(upperHandle, MOTORS_BAUD_RATE);
-   if (status != FT_OK)
-      debug << "MOTORS: Unable to set upper body serial baud rate" << endl;
-   
-   // Set Data characteristics (8 bit bytes, no parity, 1 stop bit)
-   status = FT_SetDataCharacteristics(lowerHandle, FT_BITS_8, FT_STOP_BITS_1, FT_PARITY_NONE);
-   if (status != FT_OK)
-      debug << "MOTORS: Unable to set lower body serial data characteristics" << endl;
-   
-   status = FT_SetDataCharacteristics(upperHandle, FT_BITS_8, FT_STOP_BITS_1, FT_PARITY_NONE);
-   if (status != FT_OK)
-      debug << "MOTORS: Unable to set upper body serial data characteristics" << endl;
-   
-   // Set timeouts
-   status = FT_SetTimeouts(lowerHandle, 1, 1);
-   if (status != FT_OK)
-      debug << "MOTORS: Unable to set lower body serial timeouts" << endl;
-   
-   status = FT_SetTimeouts(upperHandle, 1, 1);
-   if (status != FT_OK)
-      debug << "MOTORS: Unable to set upper body serial timeouts" << endl;
-   
-   status = FT_SetLatencyTimer(lowerHandle, 2);
-   if (status != FT_OK)
-      debug << "MOTORS: Unable to set lower latency timer" << endl;
-   status = FT_SetLatencyTimer(upperHandle, 2);
-   if (status != FT_OK)
-      debug << "MOTORS: Unable to set upper latency timer" << endl;
+   for (unsigned char i=0; i<MOTORS_NUM_LOWER_REQUEST_BLOCKS; i++)
+      lowerChannel->addRequest(MotorRequestsLower[i], MotorRequestsLowerLength[i], min(MOTORS_NUM_LOWER_MOTORS - i*MOTORS_NUM_MOTORS_PER_BLOCK, MOTORS_NUM_MOTORS_PER_BLOCK));
+   for (unsigned char i=0; i<MOTORS_NUM_UPPER_REQUEST_BLOCKS; i++)
+      upperChannel->addRequest(MotorRequestsUpper[i], MotorRequestsUpperLength[i], min(MOTORS_NUM_UPPER_MOTORS - i*MOTORS_NUM_MOTORS_PER_BLOCK, MOTORS_NUM_MOTORS_PER_BLOCK));
 }
 
 /* Initialise the motor return delays (ie. the delay between receiving a request for data, and the motor replying)
@@ -284,7 +282,7 @@ void Motors::initControlTables()
    unsigned char readdata[4096];
    unsigned short numbytes = 0;
    sleep(1);
-   readQueue(lowerHandle, readdata, 4096);
+   readQueue(lowerPort, readdata, 4096);
    
    // for each motor read the control table
    unsigned char data[] = {P_ID, 16};           // read 16 bytes starting from P_ID
@@ -294,7 +292,7 @@ void Motors::initControlTables()
    }
    // now I need to wait and then read the buffer
    sleep(1);
-   numbytes = readQueue(lowerHandle, readdata, 4096);
+   numbytes = readQueue(lowerPort, readdata, 4096);
    
    /* DX117 Reply Packet Format:
     0xFF, 0xFF, ID, length, error, para1, para2, ..., para(length-2), checksum
@@ -441,14 +439,8 @@ void Motors::initPunches()
  */
 void Motors::closeSerial()
 {
-   FT_STATUS status;
-   status = FT_Close(lowerHandle);
-   if (status != FT_OK)
-      debug << "MOTORS: Failed to close lower body serial connection" << endl;
-   
-   status = FT_Close(upperHandle);
-   if (status != FT_OK)
-      debug << "MOTORS: Failed to close lower body serial connection" << endl;
+   delete lowerPort;
+   delete upperPort;
 }
 
 /*! @brief Gets the current motor targets in motor units (to be consistent with the rest of the interface)
@@ -456,9 +448,11 @@ void Motors::closeSerial()
  */
 void Motors::getTargets(vector<float>& targets)
 {
+    pthread_mutex_lock(&ControlMutex);
     targets.clear();
     for (unsigned char i=0; i<MOTORS_NUM_MOTORS; i++)
         targets.push_back(255*MotorControls[i][2] + MotorControls[i][1]);
+    pthread_mutex_unlock(&ControlMutex);
 }
 
 /*! @brief Gets the current stiffness of each motor. Because of the present limitations the stiffness is either 0 or 100%.
@@ -506,7 +500,9 @@ void Motors::torqueOn(unsigned char motorid)
    #if DEBUG_NUPLATFORM_VERBOSITY > 2
       debug << "MOTORS: torqueOn " << (int) motorid << endl;
    #endif
+   pthread_mutex_lock(&ControlMutex);
    MotorTorqueOn[MotorIDToIndex[motorid]] = true;
+   pthread_mutex_unlock(&ControlMutex);
 }
 
 /*! Turn on the specified motors and start sending motor controls to those motors
@@ -524,8 +520,9 @@ void Motors::torqueOn(unsigned char motorid[], unsigned char nummotors)
  */
 void Motors::torqueOff(unsigned char motorid)
 {
+    pthread_mutex_lock(&ControlMutex);
     MotorTorqueOn[MotorIDToIndex[motorid]] = false;
-    
+    pthread_mutex_unlock(&ControlMutex);
 }
 
 /*! Turn off the spcified motors and stop sending motor controls to those motors
@@ -551,8 +548,13 @@ void Motors::torqueOff(unsigned char motorid[], unsigned char nummotors)
  */
 void Motors::updateControl(unsigned char motorid, unsigned short position, unsigned short speed, unsigned short punch)
 {
+   pthread_mutex_lock(&ControlMutex);
    if (not MotorTorqueOn[MotorIDToIndex[motorid]])
-      position = JointPositions[MotorIDToIndex[motorid]];
+   {
+      pthread_mutex_lock(&FeedbackMutex);
+      position = Feedback[FrontFeedback].Positions[MotorIDToIndex[motorid]];
+      pthread_mutex_unlock(&FeedbackMutex);
+   }
     
    if (position != (unsigned short) -1)
    {
@@ -584,7 +586,7 @@ void Motors::updateControl(unsigned char motorid, unsigned short position, unsig
       MotorPunches[MotorIDToIndex[motorid]][1] = (unsigned char) (punch & 0xFF);
       MotorPunches[MotorIDToIndex[motorid]][2] = (unsigned char) ((punch >> 8) & 0xFF);
    }
-
+   pthread_mutex_unlock(&ControlMutex);
 }
 
 /*! Update the motors controls and punches, the updated values will be sent ot the motors in the next cycle
@@ -652,25 +654,11 @@ bool Motors::write(unsigned char motorid[], unsigned char nummotors, unsigned ch
    
    appendPacketsToBuffer(motorid, nummotors, command, data, datalength, lowermessagebuffer, uppermessagebuffer, &lowerindex, &upperindex);
    
-   FT_STATUS status;
-   DWORD bytessentlower, bytessentupper;
-
-   status = FT_Write(lowerHandle, lowermessagebuffer, lowerindex, &bytessentlower);
-   status += FT_Write(upperHandle, uppermessagebuffer, upperindex, &bytessentupper);
-   
-   // error checking
-   if (status != FT_OK)
-   {
-      debug << "MOTORS: write(motorid[]) failed with FT_Write returning sum of error codes " << status << endl;
-      return false;
-   }
-   if (bytessentlower+bytessentupper != lowerindex+upperindex) 
-   {
-      debug << "MOTORS: write(motorid[]) failed to write all the data; only " << bytessentlower+bytessentupper << " bytes were written, instead of " << lowerindex+upperindex;
-      return false;
-   }
-   
-   return true;
+   bool success = lowerPort->write(lowermessagebuffer, lowerindex);
+   success &= upperPort->write(uppermessagebuffer, upperindex);
+   if (not success)
+      debug << "MOTORS: write(motorid[]) failed to write all the data" << endl;
+   return success;
 }
 
 /* Writes an instruction packet to the motors
@@ -700,31 +688,20 @@ bool Motors::write(unsigned char motorid, unsigned char command, unsigned char d
    
    appendPacketToBuffer(motorid, command, data, datalength, messagebuffer, &messagelength);
    
-   FT_STATUS status;
-   DWORD bytessent;
-   FT_HANDLE fthandle;
+   bool success;
    if (motorid == DX117_BROADCASTING_ID)
    {
-      status = FT_Write(lowerHandle, messagebuffer, messagelength, &bytessent);
-      status += FT_Write(upperHandle, messagebuffer, messagelength, &bytessent);
+      success = lowerPort->write(messagebuffer, messagelength);
+      success &= upperPort->write(messagebuffer, messagelength);
    }
+   else if (Motors::MotorIDToLowerBody[motorid])
+      success = lowerPort->write(messagebuffer, messagelength);
    else
-   {
-      if (Motors::MotorIDToLowerBody[motorid])
-         fthandle = lowerHandle;
-      else
-         fthandle = upperHandle;
-      status = FT_Write(fthandle, messagebuffer, messagelength, &bytessent);
-   }
+      success = upperPort->write(messagebuffer, messagelength);
    
-   if (status != FT_OK)
+   if (not success)
    {
-      debug << "MOTORS: write failed with FT_Write returning error code " << status << endl;
-      return false;
-   }
-   if (bytessent != messagelength) 
-   {
-      debug << "MOTORS: write failed to write all the data; only " << bytessent << " bytes were written, instead of " << messagelength;
+      debug << "MOTORS: write failed to write all the data" << endl;
       return false;
    }
    
@@ -739,62 +716,6 @@ bool Motors::write(unsigned char motorid, unsigned char command, unsigned char d
    return true;
 }
 
-/* Writes an instruction packet to the motors
- @param motorid, the unique id of the dynamixel to send the command to
- @param command, the instruction command
- @param data[], an array of length datalength containing the data associated with the command
- @param datalength, the length of the data[] array
- 
- @return true if the send was succesful, false if it fails
- */
-bool Motors::write(unsigned char command, unsigned char data[MOTORS_NUM_MOTORS][MOTORS_NUM_CONTROLS])
-{
-   // the idea behind this function, is that it *is* faster to put multiply commands into a single message
-   // Now things are a little complicated because I have two channels; I need two of everything
-   unsigned char lowermessagebuffer[MOTORS_NUM_MOTORS*MAX_MESSAGE_LENGTH];
-   unsigned short lowerindex = 0;
-   unsigned char uppermessagebuffer[MOTORS_NUM_MOTORS*MAX_MESSAGE_LENGTH];
-   unsigned short upperindex = 0;
-   
-   appendPacketsToBuffer(command, data, lowermessagebuffer, uppermessagebuffer, &lowerindex, &upperindex);
-   
-   FT_STATUS status;
-   DWORD bytessentlower, bytessentupper;
-   
-   status = FT_Write(lowerHandle, lowermessagebuffer, lowerindex, &bytessentlower);
-   status += FT_Write(upperHandle, uppermessagebuffer, upperindex, &bytessentupper);
-   
-   // error checking
-   if (status != FT_OK)
-   {
-      debug << "MOTORS: write(motorid[]) failed with FT_Write returning sum of error codes " << status << endl;
-      return false;
-   }
-   if (bytessentlower+bytessentupper != lowerindex+upperindex) 
-   {
-      debug << "MOTORS: write(motorid[]) failed to write all the data; only " << bytessentlower+bytessentupper << " bytes were written, instead of " << lowerindex+upperindex;
-      return false;
-   }
-   
-   return true;
-}
-
-/* Append the control packets (MotorControls) to the lower and upper message buffers
- @param lowermessagebuffer[]: the buffer to store packets to the lower body motors (please ensure it is plenty big)
- @param uppermessagebuffer[]: the buffer to store packets to the upper body motors (please ensure it is plenty big)
- @param lowerindex: the index into lowermessagebuffer[] to start appending the packets, the index will be updated to point to the position after the last one added (so that the index will be both equal to the length, and the position to start appending new data)
- @param upperindex: the index into uppermessagebuffer[] to start appending packets
- */
-void Motors::appendControlPacketsToBuffer(unsigned char lowermessagebuffer[], unsigned char uppermessagebuffer[], unsigned short* lowerindex, unsigned short* upperindex)
-{
-   #if DEBUG_NUPLATFORM_VERBOSITY > 0
-      debug << "appendControlPacketsToBuffer()" << endl;
-   #endif
-   appendPacketsToBuffer(DX117_WRITE, MotorControls, lowermessagebuffer, uppermessagebuffer, lowerindex, upperindex);
-   appendPacketsToBuffer(DX117_WRITE, MotorPunches, lowermessagebuffer, uppermessagebuffer, lowerindex, upperindex);
-   return;
-}
-
 /* Append packets to the buffer (the same command with different data to each motor in the list)
  
  @param motorid[]: the list of motor ids for each of the packets
@@ -868,72 +789,85 @@ void Motors::appendPacketToBuffer(unsigned char motorid, unsigned char command,
    *currentbufferindex = *currentbufferindex + packetlength;
 }
 
-/* Append packets the message buffers (this is a specialised version to simplify and speed up writing controls to motors)
+/* Append the control packets (MotorControls and MotorPunches) for a single channel to its message buffer
+ The controls and punches are each sent with a single sync write to every motor that is on, and the motors that are off
+ are sent a single sync write to turn their torque off (writing a control to a motor that is off would turn it back on).
  
- @param command: the same command is used for each packet
- @param data[][]: carefully formated data for the packets [for each motor][complete packet data (address, data0, data1,...)] 
- @param lowermessagebuffer[]: the buffer to store packets to the lower body motors (please ensure it is plenty big)
- @param uppermessagebuffer[]: the buffer to store packets to the upper body motors (please ensure it is plenty big)
- @param lowerindex: the index into lowermessagebuffer[] to start appending the packets, the index will be updated to point to the position after the last one added (so that the index will be both equal to the length, and the position to start appending new data)
- @param upperindex: the index into uppermessagebuffer[] to start appending packets
+ @param bodyindextomotorid[]: the motor ids on the channel (ie. LowerBodyIndexToMotorID or UpperBodyIndexToMotorID)
+ @param nummotors: the length of bodyindextomotorid[]
+ @param messagebuffer[]: the buffer to store the packets (please ensure it is plenty big)
+ @param currentbufferindex: the index into messagebuffer[] to start appending the packets, the index will be updated to point to the position after the last one added
  */
-void Motors::appendPacketsToBuffer(unsigned char command, unsigned char data[MOTORS_NUM_MOTORS][MOTORS_NUM_CONTROLS], unsigned char lowermessagebuffer[], unsigned char uppermessagebuffer[], unsigned short* lowerindex, unsigned short* upperindex)
+void Motors::appendControlPacketsToBuffer(unsigned char bodyindextomotorid[], unsigned char nummotors, unsigned char messagebuffer[], unsigned short* currentbufferindex)
 {
-    unsigned char torqueoffdata[] = {P_TORQUE_ENABLE, DX117_TORQUE_OFF};
-    unsigned char* messagebuffer;
-    unsigned short* index;
-    for (unsigned short i=0; i<MOTORS_NUM_MOTORS; i++)
-    {
-        if (Motors::MotorIDToLowerBody[Motors::IndexToMotorID[i]])             // decide which buffer this command needs to be added to
-        {
-           messagebuffer = lowermessagebuffer;
-           index = lowerindex;
-        }
-        else
-        {
-           messagebuffer = uppermessagebuffer;
-           index = upperindex;
-        }
-        
-        if (MotorTorqueOn[i])
-            appendPacketToBuffer(Motors::IndexToMotorID[i], command, data[i], MOTORS_NUM_CONTROLS, messagebuffer, index);
-        else                 
-            appendPacketToBuffer(Motors::IndexToMotorID[i], command, torqueoffdata, 2, messagebuffer, index);
-    }
-    return;
+   unsigned char torqueoffdata[] = {DX117_TORQUE_OFF};
+   unsigned char onids[MOTORS_NUM_MOTORS], offids[MOTORS_NUM_MOTORS];
+   unsigned char* controls[MOTORS_NUM_MOTORS];
+   unsigned char* punches[MOTORS_NUM_MOTORS];
+   unsigned char* torqueoff[MOTORS_NUM_MOTORS];
+   unsigned char numon = 0, numoff = 0;
+   for (unsigned char i=0; i<nummotors; i++)
+   {
+      unsigned char index = MotorIDToIndex[bodyindextomotorid[i]];
+      if (MotorTorqueOn[index])
+      {
+         onids[numon] = bodyindextomotorid[i];
+         controls[numon] = &MotorControls[index][1];         // MotorControls[i][0] and MotorPunches[i][0] are the addresses, which go in the header of the sync write
+         punches[numon] = &MotorPunches[index][1];
+         numon++;
+      }
+      else
+      {
+         offids[numoff] = bodyindextomotorid[i];
+         torqueoff[numoff] = torqueoffdata;
+         numoff++;
+      }
+   }
+   appendSyncWriteToBuffer(P_GOAL_POSITION_L, onids, numon, controls, MOTORS_NUM_CONTROLS - 1, messagebuffer, currentbufferindex);
+   appendSyncWriteToBuffer(P_PUNCH_L, onids, numon, punches, MOTORS_NUM_PUNCHES - 1, messagebuffer, currentbufferindex);
+   appendSyncWriteToBuffer(P_TORQUE_ENABLE, offids, numoff, torqueoff, 1, messagebuffer, currentbufferindex);
 }
 
-/* Append packets the message buffers (this is a specialised version to simplify and speed up writing controls to motors)
+/* APPENDS a sync write packet to the passed message buffer; the same address on every motor is written with different data in a single packet.
+ Nothing is appended if nummotors is zero.
  
- @param command: the same command is used for each packet
- @param data[][]: carefully formated data for the packets [for each motor][complete packet data (address, data0, data1,...)] 
- @param lowermessagebuffer[]: the buffer to store packets to the lower body motors (please ensure it is plenty big)
- @param uppermessagebuffer[]: the buffer to store packets to the upper body motors (please ensure it is plenty big)
- @param lowerindex: the index into lowermessagebuffer[] to start appending the packets, the index will be updated to point to the position after the last one added (so that the index will be both equal to the length, and the position to start appending new data)
- @param upperindex: the index into uppermessagebuffer[] to start appending packets
+ Sync write packet format 
+    0xFF, 0xFF, 0xFE, length, 0x83, address, L, id0, data0[0], ..., data0[L-1], id1, data1[0], ..., checksum
+    length = (L + 1)*nummotors + 4
+ 
+ @param address: the address of the first byte to write on each motor
+ @param motorid[]: the ids of the motors to write to
+ @param nummotors: the length of motorid[]
+ @param data[]: an array of pointers to the data for each motor (each entry has to be datalength long)
+ @param datalength: the number of bytes to write to each motor (L)
+ @param messagebuffer[]: the buffer to append the packet to
+ @param currentbufferindex: the position in the messagebuffer where the packet will be placed, it will be updated to point to the position after the packet
  */
-void Motors::appendPacketsToBuffer(unsigned char command, unsigned char data[MOTORS_NUM_MOTORS][MOTORS_NUM_PUNCHES], unsigned char lowermessagebuffer[], unsigned char uppermessagebuffer[], unsigned short* lowerindex, unsigned short* upperindex)
+void Motors::appendSyncWriteToBuffer(unsigned char address, unsigned char motorid[], unsigned char nummotors, unsigned char* data[], unsigned char datalength, unsigned char messagebuffer[], unsigned short* currentbufferindex)
 {
-   unsigned char* messagebuffer;
-   unsigned short* index;
-   for (unsigned short i=0; i<MOTORS_NUM_MOTORS; i++)
+   if (nummotors == 0)
+      return;
+   unsigned short offset = *currentbufferindex;
+   unsigned char checksum = 0;
+   
+   messagebuffer[offset++] = 0xFF;
+   messagebuffer[offset++] = 0xFF;
+   messagebuffer[offset++] = DX117_BROADCASTING_ID;
+   messagebuffer[offset++] = (datalength + 1)*nummotors + 4;
+   messagebuffer[offset++] = DX117_SYNC_WRITE;
+   messagebuffer[offset++] = address;
+   messagebuffer[offset++] = datalength;
+   for (unsigned char i=0; i<nummotors; i++)
    {
-      if (MotorTorqueOn[i])            // writing to a motor that is off will turn it back on
-      {
-         if (Motors::MotorIDToLowerBody[Motors::IndexToMotorID[i]])             // decide which buffer this command needs to be added to
-         {
-            messagebuffer = lowermessagebuffer;
-            index = lowerindex;
-         }
-         else
-         {
-            messagebuffer = uppermessagebuffer;
-            index = upperindex;
-         }
-         appendPacketToBuffer(Motors::IndexToMotorID[i], command, data[i], MOTORS_NUM_PUNCHES, messagebuffer, index);
-      }
+      messagebuffer[offset++] = motorid[i];
+      for (unsigned char j=0; j<datalength; j++)
+         messagebuffer[offset++] = data[i][j];
    }
-   return;
+   
+   for (unsigned short i=*currentbufferindex+2; i<offset; i++)
+      checksum += messagebuffer[i];
+   messagebuffer[offset++] = ~checksum;
+   *currentbufferindex = offset;
 }
 
 /* Writes an instruction packet to all motors using the broadcast id
@@ -977,20 +911,11 @@ bool Motors::broadcast(unsigned char command, unsigned char data[], unsigned sho
       checksum += messagebuffer[i];          // it is OK if the checksum overflows, because it needs to be clipped to a single byte anyway
    messagebuffer[messagelength-1] = ~checksum;
    
-   FT_STATUS status;
-   DWORD bytessent;
-   
-   status = FT_Write(lowerHandle, messagebuffer, messagelength, &bytessent);
-   status = FT_Write(upperHandle, messagebuffer, messagelength, &bytessent);
-   
-   if (status != FT_OK)
+   bool success = lowerPort->write(messagebuffer, messagelength);
+   success &= upperPort->write(messagebuffer, messagelength);
+   if (not success)
    {
-      debug << "MOTORS: broadcast failed with FT_Write returning error code " << status << endl;
-      return false;
-   }
-   if (bytessent != messagelength) 
-   {
-      debug << "MOTORS: broadcast failed to write all the data; only " << bytessent << " bytes were written, instead of " << messagelength;
+      debug << "MOTORS: broadcast failed to write all the data" << endl;
       return false;
    }
    
@@ -1005,235 +930,88 @@ bool Motors::broadcast(unsigned char command, unsigned char data[], unsigned sho
    return true;
 }
 
-/*! Sends MotorControls[][] to the motors (ie. control to motors, every motor that has MotorTorqueOn[i] == true, will get the controls in MotorControls[i][])
+/*! Sends MotorControls[][] to the motors, and gets new feedback from them (every motor that has MotorTorqueOn[i] == true will get the controls in MotorControls[i][])
  To control the motors:
    updateControls(newpositions, newspeeds)
-   write()        <--- this function
+   transfer()        <--- this function
+ 
+ The control packets are built for each channel, and then both channels send them along with the requests at the same time.
+ The replies are unpacked into the back buffer of the feedback, which becomes the front buffer once both channels are finished.
+ 
+ Note. This function takes as long as the slowest channel takes to get all of the replies, and it must only be called
+ from a single thread (the DXSerialThread once the constructor has finished).
+ 
+ @return true if both channels finished their transfer. If not, the feedback is not updated
  */
-bool Motors::write()
+bool Motors::transfer()
 {
-   unsigned char lowermessagebuffer[MOTORS_NUM_MOTORS*MAX_MESSAGE_LENGTH];
+   // a transfer that timed out may still be sending the command buffers and filling the back buffer, so none of them can be touched until it is done
+   if (not lowerChannel->waitForTransfer() or not upperChannel->waitForTransfer())
+   {
+      errorlog << "MOTORS: the previous transfer has still not finished; skipping this one" << endl;
+      return false;
+   }
+   
    unsigned short lowerindex = 0;
-   unsigned char uppermessagebuffer[MOTORS_NUM_MOTORS*MAX_MESSAGE_LENGTH];
    unsigned short upperindex = 0;
+   pthread_mutex_lock(&ControlMutex);
+   appendControlPacketsToBuffer(Motors::LowerBodyIndexToMotorID, MOTORS_NUM_LOWER_MOTORS, LowerCommand, &lowerindex);
+   appendControlPacketsToBuffer(Motors::UpperBodyIndexToMotorID, MOTORS_NUM_UPPER_MOTORS, UpperCommand, &upperindex);
+   pthread_mutex_unlock(&ControlMutex);
    
-   appendControlPacketsToBuffer(lowermessagebuffer, uppermessagebuffer, &lowerindex, &upperindex);
-      
-   FT_STATUS status;
-   DWORD bytessentlower, bytessentupper;
-   
-   // I want this function to be as fast as fast can be, so it is 'hard-coded' and threaded
-   pthread_t lowerthread, upperthread;
-   
-   // ----------------------------- status = FT_Write(lowerHandle, lowermessagebuffer, lowerindex, &bytessentlower);
-   ThreadLowerWrite.Handle = lowerHandle;
-   ThreadLowerWrite.Buffer = lowermessagebuffer;
-   ThreadLowerWrite.BufferLength = lowerindex;
-   
-   // create the lower thread, and set its priority
-   int err = pthread_create(&lowerthread, NULL, runThreadedWrite, (void*) &ThreadLowerWrite);
-   sched_param param;
-   param.sched_priority = 40;
-   pthread_setschedparam(lowerthread, SCHED_FIFO, &param);
+   // the motors that do not reply keep their previous feedback. Only this function changes FrontFeedback, so it can read the front without the lock
+   MotorFeedback* back = &Feedback[1 - FrontFeedback];
+   *back = Feedback[FrontFeedback];
    
-   // ----------------------------- status += FT_Write(upperHandle, uppermessagebuffer, upperindex, &bytessentupper);
-   ThreadUpperWrite.Handle = upperHandle;
-   ThreadUpperWrite.Buffer = uppermessagebuffer;
-   ThreadUpperWrite.BufferLength = upperindex;
-   
-   // create the lower thread, and set its priority
-   err = pthread_create(&upperthread, NULL, runThreadedWrite, (void*) &ThreadUpperWrite);
-   param.sched_priority = 39;
-   pthread_setschedparam(upperthread, SCHED_FIFO, &param);
-   
-   pthread_join(lowerthread, NULL);
-   pthread_join(upperthread, NULL);
-   
-   return true;
-}
-
-/*! Request new feedback from the data;  A request packet is sent to each motor all nicely timed so that the replies will appear in the read buffer some time later ;)
- 
- Note. This function can take sometime to return (4ms or so)
- */
-bool Motors::request()
-{
-    FT_STATUS status;
-    DWORD bytessentlower, bytessentupper;
-    
-    pthread_t lowerthread, upperthread;
-    sched_param lowerparam, upperparam;
-    lowerparam.sched_priority = 40;
-    upperparam.sched_priority = 39;
-    
-    unsigned char numblocks = max(MOTORS_NUM_LOWER_REQUEST_BLOCKS, MOTORS_NUM_UPPER_REQUEST_BLOCKS);
-    ThreadLowerWrite.Handle = lowerHandle;
-    ThreadUpperWrite.Handle = upperHandle;
-    for (unsigned char i=0; i<numblocks; i++)
-    {
-        // lower motors
-        ThreadLowerWrite.Buffer = MotorRequestsLower[i];
-        ThreadLowerWrite.BufferLength = MotorRequestsLowerLength[i];
-        pthread_create(&lowerthread, NULL, runThreadedWrite, (void*) &ThreadLowerWrite);
-        pthread_setschedparam(lowerthread, SCHED_FIFO, &lowerparam);
-        // upper motors
-        ThreadUpperWrite.Buffer = MotorRequestsUpper[i];
-        ThreadUpperWrite.BufferLength = MotorRequestsUpperLength[i];
-        pthread_create(&upperthread, NULL, runThreadedWrite, (void*) &ThreadUpperWrite);
-        pthread_setschedparam(upperthread, SCHED_FIFO, &upperparam);
-        
-        // wait for the threads to complete
-        pthread_join(lowerthread, NULL);
-        pthread_join(upperthread, NULL);
-        
-        // sleep for a little while
-        struct timespec nextRunTime;                    // The absolute time for the main thread to be executed
-        clock_gettime(CLOCK_REALTIME, &nextRunTime);    // Initialise the next run time to be now
-        // calculation of next run time
-        nextRunTime.tv_nsec += 1e9*2e-3;
-        if (nextRunTime.tv_nsec > 1e9)              // we need to be careful with the nanosecond clock overflowing...
-        {
-            nextRunTime.tv_sec += 1;
-            nextRunTime.tv_nsec -= 1e9;
-        }
-        clock_nanosleep(CLOCK_REALTIME, TIMER_ABSTIME, &nextRunTime, NULL);
-    }
-    return true;
-}
-
-/* Read numbytes of data on ftHandle and put it into data[]
- @param fthandle: the handle of the d2xx channel
- @param data[]: the array that is going to get the read data (make sure it is big enough)
- @param numbytestoread: the number of bytes to read
- 
- @return returns true if the correct number of bytes have been read, returns false if it was less
- */
-bool Motors::read(FT_HANDLE fthandle, unsigned char data[], unsigned short numbytestoread)
-{
-   #if DEBUG_NUPLATFORM_VERBOSITY > 0
-      debug << "MOTORS: Reading buffer:" << endl;
-   #endif
-   FT_STATUS status;
-   DWORD numbytesread;
-   status = FT_Read(fthandle, data, numbytestoread, &numbytesread);
-   if (status != FT_OK)
-   {
-      debug << "MOTORS: read failed with FT_READ error code: " << status << endl;
+   lowerChannel->startTransfer(LowerCommand, lowerindex, back);
+   upperChannel->startTransfer(UpperCommand, upperindex, back);
+   bool success = lowerChannel->waitForTransfer();
+   success &= upperChannel->waitForTransfer();
+   if (not success)
+   {  // the late channel is still writing to the back buffer, so the front buffer is kept until the next transfer
+      errorlog << "MOTORS: transfer did not finish within " << DXCHANNEL_TRANSFER_TIMEOUT << "ms" << endl;
       return false;
    }
    
-   #if DEBUG_NUPLATFORM_VERBOSITY > 1
-      debug << "MOTORS: Bytes read: " << numbytesread << " :";
-      for (unsigned short i=0; i<numbytesread; i++)
-         debug << (int)data[i] << ", ";
-      debug << endl;
-   #endif
-   #if DEBUG_NUPLATFORM_VERBOSITY > 0
-      debug << numbytesread << endl;
+   back->Time = Platform->getTime();
+   back->NumUpdated = lowerChannel->getNumUpdated() + upperChannel->getNumUpdated();
+   #if DEBUG_NUPLATFORM_VERBOSITY > 2
+      debug << "MOTORS: transfer updated " << (int)back->NumUpdated << " of " << MOTORS_NUM_MOTORS << " motors" << endl;
    #endif
-   if (numbytesread != numbytestoread)
-      return false;
    
-   return true;
+   pthread_mutex_lock(&FeedbackMutex);
+   FrontFeedback = 1 - FrontFeedback;
+   pthread_mutex_unlock(&FeedbackMutex);
+   return success;
 }
 
-/* Return the number of bytes waiting in the d2xx buffer
+/*! @brief Gets a copy of the latest feedback from the motors
+    @param feedback will be updated with the feedback from the last completed transfer
  */
-unsigned short Motors::getNumBytesInQueue(FT_HANDLE fthandle)
+void Motors::getFeedback(MotorFeedback& feedback)
 {
-   DWORD numbytes;
-   FT_STATUS status = FT_GetQueueStatus(fthandle, &numbytes);
-   if (status != FT_OK)
-   {
-      debug << "MOTORS: getNumBytesInQueue failed to get the number of bytes in the queue; error code " << status;
-      return 0;
-   }
-   return numbytes;
+   pthread_mutex_lock(&FeedbackMutex);
+   feedback = Feedback[FrontFeedback];
+   pthread_mutex_unlock(&FeedbackMutex);
 }
 
-/* Read upto maxdatalength bytes on fthandle into data
- @param fthandle: the handle to the d2xx channel
+/* Read everything in the port's queue into data
+ @param port: the serial connection
  @param data[]: the array to get the data (make sure it is at least maxdatalength long)
  @param maxdatalength: the maximum number of bytes to read
  
  @return the number of bytes in the queue that were read
  */
-unsigned short Motors::readQueue(FT_HANDLE fthandle, unsigned char data[], unsigned short maxdatalength)
+unsigned short Motors::readQueue(DXPort* port, unsigned char data[], unsigned short maxdatalength)
 {
-   //debug << "MOTORS: readQueue" << endl;
-   unsigned short numbytesinqueue = getNumBytesInQueue(fthandle);
-   if (numbytesinqueue > maxdatalength)
-      numbytesinqueue = maxdatalength;
-   read(fthandle, data, numbytesinqueue);
-   return numbytesinqueue;
-}
-
-/* Unpack the contents of readdata and copy the results into the global feedback arrays
- 
- This function scans through readdata looking for valid packets (need to have a valid header and checksum, if not the packet is discarded).
- When a valid packet is found the id is used to update jointPositions[id], jointSpeeds[id], jointLoads[id]
- @param readdata[]: the data to be used to update the feedback arrays
- @param numbytes: the length of readdata[]
- 
- @return the number of successfully updated motors
- */
-unsigned char Motors::updateFeedbackData(unsigned char readdata[], unsigned short numbytes)
-{
-   // debug << "MOTORS: UpdateFeedbackData" << numbytes << endl;
-   
-   /* DX117 Reply Packet Format:
-    0xFF, 0xFF, ID, length, error, para1, para2, ..., para(length-2), checksum
-    */
-   unsigned short index = 0;
-   unsigned char id, length, error, checksum, calculatedchecksum;
-   unsigned char packetdata[MAX_MESSAGE_LENGTH];                          // [parm0, parm1, ... , parmN];
-   unsigned short numupdates = 0;
-   // scan through and find the first header
-   while (index < numbytes)
+   unsigned short numbytes = 0;
+   unsigned short numread = 0;
+   do
    {
-      if(findHeader(readdata, numbytes, &index))
-      {
-         // debug << "MOTORS: scanData: header end at index: " << index << endl;
-         if (index + 2 < numbytes)
-         {
-            index++;
-            id = readdata[index];
-            index++;
-            length = readdata[index];
-         }
-         // debug << "MOTORS: scanData: id: " << (int)id << " length: " << (int)length << endl;
-         if (length < MAX_MESSAGE_LENGTH)
-         {
-            if (index + length < numbytes)
-            {
-               index++;
-               error = readdata[index];
-               index++;
-               calculatedchecksum = id + length + error;
-               for (unsigned char i=0; i<length-2; i++)
-               {
-                  packetdata[i] = readdata[index + i];
-                  calculatedchecksum += packetdata[i];
-               }
-               index += length - 2;
-               checksum = readdata[index];
-               calculatedchecksum = ~calculatedchecksum;
-            
-               if ((calculatedchecksum == checksum) && ((length - 2) == NUM_FEEDBACK_MOTOR) && id < MOTORS_MAX_ID && id > MOTORS_MIN_ID)
-               {
-                  if (error > 0)
-                     debug << "MOTORS: Motor " << (int)id << " has error " << (int)error << ", you should look into it ;)" << endl;
-                  int index = MotorIDToIndex[id];
-                  JointPositions[index] = ((packetdata[1] & 0x3) << 8) + packetdata[0];
-                  JointSpeeds[index] = ((packetdata[3] & 0x3) << 8) + packetdata[2];
-                  JointLoads[index] = ((packetdata[5] & 0x3) << 8) + packetdata[4];
-                  numupdates++;
-               }
-            }
-         }
-      }
-   }
-   return numupdates;
+      numread = port->read(data + numbytes, maxdatalength - numbytes, 0);
+      numbytes += numread;
+   } while (numread > 0 and numbytes < maxdatalength);
+   return numbytes;
 }
 
 /* Scans through readdata looking for a header. If one is found true is return and index is left at the second start byte.
@@ -1259,38 +1037,3 @@ bool Motors::findHeader(unsigned char readdata[], unsigned short numbytes, unsig
    return false;
 }
 
-/*! Read the serial buffer and update the global feedback arrays
- */
-bool Motors::read()
-{
-   unsigned char data[4096];
-   unsigned short bytesread;
-   
-   struct timespec time;
-   clock_gettime(CLOCK_REALTIME, &time);
-   JointTime = (time.tv_nsec/1e6 + time.tv_sec*1e3) - StartTime;
-   
-   bytesread = readQueue(lowerHandle, data, 4096);
-   updateFeedbackData(data, bytesread);
-   bytesread = readQueue(upperHandle, data, 4096);
-   updateFeedbackData(data, bytesread);
-   return true;
-}
-
-/* Threaded write to a motor serial channel. The structure passed as an arguement contains all of the data necessary to perform the write
- This is not a class function because it is too hard to create a thread using a class member.
- 
- @param arg threaddata_t where arg->Handle, arg->Buffer and arg->BufferLength contain the relavent data
- */
-void* runThreadedWrite(void *arg)
-{
-   threaddata_t* data = (threaddata_t*) arg; 
-   
-   DWORD bytessent;
-   FT_STATUS status = FT_Write(data->Handle, data->Buffer, data->BufferLength, &bytessent);
-   pthread_exit(NULL);
-}
-
-
-
-
@@ -4,17 +4,18 @@
     @class Motors
     @brief A serial communication class with the servo motors in the bear
  
-    The serial communication for channel 0 and 1 is done in parallel, and much of the serial
-    packet contents are cached. 
+    The serial communication for channel 0 and 1 is done in parallel by a DXChannel thread for each,
+    and much of the serial packet contents are cached. 
  
-    Serial writes are straight forward all of the data is added to two binary buffers and then written to each channel.
-    Only a single function call is required 'write()' which copies everything stored in MotorControls and MotorPunches 
-    to the servo motors.
+    Each control cycle is a single call to 'transfer()'. Everything stored in MotorControls and MotorPunches is
+    packed into sync write packets (one per register block per channel), and sent together with the first block
+    of feedback requests. The requests rely on staggering the return delays of blocks of motors so that multiple
+    motors can reply at once; the next block is requested as soon as every motor in the previous block has replied.
+    The replies are unpacked into the back buffer of a double buffered MotorFeedback, which becomes the front buffer
+    once both channels have finished. Use getFeedback() to get a copy of the latest feedback.
  
-    Serial reads require two steps. The first step is to request the new sensor data with 'request()', the second step
-    is to copy it from the usb buffer to the global sensor arrays with 'read()'. The request() is a little tricky
-    because it relys on staggering the return delays of blocks of motors so that multiple motors can reply at once.
-    Thus, call request() then sometime later data will be available to read()
+    If NUBOT_DX_EMULATOR is set in the environment, the pseudo-terminals of the motor emulator (dxemulator) are used
+    instead of the FTDI chip, so the bus driver can be run on an ordinary linux machine.
  
     MOTORS_NUM_MOTORS specifies the number of degrees of freedom of the robot.
     MOTORS_NUM_LOWER_MOTORS specifies the number of degrees of freedom on channel 0
@@ -23,8 +24,6 @@
     This class is very old, and not very flexible. The following areas could be improved:
         - It should be updated to use stl vectors so that the number of motors doesn't need to be hard coded. 
         - It should also be updated to use the new libftdi (instead of libftd2xx). 
-        - It should be updated to not use global variables to store the sensor data.
-        - The threading does need to have quite so much copypasta
 
     @author Jason Kulk
  
@@ -48,6 +47,8 @@
 #define MOTORS_H
 
 class DXSerialThread;
+class DXChannel;
+class DXPort;
 class ConditionalThread;
 
 #include "targetconfig.h"
@@ -57,7 +58,7 @@ class ConditionalThread;
     #include "../Cycloid/MotorConstants.h"
 #endif
 
-#include "ftd2xx.h"
+#include <pthread.h>
 #include <vector>
 #include <iostream>
 #include <fstream>
@@ -70,19 +71,19 @@ using namespace std;
 #define MOTORS_NUM_PUNCHES                1+2            // the number of bytes used to change the 'punch' of the motors (this includes the write address)
 #define MAX_MESSAGE_LENGTH                100
 
-// Globally availiable feedback arrays (be aware that accessing them is inherently not thread-safe, but I do make an effort to not update them until control has finished)
-extern long double JointTime;
-extern long double PreviousJointTime;
-extern unsigned short JointPositions[MOTORS_NUM_MOTORS];
-extern unsigned short JointSpeeds[MOTORS_NUM_MOTORS];
-extern unsigned short JointLoads[MOTORS_NUM_MOTORS];
+#define MOTORS_EMULATOR_LOWER_DEVICE      "/tmp/dxlower"     // the pseudo-terminal of the emulated lower body chain (created by dxemulator)
+#define MOTORS_EMULATOR_UPPER_DEVICE      "/tmp/dxupper"     // the pseudo-terminal of the emulated upper body chain
+#define MOTORS_EMULATOR_VARIABLE          "NUBOT_DX_EMULATOR"    // the environment variable that selects the emulator's pseudo-terminals instead of the FTDI chip
 
-// This structure's sole purpose is to store data required for a threaded write
-struct threaddata_t
+// A snapshot of the feedback from every motor (in motor units, and indexed like MotorControls)
+struct MotorFeedback
 {
-   FT_HANDLE Handle;                // the handle to buffer will be written to
-   unsigned char* Buffer;           // pointer to the buffer containing the data
-   unsigned short BufferLength;     // the number of bytes in the buffer
+   double Time;                                    // the time the snapshot was completed in ms
+   unsigned char NumUpdated;                       // the number of motors that replied (the others keep their previous values)
+   unsigned short Positions[MOTORS_NUM_MOTORS];
+   unsigned short Speeds[MOTORS_NUM_MOTORS];
+   unsigned short Loads[MOTORS_NUM_MOTORS];
+   unsigned char Errors[MOTORS_NUM_MOTORS];        // the error byte of each motor's last reply
 };
 
 class Motors
@@ -93,9 +94,8 @@ class Motors
       void updateControl(unsigned char motorid, unsigned short position, unsigned short speed, unsigned short punch);
       void updateControls(unsigned char motorid[], unsigned char nummotors, unsigned short positions[], unsigned short speeds[], unsigned short punches[]);
       void updateControls(unsigned short positions[MOTORS_NUM_MOTORS], unsigned short speeds[MOTORS_NUM_MOTORS], unsigned short punches[MOTORS_NUM_MOTORS]);           // update the control variables (they will be sent to the motors on the next cycle)
-      bool write();                                                                       // write motor control commands
-      bool request();                                                                     // request for feedback data
-      bool read();                                                                        // read feedback data and put it into global feedback arrays
+      bool transfer();                                                                    // write motor control commands and read the feedback data
+      void getFeedback(MotorFeedback& feedback);                                          // get a copy of the latest feedback data
     
       void getTargets(vector<float>& targets);
       void getStiffnesses(vector<float>& stiffnesses);
@@ -117,6 +117,7 @@ class Motors
       void initSelf();
       void initRequestMessages();
       void initSerial();
+      void initChannels();
       void initReturnDelays();
       void initControlTables();
       void initSlopes();
@@ -130,20 +131,15 @@ class Motors
       // Serial Writing
       bool write(unsigned char motorid, unsigned char command, unsigned char data[], unsigned char datalength);
       bool write(unsigned char motorid[], unsigned char nummotors, unsigned char command, unsigned char* data[], unsigned char datalength);
-      bool write(unsigned char command, unsigned char data[MOTORS_NUM_MOTORS][MOTORS_NUM_CONTROLS]);
       bool broadcast(unsigned char command, unsigned char data[], unsigned short datalength);
    
       void appendPacketToBuffer(unsigned char motorid, unsigned char command, unsigned char data[], unsigned char datalength, unsigned char messagebuffer[], unsigned short* currentbufferindex);
       void appendPacketsToBuffer(unsigned char motorid[], unsigned char nummotors, unsigned char command, unsigned char* data[], unsigned char datalength, unsigned char lowermessagebuffer[], unsigned char uppermessagebuffer[], unsigned short* lowerindex, unsigned short* upperindex);
-      void appendPacketsToBuffer(unsigned char command, unsigned char data[MOTORS_NUM_MOTORS][MOTORS_NUM_CONTROLS], unsigned char lowermessagebuffer[], unsigned char uppermessagebuffer[], unsigned short* lowerindex, unsigned short* upperindex);
-      void appendPacketsToBuffer(unsigned char command, unsigned char data[MOTORS_NUM_MOTORS][MOTORS_NUM_PUNCHES], unsigned char lowermessagebuffer[], unsigned char uppermessagebuffer[], unsigned short* lowerindex, unsigned short* upperindex);
-      void appendControlPacketsToBuffer(unsigned char lowermessagebuffer[], unsigned char uppermessagebuffer[], unsigned short* lowerindex, unsigned short* upperindex);
+      void appendSyncWriteToBuffer(unsigned char address, unsigned char motorid[], unsigned char nummotors, unsigned char* data[], unsigned char datalength, unsigned char messagebuffer[], unsigned short* currentbufferindex);
+      void appendControlPacketsToBuffer(unsigned char bodyindextomotorid[], unsigned char nummotors, unsigned char messagebuffer[], unsigned short* currentbufferindex);
    
       // Serial Reading
-      unsigned short getNumBytesInQueue(FT_HANDLE fthandle);
-      bool read(FT_HANDLE fthandle, unsigned char data[], unsigned short numbytestoread);
-      unsigned short readQueue(FT_HANDLE fthandle, unsigned char data[], unsigned short maxdatalength);
-      unsigned char updateFeedbackData(unsigned char readdata[], unsigned short numbytes);
+      unsigned short readQueue(DXPort* port, unsigned char data[], unsigned short maxdatalength);
       bool findHeader(unsigned char readdata[], unsigned short numbytes, unsigned short* index);
    
    public:
@@ -162,8 +158,10 @@ class Motors
       static unsigned short* DefaultPunches;
    
    private:
-      FT_HANDLE upperHandle;              // handle of the d2xx channel for the upper body (device 1)
-      FT_HANDLE lowerHandle;              // handle of the d2xx channel for the lower body (device 0)
+      DXPort* upperPort;                  // the serial connection to the upper body (device 1)
+      DXPort* lowerPort;                  // the serial connection to the lower body (device 0)
+      DXChannel* upperChannel;            // the thread doing the transfers on the upper body
+      DXChannel* lowerChannel;            // the thread doing the transfers on the lower body
    
       // Control packet data
       unsigned char MotorControls[MOTORS_NUM_MOTORS][MOTORS_NUM_CONTROLS];
@@ -175,17 +173,20 @@ class Motors
       unsigned char MotorRequestsUpper[MOTORS_NUM_UPPER_REQUEST_BLOCKS][MOTORS_NUM_UPPER_MOTORS*MAX_MESSAGE_LENGTH];
       unsigned short MotorRequestsUpperLength[MOTORS_NUM_UPPER_REQUEST_BLOCKS];
    
-      // Threaded write data
-      threaddata_t ThreadLowerWrite, ThreadUpperWrite;
+      // Control packets for the current transfer
+      unsigned char LowerCommand[MOTORS_NUM_MOTORS*MAX_MESSAGE_LENGTH];
+      unsigned char UpperCommand[MOTORS_NUM_MOTORS*MAX_MESSAGE_LENGTH];
+      pthread_mutex_t ControlMutex;       // lock for MotorControls, MotorPunches and MotorTorqueOn
+   
+      // Double buffered feedback; the channels fill Feedback[1 - FrontFeedback] during a transfer
+      MotorFeedback Feedback[2];
+      int FrontFeedback;
+      pthread_mutex_t FeedbackMutex;      // lock for FrontFeedback, and the front buffer while it is being copied
    
       // Software motor on/off control
       bool MotorTorqueOn[MOTORS_NUM_MOTORS];
    
-      long double StartTime;
-    
       DXSerialThread* m_thread;
 };
 
-void* runThreadedWrite(void *arg);
-
 #endif
@@ -22,6 +22,8 @@ SET (YOUR_SRCS  dx117.h
                 WinTypes.h
                 Motors.cpp Motors.h
                 DXSerialThread.cpp DXSerialThread.h
+                DXChannel.cpp DXChannel.h
+                DXPort.cpp DXPort.h
 )
 ####################################################################################
 ########## List your subdirectories here! ##########################################
@@ -18,7 +18,7 @@
 #define DX117_REG_WRITE              0x04		    // Register write instruction
 #define DX117_ACTION                 0x05		    // Action instruction (execute the last registered write) 
 #define DX117_RESET                  0x06		    // Reset instruction (changes the values in the control table back to the default values
-#define DX117_SYNC_WRITE             0x83		    // Sync write instruction. I have no idea what this does but it is included in the Direct-Access API
+#define DX117_SYNC_WRITE             0x83		    // Sync write instruction. Writes the same address on many motors, each with its own data, in a single broadcast packet
 
 // Alarm LED byte bit defintions
 #define DX117_ALARM_VOLTAGE          0x01	        // 00000001	- DXL voltage error
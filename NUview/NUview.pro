@@ -52,9 +52,15 @@ HEADERS += ui_mainwindow.h \
     openglmanager.h \
     GLDisplay.h \
     ../Infrastructure/NUImage/NUImage.h \
+    ../Infrastructure/NUImage/ImageConversions.h \
     ../Infrastructure/NUImage/ClassifiedImage.h \
     ../Vision/ClassifiedSection.h \
     ../Vision/ScanLine.h \
+    ../Vision/SegmentTable.h \
+    ../Vision/VisionStageTimer.h \
+    ../Vision/LookUpTable.h \
+    ../Vision/FrameArena.h \
+    ../Vision/RegionOfInterestTracker.h \
     ../Vision/TransitionSegment.h \
     ../Vision/GoalDetection.h \
     LayerSelectionWidget.h \
@@ -72,7 +78,9 @@ HEADERS += ui_mainwindow.h \
     ../Infrastructure/FieldObjects/MobileObject.h \
     ../Infrastructure/FieldObjects/AmbiguousObject.h \
     ../Infrastructure/FieldObjects/FieldObjects.h \
+    ../Infrastructure/FieldObjects/LandmarkVisibility.h \
     ../Vision/Threads/SaveImagesThread.h \
+    ../Vision/Threads/LoadLUTThread.h \
     ../Vision/ObjectCandidate.h \
     ../Localisation/WMPoint.h \
     ../Localisation/WMLine.h \
@@ -92,12 +100,14 @@ HEADERS += ui_mainwindow.h \
     ../NUPlatform/NUCamera/CameraSettings.h \
     ../Tools/FileFormats/Parse.h \
     ../Localisation/KF.h \
+    ../Localisation/BallTracker.h \
     ../Localisation/Localisation.h \
     ../Infrastructure/FieldObjects/WorldModelShareObject.h \
     ../Infrastructure/GameInformation/GameInformation.h \
     ../Tools/Threading/Thread.h \
     ../Tools/Threading/ConditionalThread.h \
     ../Tools/Threading/PeriodicThread.h \
+    ../Tools/Threading/PeriodicThreadStatistics.h \
     NUviewIO/NUviewIO.h \
     ../Kinematics/Kinematics.h \
     ../Tools/Math/TransformMatrices.h \
@@ -108,6 +118,7 @@ HEADERS += ui_mainwindow.h \
     bonjour/bonjourrecord.h \
     ../Tools/Math/UKF.h \
     ../Tools/Math/SRUKF.h \
+    ../Tools/Math/UnscentedFilter.h \
     ../Kinematics/Link.h \
     ../Kinematics/EndEffector.h \
     ../NUPlatform/NUSensors.h \
@@ -172,6 +183,9 @@ SOURCES += mainwindow.cpp \
     classificationwidget.cpp \
     ../Tools/FileFormats/NUbotImage.cpp \
     ../Vision/Vision.cpp \
+    ../Vision/LookUpTable.cpp \
+    ../Vision/FrameArena.cpp \
+    ../Vision/RegionOfInterestTracker.cpp \
     ../Tools/FileFormats/LUTTools.cpp \
     virtualnubot.cpp \
     ../Infrastructure/NUImage/BresenhamLine.cpp \
@@ -180,9 +194,11 @@ SOURCES += mainwindow.cpp \
     openglmanager.cpp \
     GLDisplay.cpp \
     ../Infrastructure/NUImage/NUImage.cpp \
+    ../Infrastructure/NUImage/ImageConversions.cpp \
     ../Infrastructure/NUImage/ClassifiedImage.cpp \
     ../Vision/ClassifiedSection.cpp \
     ../Vision/ScanLine.cpp \
+    ../Vision/SegmentTable.cpp \
     ../Vision/TransitionSegment.cpp \
     ../Vision/GoalDetection.cpp \
     LayerSelectionWidget.cpp \
@@ -203,6 +219,7 @@ SOURCES += mainwindow.cpp \
     $$files(../NUPlatform/NUActionators/*.cpp) \
     $$files(../Infrastructure/NUActionatorsData/*.cpp) \
     ../Infrastructure/TeamInformation/TeamInformation.cpp \
+    ../Infrastructure/TeamInformation/TeamPacket.cpp \
     $$files(../Infrastructure/Jobs/*.cpp) \
     $$files(../Infrastructure/Jobs/CameraJobs/*.cpp) \
     $$files(../Infrastructure/Jobs/VisionJobs/*.cpp) \
@@ -217,7 +234,9 @@ SOURCES += mainwindow.cpp \
     ../Infrastructure/FieldObjects/MobileObject.cpp \
     ../Infrastructure/FieldObjects/AmbiguousObject.cpp \
     ../Infrastructure/FieldObjects/FieldObjects.cpp \
+    ../Infrastructure/FieldObjects/LandmarkVisibility.cpp \
     ../Vision/Threads/SaveImagesThread.cpp \
+    ../Vision/Threads/LoadLUTThread.cpp \
     ../Localisation/WMPoint.cpp \
     ../Localisation/WMLine.cpp \
     ../Localisation/sphere.cpp \
@@ -236,12 +255,14 @@ SOURCES += mainwindow.cpp \
     ../NUPlatform/NUCamera/CameraSettings.cpp \
     ../Tools/FileFormats/Parse.cpp \
     ../Localisation/KF.cpp \
+    ../Localisation/BallTracker.cpp \
     ../Localisation/Localisation.cpp \
     ../Infrastructure/FieldObjects/WorldModelShareObject.cpp \
     ../Infrastructure/GameInformation/GameInformation.cpp \
     ../Tools/Threading/Thread.cpp \
     ../Tools/Threading/ConditionalThread.cpp \
     ../Tools/Threading/PeriodicThread.cpp \
+    ../Tools/Threading/PeriodicThreadStatistics.cpp \
     ../Kinematics/Kinematics.cpp \
     ../Tools/Math/TransformMatrices.cpp \
     frameInformationWidget.cpp \
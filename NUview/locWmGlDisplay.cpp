@@ -431,7 +431,7 @@ void locWmGlDisplay::DrawSigmaPoint(QColor colour, float x, float y, float theta
     glPopMatrix();
 }
 
-void locWmGlDisplay::DrawModel(const KF& model)
+void locWmGlDisplay::DrawModel(const KF& model, const BallTracker& ball)
 {
     drawRobot(QColor(255,255,255,model.alpha*255), model.getState(KF::selfX), model.getState(KF::selfY), model.getState(KF::selfTheta));
     if(drawSigmaPoints)
@@ -442,7 +442,8 @@ void locWmGlDisplay::DrawModel(const KF& model)
             DrawSigmaPoint(QColor(255,255,255,model.alpha*255), sigmaPoints[KF::selfX][i], sigmaPoints[KF::selfY][i], sigmaPoints[KF::selfTheta][i]);
         }
     }
-    drawBall(QColor(255,165,0,255), model.getState(KF::ballX), model.getState(KF::ballY));
+    Matrix ballEstimates = ball.getFieldEstimates(model);
+    drawBall(QColor(255,165,0,255), ballEstimates[BallTracker::relX][0], ballEstimates[BallTracker::relY][0]);
 }
 
 void locWmGlDisplay::DrawLocalisation(const Localisation& localisation)
@@ -450,7 +451,7 @@ void locWmGlDisplay::DrawLocalisation(const Localisation& localisation)
     if(drawBestModelOnly)
     {
         const KF model = localisation.getBestModel();
-        DrawModel(model);
+        DrawModel(model, localisation.getBall());
     }
     else
     {
@@ -460,7 +461,7 @@ void locWmGlDisplay::DrawLocalisation(const Localisation& localisation)
             const KF model = localisation.getModel(modelID);
             if(model.isActive)
             {
-                DrawModel(model);
+                DrawModel(model, localisation.getBall());
                 glDisable(GL_DEPTH_TEST);		// Turn Z Buffer testing Off
                 glColor4ub(255,255,255,255);
                 renderText(model.getState(KF::selfX), model.getState(KF::selfY),1,displayString.arg(modelID).arg(model.alpha*100,0,'f',1));
@@ -4,6 +4,7 @@
 #include <QGLWidget>
 
 class KF;
+class BallTracker;
 class Localisation;
 class FieldObjects;
 class Object;
@@ -56,7 +57,7 @@ protected:
         void drawRobot(QColor colour, float x, float y, float theta);
         void DrawSigmaPoint(QColor colour, float x, float y, float theta);
 
-        void DrawModel(const KF& model);
+        void DrawModel(const KF& model, const BallTracker& ball);
         void DrawLocalisation(const Localisation& localisation);
         void drawStationaryObjectLabel(const StationaryObject& object);
         void drawFieldObjectLabels(const FieldObjects& theFieldObjectsobject);
@@ -19,10 +19,10 @@
     along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
 */
 
-#include "ColorModelConversions.h"
 #include "Vision/ClassificationColours.h"
 #include "openglmanager.h"
 #include "Infrastructure/NUImage/NUImage.h"
+#include "Infrastructure/NUImage/ImageConversions.h"
 #include "Infrastructure/NUImage/ClassifiedImage.h"
 #include "Kinematics/Horizon.h"
 #include <QPainter>
@@ -96,17 +96,8 @@ void OpenglManager::writeNUImageToDisplay(const NUImage* newImage, GLDisplay::di
     height = newImage->getHeight();
 
     QImage image(width,height,QImage::Format_ARGB32);
-    unsigned char r, g, b;
-    QRgb* imageLine;
     for (int y = 0; y < height; y++)
-    {
-        imageLine = (QRgb*)image.scanLine(y);
-        for (int x = 0; x < width; x++)
-        {
-            ColorModelConversions::fromYCbCrToRGB(newImage->m_image[y][x].y,newImage->m_image[y][x].cb,newImage->m_image[y][x].cr,r,g,b);
-            imageLine[x] = qRgb(r,g,b);
-        }
-    }
+        ImageConversions::fromYCbCrToARGB(newImage->m_image[y], (unsigned int*)image.scanLine(y), width);
     createDrawTextureImage(image, displayId);
     emit updatedDisplay(displayId, displays[displayId], width, height);
     return;
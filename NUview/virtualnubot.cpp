@@ -198,7 +198,7 @@ void virtualNUbot::processVisionFrame(const NUImage* image)
     std::vector< Vector2<int> > points;
     std::vector< Vector2<int> > verticalPoints;
     std::vector< TransitionSegment > verticalsegments;
-    std::vector< TransitionSegment > horizontalsegments;
+    FrameVector<TransitionSegment>::type horizontalsegments;
     std::vector< TransitionSegment > allsegments;
     std::vector< ObjectCandidate > candidates;
 
@@ -240,9 +240,11 @@ void virtualNUbot::processVisionFrame(const NUImage* image)
     emit pointsDisplayChanged(interpolatedBoarderPoints,GLDisplay::greenHorizonPoints);
     //qDebug() << "Find Field border: finnished";
     //! Scan Below Horizon Image
-    ClassifiedSection vertScanArea = vision.verticalScan(interpolatedBoarderPoints,spacings);
+    ClassifiedSection vertScanArea;
+    vision.verticalScan(interpolatedBoarderPoints,spacings,vertScanArea);
     //! Scan Above the Horizon
-    ClassifiedSection horiScanArea = vision.horizontalScan(interpolatedBoarderPoints,spacings);
+    ClassifiedSection horiScanArea;
+    vision.horizontalScan(interpolatedBoarderPoints,spacings,horiScanArea);
     //qDebug() << "Generate Scanlines: finnished";
     //! Classify Line Segments
 
@@ -251,9 +253,9 @@ void virtualNUbot::processVisionFrame(const NUImage* image)
     //qDebug() << "Classify Scanlines: finnished";
 
 
-    std::vector< TransitionSegment > GoalBlueSegments;
-    std::vector< TransitionSegment > GoalYellowSegments;
-    std::vector< TransitionSegment > BallSegments;
+    FrameVector<TransitionSegment>::type GoalBlueSegments;
+    FrameVector<TransitionSegment>::type GoalYellowSegments;
+    FrameVector<TransitionSegment>::type BallSegments;
 
     //! Extract and Display Vertical Scan Points:
     tempNumScanLines = vertScanArea.getNumberOfScanLines();
@@ -264,21 +266,21 @@ void virtualNUbot::processVisionFrame(const NUImage* image)
         Vector2<int> startPoint = tempScanLine->getStart();
         for(int seg = 0; seg < tempScanLine->getNumberOfSegments(); seg++)
         {
-            verticalsegments.push_back((*tempScanLine->getSegment(seg)));
-            allsegments.push_back((*tempScanLine->getSegment(seg)));
+            verticalsegments.push_back(tempScanLine->getSegment(seg));
+            allsegments.push_back(tempScanLine->getSegment(seg));
 
-            if(     tempScanLine->getSegment(seg)->getColour() == ClassIndex::blue || tempScanLine->getSegment(seg)->getColour() == ClassIndex::shadow_blue)
+            if(     tempScanLine->getSegmentColour(seg) == ClassIndex::blue || tempScanLine->getSegmentColour(seg) == ClassIndex::shadow_blue)
             {
-                GoalBlueSegments.push_back((*tempScanLine->getSegment(seg)));
+                GoalBlueSegments.push_back(tempScanLine->getSegment(seg));
             }
-            if(     tempScanLine->getSegment(seg)->getColour() == ClassIndex::yellow || tempScanLine->getSegment(seg)->getColour() == ClassIndex::yellow_orange)
+            if(     tempScanLine->getSegmentColour(seg) == ClassIndex::yellow || tempScanLine->getSegmentColour(seg) == ClassIndex::yellow_orange)
             {
-                GoalYellowSegments.push_back((*tempScanLine->getSegment(seg)));
+                GoalYellowSegments.push_back(tempScanLine->getSegment(seg));
             }
-            if(     tempScanLine->getSegment(seg)->getColour() == ClassIndex::orange || tempScanLine->getSegment(seg)->getColour() == ClassIndex::yellow_orange
-                ||  tempScanLine->getSegment(seg)->getColour() == ClassIndex::pink_orange)
+            if(     tempScanLine->getSegmentColour(seg) == ClassIndex::orange || tempScanLine->getSegmentColour(seg) == ClassIndex::yellow_orange
+                ||  tempScanLine->getSegmentColour(seg) == ClassIndex::pink_orange)
             {
-                BallSegments.push_back((*tempScanLine->getSegment(seg)));
+                BallSegments.push_back(tempScanLine->getSegment(seg));
             }
         }
         if(vertScanArea.getDirection() == ScanLine::DOWN)
@@ -303,9 +305,9 @@ void virtualNUbot::processVisionFrame(const NUImage* image)
         Vector2<int> startPoint = tempScanLine->getStart();
         for(int seg = 0; seg < tempScanLine->getNumberOfSegments(); seg++)
         {
-            if(tempScanLine->getSegment(seg)->getColour() == ClassIndex::white) continue;
-            horizontalsegments.push_back((*tempScanLine->getSegment(seg)));
-            allsegments.push_back((*tempScanLine->getSegment(seg)));
+            if(tempScanLine->getSegmentColour(seg) == ClassIndex::white) continue;
+            horizontalsegments.push_back(tempScanLine->getSegment(seg));
+            allsegments.push_back(tempScanLine->getSegment(seg));
         }
         if(horiScanArea.getDirection() == ScanLine::RIGHT)
         {
@@ -334,17 +336,17 @@ void virtualNUbot::processVisionFrame(const NUImage* image)
     //qDebug() << "PREclassifyCandidates";
 
     //Prep object candidates for line detection
-    std::vector< ObjectCandidate > HorizontalLineCandidates1;
-    std::vector< ObjectCandidate > HorizontalLineCandidates2;
-    std::vector< ObjectCandidate > HorizontalLineCandidates3;
-    std::vector< ObjectCandidate > HorizontalLineCandidates;
-    std::vector< ObjectCandidate > VerticalLineCandidates;
-    std::vector< TransitionSegment > LeftoverPoints1;
-    std::vector< TransitionSegment > LeftoverPoints2;
-    std::vector< TransitionSegment > LeftoverPoints3;
-
-    std::vector< TransitionSegment > LeftoverPoints;
-    std::vector< ObjectCandidate > LineCandidates;
+    FrameVector<ObjectCandidate>::type HorizontalLineCandidates1;
+    FrameVector<ObjectCandidate>::type HorizontalLineCandidates2;
+    FrameVector<ObjectCandidate>::type HorizontalLineCandidates3;
+    FrameVector<ObjectCandidate>::type HorizontalLineCandidates;
+    FrameVector<ObjectCandidate>::type VerticalLineCandidates;
+    FrameVector<TransitionSegment>::type LeftoverPoints1;
+    FrameVector<TransitionSegment>::type LeftoverPoints2;
+    FrameVector<TransitionSegment>::type LeftoverPoints3;
+
+    FrameVector<TransitionSegment>::type LeftoverPoints;
+    FrameVector<ObjectCandidate>::type LineCandidates;
     validColours.clear();
     validColours.push_back(ClassIndex::white);
     //validColours.push_back(ClassIndex::blue);
@@ -380,12 +382,12 @@ void virtualNUbot::processVisionFrame(const NUImage* image)
     //qDebug() << "POST-ROBOT";
 
 
-    std::vector< ObjectCandidate > RobotCandidates;
-    std::vector< ObjectCandidate > BallCandidates;
-    std::vector< ObjectCandidate > BlueGoalCandidates;
-    std::vector< ObjectCandidate > YellowGoalCandidates;
-    std::vector< ObjectCandidate > BlueGoalAboveHorizonCandidates;
-    std::vector< ObjectCandidate > YellowGoalAboveHorizonCandidates;
+    FrameVector<ObjectCandidate>::type RobotCandidates;
+    FrameVector<ObjectCandidate>::type BallCandidates;
+    FrameVector<ObjectCandidate>::type BlueGoalCandidates;
+    FrameVector<ObjectCandidate>::type YellowGoalCandidates;
+    FrameVector<ObjectCandidate>::type BlueGoalAboveHorizonCandidates;
+    FrameVector<ObjectCandidate>::type YellowGoalAboveHorizonCandidates;
     mode = BALL;
     method = Vision::PRIMS;
    for (int i = 0; i < 4; i++)
@@ -508,7 +510,7 @@ void virtualNUbot::processVisionFrame(const NUImage* image)
         unsigned int currentPixel = 0;
         QImage subImage;
 
-        std::vector< ObjectCandidate >::iterator rit;
+        FrameVector<ObjectCandidate>::type::iterator rit;
         for (rit = RobotCandidates.begin(); rit != RobotCandidates.end(); rit++)
         {
             offs = rit->getTopLeft();
@@ -1,4 +1,5 @@
 #include "visionstreamwidget.h"
+#include "Tools/Threading/PeriodicThread.h"
 #include <QLabel>
 #include <QLineEdit>
 #include <QHBoxLayout>
@@ -50,11 +51,20 @@ visionStreamWidget::visionStreamWidget(QMdiArea* parentMdiWidget, QWidget *paren
     selectLayout4->addWidget(frameRateLabel,2);
     selectLayout4->addWidget(frameRateMessageLabel,1);
 
+    threadStatisticsLabel = new QLabel("Periodic thread timing: ");
+    threadStatisticsMessageLabel = new QLabel("");
+    threadStatisticsMessageLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    selectLayout5 = new QVBoxLayout;
+    selectLayout5->setAlignment(Qt::AlignTop);
+    selectLayout5->addWidget(threadStatisticsLabel);
+    selectLayout5->addWidget(threadStatisticsMessageLabel);
+
     //selectLayout2->addWidget(disconnectButton,1);
     layout->addLayout(selectLayout1);
     layout->addLayout(selectLayout2);
     layout->addLayout(selectLayout3);
     layout->addLayout(selectLayout4);
+    layout->addLayout(selectLayout5);
     layout->setAlignment(Qt::AlignLeft);
     //window = new QWidget;
     setLayout(layout);
@@ -223,6 +233,7 @@ void visionStreamWidget::readPendingData()
             buffer >> sensors;
             qDebug() << "Size of Data:" << sensorsSize;
             emit sensorsDataChanged(&sensors);
+            showThreadStatistics(netdata.data()+ sizeof(sizeOfSensors) + imageSize, sensorsSize);
 
             int mstime = timeToRecievePacket.elapsed();
             time.setInterval(0);
@@ -249,3 +260,26 @@ void visionStreamWidget::sendRequestForImage()
         connectToRobot();
     }
 }
+
+/*! @brief Shows the periodic thread statistics the robot appended to the sensors data, or nothing if there are none
+    @param sensorsdata the sensors part of the packet
+    @param size the size of the sensors part in bytes
+ */
+void visionStreamWidget::showThreadStatistics(const char* sensorsdata, int size)
+{
+    // the sensors are followed by [statistics][statistics size][PERIODIC_THREAD_STATISTICS_MAGIC]
+    int statisticsSize = 0;
+    int magic = 0;
+    if (size >= (int) (sizeof(statisticsSize) + sizeof(magic)))
+    {
+        memcpy(&magic, sensorsdata + size - sizeof(magic), sizeof(magic));
+        memcpy(&statisticsSize, sensorsdata + size - sizeof(magic) - sizeof(statisticsSize), sizeof(statisticsSize));
+    }
+    if (magic != PERIODIC_THREAD_STATISTICS_MAGIC or statisticsSize < 0 or statisticsSize > size - (int) (sizeof(statisticsSize) + sizeof(magic)))
+    {
+        threadStatisticsMessageLabel->setText("");
+        return;
+    }
+    const char* statistics = sensorsdata + size - sizeof(magic) - sizeof(statisticsSize) - statisticsSize;
+    threadStatisticsMessageLabel->setText(QString::fromLatin1(statistics, statisticsSize));
+}
@@ -66,6 +66,8 @@ signals:
     void sensorsDataChanged(const float* joint, const float* balance, const float* touch);
 
 private:
+    void showThreadStatistics(const char* sensorsdata, int size);
+
     QString robotName;
     int datasize;
     int imageSize;
@@ -83,12 +85,15 @@ private:
     QHBoxLayout* selectLayout2;
     QHBoxLayout* selectLayout3;
     QHBoxLayout* selectLayout4;
+    QVBoxLayout* selectLayout5;
     QLabel* frameLabel;
     QLabel* frameNumberLabel;
     QLabel* statusLabel;
     QLabel* statusNetworkLabel;
     QLabel* frameRateLabel;
     QLabel* frameRateMessageLabel;
+    QLabel* threadStatisticsLabel;
+    QLabel* threadStatisticsMessageLabel;
     QWidget* window;
     QTcpSocket* tcpSocket;
     QTimer time;
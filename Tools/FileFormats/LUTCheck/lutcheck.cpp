@@ -0,0 +1,297 @@
+/*! @file lutcheck.cpp
+    @brief The lutcheck executable. Checks that lookup tables survive SaveLUT and LoadLUT, and that broken files are rejected.
+
+    Usage: lutcheck [scratch file]
+
+    Tables are saved with every bit depth and encoding, and must load back exactly. The tables are the same
+    over every block of 8x8x8 entries, so that saving them with as few as 4 bits loses nothing. A table of
+    random entries and a constant table (a single run, with a three byte run length) are also saved with 7 bits,
+    and a table of 16 stripes (runs with a two byte run length) with 4 bits.
+
+    Broken files are then written: every truncation of the saved stripes, with and without its payload length
+    corrected, a wrong payload or checksum so that the Adler-32 checksum does not match, and run-length
+    payloads whose run length varint is cut short, too long, zero or runs past the end of the table. Every
+    one of them must be rejected by LoadLUT, and must leave the table it was loaded into unchanged.
+
+    The files are written to the scratch file (lutcheck.lut unless given), which is removed at the end.
+    The number of files checked and the number of failures are printed for each check, and the exit
+    status is 1 if there were any failures.
+    Use a build with NUBOT_BUILD_LUT_CHECK ON.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Tools/FileFormats/LUTTools.h"
+
+#include "debug.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+using namespace std;
+
+ofstream debug;
+ofstream errorlog;
+
+#define MAX_REPORTED_FAILURES 5                 //!< the number of failures of each check that are printed in full
+#define SENTINEL_VALUE 0xA5                     //!< the value the table is filled with before loading a file that must be rejected
+
+/*! @brief The result of a single check */
+class CheckResult
+{
+public:
+    CheckResult(const string& name) : m_name(name), m_checked(0), m_failures(0) {}
+
+    /*! @brief Records a failure if ok is false
+        @param what a description of what was checked
+     */
+    void expect(bool ok, const string& what)
+    {
+        if (ok)
+            return;
+        m_failures++;
+        if (m_failures <= MAX_REPORTED_FAILURES)
+            cout << "    " << m_name << ": " << what << endl;
+    }
+    /*! @brief Counts a file as checked */
+    void count() {m_checked++;}
+    bool failed() const {return m_failures > 0;}
+    void print() const
+    {
+        cout << m_name << ": " << m_checked << " files checked, " << m_failures << " failures" << endl;
+    }
+private:
+    string m_name;                          //!< the name of the check
+    long m_checked;                         //!< the number of files checked
+    long m_failures;                        //!< the number of failed expectations
+};
+
+/*! @brief Returns the Adler-32 checksum of data, one byte at a time as in RFC 1950 */
+static unsigned int adler32(const unsigned char* data, int length)
+{
+    unsigned int a = 1;
+    unsigned int b = 0;
+    for (int i=0; i<length; i++)
+    {
+        a = (a + data[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    return (b << 16) | a;
+}
+
+/*! @brief Writes value into buffer as 4 little endian bytes */
+static void writeUInt32(unsigned char* buffer, unsigned int value)
+{
+    for (int i=0; i<4; i++)
+        buffer[i] = (value >> (8*i)) & 0xFF;
+}
+
+/*! @brief Writes contents to the file, replacing it */
+static void writeFile(const string& filename, const vector<unsigned char>& contents)
+{
+    ofstream file(filename.c_str(), ios::out | ios::binary | ios::trunc);
+    if (not contents.empty())
+        file.write(reinterpret_cast<const char*>(&contents[0]), contents.size());
+}
+
+/*! @brief Returns the contents of the file */
+static vector<unsigned char> readFile(const string& filename)
+{
+    ifstream file(filename.c_str(), ios::in | ios::binary);
+    return vector<unsigned char>(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+}
+
+/*! @brief Returns a file with a header for the given payload
+    @param bits the number of bits per channel in the header
+    @param encoding the encoding in the header
+    @param checksum the checksum in the header
+ */
+static vector<unsigned char> makeFile(int bits, LUTTools::Encoding encoding, const vector<unsigned char>& payload, unsigned int checksum)
+{
+    vector<unsigned char> contents(LUTTOOLS_HEADER_SIZE, 0);
+    memcpy(&contents[0], LUTTOOLS_MAGIC, 4);
+    contents[4] = LUTTOOLS_VERSION;
+    contents[5] = bits;
+    contents[6] = encoding;
+    writeUInt32(&contents[8], payload.size());
+    writeUInt32(&contents[12], checksum);
+    contents.insert(contents.end(), payload.begin(), payload.end());
+    return contents;
+}
+
+/*! @brief Checks that the file is rejected by LoadLUT, and that the table it was loaded into is unchanged
+    @param what a description of how the file is broken
+ */
+static void checkRejected(CheckResult& result, const string& filename, const vector<unsigned char>& contents, const string& what)
+{
+    writeFile(filename, contents);
+    vector<unsigned char> table(LUTTools::LUT_SIZE, SENTINEL_VALUE);
+    result.expect(not LUTTools::LoadLUT(&table[0], LUTTools::LUT_SIZE, filename.c_str()), "LoadLUT() accepted " + what);
+    bool unchanged = true;
+    for (int i=0; i<LUTTools::LUT_SIZE and unchanged; i++)
+        unchanged = table[i] == SENTINEL_VALUE;
+    result.expect(unchanged, "LoadLUT() modified the table with " + what);
+    result.count();
+}
+
+/*! @brief Checks that the table is saved and loaded back exactly
+    @param what a description of the table and how it is saved
+ */
+static void checkRoundTrip(CheckResult& result, const string& filename, const vector<unsigned char>& table, int bits, LUTTools::Encoding encoding, const string& what)
+{
+    result.expect(LUTTools::SaveLUT(&table[0], LUTTools::LUT_SIZE, filename.c_str(), bits, encoding), "SaveLUT() failed for " + what);
+    vector<unsigned char> loaded(LUTTools::LUT_SIZE, SENTINEL_VALUE);
+    result.expect(LUTTools::LoadLUT(&loaded[0], LUTTools::LUT_SIZE, filename.c_str()), "LoadLUT() rejected " + what);
+    result.expect(loaded == table, "the loaded table differs for " + what);
+    result.count();
+}
+
+int main(int argc, const char *argv[])
+{
+    string filename = "lutcheck.lut";
+    if (argc > 1)
+        filename = argv[1];
+    srand(1);
+
+    CheckResult roundtrip("SaveLUT() and LoadLUT()");
+    CheckResult truncated("truncated files");
+    CheckResult checksum("checksum mismatches");
+    CheckResult varints("broken run lengths");
+
+    // ---------------------------------------------------------------- round trip
+    const int size = 1 << LUTTools::LUT_BITS;
+    const int blockshift = LUTTools::LUT_BITS - LUTTOOLS_MIN_BITS;
+    vector<unsigned char> blocks(LUTTools::LUT_SIZE);
+    vector<unsigned char> noise(LUTTools::LUT_SIZE);
+    vector<unsigned char> constant(LUTTools::LUT_SIZE, 3);
+    vector<unsigned char> stripes(LUTTools::LUT_SIZE);
+    for (int y=0; y<size; y++)
+        for (int cb=0; cb<size; cb++)
+            for (int cr=0; cr<size; cr++)
+            {
+                int index = (y << (2*LUTTools::LUT_BITS)) + (cb << LUTTools::LUT_BITS) + cr;
+                blocks[index] = (7*(y >> blockshift) + 3*(cb >> blockshift) + (cr >> blockshift)) % 9;
+                stripes[index] = (y >> blockshift) % 9;
+                noise[index] = rand() % 256;
+            }
+    for (int bits=LUTTOOLS_MIN_BITS; bits<=LUTTOOLS_MAX_BITS; bits++)
+    {
+        char what[64];
+        sprintf(what, "the block table with %d bits raw", bits);
+        checkRoundTrip(roundtrip, filename, blocks, bits, LUTTools::RAW, what);
+        sprintf(what, "the block table with %d bits run-length encoded", bits);
+        checkRoundTrip(roundtrip, filename, blocks, bits, LUTTools::RUN_LENGTH, what);
+    }
+    checkRoundTrip(roundtrip, filename, noise, LUTTools::LUT_BITS, LUTTools::RAW, "the random table raw");
+    checkRoundTrip(roundtrip, filename, noise, LUTTools::LUT_BITS, LUTTools::RUN_LENGTH, "the random table run-length encoded");
+    checkRoundTrip(roundtrip, filename, constant, LUTTools::LUT_BITS, LUTTools::RUN_LENGTH, "the constant table run-length encoded");
+    checkRoundTrip(roundtrip, filename, stripes, LUTTOOLS_MIN_BITS, LUTTools::RUN_LENGTH, "the striped table with 4 bits run-length encoded");
+
+    // a table without a header is still loaded as it is
+    writeFile(filename, noise);
+    vector<unsigned char> loaded(LUTTools::LUT_SIZE, SENTINEL_VALUE);
+    roundtrip.expect(LUTTools::LoadLUT(&loaded[0], LUTTools::LUT_SIZE, filename.c_str()), "LoadLUT() rejected a table without a header");
+    roundtrip.expect(loaded == noise, "the table without a header differs");
+    roundtrip.count();
+
+    // ---------------------------------------------------------------- truncated files
+    // the striped table with 4 bits is 16 runs of 256, so it is short and every run length is two bytes
+    LUTTools::SaveLUT(&stripes[0], LUTTools::LUT_SIZE, filename.c_str(), LUTTOOLS_MIN_BITS, LUTTools::RUN_LENGTH);
+    vector<unsigned char> saved = readFile(filename);
+    for (size_t length=0; length<saved.size(); length++)
+    {
+        vector<unsigned char> cut(saved.begin(), saved.begin() + length);
+        char what[96];
+        sprintf(what, "the file cut to %d of %d bytes", (int) length, (int) saved.size());
+        checkRejected(truncated, filename, cut, what);
+        if (length >= LUTTOOLS_HEADER_SIZE)
+        {   // with the payload length corrected, so that it is the decoding that must reject it
+            writeUInt32(&cut[8], length - LUTTOOLS_HEADER_SIZE);
+            sprintf(what, "the payload cut to %d of %d bytes", (int) (length - LUTTOOLS_HEADER_SIZE), (int) (saved.size() - LUTTOOLS_HEADER_SIZE));
+            checkRejected(truncated, filename, cut, what);
+        }
+    }
+    vector<unsigned char> extended(saved);
+    extended.push_back(0);
+    checkRejected(truncated, filename, extended, "an extra byte after the payload");
+
+    // ---------------------------------------------------------------- checksum mismatches
+    for (int encoding=LUTTools::RAW; encoding<=LUTTools::RUN_LENGTH; encoding++)
+    {
+        string name = encoding == LUTTools::RAW ? "raw" : "run-length encoded";
+        LUTTools::SaveLUT(&noise[0], LUTTools::LUT_SIZE, filename.c_str(), LUTTools::LUT_BITS, (LUTTools::Encoding) encoding);
+        saved = readFile(filename);
+        vector<unsigned char> corrupt(saved);
+        corrupt[LUTTOOLS_HEADER_SIZE] ^= 0x01;          // the first value, which still decodes
+        checkRejected(checksum, filename, corrupt, "a changed value in the " + name + " payload");
+        corrupt = saved;
+        corrupt[12] ^= 0x01;
+        checkRejected(checksum, filename, corrupt, "a changed checksum in the " + name + " header");
+        corrupt = saved;
+        corrupt[LUTTOOLS_HEADER_SIZE] ^= 0x01;
+        corrupt[LUTTOOLS_HEADER_SIZE + (encoding == LUTTools::RAW ? 1 : 2)] ^= 0x01;
+        checkRejected(checksum, filename, corrupt, "two changed values in the " + name + " payload");
+    }
+
+    // ---------------------------------------------------------------- broken run lengths
+    // a 4 bit table of 4096 fives is the single run 5, 0x80, 0x20, so the checksum is right for every one of these
+    const int storedlength = 1 << (3*LUTTOOLS_MIN_BITS);
+    vector<unsigned char> fives(storedlength, 5);
+    unsigned int fivessum = adler32(&fives[0], storedlength);
+    unsigned char whole[] = {5, 0x80, 0x20};
+    vector<unsigned char> payload(whole, whole + sizeof(whole));
+    writeFile(filename, makeFile(LUTTOOLS_MIN_BITS, LUTTools::RUN_LENGTH, payload, fivessum));
+    varints.expect(LUTTools::LoadLUT(&loaded[0], LUTTools::LUT_SIZE, filename.c_str()), "LoadLUT() rejected the run of 4096 fives");
+    varints.expect(loaded == vector<unsigned char>(LUTTools::LUT_SIZE, 5), "the run of 4096 fives did not load as fives");
+    varints.count();
+
+    unsigned char cutshort[] = {5, 0x80};
+    payload.assign(cutshort, cutshort + sizeof(cutshort));
+    checkRejected(varints, filename, makeFile(LUTTOOLS_MIN_BITS, LUTTools::RUN_LENGTH, payload, fivessum), "a run length cut short");
+    unsigned char novarint[] = {5};
+    payload.assign(novarint, novarint + sizeof(novarint));
+    checkRejected(varints, filename, makeFile(LUTTOOLS_MIN_BITS, LUTTools::RUN_LENGTH, payload, fivessum), "a value without a run length");
+    unsigned char toolong[] = {5, 0x80, 0x80, 0x80, 0x80, 0x80, 0x20};
+    payload.assign(toolong, toolong + sizeof(toolong));
+    checkRejected(varints, filename, makeFile(LUTTOOLS_MIN_BITS, LUTTools::RUN_LENGTH, payload, fivessum), "a run length of more than 32 bits");
+    unsigned char zero[] = {5, 0x00, 5, 0x80, 0x20};
+    payload.assign(zero, zero + sizeof(zero));
+    checkRejected(varints, filename, makeFile(LUTTOOLS_MIN_BITS, LUTTools::RUN_LENGTH, payload, fivessum), "a run of zero");
+    unsigned char overrun[] = {5, 0x81, 0x20};
+    payload.assign(overrun, overrun + sizeof(overrun));
+    checkRejected(varints, filename, makeFile(LUTTOOLS_MIN_BITS, LUTTools::RUN_LENGTH, payload, fivessum), "a run past the end of the table");
+    unsigned char underrun[] = {5, 0xFF, 0x1F};
+    payload.assign(underrun, underrun + sizeof(underrun));
+    checkRejected(varints, filename, makeFile(LUTTOOLS_MIN_BITS, LUTTools::RUN_LENGTH, payload, fivessum), "a run short of the end of the table");
+
+    remove(filename.c_str());
+
+    roundtrip.print();
+    truncated.print();
+    checksum.print();
+    varints.print();
+
+    if (roundtrip.failed() or truncated.failed() or checksum.failed() or varints.failed())
+        return 1;
+    else
+        return 0;
+}
@@ -1,26 +1,99 @@
 #include "LUTTools.h"
+#include "debug.h"
 #include <iostream>
 #include <fstream>
+#include <string.h>
 
 using namespace std;
 
+/*! @brief Writes value into buffer as 4 little endian bytes */
+static void writeUInt32(unsigned char* buffer, unsigned int value){
+    for (int i = 0; i < 4; i++)
+        buffer[i] = (value >> (8*i)) & 0xFF;
+}
+
+/*! @brief Returns the 4 little endian bytes in buffer as an unsigned int */
+static unsigned int readUInt32(const unsigned char* buffer){
+    unsigned int value = 0;
+    for (int i = 0; i < 4; i++)
+        value |= static_cast<unsigned int>(buffer[i]) << (8*i);
+    return value;
+}
+
 bool LUTTools::LoadLUT(unsigned char* targetBuffer, int length){
     return LoadLUT( targetBuffer, length, "/home/root/default.lut");
 }
 
 bool LUTTools::LoadLUT(unsigned char* targetBuffer, int length, const char* filename){
-    char* lutBuffer = (char*)targetBuffer;
-    fstream lutfile; 
+    fstream lutfile;
     lutfile.open(filename, ios::in | ios::binary);
-    if(lutfile.is_open()){  // check if file opened correctly
-        lutfile.seekg (0, ios::beg);  // move to start of file.
-        lutfile.read (lutBuffer, length); // read in buffer
-        lutfile.close();
-        return true;
-    } else {
+    if(!lutfile.is_open()){  // check if file opened correctly
         lutfile.clear();
         return false;
     }
+    lutfile.seekg(0, ios::end);
+    int filelength = lutfile.tellg();
+    lutfile.seekg(0, ios::beg);  // move to start of file.
+    vector<unsigned char> contents(filelength > 0 ? filelength : 0);
+    if (filelength > 0)
+        lutfile.read(reinterpret_cast<char*>(&contents[0]), filelength);
+    bool ok = not lutfile.fail();
+    lutfile.close();
+    if (not ok)
+        return false;
+
+    if (filelength < LUTTOOLS_HEADER_SIZE or memcmp(&contents[0], LUTTOOLS_MAGIC, 4) != 0){
+        // a raw table from before the file had a header
+        if (filelength < length){
+            errorlog << "LUTTools::LoadLUT(" << filename << "). The file is " << filelength << " bytes, but the table is " << length << " bytes." << endl;
+            return false;
+        }
+        memcpy(targetBuffer, &contents[0], length);
+        return true;
+    }
+
+    Header header;
+    header.Version = contents[4];
+    header.Bits = contents[5];
+    header.Encoding = contents[6];
+    header.PayloadLength = readUInt32(&contents[8]);
+    header.Checksum = readUInt32(&contents[12]);
+    if (header.Version > LUTTOOLS_VERSION or header.Bits < LUTTOOLS_MIN_BITS or header.Bits > LUTTOOLS_MAX_BITS or length != LUT_SIZE){
+        errorlog << "LUTTools::LoadLUT(" << filename << "). Unsupported table, version: " << (int)header.Version << " bits: " << (int)header.Bits << " length: " << length << endl;
+        return false;
+    }
+    if (header.PayloadLength != static_cast<unsigned int>(filelength - LUTTOOLS_HEADER_SIZE)){
+        errorlog << "LUTTools::LoadLUT(" << filename << "). The file is truncated." << endl;
+        return false;
+    }
+
+    // decode into a separate buffer, so the target is left untouched until the table has been checked
+    int storedlength = 1 << (3*header.Bits);
+    vector<unsigned char> stored(storedlength);
+    unsigned char* table = &stored[0];
+
+    const unsigned char* payload = &contents[LUTTOOLS_HEADER_SIZE];
+    bool decoded = false;
+    if (header.Encoding == RAW and header.PayloadLength == static_cast<unsigned int>(storedlength)){
+        memcpy(table, payload, storedlength);
+        decoded = true;
+    }
+    else if (header.Encoding == RUN_LENGTH)
+        decoded = decodeRunLength(payload, header.PayloadLength, table, storedlength);
+    if (not decoded){
+        errorlog << "LUTTools::LoadLUT(" << filename << "). Unable to decode the table, encoding: " << (int)header.Encoding << endl;
+        return false;
+    }
+    if (adler32(table, storedlength) != header.Checksum){
+        errorlog << "LUTTools::LoadLUT(" << filename << "). The checksum does not match." << endl;
+        return false;
+    }
+
+    if (header.Bits == LUT_BITS)
+        memcpy(targetBuffer, table, LUT_SIZE);
+    else
+        resample(table, header.Bits, targetBuffer, LUT_BITS);
+    return true;
 }
 
 bool LUTTools::SaveLUT(unsigned char* sourceBuffer, int length){
@@ -28,16 +101,144 @@ bool LUTTools::SaveLUT(unsigned char* sourceBuffer, int length){
 }
 
 bool LUTTools::SaveLUT(unsigned char* sourceBuffer, int length, const char* filename){
-    char* lutBuffer = (char*) sourceBuffer;
+    return SaveLUT(sourceBuffer, length, filename, LUT_BITS, RUN_LENGTH);
+}
+
+bool LUTTools::SaveLUT(const unsigned char* sourceBuffer, int length, const char* filename, int bits, Encoding encoding){
+    if (length != LUT_SIZE or bits < LUTTOOLS_MIN_BITS or bits > LUTTOOLS_MAX_BITS)
+        return false;
+
+    int storedlength = 1 << (3*bits);
+    vector<unsigned char> stored;
+    const unsigned char* table = sourceBuffer;
+    if (bits != LUT_BITS){
+        stored.resize(storedlength);
+        resample(sourceBuffer, LUT_BITS, &stored[0], bits);
+        table = &stored[0];
+    }
+
+    vector<unsigned char> payload;
+    if (encoding == RUN_LENGTH)
+        encodeRunLength(table, storedlength, payload);
+    else
+        payload.assign(table, table + storedlength);
+
+    unsigned char header[LUTTOOLS_HEADER_SIZE];
+    memcpy(header, LUTTOOLS_MAGIC, 4);
+    header[4] = LUTTOOLS_VERSION;
+    header[5] = bits;
+    header[6] = encoding;
+    header[7] = 0;
+    writeUInt32(&header[8], payload.size());
+    writeUInt32(&header[12], adler32(table, storedlength));
+
     fstream lutfile;
-    lutfile.open(filename, ios::out | ios::binary);
+    lutfile.open(filename, ios::out | ios::binary | ios::trunc);
     if(lutfile.is_open()){  // check if file opened correctly
-        lutfile.seekp(ios::beg);
-        lutfile.write (lutBuffer, length);
+        lutfile.write(reinterpret_cast<char*>(header), LUTTOOLS_HEADER_SIZE);
+        lutfile.write(reinterpret_cast<char*>(&payload[0]), payload.size());
+        bool ok = not lutfile.fail();
         lutfile.close();
-        return true;
+        return ok;
     } else {
         lutfile.clear();
         return false;
     }
 }
+
+/*! @brief Converts a table between bit depths. When the target has fewer bits each entry is the most
+           common colour of the source entries it covers, otherwise each entry is copied from the source
+           entry that covers it.
+ */
+void LUTTools::resample(const unsigned char* source, int sourcebits, unsigned char* target, int targetbits){
+    int targetsize = 1 << targetbits;
+    if (targetbits >= sourcebits){
+        int shift = targetbits - sourcebits;
+        for (int y = 0; y < targetsize; y++)
+            for (int cb = 0; cb < targetsize; cb++)
+                for (int cr = 0; cr < targetsize; cr++)
+                    *target++ = source[((y >> shift) << (2*sourcebits)) + ((cb >> shift) << sourcebits) + (cr >> shift)];
+        return;
+    }
+
+    int shift = sourcebits - targetbits;
+    int block = 1 << shift;
+    unsigned int counts[256];
+    for (int y = 0; y < targetsize; y++)
+        for (int cb = 0; cb < targetsize; cb++)
+            for (int cr = 0; cr < targetsize; cr++){
+                memset(counts, 0, sizeof(counts));
+                unsigned char best = 0;
+                for (int i = 0; i < block; i++)
+                    for (int j = 0; j < block; j++){
+                        const unsigned char* row = source + (((y << shift) + i) << (2*sourcebits)) + (((cb << shift) + j) << sourcebits) + (cr << shift);
+                        for (int k = 0; k < block; k++)
+                            if (++counts[row[k]] > counts[best] or (counts[row[k]] == counts[best] and row[k] < best))
+                                best = row[k];
+                    }
+                *target++ = best;
+            }
+}
+
+/*! @brief Appends the run-length encoding of table to payload; each run is its value followed by its length as a base 128 varint */
+void LUTTools::encodeRunLength(const unsigned char* table, int length, vector<unsigned char>& payload){
+    int i = 0;
+    while (i < length){
+        unsigned char value = table[i];
+        int run = 1;
+        while (i + run < length and table[i + run] == value)
+            run++;
+        i += run;
+        payload.push_back(value);
+        while (run >= 0x80){
+            payload.push_back((run & 0x7F) | 0x80);
+            run >>= 7;
+        }
+        payload.push_back(run);
+    }
+}
+
+/*! @brief Decodes a run-length encoded payload into table.
+    @return false if the payload is malformed, or does not decode to exactly length entries
+ */
+bool LUTTools::decodeRunLength(const unsigned char* payload, unsigned int payloadlength, unsigned char* table, int length){
+    unsigned int p = 0;
+    int filled = 0;
+    while (p < payloadlength){
+        unsigned char value = payload[p++];
+        unsigned int run = 0;
+        int shift = 0;
+        while (true){
+            if (p >= payloadlength or shift > 28)
+                return false;
+            unsigned char byte = payload[p++];
+            run |= static_cast<unsigned int>(byte & 0x7F) << shift;
+            if (not (byte & 0x80))
+                break;
+            shift += 7;
+        }
+        if (run == 0 or run > static_cast<unsigned int>(length - filled))
+            return false;
+        memset(table + filled, value, run);
+        filled += run;
+    }
+    return filled == length;
+}
+
+/*! @brief Returns the Adler-32 checksum of data */
+unsigned int LUTTools::adler32(const unsigned char* data, int length){
+    const unsigned int modulus = 65521;
+    unsigned int a = 1;
+    unsigned int b = 0;
+    while (length > 0){
+        int chunk = length < 5552 ? length : 5552;        // the most bytes that can be summed before b can overflow
+        length -= chunk;
+        while (chunk-- > 0){
+            a += *data++;
+            b += a;
+        }
+        a %= modulus;
+        b %= modulus;
+    }
+    return (b << 16) | a;
+}
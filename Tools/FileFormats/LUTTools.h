@@ -2,10 +2,22 @@
   @file LUTTools.h
   @author Steven Nicklin
   @brief Defines some files used to load and save a lookup table to file.
+
+  A lookup table file starts with a LUTTools::Header followed by the table, which can be run-length encoded
+  and can be stored with fewer (or more) than the 7 bits per channel used by vision. The table is always
+  loaded as a 7 bit table of LUT_SIZE bytes. Files without a header (a raw 7 bit table) can still be loaded.
 */
 #ifndef LUTTOOLS_H_DEFINED
 #define LUTTOOLS_H_DEFINED
 #include "Infrastructure/NUImage/Pixel.h"
+#include <vector>
+
+#define LUTTOOLS_MAGIC          "NULT"      //!< the first four bytes of a lookup table file with a header
+#define LUTTOOLS_VERSION        1           //!< the version of the file format written by SaveLUT
+#define LUTTOOLS_HEADER_SIZE    16          //!< the size of the header in bytes
+#define LUTTOOLS_MIN_BITS       4           //!< the fewest bits per channel a file can be stored with
+#define LUTTOOLS_MAX_BITS       8           //!< the most bits per channel a file can be stored with
+
 /*!
   @brief Class contains functions used to load a colour lookup table from a file and also save a colour
          lookup table to a file.
@@ -14,10 +26,31 @@ class LUTTools
 {
 public:
     static const int LUT_SIZE = 128*128*128; //!< The size of a lookup table in bytes.
+    static const int LUT_BITS = 7;           //!< The number of bits per channel of a lookup table.
+
+    //! The ways the table can be stored after the header
+    enum Encoding
+    {
+        RAW = 0,                //!< one byte per entry
+        RUN_LENGTH = 1          //!< (value, run length) pairs, with the run length as a base 128 varint
+    };
+
+    /*!
+      @brief The header of a lookup table file. It is stored in the file byte by byte, little endian:
+             magic[4], version[1], bits[1], encoding[1], reserved[1], payload length[4], checksum[4]
+      */
+    struct Header
+    {
+        unsigned char Version;          //!< the version of the file format
+        unsigned char Bits;             //!< the number of bits per channel of the stored table
+        unsigned char Encoding;         //!< how the stored table is encoded (a LUTTools::Encoding)
+        unsigned int PayloadLength;     //!< the number of bytes after the header
+        unsigned int Checksum;          //!< the Adler-32 checksum of the decoded table at its stored bit depth
+    };
 
     /*!
       @brief Calculate the Index of a given Colour
-      @param colour 
+      @param colour
       @return index of colour.
       */
     static inline unsigned int  getLUTIndex(const Pixel& colour)
@@ -34,6 +67,9 @@ public:
     static bool LoadLUT(unsigned char* targetBuffer, int length);
     /*!
       @brief Load a lookup table from a specified file into a supplied buffer.
+
+      Files with a header are checked, decoded and converted to 7 bits per channel, so length must be LUT_SIZE.
+      Files without a header are read as they are. The buffer is not modified if the file can not be loaded.
       @param targetBuffer The buffer to which the colour lookup table will be written.
       @param length The length of the colour lookuptable in bytes.
       @param fileName The name of the file to be loaded.
@@ -55,5 +91,22 @@ public:
       @return True if the colour lookup table was saved successfully. False if it was not.
       */
     static bool SaveLUT(unsigned char* sourceBuffer, int length, const char* filename);
+    /*!
+      @brief Save a 7 bit lookup table into a file with the given bit depth and encoding.
+      @param sourceBuffer The buffer in which the colour lookup table is stored.
+      @param length The length of the colour lookuptable in bytes, this must be LUT_SIZE.
+      @param fileName The name of the file to save the colour lookup table.
+      @param bits The number of bits per channel to store the table with. With fewer than 7 bits each
+                  entry is the most common colour of the entries it replaces.
+      @param encoding How to encode the stored table.
+      @return True if the colour lookup table was saved successfully. False if it was not.
+      */
+    static bool SaveLUT(const unsigned char* sourceBuffer, int length, const char* filename, int bits, Encoding encoding);
+
+private:
+    static void resample(const unsigned char* source, int sourcebits, unsigned char* target, int targetbits);
+    static void encodeRunLength(const unsigned char* table, int length, std::vector<unsigned char>& payload);
+    static bool decodeRunLength(const unsigned char* payload, unsigned int payloadlength, unsigned char* table, int length);
+    static unsigned int adler32(const unsigned char* data, int length);
 };
 #endif
@@ -0,0 +1,414 @@
+/*! @file AsyncLog.cpp
+    @brief Implementation of AsyncLog class
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "AsyncLog.h"
+#include "LogWriterThread.h"
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cstring>
+#include <sstream>
+#include <pthread.h>
+#include <time.h>
+using namespace std;
+
+/*! @brief The log state of a single thread. Only the thread itself writes to it, except for ReportedDropped
+           which belongs to the writer, and the Pending text which close() commits for every thread.
+ */
+struct LogThreadBuffer
+{
+    LogThreadBuffer() : Ring(LOG_RING_SIZE)
+    {
+        pthread_mutex_init(&PendingMutex, NULL);
+        memset(PendingLength, 0, sizeof(PendingLength));
+        memset(const_cast<unsigned int*>(Dropped), 0, sizeof(Dropped));
+        memset(ReportedDropped, 0, sizeof(ReportedDropped));
+        Finished = 0;
+    }
+    ~LogThreadBuffer()
+    {
+        pthread_mutex_destroy(&PendingMutex);
+    }
+    LogRing Ring;                                                   //!< the records committed by the thread, waiting for the writer
+    pthread_mutex_t PendingMutex;                                   //!< lock for Pending and PendingLength, only ever contended by close()
+    char Pending[LOG_MAX_CHANNELS][LOG_MAX_RECORD_LENGTH];          //!< the text written to each channel since it was last flushed
+    size_t PendingLength[LOG_MAX_CHANNELS];                         //!< the number of characters in each Pending
+    volatile unsigned int Dropped[LOG_MAX_CHANNELS];                //!< the number of records for each channel that did not fit in the ring
+    unsigned int ReportedDropped[LOG_MAX_CHANNELS];                 //!< the number of dropped records the writer has noted in the log
+    volatile int Finished;                                          //!< non-zero once the thread has exited; the writer deletes the buffer when it is empty
+};
+
+static __thread LogThreadBuffer* CurrentBuffer = NULL;              //!< the buffer of each thread, NULL until the thread first logs
+static pthread_key_t BufferKey;                                     //!< the key used to find out when a thread with a buffer exits
+static pthread_once_t BufferKeyOnce = PTHREAD_ONCE_INIT;
+
+static pthread_mutex_t RegistryMutex = PTHREAD_MUTEX_INITIALIZER;   //!< lock for Buffers and Channels, taken once by each thread when it first logs, and by the writer
+static pthread_mutex_t DrainMutex = PTHREAD_MUTEX_INITIALIZER;      //!< lock for taking records off the rings, and for deleting buffers. It may be held while taking
+                                                                    //!< the RegistryMutex or a PendingMutex, but never the other way around
+static vector<LogThreadBuffer*> Buffers;                            //!< the buffer of every thread that has logged
+static LogChannel* Channels[LOG_MAX_CHANNELS];                      //!< the open channels
+static unsigned short NumChannels = 0;                              //!< the number of open channels
+
+static LogWriterThread* Writer = NULL;                              //!< the thread writing the records to the files
+static volatile int Running = 0;                                    //!< non-zero while the writer is draining the rings
+static volatile unsigned int NumDropped = 0;                        //!< the number of records that have been dropped, as seen by the writer
+
+/*! @brief Commits any unflushed text, and marks the buffer as finished, when a thread that has logged exits.
+           The writer deletes a finished buffer, but once the writer has stopped the thread deletes its own.
+ */
+void AsyncLog::finishBuffer(void* p)
+{
+    LogThreadBuffer* buffer = static_cast<LogThreadBuffer*>(p);
+    CurrentBuffer = buffer;
+    for (unsigned short i=0; i<LOG_MAX_CHANNELS; i++)
+        commit(i);
+    CurrentBuffer = NULL;
+    __sync_fetch_and_add(&buffer->Finished, 1);
+    if (__sync_fetch_and_add(&Running, 0) == 0)
+    {   // close()'s drain may have missed that the buffer was finished; if it did not, the buffer is already gone from Buffers
+        pthread_mutex_lock(&DrainMutex);
+        if (removeBuffer(buffer))
+        {
+            writeRing(buffer, getNumChannels());
+            delete buffer;
+        }
+        pthread_mutex_unlock(&DrainMutex);
+    }
+}
+
+/*! @brief Creates the key used to find out when a thread exits */
+void AsyncLog::createBufferKey()
+{
+    pthread_key_create(&BufferKey, finishBuffer);
+}
+
+/*! @brief Opens a text (or binary) channel, and puts it under stream, so that everything written to the stream is logged
+    @param stream the stream, for example debug or errorlog. Its existing buffer is left in place, but is no longer used.
+    @param filename the name of the log file
+    @param binary true if the records are to be written with their headers
+    @return the channel, or NULL if LOG_MAX_CHANNELS are already open
+ */
+LogChannel* AsyncLog::attach(ostream& stream, const string& filename, bool binary)
+{
+    LogChannel* channel = open(filename, binary);
+    if (channel != NULL)
+    {
+        stream.rdbuf(channel);
+        stream.clear();                     // a stream that was written to before it was opened will be in a failed state
+    }
+    return channel;
+}
+
+/*! @brief Opens a channel that is not under a stream; records are logged to it with record()
+    @param filename the name of the log file
+    @param binary true if the records are to be written with their headers
+    @return the channel, or NULL if LOG_MAX_CHANNELS are already open
+ */
+LogChannel* AsyncLog::open(const string& filename, bool binary)
+{
+    pthread_mutex_lock(&RegistryMutex);
+    LogChannel* channel = NULL;
+    if (NumChannels < LOG_MAX_CHANNELS)
+    {
+        channel = new LogChannel(NumChannels, filename, binary);
+        Channels[NumChannels] = channel;
+        NumChannels++;
+    }
+    pthread_mutex_unlock(&RegistryMutex);
+
+    if (Writer == NULL)
+    {
+        __sync_fetch_and_add(&Running, 1);
+        Writer = new LogWriterThread();
+    }
+    return channel;
+}
+
+/*! @brief Writes everything that has been logged, including text that has not been flushed, and stops the writer.
+           From then on records are written by the thread that logs them. This should only be called once, at shutdown.
+ */
+void AsyncLog::close()
+{
+    if (not __sync_bool_compare_and_swap(&Running, 1, 0))
+        return;
+    Writer->finish();
+    drain(true);                            // the writer has exited; the threads that log now drain their own rings, under the DrainMutex
+    // The writer is left allocated; it has been joined, and Thread's destructor would cancel it again
+}
+
+/*! @brief Logs a binary record. This never blocks, if there is no room for the record it is dropped.
+    @param channel the channel to log the record to
+    @param type the id of the record, which should not be LOG_TEXT_RECORD
+    @param data the record
+    @param length the number of bytes in the record, at most LOG_MAX_RECORD_LENGTH
+    @return true if the record was logged, false if it was dropped
+ */
+bool AsyncLog::record(LogChannel* channel, unsigned short type, const void* data, size_t length)
+{
+    if (channel == NULL)
+        return false;
+    LogThreadBuffer* buffer = getBuffer();
+    bool logged = push(buffer, channel->getIndex(), type, data, length);
+    drainIfStopped(buffer);
+    return logged;
+}
+
+/*! @brief Returns the number of records that have been dropped because a thread's ring was full */
+unsigned int AsyncLog::getNumDropped()
+{
+    return __sync_fetch_and_add(&NumDropped, 0);
+}
+
+/*! @brief Adds text to the calling thread's record for the channel. If the record becomes too long it is committed,
+           and the rest of the text starts a new record.
+ */
+void AsyncLog::append(unsigned short channel, const char* data, size_t length)
+{
+    LogThreadBuffer* buffer = getBuffer();
+    char* pending = buffer->Pending[channel];
+    size_t& pendinglength = buffer->PendingLength[channel];
+    while (length > 0)
+    {
+        pthread_mutex_lock(&buffer->PendingMutex);
+        bool pushed = false;
+        if (pendinglength == LOG_MAX_RECORD_LENGTH)
+        {
+            push(buffer, channel, LOG_TEXT_RECORD, pending, pendinglength);
+            pendinglength = 0;
+            pushed = true;
+        }
+        size_t n = min(length, LOG_MAX_RECORD_LENGTH - pendinglength);
+        memcpy(pending + pendinglength, data, n);
+        pendinglength += n;
+        pthread_mutex_unlock(&buffer->PendingMutex);
+        if (pushed)
+            drainIfStopped(buffer);
+        data += n;
+        length -= n;
+    }
+}
+
+/*! @brief Commits the calling thread's record for the channel */
+void AsyncLog::commit(unsigned short channel)
+{
+    LogThreadBuffer* buffer = CurrentBuffer;
+    if (buffer == NULL)
+        return;
+    pthread_mutex_lock(&buffer->PendingMutex);
+    bool pushed = buffer->PendingLength[channel] > 0;
+    if (pushed)
+    {
+        push(buffer, channel, LOG_TEXT_RECORD, buffer->Pending[channel], buffer->PendingLength[channel]);
+        buffer->PendingLength[channel] = 0;
+    }
+    pthread_mutex_unlock(&buffer->PendingMutex);
+    if (pushed)
+        drainIfStopped(buffer);
+}
+
+/*! @brief Timestamps a record and pushes it onto the thread's ring. The caller must follow this with drainIfStopped().
+    @return true if the record was logged, false if it was dropped
+ */
+bool AsyncLog::push(LogThreadBuffer* buffer, unsigned short channel, unsigned short type, const void* data, size_t length)
+{
+    if (length > LOG_MAX_RECORD_LENGTH)
+        return false;
+
+    LogRecordHeader header;
+    header.Timestamp = getTime();
+    header.Channel = channel;
+    header.Type = type;
+    header.Length = length;
+    if (buffer->Ring.push(header, data))
+        return true;
+    __sync_fetch_and_add(&buffer->Dropped[channel], 1);
+    return false;
+}
+
+/*! @brief Writes out the calling thread's ring if the writer has stopped.
+
+    This is checked after the record is pushed rather than before, because close() may stop the writer and make
+    its last drain between the two; a record pushed after that drain would otherwise never be written.
+ */
+void AsyncLog::drainIfStopped(LogThreadBuffer* buffer)
+{
+    if (__sync_fetch_and_add(&Running, 0) != 0)
+        return;
+    pthread_mutex_lock(&DrainMutex);
+    unsigned short numchannels = getNumChannels();
+    writeRing(buffer, numchannels);
+    for (unsigned short c=0; c<numchannels; c++)
+        Channels[c]->flush();
+    pthread_mutex_unlock(&DrainMutex);
+}
+
+/*! @brief Writes the records in every thread's ring to their channels, notes any records that were dropped, and
+           flushes the files. This is called by the writer, and once by close().
+
+    The rings are merged so that the records are written in the order they were committed. Only records committed
+    before the drain started are written, so a thread that logs quickly can not keep the writer from finishing.
+    @param everything true to write every record, however late it was committed, and the text each thread has not yet flushed
+ */
+void AsyncLog::drain(bool everything)
+{
+    pthread_mutex_lock(&DrainMutex);
+    pthread_mutex_lock(&RegistryMutex);
+    vector<LogThreadBuffer*> buffers = Buffers;
+    unsigned short numchannels = NumChannels;
+    pthread_mutex_unlock(&RegistryMutex);
+
+    vector<bool> finished(buffers.size());
+    for (size_t i=0; i<buffers.size(); i++)
+        finished[i] = __sync_fetch_and_add(&buffers[i]->Finished, 0) != 0;      // if the thread has finished, everything it pushed is now visible
+    double now = everything ? numeric_limits<double>::max() : getTime();
+
+    LogRecordHeader header;
+    char data[LOG_MAX_RECORD_LENGTH];
+    while (1)
+    {
+        LogThreadBuffer* oldest = NULL;
+        double oldesttime = now;
+        for (size_t i=0; i<buffers.size(); i++)
+        {
+            if (buffers[i]->Ring.peek(header) and header.Timestamp <= oldesttime)
+            {
+                oldest = buffers[i];
+                oldesttime = header.Timestamp;
+            }
+        }
+        if (oldest == NULL)
+            break;
+        oldest->Ring.pop(header, data);
+        if (header.Channel < numchannels)
+            Channels[header.Channel]->write(header, data);
+    }
+
+    for (size_t i=0; i<buffers.size(); i++)
+    {
+        LogThreadBuffer* buffer = buffers[i];
+        if (finished[i])            // the ring of a finished thread is emptied regardless of the timestamps, because it is about to be deleted
+            writeRing(buffer, numchannels);
+        if (everything)
+        {   // the text a thread has not flushed is written after the rest of its ring, which it may have pushed to since the merge
+            pthread_mutex_lock(&buffer->PendingMutex);
+            writeRing(buffer, numchannels);
+            for (unsigned short c=0; c<numchannels; c++)
+            {
+                if (buffer->PendingLength[c] > 0)
+                {
+                    header.Timestamp = getTime();
+                    header.Channel = c;
+                    header.Type = LOG_TEXT_RECORD;
+                    header.Length = buffer->PendingLength[c];
+                    Channels[c]->write(header, buffer->Pending[c]);
+                    buffer->PendingLength[c] = 0;
+                }
+            }
+            pthread_mutex_unlock(&buffer->PendingMutex);
+        }
+
+        for (unsigned short c=0; c<numchannels; c++)
+        {
+            unsigned int dropped = __sync_fetch_and_add(&buffer->Dropped[c], 0);
+            if (dropped != buffer->ReportedDropped[c])
+            {
+                stringstream note;
+                note << "AsyncLog dropped " << dropped - buffer->ReportedDropped[c] << " records because a thread's log was full" << endl;
+                string text = note.str();
+                header.Timestamp = getTime();
+                header.Channel = c;
+                header.Type = LOG_TEXT_RECORD;
+                header.Length = text.size();
+                Channels[c]->write(header, text.c_str());
+                __sync_fetch_and_add(&NumDropped, dropped - buffer->ReportedDropped[c]);
+                buffer->ReportedDropped[c] = dropped;
+            }
+        }
+
+        if (finished[i] and removeBuffer(buffer))
+            delete buffer;
+    }
+
+    for (unsigned short c=0; c<numchannels; c++)
+        Channels[c]->flush();
+    pthread_mutex_unlock(&DrainMutex);
+}
+
+/*! @brief Writes all of the records in a thread's ring to their channels. The DrainMutex must be held. */
+void AsyncLog::writeRing(LogThreadBuffer* buffer, unsigned short numchannels)
+{
+    LogRecordHeader header;
+    char data[LOG_MAX_RECORD_LENGTH];
+    while (buffer->Ring.pop(header, data))
+    {
+        if (header.Channel < numchannels)
+            Channels[header.Channel]->write(header, data);
+    }
+}
+
+/*! @brief Takes a buffer out of Buffers so that it can be deleted. The DrainMutex must be held.
+    @return false if the buffer has already been taken out
+ */
+bool AsyncLog::removeBuffer(LogThreadBuffer* buffer)
+{
+    pthread_mutex_lock(&RegistryMutex);
+    vector<LogThreadBuffer*>::iterator it = find(Buffers.begin(), Buffers.end(), buffer);
+    bool found = it != Buffers.end();
+    if (found)
+        Buffers.erase(it);
+    pthread_mutex_unlock(&RegistryMutex);
+    return found;
+}
+
+/*! @brief Returns the number of open channels */
+unsigned short AsyncLog::getNumChannels()
+{
+    pthread_mutex_lock(&RegistryMutex);
+    unsigned short numchannels = NumChannels;
+    pthread_mutex_unlock(&RegistryMutex);
+    return numchannels;
+}
+
+/*! @brief Returns the calling thread's buffer, creating it the first time the thread logs */
+LogThreadBuffer* AsyncLog::getBuffer()
+{
+    if (CurrentBuffer == NULL)
+    {
+        pthread_once(&BufferKeyOnce, AsyncLog::createBufferKey);
+        LogThreadBuffer* buffer = new LogThreadBuffer();
+        pthread_mutex_lock(&RegistryMutex);
+        Buffers.push_back(buffer);
+        pthread_mutex_unlock(&RegistryMutex);
+        pthread_setspecific(BufferKey, buffer);
+        CurrentBuffer = buffer;
+    }
+    return CurrentBuffer;
+}
+
+/*! @brief Returns the time in ms since the epoch, used to timestamp each record */
+double AsyncLog::getTime()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return 1e3*now.tv_sec + 1e-6*now.tv_nsec;
+}
+
@@ -0,0 +1,92 @@
+/*! @file AsyncLog.h
+    @brief Declaration of AsyncLog class
+
+    @class AsyncLog
+    @brief Takes the writing of the log files off the threads that log
+
+    Writing to a log stream never touches the disk, and only blocks while close() is running. Each thread that logs formats
+    into its own buffer, and each record (everything written to a stream up to a flush) is timestamped
+    and pushed onto the thread's lock-free LogRing. A low priority LogWriterThread drains the rings
+    every LOG_WRITER_PERIOD ms, and writes the records to each LogChannel's file. When a thread's ring
+    is full its records are dropped, and the number dropped is noted in the log by the writer.
+
+    The existing streams are used as is:
+    @code
+    AsyncLog::attach(debug, "/var/volatile/debug.log");
+    AsyncLog::attach(errorlog, "/var/volatile/error.log");
+    debug << "NUbot Debug Log" << endl;
+    @endcode
+    and records can also be logged in binary for cheap high volume logging:
+    @code
+    LogChannel* channel = AsyncLog::open("/var/volatile/sensors.bin");
+    AsyncLog::record(channel, 1, &data[0], data.size()*sizeof(float));
+    @endcode
+
+    close() stops the writer once everything has been written, including any text that has not been
+    flushed; after that each record is written to its file by the thread that logs it, and the buffer of
+    a thread that exits is deleted by the thread itself.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ASYNCLOG_H
+#define ASYNCLOG_H
+
+#include "LogRing.h"
+#include "LogChannel.h"
+
+#include <ostream>
+#include <string>
+
+#define LOG_MAX_CHANNELS            8               //!< the largest number of channels that can be opened
+#define LOG_RING_SIZE               (256*1024)      //!< the size in bytes of each thread's ring
+#define LOG_WRITER_PERIOD           50              //!< the time in ms between each drain of the rings
+
+class LogWriterThread;
+struct LogThreadBuffer;
+
+class AsyncLog
+{
+public:
+    static LogChannel* attach(std::ostream& stream, const std::string& filename, bool binary = false);
+    static LogChannel* open(const std::string& filename, bool binary = true);
+    static void close();
+
+    static bool record(LogChannel* channel, unsigned short type, const void* data, size_t length);
+    static unsigned int getNumDropped();
+private:
+    friend class LogChannel;
+    friend class LogWriterThread;
+
+    static void append(unsigned short channel, const char* data, size_t length);
+    static void commit(unsigned short channel);
+    static bool push(LogThreadBuffer* buffer, unsigned short channel, unsigned short type, const void* data, size_t length);
+    static void drainIfStopped(LogThreadBuffer* buffer);
+    static void drain(bool everything = false);
+    static void writeRing(LogThreadBuffer* buffer, unsigned short numchannels);
+    static bool removeBuffer(LogThreadBuffer* buffer);
+    static void finishBuffer(void* p);
+    static void createBufferKey();
+
+    static LogThreadBuffer* getBuffer();
+    static unsigned short getNumChannels();
+    static double getTime();
+};
+
+#endif
+
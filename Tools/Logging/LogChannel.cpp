@@ -0,0 +1,171 @@
+/*! @file LogChannel.cpp
+    @brief Implementation of LogChannel class
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "LogChannel.h"
+#include "AsyncLog.h"
+
+#include <cstdio>
+#include <ctime>
+#include <sstream>
+using namespace std;
+
+/*! @brief Creates a channel, and opens its file
+    @param index the index of the channel in AsyncLog
+    @param filename the name of the log file
+    @param binary true if the records are to be written with their headers, false if they are written as text
+ */
+LogChannel::LogChannel(unsigned short index, const string& filename, bool binary) : m_index(index), m_filename(filename), m_binary(binary)
+{
+    pthread_mutex_init(&m_file_mutex, NULL);
+    open();
+}
+
+LogChannel::~LogChannel()
+{
+    m_file.close();
+    pthread_mutex_destroy(&m_file_mutex);
+}
+
+/*! @brief Writes a record to the file, rotating the file if it has become too large
+    @param header the header of the record
+    @param data the header.Length bytes of the record
+ */
+void LogChannel::write(const LogRecordHeader& header, const char* data)
+{
+    pthread_mutex_lock(&m_file_mutex);
+    if (m_binary)
+    {
+        m_file.write(reinterpret_cast<const char*>(&header), sizeof(LogRecordHeader));
+        m_file.write(data, header.Length);
+        m_file_size += sizeof(LogRecordHeader) + header.Length;
+    }
+    else if (header.Length > 0)
+    {
+        if (m_line_start)
+            writeTimestamp(header.Timestamp);
+        m_file.write(data, header.Length);
+        m_file_size += header.Length;
+        m_line_start = data[header.Length - 1] == '\n';
+    }
+
+    if (m_file_size > LOG_MAX_FILE_SIZE and (m_binary or m_line_start))
+        rotate();
+    pthread_mutex_unlock(&m_file_mutex);
+}
+
+/*! @brief Flushes the file to disk */
+void LogChannel::flush()
+{
+    pthread_mutex_lock(&m_file_mutex);
+    m_file.flush();
+    pthread_mutex_unlock(&m_file_mutex);
+}
+
+/*! @brief Returns the index of the channel in AsyncLog */
+unsigned short LogChannel::getIndex() const
+{
+    return m_index;
+}
+
+/*! @brief Returns the name of the log file */
+const string& LogChannel::getFilename() const
+{
+    return m_filename;
+}
+
+/*! @brief Returns true if the records are written with their headers */
+bool LogChannel::isBinary() const
+{
+    return m_binary;
+}
+
+/*! @brief Adds a single character to the calling thread's record */
+int LogChannel::overflow(int c)
+{
+    if (c != traits_type::eof())
+    {
+        char ch = static_cast<char>(c);
+        AsyncLog::append(m_index, &ch, 1);
+    }
+    return traits_type::not_eof(c);
+}
+
+/*! @brief Adds n characters to the calling thread's record */
+streamsize LogChannel::xsputn(const char* s, streamsize n)
+{
+    AsyncLog::append(m_index, s, static_cast<size_t>(n));
+    return n;
+}
+
+/*! @brief Commits the calling thread's record */
+int LogChannel::sync()
+{
+    AsyncLog::commit(m_index);
+    return 0;
+}
+
+/*! @brief Opens (and truncates) the log file */
+void LogChannel::open()
+{
+    if (m_binary)
+        m_file.open(m_filename.c_str(), ios_base::out | ios_base::trunc | ios_base::binary);
+    else
+        m_file.open(m_filename.c_str(), ios_base::out | ios_base::trunc);
+    m_file_size = 0;
+    m_line_start = true;
+    if (m_binary)
+    {
+        m_file.write(LOG_BINARY_MAGIC, 4);
+        m_file_size += 4;
+    }
+}
+
+/*! @brief Moves each of the old log files up one, and starts a new file */
+void LogChannel::rotate()
+{
+    m_file.close();
+    for (int i=LOG_NUM_ROTATED_FILES; i>0; i--)
+    {
+        stringstream from, to;
+        if (i > 1)
+            from << m_filename << "." << i-1;
+        else
+            from << m_filename;
+        to << m_filename << "." << i;
+        rename(from.str().c_str(), to.str().c_str());
+    }
+    open();
+}
+
+/*! @brief Writes the local time of day of the timestamp, to the millisecond, at the start of a line */
+void LogChannel::writeTimestamp(double timestamp)
+{
+    time_t seconds = static_cast<time_t>(timestamp/1e3);
+    int milliseconds = static_cast<int>(timestamp - 1e3*seconds);
+    struct tm local;
+    localtime_r(&seconds, &local);
+
+    char buffer[32];
+    int length = snprintf(buffer, sizeof(buffer), "[%02d:%02d:%02d.%03d] ", local.tm_hour, local.tm_min, local.tm_sec, milliseconds);
+    m_file.write(buffer, length);
+    m_file_size += length;
+}
+
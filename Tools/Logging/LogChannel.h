@@ -0,0 +1,82 @@
+/*! @file LogChannel.h
+    @brief Declaration of LogChannel class
+
+    @class LogChannel
+    @brief A stream buffer that sends everything written to it to AsyncLog, and the file it ends up in
+
+    A LogChannel is put under an existing stream (for example debug or errorlog) by AsyncLog::attach(),
+    so that the stream's users do not change. The channel has no put area of its own, because the same
+    stream is written to by every thread; the characters are collected in the calling thread's buffer,
+    and become a record when the stream is flushed (by endl or flush).
+
+    The log writer thread gives the records back to the channel to be written to its file. A text
+    channel prefixes each line with the time it was committed, a binary channel writes each record
+    with its LogRecordHeader. When the file grows past LOG_MAX_FILE_SIZE it is rotated; the file is
+    renamed to filename.1, filename.1 to filename.2 and so on, keeping LOG_NUM_ROTATED_FILES old files.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOGCHANNEL_H
+#define LOGCHANNEL_H
+
+#include "LogRing.h"
+
+#include <streambuf>
+#include <fstream>
+#include <string>
+#include <pthread.h>
+
+#define LOG_MAX_FILE_SIZE           (4*1024*1024)   //!< the size in bytes at which a log file is rotated
+#define LOG_NUM_ROTATED_FILES       3               //!< the number of old log files kept when rotating
+#define LOG_BINARY_MAGIC            "NULG"          //!< the first four bytes of a binary log file
+
+class LogChannel : public std::streambuf
+{
+public:
+    LogChannel(unsigned short index, const std::string& filename, bool binary);
+    ~LogChannel();
+
+    void write(const LogRecordHeader& header, const char* data);
+    void flush();
+
+    unsigned short getIndex() const;
+    const std::string& getFilename() const;
+    bool isBinary() const;
+protected:
+    int overflow(int c);
+    std::streamsize xsputn(const char* s, std::streamsize n);
+    int sync();
+private:
+    LogChannel(const LogChannel&);
+    LogChannel& operator=(const LogChannel&);
+    void open();
+    void rotate();
+    void writeTimestamp(double timestamp);
+
+    unsigned short m_index;             //!< the index of this channel in AsyncLog
+    std::string m_filename;             //!< the name of the current log file
+    bool m_binary;                      //!< true if records are written with their headers, false if they are written as text
+    std::ofstream m_file;               //!< the current log file
+    size_t m_file_size;                 //!< the number of bytes written to the current log file
+    bool m_line_start;                  //!< true if the next character written to a text file starts a new line
+    pthread_mutex_t m_file_mutex;       //!< lock for the file, which is written by the writer thread, or by any thread once the writer has stopped
+};
+
+#endif
+
@@ -0,0 +1,110 @@
+/*! @file LogRing.cpp
+    @brief Implementation of LogRing class
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "LogRing.h"
+
+#include <cstring>
+
+/*! @brief Creates an empty ring
+    @param size the minimum size of the ring in bytes, it is rounded up to a power of two
+ */
+LogRing::LogRing(size_t size)
+{
+    m_size = 1;
+    while (m_size < size)
+        m_size <<= 1;
+    m_buffer = new char[m_size];
+    m_head = 0;
+    m_tail = 0;
+}
+
+LogRing::~LogRing()
+{
+    delete [] m_buffer;
+}
+
+/*! @brief Adds a record to the ring. This must only be called by the producer.
+    @param header the header of the record, header.Length bytes of data are added
+    @param data the data of the record
+    @return true if the record was added, false if there was not enough space
+ */
+bool LogRing::push(const LogRecordHeader& header, const void* data)
+{
+    size_t bytes = sizeof(LogRecordHeader) + header.Length;
+    size_t head = __sync_fetch_and_add(&m_head, 0);
+    if (header.Length > LOG_MAX_RECORD_LENGTH or m_size - (head - __sync_fetch_and_add(&m_tail, 0)) < bytes)
+        return false;
+
+    copyIn(head, &header, sizeof(LogRecordHeader));
+    copyIn(head + sizeof(LogRecordHeader), data, header.Length);
+    __sync_fetch_and_add(&m_head, bytes);
+    return true;
+}
+
+/*! @brief Removes the oldest record from the ring. This must only be called by the consumer.
+    @param header will be updated with the header of the record
+    @param data will be updated with the data of the record, it must hold LOG_MAX_RECORD_LENGTH bytes
+    @return true if a record was removed, false if the ring was empty
+ */
+bool LogRing::pop(LogRecordHeader& header, char* data)
+{
+    size_t tail = __sync_fetch_and_add(&m_tail, 0);
+    if (__sync_fetch_and_add(&m_head, 0) == tail)
+        return false;
+
+    copyOut(tail, &header, sizeof(LogRecordHeader));
+    copyOut(tail + sizeof(LogRecordHeader), data, header.Length);
+    __sync_fetch_and_add(&m_tail, sizeof(LogRecordHeader) + header.Length);
+    return true;
+}
+
+/*! @brief Gets the header of the oldest record, without removing it. This must only be called by the consumer.
+    @param header will be updated with the header of the record
+    @return true if there was a record, false if the ring was empty
+ */
+bool LogRing::peek(LogRecordHeader& header) const
+{
+    size_t tail = __sync_fetch_and_add(const_cast<volatile size_t*>(&m_tail), 0);
+    if (__sync_fetch_and_add(const_cast<volatile size_t*>(&m_head), 0) == tail)
+        return false;
+
+    copyOut(tail, &header, sizeof(LogRecordHeader));
+    return true;
+}
+
+/*! @brief Copies bytes into the ring at position, wrapping around the end of the buffer */
+void LogRing::copyIn(size_t position, const void* source, size_t bytes)
+{
+    size_t offset = position & (m_size - 1);
+    size_t first = bytes < m_size - offset ? bytes : m_size - offset;
+    memcpy(m_buffer + offset, source, first);
+    memcpy(m_buffer, static_cast<const char*>(source) + first, bytes - first);
+}
+
+/*! @brief Copies bytes out of the ring at position, wrapping around the end of the buffer */
+void LogRing::copyOut(size_t position, void* destination, size_t bytes) const
+{
+    size_t offset = position & (m_size - 1);
+    size_t first = bytes < m_size - offset ? bytes : m_size - offset;
+    memcpy(destination, m_buffer + offset, first);
+    memcpy(static_cast<char*>(destination) + first, m_buffer, bytes - first);
+}
+
@@ -0,0 +1,72 @@
+/*! @file LogRing.h
+    @brief Declaration of LogRing class, and the LogRecordHeader
+
+    @class LogRing
+    @brief A lock-free ring buffer of log records with a single producer and a single consumer
+
+    Each thread that logs has its own ring, so the producer is always the thread that owns it and the
+    consumer is always the log writer thread. Neither side ever blocks: push() returns false when the
+    record does not fit (the caller drops it), and pop() returns false when the ring is empty.
+
+    Each record is a LogRecordHeader followed by Length bytes of data. The head and tail count every
+    byte ever written and read. Only the producer moves the head and only the consumer moves the tail,
+    and both are moved and read with atomic operations, which are full memory barriers, so a record is
+    always written before it is published and read before its space is given back.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOGRING_H
+#define LOGRING_H
+
+#include <cstddef>
+
+#define LOG_MAX_RECORD_LENGTH       1024            //!< the largest record in bytes (excluding the header). Longer text is split, longer binary records are dropped
+#define LOG_TEXT_RECORD             0               //!< the type of a record holding text written to a stream
+
+struct LogRecordHeader
+{
+    double Timestamp;                   //!< the time the record was committed in ms since the epoch
+    unsigned short Channel;             //!< the index of the LogChannel the record is for
+    unsigned short Type;                //!< LOG_TEXT_RECORD, or the id of a binary record
+    unsigned int Length;                //!< the number of bytes of data following the header
+};
+
+class LogRing
+{
+public:
+    explicit LogRing(size_t size);
+    ~LogRing();
+
+    bool push(const LogRecordHeader& header, const void* data);
+    bool pop(LogRecordHeader& header, char* data);
+    bool peek(LogRecordHeader& header) const;
+private:
+    LogRing(const LogRing&);
+    LogRing& operator=(const LogRing&);
+    void copyIn(size_t position, const void* source, size_t bytes);
+    void copyOut(size_t position, void* destination, size_t bytes) const;
+
+    char* m_buffer;                     //!< the storage for the records
+    size_t m_size;                      //!< the size of m_buffer in bytes, a power of two
+    volatile size_t m_head;             //!< the number of bytes ever pushed, only written by the producer
+    volatile size_t m_tail;             //!< the number of bytes ever popped, only written by the consumer
+};
+
+#endif
+
@@ -0,0 +1,62 @@
+/*! @file LogWriterThread.cpp
+    @brief Implementation of LogWriterThread class
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "LogWriterThread.h"
+#include "AsyncLog.h"
+
+#include <time.h>
+#include <errno.h>
+using namespace std;
+
+/*! @brief Creates and starts the thread */
+LogWriterThread::LogWriterThread() : Thread(string("LogWriterThread"), 0)
+{
+    m_finishing = 0;
+    start();
+}
+
+LogWriterThread::~LogWriterThread()
+{
+}
+
+/*! @brief Asks the thread to write everything that has been logged, and waits for it to exit */
+void LogWriterThread::finish()
+{
+    __sync_fetch_and_add(&m_finishing, 1);
+    join();
+}
+
+/*! @brief The log writer main loop; drains the rings every LOG_WRITER_PERIOD ms until asked to finish */
+void LogWriterThread::run()
+{
+    struct timespec period;
+    period.tv_sec = LOG_WRITER_PERIOD/1000;
+    period.tv_nsec = (LOG_WRITER_PERIOD % 1000)*1000000L;
+    while (__sync_fetch_and_add(&m_finishing, 0) == 0)
+    {
+        AsyncLog::drain();
+        struct timespec remaining = period;
+        while (nanosleep(&remaining, &remaining) == -1 and errno == EINTR);
+        pthread_testcancel();
+    }
+    AsyncLog::drain();
+}
+
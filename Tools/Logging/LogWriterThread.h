@@ -0,0 +1,47 @@
+/*! @file LogWriterThread.h
+    @brief Declaration of LogWriterThread class
+
+    @class LogWriterThread
+    @brief A low priority thread that writes the records logged by every other thread to their files
+
+    The thread is not real-time, so it only runs when the control threads are idle. Every
+    LOG_WRITER_PERIOD ms it drains each thread's ring with AsyncLog::drain(), and flushes the files.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOGWRITERTHREAD_H
+#define LOGWRITERTHREAD_H
+
+#include "Tools/Threading/Thread.h"
+
+class LogWriterThread : public Thread
+{
+public:
+    LogWriterThread();
+    ~LogWriterThread();
+
+    void finish();
+protected:
+    void run();
+private:
+    volatile int m_finishing;               //!< non-zero when the thread has been asked to drain the rings a final time and exit
+};
+
+#endif
+
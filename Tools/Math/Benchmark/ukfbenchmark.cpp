@@ -0,0 +1,253 @@
+/*! @file ukfbenchmark.cpp
+    @brief The ukfbenchmark executable. Times the orientation filter's updates on a synthetic sway.
+
+    Usage: ukfbenchmark [number of ticks] [period in ms]
+
+    The synthetic robot sways in pitch and roll with slowly drifting, noisy gyros and noisy accelerometers.
+    Every tick is run through OrientationUKF (built on the fixed size UnscentedFilter) and through the
+    same filter written with the dynamically sized UKF, and the cost of each time and measurement update
+    is printed in microseconds along with the heap allocations per tick and the estimation error.
+    Use a build with NUBOT_BUILD_UKF_BENCHMARK ON.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Kinematics/OrientationUKF.h"
+#include "Tools/Math/UKF.h"
+#include "Tools/Math/General.h"
+
+#include "debug.h"
+
+#include <time.h>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+using namespace std;
+
+ofstream debug;
+ofstream errorlog;
+
+static size_t AllocationCount = 0;
+
+// Every heap allocation in the executable is counted, so that the benchmark can report allocations per tick
+void* operator new(size_t size)
+{
+    AllocationCount++;
+    void* p = malloc(size == 0 ? 1 : size);
+    if (p == NULL)
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* p) throw()
+{
+    free(p);
+}
+
+void operator delete[](void* p) throw()
+{
+    free(p);
+}
+
+/*! @brief The orientation filter as it was written with the dynamically sized UKF; the reference for the benchmark */
+class DynamicOrientationUKF : public UKF
+{
+public:
+    DynamicOrientationUKF() : UKF(OrientationUKF::numStates) {};
+    void initialise(double time, const vector<float>& gyroReadings, const vector<float>& accelerations)
+    {
+        m_timeOfLastUpdate = time;
+        m_mean[OrientationUKF::pitchGyroOffset][0] = gyroReadings[1];
+        m_mean[OrientationUKF::rollGyroOffset][0] = gyroReadings[0];
+        m_covariance[OrientationUKF::pitchGyroOffset][OrientationUKF::pitchGyroOffset] = 0.1*0.1;
+        m_covariance[OrientationUKF::rollGyroOffset][OrientationUKF::rollGyroOffset] = 0.1*0.1;
+        m_mean[OrientationUKF::pitchAngle][0] = -atan2(-accelerations[0],-accelerations[2]);
+        m_mean[OrientationUKF::rollAngle][0] = atan2(accelerations[1],-accelerations[2]);
+        m_covariance[OrientationUKF::pitchAngle][OrientationUKF::pitchAngle] = 0.5*0.5;
+        m_covariance[OrientationUKF::rollAngle][OrientationUKF::rollAngle] = 0.5*0.5;
+        m_processNoise = Matrix(OrientationUKF::numStates, OrientationUKF::numStates, false);
+        m_processNoise[OrientationUKF::pitchAngle][OrientationUKF::pitchAngle] = 1e-3;
+        m_processNoise[OrientationUKF::pitchGyroOffset][OrientationUKF::pitchGyroOffset] = 1e-5;
+        m_processNoise[OrientationUKF::rollAngle][OrientationUKF::rollAngle] = 1e-3;
+        m_processNoise[OrientationUKF::rollGyroOffset][OrientationUKF::rollGyroOffset] = 1e-5;
+    }
+    void TimeUpdate(const vector<float>& gyroReadings, double timestamp)
+    {
+        const double dt = (timestamp - m_timeOfLastUpdate)/1000.0;
+        m_timeOfLastUpdate = timestamp;
+        Matrix A(OrientationUKF::numStates, OrientationUKF::numStates, true);
+        A[0][1] = -dt;
+        A[2][3] = -dt;
+        Matrix B(OrientationUKF::numStates, 2, false);
+        B[0][0] = dt;
+        B[2][1] = dt;
+        Matrix sensorData(2, 1, false);
+        sensorData[0][0] = gyroReadings[1];
+        sensorData[1][0] = gyroReadings[0];
+        Matrix sigmaPoints = GenerateSigmaPoints();
+        Matrix updateSigmaPoints(sigmaPoints.getm(), sigmaPoints.getn(), false);
+        for (int i = 0; i < sigmaPoints.getn(); i++)
+            updateSigmaPoints.setCol(i, A*sigmaPoints.getCol(i) + B*sensorData);
+        timeUpdate(updateSigmaPoints, m_processNoise);
+        m_mean[OrientationUKF::pitchAngle][0] = mathGeneral::normaliseAngle(m_mean[OrientationUKF::pitchAngle][0]);
+        m_mean[OrientationUKF::rollAngle][0] = mathGeneral::normaliseAngle(m_mean[OrientationUKF::rollAngle][0]);
+    }
+    void MeasurementUpdate(const vector<float>& accelerations)
+    {
+        const double gravityAccel = 981.0;
+        Matrix sigmaPoints = GenerateSigmaPoints();
+        Matrix predictedObservationSigmas(3, sigmaPoints.getn(), false);
+        Matrix observation(3, 1, false);
+        for (int i = 0; i < 3; i++)
+            observation[i][0] = accelerations[i];
+        double accelVectorMag = sqrt(accelerations[0]*accelerations[0] + accelerations[1]*accelerations[1] + accelerations[2]*accelerations[2]);
+        double accelNoise = pow(25.0 + fabs(accelVectorMag - gravityAccel), 2);
+        Matrix S_Obs(3, 3, false);
+        for (int i = 0; i < 3; i++)
+            S_Obs[i][i] = accelNoise;
+        for (int i = 0; i < sigmaPoints.getn(); i++)
+        {
+            double pitch = mathGeneral::normaliseAngle(sigmaPoints[OrientationUKF::pitchAngle][i]);
+            double roll = mathGeneral::normaliseAngle(sigmaPoints[OrientationUKF::rollAngle][i]);
+            predictedObservationSigmas[0][i] = gravityAccel*sin(pitch);
+            predictedObservationSigmas[1][i] = -gravityAccel*sin(roll);
+            predictedObservationSigmas[2][i] = -gravityAccel*cos(pitch)*cos(roll);
+        }
+        measurementUpdate(observation, S_Obs, predictedObservationSigmas, sigmaPoints);
+        m_mean[OrientationUKF::pitchAngle][0] = mathGeneral::normaliseAngle(m_mean[OrientationUKF::pitchAngle][0]);
+        m_mean[OrientationUKF::rollAngle][0] = mathGeneral::normaliseAngle(m_mean[OrientationUKF::rollAngle][0]);
+    }
+private:
+    double m_timeOfLastUpdate;
+    Matrix m_processNoise;
+};
+
+/*! @brief The cost of one filter's updates over the whole run */
+struct UpdateTimes
+{
+    UpdateTimes() : TotalTime(0), WorstTime(0), TotalMeasurement(0), WorstMeasurement(0), Allocations(0), SquaredError(0) {};
+    double TotalTime;
+    double WorstTime;
+    double TotalMeasurement;
+    double WorstMeasurement;
+    size_t Allocations;
+    double SquaredError;
+};
+
+/*! @brief Returns the current monotonic time in microseconds */
+static double now()
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return 1e6*t.tv_sec + 1e-3*t.tv_nsec;
+}
+
+/*! @brief Returns a sample from a zero mean normal distribution */
+static double noise(double sd)
+{
+    double u1 = (rand() + 1.0)/(RAND_MAX + 2.0);
+    double u2 = (rand() + 1.0)/(RAND_MAX + 2.0);
+    return sd*sqrt(-2*log(u1))*cos(2*mathGeneral::PI*u2);
+}
+
+static void print(const string& name, const UpdateTimes& times, int ticks)
+{
+    cout << name << endl;
+    cout << "    time update (us):        mean " << times.TotalTime/ticks << " worst " << times.WorstTime << endl;
+    cout << "    measurement update (us): mean " << times.TotalMeasurement/ticks << " worst " << times.WorstMeasurement << endl;
+    cout << "    allocations per tick:    " << static_cast<double>(times.Allocations)/ticks << endl;
+    cout << "    rms angle error (rad):   " << sqrt(times.SquaredError/(2*ticks)) << endl;
+}
+
+int main(int argc, const char *argv[])
+{
+    debug.open("ukfbenchmarkdebug.log");
+    errorlog.open("ukfbenchmarkerror.log");
+
+    int ticks = argc > 1 ? atoi(argv[1]) : 100000;
+    double period = argc > 2 ? atof(argv[2]) : 10;
+    if (ticks <= 0 or period <= 0)
+    {
+        cerr << "ukfbenchmark: the number of ticks and the period must be positive" << endl;
+        return 1;
+    }
+
+    vector<float> gyros(3, 0.0f);
+    vector<float> accelerations(3, 0.0f);
+    vector<float> kinematics(3, 0.0f);
+    accelerations[2] = -981;
+
+    OrientationUKF fixedfilter;
+    DynamicOrientationUKF dynamicfilter;
+    fixedfilter.initialise(0, gyros, accelerations);
+    dynamicfilter.initialise(0, gyros, accelerations);
+
+    UpdateTimes fixedtimes, dynamictimes;
+    srand(1);
+    for (int i = 1; i <= ticks; i++)
+    {
+        double time = i*period;
+        double t = time/1000.0;
+        double pitch = 0.1*sin(2*mathGeneral::PI*0.5*t);
+        double roll = 0.05*sin(2*mathGeneral::PI*1.0*t);
+        double pitchoffset = 0.02 + 0.01*sin(2*mathGeneral::PI*0.01*t);
+        double rolloffset = -0.01;
+        gyros[0] = 0.05*2*mathGeneral::PI*1.0*cos(2*mathGeneral::PI*1.0*t) + rolloffset + noise(0.01);
+        gyros[1] = 0.1*2*mathGeneral::PI*0.5*cos(2*mathGeneral::PI*0.5*t) + pitchoffset + noise(0.01);
+        accelerations[0] = 981*sin(pitch) + noise(20);
+        accelerations[1] = -981*sin(roll) + noise(20);
+        accelerations[2] = -981*cos(pitch)*cos(roll) + noise(20);
+
+        size_t allocations = AllocationCount;
+        double start = now();
+        fixedfilter.TimeUpdate(gyros, time);
+        double middle = now();
+        fixedfilter.MeasurementUpdate(accelerations, false, kinematics);
+        double stop = now();
+        fixedtimes.Allocations += AllocationCount - allocations;
+        fixedtimes.TotalTime += middle - start;
+        fixedtimes.WorstTime = max(fixedtimes.WorstTime, middle - start);
+        fixedtimes.TotalMeasurement += stop - middle;
+        fixedtimes.WorstMeasurement = max(fixedtimes.WorstMeasurement, stop - middle);
+        fixedtimes.SquaredError += pow(fixedfilter.getMean(OrientationUKF::pitchAngle) - pitch, 2) + pow(fixedfilter.getMean(OrientationUKF::rollAngle) - roll, 2);
+
+        allocations = AllocationCount;
+        start = now();
+        dynamicfilter.TimeUpdate(gyros, time);
+        middle = now();
+        dynamicfilter.MeasurementUpdate(accelerations);
+        stop = now();
+        dynamictimes.Allocations += AllocationCount - allocations;
+        dynamictimes.TotalTime += middle - start;
+        dynamictimes.WorstTime = max(dynamictimes.WorstTime, middle - start);
+        dynamictimes.TotalMeasurement += stop - middle;
+        dynamictimes.WorstMeasurement = max(dynamictimes.WorstMeasurement, stop - middle);
+        dynamictimes.SquaredError += pow(dynamicfilter.getMean(OrientationUKF::pitchAngle) - pitch, 2) + pow(dynamicfilter.getMean(OrientationUKF::rollAngle) - roll, 2);
+    }
+
+    cout << setprecision(3) << fixed;
+    cout << "OrientationUKF, " << ticks << " ticks at " << period << " ms" << endl;
+    print("UnscentedFilter<4>", fixedtimes, ticks);
+    print("UKF", dynamictimes, ticks);
+    return 0;
+}
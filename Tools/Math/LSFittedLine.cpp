@@ -33,7 +33,7 @@ void LSFittedLine::clearPoints(){
 	points.clear();
 }
 
-std::vector<LinePoint*> LSFittedLine::getPoints()
+const std::vector<LinePoint*>& LSFittedLine::getPoints() const
 {
 	return points;
 }
@@ -75,40 +75,51 @@ void LSFittedLine::addPoint(LinePoint &point){
 	}
 }
 
-void LSFittedLine::addPoints(vector<LinePoint*>& pointlist){
+void LSFittedLine::addPoints(const vector<LinePoint*>& pointlist){
     if(!pointlist.empty()) {
         if(numPoints < 1) {
             leftPoint = *pointlist[0];
             rightPoint = *pointlist[0];
         }
+        points.reserve(points.size() + pointlist.size());
+        // accumulate into locals so the sums stay in registers
+        double sx = 0, sy = 0, sx2 = 0, sy2 = 0, sxy = 0;
         for(unsigned int i=0; i<pointlist.size(); i++) {
-            sumX += pointlist[i]->x;
-            sumY += pointlist[i]->y;
-            sumX2 += pointlist[i]->x * pointlist[i]->x;
-            sumY2 += pointlist[i]->y * pointlist[i]->y;
-            sumXY += pointlist[i]->x * pointlist[i]->y;
-            numPoints++;
-            points.push_back(pointlist[i]);
-            pointlist[i]->inUse = true;
+            LinePoint* point = pointlist[i];
+            const double x = point->x;
+            const double y = point->y;
+            sx += x;
+            sy += y;
+            sx2 += x * x;
+            sy2 += y * y;
+            sxy += x * y;
+            points.push_back(point);
+            point->inUse = true;
 
             //CHECK if point is a start or end point
-            if(pointlist[i]->x == leftPoint.x){
-                if(pointlist[i]->y < leftPoint.y){
-                    leftPoint = *pointlist[i];
+            if(x == leftPoint.x){
+                if(y < leftPoint.y){
+                    leftPoint = *point;
                 }
             }
-            else if (pointlist[i]->x < leftPoint.x) {
-                leftPoint = *pointlist[i];
+            else if (x < leftPoint.x) {
+                leftPoint = *point;
             }
-            if(pointlist[i]->x == rightPoint.x) {
-                if(pointlist[i]->y > rightPoint.y) {
-                    rightPoint = *pointlist[i];
+            if(x == rightPoint.x) {
+                if(y > rightPoint.y) {
+                    rightPoint = *point;
                 }
             }
-            else if (pointlist[i]->x > rightPoint.x) {
-                rightPoint = *pointlist[i];
+            else if (x > rightPoint.x) {
+                rightPoint = *point;
             }
         }
+        sumX += sx;
+        sumY += sy;
+        sumX2 += sx2;
+        sumY2 += sy2;
+        sumXY += sxy;
+        numPoints += pointlist.size();
         if (numPoints < 2)
         {
                 valid = false;
@@ -121,6 +132,23 @@ void LSFittedLine::addPoints(vector<LinePoint*>& pointlist){
     }
 }
 
+/*! @brief Fits the line directly to the sums of a set of points, without a list of the points.
+           This allows the line of any set with known sums to be found in O(1).
+ */
+void LSFittedLine::setMoments(int n, double sumx, double sumy, double sumx2, double sumy2, double sumxy)
+{
+    clearPoints();
+    sumX = sumx;
+    sumY = sumy;
+    sumX2 = sumx2;
+    sumY2 = sumy2;
+    sumXY = sumxy;
+    numPoints = n;
+    valid = numPoints >= 2;
+    if (valid)
+        calcLine();
+}
+
 void LSFittedLine::joinLine(LSFittedLine &sourceLine)
 {
 	sumX += sourceLine.sumX;
@@ -129,6 +157,7 @@ void LSFittedLine::joinLine(LSFittedLine &sourceLine)
 	sumY2 += sourceLine.sumY2;
 	sumXY += sourceLine.sumXY;
 	numPoints += sourceLine.numPoints;
+	points.reserve(points.size() + sourceLine.points.size());
 	for(unsigned int p = 0; p < sourceLine.points.size(); p++)
 	{
 		points.push_back(sourceLine.points[p]);
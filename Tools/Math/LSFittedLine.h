@@ -22,7 +22,8 @@ class LSFittedLine : public Line
     bool valid;
     
     void addPoint(LinePoint &point);
-    void addPoints(vector<LinePoint*>& pointlist);
+    void addPoints(const vector<LinePoint*>& pointlist);
+    void setMoments(int n, double sumx, double sumy, double sumx2, double sumy2, double sumxy);
     void joinLine(LSFittedLine &sourceLine);
     Vector2<double> combinedR2TLSandMSD(const LSFittedLine &sourceLine) const;
     double getMSD() const;
@@ -30,7 +31,7 @@ class LSFittedLine : public Line
     Point leftPoint, rightPoint;
     Point transLeftPoint, transRightPoint;
     void clearPoints();
-    std::vector<LinePoint*> getPoints();
+    const std::vector<LinePoint*>& getPoints() const;
     int numPoints;
 private:
     void calcLine();
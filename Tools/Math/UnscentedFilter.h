@@ -0,0 +1,408 @@
+/*! @file UnscentedFilter.h
+    @brief Declaration and implementation of the UnscentedFilter class template
+
+    @class UnscentedFilter
+    @brief A square root unscented Kalman filter whose number of states is fixed at compile time
+
+    UKF and SRUKF size everything at run time, so every update allocates a handful of Matrix objects.
+    Here the mean, the square root of the covariance and the sigma points are plain arrays sized by
+    the template parameter, so an update does not touch the heap at all.
+
+    The covariance is only ever held as its lower triangular square root S (P = S*S'). After a time
+    update S is rebuilt from the square root of the process noise with a Cholesky rank one update for
+    each propagated sigma point; this gives the same factor as the QR decomposition in the usual
+    square root formulation, but needs no workspace. The measurement update downdates S by each
+    column of K*Sy.
+
+    The process and measurement models are supplied by the user as small classes:
+    @code
+    class MyProcessModel
+    {
+    public:
+        void propagate(const double state[N], double result[N]) const;
+    };
+    class MyMeasurementModel
+    {
+    public:
+        enum {NumMeasurements = M};
+        void predict(const double state[N], double measurement[M]) const;
+    };
+    @endcode
+    Any inputs (time step, control, sensor readings) should be members of the model. The noises are
+    given as the lower triangular square roots of their covariances; for independent noise this is just
+    the standard deviations on the diagonal.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef UNSCENTEDFILTER_H
+#define UNSCENTEDFILTER_H
+
+#include <cmath>
+
+template <int N>
+class UnscentedFilter
+{
+public:
+    enum {NumStates = N, NumSigmaPoints = 2*N + 1};
+
+    UnscentedFilter(double kappa = 1.0);
+
+    void setKappa(double kappa);
+    bool setState(const double mean[N], const double covariance[N][N]);
+    bool setCovariance(const double covariance[N][N]);
+    void setSqrtCovariance(const double sqrtcovariance[N][N]);
+    void setMean(int stateId, double value) {m_mean[stateId] = value;};
+
+    double getMean(int stateId) const {return m_mean[stateId];};
+    double getCovariance(int i, int j) const;
+    double getSqrtCovariance(int i, int j) const {return m_sqrt_covariance[i][j];};
+    double calculateSd(int stateId) const;
+
+    template <class ProcessModel> bool timeUpdate(const ProcessModel& model, const double sqrtprocessnoise[N][N]);
+    template <class MeasurementModel> bool measurementUpdate(const MeasurementModel& model, const double measurement[], const double sqrtmeasurementnoise[][MeasurementModel::NumMeasurements]);
+
+    template <int M> static bool cholesky(const double P[M][M], double L[M][M]);
+    template <int M> static bool choleskyUpdate(double L[M][M], double x[M], double sign);
+
+private:
+    void generateSigmaPoints();
+
+private:
+    double m_mean[N];                                   //!< the state estimate
+    double m_sqrt_covariance[N][N];                     //!< the lower triangular square root of the state covariance
+    double m_sigma_points[NumSigmaPoints][N];           //!< workspace for the sigma points; each row is a point
+    double m_kappa;                                     //!< the sigma point spread parameter
+    double m_mean_weight;                               //!< the weight of the central sigma point
+    double m_outer_weight;                              //!< the weight of each of the other sigma points
+    double m_spread;                                    //!< sqrt(N + kappa); the sigma points are this many deviations from the mean
+};
+
+/*! @brief Constructs a filter with zero mean and unit covariance
+    @param kappa the sigma point spread parameter. The default of 1 matches UKF and SRUKF
+ */
+template <int N>
+UnscentedFilter<N>::UnscentedFilter(double kappa)
+{
+    for (int i=0; i<N; i++)
+    {
+        m_mean[i] = 0;
+        for (int j=0; j<N; j++)
+            m_sqrt_covariance[i][j] = (i == j) ? 1 : 0;
+    }
+    setKappa(kappa);
+}
+
+/*! @brief Sets the sigma point spread parameter, and recalculates the weights */
+template <int N>
+void UnscentedFilter<N>::setKappa(double kappa)
+{
+    m_kappa = kappa;
+    m_mean_weight = kappa/(N + kappa);
+    m_outer_weight = (1.0 - m_mean_weight)/(2*N);
+    m_spread = sqrt(N + kappa);
+}
+
+/*! @brief Sets the mean and covariance of the state estimate
+    @return false if the covariance is not positive definite, in which case nothing is changed
+ */
+template <int N>
+bool UnscentedFilter<N>::setState(const double mean[N], const double covariance[N][N])
+{
+    if (not setCovariance(covariance))
+        return false;
+    for (int i=0; i<N; i++)
+        m_mean[i] = mean[i];
+    return true;
+}
+
+/*! @brief Sets the covariance of the state estimate
+    @return false if the covariance is not positive definite, in which case nothing is changed
+ */
+template <int N>
+bool UnscentedFilter<N>::setCovariance(const double covariance[N][N])
+{
+    double L[N][N];
+    if (not cholesky<N>(covariance, L))
+        return false;
+    setSqrtCovariance(L);
+    return true;
+}
+
+/*! @brief Sets the lower triangular square root of the covariance directly */
+template <int N>
+void UnscentedFilter<N>::setSqrtCovariance(const double sqrtcovariance[N][N])
+{
+    for (int i=0; i<N; i++)
+        for (int j=0; j<N; j++)
+            m_sqrt_covariance[i][j] = j <= i ? sqrtcovariance[i][j] : 0;
+}
+
+/*! @brief Returns element (i,j) of the state covariance */
+template <int N>
+double UnscentedFilter<N>::getCovariance(int i, int j) const
+{
+    double sum = 0;
+    for (int k=0; k<N; k++)
+        sum += m_sqrt_covariance[i][k]*m_sqrt_covariance[j][k];
+    return sum;
+}
+
+/*! @brief Returns the standard deviation of a state */
+template <int N>
+double UnscentedFilter<N>::calculateSd(int stateId) const
+{
+    return sqrt(getCovariance(stateId, stateId));
+}
+
+/*! @brief Puts the 2N+1 sigma points for the current estimate in m_sigma_points */
+template <int N>
+void UnscentedFilter<N>::generateSigmaPoints()
+{
+    for (int j=0; j<N; j++)
+        m_sigma_points[0][j] = m_mean[j];
+    for (int i=0; i<N; i++)
+    {
+        for (int j=0; j<N; j++)
+        {
+            double deviation = m_spread*m_sqrt_covariance[j][i];
+            m_sigma_points[i+1][j] = m_mean[j] + deviation;
+            m_sigma_points[i+1+N][j] = m_mean[j] - deviation;
+        }
+    }
+}
+
+/*! @brief Propagates the estimate through the process model
+    @param model the process model; model.propagate(state, result) is called for each sigma point
+    @param sqrtprocessnoise the lower triangular square root of the (additive) process noise covariance
+    @return false if the new covariance could not be factored, in which case the previous covariance is kept
+ */
+template <int N>
+template <class ProcessModel>
+bool UnscentedFilter<N>::timeUpdate(const ProcessModel& model, const double sqrtprocessnoise[N][N])
+{
+    generateSigmaPoints();
+    double propagated[N];
+    for (int i=0; i<NumSigmaPoints; i++)
+    {
+        model.propagate(m_sigma_points[i], propagated);
+        for (int j=0; j<N; j++)
+            m_sigma_points[i][j] = propagated[j];
+    }
+
+    double mean[N];
+    for (int j=0; j<N; j++)
+    {
+        mean[j] = m_mean_weight*m_sigma_points[0][j];
+        for (int i=1; i<NumSigmaPoints; i++)
+            mean[j] += m_outer_weight*m_sigma_points[i][j];
+    }
+
+    // S = chol(Q + sum w_i (X_i - x)(X_i - x)'), one rank one update at a time
+    double S[N][N];
+    for (int i=0; i<N; i++)
+        for (int j=0; j<N; j++)
+            S[i][j] = j <= i ? sqrtprocessnoise[i][j] : 0;
+    double diff[N];
+    double outer = sqrt(m_outer_weight);
+    for (int i=1; i<NumSigmaPoints; i++)
+    {
+        for (int j=0; j<N; j++)
+            diff[j] = outer*(m_sigma_points[i][j] - mean[j]);
+        if (not choleskyUpdate<N>(S, diff, 1))
+            return false;
+    }
+    double central = sqrt(fabs(m_mean_weight));
+    for (int j=0; j<N; j++)
+        diff[j] = central*(m_sigma_points[0][j] - mean[j]);
+    if (not choleskyUpdate<N>(S, diff, m_mean_weight < 0 ? -1 : 1))
+        return false;
+
+    for (int j=0; j<N; j++)
+        m_mean[j] = mean[j];
+    setSqrtCovariance(S);
+    return true;
+}
+
+/*! @brief Updates the estimate with a measurement
+    @param model the measurement model; model.predict(state, measurement) is called for each sigma point
+    @param measurement the MeasurementModel::NumMeasurements measured values
+    @param sqrtmeasurementnoise the lower triangular square root of the measurement noise covariance
+    @return false if the update would make the covariance indefinite, in which case the measurement is ignored
+ */
+template <int N>
+template <class MeasurementModel>
+bool UnscentedFilter<N>::measurementUpdate(const MeasurementModel& model, const double measurement[], const double sqrtmeasurementnoise[][MeasurementModel::NumMeasurements])
+{
+    const int M = MeasurementModel::NumMeasurements;
+    generateSigmaPoints();
+
+    double predicted[NumSigmaPoints][M];
+    for (int i=0; i<NumSigmaPoints; i++)
+        model.predict(m_sigma_points[i], predicted[i]);
+
+    double predictedmean[M];
+    for (int j=0; j<M; j++)
+    {
+        predictedmean[j] = m_mean_weight*predicted[0][j];
+        for (int i=1; i<NumSigmaPoints; i++)
+            predictedmean[j] += m_outer_weight*predicted[i][j];
+    }
+
+    // Sy = chol(R + sum w_i (Y_i - y)(Y_i - y)')
+    double Sy[M][M];
+    for (int i=0; i<M; i++)
+        for (int j=0; j<M; j++)
+            Sy[i][j] = j <= i ? sqrtmeasurementnoise[i][j] : 0;
+    double diff[M];
+    double outer = sqrt(m_outer_weight);
+    for (int i=1; i<NumSigmaPoints; i++)
+    {
+        for (int j=0; j<M; j++)
+            diff[j] = outer*(predicted[i][j] - predictedmean[j]);
+        if (not choleskyUpdate<M>(Sy, diff, 1))
+            return false;
+    }
+    double central = sqrt(fabs(m_mean_weight));
+    for (int j=0; j<M; j++)
+        diff[j] = central*(predicted[0][j] - predictedmean[j]);
+    if (not choleskyUpdate<M>(Sy, diff, m_mean_weight < 0 ? -1 : 1))
+        return false;
+
+    // Pxy = sum w_i (X_i - x)(Y_i - y)'
+    double Pxy[N][M];
+    for (int r=0; r<N; r++)
+    {
+        for (int c=0; c<M; c++)
+        {
+            double sum = m_mean_weight*(m_sigma_points[0][r] - m_mean[r])*(predicted[0][c] - predictedmean[c]);
+            for (int i=1; i<NumSigmaPoints; i++)
+                sum += m_outer_weight*(m_sigma_points[i][r] - m_mean[r])*(predicted[i][c] - predictedmean[c]);
+            Pxy[r][c] = sum;
+        }
+    }
+
+    // K = Pxy*inv(Sy*Sy'); each row of K is found with a forward then a back substitution
+    double K[N][M];
+    for (int r=0; r<N; r++)
+    {
+        double a[M];
+        for (int i=0; i<M; i++)
+        {
+            double sum = Pxy[r][i];
+            for (int k=0; k<i; k++)
+                sum -= Sy[i][k]*a[k];
+            a[i] = sum/Sy[i][i];
+        }
+        for (int i=M-1; i>=0; i--)
+        {
+            double sum = a[i];
+            for (int k=i+1; k<M; k++)
+                sum -= Sy[k][i]*K[r][k];
+            K[r][i] = sum/Sy[i][i];
+        }
+    }
+
+    // S is downdated by each column of U = K*Sy, but only committed if every downdate succeeds
+    double S[N][N];
+    for (int i=0; i<N; i++)
+        for (int j=0; j<N; j++)
+            S[i][j] = m_sqrt_covariance[i][j];
+    double u[N];
+    for (int c=0; c<M; c++)
+    {
+        for (int r=0; r<N; r++)
+        {
+            double sum = 0;
+            for (int k=c; k<M; k++)
+                sum += K[r][k]*Sy[k][c];
+            u[r] = sum;
+        }
+        if (not choleskyUpdate<N>(S, u, -1))
+            return false;
+    }
+
+    for (int r=0; r<N; r++)
+    {
+        double correction = 0;
+        for (int c=0; c<M; c++)
+            correction += K[r][c]*(measurement[c] - predictedmean[c]);
+        m_mean[r] += correction;
+    }
+    setSqrtCovariance(S);
+    return true;
+}
+
+/*! @brief Calculates the lower triangular Cholesky factor L of P, so that P = L*L'
+    @return false if P is not positive definite
+ */
+template <int N>
+template <int M>
+bool UnscentedFilter<N>::cholesky(const double P[M][M], double L[M][M])
+{
+    for (int i=0; i<M; i++)
+    {
+        for (int j=0; j<M; j++)
+            L[i][j] = 0;
+        for (int j=0; j<=i; j++)
+        {
+            double sum = P[i][j];
+            for (int k=0; k<j; k++)
+                sum -= L[i][k]*L[j][k];
+            if (i == j)
+            {
+                if (sum <= 0)
+                    return false;
+                L[i][i] = sqrt(sum);
+            }
+            else
+                L[i][j] = sum/L[j][j];
+        }
+    }
+    return true;
+}
+
+/*! @brief Replaces the lower triangular factor L of P with that of P + sign*x*x'
+    @param L the factor to update in place. Its diagonal must be positive
+    @param x the update vector; it is used as workspace and is overwritten
+    @param sign +1 for an update, -1 for a downdate
+    @return false if the downdated matrix would not be positive definite, in which case L is left partially modified
+ */
+template <int N>
+template <int M>
+bool UnscentedFilter<N>::choleskyUpdate(double L[M][M], double x[M], double sign)
+{
+    for (int k=0; k<M; k++)
+    {
+        double r2 = L[k][k]*L[k][k] + sign*x[k]*x[k];
+        if (r2 <= 0 or L[k][k] <= 0)
+            return false;
+        double r = sqrt(r2);
+        double c = r/L[k][k];
+        double s = x[k]/L[k][k];
+        L[k][k] = r;
+        for (int i=k+1; i<M; i++)
+        {
+            L[i][k] = (L[i][k] + sign*s*x[i])/c;
+            x[i] = c*x[i] - s*L[i][k];
+        }
+    }
+    return true;
+}
+
+#endif
@@ -31,20 +31,32 @@
     #define __NU_PERIODIC_CLOCK_NANOSLEEP 
 #endif
 #include <errno.h>
+#include <cmath>
+#include <algorithm>
 
 using namespace std;
 
+vector<PeriodicThread*> PeriodicThread::m_threads;
+pthread_mutex_t PeriodicThread::m_threads_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 /*! @brief Creates a thread
     @param name the name of the thread (used entirely for debug purposes)
     @param period the time in ms between each main loop execution
     @param priority the priority of the thread. If non-zero the thread will be a bona fide real-time thread.
+    @param policy what to do when the main loop runs past the next deadline
  */
-PeriodicThread::PeriodicThread(string name, int period, unsigned char priority) : Thread(name, priority), m_period(period)
+PeriodicThread::PeriodicThread(string name, int period, unsigned char priority, OverrunPolicy policy) : Thread(name, priority), m_period(period), m_overrun_policy(policy)
 {
     #if DEBUG_THREADING_VERBOSITY > 1
-        debug << "PeriodicThread::PeriodicThread(" << m_name << ", " << m_period << ", " << static_cast<int>(m_priority) << ")" << endl;
+        debug << "PeriodicThread::PeriodicThread(" << m_name << ", " << m_period << ", " << static_cast<int>(m_priority) << ", " << m_overrun_policy << ")" << endl;
     #endif
-    m_start_time = 0;
+    m_deadline = 0;
+    m_counted_until = 0;
+    pthread_mutex_init(&m_statistics_mutex, NULL);
+
+    pthread_mutex_lock(&m_threads_mutex);
+    m_threads.push_back(this);
+    pthread_mutex_unlock(&m_threads_mutex);
 }
 
 /*! @brief Stops the thread
@@ -54,30 +66,130 @@ PeriodicThread::~PeriodicThread()
     #if DEBUG_THREADING_VERBOSITY > 1
         debug << "PeriodicThread::~PeriodicThread() " << m_name << endl;
     #endif
+    pthread_mutex_lock(&m_threads_mutex);
+    m_threads.erase(find(m_threads.begin(), m_threads.end(), this));
+    pthread_mutex_unlock(&m_threads_mutex);
     stop();
+    #if DEBUG_THREADING_VERBOSITY > 0
+        debug << "PeriodicThread::~PeriodicThread() " << m_name << " " << m_statistics;
+    #endif
+    pthread_mutex_destroy(&m_statistics_mutex);
+}
+
+/*! @brief Sets what the thread does when the main loop runs past the next deadline */
+void PeriodicThread::setOverrunPolicy(OverrunPolicy policy)
+{
+    m_overrun_policy = policy;
+}
+
+/*! @brief Returns a copy of the thread's timing statistics. This is safe to call from any thread. */
+PeriodicThreadStatistics PeriodicThread::getStatistics()
+{
+    pthread_mutex_lock(&m_statistics_mutex);
+    PeriodicThreadStatistics statistics = m_statistics;
+    pthread_mutex_unlock(&m_statistics_mutex);
+    return statistics;
 }
 
-/*! @brief Sleeps for the required amount of time
+/*! @brief Clears the thread's timing statistics */
+void PeriodicThread::resetStatistics()
+{
+    pthread_mutex_lock(&m_statistics_mutex);
+    m_statistics.reset();
+    pthread_mutex_unlock(&m_statistics_mutex);
+}
+
+/*! @brief Writes the name, period and timing statistics of every periodic thread. This is safe to call from any thread.
+    @param output the stream to write the statistics to
+ */
+void PeriodicThread::writeAllStatistics(ostream& output)
+{
+    pthread_mutex_lock(&m_threads_mutex);
+    for (size_t i=0; i<m_threads.size(); i++)
+        output << m_threads[i]->m_name << " (" << m_threads[i]->m_period << "ms) " << m_threads[i]->getStatistics();
+    pthread_mutex_unlock(&m_threads_mutex);
+}
+
+/*! @brief Returns the current time in ms on the clock the deadlines are kept on
+ 
+    This is CLOCK_MONOTONIC where it is available, so that the deadlines are not moved by changes to the
+    system time. Note that this is always real time, even on platforms where Platform->getTime() is simulated.
  */
-void PeriodicThread::sleepThread()
+double PeriodicThread::getMonotonicTime()
+{
+    #ifdef __NU_PERIODIC_CLOCK_NANOSLEEP
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return 1e3*now.tv_sec + 1e-6*now.tv_nsec;
+    #else
+        return Platform->getRealTime();
+    #endif
+}
+
+/*! @brief Sleeps until the deadline, returning immediately if it has already passed
+    @param deadline the absolute time in ms (see getMonotonicTime()) to sleep until
+ */
+void PeriodicThread::sleepUntil(double deadline)
 {
-    double timenow = Platform->getTime();
-    double requiredsleeptime = m_period - (timenow - m_start_time);
     pthread_testcancel();
-    if (requiredsleeptime > 0)
-        Platform->msleep(requiredsleeptime);
+    #ifdef __NU_PERIODIC_CLOCK_NANOSLEEP
+        struct timespec waketime;
+        waketime.tv_sec = static_cast<time_t>(deadline/1e3);
+        waketime.tv_nsec = static_cast<long>(1e6*(deadline - 1e3*waketime.tv_sec));
+        if (waketime.tv_nsec >= 1000000000)
+        {
+            waketime.tv_sec++;
+            waketime.tv_nsec -= 1000000000;
+        }
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &waketime, NULL) == EINTR);       // the deadline is absolute, so we can simply sleep again if interrupted
+    #else
+        double requiredsleeptime = deadline - getMonotonicTime();
+        if (requiredsleeptime > 0)
+            Platform->msleep(requiredsleeptime);
+    #endif
     pthread_testcancel();
-    m_start_time = Platform->getTime();
+}
+
+/*! @brief Moves m_deadline to the next release. If the main loop has run past the next deadline the overrun policy is applied.
+    @param now the time the main loop finished executing
+    @return the number of deadlines that were missed
+ */
+unsigned int PeriodicThread::nextDeadline(double now)
+{
+    m_deadline += m_period;
+    if (now <= m_deadline)
+        return 0;
+
+    double firstmissed = m_deadline;            // while catching up the earlier deadlines have already been counted
+    if (firstmissed <= m_counted_until)
+        firstmissed += (floor((m_counted_until - firstmissed)/m_period) + 1)*m_period;
+    unsigned int missed = 0;
+    if (now > firstmissed)
+        missed = static_cast<unsigned int>((now - firstmissed)/m_period) + 1;
+    m_counted_until = now;
+
+    if (m_overrun_policy == Skip)
+        m_deadline += (floor((now - m_deadline)/m_period) + 1)*m_period;
+    else if (m_overrun_policy == Degrade)
+        m_deadline = now + m_period;
+    // for CatchUp m_deadline is left in the past, so the thread is released immediately until it is back on schedule
+    
+    #if DEBUG_THREADING_VERBOSITY > 2
+        debug << "PeriodicThread::nextDeadline() " << m_name << " missed " << missed << " deadlines" << endl;
+    #endif
+    return missed;
 }
 
 /*! @brief Periodically runs
  */
 void PeriodicThread::run()
 {
-    int err = 0;
-    while (err == 0 && errno != EINTR)
+    m_deadline = getMonotonicTime();
+    m_counted_until = m_deadline;
+    while (true)
     {
-        sleepThread();
+        sleepUntil(m_deadline);
+        double releasetime = getMonotonicTime();
         try
         {
             periodicFunction();
@@ -86,5 +198,12 @@ void PeriodicThread::run()
         {
             debug << "PeriodicThread::run(): " << m_name << " Unhandled exception: " << e.what() << endl;
         }
+        double finishtime = getMonotonicTime();
+        double latency = releasetime - m_deadline;
+        unsigned int missed = nextDeadline(finishtime);
+        
+        pthread_mutex_lock(&m_statistics_mutex);
+        m_statistics.add(latency, finishtime - releasetime, missed);
+        pthread_mutex_unlock(&m_statistics_mutex);
     }
 }
@@ -5,6 +5,19 @@
     @brief This encapsulates a pthread, provides several additional features.
  
     This particular thread will execute its main loop when at a specified rate.
+
+    The thread is released on absolute deadlines, each exactly one period after the last, so the
+    rate does not drift with the execution time or the wake up latency. Where it is available the
+    deadlines are on CLOCK_MONOTONIC, and the thread sleeps with clock_nanosleep(TIMER_ABSTIME).
+    When periodicFunction() runs past the next deadline the thread's OverrunPolicy decides what to do:
+        - Skip: the missed releases are dropped, and the thread waits for the next deadline in phase
+        - CatchUp: the thread is released immediately, once for each missed release, until it has caught up
+        - Degrade: the schedule is restarted a period after the overrun finished; the rate is lowered while overrunning
+
+    The wake up latency, execution time and missed deadlines of each cycle are recorded in a
+    PeriodicThreadStatistics, which can be queried at any time with getStatistics(). The statistics
+    of every periodic thread are written by writeAllStatistics(), which TcpPort sends to NUview with
+    each image.
  
     @author Jason Kulk
  
@@ -28,27 +41,54 @@
 #define PERIODIC_THREAD_H_DEFINED
 
 #include "Thread.h"
+#include "PeriodicThreadStatistics.h"
 
 #include <string>
+#include <vector>
+#include <iostream>
 #include <pthread.h>
 
+#define PERIODIC_THREAD_STATISTICS_MAGIC 0x54415453     //!< marks the statistics appended to the sensors in a vision packet; they are followed by their size and then this
+
 class PeriodicThread : public Thread
 {
 	public:
-		PeriodicThread(std::string name, int period, unsigned char priority);
+        enum OverrunPolicy
+        {
+            Skip,
+            CatchUp,
+            Degrade
+        };
+    
+		PeriodicThread(std::string name, int period, unsigned char priority, OverrunPolicy policy = Skip);
         virtual ~PeriodicThread();
     
         virtual void periodicFunction() = 0;   //!< the function which is called periodically
     
+        void setOverrunPolicy(OverrunPolicy policy);
+        PeriodicThreadStatistics getStatistics();
+        void resetStatistics();
+        static void writeAllStatistics(std::ostream& output);
+    
     protected:
         void run();
     
     private:
-        void sleepThread();                    //!< sleeps the thread for the required amount of time
+        double getMonotonicTime();             //!< returns the current time in ms on the clock the deadlines are on
+        void sleepUntil(double deadline);      //!< sleeps the thread until the deadline
+        unsigned int nextDeadline(double now); //!< moves m_deadline to the next release according to the overrun policy
 
     protected:
         int m_period;                          //!< the period in ms
-        double m_start_time;                   //!< the time the execution of the loop started (we need this to sleep properly)
+        OverrunPolicy m_overrun_policy;        //!< what to do when periodicFunction() runs past the next deadline
+    private:
+        double m_deadline;                     //!< the absolute time in ms of the next release
+        double m_counted_until;                //!< the time up to which missed deadlines have been counted
+        PeriodicThreadStatistics m_statistics; //!< the timing statistics of this thread
+        pthread_mutex_t m_statistics_mutex;    //!< lock for m_statistics, so that it can be read from other threads
+
+        static std::vector<PeriodicThread*> m_threads;     //!< every periodic thread that exists, for writeAllStatistics()
+        static pthread_mutex_t m_threads_mutex;            //!< lock for m_threads
 };
 
 #endif
@@ -0,0 +1,136 @@
+/*! @file PeriodicThreadStatistics.cpp
+    @brief Implementation of PeriodicThreadStatistics class.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PeriodicThreadStatistics.h"
+
+using namespace std;
+
+/*! The lower edge of each latency bin in ms; the last bin holds everything above its edge */
+static const double LatencyBinEdges[PERIODIC_THREAD_LATENCY_BINS] = {0, 0.1, 0.2, 0.5, 1, 2, 5, 10};
+
+PeriodicThreadStatistics::PeriodicThreadStatistics()
+{
+    reset();
+}
+
+/*! @brief Clears all of the statistics */
+void PeriodicThreadStatistics::reset()
+{
+    m_num_cycles = 0;
+    m_num_missed = 0;
+    m_worst_latency = 0;
+    m_total_latency = 0;
+    m_worst_execution_time = 0;
+    m_total_execution_time = 0;
+    for (int i=0; i<PERIODIC_THREAD_LATENCY_BINS; i++)
+        m_latency_histogram[i] = 0;
+}
+
+/*! @brief Adds a single cycle to the statistics
+    @param latency the time in ms between the deadline and the thread actually being released
+    @param executiontime the time in ms periodicFunction() took
+    @param missed the number of deadlines that passed while periodicFunction() was executing
+ */
+void PeriodicThreadStatistics::add(double latency, double executiontime, unsigned int missed)
+{
+    m_num_cycles++;
+    m_num_missed += missed;
+
+    if (latency < 0)
+        latency = 0;
+    m_total_latency += latency;
+    if (latency > m_worst_latency)
+        m_worst_latency = latency;
+    int bin = PERIODIC_THREAD_LATENCY_BINS - 1;
+    while (bin > 0 and latency < LatencyBinEdges[bin])
+        bin--;
+    m_latency_histogram[bin]++;
+
+    m_total_execution_time += executiontime;
+    if (executiontime > m_worst_execution_time)
+        m_worst_execution_time = executiontime;
+}
+
+/*! @brief Returns the number of times periodicFunction() has been run */
+unsigned long PeriodicThreadStatistics::getNumCycles() const
+{
+    return m_num_cycles;
+}
+
+/*! @brief Returns the number of deadlines that have been missed */
+unsigned long PeriodicThreadStatistics::getNumMissed() const
+{
+    return m_num_missed;
+}
+
+/*! @brief Returns the largest wake up latency in ms */
+double PeriodicThreadStatistics::getWorstLatency() const
+{
+    return m_worst_latency;
+}
+
+/*! @brief Returns the average wake up latency in ms */
+double PeriodicThreadStatistics::getMeanLatency() const
+{
+    return m_num_cycles > 0 ? m_total_latency/m_num_cycles : 0;
+}
+
+/*! @brief Returns the longest execution time of periodicFunction() in ms */
+double PeriodicThreadStatistics::getWorstExecutionTime() const
+{
+    return m_worst_execution_time;
+}
+
+/*! @brief Returns the average execution time of periodicFunction() in ms */
+double PeriodicThreadStatistics::getMeanExecutionTime() const
+{
+    return m_num_cycles > 0 ? m_total_execution_time/m_num_cycles : 0;
+}
+
+/*! @brief Returns the number of cycles whose latency fell in the given bin, or 0 if there is no such bin */
+unsigned long PeriodicThreadStatistics::getLatencyCount(int bin) const
+{
+    if (bin < 0 or bin >= PERIODIC_THREAD_LATENCY_BINS)
+        return 0;
+    return m_latency_histogram[bin];
+}
+
+/*! @brief Returns the lower edge in ms of the given latency bin */
+double PeriodicThreadStatistics::getLatencyBinEdge(int bin)
+{
+    if (bin < 0 or bin >= PERIODIC_THREAD_LATENCY_BINS)
+        return 0;
+    return LatencyBinEdges[bin];
+}
+
+/*! @brief Prints a human readable summary of the statistics */
+ostream& operator<<(ostream& output, const PeriodicThreadStatistics& statistics)
+{
+    output << "cycles: " << statistics.m_num_cycles << " missed: " << statistics.m_num_missed;
+    output << " latency (mean/worst): " << statistics.getMeanLatency() << "/" << statistics.m_worst_latency << "ms";
+    output << " execution (mean/worst): " << statistics.getMeanExecutionTime() << "/" << statistics.m_worst_execution_time << "ms" << endl;
+    output << "latency histogram:";
+    for (int i=0; i<PERIODIC_THREAD_LATENCY_BINS; i++)
+        output << " [" << LatencyBinEdges[i] << (i+1 < PERIODIC_THREAD_LATENCY_BINS ? "" : "+") << "]: " << statistics.m_latency_histogram[i];
+    output << endl;
+    return output;
+}
+
@@ -0,0 +1,66 @@
+/*! @file PeriodicThreadStatistics.h
+    @brief Declaration of PeriodicThreadStatistics class.
+
+    @class PeriodicThreadStatistics
+    @brief The timing statistics of a PeriodicThread
+
+    Every cycle of a PeriodicThread records how late it was released (the wake up latency), how long
+    its periodicFunction() took to execute, and how many deadlines it missed. The latency is kept in
+    a histogram with fixed bins so that it is cheap to record, and can be compared across threads.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PERIODIC_THREAD_STATISTICS_H
+#define PERIODIC_THREAD_STATISTICS_H
+
+#include <iostream>
+
+#define PERIODIC_THREAD_LATENCY_BINS 8          //!< the number of bins in the wake up latency histogram
+
+class PeriodicThreadStatistics
+{
+public:
+    PeriodicThreadStatistics();
+
+    void reset();
+    void add(double latency, double executiontime, unsigned int missed);
+
+    unsigned long getNumCycles() const;
+    unsigned long getNumMissed() const;
+    double getWorstLatency() const;
+    double getMeanLatency() const;
+    double getWorstExecutionTime() const;
+    double getMeanExecutionTime() const;
+    unsigned long getLatencyCount(int bin) const;
+
+    static double getLatencyBinEdge(int bin);
+
+    friend std::ostream& operator<<(std::ostream& output, const PeriodicThreadStatistics& statistics);
+private:
+    unsigned long m_num_cycles;                 //!< the number of times periodicFunction() has been run
+    unsigned long m_num_missed;                 //!< the number of deadlines that have been missed
+    double m_worst_latency;                     //!< the largest wake up latency in ms
+    double m_total_latency;                     //!< the sum of the wake up latencies in ms
+    double m_worst_execution_time;              //!< the longest execution of periodicFunction() in ms
+    double m_total_execution_time;              //!< the sum of the execution times in ms
+    unsigned long m_latency_histogram[PERIODIC_THREAD_LATENCY_BINS];    //!< the wake up latency histogram, see getLatencyBinEdge() for the bins
+};
+
+#endif
+
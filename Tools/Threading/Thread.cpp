@@ -65,6 +65,7 @@ int Thread::start()
         errorlog << "Thread::start(). Failed to create " << m_name << ". The error code was: " << err << endl;
         return -1;
     }
+    running = true;
     
     if (m_priority > 0)
     {   // if the priority is non-zero then we create the thread as a bona fide real-time thread with the given priority
@@ -89,21 +90,28 @@ int Thread::start()
 	return 0;
 }
 
-/*! @brief Blocks the calling thread until this thread is completed.
+/*! @brief Blocks the calling thread until this thread is completed. Once joined the thread is no longer running.
  */
 int Thread::join()
 {
-    return pthread_join(m_pthread, NULL); 
+    if (not running)
+        return 0;
+    int err = pthread_join(m_pthread, NULL);
+    if (err == 0)
+        running = false;
+    return err;
 }
 
-/*! @brief Cancels the threads execution, and sets the running flag to false
+/*! @brief Cancels the threads execution, and sets the running flag to false. A thread that was never started,
+           or has already been joined, is left alone.
  */
 void Thread::stop()
 {
     #if DEBUG_THREADING_VERBOSITY > 0
         debug << "Thread::stop(): " << m_name << endl;
     #endif
-    pthread_cancel(m_pthread);
+    if (running)
+        pthread_cancel(m_pthread);
 	running = false;
 }
 
@@ -24,6 +24,7 @@ SET (YOUR_SRCS
 Thread.cpp 
 ConditionalThread.cpp
 PeriodicThread.cpp
+PeriodicThreadStatistics.cpp
 QueueThread.h
 )
 ####################################################################################
@@ -8,31 +8,35 @@
 #include "debugverbosityvision.h"
 #include "Infrastructure/NUSensorsData/NUSensorsData.h"
 //#include <QDebug>
-Ball::Ball()
+Ball::Ball() : ballPoints(MAX_BALL_FITS), fits(MAX_BALL_FITS)
 {
     //debug<< "Vision::DetectBall : Ball Class created" << endl;
+    ballColours.push_back(ClassIndex::orange);
+    ballColours.push_back(ClassIndex::pink_orange);
+    ballColours.push_back(ClassIndex::yellow_orange);
 }
 Ball::~Ball()
 {
 }
 
 //! Finds the ball segments and groups updates the ball in fieldObjects (Vision is used to further classify the object)
-Circle Ball::FindBall(std::vector <ObjectCandidate> FO_Candidates, FieldObjects* AllObjects, Vision* vision,int height,int width)
+Circle Ball::FindBall(const FrameVector<ObjectCandidate>::type& FO_Candidates, FieldObjects* AllObjects, Vision* vision,int height,int width)
 {
-    ObjectCandidate largestCandidate;
-    int sizeOfLargestCandidate = 0;
+    const ObjectCandidate* candidates[MAX_BALL_FITS];
+    int sizeOfCandidates[MAX_BALL_FITS];
+    int numCandidates = 0;
     Circle result;
     result.centreX = 0;
     result.centreY = 0;
     result.radius = 0;
     result.sd = 0;
 
-    //! Go through all the candidates: to find a possible ball
+    //! Go through all the candidates: to find the MAX_BALL_FITS largest possible balls, largest first
     //debug <<"FO_Candidates.size():"<< FO_Candidates.size();
     for(unsigned int i = 0; i  < FO_Candidates.size(); i++)
     {
 
-        ObjectCandidate PossibleBall = FO_Candidates[i];
+        const ObjectCandidate& PossibleBall = FO_Candidates[i];
 
         if(!isObjectAPossibleBall(PossibleBall)) continue;
 
@@ -45,25 +49,47 @@ Circle Ball::FindBall(std::vector <ObjectCandidate> FO_Candidates, FieldObjects*
         //debug << "BALL::FindBall  Possible Ball Found ";
 
         int sizeOfCandidate = (PossibleBall.getBottomRight().y - PossibleBall.getTopLeft().y); //Uses the height of the candidate, as width can be 0
-
-        if(sizeOfCandidate > sizeOfLargestCandidate)
+        if(sizeOfCandidate <= 0) continue;
+
+        //! Insert the candidate behind those of the same size, so ties keep their original order
+        int j = numCandidates;
+        if(numCandidates < MAX_BALL_FITS)
+            numCandidates++;
+        else if(sizeOfCandidate > sizeOfCandidates[MAX_BALL_FITS-1])
+            j = MAX_BALL_FITS-1;
+        else
+            continue;
+        while(j > 0 && sizeOfCandidates[j-1] < sizeOfCandidate)
         {
-
-            sizeOfLargestCandidate = sizeOfCandidate;
-            largestCandidate = PossibleBall;
+            candidates[j] = candidates[j-1];
+            sizeOfCandidates[j] = sizeOfCandidates[j-1];
+            j--;
         }
-
+        candidates[j] = &PossibleBall;
+        sizeOfCandidates[j] = sizeOfCandidate;
     }
-    //! Closely Classify the candidate: to obtain more information about the object (using closely classify function in vision)
-    if(sizeOfLargestCandidate > 0)
+    if(numCandidates == 0)
+        return result;
+
+    //! Closely Classify the candidates: to obtain more information about the object (using closely classify function in vision)
+    for(int i = 0; i < numCandidates; i++)
     {
-        largestCandidate.setColour(ClassIndex::orange);
-        std::vector < Vector2<int> > ballPoints = classifyBallClosely(largestCandidate, vision,height, width);
+        ObjectCandidate candidate = *candidates[i];
+        candidate.setColour(ClassIndex::orange);
+        classifyBallClosely(candidate, vision, height, width, ballPoints[i]);
+    }
 
-        //! Perform Circle Fit: Must pass a threshold on fit to become a circle!
-        //debug << "BALL::FindBall  Circle Fit ";
+    //! Perform Circle Fit: Must pass a threshold on fit to become a circle! The edge points are fitted as a batch,
+    //! with outliers (eg. the edge of a robot's foot touching the ball) removed before each fit.
+    circleFit.FitCircles(ballPoints, numCandidates, BALL_FIT_INLIER_DISTANCE, fits);
 
-        result = isCorrectFit(ballPoints,largestCandidate, vision);
+    //! The largest candidate with an acceptable fit is the ball, otherwise return the (rejected) fit of the largest
+    result = isCorrectFit(ballPoints[0], fits[0], *candidates[0], vision);
+    for(int i = 1; i < numCandidates && !result.isDefined; i++)
+    {
+        Circle circ = isCorrectFit(ballPoints[i], fits[i], *candidates[i], vision);
+        if(circ.isDefined)
+            result = circ;
     }
     return result;
 }
@@ -74,7 +100,7 @@ bool Ball::isObjectAPossibleBall(const ObjectCandidate &PossibleBall)
        PossibleBall.getColour()== ClassIndex::pink_orange ||
        PossibleBall.getColour() == ClassIndex::yellow_orange)
     {
-        std::vector<TransitionSegment >segments = PossibleBall.getSegments();
+        SegmentSpan segments = PossibleBall.getSegments();
         int orangeSize = 0;
         //int pinkSize = 0;
         for(unsigned int i = 0; i <segments.size(); i++)
@@ -154,7 +180,8 @@ bool Ball::isObjectInRobot(const ObjectCandidate &PossibleBall, FieldObjects *Al
     return isInRobot;
 }
 
-std::vector < Vector2<int> > Ball::classifyBallClosely(const ObjectCandidate &PossibleBall,Vision* vision,int height, int width)
+//! Closely classifies across the middle of the candidate, and fills BallPoints with the edge points found
+void Ball::classifyBallClosely(const ObjectCandidate &PossibleBall,Vision* vision,int height, int width, std::vector < Vector2<int> >& BallPoints)
 {
     int buffer = 20;
     Vector2<int> TopLeft = PossibleBall.getTopLeft();
@@ -168,7 +195,9 @@ std::vector < Vector2<int> > Ball::classifyBallClosely(const ObjectCandidate &Po
     SegEnd.x = midX;
     SegEnd.y = BottomRight.y;
     TransitionSegment tempSeg(SegStart,SegEnd,ClassIndex::unclassified,PossibleBall.getColour(),ClassIndex::unclassified);
-    ScanLine tempLine = ScanLine();
+    closeArea.reset(ScanLine::DOWN);
+    closeArea.addScanLine(ScanLine());
+    ScanLine* tempLine = closeArea.getScanLine(0);
 
     //! Maximum ball points = 4*2 = 8;
     int spacings = (int)(BottomRight.y - TopLeft.y)/4;
@@ -177,36 +206,30 @@ std::vector < Vector2<int> > Ball::classifyBallClosely(const ObjectCandidate &Po
         spacings = 2;
     }
     //qDebug() << spacings ;
-    std::vector<unsigned char> colourlist;
-    colourlist.reserve(3);
-    colourlist.push_back(ClassIndex::orange);
-    colourlist.push_back(ClassIndex::pink_orange);
-    colourlist.push_back(ClassIndex::yellow_orange);
     int direction = ScanLine::DOWN;
     //qDebug() << "Horizontal Scan : ";
-    vision->CloselyClassifyScanline(&tempLine,&tempSeg,spacings, direction,colourlist);
-
-    std::vector< Vector2<int> > BallPoints;
+    vision->CloselyClassifyScanline(tempLine,&tempSeg,spacings, direction,ballColours);
 
+    BallPoints.clear();
     BallPoints.push_back(SegStart);
     BallPoints.push_back(SegEnd);
     //! Debug Output for small scans:
-    for(int i = 0; i < tempLine.getNumberOfSegments(); i++)
+    for(int i = 0; i < tempLine->getNumberOfSegments(); i++)
     {
-        TransitionSegment* tempSegement = tempLine.getSegment(i);
+        TransitionSegment tempSegement = tempLine->getSegment(i);
         //! Check if the segments are at the edge of screen
-        if(!(tempSegement->getStartPoint().x < buffer || tempSegement->getStartPoint().y < buffer))
+        if(!(tempSegement.getStartPoint().x < buffer || tempSegement.getStartPoint().y < buffer))
         {
-            BallPoints.push_back(tempSegement->getStartPoint());
+            BallPoints.push_back(tempSegement.getStartPoint());
         }
-        if(!(tempSegement->getEndPoint().x >= height-buffer || tempSegement->getEndPoint().x >= width-buffer))
+        if(!(tempSegement.getEndPoint().x >= height-buffer || tempSegement.getEndPoint().x >= width-buffer))
         {
-            BallPoints.push_back(tempSegement->getEndPoint());
+            BallPoints.push_back(tempSegement.getEndPoint());
         }
 
-        /*qDebug() << "Horizontal Points At " <<i<<"\t Size: "<< tempSegement->getSize()<< "\t Start(x,y),End(x,y):("<< tempSegement->getStartPoint().x
-                <<","<< tempSegement->getStartPoint().y << ")("<< tempSegement->getEndPoint().x
-                <<","<< tempSegement->getEndPoint().y << ")";*/
+        /*qDebug() << "Horizontal Points At " <<i<<"\t Size: "<< tempSegement.getSize()<< "\t Start(x,y),End(x,y):("<< tempSegement.getStartPoint().x
+                <<","<< tempSegement.getStartPoint().y << ")("<< tempSegement.getEndPoint().x
+                <<","<< tempSegement.getEndPoint().y << ")";*/
 
     }
 
@@ -215,7 +238,9 @@ std::vector < Vector2<int> > Ball::classifyBallClosely(const ObjectCandidate &Po
     SegEnd.x = BottomRight.x;
     SegEnd.y = midY;
     tempSeg = TransitionSegment(SegStart,SegEnd,ClassIndex::unclassified,PossibleBall.getColour(),ClassIndex::unclassified);
-    tempLine = ScanLine();
+    closeArea.reset(ScanLine::LEFT);
+    closeArea.addScanLine(ScanLine());
+    tempLine = closeArea.getScanLine(0);
 
     BallPoints.push_back(SegStart);
     BallPoints.push_back(SegEnd);
@@ -228,34 +253,31 @@ std::vector < Vector2<int> > Ball::classifyBallClosely(const ObjectCandidate &Po
     }
     //qDebug() << "Vertical Scan : ";
     direction = ScanLine::LEFT;
-    vision->CloselyClassifyScanline(&tempLine,&tempSeg,spacings, direction, colourlist);
-    for(int i = 0; i < tempLine.getNumberOfSegments(); i++)
+    vision->CloselyClassifyScanline(tempLine,&tempSeg,spacings, direction, ballColours);
+    for(int i = 0; i < tempLine->getNumberOfSegments(); i++)
     {
 
-        TransitionSegment* tempSegement = tempLine.getSegment(i);
+        TransitionSegment tempSegement = tempLine->getSegment(i);
         //! Check if the segments are at the edge of screen
-        if(!(tempSegement->getStartPoint().x < buffer || tempSegement->getStartPoint().y < buffer))
+        if(!(tempSegement.getStartPoint().x < buffer || tempSegement.getStartPoint().y < buffer))
         {
-            BallPoints.push_back(tempSegement->getStartPoint());
+            BallPoints.push_back(tempSegement.getStartPoint());
         }
 
         float headElevation = 0.0;
-        vision->getSensorsData()->getPosition(NUSensorsData::HeadPitch,headElevation);
+        vision->getHeadPitch(headElevation);
 
-        if(!(tempSegement->getEndPoint().y >= height-buffer || tempSegement->getEndPoint().x >= width-buffer) &&  headElevation < 0.3)
+        if(!(tempSegement.getEndPoint().y >= height-buffer || tempSegement.getEndPoint().x >= width-buffer) &&  headElevation < 0.3)
         {
-            BallPoints.push_back(tempSegement->getEndPoint());
+            BallPoints.push_back(tempSegement.getEndPoint());
         }
         //vision->getSensorsData()->getJointPosition(NUSensorsData::HeadPitch,headElevation);
         //qDebug() << "Ball Head Elevation:" << headElevation;
-        /*qDebug() << "Veritcal Points At " <<i<<"\t Size: "<< tempSegement->getSize()<< "\t Start(x,y),End(x,y):("<< tempSegement->getStartPoint().x
-                <<","<< tempSegement->getStartPoint().y << ")("<< tempSegement->getEndPoint().x
-                <<","<< tempSegement->getEndPoint().y << ")";*/
+        /*qDebug() << "Veritcal Points At " <<i<<"\t Size: "<< tempSegement.getSize()<< "\t Start(x,y),End(x,y):("<< tempSegement.getStartPoint().x
+                <<","<< tempSegement.getStartPoint().y << ")("<< tempSegement.getEndPoint().x
+                <<","<< tempSegement.getEndPoint().y << ")";*/
 
     }
-
-    return BallPoints;
-
 }
 bool Ball::isCorrectCheckRatio(const ObjectCandidate &PossibleBall,int height, int width)
 {
@@ -288,12 +310,11 @@ bool Ball::isCorrectCheckRatio(const ObjectCandidate &PossibleBall,int height, i
         return true;
     }
 }
-Circle Ball::isCorrectFit(const std::vector < Vector2<int> > &ballPoints, const ObjectCandidate &PossibleBall, Vision* vision)
+Circle Ball::isCorrectFit(const std::vector < Vector2<int> > &ballPoints, const Circle& fit, const ObjectCandidate &PossibleBall, Vision* vision)
 {
     Circle circ;
     circ.radius = 0.0;
     circ.isDefined = false;
-    CircleFitting CircleFit;
 
     //debug << "Points:";
    /* for(int i =0; i < ballPoints.size(); i++)
@@ -303,7 +324,7 @@ Circle Ball::isCorrectFit(const std::vector < Vector2<int> > &ballPoints, const
     if(ballPoints.size() > 10)
     {
 
-            circ = CircleFit.FitCircleLMA(ballPoints);
+            circ = fit;
             if(circ.sd > 5 ||  circ.radius*2 > getMaxPixelsOfBall(vision) )
             {
                 circ.isDefined = false;
@@ -1,16 +1,22 @@
+#ifndef BALL_H
+#define BALL_H
 
 #include "ObjectCandidate.h"
 #include "CircleFitting.h"
+#include "ClassifiedSection.h"
 class Vision;
 class FieldObjects;
 
+#define MAX_BALL_FITS 3                 //!< the number of the largest candidates that are closely classified and fitted
+#define BALL_FIT_INLIER_DISTANCE 3.0    //!< the distance in pixels an edge point can be from the circle before it is an outlier
+
 class Ball
 {
   public:
 	Ball();
         ~Ball();
 
-        Circle FindBall(const std::vector<ObjectCandidate> FO_Candidates,
+        Circle FindBall(const FrameVector<ObjectCandidate>::type& FO_Candidates,
 			FieldObjects* AllObjects,
                         Vision* vision,
                         int height,
@@ -20,9 +26,16 @@ class Ball
         bool isObjectInRobot(const ObjectCandidate &PossibleBall, FieldObjects* AllObjects);
         bool isObjectTooBig(const ObjectCandidate &PossibleBall, Vision* vision);
         float getMaxPixelsOfBall(Vision* vision);
-        std::vector < Vector2<int> > classifyBallClosely(const ObjectCandidate &PossibleBall,Vision* vision,int height,int width);
+        void classifyBallClosely(const ObjectCandidate &PossibleBall,Vision* vision,int height,int width, std::vector < Vector2<int> >& BallPoints);
         bool isCorrectCheckRatio(const ObjectCandidate &PossibleBall,int height,int width);
-        Circle isCorrectFit(const std::vector < Vector2<int> > &ballPoints, const ObjectCandidate &PossibleBall, Vision* vision);
-	
+        Circle isCorrectFit(const std::vector < Vector2<int> > &ballPoints, const Circle& fit, const ObjectCandidate &PossibleBall, Vision* vision);
+
+        CircleFitting circleFit;
+        ClassifiedSection closeArea;    //!< the line and segments of the current close classification, reused for each candidate
+        std::vector < std::vector < Vector2<int> > > ballPoints;   //!< the edge points of each of the MAX_BALL_FITS candidates, reused every frame
+        std::vector<Circle> fits;       //!< the fit to each candidate's edge points, reused every frame
+        std::vector<unsigned char> ballColours;     //!< the colours a close classification looks for
 };
 
+#endif
+
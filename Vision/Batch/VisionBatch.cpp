@@ -0,0 +1,436 @@
+/*! @file VisionBatch.cpp
+    @brief Implementation of VisionBatch class
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "VisionBatch.h"
+#include "Vision/Vision.h"
+#include "Infrastructure/NUImage/NUImage.h"
+#include "Infrastructure/NUSensorsData/NUSensorsData.h"
+#include "Infrastructure/NUActionatorsData/NUActionatorsData.h"
+#include "Infrastructure/FieldObjects/FieldObjects.h"
+#include "Tools/Threading/Thread.h"
+
+#include "debug.h"
+
+#include <time.h>
+#include <sstream>
+#include <iomanip>
+#include <exception>
+#include <cmath>
+using namespace std;
+
+/*! @brief A thread with its own Vision, processing frames from the logs until there are none left.
+    In the Compare mode it also has a reference Vision, which processes each frame first.
+ */
+class VisionBatch::Worker : public Thread
+{
+public:
+    Worker(VisionBatch* batch, int number) : Thread(workerName(number), 0), m_batch(batch), m_timer(VisionBatch::getThreadTime), m_reference_timer(VisionBatch::getThreadTime)
+    {
+        m_vision = createVision(batch->m_mode == FullScan ? Vision::FullScan : Vision::MultiResolutionScan, &m_timer);
+        m_image = new NUImage();
+        m_data = new NUSensorsData();
+        m_actions = new NUActionatorsData();
+        m_field_objects = new FieldObjects();
+        m_reference_vision = NULL;
+        m_reference_field_objects = NULL;
+        if (batch->m_mode == Compare)
+        {
+            m_reference_vision = createVision(Vision::FullScan, &m_reference_timer);
+            m_reference_field_objects = new FieldObjects();
+        }
+    }
+
+    ~Worker()
+    {
+        delete m_reference_field_objects;
+        delete m_reference_vision;
+        delete m_field_objects;
+        delete m_actions;
+        delete m_data;
+        delete m_image;
+        delete m_vision;
+    }
+
+protected:
+    void run()
+    {
+        int frame;
+        while (m_batch->readFrame(m_image, m_data, frame))
+        {
+            m_actions->preProcess(m_image->m_timestamp);
+            if (m_reference_vision != NULL)
+                m_reference_vision->ProcessFrame(m_image, m_data, m_actions, m_reference_field_objects);
+            m_vision->ProcessFrame(m_image, m_data, m_actions, m_field_objects);
+            m_actions->postProcess();
+            string result = VisionBatch::formatResult(frame, m_image->m_timestamp, m_timer, m_field_objects);
+            if (m_reference_vision != NULL)
+            {
+                Comparison comparison;
+                VisionBatch::compare(m_field_objects, m_reference_field_objects, m_reference_timer.getTotal(), comparison);
+                m_batch->writeResult(frame, result + VisionBatch::formatComparison(comparison), m_timer, &comparison);
+            }
+            else
+                m_batch->writeResult(frame, result, m_timer);
+        }
+        m_batch->recordFrameArena(m_vision->getFrameArena());
+    }
+
+private:
+    Vision* createVision(Vision::ScanMode mode, VisionStageTimer* timer)
+    {
+        Vision* vision = new Vision();
+        if (not m_batch->m_lut_file.empty())
+            vision->loadLUTFromFile(m_batch->m_lut_file);
+        vision->setStageTimer(timer);
+        vision->setScanMode(mode);
+        return vision;
+    }
+
+    static string workerName(int number)
+    {
+        stringstream name;
+        name << "VisionBatchWorker" << number;
+        return name.str();
+    }
+
+private:
+    VisionBatch* m_batch;                       //!< the batch the frames are read from and the results written to
+    VisionStageTimer m_timer;                   //!< the cpu time spent in each stage by this worker's Vision
+    Vision* m_vision;
+    NUImage* m_image;
+    NUSensorsData* m_data;
+    NUActionatorsData* m_actions;
+    FieldObjects* m_field_objects;
+    VisionStageTimer m_reference_timer;         //!< the cpu time spent in each stage by the reference Vision
+    Vision* m_reference_vision;                 //!< the Vision using Vision::FullScan in the Compare mode, otherwise NULL
+    FieldObjects* m_reference_field_objects;    //!< the objects found by the reference Vision in the Compare mode, otherwise NULL
+};
+
+/*! @brief Creates a batch over a log
+    @param images the image log (image.strm)
+    @param sensors the sensor log (sensor.strm)
+    @param output the stream the per frame results are written to
+    @param numworkers the number of Vision instances run in parallel
+    @param lutfile the lookup table to use; if empty the default.lut in DATA_DIR is used
+    @param mode the way the frames are processed. The MultiResolution and Compare modes always use a single worker, because
+                the regions of interest are tracked from one frame to the next.
+ */
+VisionBatch::VisionBatch(istream& images, istream& sensors, ostream& output, int numworkers, const string& lutfile, Mode mode) : m_images(images), m_sensors(sensors), m_output(output)
+{
+    m_num_workers = numworkers > 0 and mode == FullScan ? numworkers : 1;
+    m_lut_file = lutfile;
+    m_mode = mode;
+    pthread_mutex_init(&m_read_mutex, NULL);
+    pthread_mutex_init(&m_write_mutex, NULL);
+    m_frames_read = 0;
+    m_log_finished = false;
+    m_frames_written = 0;
+    for (int i=0; i<VisionStageTimer::NumStages; i++)
+        m_stage_totals[i] = 0;
+    m_frame_total = 0;
+    m_frame_max = 0;
+    m_frames_over_budget = 0;
+    m_reference_total = 0;
+    m_reference_max = 0;
+    for (int i=0; i<RegionOfInterestTracker::NumTargets; i++)
+    {
+        m_both_seen[i] = 0;
+        m_missed[i] = 0;
+        m_extra[i] = 0;
+        m_centre_error_total[i] = 0;
+    }
+    m_real_time = 0;
+    m_arena_high_water_mark = 0;
+    m_arena_overflows = 0;
+}
+
+VisionBatch::~VisionBatch()
+{
+    pthread_mutex_destroy(&m_read_mutex);
+    pthread_mutex_destroy(&m_write_mutex);
+}
+
+/*! @brief Processes the entire log, returning once every frame has been written to the output */
+void VisionBatch::run()
+{
+    writeHeader();
+    double starttime = getRealTime();
+
+    vector<Worker*> workers;
+    for (int i=0; i<m_num_workers; i++)
+        workers.push_back(new Worker(this, i));
+    for (size_t i=0; i<workers.size(); i++)
+        workers[i]->start();
+    for (size_t i=0; i<workers.size(); i++)
+        workers[i]->join();
+    for (size_t i=0; i<workers.size(); i++)
+        delete workers[i];
+
+    m_real_time = getRealTime() - starttime;
+    m_output.flush();
+}
+
+/*! @brief Reads the next frame from the logs
+    @param image will be updated with the next image
+    @param data will be updated with the sensors for the next image
+    @param frame will be updated with the position of the frame in the log
+    @return false if there are no frames left
+ */
+bool VisionBatch::readFrame(NUImage* image, NUSensorsData* data, int& frame)
+{
+    bool success = false;
+    pthread_mutex_lock(&m_read_mutex);
+    if (not m_log_finished and m_images.peek() != EOF and m_sensors.peek() != EOF)
+    {
+        try
+        {
+            m_images >> (*image);
+            m_sensors >> (*data);
+            success = not m_images.fail() and not m_sensors.fail();
+        }
+        catch (exception&)
+        {
+            errorlog << "VisionBatch::readFrame(). The log is truncated after frame " << m_frames_read << endl;
+        }
+    }
+    if (success)
+        frame = m_frames_read++;
+    else
+        m_log_finished = true;
+    pthread_mutex_unlock(&m_read_mutex);
+    return success;
+}
+
+/*! @brief Writes the result for a frame. Results are buffered until all of the earlier frames have been written.
+    @param frame the position of the frame in the log
+    @param result the line to write for the frame
+    @param timer the stage times for the frame
+    @param comparison the comparison with the reference Vision in the Compare mode, otherwise NULL
+ */
+void VisionBatch::writeResult(int frame, const string& result, const VisionStageTimer& timer, const Comparison* comparison)
+{
+    pthread_mutex_lock(&m_write_mutex);
+    for (int i=0; i<VisionStageTimer::NumStages; i++)
+        m_stage_totals[i] += timer.get(static_cast<VisionStageTimer::Stage>(i));
+    double total = timer.getTotal();
+    m_frame_total += total;
+    if (total > m_frame_max)
+        m_frame_max = total;
+    if (total > VISIONBATCH_FRAME_BUDGET)
+        m_frames_over_budget++;
+    if (comparison != NULL)
+    {
+        m_reference_total += comparison->ReferenceTime;
+        if (comparison->ReferenceTime > m_reference_max)
+            m_reference_max = comparison->ReferenceTime;
+        for (int i=0; i<RegionOfInterestTracker::NumTargets; i++)
+        {
+            if (comparison->Seen[i] and comparison->ReferenceSeen[i])
+            {
+                m_both_seen[i]++;
+                m_centre_error_total[i] += comparison->CentreError[i];
+            }
+            else if (comparison->ReferenceSeen[i])
+                m_missed[i]++;
+            else if (comparison->Seen[i])
+                m_extra[i]++;
+        }
+    }
+
+    m_pending[frame] = result;
+    map<int, string>::iterator it = m_pending.begin();
+    while (it != m_pending.end() and it->first == m_frames_written)
+    {
+        m_output << it->second << '\n';
+        m_pending.erase(it++);
+        m_frames_written++;
+    }
+    pthread_mutex_unlock(&m_write_mutex);
+}
+
+/*! @brief Records the usage of a worker's frame arena once it has finished, for the summary */
+void VisionBatch::recordFrameArena(const FrameArena& arena)
+{
+    pthread_mutex_lock(&m_write_mutex);
+    if (arena.getHighWaterMark() > m_arena_high_water_mark)
+        m_arena_high_water_mark = arena.getHighWaterMark();
+    m_arena_overflows += arena.getNumOverflows();
+    pthread_mutex_unlock(&m_write_mutex);
+}
+
+/*! @brief Writes the names of the columns of the per frame results */
+void VisionBatch::writeHeader()
+{
+    m_output << "# frame\ttimestamp\ttotal";
+    for (int i=0; i<VisionStageTimer::NumStages; i++)
+        m_output << '\t' << VisionStageTimer::getName(static_cast<VisionStageTimer::Stage>(i));
+    m_output << "\tobjects (type:id:screenx,screeny:distance,bearing,elevation)";
+    if (m_mode == Compare)
+    {
+        m_output << "\treference";
+        for (int i=0; i<RegionOfInterestTracker::NumTargets; i++)
+            m_output << '\t' << RegionOfInterestTracker::getName(static_cast<RegionOfInterestTracker::Target>(i));
+    }
+    m_output << '\n';
+}
+
+/*! @brief Formats the result of a single frame as one line. The times are in ms, the distances in cm and the angles in rad.
+    Each visible object is written as type:id:screenx,screeny:distance,bearing,elevation separated by spaces, where type is
+    S, M or A for stationary, mobile or ambiguous objects.
+ */
+string VisionBatch::formatResult(int frame, double timestamp, const VisionStageTimer& timer, const FieldObjects* fieldobjects)
+{
+    stringstream line;
+    line << frame << '\t' << fixed << setprecision(0) << timestamp;
+    line << setprecision(3) << '\t' << timer.getTotal();
+    for (int i=0; i<VisionStageTimer::NumStages; i++)
+        line << '\t' << timer.get(static_cast<VisionStageTimer::Stage>(i));
+    line << '\t' << setprecision(2);
+
+    bool first = true;
+    for (size_t i=0; i<fieldobjects->stationaryFieldObjects.size(); i++)
+    {
+        const StationaryObject& object = fieldobjects->stationaryFieldObjects[i];
+        if (not object.isObjectVisible())
+            continue;
+        line << (first ? "" : " ") << "S:" << i << ':' << object.ScreenX() << ',' << object.ScreenY() << ':' << object.measuredDistance() << ',' << object.measuredBearing() << ',' << object.measuredElevation();
+        first = false;
+    }
+    for (size_t i=0; i<fieldobjects->mobileFieldObjects.size(); i++)
+    {
+        const MobileObject& object = fieldobjects->mobileFieldObjects[i];
+        if (not object.isObjectVisible())
+            continue;
+        line << (first ? "" : " ") << "M:" << i << ':' << object.ScreenX() << ',' << object.ScreenY() << ':' << object.measuredDistance() << ',' << object.measuredBearing() << ',' << object.measuredElevation();
+        first = false;
+    }
+    for (size_t i=0; i<fieldobjects->ambiguousFieldObjects.size(); i++)
+    {
+        const AmbiguousObject& object = fieldobjects->ambiguousFieldObjects[i];
+        if (not object.isObjectVisible())
+            continue;
+        line << (first ? "" : " ") << "A:" << object.getID() << ':' << object.ScreenX() << ',' << object.ScreenY() << ':' << object.measuredDistance() << ',' << object.measuredBearing() << ',' << object.measuredElevation();
+        first = false;
+    }
+    if (first)
+        line << '-';
+    return line.str();
+}
+
+/*! @brief Compares the ball and goals found in a frame with those found by the reference Vision
+    @param fieldobjects the objects found by the multi-resolution Vision
+    @param reference the objects found by the reference Vision
+    @param referencetime the reference ProcessFrame cpu time in ms
+    @param comparison will be updated with the comparison
+ */
+void VisionBatch::compare(const FieldObjects* fieldobjects, const FieldObjects* reference, double referencetime, Comparison& comparison)
+{
+    comparison.ReferenceTime = referencetime;
+    for (int i=0; i<RegionOfInterestTracker::NumTargets; i++)
+    {
+        RegionOfInterestTracker::Target target = static_cast<RegionOfInterestTracker::Target>(i);
+        int minx, miny, maxx, maxy, refminx, refminy, refmaxx, refmaxy;
+        comparison.Seen[i] = RegionOfInterestTracker::measure(fieldobjects, target, minx, miny, maxx, maxy);
+        comparison.ReferenceSeen[i] = RegionOfInterestTracker::measure(reference, target, refminx, refminy, refmaxx, refmaxy);
+        comparison.CentreError[i] = 0;
+        if (comparison.Seen[i] and comparison.ReferenceSeen[i])
+        {
+            float dx = 0.5*(minx + maxx - refminx - refmaxx);
+            float dy = 0.5*(miny + maxy - refminy - refmaxy);
+            comparison.CentreError[i] = sqrt(dx*dx + dy*dy);
+        }
+    }
+}
+
+/*! @brief Formats a comparison as the extra columns of a frame's result; the reference time in ms, then for each target the
+    centre error in pixels if both saw it, 'M' if only the reference saw it, 'E' if only the multi-resolution Vision saw it, or '-'
+ */
+string VisionBatch::formatComparison(const Comparison& comparison)
+{
+    stringstream line;
+    line << fixed << setprecision(3) << '\t' << comparison.ReferenceTime << setprecision(1);
+    for (int i=0; i<RegionOfInterestTracker::NumTargets; i++)
+    {
+        line << '\t';
+        if (comparison.Seen[i] and comparison.ReferenceSeen[i])
+            line << comparison.CentreError[i];
+        else if (comparison.ReferenceSeen[i])
+            line << 'M';
+        else if (comparison.Seen[i])
+            line << 'E';
+        else
+            line << '-';
+    }
+    return line.str();
+}
+
+/*! @brief Returns the cpu time used by the calling thread in ms */
+double VisionBatch::getThreadTime()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return 1e3*now.tv_sec + 1e-6*now.tv_nsec;
+}
+
+/*! @brief Returns the wall time in ms */
+double VisionBatch::getRealTime()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return 1e3*now.tv_sec + 1e-6*now.tv_nsec;
+}
+
+/*! @brief Prints a summary of the batch; the number of frames, the throughput and the mean time spent in each stage.
+    In the Compare mode it also prints the speedup over the reference, and how well the ball and goals found agree with it.
+ */
+ostream& operator<<(ostream& output, const VisionBatch& batch)
+{
+    static const char* modenames[] = {"full", "multi", "compare"};
+    int frames = batch.m_frames_written;
+    output << "Frames: " << frames << " Workers: " << batch.m_num_workers << " Mode: " << modenames[batch.m_mode] << endl;
+    if (frames == 0)
+        return output;
+    output << fixed << setprecision(3);
+    output << "Wall time: " << batch.m_real_time/1e3 << "s (" << 1e3*frames/batch.m_real_time << " frames/s)" << endl;
+    output << "ProcessFrame cpu time: mean " << batch.m_frame_total/frames << "ms max " << batch.m_frame_max << "ms" << endl;
+    output << "Frames over " << VISIONBATCH_FRAME_BUDGET << "ms (30 frames/s): " << batch.m_frames_over_budget << " (" << setprecision(1) << 100.0*batch.m_frames_over_budget/frames << "%)" << setprecision(3) << endl;
+    for (int i=0; i<VisionStageTimer::NumStages; i++)
+    {
+        double mean = batch.m_stage_totals[i]/frames;
+        double percentage = batch.m_frame_total > 0 ? 100*batch.m_stage_totals[i]/batch.m_frame_total : 0;
+        output << "\t" << left << setw(12) << VisionStageTimer::getName(static_cast<VisionStageTimer::Stage>(i)) << right << mean << "ms (" << setprecision(1) << percentage << "%)" << setprecision(3) << endl;
+    }
+    output << "Frame arena: high water mark " << batch.m_arena_high_water_mark/1024 << "KB, overflowed in " << batch.m_arena_overflows << " frames" << endl;
+    if (batch.m_mode != VisionBatch::Compare)
+        return output;
+
+    output << "Reference ProcessFrame cpu time: mean " << batch.m_reference_total/frames << "ms max " << batch.m_reference_max << "ms";
+    output << " Speedup: " << (batch.m_frame_total > 0 ? batch.m_reference_total/batch.m_frame_total : 0) << endl;
+    for (int i=0; i<RegionOfInterestTracker::NumTargets; i++)
+    {
+        output << "\t" << left << setw(12) << RegionOfInterestTracker::getName(static_cast<RegionOfInterestTracker::Target>(i)) << right;
+        output << "seen by both " << batch.m_both_seen[i] << " (mean centre error ";
+        output << setprecision(1) << (batch.m_both_seen[i] > 0 ? batch.m_centre_error_total[i]/batch.m_both_seen[i] : 0) << "px)" << setprecision(3);
+        output << " missed " << batch.m_missed[i] << " extra " << batch.m_extra[i] << endl;
+    }
+    return output;
+}
+
@@ -0,0 +1,133 @@
+/*! @file VisionBatch.h
+    @brief Declaration of VisionBatch class
+
+    @class VisionBatch
+    @brief Runs Vision over a whole image log, using a pool of independent Vision instances
+
+    The log is the image.strm and sensor.strm pair saved by Vision on the robot. The frames are
+    read one at a time by whichever worker is free, so the files are only read once and never
+    held in memory. Each worker owns its own Vision, FieldObjects, NUImage, NUSensorsData and
+    NUActionatorsData, and each Vision has its own FrameArena and, through its LineDetection, its
+    own split and merge. The reading of the logs and the writing of the results are shared, and
+    each is protected by a mutex. The debug and errorlog streams are also shared and are not
+    locked, so Vision's debug output is interleaved when there is more than one worker.
+
+    Each stage of Vision::ProcessFrame() is timed with the worker's cpu time, so the timings are
+    not inflated when there are more workers than cores. The results are written one line per
+    frame, in the order of the log, regardless of the order in which the workers finish them.
+
+    In the MultiResolution mode Vision uses Vision::MultiResolutionScan, and in the Compare mode each
+    frame is also processed by a second, reference, Vision using Vision::FullScan so that the
+    detections and times of the two can be compared frame by frame. Both of these modes track the
+    ball and goals from one frame to the next, so they always use a single worker.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef VISIONBATCH_H
+#define VISIONBATCH_H
+
+#include "Vision/VisionStageTimer.h"
+#include "Vision/RegionOfInterestTracker.h"
+class FrameArena;
+class NUImage;
+class NUSensorsData;
+class FieldObjects;
+
+#include <pthread.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <iostream>
+
+#define VISIONBATCH_FRAME_BUDGET 33.3           //!< the ProcessFrame cpu time in ms that keeps up with 30 frames/s
+
+class VisionBatch
+{
+public:
+    enum Mode
+    {
+        FullScan,                               //!< run Vision::FullScan
+        MultiResolution,                        //!< run Vision::MultiResolutionScan
+        Compare                                 //!< run Vision::MultiResolutionScan and compare it with Vision::FullScan
+    };
+
+    VisionBatch(std::istream& images, std::istream& sensors, std::ostream& output, int numworkers, const std::string& lutfile = "", Mode mode = FullScan);
+    ~VisionBatch();
+
+    void run();
+
+    friend std::ostream& operator<<(std::ostream& output, const VisionBatch& batch);
+private:
+    class Worker;
+    friend class Worker;
+
+    /*! @brief The difference between the detections of the multi-resolution and the reference Vision in a single frame */
+    struct Comparison
+    {
+        double ReferenceTime;                                           //!< the reference ProcessFrame cpu time in ms
+        bool Seen[RegionOfInterestTracker::NumTargets];                 //!< true if the target was seen by the multi-resolution Vision
+        bool ReferenceSeen[RegionOfInterestTracker::NumTargets];        //!< true if the target was seen by the reference Vision
+        float CentreError[RegionOfInterestTracker::NumTargets];         //!< the distance between the centres in pixels, when both saw the target
+    };
+
+    bool readFrame(NUImage* image, NUSensorsData* data, int& frame);
+    void writeResult(int frame, const std::string& result, const VisionStageTimer& timer, const Comparison* comparison = NULL);
+    void writeHeader();
+    void recordFrameArena(const FrameArena& arena);
+
+    static std::string formatResult(int frame, double timestamp, const VisionStageTimer& timer, const FieldObjects* fieldobjects);
+    static void compare(const FieldObjects* fieldobjects, const FieldObjects* reference, double referencetime, Comparison& comparison);
+    static std::string formatComparison(const Comparison& comparison);
+    static double getThreadTime();
+    static double getRealTime();
+
+private:
+    std::istream& m_images;                     //!< the image log
+    std::istream& m_sensors;                    //!< the sensor log, with one entry for each image
+    std::ostream& m_output;                     //!< the per frame results
+    int m_num_workers;                          //!< the number of Vision instances
+    std::string m_lut_file;                     //!< the lookup table used by every Vision instance, or empty to use the default
+    Mode m_mode;                                //!< the way the frames are processed
+
+    pthread_mutex_t m_read_mutex;               //!< lock for reading the logs
+    int m_frames_read;                          //!< the number of frames read from the logs
+    bool m_log_finished;                        //!< true once the end of either log has been reached
+
+    pthread_mutex_t m_write_mutex;              //!< lock for the results below
+    std::map<int, std::string> m_pending;       //!< results that have been finished before an earlier frame
+    int m_frames_written;                       //!< the number of results written to m_output
+
+    // the summary
+    double m_stage_totals[VisionStageTimer::NumStages];     //!< the total cpu time spent in each stage in ms
+    double m_frame_total;                       //!< the total cpu time spent in ProcessFrame in ms
+    double m_frame_max;                         //!< the longest ProcessFrame in ms
+    int m_frames_over_budget;                   //!< the number of frames whose ProcessFrame took longer than VISIONBATCH_FRAME_BUDGET
+    double m_reference_total;                   //!< the total cpu time spent in the reference ProcessFrame in ms (Compare only)
+    double m_reference_max;                     //!< the longest reference ProcessFrame in ms (Compare only)
+    int m_both_seen[RegionOfInterestTracker::NumTargets];               //!< the number of frames each target was seen by both (Compare only)
+    int m_missed[RegionOfInterestTracker::NumTargets];                  //!< the number of frames each target was only seen by the reference (Compare only)
+    int m_extra[RegionOfInterestTracker::NumTargets];                   //!< the number of frames each target was only seen by the multi-resolution Vision (Compare only)
+    double m_centre_error_total[RegionOfInterestTracker::NumTargets];   //!< the total distance between the centres in pixels when both saw the target (Compare only)
+    double m_real_time;                         //!< the wall time taken to process the log in ms
+    size_t m_arena_high_water_mark;             //!< the largest frame arena high water mark of the workers in bytes
+    unsigned int m_arena_overflows;             //!< the total number of frames in which a worker's frame arena was too small
+};
+
+#endif
+
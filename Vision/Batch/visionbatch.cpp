@@ -0,0 +1,87 @@
+/*! @file visionbatch.cpp
+    @brief The visionbatch executable. Runs Vision headlessly over an entire image log.
+
+    Usage: visionbatch [image.strm] [sensor.strm] [output file] [number of workers] [lut file] [full|multi|compare]
+
+    The per frame detections and stage timings are written to the output file (visionbatch.txt by default),
+    and a summary is printed when the whole log has been processed. By default there is one worker for
+    each online core. Use a build with NUBOT_BUILD_VISION_BATCH ON.
+
+    The mode selects the scan; full (the default) is Vision::FullScan, multi is Vision::MultiResolutionScan,
+    and compare runs both on every frame and reports the speedup and the differences in the ball and goals.
+    Use "" for the lut file to keep the default lookup table.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "VisionBatch.h"
+
+#include "debug.h"
+
+#include <unistd.h>
+#include <cstdlib>
+#include <fstream>
+using namespace std;
+
+ofstream debug;
+ofstream errorlog;
+
+int main(int argc, const char *argv[])
+{
+    // The workers share these logs, so DEBUG_VISION_VERBOSITY should be left at zero for a batch build
+    debug.open("visionbatchdebug.log");
+    errorlog.open("visionbatcherror.log");
+
+    string imagefilename = argc > 1 ? argv[1] : "image.strm";
+    string sensorfilename = argc > 2 ? argv[2] : "sensor.strm";
+    string outputfilename = argc > 3 ? argv[3] : "visionbatch.txt";
+    int numworkers = argc > 4 ? atoi(argv[4]) : static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
+    string lutfilename = argc > 5 ? argv[5] : "";
+    string modename = argc > 6 ? argv[6] : "full";
+
+    VisionBatch::Mode mode = VisionBatch::FullScan;
+    if (modename == "multi")
+        mode = VisionBatch::MultiResolution;
+    else if (modename == "compare")
+        mode = VisionBatch::Compare;
+    else if (modename != "full")
+    {
+        cerr << "visionbatch: unknown mode " << modename << ", use full, multi or compare" << endl;
+        return 1;
+    }
+
+    ifstream images(imagefilename.c_str(), ios_base::in | ios_base::binary);
+    ifstream sensors(sensorfilename.c_str(), ios_base::in | ios_base::binary);
+    if (not images.is_open() or not sensors.is_open())
+    {
+        cerr << "visionbatch: unable to open " << imagefilename << " and " << sensorfilename << endl;
+        return 1;
+    }
+    ofstream output(outputfilename.c_str());
+    if (not output.is_open())
+    {
+        cerr << "visionbatch: unable to open " << outputfilename << endl;
+        return 1;
+    }
+
+    VisionBatch batch(images, sensors, output, numworkers, lutfilename, mode);
+    batch.run();
+    cout << batch;
+    return 0;
+}
+
@@ -0,0 +1,183 @@
+/*! @file linebenchmark.cpp
+    @brief The linebenchmark executable. Times LineDetection::FindFieldLines on synthetic worst case frames.
+
+    Usage: linebenchmark [repetitions] [image width] [image height]
+
+    Each kind of frame is generated with 100 to 1600 white line points, and the mean and worst time of
+    FindFieldLines is printed in ms along with the number of lines it found per frame. The frames are
+        - field lines: a few long straight lines, each with a point every few pixels, and some noise
+        - scan line clutter: points scattered along every vertical and horizontal scan line
+        - random: points scattered uniformly over the image
+        - random, right to left: the same, but in right to left order, which was the worst case for the
+          search before it used the point grid, because it relied on the points being in scan order
+    The image size and scan spacing are those of the robot (320x240 and width/20) unless given.
+    Use a build with NUBOT_BUILD_LINE_BENCHMARK ON.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Vision/LineDetection.h"
+
+#include "debug.h"
+
+#include <time.h>
+#include <cstdlib>
+#include <iomanip>
+#include <algorithm>
+using namespace std;
+
+ofstream debug;
+ofstream errorlog;
+
+/*! @brief The kinds of synthetic frame */
+enum FrameType
+{
+    FieldLines,
+    ScanLineClutter,
+    Random,
+    RandomRightToLeft,
+    NumFrameTypes
+};
+
+static const char* FrameNames[NumFrameTypes] = {"field lines", "scan line clutter", "random", "random, right to left"};
+
+/*! @brief Runs the private line search of LineDetection on a synthetic frame */
+class LineDetectionBenchmark
+{
+public:
+    /*! @brief Times FindFieldLines on one frame
+        @param points the white line points of the frame
+        @param lines will be updated with the number of lines found
+        @return the time taken in ms
+     */
+    static double run(const vector<LinePoint>& points, int width, int height, int spacing, int& lines)
+    {
+        LineDetection detection;
+        detection.LINE_SEARCH_GRID_SIZE = spacing/4;
+        detection.linePoints = points;
+        double start = now();
+        detection.FindFieldLines(width, height);
+        double stop = now();
+        lines = detection.fieldLines.size();
+        return stop - start;
+    }
+private:
+    /*! @brief Returns the current monotonic time in ms */
+    static double now()
+    {
+        struct timespec t;
+        clock_gettime(CLOCK_MONOTONIC, &t);
+        return 1e3*t.tv_sec + 1e-6*t.tv_nsec;
+    }
+};
+
+static bool RightToLeft(const LinePoint& a, const LinePoint& b)
+{
+    return a.x > b.x;
+}
+
+/*! @brief Generates the white line points of a synthetic frame */
+static void generate(FrameType type, int numpoints, int width, int height, int spacing, vector<LinePoint>& points)
+{
+    points.clear();
+    while (static_cast<int>(points.size()) < numpoints)
+    {
+        LinePoint point;
+        point.width = 2;
+        int i = points.size();
+        switch (type)
+        {
+            case FieldLines:
+                if (i % 10 == 0)
+                {   // one point in ten is noise
+                    point.x = rand() % width;
+                    point.y = rand() % height;
+                }
+                else
+                {   // the rest are on one of four lines crossing the image
+                    int line = i % 4;
+                    float t = static_cast<float>(rand())/RAND_MAX;
+                    point.x = t*(width - 1);
+                    point.y = (0.2 + 0.2*line)*height + (line - 1.5)*0.1*t*height;
+                }
+                break;
+            case ScanLineClutter:
+                if (i % 2)
+                {
+                    point.x = (rand() % (width/spacing))*spacing;
+                    point.y = rand() % height;
+                }
+                else
+                {
+                    point.x = rand() % width;
+                    point.y = (rand() % (height/spacing))*spacing;
+                }
+                break;
+            default:
+                point.x = rand() % width;
+                point.y = rand() % height;
+                break;
+        }
+        points.push_back(point);
+    }
+    if (type == RandomRightToLeft)
+        stable_sort(points.begin(), points.end(), RightToLeft);
+}
+
+int main(int argc, const char *argv[])
+{
+    debug.open("linebenchmarkdebug.log");
+    errorlog.open("linebenchmarkerror.log");
+
+    int repetitions = argc > 1 ? atoi(argv[1]) : 20;
+    int width = argc > 2 ? atoi(argv[2]) : 320;
+    int height = argc > 3 ? atoi(argv[3]) : 240;
+    int spacing = width/20;
+    if (repetitions <= 0 or spacing < 4 or height < spacing)
+    {
+        cerr << "linebenchmark: the repetitions must be positive, and the image at least 80x" << spacing << endl;
+        return 1;
+    }
+
+    cout << setprecision(3) << fixed;
+    cout << "FindFieldLines, " << width << "x" << height << " with a scan spacing of " << spacing << ", " << repetitions << " frames each" << endl;
+    vector<LinePoint> points;
+    for (int type = 0; type < NumFrameTypes; type++)
+    {
+        cout << FrameNames[type] << endl;
+        for (int numpoints = 100; numpoints <= 1600; numpoints *= 2)
+        {
+            double total = 0;
+            double worst = 0;
+            int totallines = 0;
+            srand(1);
+            for (int i = 0; i < repetitions; i++)
+            {
+                generate(static_cast<FrameType>(type), numpoints, width, height, spacing, points);
+                int lines;
+                double time = LineDetectionBenchmark::run(points, width, height, spacing, lines);
+                total += time;
+                worst = max(worst, time);
+                totallines += lines;
+            }
+            cout << "    " << setw(5) << numpoints << " points: mean " << total/repetitions << " ms worst " << worst << " ms, "
+                 << setprecision(1) << static_cast<double>(totallines)/repetitions << " lines" << setprecision(3) << endl;
+        }
+    }
+    return 0;
+}
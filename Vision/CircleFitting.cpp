@@ -24,15 +24,12 @@ const double EXTRA_DISTANCE_FRACTION = 0;//1.0/10.0;
 
 
 
-const int MAX_POINTS = 40;
-
-
-
 // Class constructor
 
 CircleFitting::CircleFitting() { 
 
-    fittedPoints.reserve(20); //RESERVE 20 SPOTs of MEMORY for ballPoints.
+    numFittedPoints = 0;
+    fittedPoints.reserve(MAX_FIT_POINTS);
 }
 
 
@@ -55,17 +52,10 @@ inline bool CircleFitting::CHECK_PIXEL(int pixel){
 
 
 
-Circle CircleFitting::FitCircleLMA(std::vector < Vector2<int> > points)
+// Fits a circle to the points. If maxPoints is not zero, larger point sets are evenly subsampled down to maxPoints.
+Circle CircleFitting::FitCircleLMA(const std::vector < Vector2<int> >& points, int maxPoints)
 {
-    numFittedPoints = points.size();
-    fittedPoints.empty();
-    for(int i = 0; i < numFittedPoints; i++)
-    {
-         point tempPoint;
-         tempPoint.x = points[i].x;
-         tempPoint.y = points[i].y;
-         fittedPoints.push_back(tempPoint);
-    }
+    LoadPoints(points, maxPoints);
 
   if (numFittedPoints > 5) {
     Circle algebraicCircle = AlgebraicCircleFit(); //! Generates an approximate centre using an algebraic approximation to the centre of the circle
@@ -83,6 +73,130 @@ Circle CircleFitting::FitCircleLMA(std::vector < Vector2<int> > points)
   return InvalidCircle();  
 }
 
+
+// Fits a circle after removing outliers with RANSAC. Use this for edge points which may include points that are not
+// on the circle, for example the edge of a robot or a field line touching the ball. inlierDistance is how close a
+// point must be to a hypothesised circle to support it, in the units of the points. The cost is bounded by
+// RANSAC_ITERATIONS*MAX_FIT_POINTS no matter how many points are given.
+Circle CircleFitting::FitCircleRANSAC(const std::vector < Vector2<int> >& points, double inlierDistance)
+{
+    LoadPoints(points, MAX_FIT_POINTS);
+
+    if (numFittedPoints >= RANSAC_MIN_POINTS)
+        RemoveOutliers(inlierDistance);
+
+    if (numFittedPoints > 5)
+        return AlgebraicCircleFit();
+
+    return InvalidCircle();
+}
+
+
+
+// Fits a circle to each of the first numSets sets of points with FitCircleRANSAC, reusing the same workspace for every fit.
+// circles is grown to hold at least numSets circles, so a caller that keeps it does not allocate again.
+void CircleFitting::FitCircles(const std::vector < std::vector < Vector2<int> > >& pointSets, unsigned int numSets, double inlierDistance, std::vector<Circle>& circles)
+{
+    if (circles.size() < numSets)
+        circles.resize(numSets);
+    for (unsigned int i = 0; i < numSets; i++)
+        circles[i] = FitCircleRANSAC(pointSets[i], inlierDistance);
+}
+
+
+
+// Copies the points into the fitted points. If maxPoints is not zero, larger sets are evenly subsampled down to maxPoints.
+void CircleFitting::LoadPoints(const std::vector < Vector2<int> >& points, int maxPoints)
+{
+    int numPoints = points.size();
+    numFittedPoints = (maxPoints > 0 && numPoints > maxPoints) ? maxPoints : numPoints;
+    fittedPoints.resize(numFittedPoints);
+    for (int i = 0; i < numFittedPoints; i++)
+    {
+        int j = (i*numPoints)/numFittedPoints;
+        fittedPoints[i].x = points[j].x;
+        fittedPoints[i].y = points[j].y;
+    }
+}
+
+
+
+// Keeps only the points supporting the best of RANSAC_ITERATIONS circles through three of the fitted points.
+// The three points are picked with a fixed seed so the result for a given set of points is repeatable.
+void CircleFitting::RemoveOutliers(double inlierDistance)
+{
+    unsigned int seed = 12345;
+    int bestSupport = 0;
+    Circle bestCircle;
+
+    for (int k = 0; k < RANSAC_ITERATIONS; k++)
+    {
+        int index[3];
+        for (int m = 0; m < 3; m++)
+        {
+            seed = seed*1103515245 + 12345;
+            index[m] = (seed >> 16) % numFittedPoints;
+        }
+        if (index[0] == index[1] || index[1] == index[2] || index[0] == index[2])
+            continue;
+
+        Circle hypothesis;
+        if (!ThreePointCircle(fittedPoints[index[0]], fittedPoints[index[1]], fittedPoints[index[2]], hypothesis))
+            continue;
+
+        int support = 0;
+        for (int i = 0; i < numFittedPoints; i++)
+        {
+            double dx = fittedPoints[i].x - hypothesis.centreX;
+            double dy = fittedPoints[i].y - hypothesis.centreY;
+            if (fabs(sqrt(dx*dx + dy*dy) - hypothesis.radius) <= inlierDistance)
+                support++;
+        }
+        if (support > bestSupport)
+        {
+            bestSupport = support;
+            bestCircle = hypothesis;
+        }
+    }
+
+    // Without a consensus of at least half the points keep them all, and leave it to the fit's sd to reject it
+    if (bestSupport <= 5 || 2*bestSupport < numFittedPoints)
+        return;
+
+    int numInliers = 0;
+    for (int i = 0; i < numFittedPoints; i++)
+    {
+        double dx = fittedPoints[i].x - bestCircle.centreX;
+        double dy = fittedPoints[i].y - bestCircle.centreY;
+        if (fabs(sqrt(dx*dx + dy*dy) - bestCircle.radius) <= inlierDistance)
+            fittedPoints[numInliers++] = fittedPoints[i];
+    }
+    numFittedPoints = numInliers;
+}
+
+
+
+// Calculates the circle through three points. Returns false if the points are colinear.
+bool CircleFitting::ThreePointCircle(const point& p1, const point& p2, const point& p3, Circle& circle)
+{
+    double bx = p2.x - p1.x, by = p2.y - p1.y;
+    double cx = p3.x - p1.x, cy = p3.y - p1.y;
+    double d = 2.0*(bx*cy - by*cx);
+    if (fabs(d) < 1e-9)
+        return false;
+
+    double b2 = bx*bx + by*by;
+    double c2 = cx*cx + cy*cy;
+    double ux = (cy*b2 - by*c2)/d;
+    double uy = (bx*c2 - cx*b2)/d;
+    circle.centreX = p1.x + ux;
+    circle.centreY = p1.y + uy;
+    circle.radius = sqrt(ux*ux + uy*uy);
+    circle.sd = 0;
+    circle.isDefined = true;
+    return true;
+}
+
 /*
 Circle CircleFitting::FitCircleLMF(uint8* image, Blob* ballBlob, int direction) {
 
@@ -150,8 +264,6 @@ Circle CircleFitting::AlgebraicCircleFit() {
 
     meanX = meanY = 0; // The mean values represent the offset from the original postion in the image
 
-    std::vector<point> centredPoints;
-    centredPoints.reserve(fittedPoints.size());
 
 
   // Sum all the elements in the array
@@ -174,18 +286,6 @@ Circle CircleFitting::AlgebraicCircleFit() {
 
 
 
-	// Shift the data to the mean
-
-	for (int j=0; j < numFittedPoints; j++) {
-
-                point tempPoint;
-
-                tempPoint.x = fittedPoints[j].x - meanX;
-
-                tempPoint.y =fittedPoints[j].y - meanY;
-
-                centredPoints.push_back(tempPoint);
-	}
 
 
 
@@ -199,9 +299,9 @@ Circle CircleFitting::AlgebraicCircleFit() {
 
   for (int k=0; k < numFittedPoints; k++) {
 
-                Xi = centredPoints[k].x;
+                Xi = fittedPoints[k].x - meanX; // Shift the data to the mean
 
-                Yi = centredPoints[k].y;
+                Yi = fittedPoints[k].y - meanY;
 
 		Zi = Xi*Xi + Yi*Yi;
 
@@ -24,6 +24,12 @@
 
 #define LAMBDA_MAX 1000.0
 
+#define MAX_FIT_POINTS 40           // FitCircleRANSAC evenly subsamples larger point sets, so the cost of removing the outliers is bounded
+
+#define RANSAC_ITERATIONS 16        // the number of three point hypotheses tested when removing outliers
+
+#define RANSAC_MIN_POINTS 12        // smaller point sets are fitted without removing outliers
+
 
 /*
 struct Circle {
@@ -80,7 +86,11 @@ class CircleFitting {
     ~CircleFitting();
 
 
-    Circle FitCircleLMA(std::vector < Vector2<int> > points);
+    Circle FitCircleLMA(const std::vector < Vector2<int> >& points, int maxPoints = 0);
+
+    Circle FitCircleRANSAC(const std::vector < Vector2<int> >& points, double inlierDistance);
+
+    void FitCircles(const std::vector < std::vector < Vector2<int> > >& pointSets, unsigned int numSets, double inlierDistance, std::vector<Circle>& circles);
 
     //Circle FitCircleLMF(uint8* image, Blob* ballBlob, int direction);
 
@@ -88,7 +98,7 @@ class CircleFitting {
 
     int numFittedPoints; //  Stores the number of points found so far
 
-    std::vector<point> fittedPoints; // Stores the points which have been found so far
+    std::vector<point> fittedPoints; // Stores the points which have been found so far, reused for every fit
 
     int meanX, meanY; 
 
@@ -97,6 +107,12 @@ class CircleFitting {
 
 
 
+    void LoadPoints(const std::vector < Vector2<int> >& points, int maxPoints);
+
+    void RemoveOutliers(double inlierDistance);
+
+    bool ThreePointCircle(const point& p1, const point& p2, const point& p3, Circle& circle);
+
     Circle AlgebraicCircleFit();
 
     Circle GeometricCircleFitLMA(Circle initialCircle);
@@ -16,6 +16,15 @@ ClassifiedSection::~ClassifiedSection()
     return;
 }
 
+//! Removes all of the lines and segments, keeping their memory, and sets the direction for the next frame.
+void ClassifiedSection::reset(int newDirection)
+{
+    direction = newDirection;
+    scanLines.clear();
+    segments.clear();
+    return;
+}
+
 void ClassifiedSection::setDirection(int newDirection)
 {
     direction = newDirection;
@@ -30,6 +39,7 @@ int ClassifiedSection::getDirection()
 void ClassifiedSection::addScanLine(const ScanLine& line)
 {
     scanLines.push_back(line);
+    scanLines.back().setSegmentTable(&segments, scanLines.size() - 1);
     return;
 }
 ScanLine* ClassifiedSection::getScanLine(int position)
@@ -40,3 +50,8 @@ int ClassifiedSection::getNumberOfScanLines()
 {
     return scanLines.size();
 }
+
+SegmentTable* ClassifiedSection::getSegments()
+{
+    return &segments;
+}
@@ -3,10 +3,17 @@
 
 #include <vector>
 #include "ScanLine.h"
+#include "SegmentTable.h"
 
 
 
-
+//! The scan lines of one scan direction, and a single table of all of the segments found on them.
+/*!
+    Vision keeps its sections and resets them every frame, so that the lines and segments reuse
+    the memory from the previous frames. A section made during a frame (for a close classification)
+    is allocated from the current FrameArena instead. The lines refer to the section's table, so a
+    section can not be copied.
+  */
 class ClassifiedSection
 {
 
@@ -17,15 +24,22 @@ public:
     ClassifiedSection(int direction);
     ~ClassifiedSection();
 
+    void reset(int newDirection);
     void setDirection(int newDirection);
     int getDirection();
     void addScanLine(const ScanLine& line);
     ScanLine* getScanLine(int position);
     int getNumberOfScanLines();
+    SegmentTable* getSegments();
+
+private:
+    ClassifiedSection(const ClassifiedSection& other);
+    ClassifiedSection& operator=(const ClassifiedSection& other);
 
 private:
     int direction;
-    std::vector< ScanLine > scanLines;
+    FrameVector<ScanLine>::type scanLines;
+    SegmentTable segments;
 
 };
 
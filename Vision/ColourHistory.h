@@ -0,0 +1,96 @@
+/*!
+  @file ColourHistory.h
+  @brief Declaration of the ColourHistory class.
+  */
+
+#ifndef COLOURHISTORY_H
+#define COLOURHISTORY_H
+
+#include <vector>
+
+//! The last few colours seen along a scan line, kept as bit masks so that the usual questions are O(1).
+/*!
+    Instead of storing the colours themselves, the history stores one bit per colour: whether or not
+    it was in the colour set given to the constructor. So containsAny() (was any recent colour in the set)
+    is a single test of the mask. isAllSame() uses the length of the current run of identical colours.
+
+    The history is at most 32 colours long. The colour set is a 256-bit bitmap, so it works for any
+    classified colour.
+  */
+class ColourHistory
+{
+public:
+    //! Creates a history of the last length colours, with no colour set.
+    ColourHistory(unsigned int length)
+    {
+        init(length);
+    }
+
+    //! Creates a history of the last length colours, tested against the given set of colours.
+    ColourHistory(unsigned int length, const std::vector<unsigned char>& colours)
+    {
+        init(length);
+        for (unsigned int i = 0; i < colours.size(); i++)
+            m_colourSet[colours[i] >> 5] |= 1u << (colours[i] & 31);
+    }
+
+    //! Returns true if the colour is in the colour set.
+    inline bool isValid(unsigned char colour) const
+    {
+        return (m_colourSet[colour >> 5] >> (colour & 31)) & 1u;
+    }
+
+    //! Adds a colour to the history, forgetting the oldest one.
+    inline void push(unsigned char colour)
+    {
+        m_matches = ((m_matches << 1) | isValid(colour)) & m_mask;
+        if (colour == m_last && m_run < m_length)
+            m_run++;
+        else if (colour != m_last)
+        {
+            m_last = colour;
+            m_run = 1;
+        }
+    }
+
+    //! Replaces the entire history with a single colour.
+    inline void fill(unsigned char colour)
+    {
+        m_matches = isValid(colour) ? m_mask : 0;
+        m_last = colour;
+        m_run = m_length;
+    }
+
+    //! Returns true if any colour in the history is in the colour set.
+    inline bool containsAny() const
+    {
+        return m_matches != 0;
+    }
+
+    //! Returns true if every colour in the history is the same.
+    inline bool isAllSame() const
+    {
+        return m_run >= m_length;
+    }
+
+private:
+    void init(unsigned int length)
+    {
+        m_length = length > 32 ? 32 : length;
+        m_mask = m_length == 32 ? 0xFFFFFFFFu : (1u << m_length) - 1;
+        for (int i = 0; i < 8; i++)
+            m_colourSet[i] = 0;
+        m_matches = 0;
+        m_last = 0;
+        m_run = 0;
+    }
+
+    unsigned int m_length;          //!< the number of colours remembered
+    unsigned int m_mask;            //!< a mask with the lowest m_length bits set
+    unsigned int m_colourSet[8];    //!< a bitmap with a bit set for each colour in the set
+    unsigned int m_matches;         //!< bit i is set if the colour pushed i colours ago is in the set
+    unsigned char m_last;           //!< the most recent colour
+    unsigned int m_run;             //!< the number of times m_last has been pushed in a row, up to m_length
+};
+
+#endif // COLOURHISTORY_H
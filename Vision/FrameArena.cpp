@@ -0,0 +1,164 @@
+/*! @file FrameArena.cpp
+    @brief Implementation of FrameArena class
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "FrameArena.h"
+
+#include "debug.h"
+#include "debugverbosityvision.h"
+
+#include <stdlib.h>
+
+static __thread FrameArena* CurrentArena = NULL;        //!< the arena of the frame being processed by each thread
+
+/*! @brief Creates an arena
+    @param capacity the initial size of the block in bytes
+ */
+FrameArena::FrameArena(size_t capacity)
+{
+    m_capacity = align(capacity);
+    m_block = static_cast<char*>(malloc(m_capacity));
+    if (m_block == NULL)
+        m_capacity = 0;
+    m_used = 0;
+    m_overflow_used = 0;
+    m_high_water_mark = 0;
+    m_num_overflows = 0;
+}
+
+FrameArena::~FrameArena()
+{
+    for (size_t i=0; i<m_overflow.size(); i++)
+        free(m_overflow[i]);
+    free(m_block);
+}
+
+/*! @brief Returns bytes of memory aligned to FRAMEARENA_ALIGNMENT, that will be valid until the next reset */
+void* FrameArena::allocate(size_t bytes)
+{
+    bytes = align(bytes);
+    void* p;
+    if (m_capacity - m_used >= bytes)
+    {
+        p = m_block + m_used;
+        m_used += bytes;
+    }
+    else
+    {
+        p = malloc(bytes);
+        if (p == NULL)
+            throw std::bad_alloc();
+        m_overflow.push_back(p);
+        m_overflow_used += bytes;
+    }
+
+    // the peak is kept here rather than at the reset, because the temporaries are given back before then
+    if (m_used + m_overflow_used > m_high_water_mark)
+        m_high_water_mark = m_used + m_overflow_used;
+    return p;
+}
+
+/*! @brief Gives back memory before the next reset. Only the most recent allocation from the block is reused
+           before the reset; everything else is left until then.
+ */
+void FrameArena::deallocate(void* p, size_t bytes)
+{
+    char* c = static_cast<char*>(p);
+    if (c >= m_block and c + align(bytes) == m_block + m_used)
+        m_used = c - m_block;
+}
+
+/*! @brief Gives back everything allocated since the last reset. If the block overflowed it is regrown to hold it all. */
+void FrameArena::reset()
+{
+    if (not m_overflow.empty())
+    {
+        for (size_t i=0; i<m_overflow.size(); i++)
+            free(m_overflow[i]);
+        m_overflow.clear();
+        m_overflow_used = 0;
+        m_num_overflows++;
+
+        // leave some room, so a slightly busier frame does not overflow again
+        size_t capacity = align(m_high_water_mark + m_high_water_mark/4);
+        char* block = static_cast<char*>(malloc(capacity));
+        if (block != NULL)
+        {
+            free(m_block);
+            m_block = block;
+            m_capacity = capacity;
+        }
+        #if DEBUG_VISION_VERBOSITY > 0
+            debug << "FrameArena::reset(). The block overflowed, it is now " << m_capacity << " bytes. High water mark: " << m_high_water_mark << " bytes" << endl;
+        #endif
+    }
+    m_used = 0;
+}
+
+/*! @brief Returns the size of the block in bytes */
+size_t FrameArena::getCapacity() const
+{
+    return m_capacity;
+}
+
+/*! @brief Returns the number of bytes allocated since the last reset */
+size_t FrameArena::getUsed() const
+{
+    return m_used + m_overflow_used;
+}
+
+/*! @brief Returns the most bytes that have been allocated at once, including those from the heap */
+size_t FrameArena::getHighWaterMark() const
+{
+    return m_high_water_mark;
+}
+
+/*! @brief Returns the number of frames in which the block was too small, and the heap was used */
+unsigned int FrameArena::getNumOverflows() const
+{
+    return m_num_overflows;
+}
+
+/*! @brief Returns the arena that is current for the calling thread, or NULL if there is none */
+FrameArena* FrameArena::getCurrent()
+{
+    return CurrentArena;
+}
+
+/*! @brief Rounds bytes up to a multiple of FRAMEARENA_ALIGNMENT */
+size_t FrameArena::align(size_t bytes)
+{
+    return (bytes + FRAMEARENA_ALIGNMENT - 1) & ~static_cast<size_t>(FRAMEARENA_ALIGNMENT - 1);
+}
+
+/*! @brief Makes arena the current arena for the calling thread until the scope ends */
+FrameArena::Scope::Scope(FrameArena& arena) : m_arena(arena)
+{
+    m_previous = CurrentArena;
+    CurrentArena = &m_arena;
+}
+
+/*! @brief Resets the arena, and restores the previously current arena */
+FrameArena::Scope::~Scope()
+{
+    m_arena.reset();
+    CurrentArena = m_previous;
+}
+
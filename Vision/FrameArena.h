@@ -0,0 +1,146 @@
+/*! @file FrameArena.h
+    @brief Declaration of FrameArena class, and the FrameAllocator and FrameVector templates
+
+    @class FrameArena
+    @brief A linear allocator for the temporaries of a single frame
+
+    Memory is handed out by bumping a pointer through a single block, and is only given back all at once
+    when the arena is reset at the end of the frame; resetting only rewinds the pointer. When the block
+    runs out each further allocation comes from the heap, and at the next reset the block is regrown to
+    the high water mark, so after the first few frames every frame is served from the block.
+
+    The arena is made current for a thread with a FrameArena::Scope, which also resets it when the scope
+    ends. Anything allocated from the arena must be destroyed before then.
+
+    @class FrameAllocator
+    @brief An STL allocator that allocates from the FrameArena that was current when it was created
+
+    When no arena is current the allocator uses the heap, so the same containers can be used outside
+    of a frame (for example in NUview).
+
+    @class FrameVector
+    @brief Provides the type of a std::vector allocated from the current FrameArena, FrameVector<T>::type
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef FRAMEARENA_H
+#define FRAMEARENA_H
+
+#include <vector>
+#include <new>
+#include <cstddef>
+
+#define FRAMEARENA_DEFAULT_CAPACITY     (256*1024)          //!< the initial size of the block in bytes
+#define FRAMEARENA_ALIGNMENT            16                  //!< the alignment of every allocation in bytes
+
+class FrameArena
+{
+public:
+    explicit FrameArena(size_t capacity = FRAMEARENA_DEFAULT_CAPACITY);
+    ~FrameArena();
+
+    void* allocate(size_t bytes);
+    void deallocate(void* p, size_t bytes);
+    void reset();
+
+    size_t getCapacity() const;
+    size_t getUsed() const;
+    size_t getHighWaterMark() const;
+    unsigned int getNumOverflows() const;
+
+    static FrameArena* getCurrent();
+
+    class Scope
+    {
+    public:
+        Scope(FrameArena& arena);
+        ~Scope();
+    private:
+        Scope(const Scope&);
+        Scope& operator=(const Scope&);
+        FrameArena& m_arena;                //!< the arena made current by this scope
+        FrameArena* m_previous;             //!< the arena that was current before this scope
+    };
+private:
+    FrameArena(const FrameArena&);
+    FrameArena& operator=(const FrameArena&);
+    static size_t align(size_t bytes);
+
+    char* m_block;                          //!< the block allocations are bumped through
+    size_t m_capacity;                      //!< the size of m_block in bytes
+    size_t m_used;                          //!< the number of bytes of m_block in use
+    std::vector<void*> m_overflow;          //!< the allocations taken from the heap since the last reset, because the block was full
+    size_t m_overflow_used;                 //!< the number of bytes in m_overflow
+    size_t m_high_water_mark;               //!< the most bytes in use (including the overflow) at any time
+    unsigned int m_num_overflows;           //!< the number of frames in which the block was too small
+};
+
+template <class T> class FrameAllocator
+{
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    template <class U> struct rebind { typedef FrameAllocator<U> other; };
+
+    FrameAllocator() : m_arena(FrameArena::getCurrent()) {}
+    FrameAllocator(const FrameAllocator& other) : m_arena(other.m_arena) {}
+    template <class U> FrameAllocator(const FrameAllocator<U>& other) : m_arena(other.getArena()) {}
+
+    pointer address(reference x) const {return &x;}
+    const_pointer address(const_reference x) const {return &x;}
+    size_type max_size() const {return size_t(-1)/sizeof(T);}
+
+    pointer allocate(size_type n, const void* hint = 0)
+    {
+        if (m_arena != NULL)
+            return static_cast<pointer>(m_arena->allocate(n*sizeof(T)));
+        else
+            return static_cast<pointer>(::operator new(n*sizeof(T)));
+    }
+    void deallocate(pointer p, size_type n)
+    {
+        if (m_arena != NULL)
+            m_arena->deallocate(p, n*sizeof(T));
+        else
+            ::operator delete(p);
+    }
+    void construct(pointer p, const T& value) {new (static_cast<void*>(p)) T(value);}
+    void destroy(pointer p) {p->~T();}
+
+    FrameArena* getArena() const {return m_arena;}
+private:
+    FrameArena* m_arena;                    //!< the arena to allocate from, or NULL to use the heap
+};
+
+template <class T, class U> inline bool operator==(const FrameAllocator<T>& a, const FrameAllocator<U>& b) {return a.getArena() == b.getArena();}
+template <class T, class U> inline bool operator!=(const FrameAllocator<T>& a, const FrameAllocator<U>& b) {return a.getArena() != b.getArena();}
+
+template <class T> class FrameVector
+{
+public:
+    typedef std::vector<T, FrameAllocator<T> > type;
+};
+
+#endif
+
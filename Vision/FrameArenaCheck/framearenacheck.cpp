@@ -0,0 +1,390 @@
+/*! @file framearenacheck.cpp
+    @brief The framearenacheck executable. Checks the FrameArena and the FrameAllocator.
+
+    Usage: framearenacheck [number of frames]
+
+    Each check makes its own small arena:
+        - allocate and deallocate: the allocations are aligned and do not overlap, the used bytes are counted
+          after alignment, and deallocating the most recent allocation (and only that one) gives it back
+        - reset: everything is given back, the block is reused from its start and it is not regrown
+        - overflow: allocations past the end of the block come from the heap, they are counted as used, and the
+          reset frees them and regrows the block to 1.25x the high water mark so that the same frame then fits
+        - high water mark: it is the most bytes used at any time, including the heap and allocations that were
+          given back before the reset, and it never goes down
+        - random frames (200 unless given): random allocations and deallocations against a model of the arena
+        - FrameAllocator: vectors use the arena that was current when they were made, the heap when there was
+          none, and the Scope restores the previous arena and resets its own
+
+    The number of checks and the number of failures are printed for each part, and the exit status is 1 if
+    there were any failures. Use a build with NUBOT_BUILD_FRAME_ARENA_CHECK ON.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Vision/FrameArena.h"
+
+#include "debug.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+ofstream debug;
+ofstream errorlog;
+
+#define MAX_REPORTED_FAILURES 5                 //!< the number of failures of each check that are printed in full
+#define SMALL_CAPACITY 1024                     //!< the size in bytes of the block of the arenas that are checked
+
+/*! @brief The result of a single check */
+class CheckResult
+{
+public:
+    CheckResult(const string& name) : m_name(name), m_checked(0), m_failures(0) {}
+
+    /*! @brief Records a failure if ok is false
+        @param what a description of what was checked
+     */
+    void expect(bool ok, const string& what)
+    {
+        m_checked++;
+        if (ok)
+            return;
+        m_failures++;
+        if (m_failures <= MAX_REPORTED_FAILURES)
+            cout << "    " << m_name << ": " << what << endl;
+    }
+    /*! @brief Records a failure if value is not reference */
+    void compare(const string& what, size_t value, size_t reference)
+    {
+        ostringstream message;
+        message << what << " is " << value << " not " << reference;
+        expect(value == reference, message.str());
+    }
+    bool failed() const {return m_failures > 0;}
+    void print() const
+    {
+        cout << m_name << ": " << m_checked << " checks, " << m_failures << " failures" << endl;
+    }
+private:
+    string m_name;                          //!< the name of the check
+    long m_checked;                         //!< the number of expectations checked
+    long m_failures;                        //!< the number of failed expectations
+};
+
+/*! @brief Rounds bytes up to a multiple of FRAMEARENA_ALIGNMENT */
+static size_t aligned(size_t bytes)
+{
+    return (bytes + FRAMEARENA_ALIGNMENT - 1)/FRAMEARENA_ALIGNMENT*FRAMEARENA_ALIGNMENT;
+}
+
+/*! @brief Returns true if p is in the block that starts at base and is capacity bytes long */
+static bool inBlock(const void* p, const char* base, size_t capacity)
+{
+    const char* c = static_cast<const char*>(p);
+    return c >= base and c < base + capacity;
+}
+
+/*! @brief Checks allocate() and deallocate() within a single frame */
+static void checkAllocate(CheckResult& result)
+{
+    FrameArena arena(SMALL_CAPACITY);
+    result.compare("the capacity", arena.getCapacity(), SMALL_CAPACITY);
+    result.compare("the used bytes of a new arena", arena.getUsed(), 0);
+
+    const size_t sizes[] = {1, 16, 17, 3, 40, 0, 100};
+    const int numsizes = sizeof(sizes)/sizeof(sizes[0]);
+    char* p[numsizes];
+    size_t used = 0;
+    for (int i=0; i<numsizes; i++)
+    {
+        p[i] = static_cast<char*>(arena.allocate(sizes[i]));
+        result.expect(reinterpret_cast<size_t>(p[i]) % FRAMEARENA_ALIGNMENT == 0, "an allocation is not aligned");
+        if (i > 0)
+            result.expect(p[i] >= p[i-1] + sizes[i-1], "an allocation overlaps the one before it");
+        used += aligned(sizes[i]);
+        result.compare("the used bytes", arena.getUsed(), used);
+    }
+    memset(p[numsizes - 1], 0xFF, sizes[numsizes - 1]);
+
+    // only the most recent allocation is given back
+    arena.deallocate(p[2], sizes[2]);
+    result.compare("the used bytes after deallocating an old allocation", arena.getUsed(), used);
+    arena.deallocate(p[numsizes - 1], sizes[numsizes - 1]);
+    used -= aligned(sizes[numsizes - 1]);
+    result.compare("the used bytes after deallocating the newest allocation", arena.getUsed(), used);
+    char* again = static_cast<char*>(arena.allocate(sizes[numsizes - 1]));
+    result.expect(again == p[numsizes - 1], "the newest allocation was not reused after it was deallocated");
+
+    // a zero byte allocation takes no space, so deallocating it must not give back the one before it
+    arena.deallocate(p[5], sizes[5]);
+    result.compare("the used bytes after deallocating an empty allocation", arena.getUsed(), used + aligned(sizes[numsizes - 1]));
+
+    // deallocating from the newest backwards gives back everything
+    arena.deallocate(again, sizes[numsizes - 1]);
+    for (int i=numsizes - 2; i>=0; i--)
+        arena.deallocate(p[i], sizes[i]);
+    result.compare("the used bytes after deallocating every allocation in reverse", arena.getUsed(), 0);
+    result.compare("the number of overflows", arena.getNumOverflows(), 0);
+}
+
+/*! @brief Checks that reset() gives back everything, and reuses the block without regrowing it */
+static void checkReset(CheckResult& result)
+{
+    FrameArena arena(SMALL_CAPACITY);
+    char* base = static_cast<char*>(arena.allocate(100));
+    arena.allocate(200);
+    arena.allocate(300);
+    size_t used = aligned(100) + aligned(200) + aligned(300);
+    arena.reset();
+    result.compare("the used bytes after a reset", arena.getUsed(), 0);
+    result.compare("the capacity after a reset without overflow", arena.getCapacity(), SMALL_CAPACITY);
+    result.compare("the number of overflows after a reset without overflow", arena.getNumOverflows(), 0);
+    result.compare("the high water mark after the first reset", arena.getHighWaterMark(), used);
+    result.expect(arena.allocate(8) == base, "the block was not reused from its start after a reset");
+
+    // every byte of the block can be used
+    arena.reset();
+    void* all = arena.allocate(SMALL_CAPACITY);
+    result.expect(all == base, "the whole block was not given to a single allocation");
+    result.compare("the used bytes of a full block", arena.getUsed(), SMALL_CAPACITY);
+    arena.reset();
+    result.compare("the number of overflows after exactly filling the block", arena.getNumOverflows(), 0);
+    result.compare("the capacity after exactly filling the block", arena.getCapacity(), SMALL_CAPACITY);
+}
+
+/*! @brief Checks the overflow onto the heap, and the regrowing of the block at the next reset */
+static void checkOverflow(CheckResult& result)
+{
+    FrameArena arena(SMALL_CAPACITY);
+    char* base = static_cast<char*>(arena.allocate(SMALL_CAPACITY - 64));
+    char* last = static_cast<char*>(arena.allocate(64));
+    result.expect(inBlock(last, base, SMALL_CAPACITY), "the allocation that fills the block is not in it");
+
+    // the block is full, so these come from the heap
+    const size_t sizes[] = {1, 500, 2000, 33};
+    const int numsizes = sizeof(sizes)/sizeof(sizes[0]);
+    size_t used = SMALL_CAPACITY;
+    for (int i=0; i<numsizes; i++)
+    {
+        char* p = static_cast<char*>(arena.allocate(sizes[i]));
+        result.expect(not inBlock(p, base, SMALL_CAPACITY), "an allocation after the block was full is in the block");
+        memset(p, 0xFF, sizes[i]);
+        used += aligned(sizes[i]);
+        result.compare("the used bytes with overflow", arena.getUsed(), used);
+        arena.deallocate(p, sizes[i]);
+        result.compare("the used bytes after deallocating an overflow", arena.getUsed(), used);
+    }
+    result.compare("the capacity before the reset", arena.getCapacity(), SMALL_CAPACITY);
+
+    arena.reset();
+    size_t regrown = aligned(used + used/4);
+    result.compare("the high water mark after an overflow", arena.getHighWaterMark(), used);
+    result.compare("the number of overflows after an overflow", arena.getNumOverflows(), 1);
+    result.compare("the capacity after an overflow", arena.getCapacity(), regrown);
+    result.compare("the used bytes after an overflow", arena.getUsed(), 0);
+
+    // the same frame now fits in the block
+    base = static_cast<char*>(arena.allocate(SMALL_CAPACITY - 64));
+    arena.allocate(64);
+    for (int i=0; i<numsizes; i++)
+        result.expect(inBlock(arena.allocate(sizes[i]), base, regrown), "an allocation of the repeated frame is not in the regrown block");
+    arena.reset();
+    result.compare("the number of overflows after the repeated frame", arena.getNumOverflows(), 1);
+    result.compare("the capacity after the repeated frame", arena.getCapacity(), regrown);
+
+    // an arena without a block overflows on every allocation until its first reset
+    FrameArena empty(0);
+    result.compare("the capacity of an empty arena", empty.getCapacity(), 0);
+    char* p = static_cast<char*>(empty.allocate(10));
+    result.expect(p != NULL, "an empty arena did not allocate");
+    memset(p, 0xFF, 10);
+    empty.reset();
+    result.compare("the number of overflows of an empty arena", empty.getNumOverflows(), 1);
+    result.compare("the capacity of an empty arena after the reset", empty.getCapacity(), aligned(aligned(10) + aligned(10)/4));
+}
+
+/*! @brief Checks that the high water mark is the most bytes used at any time, and never goes down */
+static void checkHighWaterMark(CheckResult& result)
+{
+    FrameArena arena(SMALL_CAPACITY);
+    result.compare("the high water mark of a new arena", arena.getHighWaterMark(), 0);
+    arena.allocate(300);
+    result.compare("the high water mark before the first reset", arena.getHighWaterMark(), aligned(300));
+    arena.reset();
+    result.compare("the high water mark of the first frame", arena.getHighWaterMark(), aligned(300));
+    arena.allocate(100);
+    arena.reset();
+    result.compare("the high water mark after a smaller frame", arena.getHighWaterMark(), aligned(300));
+    arena.allocate(500);
+    void* p = arena.allocate(200);
+    arena.deallocate(p, 200);
+    arena.reset();
+    result.compare("the high water mark after a deallocation", arena.getHighWaterMark(), aligned(500) + aligned(200));
+    arena.reset();
+    arena.allocate(SMALL_CAPACITY);
+    arena.allocate(SMALL_CAPACITY);
+    arena.reset();
+    result.compare("the high water mark includes the overflow", arena.getHighWaterMark(), 2*SMALL_CAPACITY);
+}
+
+/*! @brief Checks random frames of allocations and deallocations against a model of the arena
+    @param numframes the number of frames
+ */
+static void checkRandomFrames(CheckResult& result, int numframes)
+{
+    FrameArena arena(SMALL_CAPACITY);
+    size_t highwatermark = 0;
+    unsigned int numoverflows = 0;
+    size_t capacity = SMALL_CAPACITY;
+    for (int frame=0; frame<numframes; frame++)
+    {
+        vector<char*> pointers;
+        vector<size_t> sizes;
+        vector<long> offsets;               // the offset of each allocation in the block, or -1 if it is from the heap
+        size_t blockused = 0;
+        size_t overflowused = 0;
+        int numallocations = rand() % 50;
+        for (int i=0; i<numallocations; i++)
+        {
+            if (not pointers.empty() and rand() % 4 == 0)
+            {   // give back the newest allocation, which is only reused if it is at the end of the block
+                arena.deallocate(pointers.back(), sizes.back());
+                if (offsets.back() >= 0 and offsets.back() + aligned(sizes.back()) == blockused)
+                    blockused = offsets.back();
+                pointers.pop_back();
+                sizes.pop_back();
+                offsets.pop_back();
+                result.compare("the used bytes after a deallocation", arena.getUsed(), blockused + overflowused);
+                continue;
+            }
+            size_t bytes = rand() % (frame < numframes/2 ? 200 : 20);
+            char* p = static_cast<char*>(arena.allocate(bytes));
+            memset(p, frame, bytes);
+            for (size_t j=0; j<pointers.size(); j++)
+                if (bytes > 0 and sizes[j] > 0 and p < pointers[j] + sizes[j] and pointers[j] < p + bytes)
+                    result.expect(false, "an allocation overlaps a live allocation");
+            if (capacity - blockused >= aligned(bytes))
+            {
+                offsets.push_back(blockused);
+                blockused += aligned(bytes);
+            }
+            else
+            {
+                offsets.push_back(-1);
+                overflowused += aligned(bytes);
+            }
+            pointers.push_back(p);
+            sizes.push_back(bytes);
+            result.compare("the used bytes", arena.getUsed(), blockused + overflowused);
+            if (blockused + overflowused > highwatermark)
+                highwatermark = blockused + overflowused;
+        }
+        if (overflowused > 0)
+        {
+            numoverflows++;
+            capacity = aligned(highwatermark + highwatermark/4);
+        }
+        arena.reset();
+        result.compare("the high water mark", arena.getHighWaterMark(), highwatermark);
+        result.compare("the number of overflows", arena.getNumOverflows(), numoverflows);
+        result.compare("the capacity", arena.getCapacity(), capacity);
+    }
+}
+
+/*! @brief Checks the FrameAllocator and the FrameArena::Scope */
+static void checkAllocator(CheckResult& result)
+{
+    result.expect(FrameArena::getCurrent() == NULL, "there is a current arena outside of every scope");
+    FrameVector<int>::type heap;
+    result.expect(heap.get_allocator().getArena() == NULL, "a vector made outside of every scope has an arena");
+
+    FrameArena outer(SMALL_CAPACITY);
+    FrameArena inner(SMALL_CAPACITY);
+    {
+        FrameArena::Scope outerscope(outer);
+        result.expect(FrameArena::getCurrent() == &outer, "the scope did not make its arena current");
+        FrameVector<int>::type values;
+        result.expect(values.get_allocator().getArena() == &outer, "a vector made in the scope does not use its arena");
+        values.reserve(10);
+        result.compare("the used bytes of the arena after reserving a vector", outer.getUsed(), aligned(10*sizeof(int)));
+        for (int i=0; i<10; i++)
+            values.push_back(i);
+        result.compare("the used bytes of the arena after filling the reserved vector", outer.getUsed(), aligned(10*sizeof(int)));
+
+        // the rebound allocator of a list uses the same arena
+        FrameVector<FrameVector<int>::type>::type nested(1, values);
+        result.expect(nested.get_allocator().getArena() == &outer, "a nested vector does not use the arena");
+        {
+            FrameArena::Scope innerscope(inner);
+            result.expect(FrameArena::getCurrent() == &inner, "the inner scope did not make its arena current");
+            FrameVector<int>::type innervalues(5, 1);
+            result.expect(innervalues.get_allocator().getArena() == &inner, "a vector made in the inner scope does not use its arena");
+            result.compare("the used bytes of the inner arena", inner.getUsed(), aligned(5*sizeof(int)));
+            // a vector made before the inner scope keeps using the outer arena
+            size_t outerused = outer.getUsed();
+            heap.push_back(1);
+            values.push_back(10);
+            result.expect(outer.getUsed() > outerused, "a vector made in the outer scope did not grow in its arena");
+        }
+        result.expect(FrameArena::getCurrent() == &outer, "the inner scope did not restore the outer arena");
+        result.compare("the used bytes of the inner arena after its scope", inner.getUsed(), 0);
+        result.compare("the high water mark of the inner arena after its scope", inner.getHighWaterMark(), aligned(5*sizeof(int)));
+        result.compare("the sum of the vector made in the outer scope", values.back() + values[9], 19);
+    }
+    result.expect(FrameArena::getCurrent() == NULL, "the outer scope did not restore there being no arena");
+    result.compare("the used bytes of the outer arena after its scope", outer.getUsed(), 0);
+    result.expect(outer.getHighWaterMark() > 0, "the outer scope did not reset its arena");
+    result.compare("the vector made outside of every scope", heap.size(), 1);
+}
+
+int main(int argc, const char *argv[])
+{
+    int numframes = 200;
+    if (argc > 1)
+        numframes = max(1, atoi(argv[1]));
+    srand(1);
+
+    CheckResult allocate("allocate() and deallocate()");
+    CheckResult reset("reset()");
+    CheckResult overflow("overflow and regrow");
+    CheckResult highwatermark("high water mark");
+    CheckResult randomframes("random frames");
+    CheckResult allocator("FrameAllocator and Scope");
+
+    checkAllocate(allocate);
+    checkReset(reset);
+    checkOverflow(overflow);
+    checkHighWaterMark(highwatermark);
+    checkRandomFrames(randomframes, numframes);
+    checkAllocator(allocator);
+
+    allocate.print();
+    reset.print();
+    overflow.print();
+    highwatermark.print();
+    randomframes.print();
+    allocator.print();
+
+    if (allocate.failed() or reset.failed() or overflow.failed() or highwatermark.failed() or randomframes.failed() or allocator.failed())
+        return 1;
+    else
+        return 0;
+}
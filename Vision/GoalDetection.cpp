@@ -7,6 +7,7 @@
 #include "Tools/Math/General.h"
 #include "Infrastructure/NUSensorsData/NUSensorsData.h"
 #include "Kinematics/Kinematics.h"
+#include <algorithm>
 //#include <QDebug>
 using namespace mathGeneral;
 
@@ -22,10 +23,10 @@ GoalDetection::~GoalDetection()
 }
 
 //! Finds the ball segments and groups updates the goal in fieldObjects (Vision is used to further classify the object)
-ObjectCandidate GoalDetection::FindGoal(std::vector <ObjectCandidate>& FO_Candidates,
-                                        std::vector<ObjectCandidate>& FO_AboveHorizonCandidates,
+ObjectCandidate GoalDetection::FindGoal(FrameVector<ObjectCandidate>::type& FO_Candidates,
+                                        FrameVector<ObjectCandidate>::type& FO_AboveHorizonCandidates,
                                         FieldObjects* AllObjects,
-                                        const std::vector< TransitionSegment > &horizontalSegments,
+                                        const FrameVector<TransitionSegment>::type &horizontalSegments,
                                         Vision* vision,int height,int width)
 {
         //! Set the Minimum goal width in pixels as a function of screen width
@@ -33,7 +34,7 @@ ObjectCandidate GoalDetection::FindGoal(std::vector <ObjectCandidate>& FO_Candid
         MINIMUM_GOAL_HEIGHT_IN_PIXELS = vision->getImageHeight()/6.2; //38pixels for 240 height = 8m range
 
         ObjectCandidate result;
-        vector < ObjectCandidate > ::iterator it;
+        FrameVector<ObjectCandidate>::type::iterator it;
         //qDebug()<< "Candidate Size[Before Extending Above Horizon]: " <<FO_Candidates.size() << "\t Above horizon: " << FO_AboveHorizonCandidates.size();
         //! Go through all the candidates: to find a possible goal
         for(it = FO_Candidates.begin(); it  < FO_Candidates.end(); )
@@ -91,7 +92,7 @@ bool GoalDetection::isObjectAPossibleGoal(const ObjectCandidate &PossibleGoal)
         if(PossibleGoal.getColour() == ClassIndex::shadow_blue || PossibleGoal.getColour() == ClassIndex::blue)
         {
             int blueSize = 0;
-            std::vector<TransitionSegment> segments = PossibleGoal.getSegments();
+            SegmentSpan segments = PossibleGoal.getSegments();
             for(unsigned int i = 0; i <segments.size(); i++ )
             {
                 if(segments[i].getColour() == ClassIndex::blue)
@@ -111,7 +112,7 @@ bool GoalDetection::isObjectAPossibleGoal(const ObjectCandidate &PossibleGoal)
         else if(PossibleGoal.getColour() == ClassIndex::yellow || PossibleGoal.getColour() == ClassIndex::yellow_orange)
         {
             int yellowSize = 0;
-            std::vector<TransitionSegment> segments = PossibleGoal.getSegments();
+            SegmentSpan segments = PossibleGoal.getSegments();
             for(unsigned int i = 0; i <segments.size(); i++ )
             {
                 if(segments[i].getColour() == ClassIndex::yellow)
@@ -139,8 +140,8 @@ bool GoalDetection::isObjectAPossibleGoal(const ObjectCandidate &PossibleGoal)
 
 
 void GoalDetection::ExtendGoalAboveHorizon(ObjectCandidate* PossibleGoal,
-                                           std::vector<ObjectCandidate>& FO_AboveHorizonCandidates,
-                                           const std::vector < TransitionSegment > &horizontalSegments)
+                                           FrameVector<ObjectCandidate>::type& FO_AboveHorizonCandidates,
+                                           const FrameVector<TransitionSegment>::type &horizontalSegments)
 {
     Vector2<int> TopLeft = PossibleGoal->getTopLeft();
     Vector2<int> BottomRight = PossibleGoal->getBottomRight();
@@ -150,7 +151,7 @@ void GoalDetection::ExtendGoalAboveHorizon(ObjectCandidate* PossibleGoal,
     int margin = 16*1.5;
     if((int)FO_AboveHorizonCandidates.size() ==0) return;
 
-    vector < ObjectCandidate > ::iterator itAboveHorizon;
+    FrameVector<ObjectCandidate>::type::iterator itAboveHorizon;
     //debug << "AboveHoriCands:" << endl;
     for (itAboveHorizon = FO_AboveHorizonCandidates.begin(); itAboveHorizon < FO_AboveHorizonCandidates.end(); )
     {
@@ -179,7 +180,7 @@ void GoalDetection::ExtendGoalAboveHorizon(ObjectCandidate* PossibleGoal,
             PossibleGoal->setBottomRight(BottomRight);
             //ADD Above Horizon segments to Possible GOAL:
 
-            PossibleGoal->addSegments(itAboveHorizon->getSegments());
+            PossibleGoal->addSegments(*itAboveHorizon);
             itAboveHorizon = FO_AboveHorizonCandidates.erase(itAboveHorizon);
 
 
@@ -195,7 +196,7 @@ void GoalDetection::ExtendGoalAboveHorizon(ObjectCandidate* PossibleGoal,
 
     }
 /*    //SCANS UP THE IMAGE
-    std::vector<TransitionSegment>::reverse_iterator revIt = horizontalSegments.rbegin();
+    FrameVector<TransitionSegment>::type::reverse_iterator revIt = horizontalSegments.rbegin();
     for (; revIt != horizontalSegments.rend(); ++revIt)
     {
         //debug << "Crash Check: Access HZsegs: " << i;
@@ -264,7 +265,9 @@ void GoalDetection::classifyGoalClosely(ObjectCandidate* PossibleGoal,Vision* vi
     SegEnd.y = y;
     TransitionSegment tempSeg(SegStart,SegEnd,ClassIndex::unclassified,PossibleGoal->getColour(),ClassIndex::unclassified);
     //qDebug() << "segments (start): " << tempSeg.getStartPoint().x << "," << tempSeg.getStartPoint().y ;
-    ScanLine tempLine;
+    ClassifiedSection closeArea(ScanLine::RIGHT);
+    closeArea.addScanLine(ScanLine());
+    ScanLine* tempLine = closeArea.getScanLine(0);
 
     int spacings = vision->getScanSpacings()/2; //8
     int direction = ScanLine::RIGHT;
@@ -281,19 +284,19 @@ void GoalDetection::classifyGoalClosely(ObjectCandidate* PossibleGoal,Vision* vi
         colourlist.push_back(ClassIndex::shadow_blue);
     }
 
-    vision->CloselyClassifyScanline(&tempLine,&tempSeg,spacings, direction, colourlist);
+    vision->CloselyClassifyScanline(tempLine,&tempSeg,spacings, direction, colourlist);
 
     //qDebug() << "segments found: " << tempLine.getNumberOfSegments() ;
     //! Debug Output for small scans:
     int min = PossibleGoal->getTopLeft().y;
-    for(int i = 0; i < tempLine.getNumberOfSegments(); i++)
+    for(int i = 0; i < tempLine->getNumberOfSegments(); i++)
     {
-        TransitionSegment* tempSegment = tempLine.getSegment(i);
+        TransitionSegment tempSegment = tempLine->getSegment(i);
         //qDebug() << "segments (start): " << tempSeg.getStartPoint().x << "," << tempSeg.getStartPoint().y;
         //qDebug() << "segments (end): " << tempSeg.getEndPoint().x << "," << tempSeg.getEndPoint().y;
-        if(tempSegment->getStartPoint().y < min)
+        if(tempSegment.getStartPoint().y < min)
         {
-            min = tempSegment->getStartPoint().y;
+            min = tempSegment.getStartPoint().y;
         }
     }
     Vector2<int> tempTopLeft;
@@ -305,15 +308,15 @@ void GoalDetection::classifyGoalClosely(ObjectCandidate* PossibleGoal,Vision* vi
 
 }
 
-void GoalDetection::CombineOverlappingCandidates(std::vector <ObjectCandidate>& FO_Candidates)
+void GoalDetection::CombineOverlappingCandidates(FrameVector<ObjectCandidate>::type& FO_Candidates)
 {
 
-    vector < ObjectCandidate > ::iterator it;
+    FrameVector<ObjectCandidate>::type::iterator it;
     int boarder = 10;
     //! Go through all the candidates: to find overlapping and add to the bigger object candidate:
     for(it = FO_Candidates.begin(); it  < FO_Candidates.end();  )
     {
-        vector < ObjectCandidate > ::iterator itInside;
+        FrameVector<ObjectCandidate>::type::iterator itInside;
         for(itInside = it+1; itInside  < FO_Candidates.end(); )
         {
             //! CHECK INSIDE Object TOPLEFT is within outside Object
@@ -460,9 +463,9 @@ void GoalDetection::CombineOverlappingCandidates(std::vector <ObjectCandidate>&
 }
 
 
-void GoalDetection::CheckCandidateSizeRatio(std::vector< ObjectCandidate >& FO_Candidates,int height, int width)
+void GoalDetection::CheckCandidateSizeRatio(FrameVector<ObjectCandidate>::type& FO_Candidates,int height, int width)
 {
-    vector < ObjectCandidate > ::iterator it;
+    FrameVector<ObjectCandidate>::type::iterator it;
        //! Go through all the candidates: to find a possible goal
     for(it = FO_Candidates.begin(); it  < FO_Candidates.end(); )
     {
@@ -498,13 +501,13 @@ void GoalDetection::CheckCandidateSizeRatio(std::vector< ObjectCandidate >& FO_C
     return;
 }
 
-void GoalDetection::CheckIsFilled(std::vector< ObjectCandidate >& FO_Candidates, Vision* vision)
+void GoalDetection::CheckIsFilled(FrameVector<ObjectCandidate>::type& FO_Candidates, Vision* vision)
 {
     //Calculate the minimum size of horizontal scanlines
     //Add lengths of segments of these scanlines (be a multiple of width)
     //Add lengths of transition segments in object
     //Compare and throw out "small percentages"
-    vector < ObjectCandidate > ::iterator it;
+    FrameVector<ObjectCandidate>::type::iterator it;
     for(it =  FO_Candidates.begin(); it  < FO_Candidates.end(); )
     {
 
@@ -516,7 +519,7 @@ void GoalDetection::CheckIsFilled(std::vector< ObjectCandidate >& FO_Candidates,
 
         int maxScanLengthOfMinScanlines = minIntersectingScanlines * widthOfPossibleGoal;
 
-        vector<TransitionSegment> segments = it->getSegments();
+        SegmentSpan segments = it->getSegments();
         int lengthsOfSegments = 0;
         for(unsigned int i = 0; i < segments.size(); i++)
         {
@@ -568,9 +571,9 @@ bool GoalDetection::isCorrectCheckRatio(ObjectCandidate PossibleGoal,int height,
     }
 }
 
-void  GoalDetection::CheckCandidateIsInRobot(std::vector<ObjectCandidate>& FO_Candidates, FieldObjects* AllObjects)
+void  GoalDetection::CheckCandidateIsInRobot(FrameVector<ObjectCandidate>::type& FO_Candidates, FieldObjects* AllObjects)
 {
-    vector < ObjectCandidate > ::iterator it;
+    FrameVector<ObjectCandidate>::type::iterator it;
     bool objectRemoved;
 
        //! Go through all the candidates: to find a possible goal
@@ -618,9 +621,9 @@ void  GoalDetection::CheckCandidateIsInRobot(std::vector<ObjectCandidate>& FO_Ca
     return;
 }
 
-void GoalDetection::CheckObjectIsBelowHorizon(std::vector<ObjectCandidate>& FO_Candidates, Vision* vision)
+void GoalDetection::CheckObjectIsBelowHorizon(FrameVector<ObjectCandidate>::type& FO_Candidates, Vision* vision)
 {
-    vector < ObjectCandidate > ::iterator it;
+    FrameVector<ObjectCandidate>::type::iterator it;
     for(it = FO_Candidates.begin(); it  < FO_Candidates.end(); )
     {
         if((vision->m_horizonLine.IsBelowHorizon(it->getBottomRight().x, it->getBottomRight().y))== false)
@@ -642,7 +645,7 @@ void GoalDetection::CheckObjectIsBelowHorizon(std::vector<ObjectCandidate>& FO_C
 float GoalDetection::FindGoalDistance( const ObjectCandidate &PossibleGoal, Vision* vision)
 {
     float distance = 0.0;
-    std::vector < TransitionSegment > tempSegments = PossibleGoal.getSegments();
+    SegmentSpan tempSegments = PossibleGoal.getSegments();
     std::vector < Vector2<int> > midpoints, leftPoints, rightPoints;
     Vector2<int> tempStart, tempEnd;
     float pixelError = 0.0;
@@ -965,7 +968,7 @@ float GoalDetection::DistanceToPoint(const ObjectCandidate &PossibleGoal, Vision
     // I think Kinematics::DistanceToPoint should be a friend with the sensor data, and get the transform itself
     // Also will need to be updated when the sensor data can properly store kinematic data
     vector<float> ctgvector;
-    bool isOK = vision->getSensorsData()->get(NUSensorsData::CameraToGroundTransform, ctgvector); 
+    bool isOK = vision->getCameraToGroundTransform(ctgvector); 
     if(isOK == true)
     {
         Matrix camera2groundTransform = Matrix4x4fromVector(ctgvector);
@@ -990,7 +993,7 @@ float GoalDetection::DistanceLineToPoint(const LSFittedLine &midPointLine, const
     return distance;
 }
 
-void GoalDetection::SortObjectCandidates(std::vector<ObjectCandidate>& FO_Candidates)
+void GoalDetection::SortObjectCandidates(FrameVector<ObjectCandidate>::type& FO_Candidates)
 {
     /*for(unsigned int i = 0; i < FO_Candidates.size(); i++)
     {
@@ -1028,7 +1031,7 @@ void GoalDetection::UpdateAFieldObject(FieldObjects* AllObjects, Vision* vision,
     // I think Kinematics::DistanceToPoint should be a friend with the sensor data, and get the transform itself
     // Also will need to be updated when the sensor data can properly store kinematic data
     vector<float> ctvector;
-    bool isOK = vision->getSensorsData()->get(NUSensorsData::CameraTransform, ctvector);
+    bool isOK = vision->getCameraTransform(ctvector);
     if(isOK == true)
     {
         Matrix cameraTransform = Matrix4x4fromVector(ctvector);
@@ -1214,7 +1217,7 @@ void GoalDetection::AddAmbiguousGoalPost(ObjectCandidate* GoalPost, FieldObjects
     Vector2<float> screenPositionAngle(sphericalPosition[1], sphericalPosition[2]);
     
     vector<float> ctvector;
-    bool isOK = vision->getSensorsData()->get(NUSensorsData::CameraTransform, ctvector);
+    bool isOK = vision->getCameraTransform(ctvector);
     if(isOK == true)
     {
         Matrix cameraTransform = Matrix4x4fromVector(ctvector);
@@ -1234,7 +1237,7 @@ void GoalDetection::AddAmbiguousGoalPost(ObjectCandidate* GoalPost, FieldObjects
     AllObjects->ambiguousFieldObjects.push_back(newAmbObj);
 }
 
-void GoalDetection::UpdateGoalObjects(vector < ObjectCandidate > FO_Candidates, FieldObjects* AllObjects, Vision* vision)
+void GoalDetection::UpdateGoalObjects(FrameVector<ObjectCandidate>::type FO_Candidates, FieldObjects* AllObjects, Vision* vision)
 {
 
     if(FO_Candidates.size() >= 2 && FO_Candidates[0].getCentreX() < FO_Candidates[1].getCentreX() )
@@ -1313,7 +1316,7 @@ void GoalDetection::UpdateGoalObjects(vector < ObjectCandidate > FO_Candidates,
         }
     }
     //qDebug()<< "Finisihed Updating FO: Posts";
-    vector < ObjectCandidate > ::iterator it;
+    FrameVector<ObjectCandidate>::type::iterator it;
     for (it = FO_Candidates.begin(); it  < FO_Candidates.end(); )
     {
         //! SKIP first 2 objects if greater then size is greater or equal then 2!
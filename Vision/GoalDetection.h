@@ -14,10 +14,10 @@ class GoalDetection
         GoalDetection();
         ~GoalDetection();
 
-        ObjectCandidate FindGoal(std::vector<ObjectCandidate>& FO_Candidates,
-                                 std::vector<ObjectCandidate>& FO_AboveHorizonCandidates,
+        ObjectCandidate FindGoal(FrameVector<ObjectCandidate>::type& FO_Candidates,
+                                 FrameVector<ObjectCandidate>::type& FO_AboveHorizonCandidates,
 			FieldObjects* AllObjects,
-                        const std::vector < TransitionSegment > &horizontalSegments,
+                        const FrameVector<TransitionSegment>::type &horizontalSegments,
                         Vision* vision,
                         int height,
                         int width);
@@ -28,24 +28,24 @@ class GoalDetection
   private:
 
         void ExtendGoalAboveHorizon(ObjectCandidate* PossibleGoal,
-                                    std::vector<ObjectCandidate>& FO_AboveHorizonCandidates,
-                                    const std::vector < TransitionSegment > &horizontalSegments);
+                                    FrameVector<ObjectCandidate>::type& FO_AboveHorizonCandidates,
+                                    const FrameVector<TransitionSegment>::type &horizontalSegments);
 
         bool isObjectAPossibleGoal(const ObjectCandidate &PossibleGoal);
 
-        void CheckIsFilled(std::vector< ObjectCandidate >& FO_Candidates, Vision* vision);
+        void CheckIsFilled(FrameVector<ObjectCandidate>::type& FO_Candidates, Vision* vision);
 
         void classifyGoalClosely(ObjectCandidate* PossibleGoal,Vision* vision);
 
-        void CombineOverlappingCandidates(std::vector<ObjectCandidate>& FO_Candidates);
+        void CombineOverlappingCandidates(FrameVector<ObjectCandidate>::type& FO_Candidates);
 
-        void CheckCandidateSizeRatio(std::vector<ObjectCandidate>& FO_Candidates,int height,int width);
+        void CheckCandidateSizeRatio(FrameVector<ObjectCandidate>::type& FO_Candidates,int height,int width);
 
         bool isCorrectCheckRatio(ObjectCandidate PossibleGoal,int height,int width);
 
-        void CheckCandidateIsInRobot(std::vector<ObjectCandidate>& FO_Candidates, FieldObjects* AllObjects);
+        void CheckCandidateIsInRobot(FrameVector<ObjectCandidate>::type& FO_Candidates, FieldObjects* AllObjects);
 
-        void CheckObjectIsBelowHorizon(std::vector<ObjectCandidate>& FO_Candidates, Vision* vision);
+        void CheckObjectIsBelowHorizon(FrameVector<ObjectCandidate>::type& FO_Candidates, Vision* vision);
 
         float FindGoalDistance(const ObjectCandidate &PossibleGoal, Vision* vision);
         float DistanceToPoint(const ObjectCandidate &PossibleGoal, Vision* vision);
@@ -53,7 +53,7 @@ class GoalDetection
         float DistanceLineToPoint(const LSFittedLine &midPointLine, const Vector2<int> &point);
 
         //! SORTING: BIGGEST TO SMALLEST
-        void SortObjectCandidates(std::vector<ObjectCandidate>& FO_Candidates);
+        void SortObjectCandidates(FrameVector<ObjectCandidate>::type& FO_Candidates);
         static bool ObjectCandidateSizeSortPredicate(const ObjectCandidate& goal1, const ObjectCandidate& goal2);
 
 
@@ -64,7 +64,7 @@ class GoalDetection
 
 
         //! FieldObject Updating Functions
-        void UpdateGoalObjects(vector < ObjectCandidate > FO_Candidates, FieldObjects* AllObjects, Vision* vision);
+        void UpdateGoalObjects(FrameVector<ObjectCandidate>::type FO_Candidates, FieldObjects* AllObjects, Vision* vision);
 
         void UpdateAFieldObject(FieldObjects* AllObjects,Vision* vision, ObjectCandidate* GoalPost ,  int ID, Vector3<float> sphericalPosition);
 
@@ -26,11 +26,48 @@
 #include "debugverbosityvision.h"
 
 #include <ctime>
+#include <algorithm>
 
 #if TARGET_OS_IS_WINDOWS
     #include <QDebug>
 #endif
 
+/*! @brief Orders linePoints indices from left to right (horizontal) or from top to bottom (vertical).
+           Ties are broken by the other coordinate, and then by the index so that the order is deterministic.
+ */
+class LinePointOrder
+{
+public:
+    LinePointOrder(const std::vector<LinePoint>& points, bool horizontal) : m_points(points), m_horizontal(horizontal) {};
+    bool operator()(int a, int b) const
+    {
+        const LinePoint& pa = m_points[a];
+        const LinePoint& pb = m_points[b];
+        if (m_horizontal)
+        {
+            if (pa.x != pb.x) return pa.x < pb.x;
+            if (pa.y != pb.y) return pa.y < pb.y;
+        }
+        else
+        {
+            if (pa.y != pb.y) return pa.y < pb.y;
+            if (pa.x != pb.x) return pa.x < pb.x;
+        }
+        return a < b;
+    }
+private:
+    const std::vector<LinePoint>& m_points;
+    bool m_horizontal;
+};
+
+/*! @brief Returns true if line a is further left than line b. Invalid lines are put after all of the valid ones. */
+static bool LeftPointLessThan(const LSFittedLine& a, const LSFittedLine& b)
+{
+    if (a.valid != b.valid)
+        return a.valid;
+    return a.leftPoint.x < b.leftPoint.x;
+}
+
 LineDetection::LineDetection(){
 
     //Reserving Space for Vector Elements
@@ -38,6 +75,9 @@ LineDetection::LineDetection(){
     fieldLines.reserve(MAX_FIELDLINES);
     cornerPoints.reserve(MAX_CORNERPOINTS);
     TotalValidLines = 0;
+    pointGridSize = 1;
+    pointGridColumns = 0;
+    pointGridRows = 0;
 }
 
 LineDetection::~LineDetection(){
@@ -183,8 +223,8 @@ void LineDetection::FormLines(FieldObjects* AllObjects, Vision* vision, NUSensor
 void LineDetection::FormLines(FieldObjects* AllObjects,
                               Vision* vision,
                               NUSensorsData* data,
-                              vector< ObjectCandidate >& candidates,
-                              vector< TransitionSegment>& leftoverPoints) {
+                              FrameVector<ObjectCandidate>::type& candidates,
+                              FrameVector<TransitionSegment>::type& leftoverPoints) {
 
 
     //Setting up the variables:
@@ -204,17 +244,24 @@ void LineDetection::FormLines(FieldObjects* AllObjects,
     //get clusters
     vector< vector<LinePoint*> > clusters;
     vector< LinePoint* > leftover;
+    //The points are stored in clusterPoints for the rest of the frame, it is sized before any pointers are taken
+    unsigned int numpoints = leftoverPoints.size();
+    for(unsigned int i=0; i<candidates.size(); i++)
+        numpoints += candidates[i].getSegments().size();
+    clusterPoints.clear();
+    clusterPoints.resize(numpoints);
+    unsigned int nextpoint = 0;
     //temps
-    vector< TransitionSegment > tempseg;
     LinePoint* temppoint;
-    vector<LinePoint*> tempcluster;
+    clusters.resize(candidates.size());
     for(unsigned int i=0; i<candidates.size(); i++) {
         //For each ObjectCandidate create vector of linepoints and add it to clusters
-        tempseg = candidates[i].getSegments();
-        tempcluster.clear();
+        SegmentSpan tempseg = candidates[i].getSegments();
+        vector<LinePoint*>& tempcluster = clusters[i];
+        tempcluster.reserve(tempseg.size());
         for(unsigned int k=0; k<tempseg.size(); k++) {
             //For each segment create a new linepoint and push it to a vector
-            temppoint = new LinePoint();
+            temppoint = &clusterPoints[nextpoint++];
             temppoint->x = (double)tempseg[k].getMidPoint().x;
             temppoint->y = (double)tempseg[k].getMidPoint().y;
             /*
@@ -224,12 +271,12 @@ void LineDetection::FormLines(FieldObjects* AllObjects,
             */
             tempcluster.push_back(temppoint);
         }
-        clusters.push_back(tempcluster);
     }
 
     //get leftover points
+    leftover.reserve(leftoverPoints.size());
     for(unsigned int i=0; i<leftoverPoints.size(); i++) {
-        temppoint = new LinePoint();
+        temppoint = &clusterPoints[nextpoint++];
         temppoint->x = (double)leftoverPoints[i].getMidPoint().x;
         temppoint->y = (double)leftoverPoints[i].getMidPoint().y;
         /*
@@ -305,8 +352,8 @@ void LineDetection::FormLines(FieldObjects* AllObjects,
     Profiler prof("SHANNON");
     prof.start();
 
-    SAM::initRules(2.0,2,3,3,12.0,0.999);
-    SAM::splitAndMergeLSClusters(lines, clusters, leftover, vision, this, true, true, false);
+    splitAndMerge.initRules(2.0,2,3,3,12.0,0.999);
+    splitAndMerge.splitAndMergeLSClusters(lines, clusters, leftover, vision, this, true, true, false);
 
     prof.split("SAM");
 
@@ -354,6 +401,7 @@ void LineDetection::FormLines(FieldObjects* AllObjects,
         //qDebug() << "line " << lineno << " MSD: " << fieldLines.back().getMSD() << " R^2: " << fieldLines.back().getr2tls();
         sumMSD += fieldLines.back().getMSD();
         sumR2 += fieldLines.back().getr2tls();
+        delete lines.back();
         lines.pop_back();
     }
 
@@ -406,7 +454,9 @@ void LineDetection::FindLineOrRobotPoints(ClassifiedSection* scanArea,Vision* vi
         }
     }
     //! Find the LinePoints:
-    TransitionSegment* previouslyCloselyScanedSegment = NULL;
+    TransitionSegment previouslyCloselyScanedSegment;
+    bool hasPreviouslyCloselyScanedSegment = false;
+    ClassifiedSection closeArea(ScanLine::DOWN);    // the line and segments of the current close classification
     for(int i = 0; i< numberOfLines; i++)
     {
 
@@ -416,31 +466,32 @@ void LineDetection::FindLineOrRobotPoints(ClassifiedSection* scanArea,Vision* vi
             robotSegmentIsUsed = false;
             if(linePoints.size() > MAX_LINEPOINTS) break;
             //if(scanArea->getScanLine(i)->getLength() < maxLengthOfScanLine/1.5) continue;
-            TransitionSegment* segment = scanArea->getScanLine(i)->getSegment(j);
-            if(segment->getColour() == ClassIndex::pink || segment->getColour() == ClassIndex::shadow_blue || segment->getColour() == ClassIndex::pink_orange || segment->getColour() == ClassIndex::blue)
+            TransitionSegment segment = scanArea->getScanLine(i)->getSegment(j);
+            if(segment.getColour() == ClassIndex::pink || segment.getColour() == ClassIndex::shadow_blue || segment.getColour() == ClassIndex::pink_orange || segment.getColour() == ClassIndex::blue)
             {
                 robotSegmentIsUsed = true;
-                robotSegments.push_back(*segment);
+                robotSegments.push_back(segment);
             }
-            if(segment->getColour() != ClassIndex::white) continue;
+            if(segment.getColour() != ClassIndex::white) continue;
             bool segmentisused = false;
-            if(previouslyCloselyScanedSegment == NULL)
+            if(!hasPreviouslyCloselyScanedSegment)
             {
                 //qDebug() << "Assigning First Previous SEgment";
                 previouslyCloselyScanedSegment = segment;
+                hasPreviouslyCloselyScanedSegment = true;
             }
-            //int segmentSize = segment->getSize();
+            //int segmentSize = segment.getSize();
             //! CHECK The Length of the segment
-            if(segment->getSize() < MIN_POINT_THICKNESS) continue;
+            if(segment.getSize() < MIN_POINT_THICKNESS) continue;
 
 
             //! LOOKING FOR HORIZONTAL LINE POINTS:
-            if(segment->getSize() > VERT_POINT_THICKNESS*0.5 &&
-               fabs(previouslyCloselyScanedSegment->getStartPoint().x - segment->getStartPoint().x) >=LINE_SEARCH_GRID_SIZE*2)
+            if(segment.getSize() > VERT_POINT_THICKNESS*0.5 &&
+               fabs(previouslyCloselyScanedSegment.getStartPoint().x - segment.getStartPoint().x) >=LINE_SEARCH_GRID_SIZE*2)
             {
                 //! CHECK the LEFT AND RIGHT Pixels
-                int MidX = (int) (segment->getStartPoint().x + segment->getEndPoint().x)/2;
-                int MidY = (int) (segment->getEndPoint().y+segment->getStartPoint().y)/2;
+                int MidX = (int) (segment.getStartPoint().x + segment.getEndPoint().x)/2;
+                int MidY = (int) (segment.getEndPoint().y+segment.getStartPoint().y)/2;
                 int LEFTX = 0;
                 int RIGHTX = 0;
                 if (MidX + VERT_POINT_THICKNESS *1.2> image_width)
@@ -464,52 +515,54 @@ void LineDetection::FindLineOrRobotPoints(ClassifiedSection* scanArea,Vision* vi
                 if(LeftColour == ClassIndex::white || RightColour  == ClassIndex::white)
                 {
                     robotSegmentIsUsed = true;
-                    robotSegments.push_back(*segment);
+                    robotSegments.push_back(segment);
                 }
                 if( (LeftColour == ClassIndex::green && RightColour != ClassIndex::white)
                    || (LeftColour != ClassIndex::white && RightColour == ClassIndex::green)
-                   //&& segment->getAfterColour() == ClassIndex::green
-                   //&& segment->getBeforeColour() == ClassIndex::green
+                   //&& segment.getAfterColour() == ClassIndex::green
+                   //&& segment.getBeforeColour() == ClassIndex::green
                    )
                 {
-                    ScanLine tempScanLine;
+                    closeArea.reset(ScanLine::DOWN);
+                    closeArea.addScanLine(ScanLine());
+                    ScanLine* tempScanLine = closeArea.getScanLine(0);
                     previouslyCloselyScanedSegment = segment;
                     std::vector<unsigned char> colourlist;
                     colourlist.reserve(1);
                     colourlist.push_back(ClassIndex::white);
-                    vision->CloselyClassifyScanline(&tempScanLine,segment,8,ScanLine::DOWN,colourlist);
-                    ////qDebug()    << "After Closly Scan: "<<tempScanLine.getNumberOfSegments()
-                    //            << segment->getStartPoint().x << "," << segment->getStartPoint().y
+                    vision->CloselyClassifyScanline(tempScanLine,&segment,8,ScanLine::DOWN,colourlist);
+                    ////qDebug()    << "After Closly Scan: "<<tempScanLine->getNumberOfSegments()
+                    //            << segment.getStartPoint().x << "," << segment.getStartPoint().y
                     //            ;
 
 
-                    for (int k = 0; k < tempScanLine.getNumberOfSegments(); k++)
+                    for (int k = 0; k < tempScanLine->getNumberOfSegments(); k++)
                     {
-                        TransitionSegment* tempSeg = tempScanLine.getSegment(k);
-                        ////qDebug()<< k << ": \t" << tempSeg ->getBeforeColour() << "," << tempSeg ->getColour() << ","<<tempSeg ->getAfterColour()
-                        //        << "\t" << tempSeg->getSize() << tempSeg->getStartPoint().x << "," << tempSeg->getStartPoint().y;
-                        if(tempSeg->getSize() > HORZ_POINT_THICKNESS) continue;
+                        TransitionSegment tempSeg = tempScanLine->getSegment(k);
+                        ////qDebug()<< k << ": \t" << tempSeg.getBeforeColour() << "," << tempSeg.getColour() << ","<<tempSeg.getAfterColour()
+                        //        << "\t" << tempSeg.getSize() << tempSeg.getStartPoint().x << "," << tempSeg.getStartPoint().y;
+                        if(tempSeg.getSize() > HORZ_POINT_THICKNESS) continue;
                         //! Check Colour Conditions of segment
-                        if (  /*  ((ClassIndex::green   ==  tempSeg->getBeforeColour()) &&
-                                (ClassIndex::white   ==  tempSeg->getColour()) &&
-                                (ClassIndex::green   ==  tempSeg->getAfterColour())) ||
-                                ((ClassIndex::white   ==  tempSeg->getColour())
-                            &&  (tempSeg->getAfterColour() == ClassIndex::green && (tempSeg->getBeforeColour() == ClassIndex::unclassified || tempSeg->getBeforeColour() == ClassIndex::shadow_object) )
-                            &&  (tempSeg->getBeforeColour() == ClassIndex::green &&(tempSeg->getAfterColour() == ClassIndex::unclassified || tempSeg->getAfterColour() == ClassIndex::shadow_object ) ))*/
-                                (ClassIndex::white   ==  tempSeg->getColour())
-                                &&  ((tempSeg->getAfterColour() == ClassIndex::green || tempSeg->getAfterColour() == ClassIndex::unclassified) && (tempSeg->getBeforeColour() == ClassIndex::green || tempSeg->getBeforeColour() == ClassIndex::shadow_object || tempSeg->getBeforeColour() == ClassIndex::unclassified))
-                                &&  ((tempSeg->getBeforeColour() == ClassIndex::green || tempSeg->getBeforeColour() == ClassIndex::unclassified) && (tempSeg->getAfterColour() == ClassIndex::green ||  tempSeg->getAfterColour() == ClassIndex::shadow_object  || tempSeg->getAfterColour() == ClassIndex::unclassified)))
+                        if (  /*  ((ClassIndex::green   ==  tempSeg.getBeforeColour()) &&
+                                (ClassIndex::white   ==  tempSeg.getColour()) &&
+                                (ClassIndex::green   ==  tempSeg.getAfterColour())) ||
+                                ((ClassIndex::white   ==  tempSeg.getColour())
+                            &&  (tempSeg.getAfterColour() == ClassIndex::green && (tempSeg.getBeforeColour() == ClassIndex::unclassified || tempSeg.getBeforeColour() == ClassIndex::shadow_object) )
+                            &&  (tempSeg.getBeforeColour() == ClassIndex::green &&(tempSeg.getAfterColour() == ClassIndex::unclassified || tempSeg.getAfterColour() == ClassIndex::shadow_object ) ))*/
+                                (ClassIndex::white   ==  tempSeg.getColour())
+                                &&  ((tempSeg.getAfterColour() == ClassIndex::green || tempSeg.getAfterColour() == ClassIndex::unclassified) && (tempSeg.getBeforeColour() == ClassIndex::green || tempSeg.getBeforeColour() == ClassIndex::shadow_object || tempSeg.getBeforeColour() == ClassIndex::unclassified))
+                                &&  ((tempSeg.getBeforeColour() == ClassIndex::green || tempSeg.getBeforeColour() == ClassIndex::unclassified) && (tempSeg.getAfterColour() == ClassIndex::green ||  tempSeg.getAfterColour() == ClassIndex::shadow_object  || tempSeg.getAfterColour() == ClassIndex::unclassified)))
 
 
                         {
                                 //qDebug() << "Attempting to add point";
-                                Vector2<int> linepointposition= tempSeg->getMidPoint();
+                                Vector2<int> linepointposition= tempSeg.getMidPoint();
                                 //ADD A FIELD LINEPOINT!
 
 
 
                                 LinePoint tempLinePoint;
-                                tempLinePoint.width = tempSeg->getSize();
+                                tempLinePoint.width = tempSeg.getSize();
                                 tempLinePoint.x = linepointposition.x;
                                 tempLinePoint.y = linepointposition.y;
                                 tempLinePoint.inUse = false;
@@ -531,7 +584,7 @@ void LineDetection::FindLineOrRobotPoints(ClassifiedSection* scanArea,Vision* vi
                                     segmentisused = true;
                                     tempLinePoint.inUse = false;
                                     linePoints.push_back(tempLinePoint);
-                                    verticalLineSegments.push_back(*tempSeg);
+                                    verticalLineSegments.push_back(tempSeg);
                                     //qDebug() << "Added LinePoint to list: "<< tempLinePoint.x <<"," <<tempLinePoint.y << tempLinePoint.width;
                                 }
                             }
@@ -541,21 +594,21 @@ void LineDetection::FindLineOrRobotPoints(ClassifiedSection* scanArea,Vision* vi
 
             //CHECK COLOUR(GREEN-WHITE-GREEN Transistion)
             //CHECK COLOUR (U-W-G or G-W-U Transistion)
-            if(    ((ClassIndex::white   ==  segment->getColour()) &&
+            if(    ((ClassIndex::white   ==  segment.getColour()) &&
 
-                     ((segment->getAfterColour() == ClassIndex::green || segment->getAfterColour() == ClassIndex::unclassified)  && (segment->getBeforeColour() == ClassIndex::green
-                         || segment->getBeforeColour() == ClassIndex::shadow_object || segment->getBeforeColour() == ClassIndex::unclassified ) ))
+                     ((segment.getAfterColour() == ClassIndex::green || segment.getAfterColour() == ClassIndex::unclassified)  && (segment.getBeforeColour() == ClassIndex::green
+                         || segment.getBeforeColour() == ClassIndex::shadow_object || segment.getBeforeColour() == ClassIndex::unclassified ) ))
 
-                     && ((segment->getBeforeColour() == ClassIndex::green || segment->getBeforeColour() == ClassIndex::unclassified)  && (segment->getAfterColour() == ClassIndex::green
-                         || segment->getAfterColour() == ClassIndex::shadow_object || segment->getAfterColour() == ClassIndex::unclassified )) )
+                     && ((segment.getBeforeColour() == ClassIndex::green || segment.getBeforeColour() == ClassIndex::unclassified)  && (segment.getAfterColour() == ClassIndex::green
+                         || segment.getAfterColour() == ClassIndex::shadow_object || segment.getAfterColour() == ClassIndex::unclassified )) )
 
             {
                 //ADD A FIELD LINEPOINT!
-                Vector2<int>linepointposition = segment->getMidPoint();
+                Vector2<int>linepointposition = segment.getMidPoint();
 
 
                 LinePoint tempLinePoint;
-                tempLinePoint.width = (int)segment->getSize();
+                tempLinePoint.width = (int)segment.getSize();
                 tempLinePoint.x = linepointposition.x;
                 tempLinePoint.y = linepointposition.y;
                 tempLinePoint.inUse = false;
@@ -576,16 +629,16 @@ void LineDetection::FindLineOrRobotPoints(ClassifiedSection* scanArea,Vision* vi
                     segmentisused = true;
                     tempLinePoint.inUse = false;
                     linePoints.push_back(tempLinePoint);
-                    horizontalLineSegments.push_back(*segment);
+                    horizontalLineSegments.push_back(segment);
                 }
-                 ////qDebug() << "Found LinePoint (MidPoint): "<< (start.x + end.x) / 2 << ","<< (start.y+end.y)/2 << " Length: "<< segment->getSize();
+                 ////qDebug() << "Found LinePoint (MidPoint): "<< (start.x + end.x) / 2 << ","<< (start.y+end.y)/2 << " Length: "<< segment.getSize();
                 //LinePointCounter++;
 
             }
 
             if(segmentisused == false && robotSegmentIsUsed == false)
             {
-                robotSegments.push_back(*segment);
+                robotSegments.push_back(segment);
             }
 
 
@@ -603,7 +656,6 @@ void LineDetection::FindFieldLines(int IMAGE_WIDTH, int IMAGE_HEIGHT){
     //int DistanceStep;
     int SearchMultiplier = 1.5; // Increases GRID SEARCH SIZE via a multiple of SearchMultiplier
     double ColSlopeVal;
-    int previousPointID;
 
     int MAX_SCAN_SPACING = LINE_SEARCH_GRID_SIZE * 4; //ORIGINAL SCANLINE SPACINGS were 4x the
     int GRID = MAX_SCAN_SPACING * SearchMultiplier;
@@ -614,161 +666,135 @@ void LineDetection::FindFieldLines(int IMAGE_WIDTH, int IMAGE_HEIGHT){
     {
         return;
     }
-    //SORT THE LINES BY Y then BY X:
-    //clock_t startSort = clock();
-    //qsort(linePoints,0,linePoints.size()-1,2);
+    //The points are bucketed into a grid of GRID sized cells, so that the neighbours of a point can be found
+    //by looking in the adjacent cells only. linePoints is never reordered; the lines keep pointers into it.
+    BuildPointGrid(IMAGE_WIDTH, IMAGE_HEIGHT, GRID);
 
     //HORIZONTAL Line Search:
     //clock_t startHorizontalSearch = clock();
-    //debug << "Line Detection: Field Lines  : Sorting: " << (double)(startHorizontalSearch - startSort )/ CLOCKS_PER_SEC * 1000 << " ms"<<endl;
-    //Only bother searching if there is enough points to make part of a line..
-    for (unsigned int SearchFrom = 0; SearchFrom < linePoints.size() ; SearchFrom++)
+    //Search the points from left to right; the neighbours of a point are those up to GRID to the right of it
+    SortPointOrder(true);
+    for (unsigned int i = 0; i < pointOrder.size() ; i++)
     {   //for all line points recorded
         if(fieldLines.size()> MAX_FIELDLINES) break;
+        int SearchFrom = pointOrder[i];
         if(linePoints[SearchFrom].inUse) continue;
         //if(linePoints[SearchFrom].width > VERT_POINT_THICKNESS) continue;  //STOP if LINE is too THICK, but can use if in Vertical Line Search.
-        for (unsigned int EndCheck = SearchFrom+1; EndCheck < linePoints.size()-1; EndCheck++){ 	//for remaining points recorded
+        GetNeighbourPoints(SearchFrom, true, pointCandidates);
+        std::sort(pointCandidates.begin(), pointCandidates.end(), LinePointOrder(linePoints, true));
+        for (unsigned int j = 0; j < pointCandidates.size(); j++){ 	//for the neighbouring points
+            int EndCheck = pointCandidates[j];
             if (linePoints[EndCheck].width > VERT_POINT_THICKNESS) continue; //STOP if LINE is too THICK, but can use if in Vertical Line Search.
             if ((linePoints[EndCheck].inUse == true)) continue;
-            if ((linePoints[EndCheck].x == linePoints[SearchFrom].x))continue; //Vertical Line
-            // Skip all points on the same search line as this one or have already been removed..
 
-            if (linePoints[EndCheck].x <= linePoints[SearchFrom].x + GRID)
-            {
-                int DistanceStep = fabs(linePoints[EndCheck].x-linePoints[SearchFrom].x)/(MAX_SCAN_SPACING);  //number of grid units long
+            int DistanceStep = fabs(linePoints[EndCheck].x-linePoints[SearchFrom].x)/(MAX_SCAN_SPACING);  //number of grid units long
 
-                if (linePoints[EndCheck].y <= linePoints[SearchFrom].y + GRID * DistanceStep)
+            if (linePoints[EndCheck].y <= linePoints[SearchFrom].y + GRID * DistanceStep)
+            {
+                //We've found what might be a line, so lets see if we can find any more lines that match this one..
+                LSFittedLine tempFieldLine;
+                tempFieldLine.addPoint(linePoints[SearchFrom]);
+                tempFieldLine.addPoint(linePoints[EndCheck]);
+                int previousPointID = EndCheck;
+                ColSlopeVal = linePoints[SearchFrom].y - linePoints[EndCheck].y;
+                //follow the neighbours of the last point added until none of them are on the 'line'
+                LinePointOrder order(linePoints, true);
+                int nextPointID = previousPointID;
+                while (nextPointID >= 0)
                 {
-                    //qDebug() << linePoints[SearchFrom].x<< linePoints[SearchFrom].y << linePoints[EndCheck].x <<linePoints[EndCheck].y << GRID <<  fabs(linePoints[SearchFrom].y - linePoints[EndCheck].y);
-
-                    //We've found what might be a line, so lets see if we can find any more lines that match this one..
-                    LSFittedLine tempFieldLine;
-                    tempFieldLine.addPoint(linePoints[SearchFrom]);
-                    tempFieldLine.addPoint(linePoints[EndCheck]);
-                    previousPointID = EndCheck;
-                    ColSlopeVal = linePoints[SearchFrom].y - linePoints[EndCheck].y;
-                    //loop through the rest of the points that maybe in this 'line'
-                    for (unsigned int PointID = EndCheck+1; PointID < linePoints.size(); PointID++)
+                    nextPointID = -1;
+                    GetNeighbourPoints(previousPointID, true, pointNeighbours);
+                    for (unsigned int k = 0; k < pointNeighbours.size(); k++)
                     {
-                        if(linePoints[PointID].x >  linePoints[previousPointID].x + GRID )
-                        {
-                            break;
-                        }
-                        if (linePoints[previousPointID].x == linePoints[PointID].x) continue; //Vertical Line
+                        int PointID = pointNeighbours[k];
                         if (linePoints[PointID].inUse == true) continue;
+                        if (nextPointID >= 0 && order(nextPointID, PointID)) continue;   // the next point is the left most one on the line
 
-                        if (    linePoints[PointID].x <= linePoints[previousPointID].x + GRID
-                            &&  linePoints[PointID].y <= linePoints[previousPointID].y + GRID )
-                        {
-                            double DisMod = (linePoints[PointID].x - linePoints[previousPointID].x)/(double)(MAX_SCAN_SPACING);
-                            //qDebug() << "\tCheck Point : " << fabs(linePoints[PointID].y+(ColSlopeVal*DisMod) - linePoints[previousPointID].y) << DisMod << linePoints[previousPointID].x<< linePoints[previousPointID].y << linePoints[PointID].x <<linePoints[PointID].y;
-                            //Check if the slope is about right..
-                            if (fabs(linePoints[PointID].y+(ColSlopeVal*DisMod) - linePoints[previousPointID].y) <= 1)
-                            {
-                                //This is another point on the line..
-                                //qDebug() << "\t   Point Added: " <<linePoints[previousPointID].x<< linePoints[previousPointID].y << linePoints[PointID].x <<linePoints[PointID].y;
-                                tempFieldLine.addPoint(linePoints[PointID]);
-                                previousPointID = PointID;
-                            }
-                        }
-                    }
-                    if(tempFieldLine.numPoints > MIN_POINTS_ON_LINE-1)
-                    {
-                        fieldLines.push_back(tempFieldLine);
+                        double DisMod = (linePoints[PointID].x - linePoints[previousPointID].x)/(double)(MAX_SCAN_SPACING);
+                        //Check if the slope is about right..
+                        if (fabs(linePoints[PointID].y+(ColSlopeVal*DisMod) - linePoints[previousPointID].y) <= 1)
+                            nextPointID = PointID;
                     }
-                    else
+                    if (nextPointID >= 0)
                     {
-                        tempFieldLine.clearPoints();
+                        //This is another point on the line..
+                        tempFieldLine.addPoint(linePoints[nextPointID]);
+                        previousPointID = nextPointID;
                     }
                 }
+                if(tempFieldLine.numPoints > MIN_POINTS_ON_LINE-1)
+                {
+                    fieldLines.push_back(tempFieldLine);
+                }
+                else
+                {
+                    tempFieldLine.clearPoints();
+                }
             }
-            else
-            {
-                EndCheck = linePoints.size();
-            }
-
         }
     }
 
     //Now do all that again, but this time looking for the vert lines from the horz search grid..
-    //unsigned int horizontalEnd = fieldLines.size();
-    //SORT POINTS
-    //qDebug() << "SORTING...";
-    //clock_t startSortAgain = clock();
-    //debug << "Line Detection: Field Lines  : Horizontal Search: " << (double)(startSortAgain - startHorizontalSearch )/ CLOCKS_PER_SEC * 1000 << " ms"<<endl;
-    qsort(linePoints,0,linePoints.size()-1,1);
-    /*for (size_t i = 0; i < linePoints.size() ; i++)
-    {
-        qDebug() << i << ": "<< linePoints[i].x << "," << linePoints[i].y;
-
-    }*/
-    //qDebug() << "Finnished...";
-
     //clock_t startVerticalSearch = clock();
-    //debug << "Line Detection: Field Lines  : Sort: " << (double)(startVerticalSearch -  startSortAgain )/ CLOCKS_PER_SEC * 1000 << " ms"<<endl;
-    for (unsigned int SearchFrom = 0; SearchFrom < linePoints.size() ; SearchFrom++){
+    //debug << "Line Detection: Field Lines  : Horizontal Search: " << (double)(startVerticalSearch - startHorizontalSearch )/ CLOCKS_PER_SEC * 1000 << " ms"<<endl;
+    //Search the points from top to bottom; the neighbours of a point are those up to GRID below it
+    SortPointOrder(false);
+    for (unsigned int i = 0; i < pointOrder.size() ; i++){
         if(fieldLines.size()> MAX_FIELDLINES) break;
+        int SearchFrom = pointOrder[i];
         if(linePoints[SearchFrom].inUse) continue;
 
-        for (unsigned int EndCheck = SearchFrom+1; EndCheck < linePoints.size(); EndCheck++){
-                //std::cout << "Comparing.."<< SearchFrom << " with " << EndCheck <<std::endl;
-                //Skip all points on the same search line as this one or have already been removed..
-
+        GetNeighbourPoints(SearchFrom, false, pointCandidates);
+        std::sort(pointCandidates.begin(), pointCandidates.end(), LinePointOrder(linePoints, false));
+        for (unsigned int j = 0; j < pointCandidates.size(); j++){
+            int EndCheck = pointCandidates[j];
             if (linePoints[EndCheck].inUse == true) continue;
-            if (linePoints[EndCheck].y == linePoints[SearchFrom].y) continue; //Horizontal Line
             //if (linePoints[EndCheck].width > HORZ_POINT_THICKNESS) continue;  //STOP if LINE is too THICK, but can use if in Vertical Line Search.
             //if (linePoints[EndCheck].width < MIN_POINT_THICKNESS*3) continue;
-            if (linePoints[EndCheck].y <= linePoints[SearchFrom].y + GRID)
-            {
-                int DistanceStep = fabs(linePoints[EndCheck].y-linePoints[SearchFrom].y)/MAX_SCAN_SPACING;
-                //qDebug() << linePoints[SearchFrom].x<< linePoints[SearchFrom].y << linePoints[EndCheck].x <<linePoints[EndCheck].y << LINE_SEARCH_GRID_SIZE << DistanceStep<< fabs(linePoints[SearchFrom].y - linePoints[EndCheck].y);
+            int DistanceStep = fabs(linePoints[EndCheck].y-linePoints[SearchFrom].y)/MAX_SCAN_SPACING;
 
-                if (linePoints[EndCheck].x <= linePoints[SearchFrom].x + GRID * DistanceStep)
-                {
+            if (linePoints[EndCheck].x <= linePoints[SearchFrom].x + GRID * DistanceStep)
+            {
                 //We've found what might be a line, so lets see if we can find any more lines that match this one..
-                    //std::cout << "Starting New vertical Line" << std::endl;
-                    LSFittedLine tempFieldLine;
-                    tempFieldLine.addPoint(linePoints[SearchFrom]);
-                    tempFieldLine.addPoint(linePoints[EndCheck]);
-                    previousPointID = EndCheck;
-                    ColSlopeVal = linePoints[SearchFrom].x - linePoints[EndCheck].x;
-
-                    for (unsigned int PointID = EndCheck+1; PointID < linePoints.size(); PointID++)
+                LSFittedLine tempFieldLine;
+                tempFieldLine.addPoint(linePoints[SearchFrom]);
+                tempFieldLine.addPoint(linePoints[EndCheck]);
+                int previousPointID = EndCheck;
+                ColSlopeVal = linePoints[SearchFrom].x - linePoints[EndCheck].x;
+
+                LinePointOrder order(linePoints, false);
+                int nextPointID = previousPointID;
+                while (nextPointID >= 0)
+                {
+                    nextPointID = -1;
+                    GetNeighbourPoints(previousPointID, false, pointNeighbours);
+                    for (unsigned int k = 0; k < pointNeighbours.size(); k++)
                     {
-                        if(linePoints[PointID].y > linePoints[previousPointID].y + GRID)
-                        {
-                                //We've moved too far to keep searching..
-                                break;
-                        }
+                        int PointID = pointNeighbours[k];
                         if (linePoints[PointID].width > HORZ_POINT_THICKNESS) continue;
                         if (linePoints[PointID].inUse == true) continue;
-                        if (linePoints[previousPointID].y == linePoints[PointID].y) continue; //Horizontal Line
+                        if (nextPointID >= 0 && order(nextPointID, PointID)) continue;   // the next point is the top most one on the line
 
-                        if (    linePoints[PointID].y <= linePoints[previousPointID].y + GRID
-                             && linePoints[PointID].x <= linePoints[previousPointID].x + GRID )
-                        {
-                            double DisMod = (linePoints[PointID].y - linePoints[previousPointID].y)/MAX_SCAN_SPACING;
-                            //Check if the slope is about right..
-                            if (fabs(linePoints[PointID].x+(ColSlopeVal*DisMod) - linePoints[previousPointID].x) <= 1){
-                                //This is another point on the line..
-                                tempFieldLine.addPoint(linePoints[PointID]);
-                                previousPointID = PointID;
-                            }
-                        }
-
-                    }
-                    if(tempFieldLine.numPoints > MIN_POINTS_ON_LINE-1)
-                    {
-                        fieldLines.push_back(tempFieldLine);
+                        double DisMod = (linePoints[PointID].y - linePoints[previousPointID].y)/MAX_SCAN_SPACING;
+                        //Check if the slope is about right..
+                        if (fabs(linePoints[PointID].x+(ColSlopeVal*DisMod) - linePoints[previousPointID].x) <= 1)
+                            nextPointID = PointID;
                     }
-                    else
+                    if (nextPointID >= 0)
                     {
-                        tempFieldLine.clearPoints();
+                        //This is another point on the line..
+                        tempFieldLine.addPoint(linePoints[nextPointID]);
+                        previousPointID = nextPointID;
                     }
                 }
-            }
-            else {
-                    EndCheck = linePoints.size();
+                if(tempFieldLine.numPoints > MIN_POINTS_ON_LINE-1)
+                {
+                    fieldLines.push_back(tempFieldLine);
+                }
+                else
+                {
+                    tempFieldLine.clearPoints();
+                }
             }
         }
     }
@@ -1246,7 +1272,7 @@ void  LineDetection::TransformLinesToWorldModelSpace(Vision* vision)
 
     //Find Candidates for CentreCircle Lines:
 
-    vector<unsigned int> usedLines;
+    FrameVector<unsigned int>::type usedLines;
 
     for(unsigned int i = 0 ; i < transformedFieldLines.size(); i++ )
     {
@@ -1675,7 +1701,7 @@ void LineDetection::DecodeCorners(FieldObjects* AllObjects, double timestamp, Vi
         #endif
 
         //Sort Lines by most Left:
-        qsort(fieldLines, 0, fieldLines.size()-1);
+        std::sort(fieldLines.begin(), fieldLines.end(), LeftPointLessThan);
 
         for (unsigned int i = 0; i<fieldLines.size(); i++)
         {
@@ -2519,7 +2545,7 @@ void LineDetection::GetDistanceToPoint(double cx, double cy, double* distance, d
     *elevation = vision->CalculateElevation(cy);
 
     vector<float> ctgvector;
-    bool isOK = vision->getSensorsData()->get(NUSensorsData::CameraToGroundTransform, ctgvector); 
+    bool isOK = vision->getCameraToGroundTransform(ctgvector); 
     if(isOK == true)
     {
         Matrix camera2groundTransform = Matrix4x4fromVector(ctgvector);
@@ -2542,7 +2568,7 @@ bool LineDetection::GetDistanceToPoint(LinePoint point, Vector3<float> &relative
     float elevation = vision->CalculateElevation(point.y);
 
     vector<float> ctgvector;
-    bool isOK = vision->getSensorsData()->get(NUSensorsData::CameraToGroundTransform, ctgvector);
+    bool isOK = vision->getCameraToGroundTransform(ctgvector);
     if(isOK == true)
     {
         Matrix camera2groundTransform = Matrix4x4fromVector(ctgvector);
@@ -2562,7 +2588,7 @@ bool LineDetection::GetDistanceToPoint(Point point, Vector3<float> &relativePoin
     float elevation = vision->CalculateElevation(point.y);
 
     vector<float> ctgvector;
-    bool isOK = vision->getSensorsData()->get(NUSensorsData::CameraToGroundTransform, ctgvector);
+    bool isOK = vision->getCameraToGroundTransform(ctgvector);
     if(isOK == true)
     {
         Matrix camera2groundTransform = Matrix4x4fromVector(ctgvector);
@@ -2661,131 +2687,88 @@ IF the screen resolution is 640x480, this means from centre to corner is 29degre
 
 
 
-void LineDetection::swap(std::vector<LinePoint> &array, int i, int j)
+/*! @brief Buckets the linePoints into a grid of cellsize square cells with a counting sort.
+    @param image_width the width of the image the points are in
+    @param image_height the height of the image the points are in
+    @param cellsize the size of each cell in pixels
+ */
+void LineDetection::BuildPointGrid(int image_width, int image_height, int cellsize)
 {
-        LinePoint temp;
-        //qDebug() << "Swapping "<< i << "," <<j;
-        temp     = array[i];
-        array[i] = array[j];
-        array[j] = temp;
+    pointGridSize = cellsize > 0 ? cellsize : 1;
+    pointGridColumns = image_width/pointGridSize + 1;
+    pointGridRows = image_height/pointGridSize + 1;
+
+    // count the points in each cell, then turn the counts into the start of each cell
+    pointGridCells.assign(pointGridColumns*pointGridRows + 1, 0);
+    pointGridIndex.resize(linePoints.size());
+    for (unsigned int i = 0; i < linePoints.size(); i++)
+        pointGridCells[GetPointCell(linePoints[i]) + 1]++;
+    for (unsigned int c = 1; c < pointGridCells.size(); c++)
+        pointGridCells[c] += pointGridCells[c-1];
+    // place each point; this moves the start of each cell to the start of the next
+    for (unsigned int i = 0; i < linePoints.size(); i++)
+        pointGridIndex[pointGridCells[GetPointCell(linePoints[i])]++] = i;
+    for (unsigned int c = pointGridCells.size() - 1; c > 0; c--)
+        pointGridCells[c] = pointGridCells[c-1];
+    pointGridCells[0] = 0;
 }
-/*
-0 UNDEFINED
-1 Y - Smallest to Largest Y
-2 X - Smallest to Largest X
-*/
-void LineDetection::qsort(std::vector<LinePoint> &array, int left, int right, int type)
-{
-
-        int current;
-        int last;
-
-        if( left >= right )
-                return;
 
-        if (right - left < 5) {
-        // Do a selection sort  this doesnt seem to make it much faster ;(
-        int c;
-        for(int j = left; j < right; j++) {
-        c = j;
-        for (int k = j + 1; k < right+1; k++) {
-                if(type==1)
-                {
-                if(array[k].y < array[j].y) {
-                c = k;
-                if (c!=j) swap( array, c, j );
-                }
-                }
-                else if(type==2)
-                {
-                if(array[k].x < array[j].x) {
-                c = k;
-                if (c!=j) swap( array, c, j );
-                }
-                }
+/*! @brief Returns the grid cell containing a point. Points outside of the image are put in the nearest edge cell. */
+int LineDetection::GetPointCell(const LinePoint& point)
+{
+    int column = (int)point.x/pointGridSize;
+    int row = (int)point.y/pointGridSize;
+    column = std::max(0, std::min(column, pointGridColumns - 1));
+    row = std::max(0, std::min(row, pointGridRows - 1));
+    return row*pointGridColumns + column;
+}
 
-        }
-        }
-        return;
-        }
+/*! @brief Puts every linePoint index into pointOrder, sorted for the horizontal (by x) or vertical (by y) line search */
+void LineDetection::SortPointOrder(bool horizontal)
+{
+    pointOrder.resize(linePoints.size());
+    for (unsigned int i = 0; i < linePoints.size(); i++)
+        pointOrder[i] = i;
+    std::sort(pointOrder.begin(), pointOrder.end(), LinePointOrder(linePoints, horizontal));
+}
 
-        swap( array, left, (left+right)/2);
-        last = left;
+/*! @brief Finds the neighbours of a point using the grid from BuildPointGrid.
 
+    For the horizontal search the neighbours are the points to the right of the point by at most one cell,
+    and above or below it by at most one cell. For the vertical search it is the points below the point by at
+    most one cell, and left or right of it by at most one cell. Only the 3x3 cells around the point need to be checked.
 
-        for( current = left+1; current <= right; ++current )
+    @param pointid the index of the point in linePoints
+    @param horizontal true for the horizontal line search, false for the vertical line search
+    @param neighbours will be filled with the indices of the neighbours, in no particular order
+ */
+void LineDetection::GetNeighbourPoints(int pointid, bool horizontal, FrameVector<int>::type& neighbours)
+{
+    neighbours.clear();
+    const LinePoint& point = linePoints[pointid];
+    int cell = GetPointCell(point);
+    int column = cell % pointGridColumns;
+    int row = cell / pointGridColumns;
+    for (int r = std::max(row - 1, 0); r <= std::min(row + 1, pointGridRows - 1); r++)
+    {
+        for (int c = std::max(column - 1, 0); c <= std::min(column + 1, pointGridColumns - 1); c++)
         {
-                if(type==1)
+            int neighbourcell = r*pointGridColumns + c;
+            for (int k = pointGridCells[neighbourcell]; k < pointGridCells[neighbourcell + 1]; k++)
+            {
+                const LinePoint& neighbour = linePoints[pointGridIndex[k]];
+                if (horizontal)
                 {
-                    if(array[current].y < array[left].y) {
-                            ++last;
-                            swap( array, last, current);
-                    }
+                    if (neighbour.x > point.x && neighbour.x <= point.x + pointGridSize && fabs(neighbour.y - point.y) <= pointGridSize)
+                        neighbours.push_back(pointGridIndex[k]);
                 }
-                else if(type==2)
+                else
                 {
-                    if(array[current].x < array[left].x) {
-                            ++last;
-                            swap( array, last, current);
-                    }
+                    if (neighbour.y > point.y && neighbour.y <= point.y + pointGridSize && fabs(neighbour.x - point.x) <= pointGridSize)
+                        neighbours.push_back(pointGridIndex[k]);
                 }
+            }
         }
-
-        swap( array, left, last );
-
-        qsort( array, left,   last-1, type );
-        qsort( array, last+1, right,type );
-}
-
-
-void LineDetection::swap(std::vector<LSFittedLine> &array, int i, int j)
-{
-        LSFittedLine temp;
-
-        temp     = array[i];
-        array[i] = array[j];
-        array[j] = temp;
+    }
 }
 
-void LineDetection::qsort(std::vector<LSFittedLine> &array, int left, int right)
-{
-
-        int current;
-        int last;
-
-        if( left >= right )
-                return;
-
-        if (right - left < 5) {
-        // Do a selection sort  this doesnt seem to make it much faster ;(
-        int c;
-        for(int j = left; j < right; j++) {
-                c = j;
-                for (int k = j + 1; k < right+1; k++) {
-                        if(array[k].leftPoint.x < array[j].leftPoint.x && array[j].valid && array[k].valid) {
-                                c = k;
-                                if (c!=j) swap( array, c, j);
-                        }
-                }
-        }
-        return;
-        }
-
-        swap( array, left, (left+right)/2);
-        last = left;
-
-
-        for( current = left+1; current <= right; ++current )
-        {
-                if(array[current].leftPoint.x < array[left].leftPoint.x && array[current].valid && array[left].valid) {
-                        ++last;
-                        swap( array, last, current);
-                }
-
-        }
-
-        swap( array, left, last);
-
-        qsort( array, left,   last-1);
-        qsort( array, last+1, right);
-}
@@ -7,6 +7,7 @@
 #include "TransitionSegment.h"
 #include "Infrastructure/FieldObjects/FieldObjects.h"
 #include "ObjectCandidate.h"
+#include "FrameArena.h"
 #include "SplitAndMerge/SAM.h"
 #include <iostream>
 
@@ -42,13 +43,14 @@ class LineDetection{
 	//VARIABLES:
         vector<LinePoint*> centreCirclePoints;
         std::vector<LinePoint> linePoints;
+        FrameVector<LinePoint>::type clusterPoints; //!< the points handed to SAM; the lines found keep pointers to them
         std::vector<LSFittedLine> fieldLines;
         std::vector<LSFittedLine> transformedFieldLines;
         std::vector<CornerPoint> cornerPoints;
         std::vector<AmbiguousObject> possiblePenaltySpots;
-        std::vector<TransitionSegment> robotSegments;
-        std::vector<TransitionSegment> verticalLineSegments;
-        std::vector<TransitionSegment> horizontalLineSegments;
+        FrameVector<TransitionSegment>::type robotSegments;
+        FrameVector<TransitionSegment>::type verticalLineSegments;
+        FrameVector<TransitionSegment>::type horizontalLineSegments;
         //int LinePointCounter;
         //int FieldLinesCounter;
         //int CornerPointCounter;
@@ -63,17 +65,19 @@ class LineDetection{
         void FormLines(FieldObjects* AllObjects,
                        Vision* vision,
                        NUSensorsData* data,
-                       vector< ObjectCandidate >& candidates,
-                       vector< TransitionSegment>& leftover);
+                       FrameVector<ObjectCandidate>::type& candidates,
+                       FrameVector<TransitionSegment>::type& leftover);
         bool GetDistanceToPoint(Point point,  Vector3<float> &result, Vision* vision);
 
 	
 	private:
+        friend class LineDetectionBenchmark;
 
         int TotalValidLines;
         int LINE_SEARCH_GRID_SIZE;
         int PenaltySpotLineNumber;
         NUSensorsData* sensorsData;
+        SAM splitAndMerge;                          //!< the split and merge used by FormLines, owned here so that each Vision has its own
 
         void FindFieldLines(int image_width,int image_height);
 
@@ -89,13 +93,20 @@ class LineDetection{
         void GetDistanceToPoint(double,double,double*,double*,double*, Vision* vision);
         bool GetDistanceToPoint(LinePoint point,  Vector3<float> &result, Vision* vision);
         void TransformLinesToWorldModelSpace(Vision* vision);
-        //! Line Point Sorting
-        void qsort(std::vector<LinePoint> &array, int left, int right, int type);
-        void swap(std::vector<LinePoint> &array, int i, int j);
-
-        //! Lines Sorting
-        void qsort(std::vector<LSFittedLine> &array, int left, int right);
-        void swap(std::vector<LSFittedLine> &array, int i, int j);
+        //! Line Point Grid
+        void BuildPointGrid(int image_width, int image_height, int cellsize);
+        int GetPointCell(const LinePoint& point);
+        void SortPointOrder(bool horizontal);
+        void GetNeighbourPoints(int pointid, bool horizontal, FrameVector<int>::type& neighbours);
+
+        int pointGridSize;                          //!< the size of each grid cell in pixels
+        int pointGridColumns;                       //!< the number of columns in the grid
+        int pointGridRows;                          //!< the number of rows in the grid
+        FrameVector<int>::type pointGridCells;            //!< the start of each cell in pointGridIndex; cell c is [pointGridCells[c], pointGridCells[c+1])
+        FrameVector<int>::type pointGridIndex;            //!< the linePoints indices bucketed by cell
+        FrameVector<int>::type pointOrder;                //!< the linePoints indices in the order they are searched
+        FrameVector<int>::type pointCandidates;           //!< the neighbours of the point a line is started from
+        FrameVector<int>::type pointNeighbours;           //!< the neighbours of the last point added to a line
 }
 ;
 
@@ -0,0 +1,102 @@
+/*! @file LookUpTable.cpp
+    @brief Implementation of LookUpTable class
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "LookUpTable.h"
+#include "Tools/FileFormats/LUTTools.h"
+
+/*! @brief Creates a null handle */
+LookUpTable::LookUpTable()
+{
+    m_shared = NULL;
+}
+
+/*! @brief Creates a handle to a table of LUTTools::LUT_SIZE bytes
+    @param table the table
+    @param owner true if the handle takes ownership of the table (which must have been allocated with new[]),
+                 false if it only borrows it
+ */
+LookUpTable::LookUpTable(unsigned char* table, bool owner)
+{
+    m_shared = new Shared();
+    m_shared->Table = table;
+    m_shared->Owner = owner;
+    m_shared->Count = 1;
+}
+
+LookUpTable::LookUpTable(const LookUpTable& other)
+{
+    m_shared = other.m_shared;
+    if (m_shared != NULL)
+        __sync_add_and_fetch(&m_shared->Count, 1);
+}
+
+LookUpTable::~LookUpTable()
+{
+    release();
+}
+
+LookUpTable& LookUpTable::operator=(const LookUpTable& other)
+{
+    if (other.m_shared != NULL)
+        __sync_add_and_fetch(&other.m_shared->Count, 1);
+    release();
+    m_shared = other.m_shared;
+    return *this;
+}
+
+/*! @brief Returns the table, or NULL for a null handle */
+const unsigned char* LookUpTable::getTable() const
+{
+    return m_shared != NULL ? m_shared->Table : NULL;
+}
+
+/*! @brief Returns true if the handle does not refer to a table */
+bool LookUpTable::isNull() const
+{
+    return m_shared == NULL;
+}
+
+/*! @brief Loads a table from a file in any format understood by LUTTools::LoadLUT
+    @return a handle owning the loaded table, or a null handle if the file could not be loaded
+ */
+LookUpTable LookUpTable::loadFromFile(const std::string& filename)
+{
+    unsigned char* table = new unsigned char[LUTTools::LUT_SIZE];
+    if (not LUTTools::LoadLUT(table, LUTTools::LUT_SIZE, filename.c_str()))
+    {
+        delete [] table;
+        return LookUpTable();
+    }
+    return LookUpTable(table, true);
+}
+
+/*! @brief Drops this handle's reference, deleting the table if this was the last one */
+void LookUpTable::release()
+{
+    if (m_shared != NULL and __sync_sub_and_fetch(&m_shared->Count, 1) == 0)
+    {
+        if (m_shared->Owner)
+            delete [] m_shared->Table;
+        delete m_shared;
+    }
+    m_shared = NULL;
+}
+
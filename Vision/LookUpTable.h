@@ -0,0 +1,64 @@
+/*! @file LookUpTable.h
+    @brief Declaration of LookUpTable class
+
+    @class LookUpTable
+    @brief A reference counted handle to a colour lookup table
+
+    Copying a handle shares the table, and the table is deleted when the last handle to it is destroyed,
+    so a thread holding a handle can keep using its table while another thread replaces it. The reference
+    count is atomic, but a single handle must not be copied and assigned to on different threads at once;
+    Vision guards the handle it shares between threads with a mutex.
+
+    A handle can also borrow a table it does not own (for example one being edited in NUview), in which
+    case the owner of the table is responsible for keeping it alive.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOKUPTABLE_H
+#define LOOKUPTABLE_H
+
+#include <string>
+
+class LookUpTable
+{
+public:
+    LookUpTable();
+    LookUpTable(unsigned char* table, bool owner);
+    LookUpTable(const LookUpTable& other);
+    ~LookUpTable();
+    LookUpTable& operator=(const LookUpTable& other);
+
+    const unsigned char* getTable() const;
+    bool isNull() const;
+
+    static LookUpTable loadFromFile(const std::string& filename);
+private:
+    void release();
+private:
+    struct Shared
+    {
+        unsigned char* Table;           //!< the table
+        bool Owner;                     //!< true if the table is deleted with the last handle
+        volatile int Count;             //!< the number of handles to the table
+    };
+    Shared* m_shared;                   //!< the table shared by every copy of this handle, NULL for a null handle
+};
+
+#endif
+
@@ -14,7 +14,7 @@
         shadow_blue,    //!< Colour is in the Dark Blue region.
     //*/
 
-ObjectCandidate::ObjectCandidate()
+ObjectCandidate::ObjectCandidate():segmentPool(0), firstSegment(0), numSegments(0)
 {
     topLeft.x = 0;
     topLeft.y = 0;
@@ -23,7 +23,7 @@ ObjectCandidate::ObjectCandidate()
     colour = 3;
 }
 
-ObjectCandidate::ObjectCandidate(int left, int top, int right, int bottom)
+ObjectCandidate::ObjectCandidate(int left, int top, int right, int bottom):segmentPool(0), firstSegment(0), numSegments(0)
 {
     topLeft.x = left;
     topLeft.y = top;
@@ -32,7 +32,7 @@ ObjectCandidate::ObjectCandidate(int left, int top, int right, int bottom)
     colour = 3;
 }
 
-ObjectCandidate::ObjectCandidate(int left, int top, int right, int bottom, unsigned char colour): colour(colour)
+ObjectCandidate::ObjectCandidate(int left, int top, int right, int bottom, unsigned char colour): segmentPool(0), firstSegment(0), numSegments(0), colour(colour)
 {
     topLeft.x = left;
     topLeft.y = top;
@@ -40,28 +40,53 @@ ObjectCandidate::ObjectCandidate(int left, int top, int right, int bottom, unsig
     bottomRight.y = bottom;
 }
 
-ObjectCandidate::ObjectCandidate(int left, int top, int right, int bottom, unsigned char colour, std::vector<TransitionSegment> candidate_segments): colour(colour)
+/*! @brief Creates a candidate whose segments are a span of a pool. Copying the candidate does not copy its segments.
+    @param segment_pool the segments of every candidate of the frame; it must outlive the candidate
+    @param first_segment the index of the candidate's first segment in the pool
+    @param num_segments the number of the candidate's segments, which are contiguous in the pool
+ */
+ObjectCandidate::ObjectCandidate(int left, int top, int right, int bottom, unsigned char colour, std::vector<TransitionSegment>& segment_pool, int first_segment, int num_segments):
+    segmentPool(&segment_pool), firstSegment(first_segment), numSegments(num_segments), colour(colour)
 {
     topLeft.x = left;
     topLeft.y = top;
     bottomRight.x = right;
     bottomRight.y = bottom;
-    segments = candidate_segments;
 }//*/
 
-std::vector<TransitionSegment> ObjectCandidate::getSegments() const
+SegmentSpan ObjectCandidate::getSegments() const
 {
-    return segments;
+    return SegmentSpan(segmentPool, firstSegment, numSegments);
 }
-void ObjectCandidate::addSegments(const std::vector<TransitionSegment> &new_segments)
-{
-    segments.insert(segments.end(), new_segments.begin(), new_segments.end());
-    return;
-}
-void ObjectCandidate::addSegment(const TransitionSegment &new_segment)
-{
-    segments.push_back(new_segment);
-    return;
+
+/*! @brief Adds the segments of another candidate to this one. The span must stay contiguous, so unless it is at the
+           end of the pool it is first moved there; only merged candidates pay for a copy.
+ */
+void ObjectCandidate::addSegments(const ObjectCandidate &other)
+{
+    if (other.numSegments == 0)
+        return;
+    if (segmentPool == 0 or numSegments == 0)
+    {
+        segmentPool = other.segmentPool;
+        firstSegment = other.firstSegment;
+        numSegments = other.numSegments;
+        return;
+    }
+
+    std::vector<TransitionSegment>& pool = *segmentPool;
+    pool.reserve(pool.size() + numSegments + other.numSegments);
+    if (firstSegment + numSegments != (int)pool.size())
+    {
+        int first = pool.size();
+        for (int i = 0; i < numSegments; i++)
+            pool.push_back(pool[firstSegment + i]);
+        firstSegment = first;
+    }
+    const std::vector<TransitionSegment>& otherpool = *other.segmentPool;
+    for (int i = 0; i < other.numSegments; i++)
+        pool.push_back(otherpool[other.firstSegment + i]);
+    numSegments += other.numSegments;
 }
 
 ObjectCandidate::~ObjectCandidate()
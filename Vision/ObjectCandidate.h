@@ -4,7 +4,27 @@
 #include <vector>
 #include "Tools/Math/Vector2.h"
 #include "TransitionSegment.h"
+#include "FrameArena.h"
 
+//! The segments of a candidate; a contiguous span of a pool of segments shared by the candidates of a frame.
+/*!
+    The span refers to the pool by index, so it stays valid while the pool grows.
+  */
+class SegmentSpan
+{
+public:
+    SegmentSpan() : pool(0), first(0), count(0) {}
+    SegmentSpan(const std::vector<TransitionSegment>* segment_pool, int first_segment, int num_segments) : pool(segment_pool), first(first_segment), count(num_segments) {}
+
+    unsigned int size() const {return count;}
+    bool empty() const {return count == 0;}
+    const TransitionSegment& operator[](unsigned int i) const {return (*pool)[first + i];}
+
+private:
+    const std::vector<TransitionSegment>* pool;
+    int first;
+    int count;
+};
 
 class ObjectCandidate
 {
@@ -20,21 +40,22 @@ public:
     float aspect() const;
     unsigned char getColour()  const;
     void setColour(unsigned char c);
-    std::vector<TransitionSegment> getSegments() const;
-    void addSegments(const std::vector<TransitionSegment> &new_segments);
-    void addSegment(const TransitionSegment &new_segment);
+    SegmentSpan getSegments() const;
+    void addSegments(const ObjectCandidate &other);
 
     ObjectCandidate();
     ObjectCandidate(int left, int top, int right, int bottom);
     ObjectCandidate(int left, int top, int right, int bottom, unsigned char colour);
-    ObjectCandidate(int left, int top, int right, int bottom, unsigned char colour, std::vector<TransitionSegment> candidate_segments);
+    ObjectCandidate(int left, int top, int right, int bottom, unsigned char colour, std::vector<TransitionSegment>& segment_pool, int first_segment, int num_segments);
     ~ObjectCandidate();
 
 
 protected:
     Vector2<int> topLeft;
     Vector2<int> bottomRight;
-    std::vector<TransitionSegment> segments;
+    std::vector<TransitionSegment>* segmentPool;    //!< the pool holding the candidate's segments, or NULL if it has none
+    int firstSegment;                               //!< the index of the candidate's first segment in the pool
+    int numSegments;                                //!< the number of segments of the candidate; they are contiguous in the pool
     unsigned char colour;
 
 
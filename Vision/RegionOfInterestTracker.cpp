@@ -0,0 +1,270 @@
+/*! @file RegionOfInterestTracker.cpp
+    @brief Implementation of RegionOfInterestTracker class
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "RegionOfInterestTracker.h"
+#include "Infrastructure/FieldObjects/FieldObjects.h"
+
+#include <cmath>
+#include <algorithm>
+using namespace std;
+
+RegionOfInterestTracker::RegionOfInterestTracker()
+{
+    m_time = 0;
+    m_rotation_valid = false;
+    m_image_width = m_image_height = 0;
+    m_focal_x = m_focal_y = 1;
+    clear();
+}
+
+RegionOfInterestTracker::~RegionOfInterestTracker()
+{
+}
+
+/*! @brief Sets the size of the images the regions are in */
+void RegionOfInterestTracker::setImageSize(int width, int height)
+{
+    if (width == m_image_width and height == m_image_height)
+        return;
+    m_image_width = width;
+    m_image_height = height;
+    m_focal_x = (0.5*width)/tan(0.5*ROI_FOV_X);
+    m_focal_y = (0.5*height)/tan(0.5*ROI_FOV_Y);
+    clear();
+}
+
+/*! @brief Predicts the region of each tracked target in a new image
+    @param time the time the image was taken in ms
+    @param cameratoground the 4x4 camera to ground transform (row major) when the image was taken, or empty if it is not known.
+                          Without it the camera is assumed not to have moved.
+ */
+void RegionOfInterestTracker::predict(double time, const vector<float>& cameratoground)
+{
+    m_time = time;
+    m_rotation_valid = setRotation(cameratoground);
+    for (int i=0; i<NumTargets; i++)
+    {
+        const Track& track = m_tracks[i];
+        Region& region = m_regions[i];
+        region.Valid = false;
+        if (not track.Active)
+            continue;
+
+        double dt = time - track.Time;
+        float x, y;
+        moveWithCamera(track, track.CentreX, track.CentreY, x, y);
+        x += track.VelocityX*dt;
+        y += track.VelocityY*dt;
+
+        float marginx = ROI_MIN_MARGIN + (ROI_MARGIN + ROI_MISS_MARGIN*track.Misses)*track.Width;
+        float marginy = ROI_MIN_MARGIN + (ROI_MARGIN + ROI_MISS_MARGIN*track.Misses)*track.Height;
+        region.MinX = max(static_cast<int>(x - 0.5*track.Width - marginx), 0);
+        region.MaxX = min(static_cast<int>(x + 0.5*track.Width + marginx), m_image_width - 1);
+        region.MinY = max(static_cast<int>(y - 0.5*track.Height - marginy), 0);
+        region.MaxY = min(static_cast<int>(y + 0.5*track.Height + marginy), m_image_height - 1);
+        region.Valid = region.MinX <= region.MaxX and region.MinY <= region.MaxY;
+    }
+}
+
+/*! @brief Updates the track of a target with the result of the current image. This must be called after predict().
+    @param target the target
+    @param seen true if the target was seen in the current image, in which case the bounding box in the image is given
+ */
+void RegionOfInterestTracker::update(Target target, bool seen, int minx, int miny, int maxx, int maxy)
+{
+    Track& track = m_tracks[target];
+    if (not seen)
+    {
+        if (track.Active)
+        {
+            track.Misses++;
+            if (track.Misses > ROI_MAX_MISSES)
+                track.Active = false;
+        }
+        return;
+    }
+
+    float x = 0.5*(minx + maxx);
+    float y = 0.5*(miny + maxy);
+    double dt = m_time - track.Time;
+    if (track.Active and dt > 0 and dt < ROI_MAX_VELOCITY_TIME)
+    {   // the target's own velocity is what is left once the camera's motion has been taken out
+        float movedx, movedy;
+        moveWithCamera(track, track.CentreX, track.CentreY, movedx, movedy);
+        track.VelocityX = ROI_VELOCITY_GAIN*(x - movedx)/dt + (1 - ROI_VELOCITY_GAIN)*track.VelocityX;
+        track.VelocityY = ROI_VELOCITY_GAIN*(y - movedy)/dt + (1 - ROI_VELOCITY_GAIN)*track.VelocityY;
+    }
+    else
+    {
+        track.VelocityX = 0;
+        track.VelocityY = 0;
+    }
+
+    track.Active = true;
+    track.Misses = 0;
+    track.Time = m_time;
+    track.CentreX = x;
+    track.CentreY = y;
+    track.Width = maxx - minx + 1;
+    track.Height = maxy - miny + 1;
+    track.RotationValid = m_rotation_valid;
+    for (int i=0; i<3; i++)
+        for (int j=0; j<3; j++)
+            track.Rotation[i][j] = m_rotation[i][j];
+}
+
+/*! @brief Updates the track of every target with the objects found in the current image. This must be called after predict(). */
+void RegionOfInterestTracker::update(const FieldObjects* fieldobjects)
+{
+    for (int i=0; i<NumTargets; i++)
+    {
+        int minx, miny, maxx, maxy;
+        bool seen = measure(fieldobjects, static_cast<Target>(i), minx, miny, maxx, maxy);
+        update(static_cast<Target>(i), seen, minx, miny, maxx, maxy);
+    }
+}
+
+/*! @brief Drops every track */
+void RegionOfInterestTracker::clear()
+{
+    for (int i=0; i<NumTargets; i++)
+    {
+        m_tracks[i].Active = false;
+        m_tracks[i].Misses = 0;
+        m_tracks[i].Time = 0;
+        m_tracks[i].VelocityX = m_tracks[i].VelocityY = 0;
+        m_tracks[i].RotationValid = false;
+        m_regions[i].Valid = false;
+        m_regions[i].MinX = m_regions[i].MinY = 0;
+        m_regions[i].MaxX = m_regions[i].MaxY = -1;
+    }
+}
+
+/*! @brief Returns the predicted region of the target in the current image */
+const RegionOfInterestTracker::Region& RegionOfInterestTracker::getRegion(Target target) const
+{
+    return m_regions[target];
+}
+
+/*! @brief Gets the bounding box of a target in the image from the objects found by vision. A goal's box contains all of its visible posts.
+    @return true if the target was seen
+ */
+bool RegionOfInterestTracker::measure(const FieldObjects* fieldobjects, Target target, int& minx, int& miny, int& maxx, int& maxy)
+{
+    vector<const Object*> objects;
+    if (target == Ball)
+        objects.push_back(&fieldobjects->mobileFieldObjects[FieldObjects::FO_BALL]);
+    else
+    {
+        bool yellow = target == YellowGoal;
+        objects.push_back(&fieldobjects->stationaryFieldObjects[yellow ? FieldObjects::FO_YELLOW_LEFT_GOALPOST : FieldObjects::FO_BLUE_LEFT_GOALPOST]);
+        objects.push_back(&fieldobjects->stationaryFieldObjects[yellow ? FieldObjects::FO_YELLOW_RIGHT_GOALPOST : FieldObjects::FO_BLUE_RIGHT_GOALPOST]);
+        int unknown = yellow ? FieldObjects::FO_YELLOW_GOALPOST_UNKNOWN : FieldObjects::FO_BLUE_GOALPOST_UNKNOWN;
+        for (size_t i=0; i<fieldobjects->ambiguousFieldObjects.size(); i++)
+        {
+            if (fieldobjects->ambiguousFieldObjects[i].getID() == unknown)
+                objects.push_back(&fieldobjects->ambiguousFieldObjects[i]);
+        }
+    }
+
+    bool seen = false;
+    for (size_t i=0; i<objects.size(); i++)
+    {
+        const Object* object = objects[i];
+        if (not object->isObjectVisible())
+            continue;
+        int left = object->ScreenX() - object->getObjectWidth()/2;
+        int top = object->ScreenY() - object->getObjectHeight()/2;
+        int right = left + object->getObjectWidth();
+        int bottom = top + object->getObjectHeight();
+        if (not seen)
+        {
+            minx = left;
+            miny = top;
+            maxx = right;
+            maxy = bottom;
+            seen = true;
+        }
+        else
+        {
+            minx = min(minx, left);
+            miny = min(miny, top);
+            maxx = max(maxx, right);
+            maxy = max(maxy, bottom);
+        }
+    }
+    return seen;
+}
+
+/*! @brief Returns the name of the target */
+const char* RegionOfInterestTracker::getName(Target target)
+{
+    switch (target)
+    {
+        case Ball:
+            return "Ball";
+        case YellowGoal:
+            return "YellowGoal";
+        case BlueGoal:
+            return "BlueGoal";
+        default:
+            return "Unknown";
+    }
+}
+
+/*! @brief Sets the camera to ground rotation of the current image
+    @return false if the transform is not a 4x4 matrix
+ */
+bool RegionOfInterestTracker::setRotation(const vector<float>& cameratoground)
+{
+    if (cameratoground.size() != 16)
+        return false;
+    for (int i=0; i<3; i++)
+        for (int j=0; j<3; j++)
+            m_rotation[i][j] = cameratoground[4*i + j];
+    return true;
+}
+
+/*! @brief Moves a point in the image where the track was last seen to where it would be in the current image, if only the camera had
+           rotated. The point is left where it is if either rotation is unknown, or the point would be behind the camera.
+ */
+void RegionOfInterestTracker::moveWithCamera(const Track& track, float x, float y, float& movedx, float& movedy) const
+{
+    movedx = x;
+    movedy = y;
+    if (not track.RotationValid or not m_rotation_valid)
+        return;
+
+    // the direction of the point from the old camera (x forward, y left, z up)
+    float camera[3] = {1, (0.5f*m_image_width - x)/m_focal_x, (0.5f*m_image_height - y)/m_focal_y};
+    float ground[3];
+    for (int i=0; i<3; i++)
+        ground[i] = track.Rotation[i][0]*camera[0] + track.Rotation[i][1]*camera[1] + track.Rotation[i][2]*camera[2];
+    // and from the new camera, using the transpose of its camera to ground rotation
+    for (int i=0; i<3; i++)
+        camera[i] = m_rotation[0][i]*ground[0] + m_rotation[1][i]*ground[1] + m_rotation[2][i]*ground[2];
+    if (camera[0] <= 0)
+        return;
+
+    movedx = 0.5f*m_image_width - m_focal_x*camera[1]/camera[0];
+    movedy = 0.5f*m_image_height - m_focal_y*camera[2]/camera[0];
+}
+
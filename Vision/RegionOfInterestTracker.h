@@ -0,0 +1,113 @@
+/*! @file RegionOfInterestTracker.h
+    @brief Declaration of RegionOfInterestTracker class
+
+    @class RegionOfInterestTracker
+    @brief Predicts where the ball and the goals will be in the next image, from where they were in the previous images
+
+    Each target is tracked by the bounding box it had in the image when it was last seen, along with the camera
+    to ground rotation at that time, and its velocity in the image. The box is moved into the next image by
+    rotating it through the change in the camera's orientation (so that the head's motion is followed), and
+    then by the target's own velocity. The region of interest is that box plus a margin, which grows each frame
+    the target is not seen; after ROI_MAX_MISSES frames the track is dropped.
+
+    The regions are only used to add detail, Vision still scans the whole image, so a lost track only means
+    the target has to be found again by the coarse scan.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef REGIONOFINTERESTTRACKER_H
+#define REGIONOFINTERESTTRACKER_H
+
+#include <vector>
+class FieldObjects;
+
+#define ROI_FOV_X 0.7854                    //!< the horizontal field of view in rad (45 deg, the same as Vision)
+#define ROI_FOV_Y 0.6013                    //!< the vertical field of view in rad (34.45 deg, the same as Vision)
+#define ROI_MAX_MISSES 5                    //!< the number of consecutive frames a target can be missed before its track is dropped
+#define ROI_MIN_MARGIN 8                    //!< the smallest margin added to each side of a region in pixels
+#define ROI_MARGIN 0.5                      //!< the margin added to each side of a region as a fraction of the target's size
+#define ROI_MISS_MARGIN 0.5                 //!< the extra margin, as a fraction of the target's size, for each frame the target has been missed
+#define ROI_MAX_VELOCITY_TIME 200           //!< the velocity is only estimated from detections less than this many ms apart
+#define ROI_VELOCITY_GAIN 0.5               //!< the weight of each new velocity measurement
+
+class RegionOfInterestTracker
+{
+public:
+    enum Target
+    {
+        Ball,
+        YellowGoal,
+        BlueGoal,
+        NumTargets
+    };
+
+    struct Region
+    {
+        bool Valid;                         //!< true if the target is expected in the region
+        int MinX;                           //!< the left most column of the region
+        int MinY;                           //!< the top most row of the region
+        int MaxX;                           //!< the right most column of the region
+        int MaxY;                           //!< the bottom most row of the region
+    };
+
+    RegionOfInterestTracker();
+    ~RegionOfInterestTracker();
+
+    void setImageSize(int width, int height);
+    void predict(double time, const std::vector<float>& cameratoground);
+    void update(Target target, bool seen, int minx, int miny, int maxx, int maxy);
+    void update(const FieldObjects* fieldobjects);
+    void clear();
+
+    const Region& getRegion(Target target) const;
+
+    static bool measure(const FieldObjects* fieldobjects, Target target, int& minx, int& miny, int& maxx, int& maxy);
+    static const char* getName(Target target);
+private:
+    struct Track
+    {
+        bool Active;                        //!< true if the target has been seen in the last ROI_MAX_MISSES frames
+        int Misses;                         //!< the number of frames since the target was seen
+        double Time;                        //!< the time the target was last seen in ms
+        float CentreX;                      //!< the centre of the target when it was last seen
+        float CentreY;
+        float Width;                        //!< the size of the target when it was last seen
+        float Height;
+        float VelocityX;                    //!< the velocity of the target in the image, not counting the camera's motion, in pixels per ms
+        float VelocityY;
+        bool RotationValid;                 //!< true if the camera rotation was known when the target was last seen
+        float Rotation[3][3];               //!< the camera to ground rotation when the target was last seen
+    };
+
+    bool setRotation(const std::vector<float>& cameratoground);
+    void moveWithCamera(const Track& track, float x, float y, float& movedx, float& movedy) const;
+
+    Track m_tracks[NumTargets];             //!< the track of each target
+    Region m_regions[NumTargets];           //!< the region of each target in the current image
+    double m_time;                          //!< the time of the current image in ms
+    bool m_rotation_valid;                  //!< true if the camera rotation of the current image is known
+    float m_rotation[3][3];                 //!< the camera to ground rotation of the current image
+    int m_image_width;
+    int m_image_height;
+    float m_focal_x;                        //!< the horizontal focal length in pixels
+    float m_focal_y;                        //!< the vertical focal length in pixels
+};
+
+#endif
+
@@ -1,5 +1,6 @@
 #include "ScanLine.h"
 #include "ClassificationColours.h"
+#include "debug.h"
 
 ScanLine::ScanLine()
 {
@@ -7,6 +8,7 @@ ScanLine::ScanLine()
     //Vector2<int> start;
     length = 0;
     direction = 0;
+    setSegmentTable(NULL, 0);
 }
 
 ScanLine::~ScanLine()
@@ -20,6 +22,7 @@ ScanLine::ScanLine(Vector2<int> newStartPoint, int newLength)
     start = newStartPoint;
     length = newLength;
     direction = 0;
+    setSegmentTable(NULL, 0);
 }
 
 ScanLine::ScanLine(Vector2<int> newStartPoint, int newLength, int newDirection)
@@ -28,6 +31,7 @@ ScanLine::ScanLine(Vector2<int> newStartPoint, int newLength, int newDirection)
     start = newStartPoint;
     length = newLength;
     direction = newDirection;
+    setSegmentTable(NULL, 0);
 }
 
 int ScanLine::getLength()
@@ -45,20 +49,52 @@ void ScanLine::setDirection(int newDirection)
     direction = newDirection;
 }
 
+//! Sets the table the line's segments are stored in, and the line's index in it. Any segments already added are forgotten.
+void ScanLine::setSegmentTable(SegmentTable* newTable, int newIndex)
+{
+    table = newTable;
+    index = newIndex;
+    firstSegment = table ? table->size() : 0;
+    numberOfSegments = 0;
+}
+
+int ScanLine::getIndex()
+{
+    return index;
+}
+
 int  ScanLine::getNumberOfSegments()
 {
-    return segments.size();
+    return numberOfSegments;
 }
 
 void ScanLine::addSegement(const TransitionSegment& segment)
 {
-    segments.push_back(segment);
+    if (table == NULL)
+    {
+        errorlog << "ScanLine::addSegement. The line has not been added to a ClassifiedSection." << std::endl;
+        return;
+    }
+    if (numberOfSegments == 0)
+        firstSegment = table->size();
+    else if (firstSegment + numberOfSegments != table->size())
+    {
+        errorlog << "ScanLine::addSegement. Segments have been added to another line since this line's last segment." << std::endl;
+        return;
+    }
+    table->add(segment, index);
+    numberOfSegments++;
     return;
 }
 
-TransitionSegment* ScanLine::getSegment(int position)
+TransitionSegment ScanLine::getSegment(int position)
+{
+    return table->getSegment(firstSegment + position);
+}
+
+unsigned char ScanLine::getSegmentColour(int position)
 {
-    return &(segments[position]);
+    return table->getColour(firstSegment + position);
 }
 Vector2<int> ScanLine::getStart()
 {
@@ -125,28 +161,27 @@ float ScanLine::getFill(float start, float end)
     int sradius, eradius;
     int sbound = (int)(start*length);
     int ebound = (int)(  end*length);
-    if ((int)segments.size() <= 0 && length <= 0) return 0;
+    if (numberOfSegments <= 0 && length <= 0) return 0;
 
-    std::vector<TransitionSegment>::iterator it;
-    for (it = segments.begin(); it != segments.end(); it++)
+    for (int i = firstSegment; i < firstSegment + numberOfSegments; i++)
     {
-        if ( (*it).getColour() == ClassIndex::unclassified )
+        if ( table->getColour(i) == ClassIndex::unclassified )
         {
             continue;
         }
 
-        x = (*it).getStartPoint().x;
-        y = (*it).getStartPoint().y;
+        x = table->getStartPoint(i).x;
+        y = table->getStartPoint(i).y;
         sradius = (int)sqrt( (x-this->start.x)*(x-this->start.x) + (y-this->start.y)*(y-this->start.y));
-        x = (*it).getEndPoint().x;
-        y = (*it).getEndPoint().y;
+        x = table->getEndPoint(i).x;
+        y = table->getEndPoint(i).y;
         eradius = (int)sqrt( (x-this->start.x)*(x-this->start.x) + (y-this->start.y)*(y-this->start.y));
 
         //if the whole segment is within bounds
         if ( sradius >= sbound && sradius <= ebound &&
              eradius >= sbound && eradius <= ebound )
         {
-            fillCount += (*it).getSize();
+            fillCount += table->getSegment(i).getSize();
         }
         //if the start is not within bounds but the tail is inside
         else if(sradius <  start*length &&
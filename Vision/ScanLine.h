@@ -1,9 +1,17 @@
 #ifndef SCANLINE_H
 #define SCANLINE_H
 
-#include <vector>
 #include "TransitionSegment.h"
+#include "SegmentTable.h"
 
+//! A line through the image, and the span of segments found on it.
+/*!
+    The segments are not stored in the line, but in the SegmentTable of the ClassifiedSection
+    the line was added to. The line only keeps the index of its first segment and how many there
+    are, so all of the lines in a section share one contiguous table. Segments must be added to
+    one line at a time; once segments have been added to a later line in the same table, the
+    earlier line's span can not grow.
+  */
 class ScanLine
 {
     public:
@@ -24,13 +32,19 @@ class ScanLine
         void setDirection(int newDirection);
         int getNumberOfSegments();
         void addSegement(const TransitionSegment& segment);
-        TransitionSegment* getSegment(int position);
+        TransitionSegment getSegment(int position);
+        unsigned char getSegmentColour(int position);
+        void setSegmentTable(SegmentTable* newTable, int newIndex);
+        int getIndex();
         float getFill();
         float getFill(Vector2<int> start, Vector2<int> end);
         float getFill(float start, float end);
         Vector2<int> getStart();
     private:
-        std::vector<TransitionSegment> segments;
+        SegmentTable* table;    //!< the table the segments are stored in, NULL until the line is added to a section
+        int index;              //!< the index of the line in its section
+        int firstSegment;       //!< the table index of the line's first segment
+        int numberOfSegments;
         Vector2<int> start;
         int length;
         int direction;
@@ -0,0 +1,57 @@
+#include "SegmentTable.h"
+
+SegmentTable::SegmentTable()
+{
+    return;
+}
+
+SegmentTable::~SegmentTable()
+{
+    return;
+}
+
+//! Removes all of the segments, but keeps the memory for the next frame.
+void SegmentTable::clear()
+{
+    startX.clear();
+    startY.clear();
+    endX.clear();
+    endY.clear();
+    beforeColour.clear();
+    colour.clear();
+    afterColour.clear();
+    line.clear();
+}
+
+void SegmentTable::reserve(int capacity)
+{
+    startX.reserve(capacity);
+    startY.reserve(capacity);
+    endX.reserve(capacity);
+    endY.reserve(capacity);
+    beforeColour.reserve(capacity);
+    colour.reserve(capacity);
+    afterColour.reserve(capacity);
+    line.reserve(capacity);
+}
+
+//! Adds a segment found on the given line, and returns its index in the table.
+int SegmentTable::add(const TransitionSegment& segment, int lineIndex)
+{
+    Vector2<int> start = segment.getStartPoint();
+    Vector2<int> end = segment.getEndPoint();
+    startX.push_back(start.x);
+    startY.push_back(start.y);
+    endX.push_back(end.x);
+    endY.push_back(end.y);
+    beforeColour.push_back(segment.getBeforeColour());
+    colour.push_back(segment.getColour());
+    afterColour.push_back(segment.getAfterColour());
+    line.push_back(lineIndex);
+    return colour.size() - 1;
+}
+
+TransitionSegment SegmentTable::getSegment(int index) const
+{
+    return TransitionSegment(getStartPoint(index), getEndPoint(index), beforeColour[index], colour[index], afterColour[index]);
+}
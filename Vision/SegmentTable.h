@@ -0,0 +1,81 @@
+#ifndef SEGMENTTABLE_H
+#define SEGMENTTABLE_H
+
+#include <vector>
+#include "TransitionSegment.h"
+#include "FrameArena.h"
+
+//! A flat table of the transition segments found on a set of scan lines.
+/*!
+    The segments are stored as a structure of arrays (start, end, before/colour/after and the
+    index of the line they were found on), and are referred to by their index in the table.
+    Clearing the table keeps its memory, so a table that is reused every frame stops
+    allocating once it has grown to the size of a busy frame. A table made during a
+    frame is allocated from the current FrameArena.
+  */
+class SegmentTable
+{
+public:
+    SegmentTable();
+    ~SegmentTable();
+
+    void clear();
+    void reserve(int capacity);
+    int add(const TransitionSegment& segment, int line);
+    int size() const;
+
+    TransitionSegment getSegment(int index) const;
+    Vector2<int> getStartPoint(int index) const;
+    Vector2<int> getEndPoint(int index) const;
+    unsigned char getBeforeColour(int index) const;
+    unsigned char getColour(int index) const;
+    unsigned char getAfterColour(int index) const;
+    int getLine(int index) const;
+
+private:
+    FrameVector<short>::type startX;
+    FrameVector<short>::type startY;
+    FrameVector<short>::type endX;
+    FrameVector<short>::type endY;
+    FrameVector<unsigned char>::type beforeColour;
+    FrameVector<unsigned char>::type colour;
+    FrameVector<unsigned char>::type afterColour;
+    FrameVector<unsigned short>::type line;
+};
+
+inline int SegmentTable::size() const
+{
+    return colour.size();
+}
+
+inline Vector2<int> SegmentTable::getStartPoint(int index) const
+{
+    return Vector2<int>(startX[index], startY[index]);
+}
+
+inline Vector2<int> SegmentTable::getEndPoint(int index) const
+{
+    return Vector2<int>(endX[index], endY[index]);
+}
+
+inline unsigned char SegmentTable::getBeforeColour(int index) const
+{
+    return beforeColour[index];
+}
+
+inline unsigned char SegmentTable::getColour(int index) const
+{
+    return colour[index];
+}
+
+inline unsigned char SegmentTable::getAfterColour(int index) const
+{
+    return afterColour[index];
+}
+
+inline int SegmentTable::getLine(int index) const
+{
+    return line[index];
+}
+
+#endif // SEGMENTTABLE_H
@@ -5,12 +5,13 @@
 #include "Vision/LineDetection.h"
 //#include <QDebug>
 
+#include <algorithm>
+#if defined(__SSE__)
+    #include <xmmintrin.h>
+#endif
+
 using std::vector;
 
-vector<LinePoint*> SAM::noisePoints;
-unsigned int SAM::noFieldLines;
-unsigned int SAM::MAX_LINES, SAM::MAX_POINTS, SAM::MIN_POINTS_OVER, SAM::MIN_POINTS_TO_LINE, SAM::MIN_POINTS_TO_LINE_FINAL, SAM::SPLIT_NOISE_ITERATIONS;
-double SAM::MAX_END_POINT_DIFF, SAM::MIN_LINE_R2_FIT, SAM::SPLIT_DISTANCE;
 //ofstream* SAM::debug_out;
 /*
 std::vector<LinePoint*> SAM::linePoints;
@@ -88,6 +89,11 @@ void SAM::debugPrint(const vector<LinePoint *> &points) {
 
 */
 
+SAM::SAM() {
+    noFieldLines = 0;
+    initRules(1.0, 2, 3, 5, 5.0, 0.90);
+}
+
 void SAM::initRules(double SD, unsigned int MPO, unsigned int MPTL, unsigned int MPTLF, double MEPD, double MLRF) {
     //Sets up parameters
 
@@ -103,26 +109,25 @@ void SAM::initRules(double SD, unsigned int MPO, unsigned int MPTL, unsigned int
 }
 
 //CLUSTERS
-void SAM::splitAndMergeLSClusters(vector<LSFittedLine*>& lines, vector< vector<LinePoint*> >& clusters, vector<LinePoint*> leftover, Vision* vision, LineDetection* linedetector, bool clearsmall, bool cleardirty, bool noise) {
+void SAM::splitAndMergeLSClusters(vector<LSFittedLine*>& lines, const vector< vector<LinePoint*> >& clusters, const vector<LinePoint*>& leftover, Vision* vision, LineDetection* linedetector, bool clearsmall, bool cleardirty, bool noise) {
     //Performs split-and-merge algorithm with input consisting of a set of point clusters
     // and a set of unclustered points, putting the resulting lines into a reference
     // passed vector
 
     //Profiler prof("SplitAndMerge");
-    noFieldLines = 0;
-    noisePoints.clear();
+    clearArena();
 
     //For each cluster..
 
     //prof.start();
     for(unsigned int i=0; i<clusters.size(); i++) {
-        //perform split - splitLS() checks for appropriate size, so that need not be done here
-        splitLSIterative(lines, clusters[i]);
+        //perform split - splitLSIterative() checks for appropriate size, so that need not be done here
+        splitLSIterative(lines, addToArena(clusters[i]));
     }
     //prof.split("Split Clusters");
 
     //Then split leftover
-    splitLSIterative(lines, leftover);
+    splitLSIterative(lines, addToArena(leftover));
     //prof.split("Leftover");
 
     //Then noise
@@ -149,21 +154,19 @@ void SAM::splitAndMergeLSClusters(vector<LSFittedLine*>& lines, vector< vector<L
     //prof.split("Clear Unwanted");
     //debug << prof;
 
-
     noisePoints.clear();
 }
 
 
 //LEAST-SQUARE FITTING
 
-void SAM::splitAndMergeLS(vector<LSFittedLine*>& lines, vector<LinePoint*>& points, bool clearsmall, bool cleardirty, bool noise) {
+void SAM::splitAndMergeLS(vector<LSFittedLine*>& lines, const vector<LinePoint*>& points, bool clearsmall, bool cleardirty, bool noise) {
     /*
      * Split and Merge without clustering
      */
-    noFieldLines = 0;
-    noisePoints.clear();
+    clearArena();
 
-    splitLS(lines, points);
+    splitLSIterative(lines, addToArena(points));
 
     if(noise) {
         for(unsigned int i=0; i<SPLIT_NOISE_ITERATIONS; i++) {
@@ -183,435 +186,262 @@ void SAM::splitAndMergeLS(vector<LSFittedLine*>& lines, vector<LinePoint*>& poin
 }
 
 
-
-void SAM::splitLS(vector<LSFittedLine*>& lines, vector<LinePoint*>& points) {
-    // Recursive split algorithm - not used
-
-    //Assumes:
-    //	- constant detirmined for limit - MIN_POINTS_OVER
-    //	- constant for min splitting distance - SAM_THRESHOLD
-
-    //Boundary Conds
-    if(noFieldLines >= MAX_LINES) {
-        return;
-    }
-    if(points.size() < MIN_POINTS_TO_LINE) {
-        //add points to noise
-        for(unsigned int i=0; i<points.size(); i++)
-            addToNoise(points[i]);
-        return;
-    }
-
-    //temp variables
-    int points_over = 0; //how many points are further from the line than SAM_THRESHOLD
-    int greatest_point = 0; //which point in vector is the furthest
-
-    //LinePoint* temppoint;
-
-
-    //generate new LSFittedLine
-    LSFittedLine* line = new LSFittedLine();
-
-    generateLSLine(*line, points);
-
-    /*
-    //check points for perp distance over threshold
-    for(current_point = 0; current_point < points.size(); current_point++) {
-        distance = line->getLinePointDistance(*(points[current_point]));
-        if(distance > SPLIT_DISTANCE) {
-            //potential splitting point
-            points_over++; //increment points_over counter
-            //check if greatest point
-            if(distance > greatest_distance) {
-                    //new furthest point found
-                    greatest_distance = distance;
-                    greatest_point = current_point;
-            }
-        }
-    }
-    */
-    //check for points over threshold
-    findFurthestPoint(*line, points_over, greatest_point);
-
-    //if num points over threshold > limit -> split at greatest distance point.
-    if(points_over >= MIN_POINTS_OVER) {
-        //there are enough points distant to justify a split
-        vector<LinePoint*> left;
-        vector<LinePoint*> right;
-        if(separateLS(left, right, points[greatest_point], *line)) {
-            if(left.size() >= MIN_POINTS_TO_LINE) {
-                splitLS(lines, left);
-            }
-            else {
-                //add left to noise Points
-                for(unsigned int i=0; i<left.size(); i++)
-                    addToNoise(left[i]);
-            }
-            if(right.size() >= MIN_POINTS_TO_LINE) {
-                splitLS(lines, right);
-            }
-            else {
-                //add right to noise Points
-                for(unsigned int i=0; i<right.size(); i++)
-                    addToNoise(right[i]);
-            }
-        }
-        else {
-            //remove furthest point and retry
-            vector<LinePoint*> newlist = points;
-            addToNoise(newlist[greatest_point]);
-            for(unsigned int i=greatest_point; i<newlist.size()-1; i++) {
-                newlist[i] = newlist[i+1];
-            }
-            newlist[newlist.size()-1] = 0;
-            newlist.pop_back();
-            splitLS(lines, newlist);
-        }
-    }
-    else if(points_over > 0) {
-        //not enough points over to split so remove point as noisy, and regen line
-        if(points.size() > MIN_POINTS_TO_LINE_FINAL) {
-            //i.e. removal of a point will still leave enough to form a reasonable line
-            vector<LinePoint*> newlist = points;
-            addToNoise(newlist[greatest_point]);
-            for(unsigned int i=greatest_point; i<newlist.size()-1; i++) {
-                newlist[i] = newlist[i+1];
-            }
-            newlist[newlist.size()-1] = 0;
-            newlist.pop_back();
-            delete line; //clear memory of old line
-            line = new LSFittedLine();
-            generateLSLine(*line, newlist);
-            lines.push_back(line);
-        }
-        else {
-            //NOT SURE ??
-            //Add points to noise and delete line
-            //lines.push_back(line);
-            for(unsigned int i=0; i<points.size(); i++)
-                addToNoise(points[i]);
-            line->getPoints().clear();
-            delete line;
-
-        }
-    }
-    else {
-        //no points over, just push line
-        lines.push_back(line);
-    }
-}
-
-void SAM::splitLSIterative(vector<LSFittedLine*>& lines, vector<LinePoint*>& points) {
-    //Iterative split algorithm, uses a stack of lines and iterates over it, splitting
-    //each line or adding it to a final list.
+void SAM::splitLSIterative(vector<LSFittedLine*>& lines, Range range) {
+    //Iterative split algorithm, uses a stack of ranges and iterates over it, splitting
+    //each range or adding it to the final list of lines.
 
     //Boundary Conds
     if(noFieldLines >= MAX_LINES) {
         return;
     }
-    if(points.size() < MIN_POINTS_TO_LINE) {
+    if(range.size() < MIN_POINTS_TO_LINE) {
         //add points to noise
-        for(unsigned int i=0; i<points.size(); i++)
-            addToNoise(points[i]);
+        addToNoise(range);
         return;
     }
 
     //Locals
-    vector<LSFittedLine*> stack;
-    stack.clear();
-    int furthest_point, points_over;
-    vector<LinePoint*> left, right;
+    int points_over;
+    unsigned int furthest_point, opposite_point;
+    Range left, right;
 
-    LSFittedLine* tempLine = new LSFittedLine();
-    //generate first line
-    generateLSLine(*tempLine, points);
-    //push line onto stack
-    stack.push_back(tempLine);
+    stack.clear();
+    stack.push_back(range);
 
     //Begin iteration
     while(!stack.empty() && noFieldLines + stack.size() < MAX_LINES) {
-        //Pop the top line off and split it if warranted
-        //if not, slap it on the end of lines and go again
+        //Pop the top range off and split it if warranted
+        //if not, make it a line and go again
         //until stack is empty or maximum lines reached
-//qDebug() << stack.size();
-        //Clear left and right
-        left.clear();
-        right.clear();
-
-        //pop top line
-        tempLine = stack.back();
+        range = stack.back();
         stack.pop_back();
 
         //check for points over threshold
-        findFurthestPoint(*tempLine, points_over, furthest_point);
+        fitRange(range);
+        findFurthestPoint(range, points_over, furthest_point, opposite_point);
 
         //Options
-        if(points_over >= MIN_POINTS_OVER) {
-            //See if separation is an option
-            if(separateLS(left, right, tempLine->getPoints()[furthest_point], *tempLine)) {
-                //qDebug() << "separating worked";
-                //clear old line
-                tempLine->getPoints().clear();
-                delete tempLine;
+        if(points_over >= (int)MIN_POINTS_OVER) {
+            //See if separation is an option. When the furthest point is at an end of the range (ie. the range is
+            //bent like an L) the furthest point on the other side of the line is the bend, so try that next.
+            if(separateLS(left, right, furthest_point, range) || (opposite_point != range.end && separateLS(left, right, opposite_point, range))) {
                 //check if left is big enough
-                if(left.size() >= MIN_POINTS_TO_LINE) {
-                    //generate line and push it to stack
-                    tempLine = new LSFittedLine();
-                    generateLSLine(*tempLine, left);
-                    stack.push_back(tempLine);
-                }
-                else {
-                    //throw left points to noise
-                    for(unsigned int i=0; i<left.size(); i++)
-                        addToNoise(left[i]);
-                    left.clear();
-                }
+                if(left.size() >= MIN_POINTS_TO_LINE)
+                    stack.push_back(left);
+                else
+                    addToNoise(left);
                 //check if right is big enough
-                if(right.size() >= MIN_POINTS_TO_LINE) {
-                    //generate line and push it to stack
-                    tempLine = new LSFittedLine();
-                    generateLSLine(*tempLine, right);
-                    stack.push_back(tempLine);
-                }
-                else {
-                    //throw right points to noise
-                    for(unsigned int i=0; i<right.size(); i++)
-                        addToNoise(right[i]);
-                    right.clear();
-                }
-            } //if(separate())
+                if(right.size() >= MIN_POINTS_TO_LINE)
+                    stack.push_back(right);
+                else
+                    addToNoise(right);
+            }
             else {
                 //Separation didn't work
-                //remove furthest point and push new line
-                vector<LinePoint*> newlist = tempLine->getPoints();
-                //remove noisy point and update points list
-                addToNoise(newlist[furthest_point]);
-                newlist[furthest_point] = newlist[newlist.size() - 1];
-                newlist[newlist.size()-1] = 0;
-                newlist.pop_back();
-                //clear old line
-                tempLine->getPoints().clear();
-                delete tempLine;
-                tempLine = new LSFittedLine();
-                generateLSLine(*tempLine, newlist); //make new line
-                stack.push_back(tempLine); //push it back
+                //remove furthest point and try again
+                removeFromRange(range, furthest_point);
+                if(range.size() >= MIN_POINTS_TO_LINE)
+                    stack.push_back(range);
+                else
+                    addToNoise(range);
             }
-        } //if(points_over >= MIN_POINTS_OVER)
-        else if(points_over > 0){
+        }
+        else if(points_over > 0) {
             //not enough points over to split - but there are points over
-            if(tempLine->getPoints().size() > MIN_POINTS_TO_LINE_FINAL) {
+            if(range.size() > MIN_POINTS_TO_LINE_FINAL) {
                 //i.e. removal of a point will still leave enough to form a reasonable line
-                //remove noisy point and regen line
-                vector<LinePoint*> newlist = tempLine->getPoints();
-                //remove noisy point and update points list
-                addToNoise(newlist[furthest_point]);
-                newlist[furthest_point] = newlist[newlist.size() - 1];
-                newlist[newlist.size()-1] = 0;
-                newlist.pop_back();
-                tempLine->getPoints().clear();
-                delete tempLine; //clear memory of old line
-                tempLine = new LSFittedLine();
-                generateLSLine(*tempLine, newlist); //make new line
-                //qDebug() << "pushing line";
-                lines.push_back(tempLine); //push it back to finals
+                //remove noisy point and keep the line
+                removeFromRange(range, furthest_point);
+                pushLine(lines, range);
                 noFieldLines++;
             }
             else {
-                //Add points to noise and delete line
-                for(unsigned int i=0; i<tempLine->getPoints().size(); i++)
-                    addToNoise(tempLine->getPoints()[i]);
-                tempLine->getPoints().clear();
-                delete tempLine;
+                //Add points to noise
+                addToNoise(range);
             }
-        } //elseif(points_over > 0)
+        }
         else {
             //no points over, just push line to finals
-            //qDebug() << "pushing line";
-            lines.push_back(tempLine);
+            pushLine(lines, range);
             noFieldLines++;
         }
-    } // While(!stack.empty() && noFieldLines + stack.size() <= MAX_LINES)
-
+    }
 
-//qDebug() << stack.size();
     //If MAX_LINES reached, but stack is not empty push stack lines to finals
-    if(noFieldLines + stack.size() == MAX_LINES) {
-        //qDebug() << "Maximum Lines reached in split";
-    }
     while(!stack.empty()) {
-        lines.push_back(stack.back());
+        pushLine(lines, stack.back());
         stack.pop_back();
     }
 }
 
-void SAM::findFurthestPoint(LSFittedLine& line, int& points_over, int& furthest_point) {
-    //this method finds the furthest point from a line and returns (via parameters)
-    //the number of points over the SPLIT_DISTANCE threshold and the index of
-    //the furthest point
+/*! @brief Calculates the signed perpendicular distance from the line to each point in an array
+    @param x the x coordinates of the points
+    @param y the y coordinates of the points
+    @param n the number of points
+    @param a the normalised x coefficient of the line
+    @param b the normalised y coefficient of the line
+    @param c the normalised constant of the line
+    @param distances the array to put the distances in
+ */
+static void scanDistances(const float* x, const float* y, unsigned int n, float a, float b, float c, float* distances) {
+    unsigned int i = 0;
+#if defined(__SSE__)
+    //four points at a time
+    const __m128 va = _mm_set1_ps(a);
+    const __m128 vb = _mm_set1_ps(b);
+    const __m128 vc = _mm_set1_ps(c);
+    for(; i+4 <= n; i+=4) {
+        __m128 d = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(va, _mm_loadu_ps(x + i)), _mm_mul_ps(vb, _mm_loadu_ps(y + i))), vc);
+        _mm_storeu_ps(distances + i, d);
+    }
+#endif
+    for(; i<n; i++)
+        distances[i] = a*x[i] + b*y[i] - c;
+}
+
+void SAM::findFurthestPoint(const Range& range, int& points_over, unsigned int& furthest_point, unsigned int& opposite_point) {
+    //this method finds the furthest point in the range from the fitted line and returns (via parameters)
+    //the number of points over the SPLIT_DISTANCE threshold, the arena index of
+    //the furthest point, and the arena index of the furthest point over the threshold on
+    //the other side of the line (range.end if there is none)
 
-    //temp variables
-    double distance = 0.0; 	//holder for calculated LinePointDistance
-    double greatest_distance = 0.0; //saves recalculation of greatest point distance
-    unsigned int current_point = 0;
     points_over = 0;
-    furthest_point = -1;
-    vector<LinePoint*> points = line.getPoints();
-    double A, B, C;
-    A = line.getA();
-    B = line.getB();
-    C = line.getC();
-    double denom = sqrt(A*A + B*B);
-    LinePoint* temp;
+    furthest_point = range.begin;
+    opposite_point = range.end;
+    const unsigned int n = range.size();
+    if(n == 0)
+        return;
 
-    //check points for perp distance over threshold
-    for(current_point = 0; current_point < points.size(); current_point++) {
-        temp = points[current_point];
-        distance = fabs(A * temp->x + B * temp->y - C) / denom;
-        if(distance > SPLIT_DISTANCE) {
+    double A = fit.getA();
+    double B = fit.getB();
+    double C = fit.getC();
+    double denom = sqrt(A*A + B*B);
+    if(scratch.size() < n)
+        scratch.resize(n);
+    scanDistances(&arenaX[range.begin], &arenaY[range.begin], n, A/denom, B/denom, C/denom, &scratch[0]);
+
+    //check points for perp distance over threshold, keeping the furthest on each side
+    float greatest_positive = 0, greatest_negative = 0;
+    unsigned int positive_point = range.end, negative_point = range.end;
+    const float threshold = SPLIT_DISTANCE;
+    for(unsigned int i=0; i<n; i++) {
+        if(scratch[i] > threshold) {
             //potential splitting point
-            points_over++; //increment points_over counter
-            //check if greatest point
-            if(distance > greatest_distance) {
-                    //new furthest point found
-                    greatest_distance = distance;
-                    furthest_point = current_point;
+            points_over++;
+            if(scratch[i] > greatest_positive) {
+                greatest_positive = scratch[i];
+                positive_point = range.begin + i;
+            }
+        }
+        else if(-scratch[i] > threshold) {
+            points_over++;
+            if(-scratch[i] > greatest_negative) {
+                greatest_negative = -scratch[i];
+                negative_point = range.begin + i;
             }
         }
     }
+    if(points_over == 0)
+        return;
+    if(greatest_positive >= greatest_negative) {
+        furthest_point = positive_point;
+        opposite_point = negative_point;
+    }
+    else {
+        furthest_point = negative_point;
+        opposite_point = positive_point;
+    }
 }
 
 void SAM::splitNoiseLS(vector<LSFittedLine*>& lines) {
-    //this method creates a copy of the noisePoints vector,
-    //clears the current noisePoints vector and runs
-    //the split algorithm on the copy
+    //this method moves the noise points to a new range of the arena,
+    //clears the current noise and runs the split algorithm on the new range
 
     if(noisePoints.size() >= MIN_POINTS_TO_LINE_FINAL) {
-        vector<LinePoint*> noiseCopy;
-
-        noiseCopy = noisePoints;
+        Range range;
+        range.begin = arenaIndex.size();
+        for(unsigned int i=0; i<noisePoints.size(); i++) {
+            noiseFlags[noisePoints[i]] = 0;
+            appendToArena(noisePoints[i]);
+        }
+        range.end = arenaIndex.size();
         noisePoints.clear();
-        splitLSIterative(lines, noiseCopy);
+        splitLSIterative(lines, range);
     }
 }
 
 
-bool SAM::separateLS(vector<LinePoint*>& left, vector<LinePoint*>& right, LinePoint* split_point, LSFittedLine& line) {
-        /*splits a section of points around a splitting point by rotating and translating onto the line about the splitting point
-         *Pre: left and right should be empty vectors
-         *		points contains all the points to be split
-         *		split_point is a valid point in points
-         *		line is the LSFittedLine
-         *Post: left contains all points with negative transformed x-vals
-         *		right contains all points with non-negative transformed x-vals (note split_point will be in right)
-         *      if left or right is empty, returns false indicating no actual split occurred
+bool SAM::separateLS(Range& left, Range& right, unsigned int split_point, const Range& range) {
+        /*splits a range of points around a splitting point by rotating and translating onto the line about the splitting point
+         *Pre: split_point is an arena index in range
+         *		the fit is the line fitted to range
+         *Post: left is a new range of all points with negative transformed x-vals
+         *		right is a new range of all points with non-negative transformed x-vals
+         *      split_point is the first point of both left and right
+         *      if left or right would contain the entire range, returns false indicating no split occurred
+         *      and no new ranges are made
         */
 
-        //temp holder vars
-        double A = line.getA();
-        double B = line.getB();
-        double C = line.getC();
-        double x1 = split_point->x;
-        double y1 = split_point->y;
-        vector<LinePoint*> points = line.getPoints();
-        //vector<LinePoint*> points = *points;
-
-        left.push_back(split_point);
-        right.push_back(split_point);
-/*****DEBUGGING OUTPUT******/
-        //printf("\nSplitting on: (%.2f,%.2f)\n",x1,y1);
-/*****DEBUGGING OUTPUT******/
-        if(A==0.0) {
+        //the transformed x-val of a point is its projection onto the direction of the line
+        //relative to the split point. This is the same for a horizontal, vertical and sloped line
+        //(rotation by a = atan(-A/B)) provided the direction has a non-negative x component.
+        double A = fit.getA();
+        double B = fit.getB();
+        double dx, dy;
+        if(A == 0.0) {
             //horizontal line - no rotation
-            //x' = x - x0
-            for(unsigned int pointcounter = 0; pointcounter < points.size(); pointcounter++) {
-                //check all points, calculate translated x coord
-                //and place in appropriate vector
-                if(!(points[pointcounter] == split_point)) {
-                    if(points[pointcounter]->x < x1) {
-                        //point is to the left
-                        left.push_back(points[pointcounter]);
-                    }
-                    else {
-                        right.push_back(points[pointcounter]);
-                    }
-                }
-            }
+            dx = 1;
+            dy = 0;
         }
-        else if(B==0.0) {
+        else if(B == 0.0) {
             //vertical line - 90 degree rotation
-            //x' = y - y0
-            for(unsigned int pointcounter = 0; pointcounter < points.size(); pointcounter++) {
-                //check all points, calculate translated x coord
-                //and place in appropriate vector
-                if(!(points[pointcounter] == split_point)) {
-                    if(points[pointcounter]->y < y1) {
-                        //point is to the left
-                        left.push_back(points[pointcounter]);
-                    }
-                    else {
-                        right.push_back(points[pointcounter]);
-                    }
-                }
-            }
+            dx = 0;
+            dy = 1;
         }
         else {
-         // STILL TO DO: FIX MATRIX CALCS
-
             //sloped line
-            //x' = (x - x0)cosa + (y - y0)sina
-            //a = atan(-A/B)
-            //(x0,y0) from [ a, b; b, -a][x; y] = [c; bx1 - ay1]
-            double alpha = atan(-A/B);
-            double cosalpha = cos(alpha);
-            double sinalpha = sin(alpha);
-            double xtrans;
-            // Mx = k  ->  x = M^-1k
-            //M = |A   B|
-            //    |B  -A|
-
-            // k = |    c    |
-            //     | bx1-ay1 |
-            double KB;
-            KB = (B*x1) - (A*y1);
-
-            //invert M
-            // InvM = |-A/div  -B  |
-            //        |  -B   A/div|
-            // div = A*-A - B*B
-            double IA, ID;
-            double div = (-A)*A - (B*B);
-            IA = (-A)/div;
-            ID = -IA;
-
-            //X = A*K
-            //  = |-A/div  -B  |  |    c    |
-            //    |  -B   A/div|  | bx1-ay1 |
-
-            double X0 = IA*C + (-B)*KB;
-            double X1 = (-B)*C + ID*KB;
-
-            for(unsigned int pointcounter = 0; pointcounter <points.size(); pointcounter++) {
-                //check all points, calculate translated x coord
-                //and place in appropriate vector
-                if(!(points[pointcounter] == split_point)) {
-                    xtrans = (points[pointcounter]->x - X0)*cosalpha + (points[pointcounter]->y - X1)*sinalpha;
-                    if(xtrans < 0) {
-                        //point is to the left
-                        left.push_back(points[pointcounter]);
-                    }
-                    else {
-                        right.push_back(points[pointcounter]);
-                    }
-                }
-            }
+            double norm = sqrt(A*A + B*B);
+            dx = fabs(B)/norm;
+            dy = B > 0 ? -A/norm : A/norm;
+        }
+        const float x1 = arenaX[split_point];
+        const float y1 = arenaY[split_point];
+        const float fdx = dx;
+        const float fdy = dy;
+
+        const unsigned int n = range.size();
+        if(scratch.size() < n)
+            scratch.resize(n);
+        unsigned int numleft = 0;
+        for(unsigned int i=0; i<n; i++) {
+            scratch[i] = (arenaX[range.begin + i] - x1)*fdx + (arenaY[range.begin + i] - y1)*fdy;
+            numleft += scratch[i] < 0;
         }
+        //the split point itself has a transformed x-val of zero
+        unsigned int numright = n - 1 - numleft;
+
         //if either left or right contains entire point set then there will be an
         //infinite loop
-        //qDebug() << "Old line size: " << line.getPoints().size() << " Left size: " << left.size() << " Right size: " << right.size();
-        if(left.size() == points.size() || right.size() == points.size())
+        if(numleft == 0 || numright == 0)
             return false;
-        return true;
 
+        //copy each half to the end of the arena
+        left.begin = arenaIndex.size();
+        appendToArena(arenaIndex[split_point]);
+        for(unsigned int i=0; i<n; i++) {
+            if(scratch[i] < 0)
+                appendToArena(arenaIndex[range.begin + i]);
+        }
+        left.end = arenaIndex.size();
+
+        right.begin = arenaIndex.size();
+        appendToArena(arenaIndex[split_point]);
+        for(unsigned int i=0; i<n; i++) {
+            if(scratch[i] >= 0 && range.begin + i != split_point)
+                appendToArena(arenaIndex[range.begin + i]);
+        }
+        right.end = arenaIndex.size();
+        return true;
 }
 
 
@@ -620,47 +450,111 @@ void SAM::mergeLS(vector<LSFittedLine*>& lines) {
     // Compares all lines and merges based on the return value of
     // shouldMergeLines(Line, Line) - edit that method not this one
 
-    vector<LSFittedLine*> finals; //this vector contains lines that did not need merging
-
-    unsigned int i; //counter
-    LSFittedLine* current; //pointer to current line
-
-
-    while(!lines.empty()) {
-        //get next line
-        current = lines.back();
-        lines.pop_back();
-        //go through all lines and find any that should be merged - merge them
-        for(i=0; i<lines.size(); i++) {
-            if(shouldMergeLines(*current, *lines[i])) {
+    for(unsigned int i=0; i<lines.size(); i++) {
+        //go through all remaining lines and find any that should be merged - merge them
+        unsigned int j = i+1;
+        while(j<lines.size()) {
+            if(shouldMergeLines(*lines[i], *lines[j])) {
                 //join the lines
-                current->joinLine(*(lines[i]));
-                //remove the considered line and update line list
-                delete lines[i];
-                if(i<lines.size())
-                    lines[i] = lines.back();
+                lines[i]->joinLine(*lines[j]);
+                //remove the considered line, the last line takes its place and needs to be checked
+                delete lines[j];
+                lines[j] = lines.back();
                 lines.pop_back();
-
-                //need to check against newly inserted line
-                i--;
+            }
+            else {
+                j++;
             }
         }
-        //Now current should have been merged with any valid lines
-        //push current to finals
-        finals.push_back(current);
-    }
-    while(!finals.empty()) {
-        lines.push_back(finals.back());
-        finals.pop_back();
     }
 }
 
 
-void SAM::generateLSLine(LSFittedLine& line, vector<LinePoint*>& points) {
-    //creates a Least Squared Fitted line
 
-    line.clearPoints();
-    line.addPoints(points);
+
+//POINT ARENA
+
+/*! @brief Empties the point arena and the noise, ready for a new frame */
+void SAM::clearArena() {
+    noFieldLines = 0;
+    points.clear();
+    noiseFlags.clear();
+    noisePoints.clear();
+    arenaIndex.clear();
+    arenaX.clear();
+    arenaY.clear();
+    arenaMoments.clear();
+    Moments zero = {0, 0, 0, 0, 0, 0};
+    arenaMoments.push_back(zero);
+}
+
+/*! @brief Adds a set of points to the frame, and returns the range of the arena containing them */
+SAM::Range SAM::addToArena(const vector<LinePoint*>& pointlist) {
+    Range range;
+    range.begin = arenaIndex.size();
+    for(unsigned int i=0; i<pointlist.size(); i++) {
+        points.push_back(pointlist[i]);
+        noiseFlags.push_back(0);
+        appendToArena(points.size() - 1);
+    }
+    range.end = arenaIndex.size();
+    return range;
+}
+
+/*! @brief Appends points[index] to the end of the arena, and extends the moment prefix sum */
+void SAM::appendToArena(unsigned int index) {
+    const LinePoint* p = points[index];
+    Moments m = arenaMoments.back();
+    m.n += 1;
+    m.x += p->x;
+    m.y += p->y;
+    m.xx += p->x * p->x;
+    m.yy += p->y * p->y;
+    m.xy += p->x * p->y;
+    arenaIndex.push_back(index);
+    arenaX.push_back(p->x);
+    arenaY.push_back(p->y);
+    arenaMoments.push_back(m);
+}
+
+/*! @brief Fits the least-squares line to a range of the arena in O(1) from the prefix sums */
+void SAM::fitRange(const Range& range) {
+    const Moments& b = arenaMoments[range.begin];
+    const Moments& e = arenaMoments[range.end];
+    fit.setMoments(range.size(), e.x - b.x, e.y - b.y, e.xx - b.xx, e.yy - b.yy, e.xy - b.xy);
+}
+
+/*! @brief Throws the point at an arena index in a range to the noise, and removes it from the range.
+           The last point in the range takes its place, and only the prefix sums within the range are updated.
+ */
+void SAM::removeFromRange(Range& range, unsigned int index) {
+    addToNoise(arenaIndex[index]);
+    unsigned int last = range.end - 1;
+    std::swap(arenaIndex[index], arenaIndex[last]);
+    std::swap(arenaX[index], arenaX[last]);
+    std::swap(arenaY[index], arenaY[last]);
+    range.end = last;
+    for(unsigned int i=index; i<last; i++) {
+        const LinePoint* p = points[arenaIndex[i]];
+        Moments& m = arenaMoments[i+1];
+        m = arenaMoments[i];
+        m.n += 1;
+        m.x += p->x;
+        m.y += p->y;
+        m.xx += p->x * p->x;
+        m.yy += p->y * p->y;
+        m.xy += p->x * p->y;
+    }
+}
+
+/*! @brief Creates a new LSFittedLine from the points in a range, and adds it to lines */
+void SAM::pushLine(vector<LSFittedLine*>& lines, const Range& range) {
+    linePoints.clear();
+    for(unsigned int i=range.begin; i<range.end; i++)
+        linePoints.push_back(points[arenaIndex[i]]);
+    LSFittedLine* line = new LSFittedLine();
+    line->addPoints(linePoints);
+    lines.push_back(line);
 }
 
 
@@ -668,42 +562,32 @@ void SAM::generateLSLine(LSFittedLine& line, vector<LinePoint*>& points) {
 
 //GENERIC
 
-void SAM::addToNoise(LinePoint* point) {
-    //NOT EFFICIENT
-    //O(M) for every insertion - where M is the size of noisePoints
-    bool add = true;
-    for(unsigned int i=0; i<noisePoints.size(); i++) {
-        if(*noisePoints[i] == *point)
-            add = false;
-    }
-    if(add) {
-        noisePoints.push_back(point);
+void SAM::addToNoise(unsigned int index) {
+    //O(1) - the flag keeps a point from being added twice
+    if(!noiseFlags[index]) {
+        noiseFlags[index] = 1;
+        noisePoints.push_back(index);
     }
 }
 
+void SAM::addToNoise(const Range& range) {
+    for(unsigned int i=range.begin; i<range.end; i++)
+        addToNoise(arenaIndex[i]);
+}
+
 
 void SAM::clearSmallLines(vector<LSFittedLine*>& lines) {
     //removes any lines from the vector whose vector of
     //member points is too small
 
-    vector<LSFittedLine*> stack;
-    LSFittedLine* l1;
-    while(!lines.empty()) {
-        l1 = lines.back();
-        if(l1->getPoints().size() >= MIN_POINTS_TO_LINE_FINAL) {
-            //keep line
-            stack.push_back(l1);
-        }
-        else {
-            delete l1;
-        }
-        //else throw line away
-        lines.pop_back();
-    }
-    while(!stack.empty()) {
-        lines.push_back(stack.back());
-        stack.pop_back();
+    unsigned int kept = 0;
+    for(unsigned int i=0; i<lines.size(); i++) {
+        if(lines[i]->getPoints().size() >= MIN_POINTS_TO_LINE_FINAL)
+            lines[kept++] = lines[i];
+        else
+            delete lines[i];
     }
+    lines.resize(kept);
 }
 
 
@@ -711,24 +595,14 @@ void SAM::clearDirtyLines(vector<LSFittedLine*>& lines) {
     //removes any lines from the vector whose R^2 value is
     //less than MIN_LINE_R2_FIT
 
-    vector<LSFittedLine*> stack;
-    LSFittedLine* l1;
-    while(!lines.empty()) {
-        l1 = lines.back();
-        if(l1->getr2tls() >= MIN_LINE_R2_FIT) {
-            //keep line
-            stack.push_back(l1);
-        }
-        else {
-            delete l1;
-        }
-        //else throw line away
-        lines.pop_back();
-    }
-    while(!stack.empty()) {
-        lines.push_back(stack.back());
-        stack.pop_back();
+    unsigned int kept = 0;
+    for(unsigned int i=0; i<lines.size(); i++) {
+        if(lines[i]->getr2tls() >= MIN_LINE_R2_FIT)
+            lines[kept++] = lines[i];
+        else
+            delete lines[i];
     }
+    lines.resize(kept);
 }
 
 bool SAM::shouldMergeLines(const LSFittedLine& line1, const LSFittedLine& line2){
@@ -843,4 +717,5 @@ bool SAM::convertLinesEndPoints(vector<LSFittedLine *> &lines, Vision *vision, L
         linedetector->GetDistanceToPoint(*righttrans, relativePoint, vision);
         righttrans->y = relativePoint[0] * sin(relativePoint[1]) * cos(relativePoint[2]);
     }
+    return true;
 }
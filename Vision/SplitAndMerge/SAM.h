@@ -2,10 +2,18 @@
  * Author: Shannon Fenn
  * Last Modified: 25/02/11
  * Description:
- *      - A static class of method implementing the split and merge line extraction
-        algorithm for us on the NAO robot platform
-
-        - Parameters are static member variable set by initRules(), rather than
+ *      - A class implementing the split and merge line extraction
+        algorithm for us on the NAO robot platform. Each LineDetection owns its own SAM,
+        so that several Vision instances can extract lines in parallel.
+
+        - The input points are copied once into a contiguous arena. Every candidate line
+        is a range of the arena, and a prefix sum of the point moments is kept alongside,
+        so that the least-squares line of a range is fitted in O(1) without touching the
+        points. Splitting a range appends its two halves to the end of the arena, so the
+        whole extraction is linear in the number of points (for the bounded number of lines).
+        The arena is allocated from the current FrameArena, so it is given back at the end of the frame.
+
+        - Parameters are member variables set by initRules(), rather than
         #define macros. Make sure to call this method with reasonable values
         before calling splitAndMergeLS() or splitAndMergeLSClusters()
 
@@ -16,7 +24,7 @@
         - If things need to be changed the main decisions are in:
          + splitLSIterative() - decisions on whether to split, keep or throw away lines
          + findFurthestPoint() - finds the number of points distant from the line, and the furthest point
-         + separateLS() - divides point set into two subsets based on the line equation and the furthest point
+         + separateLS() - divides a range into two new ranges based on the line equation and the furthest point
                 uses a transform to axis defined by the line itself, and the normal from the furthest point
                 to the line.
          + shouldMergeLines() - decisions on whether two lines should be merged
@@ -37,6 +45,7 @@
 #include "Tools/Math/LSFittedLine.h"
 #include "Tools/Math/Matrix.h"
 #include "Tools/Math/Vector3.h"
+#include "Vision/FrameArena.h"
 
 //Debug rules
 #define DEBUG 0
@@ -56,35 +65,59 @@ using namespace std;
 class SAM
 {
 public:
+    SAM();
 
-    static vector<LinePoint*> noisePoints;
-    static unsigned int noFieldLines;
+    unsigned int noFieldLines;
 
     //GENERIC
     //static void initDebug(ofstream& dout);
-    static void initRules(double SD, unsigned int MPO, unsigned int MPTL, unsigned int MPTLF, double MEPD, double MLRF);
+    void initRules(double SD, unsigned int MPO, unsigned int MPTL, unsigned int MPTLF, double MEPD, double MLRF);
 
     //LEAST-SQUARES FITTING
-    static void splitAndMergeLS(vector<LSFittedLine*>& lines, vector<LinePoint*>& points, bool clearsmall=true, bool cleardirty=true, bool noise=true);
+    void splitAndMergeLS(vector<LSFittedLine*>& lines, const vector<LinePoint*>& points, bool clearsmall=true, bool cleardirty=true, bool noise=true);
     //CLUSTERS
-    static void splitAndMergeLSClusters(vector<LSFittedLine*>& lines, vector< vector<LinePoint*> >& clusters, vector<LinePoint*> leftover, Vision* vision, LineDetection* linedetector, bool clearsmall=true, bool cleardirty=true, bool noise=true);
+    void splitAndMergeLSClusters(vector<LSFittedLine*>& lines, const vector< vector<LinePoint*> >& clusters, const vector<LinePoint*>& leftover, Vision* vision, LineDetection* linedetector, bool clearsmall=true, bool cleardirty=true, bool noise=true);
 
 private:
+    //! The sums of x, y, x^2, y^2 and xy over a set of points. The least-squares line of a set is a function of these alone.
+    struct Moments
+    {
+        double n, x, y, xx, yy, xy;
+    };
+    //! A contiguous range [begin, end) of the point arena
+    struct Range
+    {
+        unsigned int begin, end;
+        unsigned int size() const {return end - begin;}
+    };
+
     //RULES
     //maximum field objects rules
-    static unsigned int MAX_POINTS; //500
-    static unsigned int MAX_LINES; //15
+    unsigned int MAX_POINTS; //500
+    unsigned int MAX_LINES; //15
     //splitting rules
-    static double SPLIT_DISTANCE; //1.0
-    static unsigned int MIN_POINTS_OVER; //2
-    static unsigned int MIN_POINTS_TO_LINE; //3
+    double SPLIT_DISTANCE; //1.0
+    unsigned int MIN_POINTS_OVER; //2
+    unsigned int MIN_POINTS_TO_LINE; //3
     //Noise splitting rules
-    static unsigned int SPLIT_NOISE_ITERATIONS; //1
+    unsigned int SPLIT_NOISE_ITERATIONS; //1
     //merging rules
-    static double MAX_END_POINT_DIFF; //5.0
+    double MAX_END_POINT_DIFF; //5.0
     //Line keeping rules
-    static unsigned int MIN_POINTS_TO_LINE_FINAL; //5
-    static double MIN_LINE_R2_FIT; //0.90
+    unsigned int MIN_POINTS_TO_LINE_FINAL; //5
+    double MIN_LINE_R2_FIT; //0.90
+
+    //POINT ARENA - allocated from the FrameArena that was current when the SAM was created
+    FrameVector<LinePoint*>::type points;           //every input point this frame
+    FrameVector<unsigned char>::type noiseFlags;    //noiseFlags[i] is set while points[i] is in noisePoints
+    FrameVector<unsigned int>::type noisePoints;    //indices into points of the points thrown away as noise
+    FrameVector<unsigned int>::type arenaIndex;     //the arena; each entry is an index into points
+    FrameVector<float>::type arenaX, arenaY;        //the coordinates of each arena entry, kept contiguous for the distance scan
+    FrameVector<Moments>::type arenaMoments;        //arenaMoments[i] is the sum of the moments of arena entries [0, i)
+    FrameVector<float>::type scratch;               //distances or projections of the range being considered
+    FrameVector<Range>::type stack;                 //the ranges still to be split
+    vector<LinePoint*> linePoints;                  //the points of a range, handed to an LSFittedLine
+    LSFittedLine fit;                               //the line fitted to the range being considered
 
     //DEBUGGING
     /*
@@ -97,23 +130,29 @@ private:
     static void debugPrint(const vector<LinePoint*>& points);
     */
 
+    //POINT ARENA
+    void clearArena();
+    Range addToArena(const vector<LinePoint*>& pointlist);
+    void appendToArena(unsigned int index);
+    void fitRange(const Range& range);
+    void removeFromRange(Range& range, unsigned int index);
+    void pushLine(vector<LSFittedLine*>& lines, const Range& range);
+
     //LEAST-SQUARES FITTING
-    static void splitLS(vector<LSFittedLine*>& lines, vector<LinePoint*>& points);
-    static void splitLSIterative(vector<LSFittedLine*>& lines, vector<LinePoint*>& points);
-    static void splitNoiseLS(vector<LSFittedLine*>& lines);
-    static void mergeLS(vector<LSFittedLine*>& lines);
-    static void generateLSLine(LSFittedLine& line, vector<LinePoint*>& points);
-    static bool separateLS(vector<LinePoint*>& left, vector<LinePoint*>& right, LinePoint* split_point, LSFittedLine& line);
-    //static void sortLinesLS(vector<LSFittedLine*>& lines);
+    void splitLSIterative(vector<LSFittedLine*>& lines, Range range);
+    void splitNoiseLS(vector<LSFittedLine*>& lines);
+    void mergeLS(vector<LSFittedLine*>& lines);
+    bool separateLS(Range& left, Range& right, unsigned int split_point, const Range& range);
 
 
     //GENERIC
-    static void findFurthestPoint(LSFittedLine& line, int& points_over, int& furthest_point);
-    static void addToNoise(LinePoint* point);
-    static void clearSmallLines(vector<LSFittedLine*>& lines);
-    static void clearDirtyLines(vector<LSFittedLine*>& lines);
-    static bool shouldMergeLines(const LSFittedLine& line1, const LSFittedLine& line2);
-    static bool convertLinesEndPoints(vector<LSFittedLine*>& lines, Vision* vision, LineDetection* linedetector);
+    void findFurthestPoint(const Range& range, int& points_over, unsigned int& furthest_point, unsigned int& opposite_point);
+    void addToNoise(unsigned int index);
+    void addToNoise(const Range& range);
+    void clearSmallLines(vector<LSFittedLine*>& lines);
+    void clearDirtyLines(vector<LSFittedLine*>& lines);
+    bool shouldMergeLines(const LSFittedLine& line1, const LSFittedLine& line2);
+    bool convertLinesEndPoints(vector<LSFittedLine*>& lines, Vision* vision, LineDetection* linedetector);
 
 };
 
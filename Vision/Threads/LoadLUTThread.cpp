@@ -0,0 +1,100 @@
+/*! @file LoadLUTThread.cpp
+    @brief Implementation of the loadlut thread class.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "LoadLUTThread.h"
+#include "Vision/Vision.h"
+#include "Vision/LookUpTable.h"
+
+#include "debug.h"
+#include "debugverbosityvision.h"
+
+/*! @brief Unlocks the mutex when the thread is cancelled while it holds it */
+static void unlockMutex(void* mutex)
+{
+    pthread_mutex_unlock(static_cast<pthread_mutex_t*>(mutex));
+}
+
+/*! @brief Creates and starts the thread
+    @param vision the vision to give the loaded tables to
+ */
+LoadLUTThread::LoadLUTThread(Vision* vision) : Thread(string("LoadLUTThread"), 0)
+{
+    #if DEBUG_VISION_VERBOSITY > 0
+        debug << "LoadLUTThread::LoadLUTThread(" << vision << ") with priority " << static_cast<int>(m_priority) << endl;
+    #endif
+    m_vision = vision;
+    pthread_mutex_init(&m_pending_mutex, NULL);
+    pthread_cond_init(&m_pending_condition, NULL);
+    start();
+}
+
+LoadLUTThread::~LoadLUTThread()
+{
+    #if DEBUG_VISION_VERBOSITY > 0
+        debug << "LoadLUTThread::~LoadLUTThread()" << endl;
+    #endif
+    stop();
+    pthread_cond_destroy(&m_pending_condition);
+    pthread_mutex_destroy(&m_pending_mutex);
+}
+
+/*! @brief Requests a table be loaded from a file. Returns immediately.
+    @param filename the lookup table file on the robot
+ */
+void LoadLUTThread::load(const std::string& filename)
+{
+    pthread_mutex_lock(&m_pending_mutex);
+    m_pending = filename;
+    pthread_cond_signal(&m_pending_condition);
+    pthread_mutex_unlock(&m_pending_mutex);
+}
+
+/*! @brief The load lut main loop; loads each requested file and gives it to vision
+ */
+void LoadLUTThread::run()
+{
+    #if DEBUG_VISION_VERBOSITY > 0
+        debug << "LoadLUTThread::run()" << endl;
+    #endif
+    while (1)
+    {
+        string filename;
+        pthread_mutex_lock(&m_pending_mutex);
+        pthread_cleanup_push(unlockMutex, &m_pending_mutex);
+        while (m_pending.empty())
+            pthread_cond_wait(&m_pending_condition, &m_pending_mutex);
+        filename.swap(m_pending);
+        pthread_cleanup_pop(1);
+        // -----------------------------------------------------------------------------------------------------------------------------------------------------------------
+        LookUpTable lut = LookUpTable::loadFromFile(filename);
+        if (lut.isNull())
+            errorlog << "LoadLUTThread::run(). Failed to load " << filename << endl;
+        else
+        {
+            #if DEBUG_VISION_VERBOSITY > 0
+                debug << "LoadLUTThread::run(). Loaded " << filename << endl;
+            #endif
+            m_vision->setLUT(lut);
+        }
+        // -----------------------------------------------------------------------------------------------------------------------------------------------------------------
+    }
+}
+
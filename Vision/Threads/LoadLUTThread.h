@@ -0,0 +1,58 @@
+/*! @file LoadLUTThread.h
+    @brief Declaration of a low priority thread for loading lookup tables.
+
+    @class LoadLUTThread
+    @brief A thread to load a lookup table from a file and give it to vision when it is ready
+
+    Loading, checking and decoding a table takes far longer than a frame, so it is done here rather
+    than on the vision thread. Vision only swaps in the loaded table at the start of its next frame.
+    Requesting a load never blocks; if several loads are requested while the thread is busy only the
+    last is loaded.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOADLUT_THREAD_H
+#define LOADLUT_THREAD_H
+
+#include "Tools/Threading/Thread.h"
+
+#include <string>
+#include <pthread.h>
+
+class Vision;
+
+class LoadLUTThread : public Thread
+{
+public:
+    LoadLUTThread(Vision* vision);
+    ~LoadLUTThread();
+
+    void load(const std::string& filename);
+protected:
+    void run();
+
+private:
+    Vision* m_vision;                       //!< the vision to give the loaded tables to
+    std::string m_pending;                  //!< the file to load next, empty when there is nothing to load
+    pthread_mutex_t m_pending_mutex;        //!< lock for m_pending
+    pthread_cond_t m_pending_condition;     //!< signalled when m_pending is set
+};
+
+#endif
+
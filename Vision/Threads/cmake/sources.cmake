@@ -22,6 +22,7 @@ ENDIF()
 ########## List your source files here! ############################################
 SET (YOUR_SRCS
 SaveImagesThread
+LoadLUTThread
 )
 ####################################################################################
 ########## List your subdirectories here! ##########################################
@@ -11,8 +11,8 @@
 #include "Ball.h"
 #include "GoalDetection.h"
 #include "Tools/Math/General.h"
-#include <boost/circular_buffer.hpp>
 #include <queue>
+#include <deque>
 #include <algorithm>
 #include "debug.h"
 #include "debugverbosityvision.h"
@@ -24,12 +24,14 @@
 #include "Infrastructure/Jobs/JobList.h"
 #include "Infrastructure/Jobs/CameraJobs/ChangeCameraSettingsJob.h"
 #include "Infrastructure/Jobs/VisionJobs/SaveImagesJob.h"
+#include "Infrastructure/Jobs/VisionJobs/LoadLUTJob.h"
 #include "Infrastructure/NUSensorsData/NUSensorsData.h"
 #include "Infrastructure/NUActionatorsData/NUActionatorsData.h"
 #include "NUPlatform/NUActionators/NUSounds.h"
 #include "NUPlatform/NUIO.h"
 
 #include "Vision/Threads/SaveImagesThread.h"
+#include "Vision/Threads/LoadLUTThread.h"
 #include <iostream>
 
 //#include <QDebug>
@@ -38,15 +40,21 @@ using namespace mathGeneral;
 Vision::Vision()
 {
     classifiedCounter = 0;
-    LUTBuffer = new unsigned char[LUTTools::LUT_SIZE];
-    currentLookupTable = LUTBuffer;
+    pthread_mutex_init(&m_lut_mutex, NULL);
+    setLUT(LookUpTable(new unsigned char[LUTTools::LUT_SIZE](), true));     // an empty table, used if default.lut can not be loaded
+    acquireLUT();
     loadLUTFromFile(string(DATA_DIR) + string("default.lut"));
     m_saveimages_thread = new SaveImagesThread(this);
+    m_loadlut_thread = new LoadLUTThread(this);
+    BallFinding = new Ball();
     isSavingImages = false;
     isSavingImagesWithVaryingSettings = false;
     numSavedImages = 0;
     ImageFrameNumber = 0;
     numFramesDropped = 0;
+    m_has_image_kinematics = false;
+    m_stage_timer = NULL;
+    m_scan_mode = FullScan;
     numFramesProcessed = 0;
 
     return;
@@ -55,7 +63,9 @@ Vision::Vision()
 Vision::~Vision()
 {
     // delete AllFieldObjects;
-    delete [] LUTBuffer;
+    delete m_loadlut_thread;
+    delete BallFinding;
+    pthread_mutex_destroy(&m_lut_mutex);
     imagefile.close();
     sensorfile.close();
     return;
@@ -102,6 +112,15 @@ void Vision::process(JobList* jobs)
             isSavingImagesWithVaryingSettings = job->varyCameraSettings();
             it = jobs->removeVisionJob(it);
         }
+        else if ((*it)->getID() == Job::VISION_LOAD_LUT)
+        {
+            #if DEBUG_VISION_VERBOSITY > 4
+                debug << "Vision::process(): Processing a load lut job." << endl;
+            #endif
+            LoadLUTJob* job = (LoadLUTJob*) (*it);
+            loadLUTFromFileInBackground(job->getFileName());
+            it = jobs->removeVisionJob(it);
+        }
         else 
         {
             ++it;
@@ -118,6 +137,10 @@ void Vision::ProcessFrame(NUImage* image, NUSensorsData* data, NUActionatorsData
 
     if (image == NULL || data == NULL || actions == NULL || fieldobjects == NULL)
         return;
+    // every temporary declared after this is allocated from the arena, and is gone before the arena is reset
+    FrameArena::Scope framescope(m_frame_arena);
+    if (m_stage_timer != NULL)
+        m_stage_timer->start();
     m_sensor_data = data;
     m_actions = actions;
 
@@ -128,19 +151,20 @@ void Vision::ProcessFrame(NUImage* image, NUSensorsData* data, NUActionatorsData
     numFramesProcessed++;
         
     setImage(image);
+    m_has_image_kinematics = m_sensor_data->getKinematics(image->m_timestamp, m_image_kinematics);
     AllFieldObjects->preProcess(image->m_timestamp);
+    predictExpectedLandmarks();
 
     std::vector< Vector2<int> > points;
     //std::vector< Vector2<int> > verticalPoints;
     //std::vector< TransitionSegment > allsegments;
     //std::vector< TransitionSegment > segments;
-    //std::vector< ObjectCandidate > candidates;
-    //std::vector< ObjectCandidate > tempCandidates;
+    //FrameVector<ObjectCandidate>::type candidates;
+    //FrameVector<ObjectCandidate>::type tempCandidates;
     //std::vector< Vector2<int> > horizontalPoints;
     //std::vector<LSFittedLine> fieldLines;
     //spacings = (int)(currentImage->getWidth()/20); //16 for Robot, 8 for simulator = width/20
     Circle circ;
-    int tempNumScanLines = 0;
     //debug << "Setting Image: " <<endl;
 
     if(isSavingImages)
@@ -157,15 +181,19 @@ void Vision::ProcessFrame(NUImage* image, NUSensorsData* data, NUActionatorsData
     vector <float> horizonInfo;
 
 
-    if(m_sensor_data->get(NUSensorsData::Horizon, horizonInfo))
+    if(getHorizon(horizonInfo))
         m_horizonLine.setLine((double)horizonInfo[0],(double)horizonInfo[1],(double)horizonInfo[2]);
     else
     {
         #if DEBUG_VISION_VERBOSITY > 5
             debug << "No Horizon Data" << endl;
         #endif
+        markStage(VisionStageTimer::Setup);
         return;
     }
+    if (m_scan_mode == MultiResolutionScan)
+        predictRegionsOfInterest();
+    markStage(VisionStageTimer::Setup);
 
     #if DEBUG_VISION_VERBOSITY > 7
         debug << "Generating Horizon Line: Finnished" <<endl;
@@ -203,6 +231,7 @@ void Vision::ProcessFrame(NUImage* image, NUSensorsData* data, NUActionatorsData
     //! Find the Field border:
     points = getConvexFieldBorders(points);
     points = interpolateBorders(points,spacings);
+    markStage(VisionStageTimer::GreenBorder);
 
     #if DEBUG_VISION_VERBOSITY > 5
         debug << "\tGenerating Green Boarder: Finnished" <<endl;
@@ -210,7 +239,8 @@ void Vision::ProcessFrame(NUImage* image, NUSensorsData* data, NUActionatorsData
 
 
     //! Scan Below Horizon Image:
-    ClassifiedSection vertScanArea = verticalScan(points,spacings);
+    bool coarse = m_scan_mode == MultiResolutionScan;
+    verticalScan(points,spacings,vertScanArea,coarse);
 
     #if DEBUG_VISION_VERBOSITY > 5
         debug << "\tVert ScanPaths : Finnished " << vertScanArea.getNumberOfScanLines() <<endl;
@@ -218,16 +248,22 @@ void Vision::ProcessFrame(NUImage* image, NUSensorsData* data, NUActionatorsData
 
 
     //! Scan Above the Horizon
-    ClassifiedSection horiScanArea = horizontalScan(points,spacings);
+    horizontalScan(points,spacings,horiScanArea,coarse);
+
+    //! Scan densely where the ball and goals are expected
+    if (coarse)
+        addRegionOfInterestScans(spacings,vertScanArea,horiScanArea);
 
     #if DEBUG_VISION_VERBOSITY > 5
         debug << "\tHorizontal ScanPaths : Finnished " << horiScanArea.getNumberOfScanLines() <<endl;
     #endif
+    markStage(VisionStageTimer::Scan);
     
 
     //! Classify Scan Lines to find Segments
     ClassifyScanArea(&vertScanArea);
     ClassifyScanArea(&horiScanArea);
+    markStage(VisionStageTimer::Classify);
 
     #if DEBUG_VISION_VERBOSITY > 5
         debug << "\tClassify ScanPaths : Finnished" <<endl;
@@ -235,43 +271,39 @@ void Vision::ProcessFrame(NUImage* image, NUSensorsData* data, NUActionatorsData
 
     //! Different Segments for Different possible objects:
 
-    std::vector< TransitionSegment > GoalBlueSegments;
-    std::vector< TransitionSegment > GoalYellowSegments;
-    std::vector< TransitionSegment > BallSegments;
-    std::vector< TransitionSegment > horizontalsegments;
+    FrameVector<TransitionSegment>::type GoalBlueSegments;
+    FrameVector<TransitionSegment>::type GoalYellowSegments;
+    FrameVector<TransitionSegment>::type BallSegments;
+    FrameVector<TransitionSegment>::type horizontalsegments;
 
     //! Extract and Display Vertical Scan Points:
-    tempNumScanLines = vertScanArea.getNumberOfScanLines();
-    for (int i = 0; i < tempNumScanLines; i++)
+    SegmentTable* vertSegments = vertScanArea.getSegments();
+    for (int seg = 0; seg < vertSegments->size(); seg++)
     {
-        ScanLine* tempScanLine = vertScanArea.getScanLine(i);
-        for(int seg = 0; seg < tempScanLine->getNumberOfSegments(); seg++)
+        unsigned char colour = vertSegments->getColour(seg);
+        int x = vertSegments->getStartPoint(seg).x;
+        if(     colour == ClassIndex::blue );//|| colour == ClassIndex::shadow_blue)
         {
-            if(     tempScanLine->getSegment(seg)->getColour() == ClassIndex::blue );//|| tempScanLine->getSegment(seg)->getColour() == ClassIndex::shadow_blue)
-            {
-                GoalBlueSegments.push_back((*tempScanLine->getSegment(seg)));
-            }
-            if(     tempScanLine->getSegment(seg)->getColour() == ClassIndex::yellow );//|| tempScanLine->getSegment(seg)->getColour() == ClassIndex::yellow_orange)
-            {
-                GoalYellowSegments.push_back((*tempScanLine->getSegment(seg)));
-            }
-            if(     tempScanLine->getSegment(seg)->getColour() == ClassIndex::orange || tempScanLine->getSegment(seg)->getColour() == ClassIndex::yellow_orange
-                ||  tempScanLine->getSegment(seg)->getColour() == ClassIndex::pink_orange)
-            {
-                BallSegments.push_back((*tempScanLine->getSegment(seg)));
-            }
+            if (isInExpectedGoalColumns(x, FieldObjects::FO_BLUE_LEFT_GOALPOST, FieldObjects::FO_BLUE_RIGHT_GOALPOST))
+                GoalBlueSegments.push_back(vertSegments->getSegment(seg));
+        }
+        if(     colour == ClassIndex::yellow );//|| colour == ClassIndex::yellow_orange)
+        {
+            if (isInExpectedGoalColumns(x, FieldObjects::FO_YELLOW_LEFT_GOALPOST, FieldObjects::FO_YELLOW_RIGHT_GOALPOST))
+                GoalYellowSegments.push_back(vertSegments->getSegment(seg));
+        }
+        if(     colour == ClassIndex::orange || colour == ClassIndex::yellow_orange
+            ||  colour == ClassIndex::pink_orange)
+        {
+            BallSegments.push_back(vertSegments->getSegment(seg));
         }
     }
 
     //! Extract and Display Horizontal Scan Points:
-    tempNumScanLines = horiScanArea.getNumberOfScanLines();
-    for (int i = 0; i < tempNumScanLines; i++)
+    SegmentTable* horiSegments = horiScanArea.getSegments();
+    for (int seg = 0; seg < horiSegments->size(); seg++)
     {
-        ScanLine* tempScanLine = horiScanArea.getScanLine(i);
-        for(int seg = 0; seg < tempScanLine->getNumberOfSegments(); seg++)
-        {
-            horizontalsegments.push_back((*tempScanLine->getSegment(seg)));
-        }
+        horizontalsegments.push_back(horiSegments->getSegment(seg));
     }
 
     //! Find Line or Robot Points:
@@ -283,10 +315,10 @@ void Vision::ProcessFrame(NUImage* image, NUSensorsData* data, NUActionatorsData
 
     /**INCLUDED BY SHANNON**/
 
-        std::vector< ObjectCandidate > HorizontalLineCandidates;
-        std::vector< ObjectCandidate > VerticalLineCandidates;
-        std::vector< ObjectCandidate > LineCandidates;
-        std::vector< TransitionSegment > LeftoverPoints;
+        FrameVector<ObjectCandidate>::type HorizontalLineCandidates;
+        FrameVector<ObjectCandidate>::type VerticalLineCandidates;
+        FrameVector<ObjectCandidate>::type LineCandidates;
+        FrameVector<TransitionSegment>::type LeftoverPoints;
 
         validColours.clear();
         validColours.push_back(ClassIndex::white);
@@ -312,17 +344,18 @@ void Vision::ProcessFrame(NUImage* image, NUSensorsData* data, NUActionatorsData
 
 
     /**INCLUDED BY SHANNON**/
+    markStage(VisionStageTimer::Segments);
 
     #if DEBUG_VISION_VERBOSITY > 5
     debug << "Begin Classify Candidates: " << endl;
     #endif
 
-    std::vector< ObjectCandidate > RobotCandidates;
-    std::vector< ObjectCandidate > BallCandidates;
-    std::vector< ObjectCandidate > BlueGoalCandidates;
-    std::vector< ObjectCandidate > YellowGoalCandidates;
-    std::vector< ObjectCandidate > BlueGoalAboveHorizonCandidates;
-    std::vector< ObjectCandidate > YellowGoalAboveHorizonCandidates;
+    FrameVector<ObjectCandidate>::type RobotCandidates;
+    FrameVector<ObjectCandidate>::type BallCandidates;
+    FrameVector<ObjectCandidate>::type BlueGoalCandidates;
+    FrameVector<ObjectCandidate>::type YellowGoalCandidates;
+    FrameVector<ObjectCandidate>::type BlueGoalAboveHorizonCandidates;
+    FrameVector<ObjectCandidate>::type YellowGoalAboveHorizonCandidates;
 
     mode = ROBOTS;
     method = Vision::PRIMS;
@@ -368,6 +401,8 @@ void Vision::ProcessFrame(NUImage* image, NUSensorsData* data, NUActionatorsData
 
                 break;
             case YELLOW_GOALS:
+                if (not isGoalExpected(FieldObjects::FO_YELLOW_LEFT_GOALPOST, FieldObjects::FO_YELLOW_RIGHT_GOALPOST))
+                    break;
                 validColours.clear();
                 validColours.push_back(ClassIndex::yellow);
                 //validColours.push_back(ClassIndex::yellow_orange);
@@ -384,6 +419,8 @@ void Vision::ProcessFrame(NUImage* image, NUSensorsData* data, NUActionatorsData
 
                 break;
             case BLUE_GOALS:
+                if (not isGoalExpected(FieldObjects::FO_BLUE_LEFT_GOALPOST, FieldObjects::FO_BLUE_RIGHT_GOALPOST))
+                    break;
                 validColours.clear();
                 validColours.push_back(ClassIndex::blue);
                 //validColours.push_back(ClassIndex::shadow_blue);
@@ -406,6 +443,7 @@ void Vision::ProcessFrame(NUImage* image, NUSensorsData* data, NUActionatorsData
     #if DEBUG_VISION_VERBOSITY > 5
         debug << "Finnished Classify Candidates" <<endl;
     #endif
+    markStage(VisionStageTimer::Candidates);
 
     #if DEBUG_VISION_VERBOSITY > 5
         debug << "Begin Object Recognition: " <<endl;
@@ -418,6 +456,7 @@ void Vision::ProcessFrame(NUImage* image, NUSensorsData* data, NUActionatorsData
         #endif
 
         DetectRobots(RobotCandidates);
+        markStage(VisionStageTimer::Robots);
 
         #if DEBUG_VISION_VERBOSITY > 5
             debug << "\tPost-Robot Formation: " <<endl;
@@ -433,6 +472,7 @@ void Vision::ProcessFrame(NUImage* image, NUSensorsData* data, NUActionatorsData
         DetectGoals(BlueGoalCandidates, BlueGoalAboveHorizonCandidates, horizontalsegments);
 
         PostProcessGoals();
+        markStage(VisionStageTimer::Goals);
 
         #if DEBUG_VISION_VERBOSITY > 5
             debug << "\tPost-GOALPost Recognition: " <<endl;
@@ -447,6 +487,7 @@ void Vision::ProcessFrame(NUImage* image, NUSensorsData* data, NUActionatorsData
 
         //SHANNON
         DetectLines(&LineDetector, LineCandidates, LeftoverPoints);
+        markStage(VisionStageTimer::Lines);
         //AARON
         //LineDetector.fieldLines.clear();
         //DetectLines(&LineDetector);
@@ -465,6 +506,7 @@ void Vision::ProcessFrame(NUImage* image, NUSensorsData* data, NUActionatorsData
         {
             circ = DetectBall(BallCandidates);
         }
+        markStage(VisionStageTimer::Ball);
 
         #if DEBUG_VISION_VERBOSITY > 5
             debug << "\tPost-Ball Recognition: " <<endl;
@@ -474,6 +516,8 @@ void Vision::ProcessFrame(NUImage* image, NUSensorsData* data, NUActionatorsData
         debug << "Finished Object Recognition: " <<endl;
     #endif
     AllFieldObjects->postProcess(image->m_timestamp);
+    if (m_scan_mode == MultiResolutionScan)
+        m_roi_tracker.update(AllFieldObjects);
 
     if(AllFieldObjects->stationaryFieldObjects[FieldObjects::FO_CORNER_CENTRE_CIRCLE].isObjectVisible())
     {
@@ -482,8 +526,10 @@ void Vision::ProcessFrame(NUImage* image, NUSensorsData* data, NUActionatorsData
     #if DEBUG_VISION_VERBOSITY > 3
 	debug 	<< "Vision::ProcessFrame - Number of Pixels Classified: " << classifiedCounter 
 			<< "\t Percent of Image: " << classifiedCounter / float(currentImage->getWidth() * currentImage->getHeight()) * 100.00 << "%" << endl;
+        debug << "Vision::ProcessFrame - Frame arena used: " << m_frame_arena.getUsed() << " bytes of " << m_frame_arena.getCapacity()
+              << " High water mark: " << m_frame_arena.getHighWaterMark() << " bytes" << endl;
     #endif
-    
+
 	/*For Testing Ultrasonic Distances:
 	debug << "US Distances: " ;
 	vector<float> leftDistances, rightDistances;
@@ -652,37 +698,172 @@ void Vision::setSensorsData(NUSensorsData* data)
     m_sensor_data = data;
 }
 
+/*! @brief Gets the camera transform at the time the current image was taken
+    @param data will be updated with the flattened 4x4 transform
+    @return true if valid, false if invalid
+ */
+bool Vision::getCameraTransform(std::vector<float>& data)
+{
+    if (not m_has_image_kinematics)
+        return m_sensor_data->get(NUSensorsData::CameraTransform, data);
+    if (m_image_kinematics.CameraTransformValid)
+        data.assign(m_image_kinematics.CameraTransform, m_image_kinematics.CameraTransform + 16);
+    return m_image_kinematics.CameraTransformValid;
+}
+
+/*! @brief Gets the camera to ground transform at the time the current image was taken
+    @param data will be updated with the flattened 4x4 transform
+    @return true if valid, false if invalid
+ */
+bool Vision::getCameraToGroundTransform(std::vector<float>& data)
+{
+    if (not m_has_image_kinematics)
+        return m_sensor_data->get(NUSensorsData::CameraToGroundTransform, data);
+    if (m_image_kinematics.CameraToGroundTransformValid)
+        data.assign(m_image_kinematics.CameraToGroundTransform, m_image_kinematics.CameraToGroundTransform + 16);
+    return m_image_kinematics.CameraToGroundTransformValid;
+}
+
+/*! @brief Gets the horizon line [A, B, C] at the time the current image was taken
+    @param data will be updated with the [A, B, C] of the line
+    @return true if valid, false if invalid
+ */
+bool Vision::getHorizon(std::vector<float>& data)
+{
+    if (not m_has_image_kinematics)
+        return m_sensor_data->get(NUSensorsData::Horizon, data);
+    if (m_image_kinematics.HorizonValid)
+        data.assign(m_image_kinematics.Horizon, m_image_kinematics.Horizon + 3);
+    return m_image_kinematics.HorizonValid;
+}
+
+/*! @brief Gets the head pitch at the time the current image was taken
+    @param data will be updated with the head pitch in radians
+    @return true if valid, false if invalid
+ */
+bool Vision::getHeadPitch(float& data)
+{
+    if (not m_has_image_kinematics)
+        return m_sensor_data->getPosition(NUSensorsData::HeadPitch, data);
+    if (m_image_kinematics.HeadPitchValid)
+        data = m_image_kinematics.HeadPitch;
+    return m_image_kinematics.HeadPitchValid;
+}
+
 void Vision::setActionatorsData(NUActionatorsData* actions)
 {
     m_actions = actions;
 }
 
+/*! @brief Sets the timer used to measure each stage of ProcessFrame()
+    @param timer the timer, or NULL to stop timing the stages. Vision does not take ownership of the timer.
+ */
+void Vision::setStageTimer(VisionStageTimer* timer)
+{
+    m_stage_timer = timer;
+}
+
+/*! @brief Sets how ProcessFrame() places its scan lines
+    @param mode FullScan (the default) to scan the whole image at the full density, or MultiResolutionScan to scan the whole
+                image coarsely, and densely only inside the regions the ball and goals are tracked into
+ */
+void Vision::setScanMode(ScanMode mode)
+{
+    if (mode != m_scan_mode)
+        m_roi_tracker.clear();
+    m_scan_mode = mode;
+}
+
+/*! @brief Returns how ProcessFrame() places its scan lines */
+Vision::ScanMode Vision::getScanMode() const
+{
+    return static_cast<ScanMode>(m_scan_mode);
+}
+
+/*! @brief Returns the tracker of the regions the ball and goals are expected in. It is only updated in the MultiResolutionScan mode. */
+const RegionOfInterestTracker& Vision::getRegionOfInterestTracker() const
+{
+    return m_roi_tracker;
+}
+
+/*! @brief Returns the arena used for the temporaries of ProcessFrame(), so that its high water mark can be reported */
+const FrameArena& Vision::getFrameArena() const
+{
+    return m_frame_arena;
+}
+
 void Vision::setFieldObjects(FieldObjects* fieldObjects)
 {
     AllFieldObjects = fieldObjects;
     return;
 }
 
+/*! @brief Sets the lookup table, and starts using it immediately.
+
+    Vision only borrows the table, so the caller must keep it alive and must call this from the thread
+    running vision. Use setLUT(const LookUpTable&) to replace the table from another thread.
+    @param newLUT the table of LUTTools::LUT_SIZE bytes
+ */
 void Vision::setLUT(unsigned char* newLUT)
 {
-    currentLookupTable = newLUT;
+    setLUT(LookUpTable(newLUT, false));
+    acquireLUT();
     return;
 }
 
+/*! @brief Replaces the lookup table. This can be called from any thread; the table is used from the start of the next frame.
+    @param lut the new table
+ */
+void Vision::setLUT(const LookUpTable& lut)
+{
+    pthread_mutex_lock(&m_lut_mutex);
+    m_lut = lut;
+    pthread_mutex_unlock(&m_lut_mutex);
+}
+
+/*! @brief Loads the lookup table from a file, and starts using it immediately. The current table is kept if the file can not be loaded.
+    @param fileName the lookup table file, in any format understood by LUTTools::LoadLUT
+ */
 void Vision::loadLUTFromFile(const std::string& fileName)
 {
-    LUTTools lutLoader;
-    if (lutLoader.LoadLUT(LUTBuffer, LUTTools::LUT_SIZE,fileName.c_str()) == true)
-        setLUT(LUTBuffer);
+    LookUpTable lut = LookUpTable::loadFromFile(fileName);
+    if (not lut.isNull())
+    {
+        setLUT(lut);
+        acquireLUT();
+    }
     else
         errorlog << "Vision::loadLUTFromFile(" << fileName << "). Failed to load lut." << endl;
 }
 
-void Vision::setImage(const NUImage* newImage)
+/*! @brief Loads the lookup table from a file on another thread, so that vision never waits for it.
+           The table is used from the start of the first frame after it has been loaded.
+    @param fileName the lookup table file, in any format understood by LUTTools::LoadLUT
+ */
+void Vision::loadLUTFromFileInBackground(const std::string& fileName)
+{
+    m_loadlut_thread->load(fileName);
+}
+
+/*! @brief Takes a reference to the latest lookup table for the current frame.
+
+    The table is not changed part way through a frame, and it is not deleted while it is in use, even if
+    another thread replaces it.
+ */
+void Vision::acquireLUT()
 {
+    pthread_mutex_lock(&m_lut_mutex);
+    m_frame_lut = m_lut;
+    pthread_mutex_unlock(&m_lut_mutex);
+    currentLookupTable = m_frame_lut.getTable();
+}
 
+void Vision::setImage(const NUImage* newImage)
+{
+    acquireLUT();
     currentImage = newImage;
     m_timestamp = currentImage->m_timestamp;
+    CandidateSegments.clear();
     spacings = (int)(currentImage->getWidth()/20); //16 for Robot, 8 for simulator = width/20
     ImageFrameNumber++;
 }
@@ -830,11 +1011,15 @@ std::vector<Vector2<int> > Vision::interpolateBorders(const std::vector<Vector2<
     return interpolatedBorders;
 }
 
-ClassifiedSection Vision::verticalScan(const std::vector<Vector2<int> >&fieldBorders,int scanSpacing)
+/*! @brief Generates the vertical scan lines below the field borders.
+    @param scanArea is reset, and filled with the new lines. It is reused between frames so that it does not allocate.
+    @param coarse true to leave out the shortest (eighth) lines, which are replaced by addRegionOfInterestScans() near the ball
+ */
+void Vision::verticalScan(const std::vector<Vector2<int> >&fieldBorders,int scanSpacing, ClassifiedSection& scanArea, bool coarse)
 {
     //std::vector<Vector2<int> > scanPoints;
-    ClassifiedSection scanArea(ScanLine::DOWN);
-    if(!fieldBorders.size()) return scanArea;
+    scanArea.reset(ScanLine::DOWN);
+    if(!fieldBorders.size()) return;
     std::vector<Vector2<int> >::const_iterator nextPoint = fieldBorders.begin();
     //std::vector<Vector2<int> >::const_iterator prevPoint = nextPoint++; //This iterator is unused
     int x = 0;
@@ -878,6 +1063,8 @@ ClassifiedSection Vision::verticalScan(const std::vector<Vector2<int> >&fieldBor
         ScanLine tempRightQuarterLine(temp,quarterLineLength);
         scanArea.addScanLine(tempRightQuarterLine);
 
+        if (coarse)
+            continue;
 
         //!Create Eight ScanLines
 
@@ -896,13 +1083,18 @@ ClassifiedSection Vision::verticalScan(const std::vector<Vector2<int> >&fieldBor
         scanArea.addScanLine(tempRight2EightLine);
     }
 
-    return scanArea;
+    return;
 }
 
-ClassifiedSection Vision::horizontalScan(const std::vector<Vector2<int> >&fieldBorders,int scanSpacing)
+/*! @brief Generates the horizontal scan lines, mostly above the field borders.
+    @param scanArea is reset, and filled with the new lines. It is reused between frames so that it does not allocate.
+    @param coarse true to space the lines above the field borders twice as far apart; addRegionOfInterestScans() adds the
+                  detail back near the goals
+ */
+void Vision::horizontalScan(const std::vector<Vector2<int> >&fieldBorders,int scanSpacing, ClassifiedSection& scanArea, bool coarse)
 {
-    ClassifiedSection scanArea(ScanLine::RIGHT);
-    if(!currentImage) return scanArea;
+    scanArea.reset(ScanLine::RIGHT);
+    if(!currentImage) return;
     Vector2<int> temp;
     int width = currentImage->getWidth();
     int height = currentImage->getHeight();
@@ -917,7 +1109,7 @@ ClassifiedSection Vision::horizontalScan(const std::vector<Vector2<int> >&fieldB
             ScanLine tempScanLine(temp,width);
             scanArea.addScanLine(tempScanLine);
         }
-        return scanArea;
+        return;
     }
 
     //! Find the minimum Y, and scan above the field boarders
@@ -950,7 +1142,8 @@ ClassifiedSection Vision::horizontalScan(const std::vector<Vector2<int> >&fieldB
 
     //! Then calculate horizontal scanlines above the field boarder
     //! Generate Scan pattern for above the max of green boarder.
-    for(int y = 0; y < minY; y = y + scanSpacing*0.5)
+    float aboveSpacing = coarse ? scanSpacing*1 : scanSpacing*0.5;
+    for(int y = 0; y < minY; y = y + aboveSpacing)
     {
         temp.x =0;
         temp.y = y;
@@ -988,7 +1181,49 @@ ClassifiedSection Vision::horizontalScan(const std::vector<Vector2<int> >&fieldB
         ScanLine tempScanLine(temp,minX);
         scanArea.addScanLine(tempScanLine);
     }
-    return scanArea;
+    return;
+}
+
+/*! @brief Adds dense scan lines inside the regions the ball and goals are expected in, on top of a coarse scan.
+    The ball's region gets vertical lines every quarter of the scan spacing, and each goal's region gets vertical and horizontal
+    lines every half of the scan spacing (the density of the full scan's horizontal lines above the field border).
+    @param verticalArea the vertical scan lines, which the new vertical lines are added to
+    @param horizontalArea the horizontal scan lines, which the new horizontal lines are added to
+ */
+void Vision::addRegionOfInterestScans(int scanSpacing, ClassifiedSection& verticalArea, ClassifiedSection& horizontalArea)
+{
+    Vector2<int> temp;
+    for (int i=0; i<RegionOfInterestTracker::NumTargets; i++)
+    {
+        RegionOfInterestTracker::Target target = static_cast<RegionOfInterestTracker::Target>(i);
+        const RegionOfInterestTracker::Region& region = m_roi_tracker.getRegion(target);
+        if (not region.Valid)
+            continue;
+
+        int skip = target == RegionOfInterestTracker::Ball ? max(scanSpacing/4, 2) : max(scanSpacing/2, 2);
+        int width = region.MaxX - region.MinX + 1;
+        int height = region.MaxY - region.MinY + 1;
+        for (int x = region.MinX; x <= region.MaxX; x += skip)
+        {
+            temp.x = x;
+            temp.y = region.MinY;
+            ScanLine tempScanLine(temp, height);
+            verticalArea.addScanLine(tempScanLine);
+        }
+        if (target == RegionOfInterestTracker::Ball)
+            continue;
+        for (int y = region.MinY; y <= region.MaxY; y += skip)
+        {
+            temp.x = region.MinX;
+            temp.y = y;
+            ScanLine tempScanLine(temp, width);
+            horizontalArea.addScanLine(tempScanLine);
+        }
+    }
+
+    #if DEBUG_VISION_VERBOSITY > 5
+        debug << "	Region of interest ScanPaths : Finnished " << verticalArea.getNumberOfScanLines() << " " << horizontalArea.getNumberOfScanLines() << endl;
+    #endif
 }
 
 void Vision::ClassifyScanArea(ClassifiedSection* scanArea)
@@ -1006,11 +1241,8 @@ void Vision::ClassifyScanArea(ClassifiedSection* scanArea)
     unsigned char currentColour = ClassIndex::unclassified; //!< Colour in the current segment
     //! initialising circular buffer
     int bufferSize = 1;
-    boost::circular_buffer<unsigned char> colourBuff(bufferSize);
-    for (int i = 0; i < bufferSize; i++)
-    {
-        colourBuff.push_back(0);
-    }
+    ColourHistory colourBuff(bufferSize);
+    colourBuff.fill(0);
     for (int i = 0; i < numOfLines; i++)
     {
         tempLine = scanArea->getScanLine(i);
@@ -1055,7 +1287,7 @@ void Vision::ClassifyScanArea(ClassifiedSection* scanArea)
                 continue;
             }
             afterColour = classifyPixel(currentPoint.x,currentPoint.y);
-            colourBuff.push_back(afterColour);
+            colourBuff.push(afterColour);
 
             /*qDebug() << "Scanning: " << skipPixel<<","<<j << "\t"<< currentPoint.x << "," << currentPoint.y <<
                     "\t"<<currentColour<< "," << afterColour <<
@@ -1074,10 +1306,7 @@ void Vision::ClassifyScanArea(ClassifiedSection* scanArea)
                     tempStartPoint = currentPoint;
                     beforeColour = ClassIndex::unclassified;
                     currentColour = afterColour;
-                    for (int i = 0; i < bufferSize; i++)
-                    {
-                        colourBuff.push_back(0);
-                    }
+                    colourBuff.fill(0);
                     continue;
                 }
 
@@ -1142,7 +1371,7 @@ void Vision::ClassifyScanArea(ClassifiedSection* scanArea)
                         break;
                     }
                     afterColour = classifyPixel(currentPoint.x,currentPoint.y);
-                    colourBuff.push_back(afterColour);
+                    colourBuff.push(afterColour);
                     j = j+6;
 
                 }
@@ -1153,10 +1382,7 @@ void Vision::ClassifyScanArea(ClassifiedSection* scanArea)
                 tempStartPoint = currentPoint;
                 beforeColour = ClassIndex::unclassified;
                 currentColour = afterColour;
-                for (int i = 0; i < bufferSize; i++)
-                {
-                    colourBuff.push_back(0);
-                }
+                colourBuff.fill(0);
                 if(direction == ScanLine::DOWN)
                 {
                     skipPixel = CalculateSkipSpacing(currentPoint.y,startPoint.y,greenSeen); //current point y check
@@ -1168,7 +1394,7 @@ void Vision::ClassifyScanArea(ClassifiedSection* scanArea)
                 continue;
             }
 
-            if(checkIfBufferSame(colourBuff))
+            if(colourBuff.isAllSame())
             {
                 if(currentColour != afterColour)
                 {
@@ -1228,10 +1454,7 @@ void Vision::ClassifyScanArea(ClassifiedSection* scanArea)
                     tempStartPoint = currentPoint;
                     beforeColour = currentColour;
                     currentColour = afterColour;
-                    for (int i = 0; i < bufferSize; i++)
-                    {
-                        colourBuff.push_back(0);
-                    }
+                    colourBuff.fill(0);
 
                     if(direction == ScanLine::DOWN)
                     {
@@ -1285,11 +1508,7 @@ void Vision::CloselyClassifyScanline(ScanLine* tempLine, TransitionSegment* temp
     {
         Vector2<int> StartPoint = tempTransition->getStartPoint();
         int bufferSize = 10;
-        boost::circular_buffer<unsigned char> colourBuff(bufferSize);
-        for (int i = 0; i < bufferSize; i++)
-        {
-            colourBuff.push_back(tempTransition->getColour());
-        }
+        ColourHistory colourBuff(bufferSize, colourList);
 
         int length = abs(tempTransition->getEndPoint().y - tempTransition->getStartPoint().y);
         Vector2<int> tempSubEndPoint;
@@ -1305,12 +1524,8 @@ void Vision::CloselyClassifyScanline(ScanLine* tempLine, TransitionSegment* temp
             int tempsubPoint    = StartPoint.x;
             tempColour          = tempTransition->getColour();
             //Reset Buffer: to OriginalColour
-            for (int i = 0; i < bufferSize; i++)
-            {
-                colourBuff.push_back(tempTransition->getColour());
-            }
-            //qDebug() << "Condition:" << checkIfBufferSame(colourBuff) << colourBuff[0] << tempTransition->getColour();
-            while(checkIfBufferContains(colourBuff,colourList))
+            colourBuff.fill(tempTransition->getColour());
+            while(colourBuff.containsAny())
             {
                 if(tempsubPoint+skipPixel >= width)
                 {
@@ -1324,7 +1539,7 @@ void Vision::CloselyClassifyScanline(ScanLine* tempLine, TransitionSegment* temp
                 {
 
                     tempColour= classifyPixel(tempsubPoint,StartPoint.y+k);
-                    colourBuff.push_back(tempColour);
+                    colourBuff.push(tempColour);
                 }
                 else
                 {
@@ -1334,7 +1549,7 @@ void Vision::CloselyClassifyScanline(ScanLine* tempLine, TransitionSegment* temp
 
             tempSubEndPoint.x = tempsubPoint - bufferSize*skipPixel;
             tempColour = tempTransition->getColour();
-            while(isValidColour(tempColour,colourList))
+            while(colourBuff.isValid(tempColour))
             {
                 if(StartPoint.y+k < height && StartPoint.y+k > 0
                    && tempSubEndPoint.x+1 < width && tempSubEndPoint.x+1 > 0)
@@ -1351,12 +1566,8 @@ void Vision::CloselyClassifyScanline(ScanLine* tempLine, TransitionSegment* temp
             tempsubPoint = StartPoint.x;
             tempColour = tempTransition->getColour();
             //Reset Buffer: to OriginalColour
-            for (int i = 0; i < bufferSize; i++)
-            {
-                colourBuff.push_back(tempTransition->getColour());
-            }
-            //qDebug() << "Condition:" << checkIfBufferSame(colourBuff) << colourBuff[0] << tempTransition->getColour();
-            while(checkIfBufferContains(colourBuff, colourList))
+            colourBuff.fill(tempTransition->getColour());
+            while(colourBuff.containsAny())
             {
                 if(tempsubPoint-skipPixel < 0)
                 {
@@ -1369,7 +1580,7 @@ void Vision::CloselyClassifyScanline(ScanLine* tempLine, TransitionSegment* temp
                    && tempsubPoint < width && tempsubPoint > 0)
                 {
                     tempColour = classifyPixel(tempsubPoint,StartPoint.y+k);
-                    colourBuff.push_back(tempColour);
+                    colourBuff.push(tempColour);
                 }
                 else
                 {
@@ -1379,7 +1590,7 @@ void Vision::CloselyClassifyScanline(ScanLine* tempLine, TransitionSegment* temp
             }
             tempSubStartPoint.x = tempsubPoint + bufferSize*skipPixel;
             tempColour = tempTransition->getColour();
-            while(isValidColour(tempColour,colourList))
+            while(colourBuff.isValid(tempColour))
             {
                 if(StartPoint.y+k < height && StartPoint.y+k > 0
                    && tempSubStartPoint.x-1 < width && tempSubStartPoint.x-1 > 0)
@@ -1408,8 +1619,7 @@ void Vision::CloselyClassifyScanline(ScanLine* tempLine, TransitionSegment* temp
         Vector2<int> StartPoint = tempTransition->getStartPoint();
 
         int bufferSize = 10;
-        boost::circular_buffer<unsigned char> colourBuff(bufferSize);
-
+        ColourHistory colourBuff(bufferSize, colourList);
 
         int length = abs(tempTransition->getEndPoint().x - tempTransition->getStartPoint().x);
         Vector2<int> tempSubEndPoint;
@@ -1425,13 +1635,10 @@ void Vision::CloselyClassifyScanline(ScanLine* tempLine, TransitionSegment* temp
             tempColour = tempTransition->getColour();
             //Reseting ColourBuffer
             //qDebug() << "Resetting:";
-            for (int i = 0; i < bufferSize; i++)
-            {
-                colourBuff.push_back(tempTransition->getColour());
-            }
+            colourBuff.fill(tempTransition->getColour());
             //Search for End of Perpendicular Segment
             //qDebug() << "Searching roughly for end:";
-            while(checkIfBufferContains(colourBuff, colourList))
+            while(colourBuff.containsAny())
             {
                 if(tempY+skipPixel >= height) break;
                 tempY = tempY+skipPixel;
@@ -1440,7 +1647,7 @@ void Vision::CloselyClassifyScanline(ScanLine* tempLine, TransitionSegment* temp
                    tempY < height && tempY > 0)
                 {
                     tempColour= classifyPixel(StartPoint.x+k,tempY);
-                    colourBuff.push_back(tempColour);
+                    colourBuff.push(tempColour);
                 }
                 else
                 {
@@ -1451,7 +1658,7 @@ void Vision::CloselyClassifyScanline(ScanLine* tempLine, TransitionSegment* temp
             tempSubEndPoint.y = tempY - bufferSize*skipPixel;
             tempColour = tempTransition->getColour();
             //qDebug() << "Searching closely for end:" ;
-            while(isValidColour(tempColour,colourList))
+            while(colourBuff.isValid(tempColour))
             {
                 //qDebug() << StartPoint.x+k << tempSubEndPoint.y;
                 if(StartPoint.x+k < width && StartPoint.x+k > 0 &&
@@ -1471,13 +1678,10 @@ void Vision::CloselyClassifyScanline(ScanLine* tempLine, TransitionSegment* temp
             tempColour = tempTransition->getColour();
             //Reseting ColourBuffer
             //qDebug() << "Resetting:";
-            for (int i = 0; i < bufferSize; i++)
-            {
-                colourBuff.push_back(tempTransition->getColour());
-            }
+            colourBuff.fill(tempTransition->getColour());
             //qDebug() << "Searching roughly:";
             //Search for Start of Perpendicular Segment
-            while(checkIfBufferContains(colourBuff, colourList))
+            while(colourBuff.containsAny())
             {
                 if(tempY-skipPixel < 0)
                 {
@@ -1489,7 +1693,7 @@ void Vision::CloselyClassifyScanline(ScanLine* tempLine, TransitionSegment* temp
                 {
                     tempColour = classifyPixel(StartPoint.x+k,tempY);
                     //debug << tempY<< "," << (int)tempColour<< endl;
-                    colourBuff.push_back(tempColour);
+                    colourBuff.push(tempColour);
                 }
                 else
                 {
@@ -1499,7 +1703,7 @@ void Vision::CloselyClassifyScanline(ScanLine* tempLine, TransitionSegment* temp
             tempSubStartPoint.y = tempY + bufferSize*skipPixel;
             tempColour = tempTransition->getColour();
             //qDebug() << "searching closely:";
-            while(isValidColour(tempColour,colourList))
+            while(colourBuff.isValid(tempColour))
             {
                 if(StartPoint.x+k < width && StartPoint.x+k > 0
                    && tempSubStartPoint.y-1 < height && tempSubStartPoint.y-1 > 0)
@@ -1525,20 +1729,8 @@ void Vision::CloselyClassifyScanline(ScanLine* tempLine, TransitionSegment* temp
     }
 }
 
-bool Vision::checkIfBufferContains(boost::circular_buffer<unsigned char> cb, const std::vector<unsigned char> &colourList)
-{
-    for(unsigned int i = 0; i < cb.size(); i++)
-    {
-        if(isValidColour(cb[i],colourList))
-        {
-            return true;
-        }
-    }
-    return false;
-}
-
-std::vector<ObjectCandidate> Vision::classifyCandidates(
-                                        std::vector< TransitionSegment > &segments,
+FrameVector<ObjectCandidate>::type Vision::classifyCandidates(
+                                        FrameVector<TransitionSegment>::type &segments,
                                         const std::vector<Vector2<int> >&fieldBorders,
                                         const std::vector<unsigned char> &validColours,
                                         int spacing,
@@ -1560,24 +1752,24 @@ std::vector<ObjectCandidate> Vision::classifyCandidates(
 
 }
 
-std::vector<ObjectCandidate> Vision::classifyCandidates(
-                                        std::vector< TransitionSegment > &segments,
+FrameVector<ObjectCandidate>::type Vision::classifyCandidates(
+                                        FrameVector<TransitionSegment>::type &segments,
                                         const std::vector<Vector2<int> >&fieldBorders,
                                         const std::vector<unsigned char> &validColours,
                                         int spacing,
-                                        float min_aspect, float max_aspect, int min_segments, std::vector< TransitionSegment > &leftover)
+                                        float min_aspect, float max_aspect, int min_segments, FrameVector<TransitionSegment>::type &leftover)
 {
     return classifyCandidatesPrims(segments, fieldBorders, validColours, spacing, min_aspect, max_aspect, min_segments, leftover);
 }
 
-std::vector<ObjectCandidate> Vision::classifyCandidatesPrims(std::vector< TransitionSegment > &segments,
+FrameVector<ObjectCandidate>::type Vision::classifyCandidatesPrims(FrameVector<TransitionSegment>::type &segments,
                                         const std::vector<Vector2<int> >&fieldBorders,
                                         const std::vector<unsigned char> &validColours,
                                         int spacing,
                                         float min_aspect, float max_aspect, int min_segments)
 {
     //! Overall runtime O( N^2 )
-    std::vector<ObjectCandidate> candidateList;
+    FrameVector<ObjectCandidate>::type candidateList;
 
     const int VERT_JOIN_LIMIT = 3;
     const int HORZ_JOIN_LIMIT = 1;
@@ -1588,9 +1780,9 @@ std::vector<ObjectCandidate> Vision::classifyCandidatesPrims(std::vector< Transi
         //! Sorting O(N*logN)
         sort(segments.begin(), segments.end(), Vision::sortTransitionSegments);
 
-        std::queue<int> qUnprocessed;
-        std::vector<TransitionSegment> candidate_segments;
-        std::vector<unsigned int> usedSegments;
+        std::queue<int, std::deque<int, FrameAllocator<int> > > qUnprocessed;
+        int firstSegment = 0;
+        FrameVector<unsigned int>::type usedSegments;
         unsigned int rawSegsLeft = segments.size();
         unsigned int nextRawSeg = 0;
 
@@ -1641,7 +1833,8 @@ std::vector<ObjectCandidate> Vision::classifyCandidatesPrims(std::vector< Transi
             //! For all unprocessed joined segment in a candidate O(M)
             //Build candidate
 
-            candidate_segments.clear();
+            //the candidate's segments are appended to the pool, and it refers to them by their span
+            firstSegment = CandidateSegments.size();
 
             while (!qUnprocessed.empty())
             {
@@ -1789,8 +1982,8 @@ std::vector<ObjectCandidate> Vision::classifyCandidatesPrims(std::vector< Transi
                 }
 
                 //add thisSeg to CandidateVector
-                candidate_segments.push_back(segments.at(thisSeg));
                 segments.at(thisSeg).isUsed = true;
+                CandidateSegments.push_back(segments.at(thisSeg));
                 usedSegments.push_back(thisSeg);
             }//while (!qUnprocessed->empty())
             //qDebug() << "Candidate ready...";
@@ -1809,14 +2002,12 @@ std::vector<ObjectCandidate> Vision::classifyCandidatesPrims(std::vector< Transi
                     if (i != max_col && colourHistogram[i] > colourHistogram[max_col])
                         max_col = i;
                 }
-                for(unsigned int i=0; i<candidate_segments.size(); i++) {
-                    candidate_segments[i].isUsed = true;
-                }
-                ObjectCandidate temp(min_x, min_y, max_x, max_y, validColours.at(max_col), candidate_segments);
+                ObjectCandidate temp(min_x, min_y, max_x, max_y, validColours.at(max_col), CandidateSegments, firstSegment, CandidateSegments.size() - firstSegment);
                 candidateList.push_back(temp);
                 usedSegments.clear();
             }
             else {
+                CandidateSegments.erase(CandidateSegments.begin() + firstSegment, CandidateSegments.end());
                 while(!usedSegments.empty()){
                     segments[usedSegments.back()].isUsed = false;
                     usedSegments.pop_back();
@@ -1829,15 +2020,15 @@ std::vector<ObjectCandidate> Vision::classifyCandidatesPrims(std::vector< Transi
     return candidateList;
 }
 
-std::vector<ObjectCandidate> Vision::classifyCandidatesPrims(std::vector< TransitionSegment > &segments,
+FrameVector<ObjectCandidate>::type Vision::classifyCandidatesPrims(FrameVector<TransitionSegment>::type &segments,
                                         const std::vector<Vector2<int> >&fieldBorders,
                                         const std::vector<unsigned char> &validColours,
                                         int spacing,
                                         float min_aspect, float max_aspect, int min_segments,
-                                        std::vector< TransitionSegment >& leftover)
+                                        FrameVector<TransitionSegment>::type& leftover)
 {
     //! Overall runtime O( N^2 )
-    std::vector<ObjectCandidate> candidateList;
+    FrameVector<ObjectCandidate>::type candidateList;
 
     const int VERT_JOIN_LIMIT = 3;
     const int HORZ_JOIN_LIMIT = 1;
@@ -1848,9 +2039,9 @@ std::vector<ObjectCandidate> Vision::classifyCandidatesPrims(std::vector< Transi
         //! Sorting O(N*logN)
         sort(segments.begin(), segments.end(), Vision::sortTransitionSegments);
 
-        std::queue<int> qUnprocessed;
-        std::vector<TransitionSegment> candidate_segments;
-        std::vector<unsigned int> usedSegments;
+        std::queue<int, std::deque<int, FrameAllocator<int> > > qUnprocessed;
+        int firstSegment = 0;
+        FrameVector<unsigned int>::type usedSegments;
         unsigned int rawSegsLeft = segments.size();
         unsigned int nextRawSeg = 0;
 
@@ -1901,7 +2092,8 @@ std::vector<ObjectCandidate> Vision::classifyCandidatesPrims(std::vector< Transi
             //! For all unprocessed joined segment in a candidate O(M)
             //Build candidate
 
-            candidate_segments.clear();
+            //the candidate's segments are appended to the pool, and it refers to them by their span
+            firstSegment = CandidateSegments.size();
 
             while (!qUnprocessed.empty())
             {
@@ -2049,8 +2241,8 @@ std::vector<ObjectCandidate> Vision::classifyCandidatesPrims(std::vector< Transi
                 }
 
                 //add thisSeg to CandidateVector
-                candidate_segments.push_back(segments.at(thisSeg));
                 segments.at(thisSeg).isUsed = true;
+                CandidateSegments.push_back(segments.at(thisSeg));
                 usedSegments.push_back(thisSeg);
             }//while (!qUnprocessed->empty())
             //qDebug() << "Candidate ready...";
@@ -2069,14 +2261,12 @@ std::vector<ObjectCandidate> Vision::classifyCandidatesPrims(std::vector< Transi
                     if (i != max_col && colourHistogram[i] > colourHistogram[max_col])
                         max_col = i;
                 }
-                for(unsigned int i=0; i<candidate_segments.size(); i++) {
-                    candidate_segments[i].isUsed = true;
-                }
-                ObjectCandidate temp(min_x, min_y, max_x, max_y, validColours.at(max_col), candidate_segments);
+                ObjectCandidate temp(min_x, min_y, max_x, max_y, validColours.at(max_col), CandidateSegments, firstSegment, CandidateSegments.size() - firstSegment);
                 candidateList.push_back(temp);
                 usedSegments.clear();
             }
             else {
+                CandidateSegments.erase(CandidateSegments.begin() + firstSegment, CandidateSegments.end());
                 while(!usedSegments.empty()){
                     segments[usedSegments.back()].isUsed = false;
                     leftover.push_back( segments[usedSegments.back()] );
@@ -2090,13 +2280,13 @@ std::vector<ObjectCandidate> Vision::classifyCandidatesPrims(std::vector< Transi
     return candidateList;
 }
 
-std::vector<ObjectCandidate> Vision::classifyCandidatesDBSCAN(std::vector< TransitionSegment > &segments,
+FrameVector<ObjectCandidate>::type Vision::classifyCandidatesDBSCAN(FrameVector<TransitionSegment>::type &segments,
                                         const std::vector<Vector2<int> >&fieldBorders,
                                         const std::vector<unsigned char> &validColours,
                                         int spacing,
                                         float min_aspect, float max_aspect, int min_segments)
 {
-    std::vector<ObjectCandidate> candidateList;
+    FrameVector<ObjectCandidate>::type candidateList;
 
     //unimplemented
 
@@ -2206,34 +2396,17 @@ int Vision::findInterceptFromPerspectiveFrustum(const std::vector<Vector2<int> >
     return intercept;
 }
 
-bool Vision::sortTransitionSegments(TransitionSegment a, TransitionSegment b)
+bool Vision::sortTransitionSegments(const TransitionSegment& a, const TransitionSegment& b)
 {
     return (a.getStartPoint().x < b.getStartPoint().x || (a.getStartPoint().x == b.getStartPoint().x && a.getEndPoint().y <= b.getStartPoint().y));
 }
 
-bool Vision::checkIfBufferSame(boost::circular_buffer<unsigned char> cb)
-{
-
-    unsigned char currentClass = cb[0];
-    for (unsigned int i = 1; i < cb.size(); i++)
-    {
-        if(cb[i] != currentClass)
-        {
-            return false;
-        }
-    }
-    return true;
-
-}
-
-std::vector< ObjectCandidate > Vision::ClassifyCandidatesAboveTheHorizon(   std::vector< TransitionSegment > &horizontalsegments,
+FrameVector<ObjectCandidate>::type Vision::ClassifyCandidatesAboveTheHorizon(   FrameVector<TransitionSegment>::type &horizontalsegments,
                                                                             const std::vector<unsigned char> &validColours,
                                                                             int spacing,
                                                                             int min_segments)
 {
-    std::vector< ObjectCandidate > candidates;
-    std::vector< TransitionSegment > tempSegments;
-    tempSegments.reserve(horizontalsegments.size());
+    FrameVector<ObjectCandidate>::type candidates;
     candidates.reserve(horizontalsegments.size());
 
     bool usedSegments[horizontalsegments.size()];
@@ -2250,8 +2423,9 @@ std::vector< ObjectCandidate > Vision::ClassifyCandidatesAboveTheHorizon(   std:
     //ASSUMING EVERYTHING IS ALREADY ORDERED
     for(int i = horizontalsegments.size()-1; i > 0; i--)
     {
-        tempSegments.clear();
-        std::vector<int> tempUsedSegments;
+        //the candidate's segments are appended to the pool, and it refers to them by their span
+        int firstSegment = CandidateSegments.size();
+        FrameVector<int>::type tempUsedSegments;
         tempUsedSegments.reserve(horizontalsegments.size());
         if(!isValidColour(horizontalsegments[i].getColour(), validColours))
         {
@@ -2266,7 +2440,7 @@ std::vector< ObjectCandidate > Vision::ClassifyCandidatesAboveTheHorizon(   std:
         Yend = horizontalsegments[i].getEndPoint().y;
         Xstart = horizontalsegments[i].getStartPoint().x;
         Xend = horizontalsegments[i].getEndPoint().x;
-        tempSegments.push_back(horizontalsegments[i]);
+        CandidateSegments.push_back(horizontalsegments[i]);
         horizontalsegments[i].isUsed = true;
         tempUsedSegments.push_back(i);
         int nextSegCounter = i-1;
@@ -2291,7 +2465,7 @@ std::vector< ObjectCandidate > Vision::ClassifyCandidatesAboveTheHorizon(   std:
                && horizontalsegments[nextSegCounter].getEndPoint().x  >= Xstart + spacing)
             {
                 //Update with new info
-                tempSegments.push_back(horizontalsegments[nextSegCounter]);
+                CandidateSegments.push_back(horizontalsegments[nextSegCounter]);
                 horizontalsegments[nextSegCounter].isUsed = true;
                 tempUsedSegments.push_back(nextSegCounter);
                 if (horizontalsegments[nextSegCounter].getStartPoint().x <= Xstart)
@@ -2335,22 +2509,19 @@ std::vector< ObjectCandidate > Vision::ClassifyCandidatesAboveTheHorizon(   std:
                 {
                     Ystart = horizontalsegments[j].getStartPoint().y;
                 }
-                tempSegments.push_back(horizontalsegments[j]);
+                CandidateSegments.push_back(horizontalsegments[j]);
                 horizontalsegments[j].isUsed = true;
                 tempUsedSegments.push_back(j);
             }
 
         }
-        //qDebug() << "About: Creating candidate: " << Xstart << ","<< Ystart<< ","<< Xend<< ","<< Yend << " Size: " << tempSegments.size();
+        int numSegments = CandidateSegments.size() - firstSegment;
+        //qDebug() << "About: Creating candidate: " << Xstart << ","<< Ystart<< ","<< Xend<< ","<< Yend << " Size: " << numSegments;
         //Create Object Candidate if greater then the minimum number of segments
-        if((int)tempSegments.size() >= min_segments)
+        if(numSegments >= min_segments)
         {
-            //qDebug() << "Creating candidate: " << Xstart << ","<< Ystart<< ","<< Xend<< ","<< Yend << " Size: " << tempSegments.size();
-            //for(size_t i =0; i < tempSegments.size(); i++)
-            //{
-                //qDebug() << tempSegments[i].getStartPoint().x << "," <<tempSegments[i].getStartPoint().y << " " << tempSegments[i].getEndPoint().x << "," <<tempSegments[i].getEndPoint().y;
-            //}
-            ObjectCandidate tempCandidate(Xstart, Ystart, Xend, Yend, validColours[0], tempSegments);
+            //qDebug() << "Creating candidate: " << Xstart << ","<< Ystart<< ","<< Xend<< ","<< Yend << " Size: " << numSegments;
+            ObjectCandidate tempCandidate(Xstart, Ystart, Xend, Yend, validColours[0], CandidateSegments, firstSegment, numSegments);
             candidates.push_back(tempCandidate);
             while (!tempUsedSegments.empty())
             {
@@ -2360,6 +2531,7 @@ std::vector< ObjectCandidate > Vision::ClassifyCandidatesAboveTheHorizon(   std:
         }
         else {
             //reset segments to not used
+            CandidateSegments.erase(CandidateSegments.begin() + firstSegment, CandidateSegments.end());
             while (!tempUsedSegments.empty())
             {
                 horizontalsegments[tempUsedSegments.back()].isUsed = false;
@@ -2372,15 +2544,13 @@ std::vector< ObjectCandidate > Vision::ClassifyCandidatesAboveTheHorizon(   std:
     return candidates;
 }
 
-std::vector< ObjectCandidate > Vision::ClassifyCandidatesAboveTheHorizon(   std::vector< TransitionSegment > &horizontalsegments,
+FrameVector<ObjectCandidate>::type Vision::ClassifyCandidatesAboveTheHorizon(   FrameVector<TransitionSegment>::type &horizontalsegments,
                                                                             const std::vector<unsigned char> &validColours,
                                                                             int spacing,
                                                                             int min_segments,
-                                                                            std::vector< TransitionSegment > &leftover)
+                                                                            FrameVector<TransitionSegment>::type &leftover)
 {
-    std::vector< ObjectCandidate > candidates;
-    std::vector< TransitionSegment > tempSegments;
-    tempSegments.reserve(horizontalsegments.size());
+    FrameVector<ObjectCandidate>::type candidates;
     candidates.reserve(horizontalsegments.size());
 
     bool usedSegments[horizontalsegments.size()];
@@ -2397,8 +2567,9 @@ std::vector< ObjectCandidate > Vision::ClassifyCandidatesAboveTheHorizon(   std:
     //ASSUMING EVERYTHING IS ALREADY ORDERED
     for(int i = horizontalsegments.size()-1; i > 0; i--)
     {
-        tempSegments.clear();
-        std::vector<int> tempUsedSegments;
+        //the candidate's segments are appended to the pool, and it refers to them by their span
+        int firstSegment = CandidateSegments.size();
+        FrameVector<int>::type tempUsedSegments;
         tempUsedSegments.reserve(horizontalsegments.size());
         if(!isValidColour(horizontalsegments[i].getColour(), validColours))
         {
@@ -2413,7 +2584,7 @@ std::vector< ObjectCandidate > Vision::ClassifyCandidatesAboveTheHorizon(   std:
         Yend = horizontalsegments[i].getEndPoint().y;
         Xstart = horizontalsegments[i].getStartPoint().x;
         Xend = horizontalsegments[i].getEndPoint().x;
-        tempSegments.push_back(horizontalsegments[i]);
+        CandidateSegments.push_back(horizontalsegments[i]);
         horizontalsegments[i].isUsed = true;
         tempUsedSegments.push_back(i);
         int nextSegCounter = i-1;
@@ -2438,7 +2609,7 @@ std::vector< ObjectCandidate > Vision::ClassifyCandidatesAboveTheHorizon(   std:
                && horizontalsegments[nextSegCounter].getEndPoint().x  >= Xstart + spacing)
             {
                 //Update with new info
-                tempSegments.push_back(horizontalsegments[nextSegCounter]);
+                CandidateSegments.push_back(horizontalsegments[nextSegCounter]);
                 horizontalsegments[nextSegCounter].isUsed = true;
                 tempUsedSegments.push_back(nextSegCounter);
                 if (horizontalsegments[nextSegCounter].getStartPoint().x <= Xstart)
@@ -2482,22 +2653,19 @@ std::vector< ObjectCandidate > Vision::ClassifyCandidatesAboveTheHorizon(   std:
                 {
                     Ystart = horizontalsegments[j].getStartPoint().y;
                 }
-                tempSegments.push_back(horizontalsegments[j]);
+                CandidateSegments.push_back(horizontalsegments[j]);
                 horizontalsegments[j].isUsed = true;
                 tempUsedSegments.push_back(j);
             }
 
         }
-        //qDebug() << "About: Creating candidate: " << Xstart << ","<< Ystart<< ","<< Xend<< ","<< Yend << " Size: " << tempSegments.size();
+        int numSegments = CandidateSegments.size() - firstSegment;
+        //qDebug() << "About: Creating candidate: " << Xstart << ","<< Ystart<< ","<< Xend<< ","<< Yend << " Size: " << numSegments;
         //Create Object Candidate if greater then the minimum number of segments
-        if((int)tempSegments.size() >= min_segments)
+        if(numSegments >= min_segments)
         {
-            //qDebug() << "Creating candidate: " << Xstart << ","<< Ystart<< ","<< Xend<< ","<< Yend << " Size: " << tempSegments.size();
-            //for(size_t i =0; i < tempSegments.size(); i++)
-            //{
-                //qDebug() << tempSegments[i].getStartPoint().x << "," <<tempSegments[i].getStartPoint().y << " " << tempSegments[i].getEndPoint().x << "," <<tempSegments[i].getEndPoint().y;
-            //}
-            ObjectCandidate tempCandidate(Xstart, Ystart, Xend, Yend, validColours[0], tempSegments);
+            //qDebug() << "Creating candidate: " << Xstart << ","<< Ystart<< ","<< Xend<< ","<< Yend << " Size: " << numSegments;
+            ObjectCandidate tempCandidate(Xstart, Ystart, Xend, Yend, validColours[0], CandidateSegments, firstSegment, numSegments);
             candidates.push_back(tempCandidate);
             while (!tempUsedSegments.empty())
             {
@@ -2507,6 +2675,7 @@ std::vector< ObjectCandidate > Vision::ClassifyCandidatesAboveTheHorizon(   std:
         }
         else {
             //reset segments to not used
+            CandidateSegments.erase(CandidateSegments.begin() + firstSegment, CandidateSegments.end());
             while (!tempUsedSegments.empty())
             {
                 horizontalsegments[tempUsedSegments.back()].isUsed = false;
@@ -2540,7 +2709,7 @@ void Vision::DetectLines(LineDetection* LineDetector)
 
     return;
 }
-void Vision::DetectLines(LineDetection* LineDetector, vector< ObjectCandidate >& candidates, vector< TransitionSegment >& leftover)
+void Vision::DetectLines(LineDetection* LineDetector, FrameVector<ObjectCandidate>::type& candidates, FrameVector<TransitionSegment>::type& leftover)
 {
     //qDebug() << "Forming Lines:" << endl;
 
@@ -2550,12 +2719,10 @@ void Vision::DetectLines(LineDetection* LineDetector, vector< ObjectCandidate >&
 
     return;
 }
-Circle Vision::DetectBall(const std::vector<ObjectCandidate> &FO_Candidates)
+Circle Vision::DetectBall(const FrameVector<ObjectCandidate>::type &FO_Candidates)
 {
     //debug<< "Vision::DetectBall" << endl;
 
-    Ball BallFinding;
-
     //qDebug() << "Vision::DetectBall : Ball Class created" << endl;
     int width = currentImage->getWidth();
     int height = currentImage->getHeight();
@@ -2569,7 +2736,7 @@ Circle Vision::DetectBall(const std::vector<ObjectCandidate> &FO_Candidates)
         return ball;
     }
     //qDebug() << "Vision::DetectBall : Find Ball" << endl;
-    ball = BallFinding.FindBall(FO_Candidates, AllFieldObjects, this, height, width);
+    ball = BallFinding->FindBall(FO_Candidates, AllFieldObjects, this, height, width);
     //qDebug() << "Vision::DetectBall : Finnised FO_Ball" << endl;
     if(ball.isDefined)
     {
@@ -2594,7 +2761,7 @@ Circle Vision::DetectBall(const std::vector<ObjectCandidate> &FO_Candidates)
         visualSphericalPosition[2] = elevation;
         
         vector<float> ctvector;
-        bool isOK = getSensorsData()->get(NUSensorsData::CameraTransform, ctvector);
+        bool isOK = getCameraTransform(ctvector);
         if(isOK == true)
         {
             Matrix cameraTransform = Matrix4x4fromVector(ctvector);
@@ -2624,7 +2791,7 @@ Circle Vision::DetectBall(const std::vector<ObjectCandidate> &FO_Candidates)
 
 }
 
-void Vision::DetectGoals(std::vector<ObjectCandidate>& FO_Candidates,std::vector<ObjectCandidate>& FO_AboveHorizonCandidates,std::vector< TransitionSegment > horizontalSegments)
+void Vision::DetectGoals(FrameVector<ObjectCandidate>::type& FO_Candidates,FrameVector<ObjectCandidate>::type& FO_AboveHorizonCandidates,const FrameVector<TransitionSegment>::type& horizontalSegments)
 {
     int width = currentImage->getWidth();
     int height = currentImage->getHeight();
@@ -2640,13 +2807,13 @@ void Vision::PostProcessGoals()
     return;
 }
 
-void Vision::DetectRobots(std::vector < ObjectCandidate > &RobotCandidates)
+void Vision::DetectRobots(FrameVector<ObjectCandidate>::type &RobotCandidates)
 {
     int MaxPercentageOfColour = 50;
     int MinPercentageOfColour = 1;
     for(unsigned int i = 0; i < RobotCandidates.size(); i++)
     {
-        std::vector <TransitionSegment > segments = RobotCandidates[i].getSegments();
+        SegmentSpan segments = RobotCandidates[i].getSegments();
         int pinkSize = 0;
         int blueSize = 0;
         int whiteSize = 0;
@@ -2685,7 +2852,7 @@ void Vision::DetectRobots(std::vector < ObjectCandidate > &RobotCandidates)
             vector<float> ctgvector;
             Vector3<float> measured(distance,bearing,elevation);
             Vector2<float> screenPositionAngle(bearing,elevation);
-            bool isOK = getSensorsData()->get(NUSensorsData::CameraToGroundTransform, ctgvector); 
+            bool isOK = getCameraToGroundTransform(ctgvector); 
             if(isOK == true)
             {
                 Matrix camera2groundTransform = Matrix4x4fromVector(ctgvector);
@@ -2720,7 +2887,7 @@ void Vision::DetectRobots(std::vector < ObjectCandidate > &RobotCandidates)
             vector<float> ctgvector;
             Vector3<float> measured(distance,bearing,elevation);
             Vector2<float> screenPositionAngle(bearing,elevation);
-            bool isOK = getSensorsData()->get(NUSensorsData::CameraToGroundTransform, ctgvector); 
+            bool isOK = getCameraToGroundTransform(ctgvector); 
             if(isOK == true)
             {
                 Matrix camera2groundTransform = Matrix4x4fromVector(ctgvector);
@@ -2760,6 +2927,72 @@ double Vision::EFFECTIVE_CAMERA_DISTANCE_IN_PIXELS()
     return (0.5*currentImage->getWidth())/(tan(0.5*FOVx));
 }
 
+/*! @brief Predicts which landmarks should be in the current image from the last pose and the image's camera transform.
+           Nothing is ruled out when the robot is lost, or the camera transform is not available.
+ */
+void Vision::predictExpectedLandmarks()
+{
+    Self& self = AllFieldObjects->self;
+    vector<float> ctgvector;
+    m_expected_landmarks.setImageSize(currentImage->getWidth(), currentImage->getHeight());
+    if (not self.lost() and getCameraToGroundTransform(ctgvector) and m_expected_landmarks.setCamera(ctgvector))
+        m_expected_landmarks.setPose(self.wmX(), self.wmY(), self.Heading(), self.sdX(), self.sdY(), self.sdHeading());
+    else
+        m_expected_landmarks.invalidate();
+    m_expected_landmarks.predict(AllFieldObjects->stationaryFieldObjects);
+
+    #if DEBUG_VISION_VERBOSITY > 5
+        debug << "Vision::predictExpectedLandmarks(). Valid: " << m_expected_landmarks.isValid();
+        debug << " Blue goal: " << isGoalExpected(FieldObjects::FO_BLUE_LEFT_GOALPOST, FieldObjects::FO_BLUE_RIGHT_GOALPOST);
+        debug << " Yellow goal: " << isGoalExpected(FieldObjects::FO_YELLOW_LEFT_GOALPOST, FieldObjects::FO_YELLOW_RIGHT_GOALPOST) << endl;
+    #endif
+}
+
+/*! @brief Predicts the regions of the current image the ball and goals will be in, from where they were in the previous
+           images and how the camera has moved since. Without the camera transform the camera is assumed not to have moved.
+ */
+void Vision::predictRegionsOfInterest()
+{
+    vector<float> ctgvector;
+    if (not getCameraToGroundTransform(ctgvector))
+        ctgvector.clear();
+    m_roi_tracker.setImageSize(currentImage->getWidth(), currentImage->getHeight());
+    m_roi_tracker.predict(currentImage->m_timestamp, ctgvector);
+
+    #if DEBUG_VISION_VERBOSITY > 5
+        for (int i=0; i<RegionOfInterestTracker::NumTargets; i++)
+        {
+            const RegionOfInterestTracker::Region& region = m_roi_tracker.getRegion(static_cast<RegionOfInterestTracker::Target>(i));
+            debug << "Vision::predictRegionsOfInterest(). " << RegionOfInterestTracker::getName(static_cast<RegionOfInterestTracker::Target>(i));
+            debug << " Valid: " << region.Valid << " [" << region.MinX << "," << region.MinY << "] [" << region.MaxX << "," << region.MaxY << "]" << endl;
+        }
+    #endif
+}
+
+/*! @brief Returns true if either post of a goal could be in the current image */
+bool Vision::isGoalExpected(int leftpost, int rightpost) const
+{
+    return m_expected_landmarks.isExpected(leftpost) or m_expected_landmarks.isExpected(rightpost);
+}
+
+/*! @brief Returns true if the image column x could contain either post of a goal */
+bool Vision::isInExpectedGoalColumns(int x, int leftpost, int rightpost) const
+{
+    const LandmarkVisibility::ExpectedLandmark& left = m_expected_landmarks.getExpected(leftpost);
+    const LandmarkVisibility::ExpectedLandmark& right = m_expected_landmarks.getExpected(rightpost);
+    if (not m_expected_landmarks.isValid())
+        return true;
+    else
+        return (left.Expected and x >= left.MinX and x <= left.MaxX) or (right.Expected and x >= right.MinX and x <= right.MaxX);
+}
+
+/*! @brief Charges the time since the previous stage to the given stage, if the stages are being timed */
+void Vision::markStage(VisionStageTimer::Stage stage)
+{
+    if (m_stage_timer != NULL)
+        m_stage_timer->split(stage);
+}
+
 /*! @brief Returns the number of frames dropped since the last call to this function
     @return the number of frames dropped
  */
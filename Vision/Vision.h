@@ -16,19 +16,28 @@
 #include "RobotCandidate.h"
 #include "LineDetection.h"
 #include "ObjectCandidate.h"
+#include "ColourHistory.h"
 #include "NUPlatform/NUCamera.h"
 #include "Tools/Math/Vector2.h"
 #include "Tools/FileFormats/LUTTools.h"
+#include "Infrastructure/NUSensorsData/KinematicHistory.h"
+#include "Infrastructure/FieldObjects/LandmarkVisibility.h"
+#include "VisionStageTimer.h"
+#include "LookUpTable.h"
+#include "FrameArena.h"
+#include "RegionOfInterestTracker.h"
 
 #include <vector>
-#include <boost/circular_buffer.hpp>
 #include <iostream>
 #include <fstream>
+#include <pthread.h>
 //#include <QImage>
 
 class NUSensorsData;
 class NUActionatorsData;
 class SaveImagesThread;
+class LoadLUTThread;
+class Ball;
 class NUPlatform;
 
 #define ORANGE_BALL_DIAMETER 6.5 //IN CM for NEW BALL
@@ -44,17 +53,33 @@ class Vision
     private:
     const NUImage* currentImage;                //!< Storage of a pointer to the raw colour image.
     const unsigned char* currentLookupTable;    //!< Storage of the current colour lookup table.
-    unsigned char* LUTBuffer;                   //!< Storage of the current colour lookup table.
+    LookUpTable m_lut;                          //!< the latest lookup table; it may be replaced by any thread, so it is guarded by m_lut_mutex
+    pthread_mutex_t m_lut_mutex;                //!< lock for m_lut
+    LookUpTable m_frame_lut;                    //!< the lookup table used for the current frame; it keeps currentLookupTable alive until the next frame
     unsigned char* testLUTBuffer;
     int spacings;
     
     NUSensorsData* m_sensor_data;               //!< pointer to shared sensor data object
+    KinematicState m_image_kinematics;          //!< the kinematic sensors at the time the current image was taken
+    bool m_has_image_kinematics;                //!< true if m_image_kinematics was found, otherwise the latest sensor data is used
+    LandmarkVisibility m_expected_landmarks;    //!< the landmarks expected to be in the current image
+    VisionStageTimer* m_stage_timer;            //!< the timer for each stage of ProcessFrame(), or NULL when the stages are not timed
+    FrameArena m_frame_arena;                   //!< the memory for the temporaries of ProcessFrame(); it is reset at the end of each frame
+    int m_scan_mode;                            //!< the ScanMode used by ProcessFrame()
+    RegionOfInterestTracker m_roi_tracker;      //!< the regions the ball and goals are expected in, used by MultiResolutionScan
     NUActionatorsData* m_actions;               //!< pointer to shared actionators data object
     friend class SaveImagesThread;
     SaveImagesThread* m_saveimages_thread;      //!< an external thread to do saving images in parallel with vision processing
+    LoadLUTThread* m_loadlut_thread;            //!< an external thread to load lookup tables without stalling vision processing
     
     int findYFromX(const std::vector<Vector2<int> >&points, int x);
-    bool checkIfBufferSame(boost::circular_buffer<unsigned char> cb);
+
+    void predictExpectedLandmarks();
+    bool isGoalExpected(int leftpost, int rightpost) const;
+    bool isInExpectedGoalColumns(int x, int leftpost, int rightpost) const;
+    void markStage(VisionStageTimer::Stage stage);
+    void acquireLUT();
+    void predictRegionsOfInterest();
 
     //! SavingImages:
     bool isSavingImages;
@@ -67,9 +92,22 @@ class Vision
     int numFramesProcessed;             //!< the number of frames processed since the last call to getNumFramesProcessed()
     CameraSettings currentSettings;
 
+    //! Per frame scan areas and segments. They are reset every frame, but keep their memory.
+    ClassifiedSection vertScanArea;
+    ClassifiedSection horiScanArea;
+    std::vector< TransitionSegment > CandidateSegments;    //!< the segments of every object candidate of the frame; each candidate refers to a span of them
+    Ball* BallFinding;                                      //!< the ball detector, kept so that its close classification and fitting workspace are reused
+
     void SaveAnImage();
 
     public:
+    //! The ways ProcessFrame() can place its scan lines
+    enum ScanMode
+    {
+        FullScan,                               //!< the whole image at the full density
+        MultiResolutionScan                     //!< the whole image at a coarse density, and densely inside the regions the ball and goals are expected in
+    };
+
     //! FieldObjects Container
     FieldObjects* AllFieldObjects;
     Horizon m_horizonLine;
@@ -97,8 +135,16 @@ class Vision
 
     void setActionatorsData(NUActionatorsData* actions);
 
+    void setStageTimer(VisionStageTimer* timer);
+    void setScanMode(ScanMode mode);
+    ScanMode getScanMode() const;
+    const RegionOfInterestTracker& getRegionOfInterestTracker() const;
+    const FrameArena& getFrameArena() const;
+
     void setLUT(unsigned char* newLUT);
+    void setLUT(const LookUpTable& lut);
     void loadLUTFromFile(const std::string& fileName);
+    void loadLUTFromFileInBackground(const std::string& fileName);
 
     void setImage(const NUImage* sourceImage);
     int getNumFramesDropped();
@@ -158,34 +204,34 @@ class Vision
       @returns A list of ObjectCanidates
     */
 
-    std::vector<ObjectCandidate> classifyCandidates(std::vector< TransitionSegment > &segments,
+    FrameVector<ObjectCandidate>::type classifyCandidates(FrameVector<TransitionSegment>::type &segments,
                                                     const std::vector<Vector2<int> >&fieldBorders,
                                                     const std::vector<unsigned char> &validColours,
                                                     int spacing,
                                                     float min_aspect, float max_aspect, int min_segments,
                                                     tCLASSIFY_METHOD method);
 
-    std::vector<ObjectCandidate> classifyCandidates(std::vector< TransitionSegment > &segments,
+    FrameVector<ObjectCandidate>::type classifyCandidates(FrameVector<TransitionSegment>::type &segments,
                                                     const std::vector<Vector2<int> >&fieldBorders,
                                                     const std::vector<unsigned char> &validColours,
                                                     int spacing,
                                                     float min_aspect, float max_aspect, int min_segments,
-                                                    std::vector< TransitionSegment >& leftover);
+                                                    FrameVector<TransitionSegment>::type& leftover);
 
-    std::vector<ObjectCandidate> classifyCandidatesPrims(std::vector< TransitionSegment > &segments,
+    FrameVector<ObjectCandidate>::type classifyCandidatesPrims(FrameVector<TransitionSegment>::type &segments,
                                                          const std::vector<Vector2<int> >&fieldBorders,
                                                          const std::vector<unsigned char> &validColours,
                                                          int spacing,
                                                          float min_aspect, float max_aspect, int min_segments);
 
-    std::vector<ObjectCandidate> classifyCandidatesPrims(std::vector< TransitionSegment > &segments,
+    FrameVector<ObjectCandidate>::type classifyCandidatesPrims(FrameVector<TransitionSegment>::type &segments,
                                                          const std::vector<Vector2<int> >&fieldBorders,
                                                          const std::vector<unsigned char> &validColours,
                                                          int spacing,
                                                          float min_aspect, float max_aspect, int min_segments,
-                                                         std::vector< TransitionSegment >& leftover);
+                                                         FrameVector<TransitionSegment>::type& leftover);
 
-    std::vector<ObjectCandidate> classifyCandidatesDBSCAN(std::vector< TransitionSegment > &segments,
+    FrameVector<ObjectCandidate>::type classifyCandidatesDBSCAN(FrameVector<TransitionSegment>::type &segments,
                                                           const std::vector<Vector2<int> >&fieldBorders,
                                                           const std::vector<unsigned char> &validColours,
                                                           int spacing,
@@ -201,41 +247,42 @@ class Vision
     bool isValidColour(unsigned char colour, const std::vector<unsigned char> &colourList);
 
     int findInterceptFromPerspectiveFrustum(const std::vector<Vector2<int> >&points, int current_x, int target_x, int spacing);
-    static bool sortTransitionSegments(TransitionSegment a, TransitionSegment b);
+    static bool sortTransitionSegments(const TransitionSegment& a, const TransitionSegment& b);
 
     std::vector<Vector2<int> > findGreenBorderPoints(int scanSpacing, Horizon* horizonLine);
     std::vector<Vector2<int> > getConvexFieldBorders(const std::vector<Vector2<int> >& fieldBorders);
     std::vector<Vector2<int> > interpolateBorders(const std::vector<Vector2<int> >& fieldBorders, int scanSpacing);
 
 
-    ClassifiedSection horizontalScan(const std::vector<Vector2<int> >&fieldBoarders, int scanSpacing);
-    ClassifiedSection verticalScan(const std::vector<Vector2<int> >&fieldBoarders, int scanSpacing);
+    void horizontalScan(const std::vector<Vector2<int> >&fieldBoarders, int scanSpacing, ClassifiedSection& scanArea, bool coarse = false);
+    void verticalScan(const std::vector<Vector2<int> >&fieldBoarders, int scanSpacing, ClassifiedSection& scanArea, bool coarse = false);
+    void addRegionOfInterestScans(int scanSpacing, ClassifiedSection& verticalArea, ClassifiedSection& horizontalArea);
     void ClassifyScanArea(ClassifiedSection* scanArea);
     void CloselyClassifyScanline(ScanLine* tempLine, TransitionSegment* tempSeg, int spacing, int direction, const std::vector<unsigned char> &colourList);
 
     void DetectLineOrRobotPoints(ClassifiedSection* scanArea, LineDetection* LineDetector);
 
     void DetectLines(LineDetection* LineDetector);
-    void DetectLines(LineDetection* LineDetector, vector<ObjectCandidate>& candidates, vector< TransitionSegment >& leftover);
+    void DetectLines(LineDetection* LineDetector, FrameVector<ObjectCandidate>::type& candidates, FrameVector<TransitionSegment>::type& leftover);
 
-     std::vector< ObjectCandidate > ClassifyCandidatesAboveTheHorizon(std::vector< TransitionSegment > &segments,
+     FrameVector<ObjectCandidate>::type ClassifyCandidatesAboveTheHorizon(FrameVector<TransitionSegment>::type &segments,
                                                                       const std::vector<unsigned char> &validColours,
                                                                       int spacing, int min_segments);
 
-     std::vector< ObjectCandidate > ClassifyCandidatesAboveTheHorizon(std::vector< TransitionSegment > &segments,
+     FrameVector<ObjectCandidate>::type ClassifyCandidatesAboveTheHorizon(FrameVector<TransitionSegment>::type &segments,
                                                                       const std::vector<unsigned char> &validColours,
                                                                       int spacing, int min_segments,
-                                                                      std::vector< TransitionSegment > &leftover);
+                                                                      FrameVector<TransitionSegment>::type &leftover);
 
-    Circle DetectBall(const std::vector<ObjectCandidate> &FO_Candidates);
+    Circle DetectBall(const FrameVector<ObjectCandidate>::type &FO_Candidates);
 
-    void DetectGoals(std::vector<ObjectCandidate>& FO_Candidates,
-                     std::vector<ObjectCandidate>& FO_AboveHorizonCandidates,
-                     const std::vector< TransitionSegment > horizontalSegments);
+    void DetectGoals(FrameVector<ObjectCandidate>::type& FO_Candidates,
+                     FrameVector<ObjectCandidate>::type& FO_AboveHorizonCandidates,
+                     const FrameVector<TransitionSegment>::type& horizontalSegments);
 
     void PostProcessGoals();
 
-    void DetectRobots(std::vector<ObjectCandidate> &RobotCandidates);
+    void DetectRobots(FrameVector<ObjectCandidate>::type &RobotCandidates);
 
     bool isPixelOnScreen(int x, int y);
     int getImageHeight(){ return currentImage->getHeight();}
@@ -244,7 +291,10 @@ class Vision
     int getScanSpacings(){return spacings;}
 
     NUSensorsData* getSensorsData() {return m_sensor_data;}
-    bool checkIfBufferContains(boost::circular_buffer<unsigned char> cb, const std::vector<unsigned char> &colourList);
+    bool getCameraTransform(std::vector<float>& data);
+    bool getCameraToGroundTransform(std::vector<float>& data);
+    bool getHorizon(std::vector<float>& data);
+    bool getHeadPitch(float& data);
 
     int CalculateSkipSpacing(int currentPosition, int lineLength, bool greenSeen);
 
@@ -0,0 +1,113 @@
+/*! @file VisionStageTimer.h
+    @brief Declaration and implementation of VisionStageTimer class
+
+    @class VisionStageTimer
+    @brief Accumulates the time spent in each stage of Vision::ProcessFrame()
+
+    Vision calls start() at the beginning of a frame and split() at the end of each stage, so the
+    time since the previous split is charged to the stage that just finished. The clock is supplied
+    by the owner, so that the same timer can measure wall time on the robot or per-thread cpu time
+    in the offline tools. When Vision has no timer the hooks cost a single pointer comparison.
+
+    @author agent
+
+  Copyright (c) 2026 agent
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef VISION_STAGE_TIMER_H
+#define VISION_STAGE_TIMER_H
+
+class VisionStageTimer
+{
+public:
+    /*! @brief The stages of Vision::ProcessFrame() in the order they are run */
+    enum Stage
+    {
+        Setup = 0,              //!< kinematics, the horizon and the expected landmarks
+        GreenBorder = 1,        //!< the green border points and the convex field border
+        Scan = 2,               //!< generating the vertical and horizontal scan lines
+        Classify = 3,           //!< classifying the scan lines into segments
+        Segments = 4,           //!< sorting the segments, line/robot points and line candidates
+        Candidates = 5,         //!< forming the robot, ball and goal candidates
+        Robots = 6,
+        Goals = 7,
+        Lines = 8,
+        Ball = 9,
+        NumStages = 10
+    };
+
+    typedef double (*Clock)();          //!< a function returning the current time in ms
+
+    /*! @brief Creates a timer reading the given clock */
+    VisionStageTimer(Clock clock) : m_clock(clock), m_last(0)
+    {
+        reset();
+    }
+
+    /*! @brief Sets all of the stage times to zero */
+    void reset()
+    {
+        for (int i=0; i<NumStages; i++)
+            m_times[i] = 0;
+    }
+
+    /*! @brief Marks the start of a frame, and clears the stage times */
+    void start()
+    {
+        reset();
+        m_last = m_clock();
+    }
+
+    /*! @brief Charges the time since the previous split (or start) to the given stage */
+    void split(Stage stage)
+    {
+        double now = m_clock();
+        m_times[stage] += now - m_last;
+        m_last = now;
+    }
+
+    /*! @brief Returns the time in ms spent in the stage during the current frame */
+    double get(Stage stage) const
+    {
+        return m_times[stage];
+    }
+
+    /*! @brief Returns the total time in ms spent in all stages during the current frame */
+    double getTotal() const
+    {
+        double total = 0;
+        for (int i=0; i<NumStages; i++)
+            total += m_times[i];
+        return total;
+    }
+
+    /*! @brief Returns a short name for the stage */
+    static const char* getName(Stage stage)
+    {
+        static const char* names[] = {"setup", "border", "scan", "classify", "segments", "candidates", "robots", "goals", "lines", "ball"};
+        if (stage < 0 or stage >= NumStages)
+            return "unknown";
+        return names[stage];
+    }
+
+private:
+    Clock m_clock;                      //!< the clock used to time the stages
+    double m_last;                      //!< the time of the previous split
+    double m_times[NumStages];          //!< the time spent in each stage this frame
+};
+
+#endif
+
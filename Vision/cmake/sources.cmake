@@ -27,8 +27,12 @@ ClassifiedSection.cpp
 ObjectCandidate.cpp
 RobotCandidate.cpp
 ScanLine.cpp
+SegmentTable.cpp
 TransitionSegment.cpp
 Vision.cpp
+LookUpTable.cpp
+FrameArena.cpp
+RegionOfInterestTracker.cpp
 Ball.cpp
 CircleFitting.cpp
 EllipseFit.cpp
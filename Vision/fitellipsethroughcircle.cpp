@@ -117,7 +117,7 @@ Vector3<float> FitEllipseThroughCircle::DistanceToPoint(LinePoint* point, Vision
     float elevation = vision->CalculateElevation(point->y);
 
     vector<float> ctgvector;
-    bool isOK = vision->getSensorsData()->get(NUSensorsData::CameraToGroundTransform, ctgvector);
+    bool isOK = vision->getCameraToGroundTransform(ctgvector);
     if(isOK == true)
     {
         Matrix camera2groundTransform = Matrix4x4fromVector(ctgvector);